@@ -3,13 +3,15 @@ import random
 import enum
 import socket
 
-CURRENT_REQUEST_VERSION = 1
-MAX_REQUEST_DATA_SIZE = 32
-MAX_PACKET_SIZE = 48
+CURRENT_REQUEST_VERSION = 2
+MAX_REQUEST_DATA_SIZE = 1024
+MAX_PACKET_SIZE = 1040
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
-    WriteMemory = 2
+    WriteMemory = 2,
+    ReadMemoryBatch = 3,
+    WriteMemoryBatch = 4
 
 CITRA_PORT = 45987
 
@@ -90,6 +92,43 @@ class Citra:
                 return False
         return True
 
+    def read_memory_batch(self, ranges):
+        """
+        Reads several (address, size) ranges with as few requests as possible
+        >>> c.read_memory_batch([(0x100000, 4), (0x100004, 2)])
+        [b'\\x07\\x00\\x00\\xeb', b'\\x00\\x00']
+        """
+        # Split the ranges into requests whose replies fit into a packet
+        requests = [[]]
+        reply_size = 0
+        for index, (read_address, read_size) in enumerate(ranges):
+            while read_size > 0:
+                if reply_size == MAX_REQUEST_DATA_SIZE or len(requests[-1]) * 8 == MAX_REQUEST_DATA_SIZE:
+                    requests.append([])
+                    reply_size = 0
+                piece_size = min(read_size, MAX_REQUEST_DATA_SIZE - reply_size)
+                requests[-1].append((index, read_address, piece_size))
+                reply_size += piece_size
+                read_address += piece_size
+                read_size -= piece_size
+
+        results = [bytes() for _ in ranges]
+        for pieces in requests:
+            if not pieces:
+                continue
+            request_data = b"".join(struct.pack("II", address, size) for _, address, size in pieces)
+            request, request_id = self._generate_header(RequestType.ReadMemoryBatch, len(request_data))
+            self.socket.sendto(request + request_data, (self.address, CITRA_PORT))
+
+            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ReadMemoryBatch)
+            if not reply_data or len(reply_data) != sum(size for _, _, size in pieces):
+                return None
+            for index, _, size in pieces:
+                results[index] += reply_data[:size]
+                reply_data = reply_data[size:]
+        return results
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
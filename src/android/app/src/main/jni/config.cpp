@@ -115,6 +115,12 @@ void Config::ReadValues() {
     Settings::values.use_cpu_jit = sdl2_config->GetBoolean("Core", "use_cpu_jit", true);
     Settings::values.cpu_clock_percentage =
         static_cast<int>(sdl2_config->GetInteger("Core", "cpu_clock_percentage", 100));
+    Settings::values.emulation_thread_cores = static_cast<Settings::ThreadCoreType>(
+        sdl2_config->GetInteger("Core", "emulation_thread_cores", 1));
+    Settings::values.render_thread_cores = static_cast<Settings::ThreadCoreType>(
+        sdl2_config->GetInteger("Core", "render_thread_cores", 1));
+    Settings::values.audio_thread_cores = static_cast<Settings::ThreadCoreType>(
+        sdl2_config->GetInteger("Core", "audio_thread_cores", 0));
 
     // Premium
     Settings::values.texture_filter_name =
@@ -205,6 +211,8 @@ void Config::ReadValues() {
     Settings::values.sink_id = sdl2_config->GetString("Audio", "output_engine", "auto");
     Settings::values.enable_audio_stretching =
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
+    Settings::values.enable_low_latency_output =
+        sdl2_config->GetBoolean("Audio", "enable_low_latency_output", false);
     Settings::values.audio_device_id = sdl2_config->GetString("Audio", "output_device", "auto");
     Settings::values.volume = static_cast<float>(sdl2_config->GetReal("Audio", "volume", 1));
     Settings::values.mic_input_device =
@@ -290,6 +298,8 @@ void Config::ReadValues() {
         sdl2_config->GetString("WebService", "web_api_url", "https://api.citra-emu.org");
     NetSettings::values.citra_username = sdl2_config->GetString("WebService", "citra_username", "");
     NetSettings::values.citra_token = sdl2_config->GetString("WebService", "citra_token", "");
+    NetSettings::values.enable_direct_connections =
+        sdl2_config->GetBoolean("WebService", "enable_direct_connections", false);
 
     // Update CFG file based on settings
     UpdateCFG();
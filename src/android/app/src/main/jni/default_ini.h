@@ -97,6 +97,14 @@ use_cpu_jit =
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# Host cores the emulation, render and audio threads are kept on. Only makes a difference on CPUs
+# with big and little cores.
+# 0: Any core, 1: Performance cores, 2: Efficiency cores
+# Defaults are 1 for the emulation and render threads and 0 for the audio threads
+emulation_thread_cores =
+render_thread_cores =
+audio_thread_cores =
+
 [Renderer]
 # Whether to render using OpenGL or Vulkan
 # 1: OpenGL, 2 (default): Vulkan
@@ -256,6 +264,12 @@ output_engine =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not the audio output asks the device for the smallest buffer it supports.
+# Falls back to the default latency when the device refuses it. Lowers audio latency,
+# but may crackle on slow devices.
+# 0 (default): No, 1: Yes
+enable_low_latency_output =
+
 # Which audio device to use.
 # auto (default): Auto-select
 output_device =
@@ -352,5 +366,9 @@ web_api_url = https://api.citra-emu.org
 # See https://profile.citra-emu.org/ for more info
 citra_username =
 citra_token =
+# Whether to send local wireless traffic directly to the other members of a room that allow it,
+# instead of through the room. This shares your IP address with those members.
+# 0 (default): No, 1: Yes
+enable_direct_connections =
 )";
 }
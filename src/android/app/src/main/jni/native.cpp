@@ -21,6 +21,7 @@
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/frontend/applets/default_applets.h"
 #include "core/frontend/camera/factory.h"
@@ -229,6 +230,7 @@ static Core::System::ResultStatus RunCitra(const std::string& filepath) {
     system.CoreTiming().ScheduleEvent(audio_stretching_ticks, audio_stretching_event);
 
     // Start running emulation
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation);
     while (!stop_run) {
         if (!pause_emulation) {
             const auto result = system.RunLoop();
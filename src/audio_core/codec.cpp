@@ -13,114 +13,145 @@
 
 namespace AudioCore::Codec {
 
-StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
-                           const std::array<s16, 16>& adpcm_coeff, ADPCMState& state) {
+namespace {
+
+// GC-ADPCM frames are 8 bytes long containing 14 samples each.
+constexpr std::size_t ADPCM_FRAME_LEN = 8;
+constexpr std::size_t ADPCM_SAMPLES_PER_FRAME = 14;
+
+/// Samples decoded on the stack at a time when filling a StereoBuffer16. A whole number of ADPCM
+/// frames, so every chunk starts at a frame boundary.
+constexpr std::size_t CHUNK_SIZE = ADPCM_SAMPLES_PER_FRAME * 18;
+
+/// Decodes `sample_count` samples in stack sized chunks and appends them to a buffer
+template <typename Decode>
+StereoBuffer16 DecodeInChunks(std::size_t sample_count, Decode&& decode) {
+    std::array<std::array<s16, 2>, CHUNK_SIZE> chunk;
+    StereoBuffer16 ret;
+    for (std::size_t offset = 0; offset < sample_count; offset += CHUNK_SIZE) {
+        const std::size_t count = std::min(CHUNK_SIZE, sample_count - offset);
+        decode(offset, std::span{chunk.data(), count});
+        ret.insert(ret.end(), chunk.begin(), chunk.begin() + count);
+    }
+    return ret;
+}
+
+} // Anonymous namespace
+
+void DecodeADPCM(const u8* const data, const std::array<s16, 16>& adpcm_coeff, ADPCMState& state,
+                 std::span<std::array<s16, 2>> output) {
     // GC-ADPCM with scale factor and variable coefficients.
-    // Frames are 8 bytes long containing 14 samples each.
     // Samples are 4 bits (one nibble) long.
-
-    constexpr std::size_t FRAME_LEN = 8;
-    constexpr std::size_t SAMPLES_PER_FRAME = 14;
     static constexpr std::array<int, 16> SIGNED_NIBBLES{
         0, 1, 2, 3, 4, 5, 6, 7, -8, -7, -6, -5, -4, -3, -2, -1,
     };
 
-    const std::size_t ret_size =
-        sample_count % 2 == 0 ? sample_count : sample_count + 1; // Ensure multiple of two.
-    StereoBuffer16 ret(ret_size);
-
     int yn1 = state.yn1, yn2 = state.yn2;
 
-    const std::size_t NUM_FRAMES =
-        (sample_count + (SAMPLES_PER_FRAME - 1)) / SAMPLES_PER_FRAME; // Round up.
-    for (std::size_t framei = 0; framei < NUM_FRAMES; framei++) {
-        const int frame_header = data[framei * FRAME_LEN];
-        const int scale = 1 << (frame_header & 0xF);
-        const int idx = (frame_header >> 4) & 0x7;
+    const std::size_t num_frames =
+        (output.size() + (ADPCM_SAMPLES_PER_FRAME - 1)) / ADPCM_SAMPLES_PER_FRAME; // Round up.
+    for (std::size_t framei = 0; framei < num_frames; framei++) {
+        const u8* frame = data + framei * ADPCM_FRAME_LEN;
+        const int scale = 1 << (frame[0] & 0xF);
+        const int idx = (frame[0] >> 4) & 0x7;
 
         // Coefficients are fixed point with 11 bits fractional part.
         const int coef1 = adpcm_coeff[idx * 2 + 0];
         const int coef2 = adpcm_coeff[idx * 2 + 1];
 
+        // The scale is fixed for the frame, so every nibble maps to one input term.
+        // We first transform everything into 11 bit fixed point, perform the second order
+        // digital filter, then transform back.
+        // 0x400 == 0.5 in 11 bit fixed point.
+        std::array<int, 16> terms;
+        for (std::size_t nibble = 0; nibble < terms.size(); nibble++) {
+            terms[nibble] = ((SIGNED_NIBBLES[nibble] * scale) << 11) + 0x400;
+        }
+
         // Decodes an audio sample. One nibble produces one sample.
-        const auto decode_sample = [&](const int nibble) -> s16 {
-            const int xn = nibble * scale;
-            // We first transform everything into 11 bit fixed point, perform the second order
-            // digital filter, then transform back.
-            // 0x400 == 0.5 in 11 bit fixed point.
+        const auto decode_sample = [&](const u8 nibble) -> s16 {
             // Filter: y[n] = x[n] + 0.5 + c1 * y[n-1] + c2 * y[n-2]
-            int val = ((xn << 11) + 0x400 + coef1 * yn1 + coef2 * yn2) >> 11;
+            int val = (terms[nibble] + coef1 * yn1 + coef2 * yn2) >> 11;
             // Clamp to output range.
             val = std::clamp(val, -32768, 32767);
             // Advance output feedback.
             yn2 = yn1;
             yn1 = val;
-            return (s16)val;
+            return static_cast<s16>(val);
         };
 
-        std::size_t outputi = framei * SAMPLES_PER_FRAME;
-        std::size_t datai = framei * FRAME_LEN + 1;
-        for (std::size_t i = 0; i < SAMPLES_PER_FRAME && outputi < sample_count; i += 2) {
-            const s16 sample1 = decode_sample(SIGNED_NIBBLES[data[datai] >> 4]);
-            ret[outputi].fill(sample1);
-            outputi++;
-
-            const s16 sample2 = decode_sample(SIGNED_NIBBLES[data[datai] & 0xF]);
-            ret[outputi].fill(sample2);
-            outputi++;
-
-            datai++;
+        const std::size_t first = framei * ADPCM_SAMPLES_PER_FRAME;
+        const std::size_t count = std::min(ADPCM_SAMPLES_PER_FRAME, output.size() - first);
+        for (std::size_t i = 0; i < count; i++) {
+            const u8 byte = frame[1 + i / 2];
+            output[first + i].fill(decode_sample(i % 2 == 0 ? byte >> 4 : byte & 0xF));
         }
     }
 
     state.yn1 = static_cast<s16>(yn1);
     state.yn2 = static_cast<s16>(yn2);
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
-                          const std::size_t sample_count) {
+void DecodePCM8(const unsigned num_channels, const u8* const data,
+                std::span<std::array<s16, 2>> output) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
     const auto decode_sample = [](u8 sample) {
         return static_cast<s16>(static_cast<u16>(sample) << 8);
     };
 
-    StereoBuffer16 ret(sample_count);
-
+    // Plain loops over contiguous memory, which the compiler vectorizes
+    s16* out = output.data()->data();
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i].fill(decode_sample(data[i]));
+        for (std::size_t i = 0; i < output.size(); i++) {
+            out[i * 2 + 0] = out[i * 2 + 1] = decode_sample(data[i]);
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i][0] = decode_sample(data[i * 2 + 0]);
-            ret[i][1] = decode_sample(data[i * 2 + 1]);
+        for (std::size_t i = 0; i < output.size() * 2; i++) {
+            out[i] = decode_sample(data[i]);
         }
     }
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
-                           const std::size_t sample_count) {
+void DecodePCM16(const unsigned num_channels, const u8* const data,
+                 std::span<std::array<s16, 2>> output) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
-    StereoBuffer16 ret(sample_count);
-
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
+        s16* out = output.data()->data();
+        for (std::size_t i = 0; i < output.size(); i++) {
             s16 sample;
             std::memcpy(&sample, data + i * sizeof(s16), sizeof(s16));
-            ret[i].fill(sample);
+            out[i * 2 + 0] = out[i * 2 + 1] = sample;
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; ++i) {
-            std::memcpy(&ret[i], data + i * sizeof(s16) * 2, 2 * sizeof(s16));
-        }
+        // Interleaved stereo is already in the output layout
+        std::memcpy(output.data(), data, output.size_bytes());
     }
+}
 
-    return ret;
+StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
+                           const std::array<s16, 16>& adpcm_coeff, ADPCMState& state) {
+    const std::size_t ret_size =
+        sample_count % 2 == 0 ? sample_count : sample_count + 1; // Ensure multiple of two.
+    return DecodeInChunks(ret_size, [&](std::size_t offset, std::span<std::array<s16, 2>> out) {
+        DecodeADPCM(data + offset / ADPCM_SAMPLES_PER_FRAME * ADPCM_FRAME_LEN, adpcm_coeff, state,
+                    out);
+    });
+}
+
+StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
+                          const std::size_t sample_count) {
+    return DecodeInChunks(sample_count, [&](std::size_t offset, std::span<std::array<s16, 2>> out) {
+        DecodePCM8(num_channels, data + offset * num_channels, out);
+    });
 }
+
+StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
+                           const std::size_t sample_count) {
+    return DecodeInChunks(sample_count, [&](std::size_t offset, std::span<std::array<s16, 2>> out) {
+        DecodePCM16(num_channels, data + offset * num_channels * sizeof(s16), out);
+    });
+}
+
 } // namespace AudioCore::Codec
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <span>
 #include "audio_core/audio_types.h"
 #include "common/common_types.h"
 
@@ -45,4 +46,31 @@ StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
  */
 StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
                            const std::size_t sample_count);
+
+/**
+ * Decodes ADPCM data into a caller provided buffer, without allocating
+ * @param data Pointer to ADPCM data to decode, starting at a frame boundary
+ * @param adpcm_coeff ADPCM coefficients
+ * @param state ADPCM state, this is updated with new state
+ * @param output Buffer to receive the decoded samples, its size is the number of samples decoded
+ */
+void DecodeADPCM(const u8* data, const std::array<s16, 16>& adpcm_coeff, ADPCMState& state,
+                 std::span<std::array<s16, 2>> output);
+
+/**
+ * Decodes PCM8 data into a caller provided buffer, without allocating
+ * @param num_channels Number of channels
+ * @param data Pointer to PCM8 data to decode
+ * @param output Buffer to receive the decoded samples, its size is the number of samples decoded
+ */
+void DecodePCM8(unsigned num_channels, const u8* data, std::span<std::array<s16, 2>> output);
+
+/**
+ * Decodes PCM16 data into a caller provided buffer, without allocating
+ * @param num_channels Number of channels
+ * @param data Pointer to PCM16 data to decode
+ * @param output Buffer to receive the decoded samples, its size is the number of samples decoded
+ */
+void DecodePCM16(unsigned num_channels, const u8* data, std::span<std::array<s16, 2>> output);
+
 } // namespace AudioCore::Codec
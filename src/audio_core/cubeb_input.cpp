@@ -2,21 +2,27 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <utility>
 #include <vector>
 #include <cubeb/cubeb.h>
 #include "audio_core/cubeb_input.h"
 #include "common/logging/log.h"
+#include "common/ring_buffer.h"
 
 namespace AudioCore {
 
-using SampleQueue = Common::SPSCQueue<Frontend::Mic::Samples>;
+/// Bytes of captured samples kept until the application reads them, about a second at the
+/// highest sample rate
+using SampleBuffer = Common::RingBuffer<u8, 0x10000>;
 
 struct CubebInput::Impl {
     cubeb* ctx = nullptr;
     cubeb_stream* stream = nullptr;
 
-    std::unique_ptr<SampleQueue> sample_queue{};
+    /// Samples already converted to the sample size the application asked for
+    std::unique_ptr<SampleBuffer> sample_buffer{};
     u8 sample_size_in_bytes = 0;
 
     static long DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
@@ -30,7 +36,7 @@ CubebInput::CubebInput(std::string device_id)
         LOG_ERROR(Audio, "cubeb_init failed! Mic will not work properly");
         return;
     }
-    impl->sample_queue = std::make_unique<SampleQueue>();
+    impl->sample_buffer = std::make_unique<SampleBuffer>();
 }
 
 CubebInput::~CubebInput() {
@@ -122,13 +128,13 @@ void CubebInput::AdjustSampleRate(u32 sample_rate) {
     LOG_ERROR(Audio, "AdjustSampleRate unimplemented!");
 }
 
-Frontend::Mic::Samples CubebInput::Read() {
-    Frontend::Mic::Samples samples{};
-    Frontend::Mic::Samples queue;
-    while (impl->sample_queue->Pop(queue)) {
-        samples.insert(samples.end(), queue.begin(), queue.end());
+std::size_t CubebInput::Read(std::span<u8> dest) {
+    if (!impl->sample_buffer || impl->sample_size_in_bytes == 0) {
+        return 0;
     }
-    return samples;
+    // Only whole samples are handed out, so a 16-bit sample is never split between two reads
+    const std::size_t size = dest.size() / impl->sample_size_in_bytes * impl->sample_size_in_bytes;
+    return impl->sample_buffer->Pop(dest.data(), size);
 }
 
 long CubebInput::Impl::DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
@@ -138,25 +144,23 @@ long CubebInput::Impl::DataCallback(cubeb_stream* stream, void* user_data, const
         return 0;
     }
 
-    constexpr auto resample_s16_s8 = [](s16 sample) {
-        return static_cast<u8>(static_cast<u16>(sample) >> 8);
-    };
-
-    std::vector<u8> samples{};
-    samples.reserve(num_frames * impl->sample_size_in_bytes);
+    const std::size_t num_samples = static_cast<std::size_t>(num_frames);
     if (impl->sample_size_in_bytes == 1) {
-        // If the sample format is 8bit, then resample back to 8bit before passing back to core
-        for (std::size_t i = 0; i < static_cast<std::size_t>(num_frames); i++) {
-            s16 data;
-            std::memcpy(&data, static_cast<const u8*>(input_buffer) + i * 2, 2);
-            samples.push_back(resample_s16_s8(data));
+        // If the sample format is 8bit, then resample back to 8bit before passing back to core.
+        // This is done in chunks on the stack, the callback must not allocate.
+        const s16* const input = static_cast<const s16*>(input_buffer);
+        std::array<u8, 1024> chunk;
+        for (std::size_t start = 0; start < num_samples; start += chunk.size()) {
+            const std::size_t count = std::min(chunk.size(), num_samples - start);
+            for (std::size_t i = 0; i < count; i++) {
+                chunk[i] = static_cast<u8>(static_cast<u16>(input[start + i]) >> 8);
+            }
+            impl->sample_buffer->Push(chunk.data(), count);
         }
     } else {
         // Otherwise copy all of the samples to the buffer (which will be treated as s16 by core)
-        const u8* data = reinterpret_cast<const u8*>(input_buffer);
-        samples.insert(samples.begin(), data, data + num_frames * impl->sample_size_in_bytes);
+        impl->sample_buffer->Push(input_buffer, num_samples * impl->sample_size_in_bytes);
     }
-    impl->sample_queue->Push(samples);
 
     // returning less than num_frames here signals cubeb to stop sampling
     return num_frames;
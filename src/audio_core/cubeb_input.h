@@ -21,7 +21,7 @@ public:
 
     void AdjustSampleRate(u32 sample_rate) override;
 
-    Frontend::Mic::Samples Read() override;
+    std::size_t Read(std::span<u8> dest) override;
 
 private:
     struct Impl;
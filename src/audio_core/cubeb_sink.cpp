@@ -14,6 +14,7 @@ namespace AudioCore {
 
 struct CubebSink::Impl {
     unsigned int sample_rate = 0;
+    u32 device_latency = 0;
 
     cubeb* ctx = nullptr;
     cubeb_stream* stream = nullptr;
@@ -26,7 +27,8 @@ struct CubebSink::Impl {
     static void LogCallback(char const* fmt, ...);
 };
 
-CubebSink::CubebSink(std::string_view target_device_name) : impl(std::make_unique<Impl>()) {
+CubebSink::CubebSink(std::string_view target_device_name, bool low_latency)
+    : impl(std::make_unique<Impl>()) {
     if (cubeb_init(&impl->ctx, "Citra Output", nullptr) != CUBEB_OK) {
         LOG_CRITICAL(Audio_Sink, "cubeb_init failed");
         return;
@@ -66,9 +68,23 @@ CubebSink::CubebSink(std::string_view target_device_name) : impl(std::make_uniqu
         }
     }
 
-    int stream_err = cubeb_stream_init(impl->ctx, &impl->stream, "CitraAudio", nullptr, nullptr,
-                                       output_device, &params, std::max(512u, minimum_latency),
-                                       &Impl::DataCallback, &Impl::StateCallback, impl.get());
+    const auto open_stream = [&](u32 latency) {
+        return cubeb_stream_init(impl->ctx, &impl->stream, "CitraAudio", nullptr, nullptr,
+                                 output_device, &params, latency, &Impl::DataCallback,
+                                 &Impl::StateCallback, impl.get());
+    };
+
+    // Asking for the minimum latency is what makes the backends take their low latency paths,
+    // AAudio low latency performance mode or the small shared mode periods of WASAPI
+    const u32 default_latency = std::max(512u, minimum_latency);
+    u32 latency = low_latency ? minimum_latency : default_latency;
+    int stream_err = open_stream(latency);
+    if (stream_err != CUBEB_OK && latency != default_latency) {
+        LOG_WARNING(Audio_Sink, "Low latency cubeb stream refused ({}), using {} frames",
+                    stream_err, default_latency);
+        latency = default_latency;
+        stream_err = open_stream(latency);
+    }
     if (stream_err != CUBEB_OK) {
         switch (stream_err) {
         case CUBEB_ERROR:
@@ -89,6 +105,14 @@ CubebSink::CubebSink(std::string_view target_device_name) : impl(std::make_uniqu
         LOG_CRITICAL(Audio_Sink, "Error starting cubeb stream");
         return;
     }
+
+    // Not every backend reports the latency, the requested buffer is the best estimate then
+    if (cubeb_stream_get_latency(impl->stream, &impl->device_latency) != CUBEB_OK ||
+        impl->device_latency == 0) {
+        impl->device_latency = latency;
+    }
+    LOG_INFO(Audio_Sink, "Cubeb stream opened with {} frames of device latency",
+             impl->device_latency);
 }
 
 CubebSink::~CubebSink() {
@@ -115,6 +139,10 @@ void CubebSink::SetCallback(std::function<void(s16*, std::size_t)> cb) {
     impl->cb = cb;
 }
 
+u32 CubebSink::GetDeviceLatency() const {
+    return impl->device_latency;
+}
+
 long CubebSink::Impl::DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
                                    void* output_buffer, long num_frames) {
     auto* impl = static_cast<Impl*>(user_data);
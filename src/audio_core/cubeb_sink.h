@@ -12,13 +12,15 @@ namespace AudioCore {
 
 class CubebSink final : public Sink {
 public:
-    explicit CubebSink(std::string_view device_id);
+    explicit CubebSink(std::string_view device_id, bool low_latency);
     ~CubebSink() override;
 
     unsigned int GetNativeSampleRate() const override;
 
     void SetCallback(std::function<void(s16*, std::size_t)> cb) override;
 
+    u32 GetDeviceLatency() const override;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl;
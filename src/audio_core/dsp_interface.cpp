@@ -18,10 +18,15 @@ DspInterface::~DspInterface() = default;
 
 void DspInterface::SetSink(std::string_view sink_id, std::string_view audio_device) {
     sink = CreateSinkFromID(Settings::values.sink_id.GetValue(),
-                            Settings::values.audio_device_id.GetValue());
+                            Settings::values.audio_device_id.GetValue(),
+                            Settings::values.enable_low_latency_output.GetValue());
+    const u64 device_frames = sink->GetDeviceLatency();
+    device_latency = std::chrono::microseconds{
+        static_cast<s64>(device_frames * 1'000'000 / sink->GetNativeSampleRate())};
     sink->SetCallback(
         [this](s16* buffer, std::size_t num_frames) { OutputCallback(buffer, num_frames); });
     time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
+    low_latency_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
 }
 
 Sink& DspInterface::GetSink() {
@@ -39,19 +44,34 @@ void DspInterface::EnableStretching(bool enable) {
     perform_time_stretching = enable;
 }
 
-void DspInterface::OutputFrame(StereoFrame16 frame) {
-    if (!sink)
+WsolaStretcher::Stats DspInterface::GetLowLatencyStretcherStats() const {
+    return low_latency_stretcher.GetStats();
+}
+
+std::chrono::microseconds DspInterface::GetOutputLatency() const {
+    return std::chrono::microseconds{
+        static_cast<s64>(buffered_frames.load() * 1'000'000 / native_sample_rate)};
+}
+
+std::chrono::microseconds DspInterface::GetDeviceLatency() const {
+    return device_latency.load();
+}
+
+void DspInterface::OutputFrame(const StereoFrame16& frame) {
+    // Audio of re-simulated frames was already played
+    if (!sink || Core::System::GetInstance().IsResimulating())
         return;
 
     fifo.Push(frame.data(), frame.size());
 
     if (Core::System::GetInstance().VideoDumper().IsDumping()) {
-        Core::System::GetInstance().VideoDumper().AddAudioFrame(std::move(frame));
+        Core::System::GetInstance().VideoDumper().AddAudioFrame(frame);
     }
 }
 
 void DspInterface::OutputSample(std::array<s16, 2> sample) {
-    if (!sink)
+    // Audio of re-simulated frames was already played
+    if (!sink || Core::System::GetInstance().IsResimulating())
         return;
 
     fifo.Push(&sample, 1);
@@ -64,18 +84,27 @@ void DspInterface::OutputSample(std::array<s16, 2> sample) {
 void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
     std::size_t frames_written;
     if (perform_time_stretching) {
-        const std::vector<s16> in{fifo.Pop()};
-        const std::size_t num_in{in.size() / 2};
-        frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
+        stretch_input.resize(fifo.Capacity() * 2);
+        const std::size_t num_in = fifo.Pop(stretch_input.data(), fifo.Capacity());
+        frames_written = StretchSamples(stretch_input.data(), num_in, buffer, num_frames);
     } else if (flushing_time_stretcher) {
-        time_stretcher.Flush();
-        frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
+        if (use_low_latency_stretcher) {
+            low_latency_stretcher.Flush();
+        } else {
+            time_stretcher.Flush();
+        }
+        frames_written = StretchSamples(nullptr, 0, buffer, num_frames);
         frames_written += fifo.Pop(buffer, num_frames - frames_written);
         flushing_time_stretcher = false;
     } else {
         frames_written = fifo.Pop(buffer, num_frames);
     }
 
+    const std::size_t stretcher_frames = use_low_latency_stretcher
+                                             ? low_latency_stretcher.GetBufferedFrames()
+                                             : time_stretcher.GetBufferedFrames();
+    buffered_frames = fifo.Size() + stretcher_frames;
+
     if (frames_written > 0) {
         std::memcpy(&last_frame[0], buffer + 2 * (frames_written - 1), 2 * sizeof(s16));
     }
@@ -97,4 +126,23 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
     }
 }
 
+std::size_t DspInterface::StretchSamples(const s16* in, std::size_t num_in, s16* out,
+                                         std::size_t num_out) {
+    const bool low_latency = Settings::values.enable_low_latency_stretching.GetValue();
+    if (use_low_latency_stretcher != low_latency) {
+        // Drop the audio buffered by the stretcher that is being switched away from
+        if (use_low_latency_stretcher) {
+            low_latency_stretcher.Clear();
+        } else {
+            time_stretcher.Clear();
+        }
+        use_low_latency_stretcher = low_latency;
+    }
+
+    if (use_low_latency_stretcher) {
+        return low_latency_stretcher.Process(in, num_in, out, num_out);
+    }
+    return time_stretcher.Process(in, num_in, out, num_out);
+}
+
 } // namespace AudioCore
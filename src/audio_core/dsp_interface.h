@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <boost/serialization/access.hpp>
 #include "audio_core/audio_types.h"
 #include "audio_core/time_stretch.h"
+#include "audio_core/wsola_stretch.h"
 #include "common/common_types.h"
 #include "common/ring_buffer.h"
 #include "core/memory.h"
@@ -99,20 +102,35 @@ public:
     Sink& GetSink();
     /// Enable/Disable audio stretching.
     void EnableStretching(bool enable);
+    /// Returns the metrics of the low latency audio stretcher.
+    WsolaStretcher::Stats GetLowLatencyStretcherStats() const;
+    /// Returns the duration of the audio queued between the DSP and the sink.
+    std::chrono::microseconds GetOutputLatency() const;
+    /// Returns the latency the audio device of the sink reported when it was opened.
+    std::chrono::microseconds GetDeviceLatency() const;
 
 protected:
-    void OutputFrame(StereoFrame16 frame);
+    void OutputFrame(const StereoFrame16& frame);
     void OutputSample(std::array<s16, 2> sample);
 
 private:
     void FlushResidualStretcherAudio();
     void OutputCallback(s16* buffer, std::size_t num_frames);
+    std::size_t StretchSamples(const s16* in, std::size_t num_in, s16* out,
+                               std::size_t num_out);
 
     std::atomic<bool> perform_time_stretching = false;
     std::atomic<bool> flushing_time_stretcher = false;
     Common::RingBuffer<s16, 0x2000, 2> fifo;
+    /// Frames in the FIFO and the stretchers as of the last callback
+    std::atomic<std::size_t> buffered_frames = 0;
+    std::atomic<std::chrono::microseconds> device_latency{};
+    /// Holds the FIFO contents for the stretchers, so the callback doesn't allocate
+    std::vector<s16> stretch_input;
     std::array<s16, 2> last_frame{};
     TimeStretcher time_stretcher;
+    WsolaStretcher low_latency_stretcher;
+    bool use_low_latency_stretcher = false;
     std::unique_ptr<Sink> sink;
 
     template <class Archive>
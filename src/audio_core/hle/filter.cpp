@@ -8,10 +8,44 @@
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/filter.h"
 #include "audio_core/hle/shared_memory.h"
+#include "common/assert.h"
 #include "common/common_types.h"
 
 namespace AudioCore::HLE {
 
+namespace {
+
+constexpr std::size_t MaxLanes = num_sources * 2;
+
+/// Samples of each lane, laid out so that one sample of every lane is contiguous
+using LaneSamples = std::array<std::array<s32, MaxLanes>, samples_per_frame>;
+
+/// Copies both channels of the given sources into consecutive lanes
+void GatherLanes(std::span<StereoFrame16* const> frames, std::span<const std::size_t> sources,
+                 LaneSamples& lanes) {
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        for (std::size_t k = 0; k < sources.size(); k++) {
+            const std::array<s16, 2>& sample = (*frames[sources[k]])[samplei];
+            lanes[samplei][k * 2 + 0] = sample[0];
+            lanes[samplei][k * 2 + 1] = sample[1];
+        }
+    }
+}
+
+/// Copies the lanes filled by GatherLanes back into the frames
+void ScatterLanes(std::span<StereoFrame16* const> frames, std::span<const std::size_t> sources,
+                  const LaneSamples& lanes) {
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        for (std::size_t k = 0; k < sources.size(); k++) {
+            std::array<s16, 2>& sample = (*frames[sources[k]])[samplei];
+            sample[0] = static_cast<s16>(lanes[samplei][k * 2 + 0]);
+            sample[1] = static_cast<s16>(lanes[samplei][k * 2 + 1]);
+        }
+    }
+}
+
+} // Anonymous namespace
+
 void SourceFilters::Reset() {
     Enable(false, false);
 }
@@ -47,6 +81,95 @@ void SourceFilters::ProcessFrame(StereoFrame16& frame) {
     }
 }
 
+void SourceFilters::ProcessFrames(std::span<SourceFilters* const> filters,
+                                  std::span<StereoFrame16* const> frames) {
+    ASSERT(filters.size() == frames.size() && filters.size() <= num_sources);
+
+    LaneSamples lanes;
+    std::array<std::size_t, num_sources> sources;
+    std::size_t num_lanes;
+
+    // Simple filters run first, as in ProcessFrame
+    num_lanes = 0;
+    for (std::size_t i = 0; i < filters.size(); i++) {
+        if (filters[i]->simple_filter_enabled) {
+            sources[num_lanes / 2] = i;
+            num_lanes += 2;
+        }
+    }
+    if (num_lanes != 0) {
+        std::array<s32, MaxLanes> a1, b0, y1;
+        for (std::size_t lane = 0; lane < num_lanes; lane++) {
+            const SimpleFilter& filter = filters[sources[lane / 2]]->simple_filter;
+            a1[lane] = filter.a1;
+            b0[lane] = filter.b0;
+            y1[lane] = filter.y1[lane % 2];
+        }
+
+        const std::span active{sources.data(), num_lanes / 2};
+        GatherLanes(frames, active, lanes);
+        for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+            std::array<s32, MaxLanes>& x0 = lanes[samplei];
+            for (std::size_t lane = 0; lane < num_lanes; lane++) {
+                const s32 tmp = (b0[lane] * x0[lane] + a1[lane] * y1[lane]) >> 15;
+                x0[lane] = y1[lane] = std::clamp(tmp, -32768, 32767);
+            }
+        }
+        ScatterLanes(frames, active, lanes);
+
+        for (std::size_t lane = 0; lane < num_lanes; lane++) {
+            filters[sources[lane / 2]]->simple_filter.y1[lane % 2] = static_cast<s16>(y1[lane]);
+        }
+    }
+
+    num_lanes = 0;
+    for (std::size_t i = 0; i < filters.size(); i++) {
+        if (filters[i]->biquad_filter_enabled) {
+            sources[num_lanes / 2] = i;
+            num_lanes += 2;
+        }
+    }
+    if (num_lanes != 0) {
+        std::array<s32, MaxLanes> a1, a2, b0, b1, b2, x1, x2, y1, y2;
+        for (std::size_t lane = 0; lane < num_lanes; lane++) {
+            const BiquadFilter& filter = filters[sources[lane / 2]]->biquad_filter;
+            a1[lane] = filter.a1;
+            a2[lane] = filter.a2;
+            b0[lane] = filter.b0;
+            b1[lane] = filter.b1;
+            b2[lane] = filter.b2;
+            x1[lane] = filter.x1[lane % 2];
+            x2[lane] = filter.x2[lane % 2];
+            y1[lane] = filter.y1[lane % 2];
+            y2[lane] = filter.y2[lane % 2];
+        }
+
+        const std::span active{sources.data(), num_lanes / 2};
+        GatherLanes(frames, active, lanes);
+        for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+            std::array<s32, MaxLanes>& x0 = lanes[samplei];
+            for (std::size_t lane = 0; lane < num_lanes; lane++) {
+                const s32 tmp = (b0[lane] * x0[lane] + b1[lane] * x1[lane] + b2[lane] * x2[lane] +
+                                 a1[lane] * y1[lane] + a2[lane] * y2[lane]) >>
+                                14;
+                x2[lane] = x1[lane];
+                x1[lane] = x0[lane];
+                y2[lane] = y1[lane];
+                x0[lane] = y1[lane] = std::clamp(tmp, -32768, 32767);
+            }
+        }
+        ScatterLanes(frames, active, lanes);
+
+        for (std::size_t lane = 0; lane < num_lanes; lane++) {
+            BiquadFilter& filter = filters[sources[lane / 2]]->biquad_filter;
+            filter.x1[lane % 2] = static_cast<s16>(x1[lane]);
+            filter.x2[lane % 2] = static_cast<s16>(x2[lane]);
+            filter.y1[lane % 2] = static_cast<s16>(y1[lane]);
+            filter.y2[lane % 2] = static_cast<s16>(y2[lane]);
+        }
+    }
+}
+
 // SimpleFilter
 
 void SourceFilters::SimpleFilter::Reset() {
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <span>
 #include "audio_core/audio_types.h"
 #include "audio_core/hle/shared_memory.h"
 #include "common/common_types.h"
@@ -48,6 +49,16 @@ public:
      */
     void ProcessFrame(StereoFrame16& frame);
 
+    /**
+     * Processes the frames of several sources in-place, with the same results as calling
+     * ProcessFrame for each of them. Every source channel is a lane, and the filters of all
+     * lanes are computed side by side.
+     * @param filters Filters of each source, at most num_sources.
+     * @param frames Audio samples of each source. Modified in-place.
+     */
+    static void ProcessFrames(std::span<SourceFilters* const> filters,
+                              std::span<StereoFrame16* const> frames);
+
 private:
     bool simple_filter_enabled;
     bool biquad_filter_enabled;
@@ -74,6 +85,8 @@ private:
         std::array<s16, 2> ProcessSample(const std::array<s16, 2>& x0);
 
     private:
+        friend class SourceFilters;
+
         // Configuration
         s32 a1, b0;
         // Internal state
@@ -102,6 +115,8 @@ private:
         std::array<s16, 2> ProcessSample(const std::array<s16, 2>& x0);
 
     private:
+        friend class SourceFilters;
+
         // Configuration
         s32 a1, a2, b0, b1, b2;
         // Internal state
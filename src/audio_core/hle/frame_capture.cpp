@@ -0,0 +1,115 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "audio_core/hle/frame_capture.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+
+namespace AudioCore::HLE {
+
+namespace {
+
+constexpr u32 CaptureMagic = 0x50414344; // "DCAP"
+constexpr u32 CaptureVersion = 1;
+
+struct CaptureHeader {
+    u32 magic;
+    u32 version;
+    /// Guards against captures made by a build with a different shared memory layout
+    u32 shared_memory_size;
+};
+
+struct FrameHeader {
+    u64 output_hash;
+    u32 num_memory_blocks;
+    u32 reserved;
+};
+
+struct MemoryBlockHeader {
+    u32 address;
+    u32 size;
+};
+
+} // Anonymous namespace
+
+u64 HashFrame(const StereoFrame16& frame) {
+    return Common::ComputeHash64(frame.data(), sizeof(frame));
+}
+
+FrameCaptureWriter::FrameCaptureWriter(const std::string& path) {
+    if (!FileUtil::CreateFullPath(path)) {
+        LOG_ERROR(Audio_DSP, "Unable to create the directory of {}", path);
+        return;
+    }
+    file = FileUtil::IOFile(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Audio_DSP, "Unable to open {} for the DSP frame capture", path);
+        return;
+    }
+    file.WriteObject(CaptureHeader{CaptureMagic, CaptureVersion, sizeof(SharedMemory)});
+    frame.read_region = std::make_unique<SharedMemory>();
+    LOG_INFO(Audio_DSP, "Capturing DSP frames to {}", path);
+}
+
+FrameCaptureWriter::~FrameCaptureWriter() = default;
+
+void FrameCaptureWriter::BeginFrame(const SharedMemory& read_region) {
+    std::memcpy(frame.read_region.get(), &read_region, sizeof(SharedMemory));
+    frame.memory_blocks.clear();
+}
+
+void FrameCaptureWriter::AddMemoryBlock(PAddr address, std::span<const u8> data) {
+    frame.memory_blocks.push_back({address, {data.begin(), data.end()}});
+}
+
+void FrameCaptureWriter::EndFrame(const StereoFrame16& output) {
+    if (!file.IsOpen()) {
+        return;
+    }
+    const u32 num_memory_blocks = static_cast<u32>(frame.memory_blocks.size());
+    file.WriteObject(FrameHeader{HashFrame(output), num_memory_blocks, 0});
+    file.WriteBytes(frame.read_region.get(), sizeof(SharedMemory));
+    for (const CapturedFrame::MemoryBlock& block : frame.memory_blocks) {
+        file.WriteObject(MemoryBlockHeader{block.address, static_cast<u32>(block.data.size())});
+        file.WriteBytes(block.data.data(), block.data.size());
+    }
+}
+
+std::vector<CapturedFrame> LoadFrameCapture(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    CaptureHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != CaptureMagic || header.version != CaptureVersion ||
+        header.shared_memory_size != sizeof(SharedMemory)) {
+        LOG_ERROR(Audio_DSP, "{} is not a compatible DSP frame capture", path);
+        return {};
+    }
+
+    std::vector<CapturedFrame> frames;
+    FrameHeader frame_header;
+    while (file.ReadBytes(&frame_header, sizeof(frame_header)) == sizeof(frame_header)) {
+        CapturedFrame& frame = frames.emplace_back();
+        frame.output_hash = frame_header.output_hash;
+        frame.read_region = std::make_unique<SharedMemory>();
+        file.ReadBytes(frame.read_region.get(), sizeof(SharedMemory));
+
+        frame.memory_blocks.resize(frame_header.num_memory_blocks);
+        for (CapturedFrame::MemoryBlock& block : frame.memory_blocks) {
+            MemoryBlockHeader block_header{};
+            file.ReadBytes(&block_header, sizeof(block_header));
+            block.address = block_header.address;
+            block.data.resize(block_header.size);
+            file.ReadBytes(block.data.data(), block.data.size());
+        }
+        if (!file.IsGood()) {
+            LOG_WARNING(Audio_DSP, "{} is truncated, dropping its last frame", path);
+            frames.pop_back();
+            break;
+        }
+    }
+    return frames;
+}
+
+} // namespace AudioCore::HLE
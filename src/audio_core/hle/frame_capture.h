@@ -0,0 +1,69 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "audio_core/audio_types.h"
+#include "audio_core/hle/shared_memory.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace AudioCore::HLE {
+
+/// Everything the HLE pipeline reads to generate one audio frame
+struct CapturedFrame {
+    /// Guest memory read by a source when it dequeued a buffer
+    struct MemoryBlock {
+        PAddr address;
+        std::vector<u8> data;
+    };
+
+    /// The read region, as the application left it before the frame was generated
+    std::unique_ptr<SharedMemory> read_region;
+    std::vector<MemoryBlock> memory_blocks;
+    /// Hash of the output the frame produced when it was captured
+    u64 output_hash;
+};
+
+/// Computes the hash that identifies the output of a frame
+u64 HashFrame(const StereoFrame16& frame);
+
+/**
+ * Records the input of every audio frame to a file. The file can be replayed by the
+ * OfflineRenderer, which checks that the same output is generated.
+ */
+class FrameCaptureWriter final {
+public:
+    explicit FrameCaptureWriter(const std::string& path);
+    ~FrameCaptureWriter();
+
+    [[nodiscard]] bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    /// Starts a frame, with the read region before any of its configuration is consumed
+    void BeginFrame(const SharedMemory& read_region);
+
+    /// Records guest memory read while the current frame is generated
+    void AddMemoryBlock(PAddr address, std::span<const u8> data);
+
+    /// Writes the current frame to the file
+    void EndFrame(const StereoFrame16& output);
+
+private:
+    FileUtil::IOFile file;
+    CapturedFrame frame;
+};
+
+/**
+ * Loads every frame of a capture.
+ * @returns The frames, or an empty vector if the file is missing or not a capture.
+ */
+std::vector<CapturedFrame> LoadFrameCapture(const std::string& path);
+
+} // namespace AudioCore::HLE
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <ctime>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -19,20 +20,28 @@
 #endif
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/decoder.h"
+#include "audio_core/hle/frame_capture.h"
 #include "audio_core/hle/hle.h"
 #include "audio_core/hle/mixers.h"
+#include "audio_core/hle/offline_renderer.h"
 #include "audio_core/hle/shared_memory.h"
 #include "audio_core/hle/source.h"
 #include "audio_core/sink.h"
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/file_util.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 
 SERIALIZE_EXPORT_IMPL(AudioCore::DspHle)
 
+MICROPROFILE_DEFINE(Audio_HLE_Frame, "Audio", "HLE Frame", MP_RGB(100, 200, 100));
+
 using InterruptType = Service::DSP::DSP_DSP::InterruptType;
 using Service::DSP::DSP_DSP;
 
@@ -64,7 +73,7 @@ public:
     u16 RecvData(u32 register_number);
     bool RecvDataIsReady(u32 register_number) const;
     std::vector<u8> PipeRead(DspPipe pipe_number, u32 length);
-    std::size_t GetPipeReadableSize(DspPipe pipe_number) const;
+    std::size_t GetPipeReadableSize(DspPipe pipe_number);
     void PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer);
 
     std::array<u8, Memory::DSP_RAM_SIZE>& GetDspMemory();
@@ -80,7 +89,21 @@ private:
     HLE::SharedMemory& ReadRegion();
     HLE::SharedMemory& WriteRegion();
 
+    /// Output of an audio frame generated on the frame worker, committed on the next tick
+    struct PipelinedFrame {
+        std::array<HLE::SourceStatus::Status, HLE::num_sources> source_statuses;
+        HLE::DspStatus dsp_status;
+        HLE::IntermediateMixSamples read_samples;
+        HLE::IntermediateMixSamples write_samples;
+        StereoFrame16 output;
+    };
+
+    void QueueBinaryRequest(const HLE::BinaryRequest& request);
+    void CommitBinaryResponses();
+
     StereoFrame16 GenerateCurrentFrame();
+    void QueuePipelinedFrame();
+    void CommitPipelinedFrame();
     bool Tick();
     void AudioTickCallback(s64 cycles_late);
 
@@ -101,11 +124,25 @@ private:
     Core::TimingEventType* tick_event{};
 
     std::unique_ptr<HLE::DecoderBase> decoder{};
+    /// Responses of the requests decoded on the decoder worker, in submission order
+    std::vector<HLE::BinaryResponse> binary_responses;
+    bool has_binary_requests{};
+    std::unique_ptr<Common::ThreadWorker> decoder_worker;
 
     std::weak_ptr<DSP_DSP> dsp_dsp{};
 
+    /// Records the input of every frame when dump_dsp_frames is enabled
+    std::unique_ptr<HLE::FrameCaptureWriter> capture;
+
+    std::unique_ptr<PipelinedFrame> pipelined_frame;
+    bool has_pipelined_frame{};
+    std::unique_ptr<Common::ThreadWorker> frame_worker;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        // The workers own the sources, the mixers and the decoder while work is in flight
+        CommitPipelinedFrame();
+        CommitBinaryResponses();
         ar& dsp_state;
         ar& pipe_data;
         ar& dsp_memory.raw_memory;
@@ -116,13 +153,8 @@ private:
     friend class boost::serialization::access;
 };
 
-DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory) : parent(parent_) {
-    dsp_memory.raw_memory.fill(0);
-
-    for (auto& source : sources) {
-        source.SetMemory(memory);
-    }
-
+static std::unique_ptr<HLE::DecoderBase> CreateDecoder(Memory::MemorySystem& memory) {
+    std::unique_ptr<HLE::DecoderBase> decoder;
 #if defined(HAVE_MF) && defined(HAVE_FFMPEG)
     decoder = std::make_unique<HLE::WMFDecoder>(memory);
     if (!decoder->IsValid()) {
@@ -147,6 +179,38 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory) : parent(paren
                     "Unable to load any decoders, this could cause missing audio in some games");
         decoder = std::make_unique<HLE::NullDecoder>();
     }
+    return decoder;
+}
+
+DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory) : parent(parent_) {
+    dsp_memory.raw_memory.fill(0);
+
+    if (Settings::values.dump_dsp_frames) {
+        const std::string path = fmt::format("{}dsp/frames_{}.bin",
+                                             FileUtil::GetUserPath(FileUtil::UserPath::DumpDir),
+                                             std::time(nullptr));
+        capture = std::make_unique<HLE::FrameCaptureWriter>(path);
+    }
+
+    for (auto& source : sources) {
+        source.SetMemory(memory);
+        source.SetCapture(capture.get());
+    }
+
+    if (Settings::values.enable_dsp_hle_thread) {
+        pipelined_frame = std::make_unique<PipelinedFrame>();
+        frame_worker = std::make_unique<Common::ThreadWorker>(1, "DspHle");
+        // Some backends keep per thread state, so the decoder only ever runs on its worker
+        decoder_worker = std::make_unique<Common::ThreadWorker>(1, "DspDecoder");
+        frame_worker->QueueWork([] { Common::SetCurrentThreadRole(Common::ThreadRole::Audio); });
+        decoder_worker->QueueWork([this, &memory] {
+            Common::SetCurrentThreadRole(Common::ThreadRole::Audio);
+            decoder = CreateDecoder(memory);
+        });
+        decoder_worker->WaitForRequests();
+    } else {
+        decoder = CreateDecoder(memory);
+    }
 
     Core::Timing& timing = Core::System::GetInstance().CoreTiming();
     tick_event =
@@ -159,6 +223,11 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory) : parent(paren
 DspHle::Impl::~Impl() {
     Core::Timing& timing = Core::System::GetInstance().CoreTiming();
     timing.UnscheduleEvent(tick_event, 0);
+
+    if (decoder_worker) {
+        decoder_worker->QueueWork([this] { decoder.reset(); });
+        decoder_worker->WaitForRequests();
+    }
 }
 
 DspState DspHle::Impl::GetDspState() const {
@@ -201,6 +270,10 @@ std::vector<u8> DspHle::Impl::PipeRead(DspPipe pipe_number, u32 length) {
         return {};
     }
 
+    if (pipe_number == DspPipe::Binary) {
+        CommitBinaryResponses();
+    }
+
     std::vector<u8>& data = pipe_data[pipe_index];
 
     if (length > data.size()) {
@@ -219,7 +292,7 @@ std::vector<u8> DspHle::Impl::PipeRead(DspPipe pipe_number, u32 length) {
     return ret;
 }
 
-size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) const {
+size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) {
     const std::size_t pipe_index = static_cast<std::size_t>(pipe_number);
 
     if (pipe_index >= num_dsp_pipe) {
@@ -227,6 +300,10 @@ size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) const {
         return 0;
     }
 
+    if (pipe_number == DspPipe::Binary) {
+        CommitBinaryResponses();
+    }
+
     return pipe_data[pipe_index].size();
 }
 
@@ -286,7 +363,7 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer)
         return;
     }
     case DspPipe::Binary: {
-        // TODO(B3N30): Make this async, and signal the interrupt
+        // TODO(B3N30): Signal the interrupt once the request is done
         HLE::BinaryRequest request;
         if (sizeof(request) != buffer.size()) {
             LOG_CRITICAL(Audio_DSP, "got binary pipe with wrong size {}", buffer.size());
@@ -299,6 +376,10 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer)
             UNIMPLEMENTED();
             return;
         }
+        if (decoder_worker) {
+            QueueBinaryRequest(request);
+            break;
+        }
         std::optional<HLE::BinaryResponse> response = decoder->ProcessRequest(request);
         if (response) {
             const HLE::BinaryResponse& value = *response;
@@ -324,6 +405,7 @@ void DspHle::Impl::SetServiceToInterrupt(std::weak_ptr<DSP_DSP> dsp) {
 }
 
 void DspHle::Impl::ResetPipes() {
+    CommitBinaryResponses();
     for (auto& data : pipe_data) {
         data.clear();
     }
@@ -400,44 +482,123 @@ HLE::SharedMemory& DspHle::Impl::WriteRegion() {
 }
 
 StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
+    MICROPROFILE_SCOPE(Audio_HLE_Frame);
+    Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                          Core::PerfStats::Subsystem::Audio};
     HLE::SharedMemory& read = ReadRegion();
-    HLE::SharedMemory& write = WriteRegion();
-
-    std::array<QuadFrame32, 3> intermediate_mixes = {};
+    if (capture) {
+        capture->BeginFrame(read);
+    }
+    const StereoFrame16 output_frame = HLE::GenerateFrame(sources, mixers, read, WriteRegion());
+    if (capture) {
+        capture->EndFrame(output_frame);
+    }
+    return output_frame;
+}
 
-    // Generate intermediate mixes
-    for (std::size_t i = 0; i < HLE::num_sources; i++) {
-        write.source_statuses.status[i] =
-            sources[i].Tick(read.source_configurations.config[i], read.adpcm_coefficients.coeff[i]);
-        for (std::size_t mix = 0; mix < 3; mix++) {
-            sources[i].MixInto(intermediate_mixes[mix], mix);
+void DspHle::Impl::QueueBinaryRequest(const HLE::BinaryRequest& request) {
+    // Decoding overlaps with emulation until the application reads the response, which it does
+    // after the binary interrupt of the next audio frame
+    decoder_worker->QueueWork([this, request] {
+        if (std::optional<HLE::BinaryResponse> response = decoder->ProcessRequest(request)) {
+            binary_responses.push_back(*response);
         }
+    });
+    has_binary_requests = true;
+}
+
+void DspHle::Impl::CommitBinaryResponses() {
+    if (!has_binary_requests) {
+        return;
     }
+    decoder_worker->WaitForRequests();
+    has_binary_requests = false;
+
+    // Each response replaces the previous one, as when requests are processed synchronously
+    std::vector<u8>& data = pipe_data[static_cast<u32>(DspPipe::Binary)];
+    for (const HLE::BinaryResponse& value : binary_responses) {
+        data.resize(sizeof(value));
+        std::memcpy(data.data(), &value, sizeof(value));
+    }
+    binary_responses.clear();
+}
 
-    // Generate final mix
-    write.dsp_status = mixers.Tick(read.dsp_configuration, read.intermediate_mix_samples,
-                                   write.intermediate_mix_samples, intermediate_mixes);
+void DspHle::Impl::QueuePipelinedFrame() {
+    CommitPipelinedFrame();
 
-    StereoFrame16 output_frame = mixers.GetOutput();
+    // Only the configuration is read from shared memory here, generating the frame only touches
+    // the sources, the mixers and the snapshot taken below
+    HLE::SharedMemory& read = ReadRegion();
+    if (capture) {
+        capture->BeginFrame(read);
+    }
+    for (std::size_t i = 0; i < HLE::num_sources; i++) {
+        sources[i].ParseConfig(read.source_configurations.config[i],
+                               read.adpcm_coefficients.coeff[i]);
+    }
+    mixers.ParseConfig(read.dsp_configuration);
+    pipelined_frame->read_samples = read.intermediate_mix_samples;
+    pipelined_frame->write_samples = WriteRegion().intermediate_mix_samples;
+
+    frame_worker->QueueWork([this] {
+        PipelinedFrame& frame = *pipelined_frame;
+        std::array<QuadFrame32, 3> intermediate_mixes = {};
+        for (std::size_t i = 0; i < HLE::num_sources; i++) {
+            frame.source_statuses[i] = sources[i].GenerateFrameStatus();
+        }
+        HLE::Source::FilterFrames(sources);
+        for (std::size_t i = 0; i < HLE::num_sources; i++) {
+            for (std::size_t mix = 0; mix < 3; mix++) {
+                sources[i].MixInto(intermediate_mixes[mix], mix);
+            }
+        }
+        frame.dsp_status = mixers.Mix(frame.read_samples, frame.write_samples, intermediate_mixes);
+        frame.output = mixers.GetOutput();
+        if (capture) {
+            capture->EndFrame(frame.output);
+        }
+    });
+    has_pipelined_frame = true;
+}
 
-    // Write current output frame to the shared memory region
-    for (std::size_t samplei = 0; samplei < output_frame.size(); samplei++) {
-        for (std::size_t channeli = 0; channeli < output_frame[0].size(); channeli++) {
-            write.final_samples.pcm16[samplei][channeli] = s16_le(output_frame[samplei][channeli]);
+void DspHle::Impl::CommitPipelinedFrame() {
+    if (!has_pipelined_frame) {
+        return;
+    }
+    frame_worker->WaitForRequests();
+    has_pipelined_frame = false;
+
+    // The results land in the region the application reads after this tick, one frame after the
+    // configuration they were generated from
+    HLE::SharedMemory& write = WriteRegion();
+    const PipelinedFrame& frame = *pipelined_frame;
+    for (std::size_t i = 0; i < HLE::num_sources; i++) {
+        write.source_statuses.status[i] = frame.source_statuses[i];
+    }
+    write.dsp_status = frame.dsp_status;
+    write.intermediate_mix_samples = frame.write_samples;
+    for (std::size_t samplei = 0; samplei < frame.output.size(); samplei++) {
+        for (std::size_t channeli = 0; channeli < frame.output[0].size(); channeli++) {
+            write.final_samples.pcm16[samplei][channeli] = s16_le(frame.output[samplei][channeli]);
         }
     }
 
-    return output_frame;
+    parent.OutputFrame(frame.output);
 }
 
 bool DspHle::Impl::Tick() {
+    if (frame_worker) {
+        QueuePipelinedFrame();
+        return GetDspState() == DspState::On;
+    }
+
     StereoFrame16 current_frame = {};
 
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
     // shared memory region)
     current_frame = GenerateCurrentFrame();
 
-    parent.OutputFrame(std::move(current_frame));
+    parent.OutputFrame(current_frame);
 
     return GetDspState() == DspState::On;
 }
@@ -445,6 +606,7 @@ bool DspHle::Impl::Tick() {
 void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
     if (Tick()) {
         // TODO(merry): Signal all the other interrupts as appropriate.
+        CommitBinaryResponses();
         if (auto service = dsp_dsp.lock()) {
             service->SignalInterrupt(InterruptType::Pipe, DspPipe::Audio);
             // HACK(merry): Added to prevent regressions. Will remove soon.
@@ -19,7 +19,12 @@ DspStatus Mixers::Tick(DspConfiguration& config, const IntermediateMixSamples& r
                        IntermediateMixSamples& write_samples,
                        const std::array<QuadFrame32, 3>& input) {
     ParseConfig(config);
+    return Mix(read_samples, write_samples, input);
+}
 
+DspStatus Mixers::Mix(const IntermediateMixSamples& read_samples,
+                      IntermediateMixSamples& write_samples,
+                      const std::array<QuadFrame32, 3>& input) {
     AuxReturn(read_samples);
     AuxSend(write_samples, input);
 
@@ -188,6 +193,10 @@ void Mixers::MixCurrentFrame() {
     current_frame.fill({});
 
     for (std::size_t mix = 0; mix < 3; mix++) {
+        // A muted mix adds nothing to the already clamped frame
+        if (state.intermediate_mixer_volume[mix] == 0.0f) {
+            continue;
+        }
         DownmixAndMixIntoCurrentFrame(state.intermediate_mixer_volume[mix],
                                       state.intermediate_mix_buffer[mix]);
     }
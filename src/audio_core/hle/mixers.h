@@ -22,6 +22,13 @@ public:
     DspStatus Tick(DspConfiguration& config, const IntermediateMixSamples& read_samples,
                    IntermediateMixSamples& write_samples, const std::array<QuadFrame32, 3>& input);
 
+    /// The first half of Tick, updates our internal state based on the current config.
+    void ParseConfig(DspConfiguration& config);
+
+    /// The second half of Tick, mixes the intermediate mixes into the output frame.
+    DspStatus Mix(const IntermediateMixSamples& read_samples,
+                  IntermediateMixSamples& write_samples, const std::array<QuadFrame32, 3>& input);
+
     StereoFrame16 GetOutput() const {
         return current_frame;
     }
@@ -42,8 +49,6 @@ private:
 
     } state;
 
-    /// INTERNAL: Update our internal state based on the current config.
-    void ParseConfig(DspConfiguration& config);
     /// INTERNAL: Read samples from shared memory that have been modified by the ARM11.
     void AuxReturn(const IntermediateMixSamples& read_samples);
     /// INTERNAL: Write samples to shared memory for the ARM11 to modify.
@@ -0,0 +1,105 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstring>
+#include "audio_core/hle/common.h"
+#include "audio_core/hle/offline_renderer.h"
+#include "common/assert.h"
+#include "core/memory.h"
+
+namespace AudioCore::HLE {
+
+StereoFrame16 GenerateFrame(std::span<Source> sources, Mixers& mixers, SharedMemory& read,
+                            SharedMemory& write) {
+    ASSERT(sources.size() == num_sources);
+
+    std::array<QuadFrame32, 3> intermediate_mixes = {};
+
+    // Generate intermediate mixes
+    for (std::size_t i = 0; i < num_sources; i++) {
+        write.source_statuses.status[i] =
+            sources[i].Tick(read.source_configurations.config[i], read.adpcm_coefficients.coeff[i]);
+    }
+    Source::FilterFrames(sources);
+    for (std::size_t i = 0; i < num_sources; i++) {
+        for (std::size_t mix = 0; mix < 3; mix++) {
+            sources[i].MixInto(intermediate_mixes[mix], mix);
+        }
+    }
+
+    // Generate final mix
+    write.dsp_status = mixers.Tick(read.dsp_configuration, read.intermediate_mix_samples,
+                                   write.intermediate_mix_samples, intermediate_mixes);
+
+    StereoFrame16 output_frame = mixers.GetOutput();
+
+    // Write current output frame to the shared memory region
+    for (std::size_t samplei = 0; samplei < output_frame.size(); samplei++) {
+        for (std::size_t channeli = 0; channeli < output_frame[0].size(); channeli++) {
+            write.final_samples.pcm16[samplei][channeli] = s16_le(output_frame[samplei][channeli]);
+        }
+    }
+
+    return output_frame;
+}
+
+OfflineRenderer::OfflineRenderer(Memory::MemorySystem& memory_)
+    : memory{memory_}, read{std::make_unique<SharedMemory>()},
+      write{std::make_unique<SharedMemory>()} {
+    sources.reserve(num_sources);
+    for (std::size_t i = 0; i < num_sources; i++) {
+        sources.emplace_back(i).SetMemory(memory);
+    }
+}
+
+OfflineRenderer::~OfflineRenderer() = default;
+
+void OfflineRenderer::SetCapture(FrameCaptureWriter* capture_) {
+    capture = capture_;
+    for (Source& source : sources) {
+        source.SetCapture(capture);
+    }
+}
+
+StereoFrame16 OfflineRenderer::RenderFrame(const SharedMemory& read_region) {
+    if (capture) {
+        capture->BeginFrame(read_region);
+    }
+    std::memcpy(read.get(), &read_region, sizeof(SharedMemory));
+    const StereoFrame16 output = GenerateFrame(sources, mixers, *read, *write);
+    if (capture) {
+        capture->EndFrame(output);
+    }
+    return output;
+}
+
+StereoFrame16 OfflineRenderer::ReplayFrame(const CapturedFrame& frame) {
+    for (const CapturedFrame::MemoryBlock& block : frame.memory_blocks) {
+        if (u8* const dest = memory.GetPhysicalPointer(block.address)) {
+            std::memcpy(dest, block.data.data(), block.data.size());
+        }
+    }
+    std::memcpy(read.get(), frame.read_region.get(), sizeof(SharedMemory));
+    return GenerateFrame(sources, mixers, *read, *write);
+}
+
+OfflineRenderer::ReplayResult OfflineRenderer::Replay(std::span<const CapturedFrame> frames) {
+    ReplayResult result{frames.size(), 0, 0.0};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const CapturedFrame& frame : frames) {
+        if (HashFrame(ReplayFrame(frame)) != frame.output_hash) {
+            result.num_mismatches++;
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (elapsed.count() > 0.0) {
+        result.frames_per_second = static_cast<double>(frames.size()) / elapsed.count();
+    }
+    return result;
+}
+
+} // namespace AudioCore::HLE
@@ -0,0 +1,68 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+#include "audio_core/audio_types.h"
+#include "audio_core/hle/frame_capture.h"
+#include "audio_core/hle/mixers.h"
+#include "audio_core/hle/shared_memory.h"
+#include "audio_core/hle/source.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+namespace AudioCore::HLE {
+
+/**
+ * Generates one audio frame as DspHle does every audio tick. The configuration in the read region
+ * is consumed and the statuses and output samples are written to the write region.
+ * @param sources All num_sources sources.
+ * @return The final mix.
+ */
+StereoFrame16 GenerateFrame(std::span<Source> sources, Mixers& mixers, SharedMemory& read,
+                            SharedMemory& write);
+
+/**
+ * Runs the HLE audio pipeline without an emulated system, at maximum speed. Frames captured with
+ * FrameCaptureWriter are replayed to benchmark the pipeline and to check its output.
+ */
+class OfflineRenderer final {
+public:
+    struct ReplayResult {
+        std::size_t num_frames;
+        /// Frames whose output differs from the one that was captured
+        std::size_t num_mismatches;
+        double frames_per_second;
+    };
+
+    explicit OfflineRenderer(Memory::MemorySystem& memory);
+    ~OfflineRenderer();
+
+    /// Sets the capture that RenderFrame records to, or nullptr
+    void SetCapture(FrameCaptureWriter* capture);
+
+    /// Generates a frame from the read region, leaving the given region untouched
+    StereoFrame16 RenderFrame(const SharedMemory& read_region);
+
+    /// Restores the guest memory of a captured frame and generates it
+    StereoFrame16 ReplayFrame(const CapturedFrame& frame);
+
+    /// Replays a whole capture, timing it and comparing the output of every frame
+    ReplayResult Replay(std::span<const CapturedFrame> frames);
+
+private:
+    Memory::MemorySystem& memory;
+    std::vector<Source> sources;
+    Mixers mixers;
+    std::unique_ptr<SharedMemory> read;
+    std::unique_ptr<SharedMemory> write;
+    FrameCaptureWriter* capture = nullptr;
+};
+
+} // namespace AudioCore::HLE
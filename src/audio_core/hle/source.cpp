@@ -6,6 +6,7 @@
 #include <array>
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
+#include "audio_core/hle/frame_capture.h"
 #include "audio_core/hle/source.h"
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
@@ -17,7 +18,10 @@ namespace AudioCore::HLE {
 SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
                                   const s16_le (&adpcm_coeffs)[16]) {
     ParseConfig(config, adpcm_coeffs);
+    return GenerateFrameStatus();
+}
 
+SourceStatus::Status Source::GenerateFrameStatus() {
     if (state.enabled) {
         GenerateFrame();
     }
@@ -25,11 +29,33 @@ SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
     return GetCurrentStatus();
 }
 
+void Source::FilterFrames(std::span<Source> sources) {
+    std::array<SourceFilters*, num_sources> filters;
+    std::array<StereoFrame16*, num_sources> frames;
+    std::size_t count = 0;
+    for (Source& source : sources) {
+        if (!source.filter_pending) {
+            continue;
+        }
+        source.filter_pending = false;
+        filters[count] = &source.state.filters;
+        frames[count] = &source.current_frame;
+        count++;
+    }
+    SourceFilters::ProcessFrames(std::span{filters.data(), count},
+                                 std::span{frames.data(), count});
+}
+
 void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
     if (!state.enabled)
         return;
 
     const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
+    // Sources usually only feed one of the intermediate mixes
+    if (std::ranges::all_of(gains, [](float gain) { return gain == 0.0f; })) {
+        return;
+    }
+
     for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
         // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
         dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
@@ -41,6 +67,7 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
 
 void Source::Reset() {
     current_frame.fill({});
+    filter_pending = false;
     state = {};
 }
 
@@ -48,6 +75,10 @@ void Source::SetMemory(Memory::MemorySystem& memory) {
     memory_system = &memory;
 }
 
+void Source::SetCapture(FrameCaptureWriter* capture_) {
+    capture = capture_;
+}
+
 void Source::ParseConfig(SourceConfiguration::Configuration& config,
                          const s16_le (&adpcm_coeffs)[16]) {
     if (!config.dirty_raw) {
@@ -183,11 +214,8 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
         const u8* const memory =
             memory_system->GetPhysicalPointer(state.current_buffer_physical_address & 0xFFFFFFFC);
 
-        // TODO(xperia64): This could potentially be optimized by only decoding the new data and
-        // appending that to the buffer.
         if (memory) {
             const unsigned num_channels = state.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
-            bool valid = false;
             switch (state.format) {
             case Format::PCM8:
                 // TODO(xperia64): This may just work fine like PCM16, but I haven't tested and
@@ -195,10 +223,30 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
                 UNIMPLEMENTED_MSG("{} not handled for partial buffer updates", "PCM8");
                 // state.current_buffer = Codec::DecodePCM8(num_channels, memory, config.length);
                 break;
-            case Format::PCM16:
-                state.current_buffer = Codec::DecodePCM16(num_channels, memory, config.length);
-                valid = true;
+            case Format::PCM16: {
+                // Because our interpolation consumes samples instead of using an index, only the
+                // samples from the current sample number onwards are decoded. There may be some
+                // imprecision here with the current sample number, as Detective Pikachu sounds a
+                // little rough at times.
+                // TODO(xperia64): Tomodachi life apparently can decrease config.length when the
+                // user skips dialog. I don't know the correct behavior, but to avoid crashing,
+                // just reset the current sample number to 0 and don't try to truncate the buffer
+                u32 first_sample = state.current_sample_number;
+                if (config.length < first_sample) {
+                    state.current_sample_number = 0;
+                    first_sample = 0;
+                }
+                const std::size_t offset = std::size_t{first_sample} * num_channels * 2;
+                const std::size_t num_samples = config.length - first_sample;
+                if (capture) {
+                    const PAddr address = state.current_buffer_physical_address & 0xFFFFFFFC;
+                    capture->AddMemoryBlock(static_cast<PAddr>(address + offset),
+                                            {memory + offset, num_samples * num_channels * 2});
+                }
+                state.current_buffer =
+                    Codec::DecodePCM16(num_channels, memory + offset, num_samples);
                 break;
+            }
             case Format::ADPCM:
                 // TODO(xperia64): Are partial embedded buffer updates even valid for ADPCM? What
                 // about the adpcm state?
@@ -211,24 +259,6 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
                 UNIMPLEMENTED();
                 break;
             }
-
-            // Again, because our interpolation consumes samples instead of using an index, let's
-            // just re-consume the samples up to the current sample number. There may be some
-            // imprecision here with the current sample number, as Detective Pikachu sounds a little
-            // rough at times.
-            if (valid) {
-
-                // TODO(xperia64): Tomodachi life apparently can decrease config.length when the
-                // user skips dialog. I don't know the correct behavior, but to avoid crashing, just
-                // reset the current sample number to 0 and don't try to truncate the buffer
-                if (state.current_buffer.size() < state.current_sample_number) {
-                    state.current_sample_number = 0;
-                } else {
-                    state.current_buffer.erase(
-                        state.current_buffer.begin(),
-                        std::next(state.current_buffer.begin(), state.current_sample_number));
-                }
-            }
         }
         LOG_TRACE(Audio_DSP, "partially updating embedded buffer addr={:#010x} len={} id={}",
                   state.current_buffer_physical_address, config.length, config.buffer_id);
@@ -344,9 +374,8 @@ void Source::GenerateFrame() {
                                 current_frame, frame_position);
             break;
         case InterpolationMode::Polyphase:
-            // TODO(merry): Implement polyphase interpolation
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            AudioInterp::Polyphase(state.interp_state, state.current_buffer,
+                                   state.rate_multiplier, current_frame, frame_position);
             break;
         default:
             UNIMPLEMENTED();
@@ -357,7 +386,23 @@ void Source::GenerateFrame() {
     // over time
     state.next_sample_number += static_cast<u32>(frame_position * state.rate_multiplier);
 
-    state.filters.ProcessFrame(current_frame);
+    filter_pending = true;
+}
+
+std::size_t Source::GetBufferSize(const Buffer& buf, unsigned num_channels) {
+    switch (buf.format) {
+    case Format::PCM8:
+        return std::size_t{buf.length} * num_channels;
+    case Format::PCM16:
+        return std::size_t{buf.length} * num_channels * sizeof(s16);
+    case Format::ADPCM: {
+        // Decoding is rounded to an even number of samples, in frames of 14 samples in 8 bytes
+        const std::size_t num_samples = buf.length + (buf.length & 1);
+        return (num_samples + 13) / 14 * 8;
+    }
+    default:
+        return 0;
+    }
 }
 
 bool Source::DequeueBuffer() {
@@ -380,6 +425,10 @@ bool Source::DequeueBuffer() {
     const u8* const memory = memory_system->GetPhysicalPointer(buf.physical_address & 0xFFFFFFFC);
     if (memory) {
         const unsigned num_channels = buf.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
+        if (capture) {
+            capture->AddMemoryBlock(buf.physical_address & 0xFFFFFFFC,
+                                    {memory, GetBufferSize(buf, num_channels)});
+        }
         switch (buf.format) {
         case Format::PCM8:
             state.current_buffer = Codec::DecodePCM8(num_channels, memory, buf.length);
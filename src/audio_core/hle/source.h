@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <span>
 #include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/deque.hpp>
@@ -24,6 +25,8 @@ class MemorySystem;
 
 namespace AudioCore::HLE {
 
+class FrameCaptureWriter;
+
 /**
  * This module performs:
  * - Buffer management
@@ -45,8 +48,12 @@ public:
     /// Sets the memory system to read data from
     void SetMemory(Memory::MemorySystem& memory);
 
+    /// Sets the capture that records the guest memory this source reads, or nullptr
+    void SetCapture(FrameCaptureWriter* capture);
+
     /**
-     * This is called once every audio frame. This performs per-source processing every frame.
+     * This is called once every audio frame. This performs per-source processing every frame,
+     * except for filtering, which is done for all sources at once by FilterFrames.
      * @param config The new configuration we've got for this Source from the application.
      * @param adpcm_coeffs ADPCM coefficients to use if config tells us to use them (may contain
      * invalid values otherwise).
@@ -56,6 +63,27 @@ public:
     SourceStatus::Status Tick(SourceConfiguration::Configuration& config,
                               const s16_le (&adpcm_coeffs)[16]);
 
+    /**
+     * The first half of Tick, updates our internal state based on the current config. This is
+     * the only part that touches the shared memory region.
+     * @param config The new configuration we've got for this Source from the application.
+     * @param adpcm_coeffs ADPCM coefficients to use if config tells us to use them.
+     */
+    void ParseConfig(SourceConfiguration::Configuration& config, const s16_le (&adpcm_coeffs)[16]);
+
+    /**
+     * The second half of Tick, generates the audio output for this frame.
+     * @return The current status of this Source.
+     */
+    SourceStatus::Status GenerateFrameStatus();
+
+    /**
+     * Applies the filters of every source to the frame it just generated. This must be called
+     * after GenerateFrameStatus and before MixInto.
+     * @param sources The sources whose frames were generated.
+     */
+    static void FilterFrames(std::span<Source> sources);
+
     /**
      * Mix this source's output into dest, using the gains for the `intermediate_mix_id`-th
      * intermediate mixer.
@@ -67,7 +95,10 @@ public:
 private:
     const std::size_t source_id;
     Memory::MemorySystem* memory_system;
+    FrameCaptureWriter* capture = nullptr;
     StereoFrame16 current_frame;
+    /// Whether current_frame was generated and still has to go through the filters
+    bool filter_pending = false;
 
     using Format = SourceConfiguration::Configuration::Format;
     using InterpolationMode = SourceConfiguration::Configuration::InterpolationMode;
@@ -185,13 +216,13 @@ private:
 
     // Internal functions
 
-    /// INTERNAL: Update our internal state based on the current config.
-    void ParseConfig(SourceConfiguration::Configuration& config, const s16_le (&adpcm_coeffs)[16]);
     /// INTERNAL: Generate the current audio output for this frame based on our internal state.
     void GenerateFrame();
     /// INTERNAL: Dequeues a buffer and does preprocessing on it (decoding, resampling). Puts it
     /// into current_buffer.
     bool DequeueBuffer();
+    /// INTERNAL: Size in bytes of the guest memory a buffer is decoded from.
+    static std::size_t GetBufferSize(const Buffer& buf, unsigned num_channels);
     /// INTERNAL: Generates a SourceStatus::Status based on our internal state.
     SourceStatus::Status GetCurrentStatus();
 
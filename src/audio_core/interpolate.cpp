@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cmath>
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
@@ -13,8 +14,38 @@ namespace AudioCore::AudioInterp {
 constexpr u64 scale_factor = 1 << 24;
 constexpr u64 scale_mask = scale_factor - 1;
 
+constexpr std::size_t num_polyphase_phases = 256;
+constexpr u64 polyphase_shift = 24 - 8;
+
+/// Filter taps for each of the phases between two samples, sampled from the Catmull-Rom cubic
+/// kernel. The upper bits of the fractional position select the phase.
+static std::array<std::array<float, 4>, num_polyphase_phases> MakePolyphaseCoefficients() {
+    const auto catmull_rom = [](double x) {
+        x = std::abs(x);
+        if (x < 1.0) {
+            return 1.5 * x * x * x - 2.5 * x * x + 1.0;
+        }
+        if (x < 2.0) {
+            return -0.5 * x * x * x + 2.5 * x * x - 4.0 * x + 2.0;
+        }
+        return 0.0;
+    };
+
+    std::array<std::array<float, 4>, num_polyphase_phases> table{};
+    for (std::size_t phase = 0; phase < num_polyphase_phases; phase++) {
+        const double t = static_cast<double>(phase) / num_polyphase_phases;
+        for (std::size_t tap = 0; tap < 4; tap++) {
+            table[phase][tap] =
+                static_cast<float>(catmull_rom(t + 1.0 - static_cast<double>(tap)));
+        }
+    }
+    return table;
+}
+
+static const auto polyphase_coefficients = MakePolyphaseCoefficients();
+
 /// Here we step over the input in steps of rate, until we consume all of the input.
-/// Three adjacent samples are passed to fn each step.
+/// Four adjacent samples are passed to fn each step, the output lies between the second and third.
 template <typename Function>
 static void StepOverSamples(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
                             std::size_t& outputi, Function fn) {
@@ -28,6 +59,7 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
     const u64 step_size = static_cast<u64>(rate * scale_factor);
     u64 fposition = state.fposition;
     std::size_t inputi = 0;
+    const std::array<s16, 2> xn3 = state.xn3;
 
     while (outputi < output.size()) {
         inputi = static_cast<std::size_t>(fposition / scale_factor);
@@ -38,11 +70,14 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
         }
 
         u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+        const auto& xm1 = inputi > 0 ? input[inputi - 1] : xn3;
+        output[outputi++] =
+            fn(fraction, xm1, input[inputi], input[inputi + 1], input[inputi + 2]);
 
         fposition += step_size;
     }
 
+    state.xn3 = inputi > 0 ? input[inputi - 1] : xn3;
     state.xn2 = input[inputi];
     state.xn1 = input[inputi + 1];
     state.fposition = fposition - inputi * scale_factor;
@@ -54,14 +89,17 @@ void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output
           std::size_t& outputi) {
     StepOverSamples(
         state, input, rate, output, outputi,
-        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; });
+        [](u64 fraction, const auto& xm1, const auto& x0, const auto& x1, const auto& x2) {
+            return x0;
+        });
 }
 
 void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
             std::size_t& outputi) {
     // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
     StepOverSamples(state, input, rate, output, outputi,
-                    [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
+                    [](u64 fraction, const auto& xm1, const auto& x0, const auto& x1,
+                       const auto& x2) {
                         // This is a saturated subtraction. (Verified by black-box fuzzing.)
                         s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
                         s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
@@ -73,4 +111,21 @@ void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& outp
                     });
 }
 
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi) {
+    StepOverSamples(state, input, rate, output, outputi,
+                    [](u64 fraction, const auto& xm1, const auto& x0, const auto& x1,
+                       const auto& x2) {
+                        const auto& taps = polyphase_coefficients[fraction >> polyphase_shift];
+                        std::array<s16, 2> result;
+                        for (std::size_t channel = 0; channel < 2; channel++) {
+                            const float sample = taps[0] * xm1[channel] + taps[1] * x0[channel] +
+                                                 taps[2] * x1[channel] + taps[3] * x2[channel];
+                            result[channel] =
+                                static_cast<s16>(std::clamp(std::lround(sample), -32768L, 32767L));
+                        }
+                        return result;
+                    });
+}
+
 } // namespace AudioCore::AudioInterp
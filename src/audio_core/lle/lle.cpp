@@ -4,11 +4,14 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <teakra/teakra.h>
 #include "audio_core/lle/lle.h"
 #include "common/assert.h"
 #include "common/bit_field.h"
+#include "common/microprofile.h"
+#include "common/settings.h"
 #include "common/swap.h"
 #include "common/thread.h"
 #include "core/core.h"
@@ -16,6 +19,8 @@
 #include "core/hle/lock.h"
 #include "core/hle/service/dsp/dsp_dsp.h"
 
+MICROPROFILE_DEFINE(Audio_LLE_Slice, "Audio", "LLE Slice", MP_RGB(100, 160, 100));
+
 namespace AudioCore {
 
 enum class SegmentType : u8 {
@@ -121,7 +126,9 @@ static u8 PipeIndexToSlotIndex(u8 pipe_index, PipeDirection direction) {
 }
 
 struct DspLle::Impl final {
-    Impl(bool multithread) : multithread(multithread) {
+    Impl(bool multithread)
+        : multithread(multithread),
+          relaxed_sync(multithread && Settings::values.enable_dsp_lle_relaxed_sync.GetValue()) {
         teakra_slice_event = Core::System::GetInstance().CoreTiming().RegisterEvent(
             "DSP slice", [this](u64, int late) { TeakraSliceEvent(static_cast<u64>(late)); });
     }
@@ -145,12 +152,24 @@ struct DspLle::Impl final {
     std::atomic<bool> stop_signal = false;
     std::size_t stop_generation;
 
+    /// Lets slices grow while the ARM11 and the DSP don't interact
+    const bool relaxed_sync;
+    /// Length of the slice the DSP thread runs after the next barrier
+    std::atomic<u32> slice_length = TeakraSlice;
+    /// Set when pipes, semaphores or data registers were used since the last barrier
+    std::atomic<bool> interacted = false;
+    u64 num_slices = 0;
+    u64 num_slice_cycles = 0;
+    std::chrono::nanoseconds barrier_wait{};
+
     static constexpr u32 DspDataOffset = 0x40000;
     static constexpr u32 TeakraSlice = 16384;
+    static constexpr u32 MaxRelaxedSlice = TeakraSlice * 8;
 
     void TeakraThread() {
+        Common::SetCurrentThreadRole(Common::ThreadRole::Audio);
         while (true) {
-            teakra.Run(TeakraSlice);
+            teakra.Run(slice_length);
             teakra_slice_barrier.Sync();
             if (stop_signal) {
                 if (stop_generation == teakra_slice_barrier.Generation())
@@ -169,17 +188,39 @@ struct DspLle::Impl final {
         }
     }
 
-    void RunTeakraSlice() {
-        if (multithread) {
-            teakra_slice_barrier.Sync();
-        } else {
+    /// Runs a DSP slice, returns the length of the slice the DSP runs next
+    u32 RunTeakraSlice() {
+        MICROPROFILE_SCOPE(Audio_LLE_Slice);
+        Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                              Core::PerfStats::Subsystem::Audio};
+        if (!multithread) {
             teakra.Run(TeakraSlice);
+            return TeakraSlice;
         }
+
+        // The length must be published before the barrier, the DSP thread reads it right after
+        u32 next = TeakraSlice;
+        if (relaxed_sync && !interacted.exchange(false)) {
+            next = std::min(slice_length * 2, MaxRelaxedSlice);
+        }
+        slice_length = next;
+
+        const auto wait_begin = std::chrono::steady_clock::now();
+        teakra_slice_barrier.Sync();
+        barrier_wait += std::chrono::steady_clock::now() - wait_begin;
+        num_slices++;
+        num_slice_cycles += next;
+        return next;
+    }
+
+    /// Forces the next slice back to the base length, so the other side sees the change soon
+    void MarkInteraction() {
+        interacted = true;
     }
 
     void TeakraSliceEvent(u64 late) {
-        RunTeakraSlice();
-        u64 next = TeakraSlice * 2; // DSP runs at clock rate half of the CPU rate
+        const u32 slice = RunTeakraSlice();
+        u64 next = slice * 2; // DSP runs at clock rate half of the CPU rate
         if (next < late)
             next = 0;
         else
@@ -219,6 +260,7 @@ struct DspLle::Impl final {
     }
 
     void WritePipe(u8 pipe_index, const std::vector<u8>& data) {
+        MarkInteraction();
         PipeStatus pipe_status = GetPipeStatus(pipe_index, PipeDirection::CPUtoDSP);
         bool need_update = false;
         const u8* buffer_ptr = data.data();
@@ -257,6 +299,7 @@ struct DspLle::Impl final {
     }
 
     std::vector<u8> ReadPipe(u8 pipe_index, u16 bsize) {
+        MarkInteraction();
         PipeStatus pipe_status = GetPipeStatus(pipe_index, PipeDirection::DSPtoCPU);
         bool need_update = false;
         std::vector<u8> data(bsize);
@@ -372,10 +415,22 @@ struct DspLle::Impl final {
 
         Core::System::GetInstance().CoreTiming().UnscheduleEvent(teakra_slice_event, 0);
         StopTeakraThread();
+
+        if (multithread && num_slices > 0) {
+            const double wait_us =
+                std::chrono::duration<double, std::micro>(barrier_wait).count();
+            LOG_INFO(Audio_DSP,
+                     "DSP slices: {}, average length {} cycles, average barrier wait {:.1f} us",
+                     num_slices, num_slice_cycles / num_slices, wait_us / num_slices);
+        }
+        num_slices = 0;
+        num_slice_cycles = 0;
+        barrier_wait = {};
     }
 };
 
 u16 DspLle::RecvData(u32 register_number) {
+    impl->MarkInteraction();
     while (!impl->teakra.RecvDataIsReady(register_number)) {
         impl->RunTeakraSlice();
     }
@@ -387,6 +442,7 @@ bool DspLle::RecvDataIsReady(u32 register_number) const {
 }
 
 void DspLle::SetSemaphore(u16 semaphore_value) {
+    impl->MarkInteraction();
     impl->teakra.SetSemaphore(semaphore_value);
 }
 
@@ -411,6 +467,7 @@ void DspLle::SetServiceToInterrupt(std::weak_ptr<Service::DSP::DSP_DSP> dsp) {
         if (!impl->loaded)
             return;
 
+        impl->MarkInteraction();
         std::lock_guard lock(HLE::g_hle_lock);
         if (auto locked = dsp.lock()) {
             locked->SignalInterrupt(Service::DSP::DSP_DSP::InterruptType::Zero,
@@ -421,6 +478,7 @@ void DspLle::SetServiceToInterrupt(std::weak_ptr<Service::DSP::DSP_DSP> dsp) {
         if (!impl->loaded)
             return;
 
+        impl->MarkInteraction();
         std::lock_guard lock(HLE::g_hle_lock);
         if (auto locked = dsp.lock()) {
             locked->SignalInterrupt(Service::DSP::DSP_DSP::InterruptType::One,
@@ -432,6 +490,7 @@ void DspLle::SetServiceToInterrupt(std::weak_ptr<Service::DSP::DSP_DSP> dsp) {
         if (!impl->loaded)
             return;
 
+        impl->MarkInteraction();
         auto& teakra = impl->teakra;
         if (event_from_data) {
             impl->data_signaled = true;
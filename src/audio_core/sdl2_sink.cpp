@@ -14,6 +14,7 @@ namespace AudioCore {
 
 struct SDL2Sink::Impl {
     unsigned int sample_rate = 0;
+    u32 device_latency = 0;
 
     SDL_AudioDeviceID audio_device_id = 0;
 
@@ -22,7 +23,7 @@ struct SDL2Sink::Impl {
     static void Callback(void* impl_, u8* buffer, int buffer_size_in_bytes);
 };
 
-SDL2Sink::SDL2Sink(std::string device_name) : impl(std::make_unique<Impl>()) {
+SDL2Sink::SDL2Sink(std::string device_name, bool low_latency) : impl(std::make_unique<Impl>()) {
     if (SDL_Init(SDL_INIT_AUDIO) < 0) {
         LOG_CRITICAL(Audio_Sink, "SDL_Init(SDL_INIT_AUDIO) failed with: {}", SDL_GetError());
         impl->audio_device_id = 0;
@@ -34,7 +35,8 @@ SDL2Sink::SDL2Sink(std::string device_name) : impl(std::make_unique<Impl>()) {
     desired_audiospec.format = AUDIO_S16;
     desired_audiospec.channels = 2;
     desired_audiospec.freq = native_sample_rate;
-    desired_audiospec.samples = 512;
+    // The buffer of SDL is the only latency it lets us pick, the driver may round it up
+    desired_audiospec.samples = low_latency ? 128 : 512;
     desired_audiospec.userdata = impl.get();
     desired_audiospec.callback = &Impl::Callback;
 
@@ -47,7 +49,14 @@ SDL2Sink::SDL2Sink(std::string device_name) : impl(std::make_unique<Impl>()) {
     }
 
     impl->audio_device_id =
-        SDL_OpenAudioDevice(device, false, &desired_audiospec, &obtained_audiospec, 0);
+        SDL_OpenAudioDevice(device, false, &desired_audiospec, &obtained_audiospec,
+                            low_latency ? SDL_AUDIO_ALLOW_SAMPLES_CHANGE : 0);
+    if (impl->audio_device_id <= 0 && low_latency) {
+        LOG_WARNING(Audio_Sink, "Low latency SDL audio device refused, using 512 samples");
+        desired_audiospec.samples = 512;
+        impl->audio_device_id =
+            SDL_OpenAudioDevice(device, false, &desired_audiospec, &obtained_audiospec, 0);
+    }
     if (impl->audio_device_id <= 0) {
         LOG_CRITICAL(Audio_Sink, "SDL_OpenAudioDevice failed with code {} for device \"{}\"",
                      impl->audio_device_id, device_name);
@@ -55,6 +64,9 @@ SDL2Sink::SDL2Sink(std::string device_name) : impl(std::make_unique<Impl>()) {
     }
 
     impl->sample_rate = obtained_audiospec.freq;
+    impl->device_latency = obtained_audiospec.samples;
+    LOG_INFO(Audio_Sink, "SDL audio device opened with {} frames of device latency",
+             impl->device_latency);
 
     // SDL2 audio devices start out paused, unpause it:
     SDL_PauseAudioDevice(impl->audio_device_id, 0);
@@ -78,6 +90,10 @@ void SDL2Sink::SetCallback(std::function<void(s16*, std::size_t)> cb) {
     impl->cb = cb;
 }
 
+u32 SDL2Sink::GetDeviceLatency() const {
+    return impl->device_latency;
+}
+
 void SDL2Sink::Impl::Callback(void* impl_, u8* buffer, int buffer_size_in_bytes) {
     Impl* impl = reinterpret_cast<Impl*>(impl_);
     if (!impl || !impl->cb)
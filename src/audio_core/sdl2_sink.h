@@ -12,13 +12,15 @@ namespace AudioCore {
 
 class SDL2Sink final : public Sink {
 public:
-    explicit SDL2Sink(std::string device_id);
+    explicit SDL2Sink(std::string device_id, bool low_latency);
     ~SDL2Sink() override;
 
     unsigned int GetNativeSampleRate() const override;
 
     void SetCallback(std::function<void(s16*, std::size_t)> cb) override;
 
+    u32 GetDeviceLatency() const override;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl;
@@ -30,6 +30,12 @@ public:
      * @param sample_count Number of samples.
      */
     virtual void SetCallback(std::function<void(s16*, std::size_t)> cb) = 0;
+
+    /// The latency of the output device the sink opened, zero when the sink cannot tell.
+    /// (Units: frames at the native rate)
+    virtual u32 GetDeviceLatency() const {
+        return 0;
+    }
 };
 
 } // namespace AudioCore
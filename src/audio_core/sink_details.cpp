@@ -25,7 +25,7 @@
 namespace AudioCore {
 namespace {
 struct SinkDetails {
-    using FactoryFn = std::unique_ptr<Sink> (*)(std::string_view);
+    using FactoryFn = std::unique_ptr<Sink> (*)(std::string_view, bool);
     using ListDevicesFn = std::vector<std::string> (*)();
 
     /// Name for this sink.
@@ -40,27 +40,27 @@ struct SinkDetails {
 constexpr SinkDetails sink_details[] = {
 #ifdef HAVE_CUBEB
     SinkDetails{"cubeb",
-                [](std::string_view device_id) -> std::unique_ptr<Sink> {
-                    return std::make_unique<CubebSink>(device_id);
+                [](std::string_view device_id, bool low_latency) -> std::unique_ptr<Sink> {
+                    return std::make_unique<CubebSink>(device_id, low_latency);
                 },
                 &ListCubebSinkDevices},
 #endif
 #ifdef HAVE_SDL2
     SinkDetails{"sdl2",
-                [](std::string_view device_id) -> std::unique_ptr<Sink> {
-                    return std::make_unique<SDL2Sink>(std::string(device_id));
+                [](std::string_view device_id, bool low_latency) -> std::unique_ptr<Sink> {
+                    return std::make_unique<SDL2Sink>(std::string(device_id), low_latency);
                 },
                 &ListSDL2SinkDevices},
 #endif
 #if TARGET_OS_IPHONE
     SinkDetails{"coreaudio",
-                [](std::string_view device_id) -> std::unique_ptr<Sink> {
+                [](std::string_view device_id, bool) -> std::unique_ptr<Sink> {
                     return std::make_unique<CoreAudioSink>(std::string(device_id));
                 },
                 &ListCoreAudioSinkDevices},
 #endif
     SinkDetails{"null",
-                [](std::string_view device_id) -> std::unique_ptr<Sink> {
+                [](std::string_view device_id, bool) -> std::unique_ptr<Sink> {
                     return std::make_unique<NullSink>(device_id);
                 },
                 [] { return std::vector<std::string>{"null"}; }},
@@ -97,8 +97,9 @@ std::vector<std::string> GetDeviceListForSink(std::string_view sink_id) {
     return GetSinkDetails(sink_id).list_devices();
 }
 
-std::unique_ptr<Sink> CreateSinkFromID(std::string_view sink_id, std::string_view device_id) {
-    return GetSinkDetails(sink_id).factory(device_id);
+std::unique_ptr<Sink> CreateSinkFromID(std::string_view sink_id, std::string_view device_id,
+                                       bool low_latency) {
+    return GetSinkDetails(sink_id).factory(device_id, low_latency);
 }
 
 } // namespace AudioCore
@@ -18,7 +18,12 @@ std::vector<const char*> GetSinkIDs();
 /// Gets the list of devices for a particular sink identified by the given ID.
 std::vector<std::string> GetDeviceListForSink(std::string_view sink_id);
 
-/// Creates an audio sink identified by the given device ID.
-std::unique_ptr<Sink> CreateSinkFromID(std::string_view sink_id, std::string_view device_id);
+/**
+ * Creates an audio sink identified by the given device ID. With low_latency the sink asks the
+ * backend for the smallest buffer the device supports, falling back to its default latency
+ * if the device refuses it.
+ */
+std::unique_ptr<Sink> CreateSinkFromID(std::string_view sink_id, std::string_view device_id,
+                                       bool low_latency);
 
 } // namespace AudioCore
@@ -74,4 +74,8 @@ void TimeStretcher::Flush() {
     sound_touch->flush();
 }
 
+std::size_t TimeStretcher::GetBufferedFrames() const {
+    return sound_touch->numSamples();
+}
+
 } // namespace AudioCore
@@ -33,6 +33,9 @@ public:
 
     void Flush();
 
+    /// Returns the number of stretched frames waiting to be returned.
+    std::size_t GetBufferedFrames() const;
+
 private:
     unsigned int sample_rate;
     std::unique_ptr<soundtouch::SoundTouch> sound_touch;
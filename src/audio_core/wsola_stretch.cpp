@@ -0,0 +1,219 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include "audio_core/audio_types.h"
+#include "audio_core/wsola_stretch.h"
+#include "common/logging/log.h"
+
+namespace AudioCore {
+
+namespace {
+
+/// Frames produced by each segment, about 8 ms at the native sample rate
+constexpr std::size_t SegmentLength = 256;
+/// Frames cross-faded between consecutive segments
+constexpr std::size_t OverlapLength = 64;
+/// Maximum shift in frames when matching a segment to the previous one
+constexpr std::ptrdiff_t SeekWindow = 64;
+/// Input frames that must be available past the read position to produce a segment
+constexpr std::size_t SegmentInput = SeekWindow + SegmentLength + OverlapLength;
+/// Consumed input is only discarded in batches to reduce copying
+constexpr std::size_t CompactThreshold = 0x1000;
+
+constexpr double MinTargetLatency = 0.020; // seconds
+constexpr double MaxTargetLatency = 0.100; // seconds
+/// Input arriving while this much audio is buffered is dropped
+constexpr double MaxLatency = 4 * MaxTargetLatency; // seconds
+/// After this long without an underrun the target latency is lowered again
+constexpr double TargetDecayTime = 5.0; // seconds
+
+constexpr double MinRatio = 0.25;
+constexpr double MaxRatio = 4.0;
+
+s16 ClampSample(float sample) {
+    return static_cast<s16>(std::clamp(std::lround(sample), -32768L, 32767L));
+}
+
+} // Anonymous namespace
+
+WsolaStretcher::WsolaStretcher()
+    : sample_rate(native_sample_rate), target_latency(MinTargetLatency),
+      stats_target_latency(MinTargetLatency) {
+    Clear();
+}
+
+WsolaStretcher::~WsolaStretcher() = default;
+
+void WsolaStretcher::SetOutputSampleRate(unsigned int sample_rate_) {
+    sample_rate = sample_rate_;
+}
+
+std::size_t WsolaStretcher::Process(const s16* in, std::size_t num_in, s16* out,
+                                    std::size_t num_out) {
+    if (static_cast<double>(GetBufferedFrames()) > MaxLatency * sample_rate) {
+        // Too much audio is buffered, emulation is running faster than the sink
+        num_in = 0;
+    }
+    input.insert(input.end(), in, in + num_in * 2);
+    UpdateRatio(num_in, num_out);
+
+    std::size_t frames_written = 0;
+    while (frames_written < num_out) {
+        if (output_read == output.size() && !ProcessSegment()) {
+            break;
+        }
+        const std::size_t count =
+            std::min((output.size() - output_read) / 2, num_out - frames_written);
+        std::memcpy(out + frames_written * 2, output.data() + output_read,
+                    count * 2 * sizeof(s16));
+        output_read += count * 2;
+        frames_written += count;
+    }
+
+    // Only count the first callback that runs out of audio after a stream was playing, so
+    // startup and pauses do not inflate the target
+    const double time_delta = static_cast<double>(num_out) / sample_rate;
+    const bool was_playing = std::exchange(playing, frames_written == num_out);
+    if (frames_written < num_out && was_playing) {
+        underruns++;
+        target_latency = std::min(target_latency * 1.5, MaxTargetLatency);
+        time_since_underrun = 0.0;
+    } else if ((time_since_underrun += time_delta) > TargetDecayTime) {
+        target_latency = std::max(target_latency * 0.8, MinTargetLatency);
+        time_since_underrun = 0.0;
+    }
+
+    stats_ratio = ratio;
+    stats_latency = static_cast<double>(GetBufferedFrames()) / sample_rate;
+    stats_target_latency = target_latency;
+    return frames_written;
+}
+
+void WsolaStretcher::Clear() {
+    // Pad the start so the first segment can seek backwards
+    input.assign(SeekWindow * 2, 0);
+    position = SeekWindow;
+    output.clear();
+    output_read = 0;
+    overlap.assign(OverlapLength * 2, 0.0f);
+    overlap_mono.assign(OverlapLength, 0.0f);
+    input_rate = 1.0;
+    ratio = 1.0;
+    playing = false;
+}
+
+void WsolaStretcher::Flush() {
+    // Pass the remaining input through unstretched
+    const std::size_t base = std::min(static_cast<std::size_t>(std::lround(position)) * 2,
+                                      input.size());
+    output.erase(output.begin(), output.begin() + output_read);
+    output.insert(output.end(), input.begin() + base, input.end());
+    output_read = 0;
+    input.assign(SeekWindow * 2, 0);
+    position = SeekWindow;
+}
+
+WsolaStretcher::Stats WsolaStretcher::GetStats() const {
+    return Stats{stats_ratio, stats_latency, stats_target_latency, underruns};
+}
+
+bool WsolaStretcher::ProcessSegment() {
+    const std::size_t base = static_cast<std::size_t>(std::lround(position));
+    if (base + SegmentInput > input.size() / 2) {
+        return false;
+    }
+
+    const std::size_t start = base + FindBestOffset(base);
+    const s16* segment = input.data() + start * 2;
+
+    output.resize(SegmentLength * 2);
+    output_read = 0;
+    for (std::size_t i = 0; i < OverlapLength; i++) {
+        const float fade_in = (static_cast<float>(i) + 0.5f) / OverlapLength;
+        for (std::size_t c = 0; c < 2; c++) {
+            const float sample = overlap[i * 2 + c] * (1.0f - fade_in) +
+                                 static_cast<float>(segment[i * 2 + c]) * fade_in;
+            output[i * 2 + c] = ClampSample(sample);
+        }
+    }
+    std::memcpy(output.data() + OverlapLength * 2, segment + OverlapLength * 2,
+                (SegmentLength - OverlapLength) * 2 * sizeof(s16));
+
+    const s16* continuation = segment + SegmentLength * 2;
+    for (std::size_t i = 0; i < OverlapLength; i++) {
+        overlap[i * 2 + 0] = continuation[i * 2 + 0];
+        overlap[i * 2 + 1] = continuation[i * 2 + 1];
+        overlap_mono[i] = overlap[i * 2 + 0] + overlap[i * 2 + 1];
+    }
+
+    position += SegmentLength * ratio;
+
+    const std::size_t consumed = static_cast<std::size_t>(position) - SeekWindow;
+    if (consumed >= CompactThreshold) {
+        input.erase(input.begin(), input.begin() + consumed * 2);
+        position -= static_cast<double>(consumed);
+    }
+    return true;
+}
+
+std::ptrdiff_t WsolaStretcher::FindBestOffset(std::size_t base) const {
+    // Normalized cross-correlation of the downmixed overlap against each candidate position
+    const auto correlate = [&](std::ptrdiff_t offset) {
+        const s16* candidate = input.data() + (base + offset) * 2;
+        float correlation = 0.0f;
+        float energy = 1.0f;
+        for (std::size_t i = 0; i < OverlapLength; i++) {
+            const float mono = static_cast<float>(candidate[i * 2]) + candidate[i * 2 + 1];
+            correlation += overlap_mono[i] * mono;
+            energy += mono * mono;
+        }
+        return correlation / std::sqrt(energy);
+    };
+
+    // Prefer no shift on ties so silence and unstretched audio pass through unchanged
+    std::ptrdiff_t best_offset = 0;
+    float best_correlation = correlate(0);
+    for (std::ptrdiff_t offset = -SeekWindow; offset <= SeekWindow; offset++) {
+        const float correlation = correlate(offset);
+        if (correlation > best_correlation) {
+            best_correlation = correlation;
+            best_offset = offset;
+        }
+    }
+    return best_offset;
+}
+
+std::size_t WsolaStretcher::GetBufferedFrames() const {
+    const double pending_input = static_cast<double>(input.size() / 2) - position;
+    const std::size_t pending_output = (output.size() - output_read) / 2;
+    return static_cast<std::size_t>(std::max(pending_input, 0.0)) + pending_output;
+}
+
+void WsolaStretcher::UpdateRatio(std::size_t num_in, std::size_t num_out) {
+    if (num_out == 0) {
+        return;
+    }
+    const double time_delta = static_cast<double>(num_out) / sample_rate; // seconds
+
+    // Smooth out the bursty rate at which the emulator delivers audio
+    constexpr double rate_time_scale = 0.5; // seconds
+    const double rate_gain = 1.0 - std::exp(-time_delta / rate_time_scale);
+    input_rate += rate_gain * (static_cast<double>(num_in) / num_out - input_rate);
+
+    // Speed up when the audio left after this callback is above the latency target and slow
+    // down when it is below it
+    const double buffered = static_cast<double>(GetBufferedFrames());
+    const double latency = (buffered - static_cast<double>(num_out)) / sample_rate;
+    const double error = std::clamp((latency - target_latency) / target_latency, -1.0, 1.0);
+    ratio = std::clamp(input_rate * (1.0 + 0.5 * error), MinRatio, MaxRatio);
+
+    LOG_TRACE(Audio, "{:5}/{:5} ratio:{:0.6f} latency:{:0.4f} target:{:0.4f}", num_in, num_out,
+              ratio, latency, target_latency);
+}
+
+} // namespace AudioCore
@@ -0,0 +1,81 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/**
+ * A lightweight time stretcher based on waveform similarity overlap-add (WSOLA).
+ * Unlike TimeStretcher, it does not keep a fixed backlog: the stretch ratio is driven by how far
+ * the buffered audio is from a latency target. The target starts small and only grows when the
+ * sink runs dry, so the latency stays as low as the host allows.
+ */
+class WsolaStretcher {
+public:
+    struct Stats {
+        double ratio;          ///< Current stretch ratio, input frames per output frame
+        double latency;        ///< Buffered audio in seconds
+        double target_latency; ///< Latency the stretcher is steering towards in seconds
+        u64 underruns;         ///< Number of callbacks that could not be filled
+    };
+
+    WsolaStretcher();
+    ~WsolaStretcher();
+
+    void SetOutputSampleRate(unsigned int sample_rate);
+
+    /// @param in       Input sample buffer
+    /// @param num_in   Number of input frames in `in`
+    /// @param out      Output sample buffer
+    /// @param num_out  Desired number of output frames in `out`
+    /// @returns Actual number of frames written to `out`
+    std::size_t Process(const s16* in, std::size_t num_in, s16* out, std::size_t num_out);
+
+    void Clear();
+
+    void Flush();
+
+    /// Returns the stretcher metrics, safe to call from any thread.
+    Stats GetStats() const;
+
+    /// Returns the number of input and output frames waiting to be played.
+    std::size_t GetBufferedFrames() const;
+
+private:
+    /// Produces the next output segment, returns false when there is not enough input.
+    bool ProcessSegment();
+    /// Finds the shift around `base` whose audio best continues the previous segment.
+    std::ptrdiff_t FindBestOffset(std::size_t base) const;
+    void UpdateRatio(std::size_t num_in, std::size_t num_out);
+
+    unsigned int sample_rate;
+    double input_rate = 1.0;
+    double ratio = 1.0;
+    double target_latency;
+    double time_since_underrun = 0.0;
+    bool playing = false;
+
+    /// Interleaved stereo input, frames before `position` have been consumed
+    std::vector<s16> input;
+    double position;
+    /// Interleaved stereo output that has not been returned yet
+    std::vector<s16> output;
+    std::size_t output_read = 0;
+    /// Natural continuation of the last segment, cross-faded into the next one
+    std::vector<float> overlap;
+    std::vector<float> overlap_mono;
+
+    std::atomic<double> stats_ratio = 1.0;
+    std::atomic<double> stats_latency = 0.0;
+    std::atomic<double> stats_target_latency;
+    std::atomic<u64> underruns = 0;
+};
+
+} // namespace AudioCore
@@ -2,17 +2,23 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <regex>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 // This needs to be included before getopt.h because the latter #defines symbols used by it
 #include "citra/config.h"
 #include "citra/emu_window/emu_window_sdl2.h"
 #include "common/common_paths.h"
 #include "common/detached_tasks.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
@@ -20,16 +26,23 @@
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/dumping/backend.h"
 #include "core/frontend/applets/default_applets.h"
 #include "core/frontend/framebuffer_layout.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/cfg/cfg.h"
+#include "core/hw/gpu.h"
+#include "core/memory.h"
 #include "core/movie.h"
+#include "core/savestate.h"
+#include "core/tracer/player.h"
 #include "input_common/main.h"
 #include "network/network.h"
+#include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_base.h"
+#include "video_core/shader/shader.h"
 #include "video_core/video_core.h"
 
 #undef _UNICODE
@@ -61,6 +74,22 @@ static void PrintHelp(const char* argv0) {
                  "-a, --movie-record-author=AUTHOR Sets the author of the movie to be recorded\n"
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
                  "-d, --dump-video=[file]    Dumps audio and video to the given video file\n"
+                 "--load-state=SLOT    Loads the save state in the given slot after booting\n"
+                 "--benchmark=FRAMES   Runs FRAMES frames without frame limit, then prints\n"
+                 "                     performance statistics as JSON and exits\n"
+                 "--replay-trace=FILE  Replays a CiTrace instead of running the title, repeated\n"
+                 "                     as many times as --benchmark gives, and prints frame\n"
+                 "                     times and the final top screen hash as JSON\n"
+                 "--frame-log=FILE     Writes the host time and the top screen hash of every\n"
+                 "                     frame to FILE, use with --movie-play for repeatable runs\n"
+                 "--frame-baseline=FILE Compares the frames against a log written by --frame-log,\n"
+                 "                     prints the results as JSON and fails if the output\n"
+                 "                     diverged or the frame times regressed\n"
+                 "--profile=FILE       Writes the profiling scopes of the last frames before exit\n"
+                 "                     to FILE as Chrome trace JSON, also readable by Perfetto\n"
+                 "--headless           Runs without showing a window or presenting frames, for\n"
+                 "                     automated runs. Hosts without a display can use\n"
+                 "                     SDL_VIDEODRIVER=offscreen\n"
                  "-f, --fullscreen     Start in fullscreen mode\n"
                  "-h, --help           Display this help and exit\n"
                  "-v, --version        Output version information and exit\n";
@@ -70,6 +99,193 @@ static void PrintVersion() {
     std::cout << "Citra " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
 }
 
+struct FrametimeStats {
+    double mean{};
+    double p50{};
+    double p95{};
+    double p99{};
+};
+
+static FrametimeStats GetFrametimeStats(std::vector<double> frametimes) {
+    if (frametimes.empty()) {
+        return {};
+    }
+    double total{};
+    for (const double frametime : frametimes) {
+        total += frametime;
+    }
+    std::sort(frametimes.begin(), frametimes.end());
+    const auto percentile = [&frametimes](std::size_t p) {
+        return frametimes[(frametimes.size() - 1) * p / 100];
+    };
+    return {total / frametimes.size(), percentile(50), percentile(95), percentile(99)};
+}
+
+static void PrintBenchmarkResults(Core::System& system, u64 num_frames,
+                                  std::vector<double> frametimes,
+                                  std::chrono::steady_clock::duration wall_time,
+                                  const VideoCore::RasterizerCacheStats& boot_cache_stats) {
+    const Core::PerfStats::Results results = system.GetAndResetPerfStats();
+    const FrametimeStats stats = GetFrametimeStats(std::move(frametimes));
+    const double seconds = std::chrono::duration<double>(wall_time).count();
+    std::string subsystems;
+    for (std::size_t i = 0; i < Core::PerfStats::NumSubsystems; ++i) {
+        subsystems += fmt::format(
+            "{}\"{}\": {:.3f}", i == 0 ? "" : ", ",
+            Core::PerfStats::GetSubsystemName(static_cast<Core::PerfStats::Subsystem>(i)),
+            results.subsystem_time[i] * 1000.0);
+    }
+    // Only the benchmarked frames are counted, the cache activity while booting is left out
+    const VideoCore::RasterizerCacheStats cache_stats =
+        system.Renderer().Rasterizer()->GetTotalCacheStats();
+    std::string cache_counters;
+    for (const auto& [name, member] : VideoCore::RasterizerCacheStats::Fields) {
+        cache_counters += fmt::format("{}\"{}\": {}", cache_counters.empty() ? "" : ", ", name,
+                                      cache_stats.*member - boot_cache_stats.*member);
+    }
+    const Pica::Shader::ShaderEngineStats shader_stats = Pica::Shader::GetEngine()->GetStats();
+    std::cout << fmt::format(
+        "{{\"revision\": \"{}\", \"frames\": {}, \"seconds\": {:.3f}, \"average_fps\": {:.2f}, "
+        "\"frametime_ms\": {{\"mean\": {:.3f}, \"p50\": {:.3f}, \"p95\": {:.3f}, "
+        "\"p99\": {:.3f}}}, \"emulation_speed\": {:.4f}, \"system_fps\": {:.2f}, "
+        "\"game_fps\": {:.2f}, \"frametime\": {:.6f}, \"input_latency_ms\": {:.3f}, "
+        "\"subsystem_ms\": {{{}}}, \"rasterizer_cache\": {{{}}}, "
+        "\"shader_engine\": {{\"programs_compiled\": {}, \"programs_evicted\": {}, "
+        "\"cache_bytes\": {}}}}}",
+        Common::g_scm_desc, num_frames, seconds, seconds > 0 ? num_frames / seconds : 0.0,
+        stats.mean, stats.p50, stats.p95, stats.p99, results.emulation_speed, results.system_fps,
+        results.game_fps, results.frametime, results.input_latency * 1000.0, subsystems,
+        cache_counters, shader_stats.programs_compiled, shader_stats.programs_evicted,
+        shader_stats.cache_bytes)
+              << std::endl;
+}
+
+/// Hashes the top screen framebuffer in emulated memory, after flushing the rendered surfaces
+static u64 HashTopScreen(Memory::MemorySystem& memory) {
+    VideoCore::g_renderer->Rasterizer()->FlushAll();
+    const auto& framebuffer = GPU::g_regs.framebuffer_config[0];
+    const PAddr addr =
+        framebuffer.second_fb_active ? framebuffer.address_left2 : framebuffer.address_left1;
+    const u32 size = framebuffer.stride * framebuffer.height;
+    if (size == 0 || !memory.IsValidPhysicalAddress(addr) ||
+        !memory.IsValidPhysicalAddress(addr + size - 1)) {
+        return 0;
+    }
+    return Common::ComputeHash64(memory.GetPhysicalPointer(addr), size);
+}
+
+static bool ReplayTrace(Core::System& system, const std::string& filename, u32 iterations) {
+    CiTrace::Player player{system.Memory()};
+    if (!player.Load(filename)) {
+        return false;
+    }
+
+    std::vector<double> frametimes;
+    frametimes.reserve(player.GetNumFrames() * iterations);
+    u64 framebuffer_hash{};
+    for (u32 i = 0; i < iterations; i++) {
+        player.Reset();
+        auto frame_begin = std::chrono::steady_clock::now();
+        while (player.ReplayFrame()) {
+            const auto frame_end = std::chrono::steady_clock::now();
+            frametimes.push_back(
+                std::chrono::duration<double, std::milli>(frame_end - frame_begin).count());
+            frame_begin = frame_end;
+        }
+        framebuffer_hash = HashTopScreen(system.Memory());
+    }
+
+    const FrametimeStats stats = GetFrametimeStats(frametimes);
+    std::cout << fmt::format(
+                     "{{\"revision\": \"{}\", \"trace\": \"{}\", \"iterations\": {}, "
+                     "\"frames\": {}, \"frametime_ms\": {{\"mean\": {:.3f}, \"p50\": {:.3f}, "
+                     "\"p95\": {:.3f}, \"p99\": {:.3f}}}, \"framebuffer_hash\": \"{:016x}\"}}",
+                     Common::g_scm_desc, filename, iterations, frametimes.size(), stats.mean,
+                     stats.p50, stats.p95, stats.p99, framebuffer_hash)
+              << std::endl;
+    return true;
+}
+
+/// Host time and output of one emulated frame, as recorded by --frame-log
+struct FrameRecord {
+    double frametime;
+    u64 hash;
+};
+
+/// Frame times may regress by this fraction of the baseline before the comparison fails
+constexpr double FrametimeTolerance = 0.1;
+
+static std::string SerializeFrameLog(const std::vector<FrameRecord>& frames) {
+    std::string log = fmt::format("# citra frame log, revision {}\n", Common::g_scm_desc);
+    for (const FrameRecord& frame : frames) {
+        log += fmt::format("{:.4f} {:016x}\n", frame.frametime, frame.hash);
+    }
+    return log;
+}
+
+static std::optional<std::vector<FrameRecord>> LoadFrameLog(const std::string& filename) {
+    std::string log;
+    if (FileUtil::ReadFileToString(true, filename, log) == 0) {
+        return std::nullopt;
+    }
+    std::vector<FrameRecord> frames;
+    std::istringstream stream(log);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        FrameRecord frame;
+        std::istringstream fields(line);
+        if (!(fields >> frame.frametime >> std::hex >> frame.hash)) {
+            LOG_ERROR(Frontend, "Invalid line in the frame log {}: {}", filename, line);
+            return std::nullopt;
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+/**
+ * Compares the recorded frames against the baseline and prints the results as JSON.
+ * @returns true if the output matched the baseline and the frame times did not regress
+ */
+static bool CompareFrameLog(const std::vector<FrameRecord>& frames,
+                            const std::vector<FrameRecord>& baseline) {
+    const std::size_t num_frames = std::min(frames.size(), baseline.size());
+    std::optional<std::size_t> first_divergent_frame;
+    if (frames.size() != baseline.size()) {
+        first_divergent_frame = num_frames;
+    }
+    std::vector<double> frametimes;
+    std::vector<double> baseline_frametimes;
+    frametimes.reserve(num_frames);
+    baseline_frametimes.reserve(num_frames);
+    for (std::size_t i = 0; i < num_frames; i++) {
+        if (!first_divergent_frame && frames[i].hash != baseline[i].hash) {
+            first_divergent_frame = i;
+        }
+        frametimes.push_back(frames[i].frametime);
+        baseline_frametimes.push_back(baseline[i].frametime);
+    }
+
+    // Only frames that exist in both runs are compared, so that the times stay comparable
+    const FrametimeStats stats = GetFrametimeStats(std::move(frametimes));
+    const FrametimeStats baseline_stats = GetFrametimeStats(std::move(baseline_frametimes));
+    const bool regressed = stats.mean > baseline_stats.mean * (1.0 + FrametimeTolerance) ||
+                           stats.p95 > baseline_stats.p95 * (1.0 + FrametimeTolerance);
+    std::cout << fmt::format(
+                     "{{\"revision\": \"{}\", \"frames\": {}, \"baseline_frames\": {}, "
+                     "\"first_divergent_frame\": {}, \"frametime_ms\": {{\"mean\": {:.3f}, "
+                     "\"p95\": {:.3f}}}, \"baseline_frametime_ms\": {{\"mean\": {:.3f}, "
+                     "\"p95\": {:.3f}}}, \"regressed\": {}}}",
+                     Common::g_scm_desc, frames.size(), baseline.size(),
+                     first_divergent_frame ? std::to_string(*first_divergent_frame) : "null",
+                     stats.mean, stats.p95, baseline_stats.mean, baseline_stats.p95, regressed)
+              << std::endl;
+    return !first_divergent_frame && !regressed;
+}
+
 static void OnStateChanged(const Network::RoomMember::State& state) {
     switch (state) {
     case Network::RoomMember::State::Idle:
@@ -191,6 +407,12 @@ int main(int argc, char** argv) {
     std::string movie_record_author;
     std::string movie_play;
     std::string dump_video;
+    u32 load_state_slot = 0;
+    u32 benchmark_frames = 0;
+    std::string replay_trace;
+    std::string profile_capture;
+    std::string frame_log;
+    std::string frame_baseline;
 
     InitializeLogging();
 
@@ -208,6 +430,7 @@ int main(int argc, char** argv) {
 
     bool use_multiplayer = false;
     bool fullscreen = false;
+    bool headless = false;
     std::string nickname{};
     std::string password{};
     std::string address{};
@@ -221,6 +444,13 @@ int main(int argc, char** argv) {
         {"movie-record-author", required_argument, 0, 'a'},
         {"movie-play", required_argument, 0, 'p'},
         {"dump-video", required_argument, 0, 'd'},
+        {"load-state", required_argument, 0, 's'},
+        {"benchmark", required_argument, 0, 'b'},
+        {"replay-trace", required_argument, 0, 't'},
+        {"profile", required_argument, 0, 'P'},
+        {"frame-log", required_argument, 0, 'l'},
+        {"frame-baseline", required_argument, 0, 'B'},
+        {"headless", no_argument, 0, 'H'},
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
@@ -297,6 +527,42 @@ int main(int argc, char** argv) {
             case 'd':
                 dump_video = optarg;
                 break;
+            case 's':
+                errno = 0;
+                load_state_slot = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || load_state_slot == 0 ||
+                    load_state_slot > Core::SaveStateSlotCount)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--load-state");
+                    exit(1);
+                }
+                break;
+            case 'b':
+                errno = 0;
+                benchmark_frames = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || benchmark_frames == 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--benchmark");
+                    exit(1);
+                }
+                break;
+            case 't':
+                replay_trace = optarg;
+                break;
+            case 'P':
+                profile_capture = optarg;
+                break;
+            case 'l':
+                frame_log = optarg;
+                break;
+            case 'B':
+                frame_baseline = optarg;
+                break;
+            case 'H':
+                headless = true;
+                break;
             case 'f':
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
@@ -335,6 +601,20 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    std::vector<FrameRecord> baseline_frames;
+    if (!frame_baseline.empty()) {
+        auto frames = LoadFrameLog(frame_baseline);
+        if (!frames) {
+            LOG_CRITICAL(Frontend, "Failed to load the frame baseline {}", frame_baseline);
+            return -1;
+        }
+        baseline_frames = std::move(*frames);
+    }
+    const bool record_frames = !frame_log.empty() || !frame_baseline.empty();
+    if (record_frames && movie_play.empty()) {
+        LOG_WARNING(Frontend, "Frames are recorded without a movie, the output may not repeat");
+    }
+
     if (!movie_record.empty()) {
         Core::Movie::GetInstance().PrepareForRecording();
     }
@@ -345,6 +625,9 @@ int main(int argc, char** argv) {
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (benchmark_frames != 0 || !replay_trace.empty() || record_frames) {
+        Settings::values.frame_limit.SetValue(0);
+    }
     Settings::Apply();
 
     // Register frontend applets
@@ -352,11 +635,11 @@ int main(int argc, char** argv) {
 
     EmuWindow_SDL2::InitializeSDL2();
 
-    const auto emu_window{std::make_unique<EmuWindow_SDL2>(fullscreen, false)};
-    const bool use_secondary_window{Settings::values.layout_option.GetValue() ==
-                                    Settings::LayoutOption::SeparateWindows};
+    const auto emu_window{std::make_unique<EmuWindow_SDL2>(fullscreen, false, headless)};
+    const bool use_secondary_window{!headless && Settings::values.layout_option.GetValue() ==
+                                                     Settings::LayoutOption::SeparateWindows};
     const auto secondary_window =
-        use_secondary_window ? std::make_unique<EmuWindow_SDL2>(false, true) : nullptr;
+        use_secondary_window ? std::make_unique<EmuWindow_SDL2>(false, true, false) : nullptr;
 
     const auto scope = emu_window->Acquire();
 
@@ -424,6 +707,11 @@ int main(int argc, char** argv) {
         LOG_INFO(Movie, "Rerecord count: {}", metadata.rerecord_count);
         LOG_INFO(Movie, "Input count: {}", metadata.input_count);
         Core::Movie::GetInstance().StartPlayback(movie_play);
+        if (record_frames) {
+            // The movie drives the whole run when the frames are compared
+            Core::Movie::GetInstance().SetPlaybackCompletionCallback(
+                [&emu_window] { emu_window->RequestClose(); });
+        }
     }
     if (!movie_record.empty()) {
         Core::Movie::GetInstance().StartRecording(movie_record, movie_record_author);
@@ -434,7 +722,12 @@ int main(int argc, char** argv) {
         system.VideoDumper().StartDumping(dump_video, layout);
     }
 
-    std::thread main_render_thread([&emu_window] { emu_window->Present(); });
+    // Without a presenter the renderer keeps reusing the oldest frame of the mailbox
+    std::thread main_render_thread([&emu_window, headless] {
+        if (!headless) {
+            emu_window->Present();
+        }
+    });
     std::thread secondary_render_thread([&secondary_window] {
         if (secondary_window) {
             secondary_window->Present();
@@ -448,12 +741,67 @@ int main(int argc, char** argv) {
                       total);
         });
 
+    if (load_state_slot != 0) {
+        try {
+            system.LoadState(load_state_slot);
+        } catch (const std::exception& e) {
+            LOG_CRITICAL(Frontend, "Failed to load the state in slot {}: {}", load_state_slot,
+                         e.what());
+            return -1;
+        }
+    }
+
+    if (!profile_capture.empty()) {
+        Common::Profiling::StartCapture();
+    }
+
+    // Only the frames from here on are benchmarked
+    [[maybe_unused]] const Core::PerfStats::Results boot_results = system.GetAndResetPerfStats();
+    const VideoCore::RasterizerCacheStats boot_cache_stats =
+        system.Renderer().Rasterizer()->GetTotalCacheStats();
+    const auto benchmark_begin = std::chrono::steady_clock::now();
+
     const auto secondary_is_open = [&secondary_window] {
         // if the secondary window isn't created, it shouldn't affect the main loop
         return secondary_window ? secondary_window->IsOpen() : true;
     };
+    // The title is only booted to set up the system, the trace replaces its GPU work
+    if (!replay_trace.empty()) {
+        if (!ReplayTrace(system, replay_trace, std::max(benchmark_frames, 1U))) {
+            LOG_CRITICAL(Frontend, "Failed to replay the trace {}", replay_trace);
+        }
+        benchmark_frames = 0;
+        emu_window->RequestClose();
+    }
+
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation);
+    std::vector<FrameRecord> frames;
+    // Frame times of the benchmarked frames, as measured by PerfStats
+    std::vector<double> benchmark_frametimes;
+    u64 num_frames = 0;
+    u64 last_system_frame = system.GetPerfStats()->GetNumSystemFrames();
+    auto frame_begin = std::chrono::steady_clock::now();
     while (emu_window->IsOpen() && secondary_is_open()) {
+        if (benchmark_frames != 0 && num_frames >= benchmark_frames) {
+            break;
+        }
         const auto result = system.RunLoop();
+        const u64 system_frame = system.GetPerfStats()->GetNumSystemFrames();
+        if (system_frame != last_system_frame) {
+            num_frames += system_frame - last_system_frame;
+            last_system_frame = system_frame;
+            if (benchmark_frames != 0) {
+                benchmark_frametimes.push_back(system.GetPerfStats()->GetLastFrametime());
+            }
+            if (record_frames) {
+                const auto frame_end = std::chrono::steady_clock::now();
+                // Hashing flushes the rasterizer cache, which is left out of the frame time
+                frames.push_back(FrameRecord{
+                    std::chrono::duration<double, std::milli>(frame_end - frame_begin).count(),
+                    HashTopScreen(system.Memory())});
+                frame_begin = std::chrono::steady_clock::now();
+            }
+        }
 
         switch (result) {
         case Core::System::ResultStatus::ShutdownRequested:
@@ -466,6 +814,19 @@ int main(int argc, char** argv) {
             break;
         }
     }
+    if (benchmark_frames != 0) {
+        PrintBenchmarkResults(system, num_frames, std::move(benchmark_frametimes),
+                              std::chrono::steady_clock::now() - benchmark_begin,
+                              boot_cache_stats);
+    }
+    if (!profile_capture.empty()) {
+        Common::Profiling::StopCapture(profile_capture);
+    }
+    if (!frame_log.empty() &&
+        FileUtil::WriteStringToFile(true, frame_log, SerializeFrameLog(frames)) == 0) {
+        LOG_ERROR(Frontend, "Failed to write the frame log {}", frame_log);
+    }
+    const bool frames_match = frame_baseline.empty() || CompareFrameLog(frames, baseline_frames);
     emu_window->RequestClose();
     if (secondary_window) {
         secondary_window->RequestClose();
@@ -484,5 +845,5 @@ int main(int argc, char** argv) {
     system.Shutdown();
 
     detached_tasks.WaitForAllTasks();
-    return 0;
+    return frames_match ? 0 : 1;
 }
@@ -102,17 +102,50 @@ void Config::ReadValues() {
     Settings::values.current_input_profile.udp_input_port =
         static_cast<u16>(sdl2_config->GetInteger("Controls", "udp_input_port",
                                                  InputCommon::CemuhookUDP::DEFAULT_PORT));
+    Settings::values.late_input_sampling =
+        sdl2_config->GetBoolean("Controls", "late_input_sampling", false);
 
     // Core
     Settings::values.use_cpu_jit = sdl2_config->GetBoolean("Core", "use_cpu_jit", true);
     Settings::values.cpu_clock_percentage =
         sdl2_config->GetInteger("Core", "cpu_clock_percentage", 100);
+    Settings::values.auto_cpu_clock = sdl2_config->GetBoolean("Core", "auto_cpu_clock", false);
+    Settings::values.auto_cpu_clock_min =
+        static_cast<s32>(sdl2_config->GetInteger("Core", "auto_cpu_clock_min", 100));
+    Settings::values.auto_cpu_clock_max =
+        static_cast<s32>(sdl2_config->GetInteger("Core", "auto_cpu_clock_max", 200));
+    Settings::values.parallel_cpu_cores =
+        sdl2_config->GetBoolean("Core", "parallel_cpu_cores", false);
+    Settings::values.parallel_cpu_max_skew_us =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "parallel_cpu_max_skew_us", 1000));
+    Settings::values.idle_loop_detection =
+        sdl2_config->GetBoolean("Core", "idle_loop_detection", false);
+    Settings::values.use_fastmem = sdl2_config->GetBoolean("Core", "use_fastmem", true);
+    Settings::values.use_jit_profiles =
+        sdl2_config->GetBoolean("Core", "use_jit_profiles", true);
+    Settings::values.delta_savestates =
+        sdl2_config->GetBoolean("Core", "delta_savestates", false);
+    Settings::values.rewind_seconds =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "rewind_seconds", 0));
+    Settings::values.rewind_states_per_second =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "rewind_states_per_second", 2));
+    Settings::values.rewind_memory_mb =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "rewind_memory_mb", 512));
+    Settings::values.emulation_thread_cores = static_cast<Settings::ThreadCoreType>(
+        sdl2_config->GetInteger("Core", "emulation_thread_cores", 1));
+    Settings::values.render_thread_cores = static_cast<Settings::ThreadCoreType>(
+        sdl2_config->GetInteger("Core", "render_thread_cores", 1));
+    Settings::values.audio_thread_cores = static_cast<Settings::ThreadCoreType>(
+        sdl2_config->GetInteger("Core", "audio_thread_cores", 0));
+    Settings::values.max_worker_threads =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "max_worker_threads", 0));
 
     // Renderer
     Settings::values.graphics_api =
         static_cast<Settings::GraphicsAPI>(sdl2_config->GetInteger("Renderer", "graphics_api", 0));
     Settings::values.use_hw_renderer = sdl2_config->GetBoolean("Renderer", "use_hw_renderer", true);
     Settings::values.use_hw_shader = sdl2_config->GetBoolean("Renderer", "use_hw_shader", true);
+    Settings::values.async_gpu = sdl2_config->GetBoolean("Renderer", "async_gpu", false);
 #ifdef __APPLE__
     // Separable shader is broken on macos with Intel GPU thanks to poor drivers.
     // We still want to provide this option for test/development purposes, but disable it by
@@ -123,10 +156,36 @@ void Config::ReadValues() {
     Settings::values.shaders_accurate_mul =
         sdl2_config->GetBoolean("Renderer", "shaders_accurate_mul", true);
     Settings::values.use_shader_jit = sdl2_config->GetBoolean("Renderer", "use_shader_jit", true);
+    Settings::values.large_vertex_cache =
+        sdl2_config->GetBoolean("Renderer", "large_vertex_cache", false);
+    Settings::values.gpu_texture_decoding =
+        sdl2_config->GetBoolean("Renderer", "gpu_texture_decoding", false);
+    Settings::values.hash_texture_uploads =
+        sdl2_config->GetBoolean("Renderer", "hash_texture_uploads", false);
+    Settings::values.texture_memory_budget =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "texture_memory_budget", 0));
+    Settings::values.async_pipeline_warmup =
+        sdl2_config->GetBoolean("Renderer", "async_pipeline_warmup", false);
+    Settings::values.force_uber_shader =
+        sdl2_config->GetBoolean("Renderer", "force_uber_shader", false);
+    Settings::values.specialize_hw_shaders =
+        sdl2_config->GetBoolean("Renderer", "specialize_hw_shaders", true);
+    Settings::values.low_latency_pacing =
+        sdl2_config->GetBoolean("Renderer", "low_latency_pacing", false);
+    Settings::values.dynamic_resolution =
+        sdl2_config->GetBoolean("Renderer", "dynamic_resolution", false);
+    Settings::values.dynamic_resolution_min =
+        static_cast<u16>(sdl2_config->GetInteger("Renderer", "dynamic_resolution_min", 1));
+    Settings::values.frame_skip =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "frame_skip", 0));
+    Settings::values.gpu_timing = static_cast<Settings::GpuTimingOption>(
+        sdl2_config->GetInteger("Renderer", "gpu_timing", 0));
     Settings::values.resolution_factor =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "resolution_factor", 1));
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", true);
+    Settings::values.shader_cache_read_only =
+        sdl2_config->GetBoolean("Renderer", "shader_cache_read_only", false);
     Settings::values.frame_limit =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit", 100));
     Settings::values.use_vsync_new =
@@ -180,16 +239,31 @@ void Config::ReadValues() {
 
     // Utility
     Settings::values.dump_textures = sdl2_config->GetBoolean("Utility", "dump_textures", false);
+    Settings::values.dump_textures_fast =
+        sdl2_config->GetBoolean("Utility", "dump_textures_fast", false);
     Settings::values.custom_textures = sdl2_config->GetBoolean("Utility", "custom_textures", false);
     Settings::values.preload_textures =
         sdl2_config->GetBoolean("Utility", "preload_textures", false);
+    Settings::values.async_custom_loading =
+        sdl2_config->GetBoolean("Utility", "async_custom_loading", true);
+    Settings::values.custom_textures_cache_size =
+        static_cast<u32>(sdl2_config->GetInteger("Utility", "custom_textures_cache_size", 512));
+    Settings::values.dump_dsp_frames = sdl2_config->GetBoolean("Utility", "dump_dsp_frames", false);
 
     // Audio
     Settings::values.audio_emulation = static_cast<Settings::AudioEmulation>(
         sdl2_config->GetInteger("Audio", "audio_emulation", 0));
+    Settings::values.enable_dsp_hle_thread =
+        sdl2_config->GetBoolean("Audio", "enable_dsp_hle_thread", false);
+    Settings::values.enable_dsp_lle_relaxed_sync =
+        sdl2_config->GetBoolean("Audio", "enable_dsp_lle_relaxed_sync", false);
     Settings::values.sink_id = sdl2_config->GetString("Audio", "output_engine", "auto");
     Settings::values.enable_audio_stretching =
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
+    Settings::values.enable_low_latency_stretching =
+        sdl2_config->GetBoolean("Audio", "enable_low_latency_stretching", false);
+    Settings::values.enable_low_latency_output =
+        sdl2_config->GetBoolean("Audio", "enable_low_latency_output", false);
     Settings::values.audio_device_id = sdl2_config->GetString("Audio", "output_device", "auto");
     Settings::values.volume = static_cast<float>(sdl2_config->GetReal("Audio", "volume", 1));
     Settings::values.mic_input_device =
@@ -320,6 +394,8 @@ void Config::ReadValues() {
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
+    Settings::values.rpc_shared_memory =
+        sdl2_config->GetBoolean("Debugging", "rpc_shared_memory", false);
 
     for (const auto& service_module : Service::service_module_map) {
         bool use_lle = sdl2_config->GetBoolean("Debugging", "LLE\\" + service_module.name, false);
@@ -333,6 +409,8 @@ void Config::ReadValues() {
         sdl2_config->GetString("WebService", "web_api_url", "https://api.citra-emu.org");
     NetSettings::values.citra_username = sdl2_config->GetString("WebService", "citra_username", "");
     NetSettings::values.citra_token = sdl2_config->GetString("WebService", "citra_token", "");
+    NetSettings::values.enable_direct_connections =
+        sdl2_config->GetBoolean("WebService", "enable_direct_connections", false);
 
     // Video Dumping
     Settings::values.output_format =
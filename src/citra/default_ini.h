@@ -86,6 +86,11 @@ udp_input_port=
 # The pad to request data on. Should be between 0 (Pad 1) and 3 (Pad 4). (Default 0)
 udp_pad_index=
 
+# Samples the input again right after each frame was paced, so games read the freshest input when
+# they start the next frame. Lowers input latency, but does not suit movies recorded without it.
+# 0 (default): Off, 1: On
+late_input_sampling=
+
 [Core]
 # Whether to use the Just-In-Time (JIT) compiler for CPU emulation
 # 0: Interpreter (slow), 1 (default): JIT (fast)
@@ -97,7 +102,79 @@ use_cpu_jit =
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# Adjusts the clock between auto_cpu_clock_min and auto_cpu_clock_max instead of using
+# cpu_clock_percentage. The clock goes up while the game keeps the CPU busy and the host has time
+# to spare, and down again while the game idles or the host falls behind. Turned off while a movie
+# is recorded or played, so that it replays the same way.
+# 0 (default): Off, 1: On
+auto_cpu_clock =
+# Defaults are 100 and 200
+auto_cpu_clock_min =
+auto_cpu_clock_max =
+
+# Run each emulated ARM11 core on its own host thread. Requires the CPU JIT. Cores fall back to
+# running one after the other while recording or playing a movie, or while the GDB stub is enabled.
+# 0 (default): Off, 1: On
+parallel_cpu_cores =
+
+# Maximum time in microseconds that the cores may run apart before synchronizing again when
+# parallel_cpu_cores is enabled. Lower values are more accurate, higher values are faster.
+# Range is 10 - 4000, default is 1000
+parallel_cpu_max_skew_us =
+
+# Skip ahead to the next scheduled event when a guest thread is detected spinning in a polling
+# loop that cannot make progress before then. Only used by the CPU JIT.
+# 0 (default): Off, 1: On
+idle_loop_detection =
+
+# Mirror emulated memory into host address space so that the CPU JIT can access it directly.
+# Only available on 64-bit hosts other than Windows, takes effect on the next boot.
+# 0: Off, 1 (default): On
+use_fastmem =
+
+# Build the CPU JIT with the optimizations of the title's profile. By default profiles only include
+# accurate optimizations, jit_profiles.txt in the config directory changes them per title with
+# lines like "0004000000030800 unsafe_inaccurate_nan=1" to give up accuracy for speed, or
+# "0004000000030800 accurate" to turn off every unsafe optimization for that title.
+# 0: Off, only accurate optimizations, 1 (default): On
+use_jit_profiles =
+
+# Save states after the first one only store the memory pages that changed since the last full
+# state, which is kept as their base. Loading such a state needs its base slot to be unchanged.
+# 0 (default): Off, 1: On
+delta_savestates =
+
+# How many seconds of recent gameplay are kept in memory to rewind through, takes effect on the
+# next boot. Rewinding steps back one state at a time. 0 (default): Off
+rewind_seconds =
+
+# How many states per second of emulated time are kept for rewinding. 1 - 10 (default: 2)
+rewind_states_per_second =
+
+# Upper bound of the memory used by the rewind states in MiB, older states are dropped beyond it.
+# 16 - 8192 (default: 512)
+rewind_memory_mb =
+
+# Host cores the emulation threads (CPU cores), render threads (GPU, presentation and Vulkan worker)
+# and audio threads (DSP) are kept on. Only makes a difference on CPUs with performance and
+# efficiency cores, performance cores also get a higher priority or QoS class.
+# 0: Any core, 1: Performance cores, 2: Efficiency cores
+# Defaults are 1 for the emulation and render threads and 0 for the audio threads
+emulation_thread_cores =
+render_thread_cores =
+audio_thread_cores =
+
+# Most threads each pool of background workers (texture decoding, shader compilation, transfers)
+# may use. Lower it when running many instances on one host.
+# 0 (default): Decided by the number of host cores
+max_worker_threads =
+
 [Renderer]
+# Which graphics API to render with. The null renderer draws and presents nothing, for runs that
+# only need the game logic. Fills and display transfers still reach guest memory.
+# 0 (default): OpenGL, 1: OpenGLES, 2: Vulkan, 3: Null
+graphics_api =
+
 # Whether to render using GLES or OpenGL
 # 0 (default): OpenGL, 1: GLES
 use_gles =
@@ -110,6 +187,10 @@ use_hw_renderer =
 # 0: Software, 1 (default): Hardware
 use_hw_shader =
 
+# Whether to process GPU commands on a separate thread, only supported with Vulkan
+# 0 (default): Off, 1: On
+async_gpu =
+
 # Whether to use separable shaders to emulate 3DS shaders (macOS only)
 # 0: Off (Default), 1 : On
 separable_shader =
@@ -122,6 +203,61 @@ shaders_accurate_mul =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Size of the cache of transformed vertices used by indexed draws on the software vertex path.
+# The large cache skips more shader runs, but shaders that carry state between vertices may break.
+# 0 (default): 32 vertices, 1: 1024 vertices
+large_vertex_cache =
+
+# Unswizzles and decodes tiled textures with a compute shader instead of on the CPU. This also
+# reinterprets color surfaces between formats of the same size without a guest memory round-trip
+# 0 (default): CPU, 1: GPU
+gpu_texture_decoding =
+
+# Skips re-uploading textures that the game rewrote with identical data, at the cost of hashing them
+# 0 (default): Off, 1: On
+hash_texture_uploads =
+
+# Memory in MiB that cached textures may use before unused ones are evicted
+# 0 (default): Decided by the graphics driver where possible, otherwise unlimited
+texture_memory_budget =
+
+# Starts the game while the pipelines it used in previous sessions are still being built (Vulkan)
+# 0 (default): Wait for them on the loading screen, 1: Build them in the background
+async_pipeline_warmup =
+
+# Draws with the uber fragment shader instead of per configuration shaders (OpenGL)
+# 0 (default): Only while a shader compiles asynchronously, 1: Always, for debugging
+force_uber_shader =
+
+# Builds vertex shader variants with the bool uniforms that rarely change folded into constants
+# 0: Off, 1 (default): On
+specialize_hw_shaders =
+
+# Keeps at most one frame waiting for presentation and delays emulation of the next frame so that
+# it finishes just before the display refreshes. Lowers input latency at the cost of some headroom.
+# 0 (default): Off, 1: On
+low_latency_pacing =
+
+# Lowers the resolution scale of render targets while the GPU can't keep up with full speed, and
+# raises it again up to resolution_factor once there is headroom (OpenGL)
+# 0 (default): Off, 1: On
+dynamic_resolution =
+
+# Lowest resolution scale dynamic resolution may drop to
+# 1 (default): Native 3DS screen resolution, Otherwise a scale factor for the 3DS resolution
+dynamic_resolution_min =
+
+# Skips the draws of up to this many frames in a row while the host can't render every frame at
+# full speed. Memory fills and transfers still run, and frames are drawn again whenever the game
+# reads rendered data back.
+# 0 (default): Off, 1 - 4: Most frames skipped after each drawn frame
+frame_skip =
+
+# Measures the GPU time of each frame with timestamp queries, summed over the chosen scopes, and
+# shows it next to the frame time (OpenGL)
+# 0 (default): Off, 1: Whole frame, 2: Render passes, 3: Draws
+gpu_timing =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
@@ -131,6 +267,11 @@ use_vsync_new =
 # 0: Off, 1 (default. On)
 use_disk_shader_cache =
 
+# Only reads the disk shader cache, shaders missing from it are kept in memory for the session.
+# Lets many instances share one cache without writing to it.
+# 0 (default): Off, 1: On
+shader_cache_read_only =
+
 # Resolution scale factor
 # 0: Auto (scales resolution to window size), 1: Native 3DS screen resolution, Otherwise a scale
 # factor for the 3DS resolution
@@ -162,7 +303,7 @@ bg_green =
 # 0 (default): Off, 1: Side by Side, 2: Anaglyph, 3: Interlaced, 4: Reverse Interlaced
 render_3d =
 
-# Change 3D Intensity
+# Change 3D Intensity. Titles see the slider down when render_3d is off and the left eye is shown
 # 0 - 100: Intensity. 0 (default)
 factor_3d =
 
@@ -227,6 +368,10 @@ large_screen_proportion =
 # 0 (default): Off, 1: On
 dump_textures =
 
+# Dumps textures with the fastest PNG compression. Files are larger but still lossless.
+# 0 (default): Off, 1: On
+dump_textures_fast =
+
 # Reads PNG files from load/textures/[Title ID]/ and replaces textures.
 # 0 (default): Off, 1: On
 custom_textures =
@@ -235,6 +380,18 @@ custom_textures =
 # 0 (default): Off, 1: On
 preload_textures =
 
+# Loads custom textures in the background, showing the original texture until they are ready.
+# 0: Off, 1 (default): On
+async_custom_loading =
+
+# Memory in MiB kept for decoded custom textures, least recently used ones are released beyond it.
+# Ignored when preload_textures is on. 0: Unlimited, 512 (default)
+custom_textures_cache_size =
+
+# Records the input of every HLE audio frame to dump/dsp/, to be replayed by the audio tests.
+# 0 (default): Off, 1: On
+dump_dsp_frames =
+
 [Audio]
 # Whether or not to enable DSP LLE
 # 0 (default): No, 1: Yes
@@ -244,6 +401,15 @@ enable_dsp_lle =
 # 0 (default): No, 1: Yes
 enable_dsp_lle_thread =
 
+# Whether or not multithreaded DSP LLE lengthens its time slices while the application does not
+# talk to the DSP. This lets both threads run ahead, at the cost of timing accuracy.
+# 0 (default): No, 1: Yes
+enable_dsp_lle_relaxed_sync =
+
+# Whether or not to generate DSP HLE audio frames and decode AAC audio on separate threads.
+# Frame results reach the application one audio frame later.
+# 0 (default): No, 1: Yes
+enable_dsp_hle_thread =
 
 # Which audio output engine to use.
 # auto (default): Auto-select, null: No audio output, sdl2: SDL2 (if available)
@@ -255,6 +421,18 @@ output_engine =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not audio stretching uses the low latency stretcher instead of SoundTouch.
+# It keeps as little audio buffered as the output device allows and is cheaper to run,
+# at the cost of stretching quality.
+# 0 (default): No, 1: Yes
+enable_low_latency_stretching =
+
+# Whether or not the audio output asks the device for the smallest buffer it supports.
+# Falls back to the default latency when the device refuses it. Lowers audio latency,
+# but may crackle on slow devices.
+# 0 (default): No, 1: Yes
+enable_low_latency_output =
+
 # Which audio device to use.
 # auto (default): Auto-select
 output_device =
@@ -331,6 +509,10 @@ record_frame_times =
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
+# Expose the memory of the emulated game to tools on the same computer through shared memory
+# (/citra_rpc), which is updated at the end of every frame. Not available on Windows.
+# 0 (default): No, 1: Yes
+rpc_shared_memory =
 # To LLE a service module add "LLE\<module name>=true"
 
 [WebService]
@@ -343,6 +525,10 @@ web_api_url = https://api.citra-emu.org
 # See https://profile.citra-emu.org/ for more info
 citra_username =
 citra_token =
+# Whether to send local wireless traffic directly to the other members of a room that allow it,
+# instead of through the room. This shares your IP address with those members.
+# 0 (default): No, 1: Yes
+enable_direct_connections =
 
 [Video Dumping]
 # Format of the video to output, default: webm
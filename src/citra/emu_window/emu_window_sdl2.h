@@ -29,7 +29,8 @@ private:
 
 class EmuWindow_SDL2 : public Frontend::EmuWindow {
 public:
-    explicit EmuWindow_SDL2(bool fullscreen, bool is_secondary);
+    /// A headless window is never shown, frames are rendered but not presented
+    explicit EmuWindow_SDL2(bool fullscreen, bool is_secondary, bool headless);
     ~EmuWindow_SDL2();
 
     static void InitializeSDL2();
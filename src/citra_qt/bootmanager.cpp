@@ -10,12 +10,14 @@
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
 #include <QOpenGLExtraFunctions>
+#include <QThread>
 #include <fmt/format.h>
 #include "citra_qt/bootmanager.h"
 #include "citra_qt/main.h"
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
+#include "common/thread.h"
 #include "core/3ds.h"
 #include "core/core.h"
 #include "input_common/keyboard.h"
@@ -50,6 +52,7 @@ static GMainWindow* GetMainWindow() {
 
 void EmuThread::run() {
     MicroProfileOnThreadCreate("EmuThread");
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation);
     const auto scope = core_context.Acquire();
 
     emit LoadProgress(VideoCore::LoadCallbackStage::Prepare, 0, 0);
@@ -217,6 +220,12 @@ public:
 
     virtual void Present() {}
 
+    /// Called once emulation starts, presentation can be moved off the GUI thread from here on
+    virtual void StartPresenting() {}
+
+    /// Called before emulation stops, returns presentation to the GUI thread
+    virtual void StopPresenting() {}
+
     void paintEvent(QPaintEvent* event) override {
         Present();
         update();
@@ -287,6 +296,10 @@ public:
         windowHandle()->setSurfaceType(QWindow::OpenGLSurface);
     }
 
+    ~OpenGLRenderWidget() override {
+        StopPresenting();
+    }
+
     void SetContext(std::unique_ptr<OpenGLSharedContext>&& context_) {
         context = std::move(context_);
     }
@@ -295,6 +308,49 @@ public:
         if (!isVisible()) {
             return;
         }
+        PresentFrame();
+    }
+
+    void StartPresenting() override {
+        // Without threaded GL support the frames keep being presented from paint events
+        if (present_thread || !QOpenGLContext::supportsThreadedOpenGL()) {
+            return;
+        }
+        context->DoneCurrent();
+        present_thread.reset(QThread::create([this] { PresentLoop(); }));
+        context->GetShareContext()->moveToThread(present_thread.get());
+        present_thread->start();
+    }
+
+    void StopPresenting() override {
+        if (!present_thread) {
+            return;
+        }
+        present_thread->requestInterruption();
+        present_thread->wait();
+        present_thread.reset();
+        update();
+    }
+
+    void paintEvent(QPaintEvent* event) override {
+        // The present thread does not depend on paint events, which UI activity can delay
+        if (!present_thread) {
+            RenderWidget::paintEvent(event);
+        }
+    }
+
+    void showEvent(QShowEvent* event) override {
+        RenderWidget::showEvent(event);
+        visible = true;
+    }
+
+    void hideEvent(QHideEvent* event) override {
+        visible = false;
+        RenderWidget::hideEvent(event);
+    }
+
+private:
+    void PresentFrame() {
         if (!Core::System::GetInstance().IsPoweredOn()) {
             return;
         }
@@ -306,8 +362,30 @@ public:
         f->glFinish();
     }
 
-private:
+    void PresentLoop() {
+        MicroProfileOnThreadCreate("PresentThread");
+        Common::SetCurrentThreadRole(Common::ThreadRole::Render);
+        QThread* const thread = QThread::currentThread();
+        while (!thread->isInterruptionRequested()) {
+            if (!visible) {
+                QThread::msleep(10);
+                continue;
+            }
+            // Waits for the next frame, so the loop does not spin while emulation is paused
+            PresentFrame();
+        }
+        context->DoneCurrent();
+        // Objects can only be pushed to another thread from the one they live in
+        context->GetShareContext()->moveToThread(qApp->thread());
+#if MICROPROFILE_ENABLED
+        MicroProfileOnThreadExit();
+#endif
+    }
+
     std::unique_ptr<OpenGLSharedContext> context{};
+    std::unique_ptr<QThread> present_thread;
+    /// Whether the widget is shown, read by the present thread
+    std::atomic_bool visible{};
     bool is_secondary;
 };
 
@@ -596,6 +674,9 @@ bool GRenderWindow::InitRenderTarget() {
             return false;
         }
         break;
+    case Settings::GraphicsAPI::Null:
+        InitializeNull();
+        break;
     }
 
     // Update the Window System information with the new render target
@@ -671,11 +752,25 @@ bool GRenderWindow::InitializeVulkan() {
     return true;
 }
 
+void GRenderWindow::InitializeNull() {
+    // Nothing is presented, the widget only receives the input
+    child_widget = new RenderWidget(this);
+    child_widget->windowHandle()->create();
+    main_context = std::make_unique<DummyContext>();
+}
+
 void GRenderWindow::OnEmulationStarting(EmuThread* emu_thread) {
     this->emu_thread = emu_thread;
+    if (child_widget) {
+        static_cast<RenderWidget*>(child_widget)->StartPresenting();
+    }
 }
 
 void GRenderWindow::OnEmulationStopping() {
+    // The renderer is destroyed once the emulation thread stops
+    if (child_widget) {
+        static_cast<RenderWidget*>(child_widget)->StopPresenting();
+    }
     emu_thread = nullptr;
 }
 
@@ -171,13 +171,16 @@ static constexpr int V(int r, int g, int b) {
 } // namespace YuvTable
 
 std::vector<u16> Rgb2Yuv(const QImage& source, int width, int height) {
+    // Reading whole scanlines skips the format lookup QImage::pixel does for every pixel
+    const QImage image = source.convertToFormat(QImage::Format_RGB32);
     auto buffer = std::vector<u16>(width * height);
     auto dest = buffer.begin();
     bool write = false;
     int py, pu, pv;
     for (int j = 0; j < height; ++j) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(j));
         for (int i = 0; i < width; ++i) {
-            QRgb rgb = source.pixel(i, j);
+            QRgb rgb = line[i];
             int r = qRed(rgb);
             int g = qGreen(rgb);
             int b = qBlue(rgb);
@@ -56,7 +56,7 @@ const std::array<std::array<int, 5>, Settings::NativeAnalog::NumAnalogs> Config:
 // This must be in alphabetical order according to action name as it must have the same order as
 // UISetting::values.shortcuts, which is alphabetically ordered.
 // clang-format off
-const std::array<UISettings::Shortcut, 27> Config::default_hotkeys {{
+const std::array<UISettings::Shortcut, 29> Config::default_hotkeys {{
      {QStringLiteral("Advance Frame"),            QStringLiteral("Main Window"), {QStringLiteral(""),     Qt::ApplicationShortcut}},
      {QStringLiteral("Capture Screenshot"),       QStringLiteral("Main Window"), {QStringLiteral("Ctrl+P"), Qt::WidgetWithChildrenShortcut}},
      {QStringLiteral("Continue/Pause Emulation"), QStringLiteral("Main Window"), {QStringLiteral("F4"),     Qt::WindowShortcut}},
@@ -73,6 +73,7 @@ const std::array<UISettings::Shortcut, 27> Config::default_hotkeys {{
      {QStringLiteral("Mute Audio"),               QStringLiteral("Main Window"), {QStringLiteral("Ctrl+M"), Qt::WindowShortcut}},
      {QStringLiteral("Remove Amiibo"),            QStringLiteral("Main Window"), {QStringLiteral("F3"),     Qt::ApplicationShortcut}},
      {QStringLiteral("Restart Emulation"),        QStringLiteral("Main Window"), {QStringLiteral("F6"),     Qt::WindowShortcut}},
+     {QStringLiteral("Rewind"),                   QStringLiteral("Main Window"), {QStringLiteral("Backspace"), Qt::WindowShortcut}},
      {QStringLiteral("Rotate Screens Upright"),   QStringLiteral("Main Window"), {QStringLiteral("F8"),     Qt::WindowShortcut}},
      {QStringLiteral("Save to Oldest Slot"),      QStringLiteral("Main Window"), {QStringLiteral("Ctrl+C"), Qt::WindowShortcut}},
      {QStringLiteral("Stop Emulation"),           QStringLiteral("Main Window"), {QStringLiteral("F5"),     Qt::WindowShortcut}},
@@ -81,6 +82,7 @@ const std::array<UISettings::Shortcut, 27> Config::default_hotkeys {{
      {QStringLiteral("Toggle Per-Game Speed"),    QStringLiteral("Main Window"), {QStringLiteral("Ctrl+Z"), Qt::ApplicationShortcut}},
      {QStringLiteral("Toggle Filter Bar"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+F"), Qt::WindowShortcut}},
      {QStringLiteral("Toggle Frame Advancing"),   QStringLiteral("Main Window"), {QStringLiteral("Ctrl+A"), Qt::ApplicationShortcut}},
+     {QStringLiteral("Toggle Profile Capture"),   QStringLiteral("Main Window"), {QStringLiteral(""),       Qt::ApplicationShortcut}},
      {QStringLiteral("Toggle Screen Layout"),     QStringLiteral("Main Window"), {QStringLiteral("F10"),    Qt::WindowShortcut}},
      {QStringLiteral("Toggle Status Bar"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+S"), Qt::WindowShortcut}},
      {QStringLiteral("Toggle Texture Dumping"),   QStringLiteral("Main Window"), {QStringLiteral(""),       Qt::ApplicationShortcut}},
@@ -275,6 +277,10 @@ void Config::ReadAudioValues() {
     ReadGlobalSetting(Settings::values.volume);
 
     if (global) {
+        ReadBasicSetting(Settings::values.enable_dsp_hle_thread);
+        ReadBasicSetting(Settings::values.enable_dsp_lle_relaxed_sync);
+        ReadBasicSetting(Settings::values.enable_low_latency_stretching);
+        ReadBasicSetting(Settings::values.enable_low_latency_output);
         ReadBasicSetting(Settings::values.sink_id);
         ReadBasicSetting(Settings::values.audio_device_id);
         ReadBasicSetting(Settings::values.mic_input_device);
@@ -430,6 +436,8 @@ void Config::ReadControlValues() {
 
     Settings::LoadProfile(Settings::values.current_input_profile_index);
 
+    ReadBasicSetting(Settings::values.late_input_sampling);
+
     qt_config->endGroup();
 }
 
@@ -437,8 +445,12 @@ void Config::ReadUtilityValues() {
     qt_config->beginGroup(QStringLiteral("Utility"));
 
     ReadGlobalSetting(Settings::values.dump_textures);
+    ReadGlobalSetting(Settings::values.dump_textures_fast);
     ReadGlobalSetting(Settings::values.custom_textures);
     ReadGlobalSetting(Settings::values.preload_textures);
+    ReadGlobalSetting(Settings::values.async_custom_loading);
+    ReadGlobalSetting(Settings::values.custom_textures_cache_size);
+    ReadBasicSetting(Settings::values.dump_dsp_frames);
 
     qt_config->endGroup();
 }
@@ -447,9 +459,25 @@ void Config::ReadCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     ReadGlobalSetting(Settings::values.cpu_clock_percentage);
+    ReadGlobalSetting(Settings::values.idle_loop_detection);
 
     if (global) {
         ReadBasicSetting(Settings::values.use_cpu_jit);
+        ReadBasicSetting(Settings::values.auto_cpu_clock);
+        ReadBasicSetting(Settings::values.auto_cpu_clock_min);
+        ReadBasicSetting(Settings::values.auto_cpu_clock_max);
+        ReadBasicSetting(Settings::values.parallel_cpu_cores);
+        ReadBasicSetting(Settings::values.parallel_cpu_max_skew_us);
+        ReadBasicSetting(Settings::values.use_fastmem);
+        ReadBasicSetting(Settings::values.use_jit_profiles);
+        ReadBasicSetting(Settings::values.delta_savestates);
+        ReadBasicSetting(Settings::values.rewind_seconds);
+        ReadBasicSetting(Settings::values.rewind_states_per_second);
+        ReadBasicSetting(Settings::values.rewind_memory_mb);
+        ReadBasicSetting(Settings::values.emulation_thread_cores);
+        ReadBasicSetting(Settings::values.render_thread_cores);
+        ReadBasicSetting(Settings::values.audio_thread_cores);
+        ReadBasicSetting(Settings::values.max_worker_threads);
     }
 
     qt_config->endGroup();
@@ -482,6 +510,7 @@ void Config::ReadDebuggingValues() {
         qt_config->value(QStringLiteral("record_frame_times"), false).toBool();
     ReadBasicSetting(Settings::values.use_gdbstub);
     ReadBasicSetting(Settings::values.gdbstub_port);
+    ReadBasicSetting(Settings::values.rpc_shared_memory);
     ReadBasicSetting(Settings::values.renderer_debug);
     ReadBasicSetting(Settings::values.dump_command_buffers);
 
@@ -653,6 +682,20 @@ void Config::ReadRendererValues() {
 
     if (global) {
         ReadBasicSetting(Settings::values.use_shader_jit);
+        ReadBasicSetting(Settings::values.async_gpu);
+        ReadBasicSetting(Settings::values.large_vertex_cache);
+        ReadBasicSetting(Settings::values.gpu_texture_decoding);
+        ReadBasicSetting(Settings::values.hash_texture_uploads);
+        ReadBasicSetting(Settings::values.texture_memory_budget);
+        ReadBasicSetting(Settings::values.async_pipeline_warmup);
+        ReadBasicSetting(Settings::values.force_uber_shader);
+        ReadBasicSetting(Settings::values.specialize_hw_shaders);
+        ReadBasicSetting(Settings::values.low_latency_pacing);
+        ReadBasicSetting(Settings::values.dynamic_resolution);
+        ReadBasicSetting(Settings::values.dynamic_resolution_min);
+        ReadBasicSetting(Settings::values.frame_skip);
+        ReadBasicSetting(Settings::values.shader_cache_read_only);
+        ReadBasicSetting(Settings::values.gpu_timing);
     }
 
     qt_config->endGroup();
@@ -823,6 +866,8 @@ void Config::ReadWebServiceValues() {
         ReadSetting(QStringLiteral("citra_username")).toString().toStdString();
     NetSettings::values.citra_token =
         ReadSetting(QStringLiteral("citra_token")).toString().toStdString();
+    NetSettings::values.enable_direct_connections =
+        ReadSetting(QStringLiteral("enable_direct_connections"), false).toBool();
 
     qt_config->endGroup();
 }
@@ -856,6 +901,10 @@ void Config::SaveAudioValues() {
     WriteGlobalSetting(Settings::values.volume);
 
     if (global) {
+        WriteBasicSetting(Settings::values.enable_dsp_hle_thread);
+        WriteBasicSetting(Settings::values.enable_dsp_lle_relaxed_sync);
+        WriteBasicSetting(Settings::values.enable_low_latency_stretching);
+        WriteBasicSetting(Settings::values.enable_low_latency_output);
         WriteBasicSetting(Settings::values.sink_id);
         WriteBasicSetting(Settings::values.audio_device_id);
         WriteBasicSetting(Settings::values.mic_input_device);
@@ -951,6 +1000,8 @@ void Config::SaveControlValues() {
     }
     qt_config->endArray();
 
+    WriteBasicSetting(Settings::values.late_input_sampling);
+
     qt_config->endGroup();
 }
 
@@ -958,8 +1009,12 @@ void Config::SaveUtilityValues() {
     qt_config->beginGroup(QStringLiteral("Utility"));
 
     WriteGlobalSetting(Settings::values.dump_textures);
+    WriteGlobalSetting(Settings::values.dump_textures_fast);
     WriteGlobalSetting(Settings::values.custom_textures);
     WriteGlobalSetting(Settings::values.preload_textures);
+    WriteGlobalSetting(Settings::values.async_custom_loading);
+    WriteGlobalSetting(Settings::values.custom_textures_cache_size);
+    WriteBasicSetting(Settings::values.dump_dsp_frames);
 
     qt_config->endGroup();
 }
@@ -968,9 +1023,25 @@ void Config::SaveCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     WriteGlobalSetting(Settings::values.cpu_clock_percentage);
+    WriteGlobalSetting(Settings::values.idle_loop_detection);
 
     if (global) {
         WriteBasicSetting(Settings::values.use_cpu_jit);
+        WriteBasicSetting(Settings::values.auto_cpu_clock);
+        WriteBasicSetting(Settings::values.auto_cpu_clock_min);
+        WriteBasicSetting(Settings::values.auto_cpu_clock_max);
+        WriteBasicSetting(Settings::values.parallel_cpu_cores);
+        WriteBasicSetting(Settings::values.parallel_cpu_max_skew_us);
+        WriteBasicSetting(Settings::values.use_fastmem);
+        WriteBasicSetting(Settings::values.use_jit_profiles);
+        WriteBasicSetting(Settings::values.delta_savestates);
+        WriteBasicSetting(Settings::values.rewind_seconds);
+        WriteBasicSetting(Settings::values.rewind_states_per_second);
+        WriteBasicSetting(Settings::values.rewind_memory_mb);
+        WriteBasicSetting(Settings::values.emulation_thread_cores);
+        WriteBasicSetting(Settings::values.render_thread_cores);
+        WriteBasicSetting(Settings::values.audio_thread_cores);
+        WriteBasicSetting(Settings::values.max_worker_threads);
     }
 
     qt_config->endGroup();
@@ -998,6 +1069,7 @@ void Config::SaveDebuggingValues() {
     qt_config->setValue(QStringLiteral("record_frame_times"), Settings::values.record_frame_times);
     WriteBasicSetting(Settings::values.use_gdbstub);
     WriteBasicSetting(Settings::values.gdbstub_port);
+    WriteBasicSetting(Settings::values.rpc_shared_memory);
     WriteBasicSetting(Settings::values.renderer_debug);
     WriteBasicSetting(Settings::values.dump_command_buffers);
 
@@ -1137,6 +1209,20 @@ void Config::SaveRendererValues() {
     if (global) {
         WriteSetting(QStringLiteral("use_shader_jit"), Settings::values.use_shader_jit.GetValue(),
                      true);
+        WriteBasicSetting(Settings::values.async_gpu);
+        WriteBasicSetting(Settings::values.large_vertex_cache);
+        WriteBasicSetting(Settings::values.gpu_texture_decoding);
+        WriteBasicSetting(Settings::values.hash_texture_uploads);
+        WriteBasicSetting(Settings::values.texture_memory_budget);
+        WriteBasicSetting(Settings::values.async_pipeline_warmup);
+        WriteBasicSetting(Settings::values.force_uber_shader);
+        WriteBasicSetting(Settings::values.specialize_hw_shaders);
+        WriteBasicSetting(Settings::values.low_latency_pacing);
+        WriteBasicSetting(Settings::values.dynamic_resolution);
+        WriteBasicSetting(Settings::values.dynamic_resolution_min);
+        WriteBasicSetting(Settings::values.frame_skip);
+        WriteBasicSetting(Settings::values.shader_cache_read_only);
+        WriteBasicSetting(Settings::values.gpu_timing);
     }
 
     qt_config->endGroup();
@@ -1285,6 +1371,8 @@ void Config::SaveWebServiceValues() {
                  QString::fromStdString(NetSettings::values.citra_username));
     WriteSetting(QStringLiteral("citra_token"),
                  QString::fromStdString(NetSettings::values.citra_token));
+    WriteSetting(QStringLiteral("enable_direct_connections"),
+                 NetSettings::values.enable_direct_connections, false);
 
     qt_config->endGroup();
 }
@@ -70,6 +70,8 @@ void ConfigureAudio::SetConfiguration() {
     SetAudioDeviceFromDeviceID();
 
     ui->toggle_audio_stretching->setChecked(Settings::values.enable_audio_stretching.GetValue());
+    ui->toggle_low_latency_output->setChecked(
+        Settings::values.enable_low_latency_output.GetValue());
 
     const s32 volume =
         static_cast<s32>(Settings::values.volume.GetValue() * ui->volume_slider->maximum());
@@ -150,6 +152,7 @@ void ConfigureAudio::ApplyConfiguration() {
         Settings::values.audio_device_id =
             ui->audio_device_combo_box->itemText(ui->audio_device_combo_box->currentIndex())
                 .toStdString();
+        Settings::values.enable_low_latency_output = ui->toggle_low_latency_output->isChecked();
         Settings::values.mic_input_type =
             static_cast<Settings::MicInputType>(ui->input_type_combo_box->currentIndex());
 
@@ -198,6 +201,7 @@ void ConfigureAudio::SetupPerGameUI() {
     ui->output_sink_label->setVisible(false);
     ui->audio_device_combo_box->setVisible(false);
     ui->audio_device_label->setVisible(false);
+    ui->toggle_low_latency_output->setVisible(false);
     ui->input_type_label->setVisible(false);
     ui->input_type_combo_box->setVisible(false);
     ui->input_device_label->setVisible(false);
@@ -0,0 +1,67 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <QHeaderView>
+#include <QTimer>
+#include <QTreeWidget>
+#include "citra_qt/debugger/graphics/graphics_cache_stats.h"
+#include "core/core.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+
+namespace {
+constexpr int UpdateIntervalMs = 250;
+}
+
+GraphicsCacheStatsWidget::GraphicsCacheStatsWidget(QWidget* parent)
+    : QDockWidget(tr("Rasterizer Cache Statistics"), parent) {
+    setObjectName(QStringLiteral("GraphicsCacheStatsWidget"));
+
+    stats_tree = new QTreeWidget;
+    stats_tree->setColumnCount(3);
+    stats_tree->setHeaderLabels({tr("Counter"), tr("Last Frame"), tr("Total")});
+    stats_tree->setRootIsDecorated(false);
+    stats_tree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    for (const auto& [name, member] : VideoCore::RasterizerCacheStats::Fields) {
+        auto* item = new QTreeWidgetItem(stats_tree);
+        item->setText(0, QString::fromUtf8(name));
+        item->setTextAlignment(1, Qt::AlignRight);
+        item->setTextAlignment(2, Qt::AlignRight);
+    }
+    setWidget(stats_tree);
+
+    update_timer = new QTimer(this);
+    update_timer->setInterval(UpdateIntervalMs);
+    connect(update_timer, &QTimer::timeout, this, &GraphicsCacheStatsWidget::UpdateStats);
+    setEnabled(false);
+}
+
+GraphicsCacheStatsWidget::~GraphicsCacheStatsWidget() = default;
+
+void GraphicsCacheStatsWidget::OnEmulationStarting(EmuThread* emu_thread) {
+    setEnabled(true);
+    update_timer->start();
+}
+
+void GraphicsCacheStatsWidget::OnEmulationStopping() {
+    update_timer->stop();
+    setEnabled(false);
+}
+
+void GraphicsCacheStatsWidget::UpdateStats() {
+    auto& system = Core::System::GetInstance();
+    if (!isVisible() || !system.IsPoweredOn()) {
+        return;
+    }
+    const auto* rasterizer = system.Renderer().Rasterizer();
+    const VideoCore::RasterizerCacheStats last_frame = rasterizer->GetLastFrameCacheStats();
+    const VideoCore::RasterizerCacheStats total = rasterizer->GetTotalCacheStats();
+    const auto& fields = VideoCore::RasterizerCacheStats::Fields;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        const auto member = fields[i].second;
+        QTreeWidgetItem* item = stats_tree->topLevelItem(static_cast<int>(i));
+        item->setText(1, QString::number(last_frame.*member));
+        item->setText(2, QString::number(total.*member));
+    }
+}
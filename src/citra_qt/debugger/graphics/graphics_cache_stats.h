@@ -0,0 +1,29 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <QDockWidget>
+
+class EmuThread;
+class QTimer;
+class QTreeWidget;
+
+/// Shows what the rasterizer cache did during the last frame and since emulation started
+class GraphicsCacheStatsWidget : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit GraphicsCacheStatsWidget(QWidget* parent = nullptr);
+    ~GraphicsCacheStatsWidget() override;
+
+    void OnEmulationStarting(EmuThread* emu_thread);
+    void OnEmulationStopping();
+
+private:
+    void UpdateStats();
+
+    QTreeWidget* stats_tree;
+    QTimer* update_timer;
+};
@@ -0,0 +1,129 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+#include "citra_qt/game_list_cache.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+
+namespace {
+
+constexpr quint32 CacheMagic = 0x434C4743; // "CGLC"
+/// Increment when the layout of the cache or the meaning of its entries changes
+constexpr quint32 CacheVersion = 1;
+
+} // Anonymous namespace
+
+GameListCache::GameListCache()
+    : file_path{FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "game_list/metadata.bin"} {
+    Load();
+}
+
+GameListCache::~GameListCache() = default;
+
+std::optional<GameListCache::Entry> GameListCache::Find(const std::string& path,
+                                                        const FileUtil::FileStatus& status) {
+    std::scoped_lock lock{mutex};
+    const auto it = records.find(path);
+    if (it == records.end() || it->second.size != status.size ||
+        it->second.modification_time != status.modification_time) {
+        return std::nullopt;
+    }
+    it->second.used = true;
+    return it->second.entry;
+}
+
+void GameListCache::Insert(const std::string& path, const FileUtil::FileStatus& status,
+                           Entry entry) {
+    std::scoped_lock lock{mutex};
+    records.insert_or_assign(path,
+                             Record{status.size, status.modification_time, std::move(entry), true});
+    dirty = true;
+}
+
+void GameListCache::Load() {
+    QFile file(QString::fromStdString(file_path));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic{};
+    quint32 version{};
+    quint32 count{};
+    stream >> magic >> version >> count;
+    if (magic != CacheMagic || version != CacheVersion) {
+        LOG_INFO(Frontend, "Ignoring outdated game list cache");
+        return;
+    }
+
+    std::unordered_map<std::string, Record> loaded;
+    loaded.reserve(count);
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        quint64 size{};
+        qint64 modification_time{};
+        bool is_executable{};
+        quint64 program_id{};
+        quint64 extdata_id{};
+        QString file_type;
+        QByteArray smdh;
+        stream >> path >> size >> modification_time >> is_executable >> program_id >>
+            extdata_id >> file_type >> smdh;
+
+        Entry entry{is_executable, program_id, extdata_id, file_type.toStdString(),
+                    std::vector<u8>(smdh.begin(), smdh.end())};
+        loaded.emplace(path.toStdString(),
+                       Record{size, modification_time, std::move(entry), false});
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        LOG_WARNING(Frontend, "Game list cache is corrupted, ignoring it");
+        return;
+    }
+    records = std::move(loaded);
+}
+
+void GameListCache::Save(bool prune) {
+    std::scoped_lock lock{mutex};
+    if (prune) {
+        for (auto it = records.begin(); it != records.end();) {
+            if (it->second.used) {
+                ++it;
+            } else {
+                it = records.erase(it);
+                dirty = true;
+            }
+        }
+    }
+    if (!dirty) {
+        return;
+    }
+
+    if (!FileUtil::CreateFullPath(file_path)) {
+        LOG_ERROR(Frontend, "Could not create the game list cache directory");
+        return;
+    }
+    QFile file(QString::fromStdString(file_path));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_ERROR(Frontend, "Could not open the game list cache for writing");
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << CacheMagic << CacheVersion << static_cast<quint32>(records.size());
+    for (const auto& [path, record] : records) {
+        const Entry& entry = record.entry;
+        stream << QString::fromStdString(path) << static_cast<quint64>(record.size)
+               << static_cast<qint64>(record.modification_time) << entry.is_executable
+               << static_cast<quint64>(entry.program_id) << static_cast<quint64>(entry.extdata_id)
+               << QString::fromStdString(entry.file_type)
+               << QByteArray(reinterpret_cast<const char*>(entry.smdh.data()),
+                             static_cast<int>(entry.smdh.size()));
+    }
+    dirty = false;
+}
@@ -0,0 +1,63 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace FileUtil {
+struct FileStatus;
+}
+
+/**
+ * Persistent cache of the metadata the game list reads from each file, so that refreshing the list
+ * does not have to open and parse every title again. Entries are keyed by the file path and are
+ * only used while the size and modification time of the file are unchanged. Thread-safe.
+ */
+class GameListCache {
+public:
+    struct Entry {
+        bool is_executable = false; ///< Whether the file is a (possibly encrypted) executable
+        u64 program_id = 0;
+        u64 extdata_id = 0;
+        std::string file_type;
+        std::vector<u8> smdh;
+    };
+
+    /// Loads the cache from the user cache directory, starting empty if it is missing or outdated.
+    GameListCache();
+    ~GameListCache();
+
+    /// Returns the entry of the file if it was cached with the same size and modification time.
+    std::optional<Entry> Find(const std::string& path, const FileUtil::FileStatus& status);
+
+    /// Stores the entry of the file, replacing an outdated one.
+    void Insert(const std::string& path, const FileUtil::FileStatus& status, Entry entry);
+
+    /**
+     * Writes the cache back to the disk if it changed.
+     * @param prune whether to drop the entries of files that were not looked up since loading
+     */
+    void Save(bool prune);
+
+private:
+    struct Record {
+        u64 size;
+        s64 modification_time;
+        Entry entry;
+        bool used;
+    };
+
+    void Load();
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Record> records;
+    std::string file_path;
+    bool dirty = false;
+};
@@ -8,8 +8,10 @@
 #include <vector>
 #include <QDir>
 #include <QFileInfo>
+#include <QtConcurrent/QtConcurrentMap>
 #include "citra_qt/compatibility_list.h"
 #include "citra_qt/game_list.h"
+#include "citra_qt/game_list_cache.h"
 #include "citra_qt/game_list_p.h"
 #include "citra_qt/game_list_worker.h"
 #include "citra_qt/uisettings.h"
@@ -26,98 +28,149 @@ bool HasSupportedFileExtension(const std::string& file_name) {
 }
 } // Anonymous namespace
 
+/// A file found in a game directory, with the metadata shown in its game list entry.
+struct GameListWorker::ScannedFile {
+    std::string path;
+    FileUtil::FileStatus status;
+    GameListCache::Entry entry;
+};
+
 GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
                                const CompatibilityList& compatibility_list)
     : game_dirs(game_dirs), compatibility_list(compatibility_list) {}
 
 GameListWorker::~GameListWorker() = default;
 
-void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
-                                             GameListDir* parent_dir) {
-    const auto callback = [this, recursion, parent_dir](u64* num_entries_out,
-                                                        const std::string& directory,
-                                                        const std::string& virtual_name) -> bool {
+void GameListWorker::CollectFiles(const std::string& dir_path, unsigned int recursion,
+                                  std::vector<ScannedFile>& files) {
+    const auto callback = [this, recursion, &files](u64* num_entries_out,
+                                                    const std::string& directory,
+                                                    const std::string& virtual_name) -> bool {
         if (stop_processing) {
             // Breaks the callback loop.
             return false;
         }
 
         const std::string physical_name = directory + DIR_SEP + virtual_name;
-        const bool is_dir = FileUtil::IsDirectory(physical_name);
-        if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader) {
-                return true;
-            }
+        const auto status = FileUtil::GetStatus(physical_name);
+        if (!status) {
+            return true;
+        }
+        if (!status->is_directory && HasSupportedFileExtension(physical_name)) {
+            files.push_back({physical_name, *status, {}});
+        } else if (status->is_directory && recursion > 0) {
+            watch_list.append(QString::fromStdString(physical_name));
+            CollectFiles(physical_name, recursion - 1, files);
+        }
 
-            bool executable = false;
-            const auto res = loader->IsExecutable(executable);
-            if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
-                return true;
-            }
+        return true;
+    };
 
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh;
-            // Look for an update icon if available
-            if (!(program_id & ~0x00040000FFFFFFFF)) {
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
-                if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
-                }
-            }
+    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+}
 
-            if (!Loader::IsValidSMDH(smdh)) {
-                // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
-            }
+static GameListCache::Entry ReadFileMetadata(const std::string& path) {
+    GameListCache::Entry entry;
+    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(path);
+    if (!loader) {
+        return entry;
+    }
+
+    bool executable = false;
+    const auto res = loader->IsExecutable(executable);
+    entry.is_executable = executable || res == Loader::ResultStatus::ErrorEncrypted;
+    if (!entry.is_executable) {
+        return entry;
+    }
+
+    loader->ReadProgramId(entry.program_id);
+    loader->ReadExtdataId(entry.extdata_id);
+    loader->ReadIcon(entry.smdh);
+    entry.file_type = Loader::GetFileTypeString(loader->GetFileType());
+    return entry;
+}
+
+void GameListWorker::ScanFile(ScannedFile& file) {
+    if (stop_processing) {
+        return;
+    }
 
-            if (!Loader::IsValidSMDH(smdh) && UISettings::values.game_list_hide_no_icon) {
-                // Skip this invalid entry
-                return true;
+    const auto read_cached = [this](const std::string& path, const FileUtil::FileStatus& status) {
+        if (auto entry = cache->Find(path, status)) {
+            return *std::move(entry);
+        }
+        GameListCache::Entry entry = ReadFileMetadata(path);
+        cache->Insert(path, status, entry);
+        return entry;
+    };
+
+    file.entry = read_cached(file.path, file.status);
+    if (!file.entry.is_executable) {
+        return;
+    }
+
+    // Look for an update icon if available
+    const u64 program_id = file.entry.program_id;
+    if (!(program_id & ~0x00040000FFFFFFFF)) {
+        const std::string update_path = Service::AM::GetTitleContentPath(
+            Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
+        if (const auto update_status = FileUtil::GetStatus(update_path)) {
+            std::vector<u8> update_smdh = read_cached(update_path, *update_status).smdh;
+            if (Loader::IsValidSMDH(update_smdh)) {
+                file.entry.smdh = std::move(update_smdh);
             }
+        }
+    }
+}
 
-            auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
-
-            // The game list uses this as compatibility number for untested games
-            QString compatibility(QStringLiteral("99"));
-            if (it != compatibility_list.end())
-                compatibility = it->second.first;
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id),
-                    new GameListItemCompat(compatibility),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                },
-                parent_dir);
-
-        } else if (is_dir && recursion > 0) {
-            watch_list.append(QString::fromStdString(physical_name));
-            AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir);
+void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
+                                             GameListDir* parent_dir) {
+    std::vector<ScannedFile> files;
+    CollectFiles(dir_path, recursion, files);
+
+    // Parsing the titles is the slow part, spread it over the thread pool. Files whose cached
+    // metadata is still current are not opened at all.
+    QtConcurrent::blockingMap(files, [this](ScannedFile& file) { ScanFile(file); });
+
+    // The items are still created in directory order, so the list fills in the same way as before
+    for (const ScannedFile& file : files) {
+        if (stop_processing) {
+            return;
         }
 
-        return true;
-    };
+        const GameListCache::Entry& entry = file.entry;
+        if (!entry.is_executable) {
+            continue;
+        }
 
-    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+        if (!Loader::IsValidSMDH(entry.smdh) && UISettings::values.game_list_hide_no_icon) {
+            // Skip this invalid entry
+            continue;
+        }
+
+        auto it = FindMatchingCompatibilityEntry(compatibility_list, entry.program_id);
+
+        // The game list uses this as compatibility number for untested games
+        QString compatibility(QStringLiteral("99"));
+        if (it != compatibility_list.end())
+            compatibility = it->second.first;
+
+        emit EntryReady(
+            {
+                new GameListItemPath(QString::fromStdString(file.path), entry.smdh,
+                                     entry.program_id, entry.extdata_id),
+                new GameListItemCompat(compatibility),
+                new GameListItemRegion(entry.smdh),
+                new GameListItem(QString::fromStdString(entry.file_type)),
+                new GameListItemSize(file.status.size),
+            },
+            parent_dir);
+    }
 }
 
 void GameListWorker::run() {
     stop_processing = false;
+    cache = std::make_unique<GameListCache>();
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == QStringLiteral("INSTALLED")) {
             QString games_path =
@@ -154,6 +207,8 @@ void GameListWorker::run() {
         }
     }
 
+    // Only a complete scan tells which cached files are gone
+    cache->Save(!stop_processing);
     emit Finished(watch_list);
 }
 
@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -17,6 +18,7 @@
 #include "citra_qt/compatibility_list.h"
 #include "common/common_types.h"
 
+class GameListCache;
 class QStandardItem;
 
 /**
@@ -53,11 +55,17 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    struct ScannedFile;
+
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir);
+    void CollectFiles(const std::string& dir_path, unsigned int recursion,
+                      std::vector<ScannedFile>& files);
+    void ScanFile(ScannedFile& file);
 
     QVector<UISettings::GameDir>& game_dirs;
     const CompatibilityList& compatibility_list;
+    std::unique_ptr<GameListCache> cache;
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
@@ -33,6 +33,7 @@
 #include "citra_qt/debugger/console.h"
 #include "citra_qt/debugger/graphics/graphics.h"
 #include "citra_qt/debugger/graphics/graphics_breakpoints.h"
+#include "citra_qt/debugger/graphics/graphics_cache_stats.h"
 #include "citra_qt/debugger/graphics/graphics_cmdlists.h"
 #include "citra_qt/debugger/graphics/graphics_surface.h"
 #include "citra_qt/debugger/graphics/graphics_tracing.h"
@@ -433,6 +434,15 @@ void GMainWindow::InitializeDebugWidgets() {
     connect(this, &GMainWindow::EmulationStopping, graphicsTracingWidget,
             &GraphicsTracingWidget::OnEmulationStopping);
 
+    graphicsCacheStatsWidget = new GraphicsCacheStatsWidget(this);
+    addDockWidget(Qt::RightDockWidgetArea, graphicsCacheStatsWidget);
+    graphicsCacheStatsWidget->hide();
+    debug_menu->addAction(graphicsCacheStatsWidget->toggleViewAction());
+    connect(this, &GMainWindow::EmulationStarting, graphicsCacheStatsWidget,
+            &GraphicsCacheStatsWidget::OnEmulationStarting);
+    connect(this, &GMainWindow::EmulationStopping, graphicsCacheStatsWidget,
+            &GraphicsCacheStatsWidget::OnEmulationStopping);
+
     waitTreeWidget = new WaitTreeWidget(this);
     addDockWidget(Qt::LeftDockWidgetArea, waitTreeWidget);
     waitTreeWidget->hide();
@@ -592,6 +602,17 @@ void GMainWindow::InitializeHotkeys() {
                      [&] { Settings::values.dump_textures = !Settings::values.dump_textures; });
     connect_shortcut(QStringLiteral("Toggle Custom Textures"),
                      [&] { Settings::values.custom_textures = !Settings::values.custom_textures; });
+    connect_shortcut(QStringLiteral("Toggle Profile Capture"), [] {
+        if (!Common::Profiling::IsCapturing()) {
+            Common::Profiling::StartCapture();
+            return;
+        }
+        const std::string timestamp = QDateTime::currentDateTime()
+                                          .toString(QStringLiteral("dd.MM.yy_hh.mm.ss.z"))
+                                          .toStdString();
+        Common::Profiling::StopCapture(fmt::format(
+            "{}profile_{}.json", FileUtil::GetUserPath(FileUtil::UserPath::LogDir), timestamp));
+    });
     // We use "static" here in order to avoid capturing by lambda due to a MSVC bug, which makes
     // the variable hold a garbage value after this function exits
     static constexpr u16 SPEED_LIMIT_STEP = 5;
@@ -619,6 +640,11 @@ void GMainWindow::InitializeHotkeys() {
     });
     connect_shortcut(QStringLiteral("Mute Audio"),
                      [] { Settings::values.audio_muted = !Settings::values.audio_muted; });
+    connect_shortcut(QStringLiteral("Rewind"), [&] {
+        if (emulation_running && Settings::values.rewind_seconds.GetValue() > 0) {
+            Core::System::GetInstance().SendSignal(Core::System::Signal::Rewind);
+        }
+    });
 
     // We use "static" here in order to avoid capturing by lambda due to a MSVC bug, which makes the
     // variable hold a garbage value after this function exits
@@ -2320,7 +2346,30 @@ void GMainWindow::UpdateStatusBar() {
                                      .arg(Settings::values.frame_limit.GetValue()));
     }
     game_fps_label->setText(tr("Game: %1 FPS").arg(results.game_fps, 0, 'f', 0));
-    emu_frametime_label->setText(tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
+    if (results.gpu_time == 0.0) {
+        emu_frametime_label->setText(
+            tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
+    } else {
+        emu_frametime_label->setText(tr("Frame: %1 ms (GPU: %2 ms)")
+                                         .arg(results.frametime * 1000.0, 0, 'f', 2)
+                                         .arg(results.gpu_time * 1000.0, 0, 'f', 2));
+    }
+
+    const std::array<QString, Core::PerfStats::NumSubsystems> subsystem_names{
+        tr("CPU"),     tr("HLE services"), tr("GPU commands"), tr("Rasterizer"),
+        tr("Shaders"), tr("Audio DSP"),    tr("Frame limiter")};
+    QString frametime_tooltip =
+        tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
+           "full-speed emulation this should be at most 16.67 ms.");
+    frametime_tooltip += QStringLiteral("\n");
+    for (std::size_t i = 0; i < subsystem_names.size(); ++i) {
+        frametime_tooltip += tr("\n%1: %2 ms")
+                                 .arg(subsystem_names[i])
+                                 .arg(results.subsystem_time[i] * 1000.0, 0, 'f', 2);
+    }
+    frametime_tooltip +=
+        tr("\n\nInput latency: %1 ms").arg(results.input_latency * 1000.0, 0, 'f', 2);
+    emu_frametime_label->setToolTip(frametime_tooltip);
 
     emu_speed_label->setVisible(true);
     game_fps_label->setVisible(true);
@@ -2727,9 +2776,12 @@ void GMainWindow::RetranslateStatusBar() {
                                    "indicate emulation is running faster or slower than a 3DS."));
     game_fps_label->setToolTip(tr("How many frames per second the game is currently displaying. "
                                   "This will vary from game to game and scene to scene."));
-    emu_frametime_label->setToolTip(
-        tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
-           "full-speed emulation this should be at most 16.67 ms."));
+    // The frame time tooltip is set with the time breakdown by UpdateStatusBar
+    if (!emu_thread) {
+        emu_frametime_label->setToolTip(
+            tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
+               "full-speed emulation this should be at most 16.67 ms."));
+    }
 
     multiplayer_state->retranslateUi();
 }
@@ -32,6 +32,7 @@ class GImageInfo;
 class GPUCommandListWidget;
 class GPUCommandStreamWidget;
 class GraphicsBreakPointsWidget;
+class GraphicsCacheStatsWidget;
 class GraphicsTracingWidget;
 class GraphicsVertexShaderWidget;
 class GRenderWindow;
@@ -312,6 +313,7 @@ private:
     GraphicsBreakPointsWidget* graphicsBreakpointsWidget;
     GraphicsVertexShaderWidget* graphicsVertexShaderWidget;
     GraphicsTracingWidget* graphicsTracingWidget;
+    GraphicsCacheStatsWidget* graphicsCacheStatsWidget;
     IPCRecorderWidget* ipcRecorderWidget;
     LLEServiceModulesWidget* lleServiceModulesWidget;
     WaitTreeWidget* waitTreeWidget;
@@ -62,6 +62,7 @@
 #define EMU_CONFIG "emu.ini"
 #define DEBUGGER_CONFIG "debugger.ini"
 #define LOGGER_CONFIG "logger.ini"
+#define JIT_PROFILES "jit_profiles.txt"
 
 // Sys files
 #define SHARED_FONT "shared_font.bin"
@@ -14,6 +14,7 @@
 #include "common/common_paths.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/zstd_compression.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -49,6 +50,7 @@
 #include <dirent.h>
 #include <pwd.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 #if defined(__APPLE__)
@@ -419,6 +421,30 @@ u64 GetSize(FILE* f) {
     return size;
 }
 
+std::optional<FileStatus> GetStatus(const std::string& filename) {
+#ifdef ANDROID
+    // Storage access framework paths have no modification time
+    return std::nullopt;
+#else
+    struct stat file_info;
+
+    std::string copy(filename);
+    StripTailDirSlashes(copy);
+
+#ifdef _WIN32
+    int result = _wstat64(Common::UTF8ToUTF16W(copy).c_str(), &file_info);
+#else
+    int result = stat(copy.c_str(), &file_info);
+#endif
+
+    if (result < 0) {
+        return std::nullopt;
+    }
+    return FileStatus{S_ISDIR(file_info.st_mode), static_cast<u64>(file_info.st_size),
+                      static_cast<s64>(file_info.st_mtime)};
+#endif
+}
+
 bool CreateEmptyFile(const std::string& filename) {
     LOG_TRACE(Common_Filesystem, "{}", filename);
 
@@ -1045,15 +1071,29 @@ void IOFile::Swap(IOFile& other) noexcept {
     std::swap(filename, other.filename);
     std::swap(openmode, other.openmode);
     std::swap(flags, other.flags);
+    std::swap(decompressor, other.decompressor);
+    std::swap(decompressed_position, other.decompressed_position);
 }
 
 bool IOFile::Open() {
     Close();
 
+    const int os_flags = flags & ~DecompressSeekable;
+    if ((flags & DecompressSeekable) != 0) {
+        auto reader = std::make_unique<Common::Compression::SeekableZSTDReader>(
+            IOFile(filename, openmode.c_str(), os_flags));
+        if (reader->IsValid()) {
+            decompressor = std::move(reader);
+            decompressed_position = 0;
+            m_good = true;
+            return m_good;
+        }
+    }
+
 #ifdef _WIN32
-    if (flags != 0) {
+    if (os_flags != 0) {
         m_file = _wfsopen(Common::UTF8ToUTF16W(filename).c_str(),
-                          Common::UTF8ToUTF16W(openmode).c_str(), flags);
+                          Common::UTF8ToUTF16W(openmode).c_str(), os_flags);
         m_good = m_file != nullptr;
     } else {
         m_good = _wfopen_s(&m_file, Common::UTF8ToUTF16W(filename).c_str(),
@@ -1098,6 +1138,10 @@ bool IOFile::Open() {
 }
 
 bool IOFile::Close() {
+    if (decompressor) {
+        decompressor.reset();
+        return m_good;
+    }
     if (!IsOpen() || 0 != std::fclose(m_file))
         m_good = false;
 
@@ -1106,6 +1150,8 @@ bool IOFile::Close() {
 }
 
 u64 IOFile::GetSize() const {
+    if (decompressor)
+        return decompressor->GetSize();
     if (IsOpen())
         return FileUtil::GetSize(m_file);
 
@@ -1113,6 +1159,17 @@ u64 IOFile::GetSize() const {
 }
 
 bool IOFile::Seek(s64 off, int origin) {
+    if (decompressor) {
+        const s64 base = origin == SEEK_SET   ? 0
+                         : origin == SEEK_CUR ? static_cast<s64>(decompressed_position)
+                                              : static_cast<s64>(decompressor->GetSize());
+        if (base + off < 0) {
+            m_good = false;
+        } else {
+            decompressed_position = static_cast<u64>(base + off);
+        }
+        return m_good;
+    }
     if (!IsOpen() || 0 != fseeko(m_file, off, origin))
         m_good = false;
 
@@ -1120,6 +1177,8 @@ bool IOFile::Seek(s64 off, int origin) {
 }
 
 u64 IOFile::Tell() const {
+    if (decompressor)
+        return decompressed_position;
     if (IsOpen())
         return ftello(m_file);
 
@@ -1127,6 +1186,8 @@ u64 IOFile::Tell() const {
 }
 
 bool IOFile::Flush() {
+    if (decompressor)
+        return m_good;
     if (!IsOpen() || 0 != std::fflush(m_file))
         m_good = false;
 
@@ -1145,6 +1206,13 @@ std::size_t IOFile::ReadImpl(void* data, std::size_t length, std::size_t data_si
 
     DEBUG_ASSERT(data != nullptr);
 
+    if (decompressor) {
+        const std::size_t bytes_read = decompressor->Read(
+            decompressed_position, static_cast<u8*>(data), length * data_size);
+        decompressed_position += bytes_read;
+        return bytes_read / data_size;
+    }
+
     return std::fread(data, data_size, length, m_file);
 }
 
@@ -1154,6 +1222,12 @@ std::size_t IOFile::WriteImpl(const void* data, std::size_t length, std::size_t
         return std::numeric_limits<std::size_t>::max();
     }
 
+    if (decompressor) {
+        // Decompressed files are read-only
+        m_good = false;
+        return 0;
+    }
+
     if (length == 0) {
         return 0;
     }
@@ -1164,7 +1238,7 @@ std::size_t IOFile::WriteImpl(const void* data, std::size_t length, std::size_t
 }
 
 bool IOFile::Resize(u64 size) {
-    if (!IsOpen() || 0 !=
+    if (!IsOpen() || decompressor || 0 !=
 #ifdef _WIN32
                          // ector: _chsize sucks, not 64-bit safe
                          // F|RES: changed to _chsize_s. i think it is 64-bit safe
@@ -1179,6 +1253,76 @@ bool IOFile::Resize(u64 size) {
     return m_good;
 }
 
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const IOFile& file) {
+    const u64 file_size = file.GetSize();
+    const int fd = file.GetFd();
+    if (fd == -1 || file_size == 0 || file_size > std::numeric_limits<std::size_t>::max()) {
+        return;
+    }
+    size = static_cast<std::size_t>(file_size);
+
+#ifdef _WIN32
+    const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        LOG_WARNING(Common_Filesystem, "CreateFileMapping failed: {}", GetLastErrorMsg());
+        size = 0;
+        return;
+    }
+    data = static_cast<const u8*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, size));
+    if (data == nullptr) {
+        LOG_WARNING(Common_Filesystem, "MapViewOfFile failed: {}", GetLastErrorMsg());
+        Close();
+    }
+#else
+    void* const base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        LOG_WARNING(Common_Filesystem, "mmap failed: {}", GetLastErrorMsg());
+        size = 0;
+        return;
+    }
+    data = static_cast<const u8*>(base);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    Close();
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+#ifdef _WIN32
+    std::swap(mapping_handle, other.mapping_handle);
+#endif
+    return *this;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+    }
+#else
+    if (data != nullptr) {
+        munmap(const_cast<u8*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
+
 template <typename T>
 using boost_iostreams = boost::iostreams::stream<T>;
 
@@ -9,7 +9,9 @@
 #include <fstream>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -22,6 +24,10 @@
 #include "common/string_util.h"
 #endif
 
+namespace Common::Compression {
+class SeekableZSTDReader;
+}
+
 namespace FileUtil {
 
 // User paths for GetUserPath
@@ -105,6 +111,16 @@ private:
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(FILE* f);
 
+struct FileStatus {
+    bool is_directory;
+    u64 size;
+    s64 modification_time; // In seconds since the epoch
+};
+
+// Returns the type, size and modification time of filename from a single stat, or nothing if it
+// does not exist or can not be queried
+[[nodiscard]] std::optional<FileStatus> GetStatus(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -266,6 +282,12 @@ enum class DirectorySeparator {
 // and make forgetting an fclose() harder
 class IOFile : public NonCopyable {
 public:
+    /**
+     * Flag for read-only files that may be in the Zstandard seekable format. Such files are then
+     * read as their decompressed data, other files are read as they are.
+     */
+    static constexpr int DecompressSeekable = 1 << 16;
+
     IOFile();
 
     // flags is used for windows specific file open mode flags, which
@@ -329,7 +351,12 @@ public:
     }
 
     [[nodiscard]] bool IsOpen() const {
-        return nullptr != m_file;
+        return nullptr != m_file || nullptr != decompressor;
+    }
+
+    /// Whether the file is read through DecompressSeekable, it then has no handle or descriptor
+    [[nodiscard]] bool IsDecompressed() const {
+        return nullptr != decompressor;
     }
 
     // m_good is set to false when a read, write or other function fails
@@ -352,6 +379,10 @@ public:
         return m_file;
     }
 
+    [[nodiscard]] const std::string& GetFilename() const {
+        return filename;
+    }
+
     bool Seek(s64 off, int origin);
     [[nodiscard]] u64 Tell() const;
     [[nodiscard]] u64 GetSize() const;
@@ -361,7 +392,9 @@ public:
     // clear error state
     void Clear() {
         m_good = true;
-        std::clearerr(m_file);
+        if (m_file) {
+            std::clearerr(m_file);
+        }
     }
 
 private:
@@ -374,6 +407,10 @@ private:
     int m_fd = -1;
     bool m_good = true;
 
+    /// Set instead of m_file when the file is decompressed
+    std::unique_ptr<Common::Compression::SeekableZSTDReader> decompressor;
+    u64 decompressed_position = 0;
+
     std::string filename;
     std::string openmode;
     u32 flags;
@@ -396,6 +433,43 @@ private:
     friend class boost::serialization::access;
 };
 
+/**
+ * A read-only view of a whole file mapped into memory. The pages come from the OS page cache, so
+ * reads avoid the stdio copy and several processes mapping the same file share its memory.
+ * Mapping fails for empty files or files larger than the address space, callers should then fall
+ * back to reading through the IOFile.
+ */
+class MappedFile : public NonCopyable {
+public:
+    MappedFile();
+    explicit MappedFile(const IOFile& file);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    [[nodiscard]] bool IsOpen() const {
+        return data != nullptr;
+    }
+
+    [[nodiscard]] std::span<const u8> GetData() const {
+        return {data, size};
+    }
+
+    [[nodiscard]] std::size_t GetSize() const {
+        return size;
+    }
+
+    void Close();
+
+private:
+    const u8* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
+};
+
 template <std::ios_base::openmode o, typename T>
 void OpenFStream(T& fstream, const std::string& filename);
 } // namespace FileUtil
@@ -0,0 +1,203 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include <atomic>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/error.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+namespace Common {
+
+/// Size of the large pages transparent huge pages use on x86-64 and ARM64 with 4 KiB pages
+[[maybe_unused]] constexpr std::size_t HugePageSize = 2 * 1024 * 1024;
+
+#ifdef _WIN32
+
+// Mapping views of a section into reserved address space needs the placeholder API of Windows 10
+// 1803, which is not wired up yet. Callers fall back to regular allocations.
+
+HostMemory::HostMemory(std::size_t backing_size_) : backing_size{backing_size_} {}
+
+HostMemory::~HostMemory() = default;
+
+VirtualArena::VirtualArena(const HostMemory& backing_, std::size_t virtual_size_)
+    : backing{backing_}, virtual_size{virtual_size_} {}
+
+VirtualArena::~VirtualArena() = default;
+
+void VirtualArena::Map(std::size_t, std::size_t, std::size_t) {
+    UNREACHABLE();
+}
+
+void VirtualArena::Unmap(std::size_t, std::size_t) {
+    UNREACHABLE();
+}
+
+LargePageMemory::LargePageMemory(std::size_t size_) : size{size_} {
+    // Large pages need the lock pages in memory privilege, which few users grant
+    const std::size_t large_page_size = GetLargePageMinimum();
+    if (large_page_size != 0) {
+        const std::size_t large_size = (size + large_page_size - 1) & ~(large_page_size - 1);
+        allocation = VirtualAlloc(nullptr, large_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                  PAGE_READWRITE);
+        if (allocation) {
+            LOG_INFO(Common_Memory, "Allocated {} bytes of large pages", large_size);
+        }
+    }
+    if (!allocation) {
+        allocation = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+    if (!allocation) {
+        LOG_ERROR(Common_Memory, "Failed to allocate {} bytes: {}", size, GetLastErrorMsg());
+        return;
+    }
+    base = static_cast<u8*>(allocation);
+}
+
+LargePageMemory::~LargePageMemory() {
+    if (allocation) {
+        VirtualFree(allocation, 0, MEM_RELEASE);
+    }
+}
+
+#else
+
+static int CreateSharedMemoryFile() {
+#ifdef __linux__
+    // Older Android NDKs do not expose memfd_create, so use the syscall directly.
+    return static_cast<int>(syscall(SYS_memfd_create, "HostMemory", 0));
+#else
+    static std::atomic<u32> counter{0};
+    const std::string name = fmt::format("/citra_{}_{}", getpid(), counter++);
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd != -1) {
+        shm_unlink(name.c_str());
+    }
+    return fd;
+#endif
+}
+
+HostMemory::HostMemory(std::size_t backing_size_) : backing_size{backing_size_} {
+    fd = CreateSharedMemoryFile();
+    if (fd == -1) {
+        LOG_ERROR(Common_Memory, "Failed to create shared memory: {}", GetLastErrorMsg());
+        return;
+    }
+    if (ftruncate(fd, static_cast<off_t>(backing_size)) != 0) {
+        LOG_ERROR(Common_Memory, "Failed to resize shared memory: {}", GetLastErrorMsg());
+        close(fd);
+        fd = -1;
+        return;
+    }
+    void* base = mmap(nullptr, backing_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Failed to map shared memory: {}", GetLastErrorMsg());
+        close(fd);
+        fd = -1;
+        return;
+    }
+    backing_base = static_cast<u8*>(base);
+#ifdef MADV_HUGEPAGE
+    // Shared memory only gets huge pages when shmem_enabled is set to advise or above
+    madvise(backing_base, backing_size, MADV_HUGEPAGE);
+#endif
+}
+
+HostMemory::~HostMemory() {
+    if (backing_base) {
+        munmap(backing_base, backing_size);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+VirtualArena::VirtualArena(const HostMemory& backing_, std::size_t virtual_size_)
+    : backing{backing_}, virtual_size{virtual_size_} {
+    if (!backing.IsValid()) {
+        return;
+    }
+    void* base = mmap(nullptr, virtual_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                      -1, 0);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Failed to reserve {} bytes of address space: {}", virtual_size,
+                  GetLastErrorMsg());
+        return;
+    }
+    virtual_base = static_cast<u8*>(base);
+}
+
+VirtualArena::~VirtualArena() {
+    if (virtual_base) {
+        munmap(virtual_base, virtual_size);
+    }
+}
+
+void VirtualArena::Map(std::size_t virtual_offset, std::size_t backing_offset,
+                       std::size_t length) {
+    ASSERT(virtual_offset + length <= virtual_size);
+    ASSERT(backing_offset + length <= backing.backing_size);
+    void* ret = mmap(virtual_base + virtual_offset, length, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_FIXED, backing.fd, static_cast<off_t>(backing_offset));
+    ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", GetLastErrorMsg());
+#ifdef MADV_HUGEPAGE
+    // Views of whole huge pages can share the huge page mappings of the backing
+    if (length >= HugePageSize) {
+        madvise(ret, length, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+void VirtualArena::Unmap(std::size_t virtual_offset, std::size_t length) {
+    ASSERT(virtual_offset + length <= virtual_size);
+    // Replace the view with inaccessible memory instead of unmapping it, so that the range stays
+    // reserved for this arena.
+    void* ret = mmap(virtual_base + virtual_offset, length, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", GetLastErrorMsg());
+}
+
+LargePageMemory::LargePageMemory(std::size_t size_) : size{size_} {
+    // Over-allocate so that the memory can start on a huge page boundary, the kernel only uses
+    // huge pages for aligned ranges
+    allocation_size = size + HugePageSize;
+    allocation = mmap(nullptr, allocation_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (allocation == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Failed to allocate {} bytes: {}", size, GetLastErrorMsg());
+        allocation = nullptr;
+        return;
+    }
+    const auto address = reinterpret_cast<std::uintptr_t>(allocation);
+    base = reinterpret_cast<u8*>((address + HugePageSize - 1) & ~(HugePageSize - 1));
+#ifdef MADV_HUGEPAGE
+    if (madvise(base, size, MADV_HUGEPAGE) != 0) {
+        LOG_DEBUG(Common_Memory, "Transparent huge pages are not available: {}",
+                  GetLastErrorMsg());
+    }
+#endif
+}
+
+LargePageMemory::~LargePageMemory() {
+    if (allocation) {
+        munmap(allocation, allocation_size);
+    }
+}
+
+#endif
+
+} // namespace Common
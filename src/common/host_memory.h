@@ -0,0 +1,108 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * A block of shared host memory that can be mapped at several host addresses at the same time.
+ * It is always mapped once at BackingBasePointer(), VirtualArena can add more views of it.
+ */
+class HostMemory {
+public:
+    explicit HostMemory(std::size_t backing_size);
+    ~HostMemory();
+
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    /// Returns false if the host does not support shared memory mappings.
+    [[nodiscard]] bool IsValid() const {
+        return backing_base != nullptr;
+    }
+
+    [[nodiscard]] u8* BackingBasePointer() const {
+        return backing_base;
+    }
+
+    [[nodiscard]] std::size_t BackingSize() const {
+        return backing_size;
+    }
+
+private:
+    friend class VirtualArena;
+
+    std::size_t backing_size;
+    u8* backing_base = nullptr;
+    int fd = -1;
+};
+
+/**
+ * A reserved range of host address space. Ranges of it can mirror parts of a HostMemory,
+ * accesses to the rest of it fault.
+ */
+class VirtualArena {
+public:
+    VirtualArena(const HostMemory& backing, std::size_t virtual_size);
+    ~VirtualArena();
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+
+    /// Returns false if the address space could not be reserved.
+    [[nodiscard]] bool IsValid() const {
+        return virtual_base != nullptr;
+    }
+
+    [[nodiscard]] u8* VirtualBasePointer() const {
+        return virtual_base;
+    }
+
+    /// Mirrors length bytes of the backing at backing_offset to virtual_offset.
+    void Map(std::size_t virtual_offset, std::size_t backing_offset, std::size_t length);
+
+    /// Makes accesses to the given range fault again.
+    void Unmap(std::size_t virtual_offset, std::size_t length);
+
+private:
+    const HostMemory& backing;
+    std::size_t virtual_size;
+    u8* virtual_base = nullptr;
+};
+
+/**
+ * Zero initialized private memory, backed by large pages where the host allows it to reduce the
+ * TLB misses of accesses scattered over it.
+ */
+class LargePageMemory {
+public:
+    explicit LargePageMemory(std::size_t size);
+    ~LargePageMemory();
+
+    LargePageMemory(const LargePageMemory&) = delete;
+    LargePageMemory& operator=(const LargePageMemory&) = delete;
+
+    /// Returns false if the memory could not be allocated.
+    [[nodiscard]] bool IsValid() const {
+        return base != nullptr;
+    }
+
+    [[nodiscard]] u8* Pointer() const {
+        return base;
+    }
+
+private:
+    std::size_t size;
+    u8* base = nullptr;
+    /// Start and size of the whole allocation, which may be larger to align base
+    void* allocation = nullptr;
+    std::size_t allocation_size = 0;
+};
+
+} // namespace Common
@@ -64,6 +64,9 @@ bool DecodePNG(std::span<const u8> png_data, std::span<u8> out_data) {
     if (spng_decoded_image_size(ctx.get(), format, &decoded_len)) {
         return false;
     }
+    if (decoded_len > out_data.size()) {
+        return false;
+    }
 
     if (spng_decode_image(ctx.get(), out_data.data(), decoded_len, format, 0)) {
         return false;
@@ -100,6 +103,9 @@ bool LoadDDSKTX(std::span<const u8> dds_data, std::span<u8> out_data) {
 
     ddsktx_sub_data sub_data{};
     ddsktx_get_sub(&tc, &sub_data, dds_data.data(), size, 0, 0, 0);
+    if (static_cast<std::size_t>(sub_data.size_bytes) > out_data.size()) {
+        return false;
+    }
     std::memcpy(out_data.data(), sub_data.buff, sub_data.size_bytes);
 
     return true;
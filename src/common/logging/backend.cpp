@@ -3,14 +3,19 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <regex>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <vector>
+#include <fmt/args.h>
 #ifdef _WIN32
 #include <share.h>   // For _SH_DENYWR
 #include <windows.h> // For OutputDebugStringW
@@ -22,7 +27,6 @@
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
 #include "common/string_util.h"
-#include "common/threadsafe_queue.h"
 
 namespace Log {
 
@@ -30,6 +34,268 @@ Filter filter;
 void SetGlobalFilter(const Filter& f) {
     filter = f;
 }
+
+namespace {
+
+/// Messages one call site can log per window before the rest are suppressed. Trace and debug
+/// messages are not limited, as they are only enabled to see everything, nor critical ones.
+constexpr u32 RateLimitMessages = 10;
+constexpr std::chrono::microseconds RateLimitWindow = std::chrono::seconds{1};
+/// Number of call sites that can be rate limited, must be a power of two
+constexpr std::size_t NumCallSites = 4096;
+/// Number of slots that are probed to find the counters of a call site
+constexpr std::size_t CallSiteProbes = 8;
+
+/// Most format arguments that are captured, messages with more are formatted right away
+constexpr std::size_t MaxCapturedArgs = 16;
+/// Bytes of string arguments that are captured, messages with more are formatted right away
+constexpr std::size_t MaxCapturedText = 256;
+/// Number of messages that can be queued to the logging thread, must be a power of two
+constexpr std::size_t RingSize = 512;
+
+/// Set on the logging thread, which must never wait for the queue it drains
+thread_local bool is_logging_thread = false;
+
+/**
+ * Copy of the format arguments of a message, so the message can be formatted by the logging
+ * thread without allocating on the thread that logs it. Custom types, such as enums, can not be
+ * copied generically and make the message be formatted right away instead.
+ */
+class CapturedArgs {
+public:
+    /// Copies the arguments, returns false if they do not fit or can not be copied
+    bool Capture(const fmt::format_args& format_args) {
+        num_args = 0;
+        text_size = 0;
+        for (int i = 0;; ++i) {
+            const auto arg = format_args.get(i);
+            if (!arg) {
+                return true;
+            }
+            if (num_args == MaxCapturedArgs) {
+                return false;
+            }
+            Arg& captured = args[num_args++];
+            if (!fmt::visit_format_arg([&](auto value) { return Store(captured, value); }, arg)) {
+                return false;
+            }
+        }
+    }
+
+    /// Formats the captured arguments, throws fmt::format_error if the format string is invalid
+    std::string Format(const char* format) const {
+        fmt::dynamic_format_arg_store<fmt::format_context> store;
+        store.reserve(num_args, 0);
+        for (std::size_t i = 0; i < num_args; ++i) {
+            const Arg& arg = args[i];
+            switch (arg.type) {
+            case Type::Int:
+                store.push_back(arg.int_value);
+                break;
+            case Type::UInt:
+                store.push_back(arg.uint_value);
+                break;
+            case Type::Bool:
+                store.push_back(arg.bool_value);
+                break;
+            case Type::Char:
+                store.push_back(arg.char_value);
+                break;
+            case Type::Float:
+                store.push_back(arg.float_value);
+                break;
+            case Type::Double:
+                store.push_back(arg.double_value);
+                break;
+            case Type::LongDouble:
+                store.push_back(arg.long_double_value);
+                break;
+            case Type::String:
+                store.push_back(
+                    std::string_view{text.data() + arg.string.offset, arg.string.size});
+                break;
+            case Type::Pointer:
+                store.push_back(arg.pointer_value);
+                break;
+            }
+        }
+        return fmt::vformat(format, store);
+    }
+
+private:
+    enum class Type : u8 { Int, UInt, Bool, Char, Float, Double, LongDouble, String, Pointer };
+
+    struct Arg {
+        Type type;
+        union {
+            s64 int_value;
+            u64 uint_value;
+            bool bool_value;
+            char char_value;
+            float float_value;
+            double double_value;
+            long double long_double_value;
+            const void* pointer_value;
+            struct {
+                u16 offset;
+                u16 size;
+            } string;
+        };
+    };
+
+    template <typename T>
+    bool Store(Arg& arg, T value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            arg.type = Type::Bool;
+            arg.bool_value = value;
+        } else if constexpr (std::is_same_v<T, char>) {
+            arg.type = Type::Char;
+            arg.char_value = value;
+        } else if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(u64)) {
+            if constexpr (std::is_signed_v<T>) {
+                arg.type = Type::Int;
+                arg.int_value = value;
+            } else {
+                arg.type = Type::UInt;
+                arg.uint_value = value;
+            }
+        } else if constexpr (std::is_same_v<T, float>) {
+            arg.type = Type::Float;
+            arg.float_value = value;
+        } else if constexpr (std::is_same_v<T, double>) {
+            arg.type = Type::Double;
+            arg.double_value = value;
+        } else if constexpr (std::is_same_v<T, long double>) {
+            arg.type = Type::LongDouble;
+            arg.long_double_value = value;
+        } else if constexpr (std::is_same_v<T, const char*>) {
+            // A null string is an error that is reported when formatting right away
+            return value != nullptr && StoreString(arg, value);
+        } else if constexpr (std::is_same_v<T, fmt::string_view>) {
+            return StoreString(arg, std::string_view{value.data(), value.size()});
+        } else if constexpr (std::is_same_v<T, const void*>) {
+            arg.type = Type::Pointer;
+            arg.pointer_value = value;
+        } else {
+            // Custom types and 128-bit integers
+            return false;
+        }
+        return true;
+    }
+
+    bool StoreString(Arg& arg, std::string_view value) {
+        if (value.size() > MaxCapturedText - text_size) {
+            return false;
+        }
+        std::copy(value.begin(), value.end(), text.begin() + text_size);
+        arg.type = Type::String;
+        arg.string.offset = static_cast<u16>(text_size);
+        arg.string.size = static_cast<u16>(value.size());
+        text_size += value.size();
+        return true;
+    }
+
+    std::array<Arg, MaxCapturedArgs> args;
+    std::size_t num_args = 0;
+    std::array<char, MaxCapturedText> text;
+    std::size_t text_size = 0;
+};
+
+/// A message queued to the logging thread
+struct QueuedMessage {
+    /// Position in the ring the slot can be claimed or read at, see MessageRing
+    std::atomic<std::size_t> sequence;
+    std::size_t position;
+
+    std::chrono::microseconds timestamp;
+    Class log_class;
+    Level log_level;
+    const char* filename;
+    unsigned int line_num;
+    const char* function;
+    const char* format;
+    /// Messages of the same call site that were suppressed before this one
+    u32 num_suppressed;
+    /// Whether `message` holds the formatted message, instead of `args` the arguments
+    bool preformatted;
+    bool final_entry;
+    CapturedArgs args;
+    /// Keeps its capacity when the slot is reused
+    std::string message;
+};
+
+/**
+ * Fixed size queue of messages, that many threads can write to without locking and the logging
+ * thread reads from. A slot whose sequence equals the write position is free, one whose sequence
+ * is one past the read position holds a published message.
+ */
+class MessageRing {
+public:
+    MessageRing() : slots(std::make_unique<QueuedMessage[]>(RingSize)) {
+        for (std::size_t i = 0; i < RingSize; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// Claims a slot to write a message to, returns nullptr if the ring is full
+    QueuedMessage* TryClaim() {
+        std::size_t position = write_position.load(std::memory_order_relaxed);
+        while (true) {
+            QueuedMessage& slot = slots[position & (RingSize - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (write_position.compare_exchange_weak(position, position + 1,
+                                                         std::memory_order_relaxed)) {
+                    slot.position = position;
+                    return &slot;
+                }
+            } else if (sequence < position) {
+                return nullptr;
+            } else {
+                position = write_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Hands a claimed slot over to the logging thread
+    void Publish(QueuedMessage& slot) {
+        slot.sequence.store(slot.position + 1, std::memory_order_release);
+    }
+
+    /// Returns the oldest published message, or nullptr if there is none
+    QueuedMessage* Front() {
+        QueuedMessage& slot = slots[read_position & (RingSize - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != read_position + 1) {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    /// Frees the slot returned by Front
+    void Pop() {
+        slots[read_position & (RingSize - 1)].sequence.store(read_position + RingSize,
+                                                            std::memory_order_release);
+        ++read_position;
+    }
+
+private:
+    std::unique_ptr<QueuedMessage[]> slots;
+    std::atomic<std::size_t> write_position{0};
+    /// Only accessed by the logging thread
+    std::size_t read_position{0};
+};
+
+/// Message counters of a call site for rate limiting
+struct CallSite {
+    /// Hash of the file name and line of the call site, zero while the slot is free
+    std::atomic<u64> key{0};
+    std::atomic<s64> window{-1};
+    std::atomic<u32> num_messages{0};
+    std::atomic<u32> num_suppressed{0};
+};
+
+} // Anonymous namespace
+
 /**
  * Static state as a singleton.
  */
@@ -43,10 +309,39 @@ public:
     Impl(Impl const&) = delete;
     const Impl& operator=(Impl const&) = delete;
 
-    void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
-                   const char* function, std::string message) {
-        message_queue.Push(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+    void PushMessage(Class log_class, Level log_level, const char* filename,
+                     unsigned int line_num, const char* function, const char* format,
+                     const fmt::format_args& args) {
+        const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - time_origin);
+        u32 num_suppressed = 0;
+        if (!CheckRateLimit(log_level, filename, line_num, timestamp, num_suppressed)) {
+            return;
+        }
+
+        QueuedMessage* slot = ClaimSlot();
+        if (!slot) {
+            return;
+        }
+        slot->timestamp = timestamp;
+        slot->log_class = log_class;
+        slot->log_level = log_level;
+        slot->filename = filename;
+        slot->line_num = line_num;
+        slot->function = function;
+        slot->format = format;
+        slot->num_suppressed = num_suppressed;
+        slot->final_entry = false;
+        slot->preformatted = !slot->args.Capture(args);
+        if (slot->preformatted) {
+            slot->message.clear();
+            try {
+                fmt::vformat_to(std::back_inserter(slot->message), format, args);
+            } catch (const fmt::format_error& e) {
+                slot->message = fmt::format("Invalid log message \"{}\": {}", format, e.what());
+            }
+        }
+        PublishSlot(*slot);
     }
 
     void AddBackend(std::unique_ptr<Backend> backend) {
@@ -74,6 +369,7 @@ public:
 private:
     Impl() {
         backend_thread = std::thread([&] {
+            is_logging_thread = true;
             Entry entry;
             auto write_logs = [&](Entry& e) {
                 std::lock_guard lock{writing_mutex};
@@ -82,10 +378,13 @@ private:
                 }
             };
             while (true) {
-                entry = message_queue.PopWait();
-                if (entry.final_entry) {
+                QueuedMessage& message = WaitForMessage();
+                if (message.final_entry) {
+                    ring.Pop();
                     break;
                 }
+                CreateEntry(message, entry);
+                ring.Pop();
                 write_logs(entry);
             }
 
@@ -93,41 +392,142 @@ private:
             // where a system is repeatedly spamming logs even on close.
             constexpr int MAX_LOGS_TO_WRITE = 100;
             int logs_written = 0;
-            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(entry)) {
+            while (logs_written++ < MAX_LOGS_TO_WRITE) {
+                QueuedMessage* message = ring.Front();
+                if (!message) {
+                    break;
+                }
+                CreateEntry(*message, entry);
+                ring.Pop();
                 write_logs(entry);
             }
         });
     }
 
     ~Impl() {
-        Entry entry;
-        entry.final_entry = true;
-        message_queue.Push(entry);
+        QueuedMessage* slot = ClaimSlot();
+        slot->final_entry = true;
+        PublishSlot(*slot);
         backend_thread.join();
     }
 
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string message) const {
-        using std::chrono::duration_cast;
-        using std::chrono::steady_clock;
-
-        Entry entry;
-        entry.timestamp =
-            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
-        entry.log_class = log_class;
-        entry.log_level = log_level;
-        entry.filename = filename;
-        entry.line_num = line_nr;
-        entry.function = function;
-        entry.message = std::move(message);
-
-        return entry;
+    /// Returns false if the message is suppressed, otherwise sets the number of messages of the
+    /// call site that were suppressed before it
+    bool CheckRateLimit(Level log_level, const char* filename, unsigned int line_num,
+                        std::chrono::microseconds timestamp, u32& num_suppressed) {
+        if (log_level <= Level::Debug || log_level == Level::Critical) {
+            return true;
+        }
+        CallSite* site = FindCallSite(filename, line_num);
+        if (!site) {
+            return true;
+        }
+
+        const s64 window = timestamp / RateLimitWindow;
+        s64 site_window = site->window.load(std::memory_order_relaxed);
+        if (site_window != window &&
+            site->window.compare_exchange_strong(site_window, window, std::memory_order_relaxed)) {
+            site->num_messages.store(0, std::memory_order_relaxed);
+        }
+        if (site->num_messages.fetch_add(1, std::memory_order_relaxed) >= RateLimitMessages) {
+            site->num_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        num_suppressed = site->num_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Returns the counters of a call site, or nullptr if there is no free slot left for it
+    CallSite* FindCallSite(const char* filename, unsigned int line_num) {
+        // The file name is a string literal, so its address identifies the file
+        u64 key = (reinterpret_cast<std::uintptr_t>(filename) ^ line_num) * 0x9E3779B97F4A7C15ULL;
+        key = (key ^ (key >> 32)) | 1;
+        for (std::size_t i = 0; i < CallSiteProbes; ++i) {
+            CallSite& site = call_sites[(key + i) & (NumCallSites - 1)];
+            u64 site_key = site.key.load(std::memory_order_relaxed);
+            if (site_key == 0 &&
+                site.key.compare_exchange_strong(site_key, key, std::memory_order_relaxed)) {
+                return &site;
+            }
+            if (site_key == key) {
+                return &site;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Claims a slot of the ring, waiting for the logging thread while it is full. Returns nullptr
+    /// when called by the logging thread itself on a full ring, the message is dropped then.
+    QueuedMessage* ClaimSlot() {
+        while (true) {
+            if (QueuedMessage* slot = ring.TryClaim()) {
+                return slot;
+            }
+            if (is_logging_thread) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void PublishSlot(QueuedMessage& slot) {
+        ring.Publish(slot);
+        // Pairs with the fence in WaitForMessage, so either the logging thread sees the message
+        // or this thread sees that it is waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (logging_thread_waiting.load(std::memory_order_relaxed)) {
+            std::lock_guard lock{wait_mutex};
+            message_available.notify_one();
+        }
+    }
+
+    QueuedMessage& WaitForMessage() {
+        while (true) {
+            if (QueuedMessage* message = ring.Front()) {
+                return *message;
+            }
+            std::unique_lock lock{wait_mutex};
+            logging_thread_waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ring.Front() == nullptr) {
+                message_available.wait(lock);
+            }
+            logging_thread_waiting.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /// Formats a queued message on the logging thread
+    static void CreateEntry(const QueuedMessage& message, Entry& entry) {
+        entry.timestamp = message.timestamp;
+        entry.log_class = message.log_class;
+        entry.log_level = message.log_level;
+        entry.filename = message.filename;
+        entry.line_num = message.line_num;
+        entry.function = message.function;
+        if (message.preformatted) {
+            entry.message = message.message;
+        } else {
+            try {
+                entry.message = message.args.Format(message.format);
+            } catch (const fmt::format_error& e) {
+                entry.message =
+                    fmt::format("Invalid log message \"{}\": {}", message.format, e.what());
+            }
+        }
+        if (message.num_suppressed != 0) {
+            entry.message +=
+                fmt::format(" ({} similar messages were suppressed)", message.num_suppressed);
+        }
     }
 
     std::mutex writing_mutex;
     std::thread backend_thread;
     std::vector<std::unique_ptr<Backend>> backends;
-    Common::MPSCQueue<Log::Entry> message_queue;
+    MessageRing ring;
+    std::array<CallSite, NumCallSites> call_sites;
+    std::mutex wait_mutex;
+    std::condition_variable message_available;
+    std::atomic<bool> logging_thread_waiting{false};
     Filter filter;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
 };
@@ -301,7 +701,6 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
     auto& instance = Impl::Instance();
-    instance.PushEntry(log_class, log_level, filename, line_num, function,
-                       fmt::vformat(format, args));
+    instance.PushMessage(log_class, log_level, filename, line_num, function, format, args);
 }
 } // namespace Log
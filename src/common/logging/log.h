@@ -158,7 +158,10 @@ extern Filter filter;
 
 void SetGlobalFilter(const Filter& f);
 
-/// Logs a message to the global logger, using fmt
+/**
+ * Logs a message to the global logger, using fmt. The message is formatted by the logging thread,
+ * so the format string must be a string literal, as the LOG_ macros pass.
+ */
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
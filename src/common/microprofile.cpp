@@ -5,3 +5,129 @@
 // Includes the MicroProfile implementation in this file for compilation
 #define MICROPROFILE_IMPL 1
 #include "common/microprofile.h"
+
+#include <atomic>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+
+namespace Common::Profiling {
+
+#if MICROPROFILE_ENABLED
+
+static std::atomic<bool> capturing = false;
+/// The groups that were enabled before the capture, restored after it
+static bool enabled_all_groups = false;
+
+void StartCapture() {
+    if (capturing.exchange(true)) {
+        return;
+    }
+    enabled_all_groups = MicroProfileGetEnableAllGroups();
+    MicroProfileSetEnableAllGroups(true);
+}
+
+bool IsCapturing() {
+    return capturing;
+}
+
+static std::string EscapeJson(const char* str) {
+    std::string escaped;
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            escaped += '\\';
+        }
+        escaped += *str;
+    }
+    return escaped;
+}
+
+/// Converts the frames in the history to trace events, only the CPU timers are recorded
+static std::string MakeTrace() {
+    std::lock_guard lock{MicroProfileGetMutex()};
+    const MicroProfile& profile = *MicroProfileGet();
+
+    constexpr u32 num_frames = MICROPROFILE_MAX_FRAME_HISTORY - MICROPROFILE_GPU_FRAME_DELAY - 3;
+    const u32 first_frame = (profile.nFrameCurrent + MICROPROFILE_MAX_FRAME_HISTORY - num_frames) %
+                            MICROPROFILE_MAX_FRAME_HISTORY;
+    const s64 start_tick = profile.Frames[first_frame].nFrameStartCpu;
+    const double ticks_to_us = 1000000.0 / static_cast<double>(MicroProfileTicksPerSecondCpu());
+
+    std::string trace = R"({"displayTimeUnit":"ms","traceEvents":[)";
+    bool first_event = true;
+    const auto add_event = [&trace, &first_event](std::string_view event) {
+        if (!first_event) {
+            trace += ',';
+        }
+        first_event = false;
+        trace += event;
+    };
+
+    for (u32 log_index = 0; log_index < profile.nNumLogs; log_index++) {
+        const MicroProfileThreadLog* log = profile.Pool[log_index];
+        if (!log || log->nGpu) {
+            continue;
+        }
+        add_event(fmt::format(
+            R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"{}"}}}})",
+            log_index, EscapeJson(log->ThreadName)));
+
+        for (u32 i = 0; i < num_frames; i++) {
+            const u32 frame = (first_frame + i) % MICROPROFILE_MAX_FRAME_HISTORY;
+            const u32 next_frame = (frame + 1) % MICROPROFILE_MAX_FRAME_HISTORY;
+            const u32 log_end = profile.Frames[next_frame].nLogStart[log_index];
+            for (u32 k = profile.Frames[frame].nLogStart[log_index]; k != log_end;
+                 k = (k + 1) % MICROPROFILE_BUFFER_SIZE) {
+                const MicroProfileLogEntry entry = log->Log[k];
+                const u64 type = MicroProfileLogType(entry);
+                if (type != MP_LOG_ENTER && type != MP_LOG_LEAVE) {
+                    continue;
+                }
+                const MicroProfileTimerInfo& timer =
+                    profile.TimerInfo[MicroProfileLogTimerIndex(entry)];
+                const double timestamp =
+                    static_cast<double>(MicroProfileLogTickDifference(start_tick, entry)) *
+                    ticks_to_us;
+                add_event(fmt::format(
+                    R"({{"name":"{}","cat":"{}","ph":"{}","pid":0,"tid":{},"ts":{:.3f}}})",
+                    EscapeJson(timer.pName),
+                    EscapeJson(profile.GroupInfo[timer.nGroupIndex].pName),
+                    type == MP_LOG_ENTER ? 'B' : 'E', log_index, timestamp));
+            }
+        }
+    }
+    trace += "]}";
+    return trace;
+}
+
+bool StopCapture(const std::string& path) {
+    if (!capturing.exchange(false)) {
+        return false;
+    }
+    const std::string trace = MakeTrace();
+    MicroProfileSetEnableAllGroups(enabled_all_groups);
+
+    if (FileUtil::WriteStringToFile(false, path, trace) != trace.size()) {
+        LOG_ERROR(Common, "Could not write the profile capture to {}", path);
+        return false;
+    }
+    LOG_INFO(Common, "Wrote the profile capture to {}", path);
+    return true;
+}
+
+#else
+
+void StartCapture() {}
+
+bool IsCapturing() {
+    return false;
+}
+
+bool StopCapture(const std::string& path) {
+    LOG_ERROR(Common, "Profiling is disabled in this build");
+    return false;
+}
+
+#endif
+
+} // namespace Common::Profiling
@@ -20,6 +20,24 @@
 typedef void* HANDLE;
 #endif
 
+#include <string>
 #include <microprofile.h>
 
 #define MP_RGB(r, g, b) ((r) << 16 | (g) << 8 | (b) << 0)
+
+namespace Common::Profiling {
+
+/// Starts recording every profiling scope, also the ones the profiler window does not show
+void StartCapture();
+
+/// Returns true while a capture is running
+bool IsCapturing();
+
+/**
+ * Stops the capture and writes the scopes of the frames still in the profiler history, with the
+ * names of their threads, as a Chrome trace event file. chrome://tracing and Perfetto open it.
+ * @returns false if there was no capture or the file could not be written
+ */
+bool StopCapture(const std::string& path);
+
+} // namespace Common::Profiling
@@ -27,6 +27,8 @@ std::string_view GetAPIName(GraphicsAPI api) {
         return "OpenGLES";
     case GraphicsAPI::Vulkan:
         return "Vulkan";
+    case GraphicsAPI::Null:
+        return "Null";
     }
 }
 
@@ -109,10 +111,28 @@ void LogSettings() {
     };
 
     LOG_INFO(Config, "Citra Configuration:");
+    log_setting("Controls_LateInputSampling", values.late_input_sampling.GetValue());
     log_setting("Core_UseCpuJit", values.use_cpu_jit.GetValue());
     log_setting("Core_CPUClockPercentage", values.cpu_clock_percentage.GetValue());
+    log_setting("Core_AutoCPUClock", values.auto_cpu_clock.GetValue());
+    log_setting("Core_AutoCPUClockMin", values.auto_cpu_clock_min.GetValue());
+    log_setting("Core_AutoCPUClockMax", values.auto_cpu_clock_max.GetValue());
+    log_setting("Core_ParallelCpuCores", values.parallel_cpu_cores.GetValue());
+    log_setting("Core_ParallelCpuMaxSkewUs", values.parallel_cpu_max_skew_us.GetValue());
+    log_setting("Core_IdleLoopDetection", values.idle_loop_detection.GetValue());
+    log_setting("Core_UseFastmem", values.use_fastmem.GetValue());
+    log_setting("Core_UseJitProfiles", values.use_jit_profiles.GetValue());
+    log_setting("Core_DeltaSavestates", values.delta_savestates.GetValue());
+    log_setting("Core_RewindSeconds", values.rewind_seconds.GetValue());
+    log_setting("Core_RewindStatesPerSecond", values.rewind_states_per_second.GetValue());
+    log_setting("Core_RewindMemoryMB", values.rewind_memory_mb.GetValue());
+    log_setting("Core_EmulationThreadCores", values.emulation_thread_cores.GetValue());
+    log_setting("Core_RenderThreadCores", values.render_thread_cores.GetValue());
+    log_setting("Core_AudioThreadCores", values.audio_thread_cores.GetValue());
+    log_setting("Core_MaxWorkerThreads", values.max_worker_threads.GetValue());
     log_setting("Renderer_GraphicsAPI", GetAPIName(values.graphics_api.GetValue()));
     log_setting("Renderer_AsyncShaders", values.async_shader_compilation.GetValue());
+    log_setting("Renderer_AsyncGpu", values.async_gpu.GetValue());
     log_setting("Renderer_SpirvShaderGen", values.spirv_shader_gen.GetValue());
     log_setting("Renderer_Debug", values.renderer_debug.GetValue());
     log_setting("Renderer_UseHwRenderer", values.use_hw_renderer.GetValue());
@@ -120,6 +140,18 @@ void LogSettings() {
     log_setting("Renderer_SeparableShader", values.separable_shader.GetValue());
     log_setting("Renderer_ShadersAccurateMul", values.shaders_accurate_mul.GetValue());
     log_setting("Renderer_UseShaderJit", values.use_shader_jit.GetValue());
+    log_setting("Renderer_LargeVertexCache", values.large_vertex_cache.GetValue());
+    log_setting("Renderer_GpuTextureDecoding", values.gpu_texture_decoding.GetValue());
+    log_setting("Renderer_HashTextureUploads", values.hash_texture_uploads.GetValue());
+    log_setting("Renderer_TextureMemoryBudget", values.texture_memory_budget.GetValue());
+    log_setting("Renderer_AsyncPipelineWarmup", values.async_pipeline_warmup.GetValue());
+    log_setting("Renderer_ForceUberShader", values.force_uber_shader.GetValue());
+    log_setting("Renderer_SpecializeHwShaders", values.specialize_hw_shaders.GetValue());
+    log_setting("Renderer_LowLatencyPacing", values.low_latency_pacing.GetValue());
+    log_setting("Renderer_DynamicResolution", values.dynamic_resolution.GetValue());
+    log_setting("Renderer_DynamicResolutionMin", values.dynamic_resolution_min.GetValue());
+    log_setting("Renderer_FrameSkip", values.frame_skip.GetValue());
+    log_setting("Renderer_GpuTiming", values.gpu_timing.GetValue());
     log_setting("Renderer_UseResolutionFactor", values.resolution_factor.GetValue());
     log_setting("Renderer_FrameLimit", values.frame_limit.GetValue());
     log_setting("Renderer_VSyncNew", values.use_vsync_new.GetValue());
@@ -137,11 +169,22 @@ void LogSettings() {
     log_setting("Layout_UprightScreen", values.upright_screen.GetValue());
     log_setting("Layout_LargeScreenProportion", values.large_screen_proportion.GetValue());
     log_setting("Utility_DumpTextures", values.dump_textures.GetValue());
+    log_setting("Utility_DumpTexturesFast", values.dump_textures_fast.GetValue());
     log_setting("Utility_CustomTextures", values.custom_textures.GetValue());
+    log_setting("Utility_PreloadTextures", values.preload_textures.GetValue());
+    log_setting("Utility_AsyncCustomLoading", values.async_custom_loading.GetValue());
+    log_setting("Utility_DumpDspFrames", values.dump_dsp_frames.GetValue());
+    log_setting("Utility_CustomTexturesCacheSize", values.custom_textures_cache_size.GetValue());
     log_setting("Utility_UseDiskShaderCache", values.use_disk_shader_cache.GetValue());
+    log_setting("Utility_ShaderCacheReadOnly", values.shader_cache_read_only.GetValue());
     log_setting("Audio_Emulation", GetAudioEmulationName(values.audio_emulation.GetValue()));
+    log_setting("Audio_EnableDspHleThread", values.enable_dsp_hle_thread.GetValue());
+    log_setting("Audio_EnableDspLleRelaxedSync", values.enable_dsp_lle_relaxed_sync.GetValue());
     log_setting("Audio_OutputEngine", values.sink_id.GetValue());
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
+    log_setting("Audio_EnableLowLatencyStretching",
+                values.enable_low_latency_stretching.GetValue());
+    log_setting("Audio_EnableLowLatencyOutput", values.enable_low_latency_output.GetValue());
     log_setting("Audio_OutputDevice", values.audio_device_id.GetValue());
     log_setting("Audio_InputDeviceType", values.mic_input_type.GetValue());
     log_setting("Audio_InputDevice", values.mic_input_device.GetValue());
@@ -167,6 +210,7 @@ void LogSettings() {
     log_setting("System_PluginLoaderAllowed", values.allow_plugin_loader.GetValue());
     log_setting("Debugging_UseGdbstub", values.use_gdbstub.GetValue());
     log_setting("Debugging_GdbstubPort", values.gdbstub_port.GetValue());
+    log_setting("Debugging_RpcSharedMemory", values.rpc_shared_memory.GetValue());
 }
 
 bool IsConfiguringGlobal() {
@@ -184,6 +228,15 @@ float Volume() {
     return values.volume.GetValue();
 }
 
+float Slider3D() {
+    // Titles skip the right eye pass with the slider down, which is all that is shown in mono
+    if (values.render_3d.GetValue() == StereoRenderOption::Off &&
+        values.mono_render_option.GetValue() == MonoRenderOption::LeftEye) {
+        return 0.0f;
+    }
+    return values.factor_3d.GetValue() / 100.0f;
+}
+
 void RestoreGlobalState(bool is_powered_on) {
     // If a game is running, DO NOT restore the global settings state
     if (is_powered_on) {
@@ -198,6 +251,7 @@ void RestoreGlobalState(bool is_powered_on) {
     // Core
     values.cpu_clock_percentage.SetGlobal(true);
     values.is_new_3ds.SetGlobal(true);
+    values.idle_loop_detection.SetGlobal(true);
 
     // Renderer
     values.use_hw_renderer.SetGlobal(true);
@@ -225,8 +279,11 @@ void RestoreGlobalState(bool is_powered_on) {
     values.pp_shader_name.SetGlobal(true);
     values.anaglyph_shader_name.SetGlobal(true);
     values.dump_textures.SetGlobal(true);
+    values.dump_textures_fast.SetGlobal(true);
     values.custom_textures.SetGlobal(true);
     values.preload_textures.SetGlobal(true);
+    values.async_custom_loading.SetGlobal(true);
+    values.custom_textures_cache_size.SetGlobal(true);
 }
 
 void LoadProfile(int index) {
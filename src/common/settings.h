@@ -19,6 +19,7 @@ enum class GraphicsAPI {
     OpenGL = 0,
     OpenGLES = 1,
     Vulkan = 2,
+    Null = 3,
 };
 
 enum class InitClock : u32 {
@@ -65,6 +66,21 @@ enum class MonoRenderOption : u32 {
     RightEye = 1,
 };
 
+/// How finely the GPU time of a frame is measured
+enum class GpuTimingOption : u32 {
+    Off = 0,
+    Frame = 1,
+    Renderpass = 2,
+    Draw = 3,
+};
+
+/// Which host cores a thread is kept on, only hybrid CPUs have more than one type
+enum class ThreadCoreType : u32 {
+    Any = 0,
+    Performance = 1,
+    Efficiency = 2,
+};
+
 enum class AudioEmulation : u32 {
     HLE = 0,
     LLE = 1,
@@ -402,11 +418,30 @@ struct Values {
     int current_input_profile_index;          ///< The current input profile index
     std::vector<InputProfile> input_profiles; ///< The list of input profiles
     std::vector<TouchFromButtonMap> touch_from_button_maps;
+    Setting<bool> late_input_sampling{false, "late_input_sampling"};
 
     // Core
     Setting<bool> use_cpu_jit{true, "use_cpu_jit"};
     SwitchableSetting<s32, true> cpu_clock_percentage{100, 5, 400, "cpu_clock_percentage"};
+    Setting<bool> auto_cpu_clock{false, "auto_cpu_clock"};
+    Setting<s32, true> auto_cpu_clock_min{100, 5, 400, "auto_cpu_clock_min"};
+    Setting<s32, true> auto_cpu_clock_max{200, 5, 400, "auto_cpu_clock_max"};
     SwitchableSetting<bool> is_new_3ds{true, "is_new_3ds"};
+    Setting<bool> parallel_cpu_cores{false, "parallel_cpu_cores"};
+    Setting<u32, true> parallel_cpu_max_skew_us{1000, 10, 4000, "parallel_cpu_max_skew_us"};
+    SwitchableSetting<bool> idle_loop_detection{false, "idle_loop_detection"};
+    Setting<bool> use_fastmem{true, "use_fastmem"};
+    Setting<bool> use_jit_profiles{true, "use_jit_profiles"};
+    Setting<bool> delta_savestates{false, "delta_savestates"};
+    Setting<u32, true> rewind_seconds{0, 0, 600, "rewind_seconds"};
+    Setting<u32, true> rewind_states_per_second{2, 1, 10, "rewind_states_per_second"};
+    Setting<u32, true> rewind_memory_mb{512, 16, 8192, "rewind_memory_mb"};
+    Setting<ThreadCoreType> emulation_thread_cores{ThreadCoreType::Performance,
+                                                   "emulation_thread_cores"};
+    Setting<ThreadCoreType> render_thread_cores{ThreadCoreType::Performance,
+                                                "render_thread_cores"};
+    Setting<ThreadCoreType> audio_thread_cores{ThreadCoreType::Any, "audio_thread_cores"};
+    Setting<u32> max_worker_threads{0, "max_worker_threads"};
 
     // Data Storage
     Setting<bool> use_virtual_sd{true, "use_virtual_sd"};
@@ -427,13 +462,27 @@ struct Values {
     Setting<bool> dump_command_buffers{false, "dump_command_buffers"};
     SwitchableSetting<bool> spirv_shader_gen{true, "spirv_shader_gen"};
     SwitchableSetting<bool> async_shader_compilation{false, "async_shader_compilation"};
+    Setting<bool> async_gpu{false, "async_gpu"};
     SwitchableSetting<bool> use_hw_renderer{true, "use_hw_renderer"};
     SwitchableSetting<bool> use_hw_shader{true, "use_hw_shader"};
     SwitchableSetting<bool> separable_shader{false, "use_separable_shader"};
     SwitchableSetting<bool> use_disk_shader_cache{true, "use_disk_shader_cache"};
+    Setting<bool> shader_cache_read_only{false, "shader_cache_read_only"};
     SwitchableSetting<bool> shaders_accurate_mul{true, "shaders_accurate_mul"};
     SwitchableSetting<bool> use_vsync_new{true, "use_vsync_new"};
     Setting<bool> use_shader_jit{true, "use_shader_jit"};
+    Setting<bool> large_vertex_cache{false, "large_vertex_cache"};
+    Setting<bool> gpu_texture_decoding{false, "gpu_texture_decoding"};
+    Setting<bool> hash_texture_uploads{false, "hash_texture_uploads"};
+    Setting<u32> texture_memory_budget{0, "texture_memory_budget"};
+    Setting<bool> async_pipeline_warmup{false, "async_pipeline_warmup"};
+    Setting<bool> force_uber_shader{false, "force_uber_shader"};
+    Setting<bool> specialize_hw_shaders{true, "specialize_hw_shaders"};
+    Setting<bool> low_latency_pacing{false, "low_latency_pacing"};
+    Setting<bool> dynamic_resolution{false, "dynamic_resolution"};
+    Setting<u16> dynamic_resolution_min{1, "dynamic_resolution_min"};
+    Setting<u32, true> frame_skip{0, 0, 4, "frame_skip"};
+    Setting<GpuTimingOption> gpu_timing{GpuTimingOption::Off, "gpu_timing"};
     SwitchableSetting<u16, true> resolution_factor{1, 0, 10, "resolution_factor"};
     SwitchableSetting<u16, true> frame_limit{100, 0, 1000, "frame_limit"};
     SwitchableSetting<std::string> texture_filter_name{"none", "texture_filter_name"};
@@ -472,14 +521,22 @@ struct Values {
     SwitchableSetting<std::string> anaglyph_shader_name{"dubois (builtin)", "anaglyph_shader_name"};
 
     SwitchableSetting<bool> dump_textures{false, "dump_textures"};
+    SwitchableSetting<bool> dump_textures_fast{false, "dump_textures_fast"};
     SwitchableSetting<bool> custom_textures{false, "custom_textures"};
     SwitchableSetting<bool> preload_textures{false, "preload_textures"};
+    SwitchableSetting<bool> async_custom_loading{true, "async_custom_loading"};
+    SwitchableSetting<u32> custom_textures_cache_size{512, "custom_textures_cache_size"};
+    Setting<bool> dump_dsp_frames{false, "dump_dsp_frames"};
 
     // Audio
     bool audio_muted;
     SwitchableSetting<AudioEmulation> audio_emulation{AudioEmulation::HLE, "audio_emulation"};
+    Setting<bool> enable_dsp_hle_thread{false, "enable_dsp_hle_thread"};
+    Setting<bool> enable_dsp_lle_relaxed_sync{false, "enable_dsp_lle_relaxed_sync"};
     Setting<std::string> sink_id{"auto", "output_engine"};
     SwitchableSetting<bool> enable_audio_stretching{true, "enable_audio_stretching"};
+    Setting<bool> enable_low_latency_stretching{false, "enable_low_latency_stretching"};
+    Setting<bool> enable_low_latency_output{false, "enable_low_latency_output"};
     Setting<std::string> audio_device_id{"auto", "output_device"};
     SwitchableSetting<float, true> volume{1.f, 0.f, 1.f, "volume"};
     Setting<MicInputType> mic_input_type{MicInputType::None, "mic_input_type"};
@@ -495,6 +552,7 @@ struct Values {
     std::unordered_map<std::string, bool> lle_modules;
     Setting<bool> use_gdbstub{false, "use_gdbstub"};
     Setting<u16> gdbstub_port{24689, "gdbstub_port"};
+    Setting<bool> rpc_shared_memory{false, "rpc_shared_memory"};
 
     // Miscellaneous
     Setting<std::string> log_filter{"*:Info", "log_filter"};
@@ -519,6 +577,9 @@ void SetConfiguringGlobal(bool is_global);
 
 float Volume();
 
+/// Returns the 3D slider state reported to the guest, in the 0.0-1.0 range
+float Slider3D();
+
 void Apply();
 void LogSettings();
 
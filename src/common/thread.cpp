@@ -2,13 +2,18 @@
 // SPDX-FileCopyrightText: 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "common/error.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "common/thread.h"
 #ifdef __APPLE__
 #include <mach/mach.h>
+#include <pthread.h>
 #elif defined(_WIN32)
 #include <windows.h>
 #else
@@ -140,4 +145,106 @@ void SetCurrentThreadName(const char* name) {
 
 #endif
 
+namespace {
+
+Settings::ThreadCoreType GetRoleCoreType(ThreadRole role) {
+    switch (role) {
+    case ThreadRole::Emulation:
+        return Settings::values.emulation_thread_cores.GetValue();
+    case ThreadRole::Render:
+        return Settings::values.render_thread_cores.GetValue();
+    case ThreadRole::Audio:
+        return Settings::values.audio_thread_cores.GetValue();
+    }
+    return Settings::ThreadCoreType::Any;
+}
+
+#if defined(__linux__)
+
+/// Reads a number from a sysfs file of a cpu, zero if it does not exist
+u64 ReadCpuValue(u32 cpu, const char* name) {
+    std::string value;
+    FileUtil::ReadFileToString(true, fmt::format("/sys/devices/system/cpu/cpu{}/{}", cpu, name),
+                               value);
+    return value.empty() ? 0 : std::strtoull(value.c_str(), nullptr, 10);
+}
+
+struct CoreSets {
+    cpu_set_t performance;
+    cpu_set_t efficiency;
+    /// Whether the host has more than one type of core
+    bool hybrid;
+};
+
+/// Sorts the host cores by their capacity, or their maximum frequency where it is not exposed
+CoreSets GetCoreSets() {
+    const u32 num_cpus = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<u64> capacities(num_cpus);
+    for (u32 cpu = 0; cpu < num_cpus; cpu++) {
+        capacities[cpu] = ReadCpuValue(cpu, "cpu_capacity");
+        if (capacities[cpu] == 0) {
+            capacities[cpu] = ReadCpuValue(cpu, "cpufreq/cpuinfo_max_freq");
+        }
+    }
+
+    CoreSets sets{};
+    CPU_ZERO(&sets.performance);
+    CPU_ZERO(&sets.efficiency);
+    const auto [min_it, max_it] = std::minmax_element(capacities.begin(), capacities.end());
+    sets.hybrid = *min_it != 0 && *min_it != *max_it;
+    for (u32 cpu = 0; cpu < num_cpus && sets.hybrid; cpu++) {
+        CPU_SET(cpu, capacities[cpu] == *max_it ? &sets.performance : &sets.efficiency);
+    }
+    return sets;
+}
+
+#endif
+
+} // Anonymous namespace
+
+u32 GetWorkerThreadCount(u32 wanted) {
+    const u32 max_threads = Settings::values.max_worker_threads.GetValue();
+    return max_threads == 0 ? wanted : std::min(wanted, max_threads);
+}
+
+void SetCurrentThreadRole(ThreadRole role) {
+    const Settings::ThreadCoreType core_type = GetRoleCoreType(role);
+    if (core_type == Settings::ThreadCoreType::Any) {
+        return;
+    }
+    const bool performance = core_type == Settings::ThreadCoreType::Performance;
+
+#if defined(_WIN32)
+    SetCurrentThreadPriority(performance ? ThreadPriority::High : ThreadPriority::Low);
+#ifdef THREAD_POWER_THROTTLING_CURRENT_VERSION
+    // Opting out of EcoQoS keeps the thread off the efficiency cores of hybrid CPUs
+    THREAD_POWER_THROTTLING_STATE state{};
+    state.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+    state.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+    state.StateMask = performance ? 0 : THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+    if (!SetThreadInformation(GetCurrentThread(), ThreadPowerThrottling, &state, sizeof(state))) {
+        LOG_WARNING(Common, "Failed to set the thread power throttling state: {}",
+                    GetLastErrorMsg());
+    }
+#endif
+#elif defined(__APPLE__)
+    // The scheduler places threads on the core types by their QoS class
+    const qos_class_t qos_class = performance ? QOS_CLASS_USER_INTERACTIVE : QOS_CLASS_UTILITY;
+    if (const int error = pthread_set_qos_class_self_np(qos_class, 0)) {
+        LOG_WARNING(Common, "Failed to set the thread QoS class: {}", error);
+    }
+#elif defined(__linux__)
+    // Android's hint sessions need a target duration per frame that the threads can't provide, so
+    // the affinity is used there as well
+    static const CoreSets core_sets = GetCoreSets();
+    if (!core_sets.hybrid) {
+        return;
+    }
+    const cpu_set_t& cores = performance ? core_sets.performance : core_sets.efficiency;
+    if (sched_setaffinity(0, sizeof(cores), &cores) != 0) {
+        LOG_WARNING(Common, "Failed to set the thread affinity: {}", GetLastErrorMsg());
+    }
+#endif
+}
+
 } // namespace Common
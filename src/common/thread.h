@@ -111,4 +111,24 @@ void SetCurrentThreadPriority(ThreadPriority new_priority);
 
 void SetCurrentThreadName(const char* name);
 
+/// What a thread is used for, each role has its own core type setting
+enum class ThreadRole : u32 {
+    /// Threads running the emulated CPU cores
+    Emulation,
+    /// GPU emulation, presentation and renderer submission threads
+    Render,
+    /// DSP emulation threads
+    Audio,
+};
+
+/**
+ * Keeps the current thread on the host cores configured for its role and requests the matching
+ * scheduling class: affinity on Linux and Android, the QoS class on macOS and the priority and
+ * power throttling state on Windows. Does nothing for roles configured to run on any core.
+ */
+void SetCurrentThreadRole(ThreadRole role);
+
+/// Returns at most `wanted`, limited by the max_worker_threads setting when it is set
+u32 GetWorkerThreadCount(u32 wanted);
+
 } // namespace Common
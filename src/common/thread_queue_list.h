@@ -4,204 +4,214 @@
 
 #pragma once
 
-#include <algorithm>
 #include <array>
+#include <bit>
 #include <deque>
 #include <boost/serialization/deque.hpp>
 #include <boost/serialization/split_member.hpp>
+#include "common/assert.h"
 #include "common/common_types.h"
 
 namespace Common {
 
+/**
+ * Links of an element of a ThreadQueueList. The list holds pointers to its elements, and the
+ * pointed-to type needs a public member of this type named queue_hook.
+ */
+template <class T>
+struct ThreadQueueListHook {
+    T prev{};
+    T next{};
+    /// List that currently holds the element, or nullptr
+    const void* list = nullptr;
+    unsigned int priority = 0;
+};
+
+/**
+ * Priority queue of threads with one FIFO list per priority level. The lists are intrusive, and a
+ * bitmap of the non-empty levels makes finding the best ready thread a count of trailing zeros,
+ * so all operations are O(1).
+ */
 template <class T, unsigned int N>
 struct ThreadQueueList {
-    // TODO(yuriks): If performance proves to be a problem, the std::deques can be replaced with
-    //               (dynamically resizable) circular buffers to remove their overhead when
-    //               inserting and popping.
+    static_assert(N <= 64, "The priority bitmap only has room for 64 levels");
 
     using Priority = unsigned int;
 
     // Number of priority levels. (Valid levels are [0..NUM_QUEUES).)
     static constexpr Priority NUM_QUEUES = N;
 
-    ThreadQueueList() {
-        first = nullptr;
-    }
+    ThreadQueueList() = default;
+
+    ThreadQueueList(const ThreadQueueList&) = delete;
+    ThreadQueueList& operator=(const ThreadQueueList&) = delete;
 
     // Only for debugging, returns priority level.
     [[nodiscard]] Priority contains(const T& uid) const {
-        for (Priority i = 0; i < NUM_QUEUES; ++i) {
-            const Queue& cur = queues[i];
-            if (std::find(cur.data.cbegin(), cur.data.cend(), uid) != cur.data.cend()) {
-                return i;
-            }
-        }
-
-        return -1;
+        const auto& hook = uid->queue_hook;
+        return hook.list == this ? hook.priority : -1;
     }
 
     [[nodiscard]] T get_first() const {
-        const Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                return cur->data.front();
-            }
-            cur = cur->next_nonempty;
+        if (occupied == 0) {
+            return T();
         }
-
-        return T();
+        return queues[std::countr_zero(occupied)].head;
     }
 
     T pop_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
+        if (occupied == 0) {
+            return T();
         }
-
-        return T();
+        return pop_front(static_cast<Priority>(std::countr_zero(occupied)));
     }
 
     T pop_first_better(Priority priority) {
-        Queue* cur = first;
-        Queue* stop = &queues[priority];
-        while (cur < stop) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
+        const u64 better = occupied & LevelsBefore(priority);
+        if (better == 0) {
+            return T();
         }
-
-        return T();
+        return pop_front(static_cast<Priority>(std::countr_zero(better)));
     }
 
     void push_front(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_front(thread_id);
+        Queue& cur = queues[priority];
+        auto& hook = Link(priority, thread_id);
+        hook.next = cur.head;
+        if (cur.head) {
+            cur.head->queue_hook.prev = thread_id;
+        } else {
+            cur.tail = thread_id;
+        }
+        cur.head = thread_id;
     }
 
     void push_back(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_back(thread_id);
+        Queue& cur = queues[priority];
+        auto& hook = Link(priority, thread_id);
+        hook.prev = cur.tail;
+        if (cur.tail) {
+            cur.tail->queue_hook.next = thread_id;
+        } else {
+            cur.head = thread_id;
+        }
+        cur.tail = thread_id;
     }
 
-    void move(const T& thread_id, Priority old_priority, Priority new_priority) {
-        remove(old_priority, thread_id);
-        prepare(new_priority);
+    /// Moves the thread to the back of new_priority, wherever it is queued now.
+    void move(const T& thread_id, [[maybe_unused]] Priority old_priority, Priority new_priority) {
         push_back(new_priority, thread_id);
     }
 
     void remove(Priority priority, const T& thread_id) {
-        Queue* const cur = &queues[priority];
-        const auto iter = std::remove(cur->data.begin(), cur->data.end(), thread_id);
-        cur->data.erase(iter, cur->data.end());
+        auto& hook = thread_id->queue_hook;
+        if (hook.list != this || hook.priority != priority) {
+            return;
+        }
+
+        Queue& cur = queues[priority];
+        if (hook.prev) {
+            hook.prev->queue_hook.next = hook.next;
+        } else {
+            cur.head = hook.next;
+        }
+        if (hook.next) {
+            hook.next->queue_hook.prev = hook.prev;
+        } else {
+            cur.tail = hook.prev;
+        }
+        if (!cur.head) {
+            occupied &= ~(u64{1} << priority);
+        }
+        hook = {};
     }
 
     void rotate(Priority priority) {
-        Queue* cur = &queues[priority];
-
-        if (cur->data.size() > 1) {
-            cur->data.push_back(std::move(cur->data.front()));
-            cur->data.pop_front();
+        Queue& cur = queues[priority];
+        if (cur.head != cur.tail) {
+            push_back(priority, pop_front(priority));
         }
     }
 
     void clear() {
-        queues.fill(Queue());
-        first = nullptr;
+        for (Priority i = 0; i < NUM_QUEUES; ++i) {
+            while (queues[i].head) {
+                pop_front(i);
+            }
+        }
     }
 
     [[nodiscard]] bool empty(Priority priority) const {
-        const Queue* cur = &queues[priority];
-        return cur->data.empty();
-    }
-
-    void prepare(Priority priority) {
-        Queue* cur = &queues[priority];
-        if (cur->next_nonempty == UnlinkedTag())
-            link(priority);
+        return !queues[priority].head;
     }
 
 private:
     struct Queue {
-        // Points to the next active priority, skipping over ones that have never been used.
-        Queue* next_nonempty = UnlinkedTag();
-        // Double-ended queue of threads in this priority level
-        std::deque<T> data;
+        T head{};
+        T tail{};
     };
 
-    /// Special tag used to mark priority levels that have never been used.
-    static Queue* UnlinkedTag() {
-        return reinterpret_cast<Queue*>(1);
+    static constexpr u64 LevelsBefore(Priority priority) {
+        return priority >= 64 ? ~u64{0} : (u64{1} << priority) - 1;
     }
 
-    void link(Priority priority) {
-        Queue* cur = &queues[priority];
-
-        for (int i = priority - 1; i >= 0; --i) {
-            if (queues[i].next_nonempty != UnlinkedTag()) {
-                cur->next_nonempty = queues[i].next_nonempty;
-                queues[i].next_nonempty = cur;
-                return;
-            }
+    auto& Link(Priority priority, const T& thread_id) {
+        auto& hook = thread_id->queue_hook;
+        // A thread that is queued again moves to its new place, like a priority change does
+        if (hook.list == this) {
+            remove(hook.priority, thread_id);
         }
-
-        cur->next_nonempty = first;
-        first = cur;
+        ASSERT_MSG(hook.list == nullptr, "Thread is already in another ready queue");
+        hook.list = this;
+        hook.priority = priority;
+        hook.prev = T();
+        hook.next = T();
+        occupied |= u64{1} << priority;
+        return hook;
     }
 
-    // The first queue that's ever been used.
-    Queue* first;
-    // The priority level queues of thread ids.
-    std::array<Queue, NUM_QUEUES> queues;
-
-    s64 ToIndex(const Queue* q) const {
-        if (q == nullptr) {
-            return -2;
-        } else if (q == UnlinkedTag()) {
-            return -1;
-        } else {
-            return q - queues.data();
-        }
+    T pop_front(Priority priority) {
+        T thread_id = queues[priority].head;
+        remove(priority, thread_id);
+        return thread_id;
     }
 
-    Queue* ToPointer(s64 idx) {
-        if (idx == -1) {
-            return UnlinkedTag();
-        } else if (idx < 0) {
-            return nullptr;
-        } else {
-            return &queues[idx];
-        }
-    }
+    /// Bit i is set if priority level i has ready threads
+    u64 occupied = 0;
+    // The priority level queues of thread ids.
+    std::array<Queue, NUM_QUEUES> queues{};
 
+    // Save states store the levels as deques, following the links of levels that were used
+    // before. The links are rebuilt from the deques when loading.
     friend class boost::serialization::access;
     template <class Archive>
     void save(Archive& ar, const unsigned int file_version) const {
-        const s64 idx = ToIndex(first);
-        ar << idx;
-        for (std::size_t i = 0; i < NUM_QUEUES; i++) {
-            const s64 idx1 = ToIndex(queues[i].next_nonempty);
-            ar << idx1;
-            ar << queues[i].data;
+        const s64 first = occupied == 0 ? -2 : std::countr_zero(occupied);
+        ar << first;
+        for (Priority i = 0; i < NUM_QUEUES; i++) {
+            const u64 later = occupied & ~LevelsBefore(i + 1);
+            const s64 next = empty(i) ? -1 : (later == 0 ? -2 : std::countr_zero(later));
+            ar << next;
+            std::deque<T> data;
+            for (T cur = queues[i].head; cur; cur = cur->queue_hook.next) {
+                data.push_back(cur);
+            }
+            ar << data;
         }
     }
 
     template <class Archive>
     void load(Archive& ar, const unsigned int file_version) {
+        clear();
         s64 idx;
         ar >> idx;
-        first = ToPointer(idx);
-        for (std::size_t i = 0; i < NUM_QUEUES; i++) {
+        for (Priority i = 0; i < NUM_QUEUES; i++) {
             ar >> idx;
-            queues[i].next_nonempty = ToPointer(idx);
-            ar >> queues[i].data;
+            std::deque<T> data;
+            ar >> data;
+            for (const T& thread_id : data) {
+                push_back(i, thread_id);
+            }
         }
     }
 
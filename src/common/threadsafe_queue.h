@@ -194,4 +194,65 @@ private:
     SPSCQueue<T, with_stop_token> spsc_queue;
     std::mutex write_lock;
 };
+
+// a lock-free thread-safe,
+// single reader, multiple writer queue
+// Writers push onto an intrusive stack with a single compare-and-swap. The reader takes the whole
+// stack at once and restores the push order, so it never contends with the writers.
+
+template <typename T>
+class LockFreeMPSCQueue {
+public:
+    LockFreeMPSCQueue() = default;
+    LockFreeMPSCQueue(const LockFreeMPSCQueue&) = delete;
+    LockFreeMPSCQueue& operator=(const LockFreeMPSCQueue&) = delete;
+
+    ~LockFreeMPSCQueue() {
+        Clear();
+    }
+
+    [[nodiscard]] bool Empty() const {
+        return head.load(std::memory_order_relaxed) == nullptr;
+    }
+
+    template <typename Arg>
+    void Push(Arg&& t) {
+        Node* node = new Node{std::forward<Arg>(t), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    // removes every queued element and passes it to func, in the order they were pushed
+    template <typename Func>
+    void PopAll(Func&& func) {
+        Node* node = head.exchange(nullptr, std::memory_order_acquire);
+        Node* reversed = nullptr;
+        while (node) {
+            Node* next = node->next;
+            node->next = reversed;
+            reversed = node;
+            node = next;
+        }
+        while (reversed) {
+            Node* next = reversed->next;
+            func(reversed->value);
+            delete reversed;
+            reversed = next;
+        }
+    }
+
+    // only thread-safe with regard to the writers
+    void Clear() {
+        PopAll([](T&) {});
+    }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> head{nullptr};
+};
 } // namespace Common
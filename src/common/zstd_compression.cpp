@@ -3,13 +3,46 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <memory>
 #include <zstd.h>
 
 #include "common/assert.h"
+#include "common/file_util.h"
 #include "common/zstd_compression.h"
 
 namespace Common::Compression {
 
+namespace {
+
+/// Any frame with this magic is skipped by decoders that don't know the seek table
+constexpr u32 SkippableFrameMagic = 0x184D2A5E;
+constexpr u32 SeekableMagic = 0x8F92EAB1;
+constexpr std::size_t SkippableFrameHeaderSize = 8;
+/// Number of frames, descriptor and seekable magic
+constexpr std::size_t SeekTableFooterSize = 9;
+/// Set in the descriptor when the entries are followed by a checksum
+constexpr u8 SeekTableChecksumFlag = 0x80;
+constexpr u8 SeekTableReservedBits = 0x7C;
+/// Decompressed frames kept by a reader, at least one frame is always kept
+constexpr std::size_t MaxCachedFrameBytes = 0x800000;
+
+u32 ReadLE32(const u8* data) {
+    return static_cast<u32>(data[0]) | static_cast<u32>(data[1]) << 8 |
+           static_cast<u32>(data[2]) << 16 | static_cast<u32>(data[3]) << 24;
+}
+
+void AppendLE32(std::vector<u8>& data, u32 value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        data.push_back(static_cast<u8>(value >> shift));
+    }
+}
+
+} // Anonymous namespace
+
 std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size, s32 compression_level) {
     compression_level = std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel());
 
@@ -48,4 +81,252 @@ std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
     return decompressed;
 }
 
+bool DecompressDataZSTD(const u8* source, std::size_t source_size, u8* destination,
+                        std::size_t destination_size) {
+    const std::size_t result =
+        ZSTD_decompress(destination, destination_size, source, source_size);
+    return !ZSTD_isError(result) && result == destination_size;
+}
+
+ZSTDDecompressStreambuf::ZSTDDecompressStreambuf(FileUtil::IOFile& file_)
+    : file{file_}, context{ZSTD_createDCtx()}, in_buffer(ZSTD_DStreamInSize()),
+      out_buffer(ZSTD_DStreamOutSize()) {
+    setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+}
+
+ZSTDDecompressStreambuf::~ZSTDDecompressStreambuf() {
+    ZSTD_freeDCtx(context);
+}
+
+ZSTDDecompressStreambuf::int_type ZSTDDecompressStreambuf::underflow() {
+    for (;;) {
+        if (in_pos == in_size && !output_pending) {
+            in_size = file.ReadBytes(in_buffer.data(), in_buffer.size());
+            in_pos = 0;
+            if (in_size == 0) {
+                return traits_type::eof();
+            }
+        }
+
+        ZSTD_inBuffer in{in_buffer.data(), in_size, in_pos};
+        ZSTD_outBuffer out{out_buffer.data(), out_buffer.size(), 0};
+        const std::size_t result = ZSTD_decompressStream(context, &out, &in);
+        if (ZSTD_isError(result)) {
+            return traits_type::eof();
+        }
+        in_pos = in.pos;
+        output_pending = out.pos == out.size;
+        if (out.pos != 0) {
+            setg(out_buffer.data(), out_buffer.data(), out_buffer.data() + out.pos);
+            return traits_type::to_int_type(*gptr());
+        }
+    }
+}
+
+bool CompressSeekableZSTD(FileUtil::IOFile& source, FileUtil::IOFile& destination,
+                          s32 compression_level, std::size_t frame_size) {
+    if (!source.IsOpen() || !destination.IsOpen() || frame_size == 0 ||
+        frame_size > std::numeric_limits<u32>::max()) {
+        return false;
+    }
+    compression_level = std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel());
+
+    const std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context{ZSTD_createCCtx(),
+                                                                       ZSTD_freeCCtx};
+    std::vector<u8> data(frame_size);
+    std::vector<u8> compressed(ZSTD_compressBound(frame_size));
+    std::vector<u8> seek_table;
+    u32 num_frames = 0;
+
+    source.Seek(0, SEEK_SET);
+    for (;;) {
+        const std::size_t size = source.ReadBytes(data.data(), data.size());
+        if (size == 0) {
+            break;
+        }
+        const std::size_t compressed_size =
+            ZSTD_compressCCtx(context.get(), compressed.data(), compressed.size(), data.data(),
+                              size, compression_level);
+        if (ZSTD_isError(compressed_size) ||
+            destination.WriteBytes(compressed.data(), compressed_size) != compressed_size) {
+            return false;
+        }
+        AppendLE32(seek_table, static_cast<u32>(compressed_size));
+        AppendLE32(seek_table, static_cast<u32>(size));
+        num_frames++;
+        if (size != data.size()) {
+            break;
+        }
+    }
+
+    AppendLE32(seek_table, num_frames);
+    seek_table.push_back(0);
+    AppendLE32(seek_table, SeekableMagic);
+
+    std::vector<u8> header;
+    AppendLE32(header, SkippableFrameMagic);
+    AppendLE32(header, static_cast<u32>(seek_table.size()));
+    return destination.WriteBytes(header.data(), header.size()) == header.size() &&
+           destination.WriteBytes(seek_table.data(), seek_table.size()) == seek_table.size();
+}
+
+struct SeekableZSTDReader::Impl {
+    struct Frame {
+        u64 compressed_offset;
+        u64 decompressed_offset;
+        u32 compressed_size;
+        u32 decompressed_size;
+    };
+
+    struct CachedFrame {
+        std::size_t index;
+        std::vector<u8> data;
+    };
+
+    bool LoadSeekTable();
+    bool DecompressFrame(const Frame& frame, u8* destination);
+    const std::vector<u8>* GetFrame(std::size_t index);
+
+    FileUtil::IOFile file;
+    bool is_valid = false;
+    std::vector<Frame> frames;
+    u64 size = 0;
+
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context{ZSTD_createDCtx(),
+                                                                 ZSTD_freeDCtx};
+    std::vector<u8> compressed;
+    /// Most recently used first
+    std::list<CachedFrame> cache;
+    std::size_t cached_bytes = 0;
+};
+
+bool SeekableZSTDReader::Impl::LoadSeekTable() {
+    const u64 file_size = file.GetSize();
+    if (file_size < SkippableFrameHeaderSize + SeekTableFooterSize) {
+        return false;
+    }
+
+    std::array<u8, SeekTableFooterSize> footer;
+    file.Seek(file_size - footer.size(), SEEK_SET);
+    if (file.ReadBytes(footer.data(), footer.size()) != footer.size() ||
+        ReadLE32(footer.data() + 5) != SeekableMagic || (footer[4] & SeekTableReservedBits) != 0) {
+        return false;
+    }
+
+    const u32 num_frames = ReadLE32(footer.data());
+    const std::size_t entry_size = (footer[4] & SeekTableChecksumFlag) ? 12 : 8;
+    const u64 table_size = static_cast<u64>(num_frames) * entry_size + SeekTableFooterSize;
+    if (file_size < SkippableFrameHeaderSize + table_size) {
+        return false;
+    }
+    const u64 table_offset = file_size - table_size - SkippableFrameHeaderSize;
+
+    std::vector<u8> table(SkippableFrameHeaderSize + table_size - SeekTableFooterSize);
+    file.Seek(table_offset, SEEK_SET);
+    if (file.ReadBytes(table.data(), table.size()) != table.size() ||
+        ReadLE32(table.data()) != SkippableFrameMagic ||
+        ReadLE32(table.data() + 4) != table_size) {
+        return false;
+    }
+
+    frames.resize(num_frames);
+    u64 compressed_offset = 0;
+    for (std::size_t i = 0; i < frames.size(); i++) {
+        const u8* entry = table.data() + SkippableFrameHeaderSize + i * entry_size;
+        frames[i] = {compressed_offset, size, ReadLE32(entry), ReadLE32(entry + 4)};
+        compressed_offset += frames[i].compressed_size;
+        size += frames[i].decompressed_size;
+    }
+    // The frames have to end where the seek table starts
+    return compressed_offset == table_offset;
+}
+
+bool SeekableZSTDReader::Impl::DecompressFrame(const Frame& frame, u8* destination) {
+    compressed.resize(frame.compressed_size);
+    file.Seek(frame.compressed_offset, SEEK_SET);
+    if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        return false;
+    }
+    const std::size_t result = ZSTD_decompressDCtx(context.get(), destination,
+                                                   frame.decompressed_size, compressed.data(),
+                                                   compressed.size());
+    return !ZSTD_isError(result) && result == frame.decompressed_size;
+}
+
+const std::vector<u8>* SeekableZSTDReader::Impl::GetFrame(std::size_t index) {
+    const auto it = std::find_if(cache.begin(), cache.end(), [index](const CachedFrame& cached) {
+        return cached.index == index;
+    });
+    if (it != cache.end()) {
+        cache.splice(cache.begin(), cache, it);
+        return &it->data;
+    }
+
+    const Frame& frame = frames[index];
+    while (!cache.empty() && cached_bytes + frame.decompressed_size > MaxCachedFrameBytes) {
+        cached_bytes -= cache.back().data.size();
+        cache.pop_back();
+    }
+    std::vector<u8> data(frame.decompressed_size);
+    if (!DecompressFrame(frame, data.data())) {
+        return nullptr;
+    }
+    cached_bytes += data.size();
+    cache.push_front({index, std::move(data)});
+    return &cache.front().data;
+}
+
+SeekableZSTDReader::SeekableZSTDReader(FileUtil::IOFile&& file) : impl{std::make_unique<Impl>()} {
+    impl->file = std::move(file);
+    impl->is_valid = impl->file.IsOpen() && impl->LoadSeekTable();
+}
+
+SeekableZSTDReader::~SeekableZSTDReader() = default;
+
+bool SeekableZSTDReader::IsValid() const {
+    return impl->is_valid;
+}
+
+u64 SeekableZSTDReader::GetSize() const {
+    return impl->is_valid ? impl->size : 0;
+}
+
+std::size_t SeekableZSTDReader::Read(u64 offset, u8* destination, std::size_t length) {
+    if (!impl->is_valid || offset >= impl->size) {
+        return 0;
+    }
+    length = static_cast<std::size_t>(std::min<u64>(length, impl->size - offset));
+
+    // The last frame starting at or before the offset
+    const auto& frames = impl->frames;
+    const auto next = std::upper_bound(
+        frames.begin(), frames.end(), offset,
+        [](u64 value, const Impl::Frame& frame) { return value < frame.decompressed_offset; });
+    std::size_t index = static_cast<std::size_t>(next - frames.begin()) - 1;
+
+    std::size_t done = 0;
+    for (; done < length; index++) {
+        const Impl::Frame& frame = frames[index];
+        const std::size_t frame_offset =
+            static_cast<std::size_t>(offset + done - frame.decompressed_offset);
+        const std::size_t count =
+            std::min<std::size_t>(length - done, frame.decompressed_size - frame_offset);
+
+        if (count == frame.decompressed_size) {
+            // Whole frames are decompressed straight into the destination
+            if (!impl->DecompressFrame(frame, destination + done)) {
+                break;
+            }
+        } else {
+            const std::vector<u8>* data = impl->GetFrame(index);
+            if (!data) {
+                break;
+            }
+            std::memcpy(destination + done, data->data() + frame_offset, count);
+        }
+        done += count;
+    }
+    return done;
+}
+
 } // namespace Common::Compression
@@ -4,10 +4,18 @@
 
 #pragma once
 
+#include <memory>
+#include <streambuf>
 #include <vector>
 
 #include "common/common_types.h"
 
+struct ZSTD_DCtx_s;
+
+namespace FileUtil {
+class IOFile;
+}
+
 namespace Common::Compression {
 
 /**
@@ -42,4 +50,81 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed);
 
+/**
+ * Decompresses a source memory region with Zstandard into a destination memory region.
+ *
+ * @param source the compressed source memory region.
+ * @param source_size the size in bytes of the compressed source memory region.
+ * @param destination the memory region to decompress into.
+ * @param destination_size the size in bytes the data has when decompressed.
+ *
+ * @return whether the data was decompressed and filled the destination exactly.
+ */
+[[nodiscard]] bool DecompressDataZSTD(const u8* source, std::size_t source_size, u8* destination,
+                                      std::size_t destination_size);
+
+/**
+ * Stream buffer that reads Zstandard frames from a file, starting at its current position, and
+ * decompresses them as they are read.
+ */
+class ZSTDDecompressStreambuf final : public std::streambuf {
+public:
+    explicit ZSTDDecompressStreambuf(FileUtil::IOFile& file);
+    ~ZSTDDecompressStreambuf() override;
+
+protected:
+    int_type underflow() override;
+
+private:
+    FileUtil::IOFile& file;
+    ZSTD_DCtx_s* context;
+    std::vector<char> in_buffer;
+    std::vector<char> out_buffer;
+    std::size_t in_pos = 0;
+    std::size_t in_size = 0;
+    /// Set when the last output filled the buffer, the context may then hold more data
+    bool output_pending = false;
+};
+
+/// Decompressed size of the frames written by CompressSeekableZSTD
+constexpr std::size_t SeekableFrameSize = 0x40000;
+
+/**
+ * Compresses a file into the Zstandard seekable format: independent frames followed by a
+ * skippable frame holding their sizes, so that any range can be decompressed on its own. The whole
+ * source file is compressed, starting from its beginning.
+ *
+ * @return whether the whole file was compressed and written.
+ */
+[[nodiscard]] bool CompressSeekableZSTD(FileUtil::IOFile& source, FileUtil::IOFile& destination,
+                                        s32 compression_level,
+                                        std::size_t frame_size = SeekableFrameSize);
+
+/**
+ * Random access reader of a file in the Zstandard seekable format. Reads only decompress the
+ * frames they touch, the most recently used frames are kept decompressed for the reads that follow.
+ */
+class SeekableZSTDReader {
+public:
+    /// Takes ownership of the file, which stays invalid when it is not in the seekable format
+    explicit SeekableZSTDReader(FileUtil::IOFile&& file);
+    ~SeekableZSTDReader();
+
+    [[nodiscard]] bool IsValid() const;
+
+    /// Size of the decompressed data
+    [[nodiscard]] u64 GetSize() const;
+
+    /**
+     * Reads decompressed data.
+     *
+     * @return the number of bytes read, short at the end of the data or on a corrupted frame.
+     */
+    std::size_t Read(u64 offset, u8* destination, std::size_t length);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
 } // namespace Common::Compression
@@ -2,12 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <dynarmic/interface/A32/a32.h>
 #include <dynarmic/interface/A32/context.h>
 #include <dynarmic/interface/optimization_flags.h>
 #include "common/assert.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
 #include "core/arm/dynarmic/arm_exclusive_monitor.h"
@@ -104,16 +106,23 @@ public:
     }
 
     bool MemoryWriteExclusive8(u32 vaddr, u8 value, u8 expected) override {
-        return memory.WriteExclusive8(vaddr, value, expected);
+        return RecordExclusiveWrite(memory.WriteExclusive8(vaddr, value, expected));
     }
     bool MemoryWriteExclusive16(u32 vaddr, u16 value, u16 expected) override {
-        return memory.WriteExclusive16(vaddr, value, expected);
+        return RecordExclusiveWrite(memory.WriteExclusive16(vaddr, value, expected));
     }
     bool MemoryWriteExclusive32(u32 vaddr, u32 value, u32 expected) override {
-        return memory.WriteExclusive32(vaddr, value, expected);
+        return RecordExclusiveWrite(memory.WriteExclusive32(vaddr, value, expected));
     }
     bool MemoryWriteExclusive64(u32 vaddr, u64 value, u64 expected) override {
-        return memory.WriteExclusive64(vaddr, value, expected);
+        return RecordExclusiveWrite(memory.WriteExclusive64(vaddr, value, expected));
+    }
+
+    /// Dynarmic only asks for the write once the reservation check passed, so a failure here
+    /// means the value changed under a plain store.
+    bool RecordExclusiveWrite(bool success) {
+        parent.exclusive_monitor.RecordWrite(parent.GetID(), success);
+        return success;
     }
 
     void InterpreterFallback(VAddr pc, std::size_t num_instructions) override {
@@ -180,7 +189,18 @@ ARM_Dynarmic::ARM_Dynarmic(Core::System* system_, Memory::MemorySystem& memory_,
     SetPageTable(memory.GetCurrentPageTable());
 }
 
-ARM_Dynarmic::~ARM_Dynarmic() = default;
+ARM_Dynarmic::~ARM_Dynarmic() {
+    const auto& stats = idle_loop_detector.GetStats();
+    if (stats.skipped_slices == 0) {
+        return;
+    }
+    const double ns_per_tick =
+        run_ticks ? static_cast<double>(run_time.count()) / static_cast<double>(run_ticks) : 0.0;
+    LOG_INFO(Core_ARM11,
+             "Core {} skipped {} of {} detected idle loop slices, {} ticks, ~{:.1f} ms host time",
+             GetID(), stats.skipped_slices, stats.detected_loops, stats.skipped_ticks,
+             ns_per_tick * static_cast<double>(stats.skipped_ticks) / 1000000.0);
+}
 
 MICROPROFILE_DEFINE(ARM_Jit, "ARM JIT", "ARM JIT", MP_RGB(255, 64, 64));
 
@@ -188,7 +208,25 @@ void ARM_Dynarmic::Run() {
     ASSERT(memory.GetCurrentPageTable() == current_page_table);
     MICROPROFILE_SCOPE(ARM_Jit);
 
+    const bool detect_idle_loops = Settings::values.idle_loop_detection.GetValue();
+    if (detect_idle_loops && idle_loop_detector.IsStillIdle(*this, *current_page_table)) {
+        // Nothing the loop polls can change before the next event, skip straight to it.
+        idle_loop_detector.OnSliceSkipped(GetTimer().GetDowncount());
+        GetTimer().Idle();
+        return;
+    }
+
+    const s64 start_downcount = GetTimer().GetDowncount();
+    const auto start_time = std::chrono::steady_clock::now();
     jit->Run();
+    run_time += std::chrono::steady_clock::now() - start_time;
+    run_ticks += static_cast<u64>(std::max<s64>(start_downcount - GetTimer().GetDowncount(), 0));
+
+    // Only a thread that spun through the whole slice is a candidate, returning early means it
+    // made a kernel call or was preempted.
+    if (detect_idle_loops && GetTimer().GetDowncount() <= 0) {
+        idle_loop_detector.OnSliceExhausted(*this, *current_page_table);
+    }
 }
 
 void ARM_Dynarmic::Step() {
@@ -310,8 +348,8 @@ void ARM_Dynarmic::PrepareReschedule() {
 }
 
 void ARM_Dynarmic::ClearInstructionCache() {
-    for (const auto& j : jits) {
-        j.second->ClearCache();
+    for (const auto& cached : jits) {
+        cached.jit->ClearCache();
     }
 }
 
@@ -329,14 +367,19 @@ std::shared_ptr<Memory::PageTable> ARM_Dynarmic::GetPageTable() const {
 
 void ARM_Dynarmic::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) {
     current_page_table = page_table;
+    idle_loop_detector.Reset();
     Dynarmic::A32::Context ctx{};
     if (jit) {
         jit->SaveContext(ctx);
     }
 
-    auto iter = jits.find(current_page_table);
+    auto iter = std::find_if(jits.begin(), jits.end(), [&](const CachedJit& cached) {
+        return cached.page_table.lock() == current_page_table;
+    });
     if (iter != jits.end()) {
-        jit = iter->second.get();
+        // Move the entry to the back to mark it as the most recently used.
+        std::rotate(iter, iter + 1, jits.end());
+        jit = jits.back().jit.get();
         jit->LoadContext(ctx);
         return;
     }
@@ -344,7 +387,22 @@ void ARM_Dynarmic::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_t
     auto new_jit = MakeJit();
     jit = new_jit.get();
     jit->LoadContext(ctx);
-    jits.emplace(current_page_table, std::move(new_jit));
+    jits.push_back({current_page_table, std::move(new_jit)});
+    EvictJits();
+}
+
+void ARM_Dynarmic::EvictJits() {
+    // The page table of an exited process is gone for good, as is any code compiled against it.
+    std::erase_if(jits, [](const CachedJit& cached) { return cached.page_table.expired(); });
+
+    // Applets and system modules that are relaunched get new page tables, keep the number of
+    // JITs for page tables that are idle bounded instead of growing the code caches indefinitely.
+    // The most recently used entry is the current one and is never evicted.
+    if (jits.size() > MAX_CACHED_JITS + 1) {
+        const auto num_evicted = jits.size() - MAX_CACHED_JITS - 1;
+        LOG_DEBUG(Core_ARM11, "Core {} evicting {} idle JITs", GetID(), num_evicted);
+        jits.erase(jits.begin(), jits.begin() + num_evicted);
+    }
 }
 
 void ARM_Dynarmic::ServeBreak() {
@@ -358,9 +416,38 @@ std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     Dynarmic::A32::UserConfig config;
     config.callbacks = cb.get();
     config.page_table = &current_page_table->GetPointerArray();
+    const Core::JitProfile& profile = system.GetJitProfile();
+    // Pages the fastmem arena does not map fault, the JIT then recompiles the access to go through
+    // the page table and the memory callbacks instead.
+    u8* fastmem_pointer = current_page_table->GetFastmemPointer();
+    if (fastmem_pointer && profile.fastmem) {
+        config.fastmem_pointer = reinterpret_cast<std::uintptr_t>(fastmem_pointer);
+        config.recompile_on_fastmem_failure = true;
+        // Exclusive stores become an inline host compare-and-swap on the arena, instead of a call
+        // into MemorySystem::WriteExclusive* while the global monitor is locked.
+        config.fastmem_exclusive_access = true;
+        config.recompile_on_exclusive_fastmem_failure = true;
+    }
     config.coprocessors[15] = std::make_shared<DynarmicCP15>(cp15_state);
     config.define_unpredictable_behaviour = true;
 
+    using Dynarmic::OptimizationFlag;
+    config.optimizations = Dynarmic::no_optimizations;
+    const auto enable = [&config](bool enabled, OptimizationFlag flag) {
+        if (enabled) {
+            config.optimizations |= flag;
+        }
+    };
+    enable(profile.block_linking, OptimizationFlag::BlockLinking);
+    enable(profile.return_stack_buffer, OptimizationFlag::ReturnStackBuffer);
+    enable(profile.fast_dispatch, OptimizationFlag::FastDispatch);
+    enable(profile.ir_optimizations, OptimizationFlag::GetSetElimination |
+                                         OptimizationFlag::ConstProp | OptimizationFlag::MiscIROpt);
+    enable(profile.unsafe_inaccurate_nan, OptimizationFlag::Unsafe_InaccurateNaN);
+    enable(profile.unsafe_ignore_global_monitor, OptimizationFlag::Unsafe_IgnoreGlobalMonitor);
+    config.unsafe_optimizations =
+        profile.unsafe_inaccurate_nan || profile.unsafe_ignore_global_monitor;
+
     // Multi-process state
     config.processor_id = GetID();
     config.global_monitor = &exclusive_monitor.monitor;
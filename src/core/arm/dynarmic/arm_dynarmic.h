@@ -4,12 +4,14 @@
 
 #pragma once
 
-#include <map>
+#include <chrono>
 #include <memory>
+#include <vector>
 #include <dynarmic/interface/A32/a32.h>
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
+#include "core/arm/idle_loop_detector.h"
 
 namespace Memory {
 struct PageTable;
@@ -73,9 +75,26 @@ private:
 
     u32 fpexc = 0;
     CP15State cp15_state;
+    Core::IdleLoopDetector idle_loop_detector;
+    /// Host time spent executing guest code, used to estimate the time saved by idle loop skipping
+    std::chrono::nanoseconds run_time{};
+    u64 run_ticks = 0;
     Core::DynarmicExclusiveMonitor& exclusive_monitor;
 
+    /// Destroys JITs of page tables that no longer exist and evicts the least recently used ones
+    void EvictJits();
+
+    struct CachedJit {
+        /// Weak so that the JIT does not keep the page table of an exited process alive.
+        std::weak_ptr<Memory::PageTable> page_table;
+        std::unique_ptr<Dynarmic::A32::Jit> jit;
+    };
+
+    /// Maximum number of JITs kept around for page tables that are not currently in use.
+    static constexpr std::size_t MAX_CACHED_JITS = 8;
+
     Dynarmic::A32::Jit* jit = nullptr;
     std::shared_ptr<Memory::PageTable> current_page_table = nullptr;
-    std::map<std::shared_ptr<Memory::PageTable>, std::unique_ptr<Dynarmic::A32::Jit>> jits;
+    /// JITs ordered from least to most recently used.
+    std::vector<CachedJit> jits;
 };
@@ -8,7 +8,7 @@ namespace Core {
 
 DynarmicExclusiveMonitor::DynarmicExclusiveMonitor(Memory::MemorySystem& memory_,
                                                    std::size_t core_count_)
-    : monitor{core_count_}, memory{memory_} {}
+    : ExclusiveMonitor{core_count_}, monitor{core_count_}, memory{memory_} {}
 
 DynarmicExclusiveMonitor::~DynarmicExclusiveMonitor() = default;
 
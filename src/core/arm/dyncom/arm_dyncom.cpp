@@ -70,9 +70,12 @@ private:
 
 ARM_DynCom::ARM_DynCom(Core::System* system, Memory::MemorySystem& memory,
                        PrivilegeMode initial_mode, u32 id,
-                       std::shared_ptr<Core::Timing::Timer> timer)
+                       std::shared_ptr<Core::Timing::Timer> timer,
+                       Core::ExclusiveMonitor* exclusive_monitor)
     : ARM_Interface(id, timer), system(system) {
     state = std::make_unique<ARMul_State>(system, memory, initial_mode);
+    state->exclusive_monitor = exclusive_monitor;
+    state->core_id = id;
 }
 
 ARM_DynCom::~ARM_DynCom() {}
@@ -89,6 +92,11 @@ void ARM_DynCom::Step() {
 void ARM_DynCom::ClearInstructionCache() {
     state->instruction_cache.clear();
     trans_cache_buf_top = 0;
+    trans_cache_generation++;
+}
+
+void ARM_DynCom::ClearExclusiveState() {
+    state->UnsetExclusiveMemoryAddress();
 }
 
 void ARM_DynCom::InvalidateCacheRange(u32, std::size_t) {
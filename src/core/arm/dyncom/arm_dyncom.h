@@ -11,6 +11,7 @@
 #include "core/arm/skyeye_common/armstate.h"
 
 namespace Core {
+class ExclusiveMonitor;
 class System;
 }
 
@@ -22,7 +23,8 @@ class ARM_DynCom final : public ARM_Interface {
 public:
     explicit ARM_DynCom(Core::System* system, Memory::MemorySystem& memory,
                         PrivilegeMode initial_mode, u32 id,
-                        std::shared_ptr<Core::Timing::Timer> timer);
+                        std::shared_ptr<Core::Timing::Timer> timer,
+                        Core::ExclusiveMonitor* exclusive_monitor = nullptr);
     ~ARM_DynCom() override;
 
     void Run() override;
@@ -30,7 +32,7 @@ public:
 
     void ClearInstructionCache() override;
     void InvalidateCacheRange(u32 start_address, std::size_t length) override;
-    void ClearExclusiveState() override{};
+    void ClearExclusiveState() override;
 
     void SetPC(u32 pc) override;
     u32 GetPC() const override;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <string_view>
 #include "core/arm/dyncom/arm_dyncom_dec.h"
 #include "core/arm/skyeye_common/armsupp.h"
 
@@ -501,3 +502,30 @@ ARMDecodeStatus DecodeARMInstruction(u32 instr, int* idx) {
     }
     return ret;
 }
+
+ARMInstructionGroup GetARMInstructionGroup(int idx) {
+    constexpr int instr_slots = sizeof(arm_instruction) / sizeof(InstructionSetEncodingItem);
+    if (idx < 0 || idx >= instr_slots) {
+        return ARMInstructionGroup::OTHER;
+    }
+
+    const std::string_view name = arm_instruction[idx].name;
+    for (const std::string_view compare : {"cmp", "cmn", "tst", "teq"}) {
+        if (name == compare) {
+            return ARMInstructionGroup::COMPARE;
+        }
+    }
+    for (const std::string_view load_store : {"ldr", "ldrcond", "str", "ldrb", "strb", "ldrh",
+                                              "strh", "ldrsb", "ldrsh", "ldrd", "strd"}) {
+        if (name == load_store) {
+            return ARMInstructionGroup::LOAD_STORE;
+        }
+    }
+    for (const std::string_view vfp : {"vmla", "vmls", "vnmla", "vnmls", "vmul", "vnmul", "vadd",
+                                       "vsub"}) {
+        if (name == vfp) {
+            return ARMInstructionGroup::VFP_ARITHMETIC;
+        }
+    }
+    return ARMInstructionGroup::OTHER;
+}
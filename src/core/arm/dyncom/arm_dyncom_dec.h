@@ -8,4 +8,10 @@
 
 enum class ARMDecodeStatus { SUCCESS, FAILURE };
 
+/// Instruction groups whose consecutive members the interpreter runs without checks in between.
+enum class ARMInstructionGroup { OTHER, COMPARE, LOAD_STORE, VFP_ARITHMETIC };
+
 ARMDecodeStatus DecodeARMInstruction(u32 instr, int* idx);
+
+/// Returns the group of an instruction index returned by DecodeARMInstruction.
+ARMInstructionGroup GetARMInstructionGroup(int idx);
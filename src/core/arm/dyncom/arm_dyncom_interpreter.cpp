@@ -822,6 +822,7 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
 
         // We have translated the Thumb branch instruction in the Thumb decoder
         if (state == ThumbDecodeStatus::BRANCH) {
+            inst_base->paired = 0;
             return inst_size;
         }
         inst = arm_inst;
@@ -836,6 +837,7 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
         CITRA_IGNORE_EXIT(-1);
     }
     inst_base = arm_instruction_trans[idx](inst, idx);
+    inst_base->paired = 0;
 
     return inst_size;
 }
@@ -854,10 +856,20 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
+    ARMInstructionGroup prev_group = ARMInstructionGroup::OTHER;
     while (ret == TransExtData::NON_BRANCH) {
         u32 inst_size = InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
         phys_addr += inst_size;
 
+        // Pair compare and branch, runs of loads and stores and chains of VFP arithmetic
+        const ARMInstructionGroup group = GetARMInstructionGroup(inst_base->idx);
+        if (prev_group == ARMInstructionGroup::COMPARE) {
+            inst_base->paired = inst_base->br == TransExtData::DIRECT_BRANCH;
+        } else if (prev_group != ARMInstructionGroup::OTHER) {
+            inst_base->paired = group == prev_group;
+        }
+        prev_group = group;
+
         if ((phys_addr & 0xfff) == 0) {
             inst_base->br = TransExtData::END_OF_PAGE;
         }
@@ -966,18 +978,40 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     }
 #endif
 
+// Direct branches jump to the block they reached last time without going through DISPATCH. A
+// pending IRQ still has to end the loop, and an attached debugger needs DISPATCH to look up the
+// breakpoints of the new block. Otherwise DISPATCH records the block it finds for next time.
+// Once the translation cache has been cleared under the running block, its links live in memory
+// that the next translation reuses, so they are neither followed nor filled in.
+#define FOLLOW_LINK(link)                                                                          \
+    if (block_generation != trans_cache_generation) {                                              \
+        goto DISPATCH;                                                                             \
+    }                                                                                              \
+    if (!gdb_active && (cpu->NirqSig || (cpu->Cpsr & 0x80)) && (link).pc == cpu->Reg[15] &&        \
+        (link).generation == trans_cache_generation) {                                             \
+        ptr = (link).ptr;                                                                          \
+        inst_base = (arm_inst*)&trans_cache_buf[ptr];                                              \
+        GOTO_NEXT_INST;                                                                            \
+    }                                                                                              \
+    pending_link = &(link);                                                                        \
+    goto DISPATCH
+
 // GCC and Clang have a C++ extension to support a lookup table of labels. Otherwise, fallback to a
 // clunky switch statement.
 #if defined __GNUC__ || (defined __clang__ && !defined _MSC_VER)
 #define GOTO_NEXT_INST                                                                             \
-    GDB_BP_CHECK;                                                                                  \
+    if (!inst_base->paired || gdb_active) {                                                        \
+        GDB_BP_CHECK;                                                                              \
+    }                                                                                              \
     if (num_instrs >= cpu->NumInstrsToExecute)                                                     \
         goto END;                                                                                  \
     num_instrs++;                                                                                  \
     goto* InstLabel[inst_base->idx]
 #else
 #define GOTO_NEXT_INST                                                                             \
-    GDB_BP_CHECK;                                                                                  \
+    if (!inst_base->paired || gdb_active) {                                                        \
+        GDB_BP_CHECK;                                                                              \
+    }                                                                                              \
     if (num_instrs >= cpu->NumInstrsToExecute)                                                     \
         goto END;                                                                                  \
     num_instrs++;                                                                                  \
@@ -1626,6 +1660,14 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     unsigned int num_instrs = 0;
 
     std::size_t ptr;
+    block_link* pending_link = nullptr;
+    u32 block_generation = trans_cache_generation;
+
+#ifdef ANDROID
+    constexpr bool gdb_active = false;
+#else
+    const bool gdb_active = GDBStub::IsServerEnabled();
+#endif
 
     LOAD_NZCVT;
 DISPATCH : {
@@ -1652,6 +1694,12 @@ DISPATCH : {
             goto END;
     }
 
+    if (pending_link) {
+        *pending_link = {cpu->Reg[15], ptr, trans_cache_generation};
+        pending_link = nullptr;
+    }
+    block_generation = trans_cache_generation;
+
 #ifndef ANDROID
     // Find breakpoint if one exists within the block
     if (GDBStub::IsConnected()) {
@@ -1763,18 +1811,18 @@ AND_INST : {
     GOTO_NEXT_INST;
 }
 BBL_INST : {
+    bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
     if ((inst_base->cond == ConditionCode::AL) || CondPassed(cpu, inst_base->cond)) {
-        bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
         if (inst_cream->L) {
             LINK_RTN_ADDR;
         }
         SET_PC;
         INC_PC(sizeof(bbl_inst));
-        goto DISPATCH;
+        FOLLOW_LINK(inst_cream->taken);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(bbl_inst));
-    goto DISPATCH;
+    FOLLOW_LINK(inst_cream->not_taken);
 }
 BIC_INST : {
     bic_inst* inst_cream = (bic_inst*)inst_base->component;
@@ -2237,9 +2285,7 @@ LDREX_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
-        RD = cpu->ReadMemory32(read_addr);
+        RD = cpu->ReadExclusiveMemory32(read_addr);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -2251,9 +2297,7 @@ LDREXB_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
-        RD = cpu->ReadMemory8(read_addr);
+        RD = cpu->ReadExclusiveMemory8(read_addr);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -2265,9 +2309,7 @@ LDREXH_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
-        RD = cpu->ReadMemory16(read_addr);
+        RD = cpu->ReadExclusiveMemory16(read_addr);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -2279,10 +2321,14 @@ LDREXD_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
-        RD = cpu->ReadMemory32(read_addr);
-        RD2 = cpu->ReadMemory32(read_addr + 4);
+        const u64 value = cpu->ReadExclusiveMemory64(read_addr);
+        if (cpu->InBigEndianMode()) {
+            RD = static_cast<u32>(value >> 32);
+            RD2 = static_cast<u32>(value);
+        } else {
+            RD = static_cast<u32>(value);
+            RD2 = static_cast<u32>(value >> 32);
+        }
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3716,14 +3762,8 @@ STREX_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
-            cpu->WriteMemory32(write_addr, RM);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Failed to write due to mutex access if the result is 1
+        RD = cpu->WriteExclusiveMemory32(write_addr, RM) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3735,14 +3775,8 @@ STREXB_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
-            cpu->WriteMemory8(write_addr, cpu->Reg[inst_cream->Rm]);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Failed to write due to mutex access if the result is 1
+        RD = cpu->WriteExclusiveMemory8(write_addr, cpu->Reg[inst_cream->Rm]) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3754,24 +3788,17 @@ STREXD_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
+        const u32 rt = cpu->Reg[inst_cream->Rm + 0];
+        const u32 rt2 = cpu->Reg[inst_cream->Rm + 1];
+        u64 value;
 
-            const u32 rt = cpu->Reg[inst_cream->Rm + 0];
-            const u32 rt2 = cpu->Reg[inst_cream->Rm + 1];
-            u64 value;
-
-            if (cpu->InBigEndianMode())
-                value = (((u64)rt << 32) | rt2);
-            else
-                value = (((u64)rt2 << 32) | rt);
+        if (cpu->InBigEndianMode())
+            value = (((u64)rt << 32) | rt2);
+        else
+            value = (((u64)rt2 << 32) | rt);
 
-            cpu->WriteMemory64(write_addr, value);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Failed to write due to mutex access if the result is 1
+        RD = cpu->WriteExclusiveMemory64(write_addr, value) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3783,14 +3810,8 @@ STREXH_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
-            cpu->WriteMemory16(write_addr, RM);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Failed to write due to mutex access if the result is 1
+        RD = cpu->WriteExclusiveMemory16(write_addr, RM) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -4325,18 +4346,18 @@ B_2_THUMB : {
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
     cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
     INC_PC(sizeof(b_2_thumb));
-    goto DISPATCH;
+    FOLLOW_LINK(inst_cream->taken);
 }
 B_COND_THUMB : {
     b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
 
-    if (CondPassed(cpu, inst_cream->cond))
-        cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-    else
-        cpu->Reg[15] += 2;
-
     INC_PC(sizeof(b_cond_thumb));
-    goto DISPATCH;
+    if (CondPassed(cpu, inst_cream->cond)) {
+        cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
+        FOLLOW_LINK(inst_cream->taken);
+    }
+    cpu->Reg[15] += 2;
+    FOLLOW_LINK(inst_cream->not_taken);
 }
 BL_1_THUMB : {
     bl_1_thumb* inst_cream = (bl_1_thumb*)inst_base->component;
@@ -4352,7 +4373,7 @@ BL_2_THUMB : {
     cpu->Reg[15] = (cpu->Reg[14] + inst_cream->imm);
     cpu->Reg[14] = tmp;
     INC_PC(sizeof(bl_2_thumb));
-    goto DISPATCH;
+    FOLLOW_LINK(inst_cream->taken);
 }
 BLX_1_THUMB : {
     // BLX 1 for armv5t and above
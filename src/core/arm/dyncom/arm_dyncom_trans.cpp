@@ -8,6 +8,7 @@
 
 char trans_cache_buf[TRANS_CACHE_SIZE];
 size_t trans_cache_buf_top = 0;
+u32 trans_cache_generation = 0;
 
 static void* AllocBuffer(std::size_t size) {
     std::size_t start = trans_cache_buf_top;
@@ -99,6 +100,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(unsigned int inst, int index) {
 
     inst_cream->L = BIT(inst, 24);
     inst_cream->signed_immed_24 = BIT(inst, 23) ? NEGBRANCH : POSBRANCH;
+    inst_cream->taken.pc = INVALID_LINK_PC;
+    inst_cream->not_taken.pc = INVALID_LINK_PC;
 
     return inst_base;
 }
@@ -1646,6 +1649,7 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_2_thumb)(unsigned int tinst, int ind
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
 
     inst_cream->imm = ((tinst & 0x3FF) << 1) | ((tinst & (1 << 10)) ? 0xFFFFF800 : 0);
+    inst_cream->taken.pc = INVALID_LINK_PC;
 
     inst_base->idx = index;
     inst_base->br = TransExtData::DIRECT_BRANCH;
@@ -1659,6 +1663,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_cond_thumb)(unsigned int tinst, int
 
     inst_cream->imm = (((tinst & 0x7F) << 1) | ((tinst & (1 << 7)) ? 0xFFFFFF00 : 0));
     inst_cream->cond = ((tinst >> 8) & 0xf);
+    inst_cream->taken.pc = INVALID_LINK_PC;
+    inst_cream->not_taken.pc = INVALID_LINK_PC;
     inst_base->idx = index;
     inst_base->br = TransExtData::DIRECT_BRANCH;
 
@@ -1680,6 +1686,7 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_2_thumb)(unsigned int tinst, int in
     bl_2_thumb* inst_cream = (bl_2_thumb*)inst_base->component;
 
     inst_cream->imm = (tinst & 0x07FF) << 1;
+    inst_cream->taken.pc = INVALID_LINK_PC;
 
     inst_base->idx = index;
     inst_base->br = TransExtData::DIRECT_BRANCH;
@@ -26,9 +26,24 @@ struct arm_inst {
     unsigned int idx;
     unsigned int cond;
     TransExtData br;
+    // Set when the instruction pairs with the one before it in its block, so the interpreter can
+    // continue into it without the per-instruction debugger check and CPSR T bit sync. Both
+    // instructions still run through their own handlers.
+    unsigned int paired;
     char component[0];
 };
 
+// Target of a direct branch as last seen by DISPATCH. Following it jumps straight into the
+// translated target block, skipping the instruction cache lookup. A link recorded before the
+// translation cache was last cleared points into reused memory and is ignored.
+struct block_link {
+    u32 pc;
+    std::size_t ptr;
+    u32 generation;
+};
+
+constexpr u32 INVALID_LINK_PC = 0xFFFFFFFF;
+
 struct generic_arm_inst {
     u32 Ra;
     u32 Rm;
@@ -88,6 +103,8 @@ struct bbl_inst {
     int signed_immed_24;
     unsigned int next_addr;
     unsigned int jmp_addr;
+    block_link taken;
+    block_link not_taken;
 };
 
 struct bx_inst {
@@ -451,10 +468,13 @@ struct setend_inst {
 
 struct b_2_thumb {
     unsigned int imm;
+    block_link taken;
 };
 struct b_cond_thumb {
     unsigned int imm;
     unsigned int cond;
+    block_link taken;
+    block_link not_taken;
 };
 
 struct bl_1_thumb {
@@ -462,6 +482,7 @@ struct bl_1_thumb {
 };
 struct bl_2_thumb {
     unsigned int imm;
+    block_link taken;
 };
 struct blx_1_thumb {
     unsigned int imm;
@@ -496,3 +517,5 @@ extern const std::size_t arm_instruction_trans_len;
 #define TRANS_CACHE_SIZE (64 * 1024 * 2000)
 extern char trans_cache_buf[TRANS_CACHE_SIZE];
 extern std::size_t trans_cache_buf_top;
+// Incremented every time the translation cache is cleared
+extern u32 trans_cache_generation;
@@ -5,13 +5,35 @@
 #if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
 #include "core/arm/dynarmic/arm_exclusive_monitor.h"
 #endif
+#include "common/logging/log.h"
 #include "common/settings.h"
 #include "core/arm/exclusive_monitor.h"
+#include "core/arm/sharded_exclusive_monitor.h"
 #include "core/memory.h"
 
 namespace Core {
 
-ExclusiveMonitor::~ExclusiveMonitor() = default;
+ExclusiveMonitor::ExclusiveMonitor(std::size_t num_cores) : counters(num_cores) {}
+
+ExclusiveMonitor::~ExclusiveMonitor() {
+    const ExclusiveMonitorStatistics stats = GetStatistics();
+    LOG_DEBUG(Core_ARM11,
+              "{} exclusive reads, {} writes, {} failed ({} contended), {} waits for a lock",
+              stats.reads, stats.writes, stats.failed_writes, stats.contended_writes,
+              stats.lock_contention);
+}
+
+ExclusiveMonitorStatistics ExclusiveMonitor::GetStatistics() const {
+    ExclusiveMonitorStatistics stats;
+    for (const Counters& core : counters) {
+        stats.reads += core.reads.load(std::memory_order_relaxed);
+        stats.writes += core.writes.load(std::memory_order_relaxed);
+        stats.failed_writes += core.failed_writes.load(std::memory_order_relaxed);
+        stats.contended_writes += core.contended_writes.load(std::memory_order_relaxed);
+        stats.lock_contention += core.lock_contention.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
 
 std::unique_ptr<Core::ExclusiveMonitor> MakeExclusiveMonitor(Memory::MemorySystem& memory,
                                                              std::size_t num_cores) {
@@ -20,8 +42,7 @@ std::unique_ptr<Core::ExclusiveMonitor> MakeExclusiveMonitor(Memory::MemorySyste
         return std::make_unique<Core::DynarmicExclusiveMonitor>(memory, num_cores);
     }
 #endif
-    // TODO(merry): Passthrough exclusive monitor
-    return nullptr;
+    return std::make_unique<Core::ShardedExclusiveMonitor>(memory, num_cores);
 }
 
 } // namespace Core
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "common/common_types.h"
 
@@ -13,8 +15,22 @@ class MemorySystem;
 
 namespace Core {
 
+/// Counters of the exclusive accesses seen by an exclusive monitor, summed over all cores.
+struct ExclusiveMonitorStatistics {
+    u64 reads = 0;
+    u64 writes = 0;
+    /// Exclusive writes that failed and have to be retried by the guest
+    u64 failed_writes = 0;
+    /// Failed writes that lost their reservation to an exclusive write of another core. The other
+    /// failures are false retries, caused by context switches or plain stores to the address.
+    u64 contended_writes = 0;
+    /// Times a core had to wait for another one to finish an exclusive access
+    u64 lock_contention = 0;
+};
+
 class ExclusiveMonitor {
 public:
+    explicit ExclusiveMonitor(std::size_t num_cores);
     virtual ~ExclusiveMonitor();
 
     virtual u8 ExclusiveRead8(std::size_t core_index, VAddr addr) = 0;
@@ -27,6 +43,44 @@ public:
     virtual bool ExclusiveWrite16(std::size_t core_index, VAddr vaddr, u16 value) = 0;
     virtual bool ExclusiveWrite32(std::size_t core_index, VAddr vaddr, u32 value) = 0;
     virtual bool ExclusiveWrite64(std::size_t core_index, VAddr vaddr, u64 value) = 0;
+
+    ExclusiveMonitorStatistics GetStatistics() const;
+
+    void RecordRead(std::size_t core_index) {
+        Increment(counters[core_index].reads);
+    }
+
+    void RecordWrite(std::size_t core_index, bool success, bool contended = false) {
+        Counters& core = counters[core_index];
+        Increment(core.writes);
+        if (!success) {
+            Increment(core.failed_writes);
+        }
+        if (contended) {
+            Increment(core.contended_writes);
+        }
+    }
+
+    void RecordLockContention(std::size_t core_index) {
+        Increment(counters[core_index].lock_contention);
+    }
+
+private:
+    /// Only written by the thread of their core, so they don't need atomic read-modify-writes and
+    /// don't share cache lines with the counters of other cores.
+    struct alignas(64) Counters {
+        std::atomic<u64> reads{0};
+        std::atomic<u64> writes{0};
+        std::atomic<u64> failed_writes{0};
+        std::atomic<u64> contended_writes{0};
+        std::atomic<u64> lock_contention{0};
+    };
+
+    static void Increment(std::atomic<u64>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::vector<Counters> counters;
 };
 
 std::unique_ptr<Core::ExclusiveMonitor> MakeExclusiveMonitor(Memory::MemorySystem& memory,
@@ -0,0 +1,332 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <bitset>
+#include <cstring>
+#include <optional>
+#include "core/arm/arm_interface.h"
+#include "core/arm/idle_loop_detector.h"
+#include "core/memory.h"
+
+namespace Core {
+
+namespace {
+
+constexpr u32 COND_AL = 0xE;
+constexpr u32 CPSR_THUMB_BIT = 1 << 5;
+/// Pseudo register index used to track the NZCV flags
+constexpr std::size_t FLAGS = 16;
+
+bool ReadGuest(const Memory::PageTable& page_table, VAddr vaddr, u32 size, u32& value) {
+    // Accesses that cross a page boundary are rare enough in polling loops to not bother.
+    if ((vaddr & Memory::CITRA_PAGE_MASK) + size > Memory::CITRA_PAGE_SIZE) {
+        return false;
+    }
+    const u8* page_pointer = page_table.GetPointerArray()[vaddr >> Memory::CITRA_PAGE_BITS];
+    if (!page_pointer) {
+        // MMIO and rasterizer cached memory can change without a scheduled event.
+        return false;
+    }
+    value = 0;
+    std::memcpy(&value, page_pointer + (vaddr & Memory::CITRA_PAGE_MASK), size);
+    return true;
+}
+
+/// Register dataflow of one instruction in the loop body
+struct InstructionInfo {
+    bool conditional = false;
+    std::bitset<17> reads;
+    std::bitset<17> writes;
+    bool is_load = false;
+    u32 load_size = 0;
+    u32 base_reg = 0;
+    std::optional<u32> offset_reg;
+    s32 offset = 0;
+};
+
+/// Decodes instructions that only read memory and registers, returns nullopt for anything else.
+std::optional<InstructionInfo> DecodeSideEffectFree(u32 inst) {
+    InstructionInfo info;
+    const u32 cond = inst >> 28;
+    if (cond == 0xF) {
+        return std::nullopt;
+    }
+    if (cond != COND_AL) {
+        info.conditional = true;
+        info.reads.set(FLAGS);
+    }
+
+    const u32 rn = (inst >> 16) & 0xF;
+    const u32 rd = (inst >> 12) & 0xF;
+    const u32 rm = inst & 0xF;
+    const bool up = (inst >> 23) & 1;
+
+    // LDREX
+    if ((inst & 0x0FF00FFF) == 0x01900F9F) {
+        if (rd == 15) {
+            return std::nullopt;
+        }
+        info.reads.set(rn);
+        info.writes.set(rd);
+        info.is_load = true;
+        info.load_size = 4;
+        info.base_reg = rn;
+        return info;
+    }
+
+    // LDRH, LDRSB, LDRSH with offset addressing and no writeback
+    if ((inst & 0x0E000090) == 0x00000090 && ((inst >> 5) & 3) != 0) {
+        const bool pre_index = (inst >> 24) & 1;
+        const bool writeback = (inst >> 21) & 1;
+        const bool load = (inst >> 20) & 1;
+        if (!load || !pre_index || writeback || rd == 15) {
+            return std::nullopt;
+        }
+        info.reads.set(rn);
+        info.writes.set(rd);
+        info.is_load = true;
+        info.load_size = ((inst >> 5) & 3) == 2 ? 1 : 2;
+        info.base_reg = rn;
+        if ((inst >> 22) & 1) {
+            const s32 imm = static_cast<s32>(((inst >> 4) & 0xF0) | (inst & 0xF));
+            info.offset = up ? imm : -imm;
+        } else {
+            if (!up) {
+                return std::nullopt;
+            }
+            info.reads.set(rm);
+            info.offset_reg = rm;
+        }
+        return info;
+    }
+
+    // Data processing
+    if ((inst & 0x0C000000) == 0) {
+        const bool immediate = (inst >> 25) & 1;
+        if (!immediate && ((inst >> 7) & 1) && ((inst >> 4) & 1)) {
+            // Multiplies and the remaining extra load/store space
+            return std::nullopt;
+        }
+        const u32 opcode = (inst >> 21) & 0xF;
+        const bool set_flags = (inst >> 20) & 1;
+        const bool is_compare = opcode >= 0x8 && opcode <= 0xB;
+        if (is_compare && !set_flags) {
+            // Miscellaneous instructions (MRS, MSR, BX, CLZ, MOVW, ...)
+            return std::nullopt;
+        }
+        if (!is_compare && rd == 15) {
+            return std::nullopt;
+        }
+        if (opcode != 0xD && opcode != 0xF) {
+            info.reads.set(rn);
+        }
+        if (!immediate) {
+            info.reads.set(rm);
+            if ((inst >> 4) & 1) {
+                info.reads.set((inst >> 8) & 0xF);
+            } else if (((inst >> 5) & 3) == 3 && ((inst >> 7) & 0x1F) == 0) {
+                // RRX shifts in the carry flag
+                info.reads.set(FLAGS);
+            }
+        }
+        if (opcode >= 0x5 && opcode <= 0x7) {
+            // ADC, SBC and RSC consume the carry flag
+            info.reads.set(FLAGS);
+        }
+        if (!is_compare) {
+            info.writes.set(rd);
+        }
+        if (set_flags) {
+            info.writes.set(FLAGS);
+        }
+        return info;
+    }
+
+    // LDR, LDRB with offset addressing and no writeback
+    if ((inst & 0x0C000000) == 0x04000000) {
+        const bool register_offset = (inst >> 25) & 1;
+        const bool pre_index = (inst >> 24) & 1;
+        const bool writeback = (inst >> 21) & 1;
+        const bool load = (inst >> 20) & 1;
+        if (!load || !pre_index || writeback || rd == 15) {
+            return std::nullopt;
+        }
+        if (register_offset && ((inst >> 4) & 1)) {
+            // Media instruction space
+            return std::nullopt;
+        }
+        info.reads.set(rn);
+        info.writes.set(rd);
+        info.is_load = true;
+        info.load_size = ((inst >> 22) & 1) ? 1 : 4;
+        info.base_reg = rn;
+        if (register_offset) {
+            if (!up || ((inst >> 4) & 0xFF) != 0) {
+                // Shifted or subtracted register offsets are not worth handling here
+                return std::nullopt;
+            }
+            info.reads.set(rm);
+            info.offset_reg = rm;
+        } else {
+            const s32 imm = static_cast<s32>(inst & 0xFFF);
+            info.offset = up ? imm : -imm;
+        }
+        return info;
+    }
+
+    return std::nullopt;
+}
+
+} // Anonymous namespace
+
+void IdleLoopDetector::OnSliceExhausted(const ARM_Interface& core,
+                                        const Memory::PageTable& page_table) {
+    // The state the last slice ended in has been run for a whole slice without leaving the loop.
+    if (loop_candidate && IsSameState(core, page_table)) {
+        loop_valid = true;
+        stats.detected_loops++;
+        return;
+    }
+
+    loop_valid = false;
+    loop_candidate = AnalyzeLoop(core, page_table) && ReadPolledValues(page_table, false);
+    if (!loop_candidate) {
+        return;
+    }
+    for (std::size_t i = 0; i < registers.size(); ++i) {
+        registers[i] = core.GetReg(static_cast<int>(i));
+    }
+    cpsr = core.GetCPSR();
+}
+
+bool IdleLoopDetector::IsStillIdle(const ARM_Interface& core,
+                                   const Memory::PageTable& page_table) {
+    if (!loop_valid) {
+        return false;
+    }
+    loop_valid = IsSameState(core, page_table);
+    loop_candidate = loop_valid;
+    return loop_valid;
+}
+
+bool IdleLoopDetector::IsSameState(const ARM_Interface& core,
+                                   const Memory::PageTable& page_table) {
+    // A different thread might have been scheduled in, possibly spinning in the same code.
+    bool same_state = core.GetCPSR() == cpsr;
+    for (std::size_t i = 0; i < registers.size() && same_state; ++i) {
+        same_state = core.GetReg(static_cast<int>(i)) == registers[i];
+    }
+    // The loop body could also have been patched since it was analyzed, e.g. by a CRO reload.
+    for (std::size_t i = 0; i < num_code_words && same_state; ++i) {
+        u32 inst;
+        same_state = ReadGuest(page_table, loop_start + static_cast<VAddr>(i * 4), 4, inst) &&
+                     inst == code[i];
+    }
+    return same_state && ReadPolledValues(page_table, true);
+}
+
+bool IdleLoopDetector::AnalyzeLoop(const ARM_Interface& core,
+                                   const Memory::PageTable& page_table) {
+    if (core.GetCPSR() & CPSR_THUMB_BIT) {
+        return false;
+    }
+
+    // Find the conditional backward branch that closes the loop the PC is in.
+    const VAddr pc = core.GetPC() & ~3U;
+    std::optional<VAddr> branch_address;
+    std::optional<VAddr> branch_target;
+    for (std::size_t i = 0; i < MAX_LOOP_INSTRUCTIONS; ++i) {
+        const VAddr address = pc + static_cast<VAddr>(i * 4);
+        u32 inst;
+        if (!ReadGuest(page_table, address, 4, inst)) {
+            return false;
+        }
+        if ((inst & 0x0F000000) != 0x0A000000) {
+            continue;
+        }
+        const s32 offset = static_cast<s32>(inst << 8) >> 6;
+        const VAddr target = address + 8 + offset;
+        const bool conditional = (inst >> 28) < COND_AL;
+        if (!conditional || target > pc || address - target >= MAX_LOOP_INSTRUCTIONS * 4) {
+            return false;
+        }
+        branch_address = address;
+        branch_target = target;
+        break;
+    }
+    if (!branch_address) {
+        return false;
+    }
+
+    // Decode the body, then check that every value read in an iteration is either produced earlier
+    // in the same iteration or never written by the loop at all.
+    std::array<InstructionInfo, MAX_LOOP_INSTRUCTIONS> body;
+    const std::size_t body_size = (*branch_address - *branch_target) / 4;
+    std::bitset<17> written;
+    num_code_words = body_size + 1;
+    for (std::size_t i = 0; i < num_code_words; ++i) {
+        u32& inst = code[i];
+        if (!ReadGuest(page_table, *branch_target + static_cast<VAddr>(i * 4), 4, inst)) {
+            return false;
+        }
+        if (i == body_size) {
+            break;
+        }
+        const auto info = DecodeSideEffectFree(inst);
+        if (!info) {
+            return false;
+        }
+        body[i] = *info;
+        written |= info->writes;
+    }
+
+    std::bitset<17> defined;
+    num_loads = 0;
+    for (std::size_t i = 0; i < body_size; ++i) {
+        const InstructionInfo& info = body[i];
+        if ((info.reads & written & ~defined).any()) {
+            return false;
+        }
+        if (info.is_load) {
+            // The polled address has to stay the same across iterations.
+            if (written[info.base_reg] || (info.offset_reg && written[*info.offset_reg])) {
+                return false;
+            }
+            // Reading the PC yields the address of the instruction plus 8.
+            const auto read_reg = [&](u32 reg) {
+                return reg == 15 ? *branch_target + static_cast<VAddr>(i * 4) + 8
+                                 : core.GetReg(static_cast<int>(reg));
+            };
+            VAddr address = read_reg(info.base_reg) + info.offset;
+            if (info.offset_reg) {
+                address += read_reg(*info.offset_reg);
+            }
+            loads[num_loads++] = {address, info.load_size, 0};
+        }
+        // A conditional instruction may leave the previous iteration's value in place.
+        if (!info.conditional) {
+            defined |= info.writes;
+        }
+    }
+
+    loop_start = *branch_target;
+    return num_loads > 0;
+}
+
+bool IdleLoopDetector::ReadPolledValues(const Memory::PageTable& page_table, bool compare) {
+    for (std::size_t i = 0; i < num_loads; ++i) {
+        PolledLoad& load = loads[i];
+        u32 value;
+        if (!ReadGuest(page_table, load.address, load.size, value)) {
+            return false;
+        }
+        if (compare && value != load.value) {
+            return false;
+        }
+        load.value = value;
+    }
+    return true;
+}
+
+} // namespace Core
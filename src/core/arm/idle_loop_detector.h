@@ -0,0 +1,97 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include "common/common_types.h"
+
+class ARM_Interface;
+
+namespace Memory {
+struct PageTable;
+}
+
+namespace Core {
+
+/**
+ * Detects guest threads that spin in a tight polling loop, e.g. while waiting for a GSP or DSP
+ * interrupt to update shared memory.
+ *
+ * A loop qualifies when it is a short run of ARM instructions closed by a conditional backward
+ * branch, it does not store to memory or call into the kernel, and no register or flag value is
+ * carried from one iteration to the next. Every iteration then behaves the same until the polled
+ * memory changes, which only happens when a scheduled event runs.
+ *
+ * A loop is only confirmed once two consecutive slices ended in it with the same registers, flags
+ * and polled values. The slice in between then ran the loop with that memory without leaving it,
+ * so the core can skip straight to the next event for as long as the polled memory stays the same.
+ */
+class IdleLoopDetector {
+public:
+    struct Stats {
+        u64 detected_loops = 0; ///< Number of times an idle loop was confirmed
+        u64 skipped_slices = 0; ///< Number of slices that were idled instead of executed
+        u64 skipped_ticks = 0;  ///< Guest ticks that were idled instead of executed
+    };
+
+    /**
+     * Inspects the code at the current PC of a core that ran through its whole slice. Confirms the
+     * candidate loop if the core ended the previous slice in the same state, otherwise remembers
+     * the loop and the memory it polls as the new candidate if it is an idle loop.
+     */
+    void OnSliceExhausted(const ARM_Interface& core, const Memory::PageTable& page_table);
+
+    /**
+     * Returns true if the core is still in the state in which the last idle loop was confirmed and
+     * none of the memory polled by that loop has changed since.
+     */
+    [[nodiscard]] bool IsStillIdle(const ARM_Interface& core, const Memory::PageTable& page_table);
+
+    /// Accounts for a slice of the given length that was skipped.
+    void OnSliceSkipped(s64 ticks) {
+        stats.skipped_slices++;
+        stats.skipped_ticks += static_cast<u64>(ticks);
+    }
+
+    /// Forgets the current loop, e.g. after the code or the page table changed.
+    void Reset() {
+        loop_candidate = false;
+        loop_valid = false;
+    }
+
+    [[nodiscard]] const Stats& GetStats() const {
+        return stats;
+    }
+
+private:
+    static constexpr std::size_t MAX_LOOP_INSTRUCTIONS = 8;
+
+    struct PolledLoad {
+        VAddr address;
+        u32 size;
+        u32 value;
+    };
+
+    bool AnalyzeLoop(const ARM_Interface& core, const Memory::PageTable& page_table);
+    bool ReadPolledValues(const Memory::PageTable& page_table, bool compare);
+    bool IsSameState(const ARM_Interface& core, const Memory::PageTable& page_table);
+
+    /// Set when a slice ended in the loop, which has not been seen to run without exiting yet
+    bool loop_candidate = false;
+    /// Set once the loop has run through a whole slice without any state change
+    bool loop_valid = false;
+    VAddr loop_start = 0;
+    /// Loop body including the closing branch
+    std::array<u32, MAX_LOOP_INSTRUCTIONS> code{};
+    std::size_t num_code_words = 0;
+    std::array<PolledLoad, MAX_LOOP_INSTRUCTIONS> loads{};
+    std::size_t num_loads = 0;
+    /// Core state when the loop became a candidate
+    std::array<u32, 16> registers{};
+    u32 cpsr = 0;
+    Stats stats;
+};
+
+} // namespace Core
@@ -0,0 +1,122 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <charconv>
+#include <sstream>
+#include <fmt/format.h>
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/arm/jit_profile.h"
+
+namespace Core {
+
+namespace {
+
+struct Option {
+    const char* name;
+    bool JitProfile::*value;
+};
+
+constexpr std::array<Option, 7> Options{{
+    {"block_linking", &JitProfile::block_linking},
+    {"return_stack_buffer", &JitProfile::return_stack_buffer},
+    {"fast_dispatch", &JitProfile::fast_dispatch},
+    {"ir_optimizations", &JitProfile::ir_optimizations},
+    {"fastmem", &JitProfile::fastmem},
+    {"unsafe_inaccurate_nan", &JitProfile::unsafe_inaccurate_nan},
+    {"unsafe_ignore_global_monitor", &JitProfile::unsafe_ignore_global_monitor},
+}};
+
+bool ParseOption(JitProfile& profile, const std::string& entry) {
+    if (entry == "accurate") {
+        profile = JitProfile::Accurate();
+        return true;
+    }
+    const std::size_t separator = entry.find('=');
+    if (separator == std::string::npos || entry.size() != separator + 2) {
+        return false;
+    }
+    const char value = entry.back();
+    if (value != '0' && value != '1') {
+        return false;
+    }
+    const std::string name = entry.substr(0, separator);
+    for (const Option& option : Options) {
+        if (name == option.name) {
+            profile.*option.value = value == '1';
+            return true;
+        }
+    }
+    return false;
+}
+
+} // Anonymous namespace
+
+JitProfile JitProfile::Accurate() {
+    JitProfile profile;
+    profile.unsafe_inaccurate_nan = false;
+    profile.unsafe_ignore_global_monitor = false;
+    return profile;
+}
+
+std::string JitProfile::ToString() const {
+    std::string out;
+    for (const Option& option : Options) {
+        out += fmt::format("{}{}={}", out.empty() ? "" : " ", option.name,
+                           this->*option.value ? 1 : 0);
+    }
+    return out;
+}
+
+bool ParseJitProfileOptions(JitProfile& profile, const std::string& options) {
+    std::istringstream stream{options};
+    std::string entry;
+    bool valid = true;
+    while (stream >> entry) {
+        valid &= ParseOption(profile, entry);
+    }
+    return valid;
+}
+
+JitProfile ParseJitProfiles(const std::string& overrides, u64 title_id) {
+    JitProfile profile;
+    std::istringstream stream{overrides};
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream line_stream{line};
+        std::string id;
+        if (!(line_stream >> id) || id[0] == '#') {
+            continue;
+        }
+        u64 line_title_id{};
+        const auto [end, error] =
+            std::from_chars(id.data(), id.data() + id.size(), line_title_id, 16);
+        if (error != std::errc{} || end != id.data() + id.size()) {
+            LOG_WARNING(Core_ARM11, "Invalid title id in JIT profile line: {}", line);
+            continue;
+        }
+        if (line_title_id != title_id) {
+            continue;
+        }
+        std::string options;
+        std::getline(line_stream, options);
+        if (!ParseJitProfileOptions(profile, options)) {
+            LOG_WARNING(Core_ARM11, "Invalid option in JIT profile line: {}", line);
+        }
+    }
+    return profile;
+}
+
+JitProfile LoadJitProfile(u64 title_id) {
+    const std::string path = FileUtil::GetUserPath(FileUtil::UserPath::ConfigDir) + JIT_PROFILES;
+    std::string overrides;
+    if (FileUtil::Exists(path)) {
+        FileUtil::ReadFileToString(true, path, overrides);
+    }
+    return ParseJitProfiles(overrides, title_id);
+}
+
+} // namespace Core
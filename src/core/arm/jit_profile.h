@@ -0,0 +1,55 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include "common/common_types.h"
+
+namespace Core {
+
+/**
+ * Optimizations the CPU JIT is built with. The unsafe ones trade accuracy for speed, they are off
+ * by default and only turned on for the titles whose profile enables them.
+ *
+ * The unsafe FMA, reciprocal estimate and FPSCR options of Dynarmic are left out, the ARM11 has
+ * neither fused multiply-add nor NEON so they would not change anything.
+ */
+struct JitProfile {
+    bool block_linking = true;
+    bool return_stack_buffer = true;
+    bool fast_dispatch = true;
+    /// Constant propagation, get/set elimination and the other IR passes
+    bool ir_optimizations = true;
+    /// Whether memory accesses may go through the fastmem arena when it is enabled
+    bool fastmem = true;
+    /// Generated NaNs do not get the default NaN the hardware produces
+    bool unsafe_inaccurate_nan = false;
+    /// Exclusive accesses of one core do not clear the exclusive state of the others
+    bool unsafe_ignore_global_monitor = false;
+
+    /// The profile without unsafe optimizations, the fallback for titles a profile breaks
+    static JitProfile Accurate();
+
+    std::string ToString() const;
+
+    bool operator==(const JitProfile&) const = default;
+};
+
+/**
+ * Applies space separated `option=0` or `option=1` entries to a profile. `accurate` resets it to
+ * JitProfile::Accurate(). Returns false if an entry is not understood, the others still apply.
+ */
+bool ParseJitProfileOptions(JitProfile& profile, const std::string& options);
+
+/**
+ * Returns the profile of a title given the contents of an overrides file, which has one
+ * `<title id in hex> <options>` line per title. Empty lines and lines starting with # are skipped.
+ */
+JitProfile ParseJitProfiles(const std::string& overrides, u64 title_id);
+
+/// Returns the profile of a title, with the overrides of jit_profiles.txt in the config directory
+JitProfile LoadJitProfile(u64 title_id);
+
+} // namespace Core
@@ -0,0 +1,113 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/arm/sharded_exclusive_monitor.h"
+#include "core/memory.h"
+
+namespace Core {
+
+ShardedExclusiveMonitor::ShardedExclusiveMonitor(Memory::MemorySystem& memory_,
+                                                 std::size_t num_cores)
+    : ExclusiveMonitor{num_cores}, memory{memory_}, reservations(num_cores) {}
+
+ShardedExclusiveMonitor::~ShardedExclusiveMonitor() = default;
+
+std::unique_lock<std::mutex> ShardedExclusiveMonitor::LockShard(std::size_t core_index,
+                                                                VAddr addr) {
+    Shard& shard = shards[(addr >> RESERVATION_GRANULE_BITS) % NUM_SHARDS];
+    std::unique_lock lock{shard.mutex, std::try_to_lock};
+    if (!lock.owns_lock()) {
+        RecordLockContention(core_index);
+        lock.lock();
+    }
+    return lock;
+}
+
+template <typename T, typename ReadFunc>
+T ShardedExclusiveMonitor::ExclusiveRead(std::size_t core_index, VAddr addr, ReadFunc&& read) {
+    RecordRead(core_index);
+    // Reading under the shard lock keeps a concurrent exclusive write from slipping between the
+    // read and the reservation.
+    const auto lock = LockShard(core_index, addr);
+    const T value = read();
+    Reservation& reservation = reservations[core_index];
+    reservation.value = value;
+    reservation.tag.store(addr & RESERVATION_GRANULE_MASK, std::memory_order_relaxed);
+    return value;
+}
+
+template <typename T, typename WriteFunc>
+bool ShardedExclusiveMonitor::ExclusiveWrite(std::size_t core_index, VAddr addr,
+                                             WriteFunc&& write) {
+    const u64 granule = addr & RESERVATION_GRANULE_MASK;
+    const auto lock = LockShard(core_index, addr);
+
+    Reservation& reservation = reservations[core_index];
+    const u64 tag = reservation.tag.exchange(NO_RESERVATION, std::memory_order_relaxed);
+    if (tag != granule) {
+        RecordWrite(core_index, false, tag == LOST_RESERVATION);
+        return false;
+    }
+    if (!write(static_cast<T>(reservation.value))) {
+        RecordWrite(core_index, false);
+        return false;
+    }
+
+    // Reservations of other cores on this granule can only be taken under the same shard lock.
+    for (std::size_t core = 0; core < reservations.size(); ++core) {
+        u64 expected = granule;
+        if (core != core_index) {
+            reservations[core].tag.compare_exchange_strong(expected, LOST_RESERVATION,
+                                                           std::memory_order_relaxed);
+        }
+    }
+    RecordWrite(core_index, true);
+    return true;
+}
+
+u8 ShardedExclusiveMonitor::ExclusiveRead8(std::size_t core_index, VAddr addr) {
+    return ExclusiveRead<u8>(core_index, addr, [&] { return memory.Read8(addr); });
+}
+
+u16 ShardedExclusiveMonitor::ExclusiveRead16(std::size_t core_index, VAddr addr) {
+    return ExclusiveRead<u16>(core_index, addr, [&] { return memory.Read16(addr); });
+}
+
+u32 ShardedExclusiveMonitor::ExclusiveRead32(std::size_t core_index, VAddr addr) {
+    return ExclusiveRead<u32>(core_index, addr, [&] { return memory.Read32(addr); });
+}
+
+u64 ShardedExclusiveMonitor::ExclusiveRead64(std::size_t core_index, VAddr addr) {
+    return ExclusiveRead<u64>(core_index, addr, [&] { return memory.Read64(addr); });
+}
+
+void ShardedExclusiveMonitor::ClearExclusive(std::size_t core_index) {
+    reservations[core_index].tag.store(NO_RESERVATION, std::memory_order_relaxed);
+}
+
+bool ShardedExclusiveMonitor::ExclusiveWrite8(std::size_t core_index, VAddr vaddr, u8 value) {
+    return ExclusiveWrite<u8>(core_index, vaddr, [&](u8 expected) {
+        return memory.WriteExclusive8(vaddr, value, expected);
+    });
+}
+
+bool ShardedExclusiveMonitor::ExclusiveWrite16(std::size_t core_index, VAddr vaddr, u16 value) {
+    return ExclusiveWrite<u16>(core_index, vaddr, [&](u16 expected) {
+        return memory.WriteExclusive16(vaddr, value, expected);
+    });
+}
+
+bool ShardedExclusiveMonitor::ExclusiveWrite32(std::size_t core_index, VAddr vaddr, u32 value) {
+    return ExclusiveWrite<u32>(core_index, vaddr, [&](u32 expected) {
+        return memory.WriteExclusive32(vaddr, value, expected);
+    });
+}
+
+bool ShardedExclusiveMonitor::ExclusiveWrite64(std::size_t core_index, VAddr vaddr, u64 value) {
+    return ExclusiveWrite<u64>(core_index, vaddr, [&](u64 expected) {
+        return memory.WriteExclusive64(vaddr, value, expected);
+    });
+}
+
+} // namespace Core
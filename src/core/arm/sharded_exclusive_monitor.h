@@ -0,0 +1,73 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "common/common_types.h"
+#include "core/arm/exclusive_monitor.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+namespace Core {
+
+/**
+ * Global exclusive monitor that does not serialize all cores on one lock. Reservations are kept
+ * per core, and exclusive accesses only lock the shard of their reservation granule. Exclusive
+ * writes are host compare-and-swaps against the value read by the exclusive load, so plain stores
+ * of other cores to a reserved address also make them fail.
+ */
+class ShardedExclusiveMonitor final : public ExclusiveMonitor {
+public:
+    explicit ShardedExclusiveMonitor(Memory::MemorySystem& memory, std::size_t num_cores);
+    ~ShardedExclusiveMonitor() override;
+
+    u8 ExclusiveRead8(std::size_t core_index, VAddr addr) override;
+    u16 ExclusiveRead16(std::size_t core_index, VAddr addr) override;
+    u32 ExclusiveRead32(std::size_t core_index, VAddr addr) override;
+    u64 ExclusiveRead64(std::size_t core_index, VAddr addr) override;
+    void ClearExclusive(std::size_t core_index) override;
+
+    bool ExclusiveWrite8(std::size_t core_index, VAddr vaddr, u8 value) override;
+    bool ExclusiveWrite16(std::size_t core_index, VAddr vaddr, u16 value) override;
+    bool ExclusiveWrite32(std::size_t core_index, VAddr vaddr, u32 value) override;
+    bool ExclusiveWrite64(std::size_t core_index, VAddr vaddr, u64 value) override;
+
+private:
+    static constexpr std::size_t NUM_SHARDS = 64;
+    static constexpr u32 RESERVATION_GRANULE_BITS = 3;
+    static constexpr VAddr RESERVATION_GRANULE_MASK = ~((1U << RESERVATION_GRANULE_BITS) - 1);
+    /// Reservation tags are granule addresses, these never match one
+    static constexpr u64 NO_RESERVATION = ~u64{0};
+    static constexpr u64 LOST_RESERVATION = ~u64{1};
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+    };
+
+    struct alignas(64) Reservation {
+        std::atomic<u64> tag{NO_RESERVATION};
+        /// Value read by the exclusive load, only accessed by the owning core
+        u64 value = 0;
+    };
+
+    std::unique_lock<std::mutex> LockShard(std::size_t core_index, VAddr addr);
+
+    template <typename T, typename ReadFunc>
+    T ExclusiveRead(std::size_t core_index, VAddr addr, ReadFunc&& read);
+
+    template <typename T, typename WriteFunc>
+    bool ExclusiveWrite(std::size_t core_index, VAddr addr, WriteFunc&& write);
+
+    Memory::MemorySystem& memory;
+    std::array<Shard, NUM_SHARDS> shards;
+    std::vector<Reservation> reservations;
+};
+
+} // namespace Core
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include "common/logging/log.h"
 #include "common/swap.h"
+#include "core/arm/exclusive_monitor.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
 #include "core/core.h"
@@ -265,6 +266,111 @@ void ARMul_State::WriteMemory64(u32 address, u64 data) {
     memory.Write64(address, data);
 }
 
+void ARMul_State::UnsetExclusiveMemoryAddress() {
+    exclusive_tag = 0xFFFFFFFF;
+    exclusive_state = false;
+    if (exclusive_monitor) {
+        exclusive_monitor->ClearExclusive(core_id);
+    }
+}
+
+u8 ARMul_State::ReadExclusiveMemory8(u32 address) {
+    if (!exclusive_monitor) {
+        SetExclusiveMemoryAddress(address);
+        return ReadMemory8(address);
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
+    return exclusive_monitor->ExclusiveRead8(core_id, address);
+}
+
+u16 ARMul_State::ReadExclusiveMemory16(u32 address) {
+    if (!exclusive_monitor) {
+        SetExclusiveMemoryAddress(address);
+        return ReadMemory16(address);
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
+    const u16 data = exclusive_monitor->ExclusiveRead16(core_id, address);
+    return InBigEndianMode() ? Common::swap16(data) : data;
+}
+
+u32 ARMul_State::ReadExclusiveMemory32(u32 address) {
+    if (!exclusive_monitor) {
+        SetExclusiveMemoryAddress(address);
+        return ReadMemory32(address);
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
+    const u32 data = exclusive_monitor->ExclusiveRead32(core_id, address);
+    return InBigEndianMode() ? Common::swap32(data) : data;
+}
+
+u64 ARMul_State::ReadExclusiveMemory64(u32 address) {
+    if (!exclusive_monitor) {
+        SetExclusiveMemoryAddress(address);
+        return ReadMemory64(address);
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
+    const u64 data = exclusive_monitor->ExclusiveRead64(core_id, address);
+    return InBigEndianMode() ? Common::swap64(data) : data;
+}
+
+bool ARMul_State::WriteExclusiveMemory8(u32 address, u8 data) {
+    if (!exclusive_monitor) {
+        if (!IsExclusiveMemoryAccess(address)) {
+            return false;
+        }
+        UnsetExclusiveMemoryAddress();
+        WriteMemory8(address, data);
+        return true;
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
+    return exclusive_monitor->ExclusiveWrite8(core_id, address, data);
+}
+
+bool ARMul_State::WriteExclusiveMemory16(u32 address, u16 data) {
+    if (!exclusive_monitor) {
+        if (!IsExclusiveMemoryAccess(address)) {
+            return false;
+        }
+        UnsetExclusiveMemoryAddress();
+        WriteMemory16(address, data);
+        return true;
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
+    if (InBigEndianMode())
+        data = Common::swap16(data);
+    return exclusive_monitor->ExclusiveWrite16(core_id, address, data);
+}
+
+bool ARMul_State::WriteExclusiveMemory32(u32 address, u32 data) {
+    if (!exclusive_monitor) {
+        if (!IsExclusiveMemoryAccess(address)) {
+            return false;
+        }
+        UnsetExclusiveMemoryAddress();
+        WriteMemory32(address, data);
+        return true;
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
+    if (InBigEndianMode())
+        data = Common::swap32(data);
+    return exclusive_monitor->ExclusiveWrite32(core_id, address, data);
+}
+
+bool ARMul_State::WriteExclusiveMemory64(u32 address, u64 data) {
+    if (!exclusive_monitor) {
+        if (!IsExclusiveMemoryAccess(address)) {
+            return false;
+        }
+        UnsetExclusiveMemoryAddress();
+        WriteMemory64(address, data);
+        return true;
+    }
+    CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
+    if (InBigEndianMode())
+        data = Common::swap64(data);
+    return exclusive_monitor->ExclusiveWrite64(core_id, address, data);
+}
+
 // Reads from the CP15 registers. Used with implementation of the MRC instruction.
 // Note that since the 3DS does not have the hypervisor extensions, these registers
 // are not implemented.
@@ -24,6 +24,7 @@
 #include "core/gdbstub/gdbstub.h"
 
 namespace Core {
+class ExclusiveMonitor;
 class System;
 }
 
@@ -175,10 +176,19 @@ public:
         exclusive_tag = address & RESERVATION_GRANULE_MASK;
         exclusive_state = true;
     }
-    void UnsetExclusiveMemoryAddress() {
-        exclusive_tag = 0xFFFFFFFF;
-        exclusive_state = false;
-    }
+    void UnsetExclusiveMemoryAddress();
+
+    // Exclusive loads and stores with the same endianness handling as ReadMemory/WriteMemory.
+    // They go through the global exclusive monitor if there is one, otherwise only the local
+    // monitor of this core is used.
+    u8 ReadExclusiveMemory8(u32 address);
+    u16 ReadExclusiveMemory16(u32 address);
+    u32 ReadExclusiveMemory32(u32 address);
+    u64 ReadExclusiveMemory64(u32 address);
+    bool WriteExclusiveMemory8(u32 address, u8 data);
+    bool WriteExclusiveMemory16(u32 address, u16 data);
+    bool WriteExclusiveMemory32(u32 address, u32 data);
+    bool WriteExclusiveMemory64(u32 address, u64 data);
 
     // Whether or not the given CPU is in big endian mode (E bit is set)
     bool InBigEndianMode() const {
@@ -208,6 +218,9 @@ public:
 
     Core::System* system;
     Memory::MemorySystem& memory;
+    /// Shared by all cores, optional
+    Core::ExclusiveMonitor* exclusive_monitor = nullptr;
+    std::size_t core_id = 0;
 
     std::array<u32, 16> Reg{}; // The current register file
     std::array<u32, 2> Reg_usr{};
@@ -3,9 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
-#include <cmath>
+#include <cstring>
 #include <fstream>
-#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include <boost/iostreams/device/file_descriptor.hpp>
@@ -30,39 +30,86 @@ struct State {
     bool loop_flag = false;
 };
 
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat::CheatLine& line,
-                                                              const State& state,
-                                                              ReadFunction read_func,
-                                                              WriteFunction write_func,
-                                                              Core::System& system) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
-    if (val != static_cast<T>(line.value)) {
-        write_func(addr, static_cast<T>(line.value));
+/**
+ * Accesses the emulated memory for one run of a cheat. Plain RAM is accessed through the host
+ * pointers of the current page table, which is looked up once per run so that remapped pages are
+ * picked up by the next run. Other pages go through the memory system.
+ */
+class CheatMemory {
+public:
+    explicit CheatMemory(Memory::MemorySystem& memory_)
+        : memory(memory_), page_table(memory.GetCurrentPageTable()) {}
+
+    template <typename T>
+    T Read(VAddr addr) {
+        if (const u8* page_pointer = GetPagePointer(addr)) {
+            T value;
+            std::memcpy(&value, page_pointer + (addr & Memory::CITRA_PAGE_MASK), sizeof(T));
+            return value;
+        }
+        if constexpr (sizeof(T) == 1) {
+            return memory.Read8(addr);
+        } else if constexpr (sizeof(T) == 2) {
+            return memory.Read16(addr);
+        } else {
+            return memory.Read32(addr);
+        }
+    }
+
+    template <typename T>
+    void Write(VAddr addr, T value) {
+        if (u8* page_pointer = GetPagePointer(addr)) {
+            std::memcpy(page_pointer + (addr & Memory::CITRA_PAGE_MASK), &value, sizeof(T));
+            return;
+        }
+        if constexpr (sizeof(T) == 1) {
+            memory.Write8(addr, value);
+        } else if constexpr (sizeof(T) == 2) {
+            memory.Write16(addr, value);
+        } else {
+            memory.Write32(addr, value);
+        }
+    }
+
+private:
+    u8* GetPagePointer(VAddr addr) const {
+        return page_table ? page_table->GetPointerArray()[addr >> Memory::CITRA_PAGE_BITS]
+                          : nullptr;
+    }
+
+    Memory::MemorySystem& memory;
+    std::shared_ptr<Memory::PageTable> page_table;
+};
+
+using Op = GatewayCheat::Op;
+
+template <typename T>
+static inline void WriteOp(const Op& op, const State& state, CheatMemory& memory,
+                           Core::System& system) {
+    u32 addr = op.address + state.offset;
+    T val = memory.Read<T>(addr);
+    if (val != static_cast<T>(op.value)) {
+        memory.Write<T>(addr, static_cast<T>(op.value));
         system.InvalidateCacheRange(addr, sizeof(T));
     }
 }
 
-template <typename T, typename ReadFunction, typename CompareFunc>
-static inline std::enable_if_t<std::is_integral_v<T>> CompOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func,
-                                                             CompareFunc comp) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
+template <typename T, typename CompareFunc>
+static inline void CompOp(const Op& op, State& state, CheatMemory& memory, CompareFunc comp) {
+    u32 addr = op.address + state.offset;
+    T val = memory.Read<T>(addr);
     if (!comp(val)) {
         state.if_flag++;
     }
 }
 
-static inline void LoadOffsetOp(Memory::MemorySystem& memory, const GatewayCheat::CheatLine& line,
-                                State& state) {
-    u32 addr = line.address + state.offset;
-    state.offset = memory.Read32(addr);
+static inline void LoadOffsetOp(const Op& op, State& state, CheatMemory& memory) {
+    u32 addr = op.address + state.offset;
+    state.offset = memory.Read<u32>(addr);
 }
 
-static inline void LoopOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.loop_flag = state.loop_count < line.value;
+static inline void LoopOp(const Op& op, State& state) {
+    state.loop_flag = state.loop_count < op.value;
     state.loop_count++;
     state.loop_back_line = state.current_line_nr;
 }
@@ -93,90 +140,70 @@ static inline void FullTerminateOp(State& state) {
     }
 }
 
-static inline void SetOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset = line.value;
+static inline void SetOffsetOp(const Op& op, State& state) {
+    state.offset = op.value;
 }
 
-static inline void AddValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg += line.value;
+static inline void AddValueOp(const Op& op, State& state) {
+    state.reg += op.value;
 }
 
-static inline void SetValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg = line.value;
+static inline void SetValueOp(const Op& op, State& state) {
+    state.reg = op.value;
 }
 
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> IncrementiveWriteOp(
-    const GatewayCheat::CheatLine& line, State& state, ReadFunction read_func,
-    WriteFunction write_func, Core::System& system) {
-    u32 addr = line.value + state.offset;
-    T val = read_func(addr);
+template <typename T>
+static inline void IncrementiveWriteOp(const Op& op, State& state, CheatMemory& memory,
+                                       Core::System& system) {
+    u32 addr = op.value + state.offset;
+    T val = memory.Read<T>(addr);
     if (val != static_cast<T>(state.reg)) {
-        write_func(addr, static_cast<T>(state.reg));
+        memory.Write<T>(addr, static_cast<T>(state.reg));
         system.InvalidateCacheRange(addr, sizeof(T));
     }
     state.offset += sizeof(T);
 }
 
-template <typename T, typename ReadFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> LoadOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func) {
-
-    u32 addr = line.value + state.offset;
-    state.reg = read_func(addr);
+template <typename T>
+static inline void LoadOp(const Op& op, State& state, CheatMemory& memory) {
+    u32 addr = op.value + state.offset;
+    state.reg = memory.Read<T>(addr);
 }
 
-static inline void AddOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset += line.value;
+static inline void AddOffsetOp(const Op& op, State& state) {
+    state.offset += op.value;
 }
 
-static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state,
+static inline void JokerOp(const Op& op, State& state, std::optional<u32>& pad_state,
                            const Core::System& system) {
-    u32 pad_state = system.ServiceManager()
+    // The pad state does not change while the cheat runs, so it is only read once
+    if (!pad_state) {
+        pad_state = system.ServiceManager()
                         .GetService<Service::HID::Module::Interface>("hid:USER")
                         ->GetModule()
                         ->GetState()
                         .hex;
-    bool pressed = (pad_state & line.value) == line.value;
+    }
+    bool pressed = (*pad_state & op.value) == op.value;
     if (!pressed) {
         state.if_flag++;
     }
 }
 
-static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Core::System& system,
-                           const std::vector<GatewayCheat::CheatLine>& cheat_lines) {
-    if (state.if_flag > 0) {
-        // Skip over the additional patch lines
-        state.current_line_nr += static_cast<int>(std::ceil(line.value / 8.0));
-        return;
-    }
-    u32 num_bytes = line.value;
-    u32 addr = line.address + state.offset;
+static inline void PatchOp(const Op& op, const State& state, CheatMemory& memory,
+                           Core::System& system, const std::vector<u8>& patch_data) {
+    u32 num_bytes = op.value;
+    u32 addr = op.address + state.offset;
     system.InvalidateCacheRange(addr, num_bytes);
 
-    bool first = true;
-    u32 bit_offset = 0;
-    if (num_bytes > 0)
-        state.current_line_nr++; // skip over the current code
-    while (num_bytes >= 4) {
-        u32 tmp = first ? cheat_lines[state.current_line_nr].first
-                        : cheat_lines[state.current_line_nr].value;
-        if (!first && num_bytes > 4) {
-            state.current_line_nr++;
-        }
-        first = !first;
-        system.Memory().Write32(addr, tmp);
-        addr += 4;
-        num_bytes -= 4;
+    const u8* data = patch_data.data() + op.patch_offset;
+    for (; num_bytes >= 4; num_bytes -= 4, addr += 4, data += 4) {
+        u32 word;
+        std::memcpy(&word, data, sizeof(word));
+        memory.Write<u32>(addr, word);
     }
-    while (num_bytes > 0) {
-        u32 tmp = (first ? cheat_lines[state.current_line_nr].first
-                         : cheat_lines[state.current_line_nr].value) >>
-                  bit_offset;
-        system.Memory().Write8(addr, tmp);
-        addr += 1;
-        num_bytes -= 1;
-        bit_offset += 8;
+    for (; num_bytes > 0; num_bytes--, addr++, data++) {
+        memory.Write<u8>(addr, *data);
     }
 }
 
@@ -211,6 +238,7 @@ GatewayCheat::CheatLine::CheatLine(const std::string& line) {
 GatewayCheat::GatewayCheat(std::string name_, std::vector<CheatLine> cheat_lines_,
                            std::string comments_)
     : name(std::move(name_)), cheat_lines(std::move(cheat_lines_)), comments(std::move(comments_)) {
+    Compile();
 }
 
 GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comments_)
@@ -225,26 +253,50 @@ GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comm
             temp_cheat_lines.emplace_back(code_lines[i]);
     }
     cheat_lines = std::move(temp_cheat_lines);
+    Compile();
 }
 
 GatewayCheat::~GatewayCheat() = default;
 
+void GatewayCheat::Compile() {
+    ops.reserve(cheat_lines.size());
+    for (std::size_t i = 0; i < cheat_lines.size(); ++i) {
+        const CheatLine& line = cheat_lines[i];
+        Op op{line.type, line.address, line.value, 0};
+        if (line.type == CheatType::Patch) {
+            // EXXXXXXX YYYYYYYY is followed by the YYYYYYYY bytes to copy, 8 bytes per line. They
+            // are gathered here, so the lines holding them are not executed.
+            op.patch_offset = static_cast<u32>(patch_data.size());
+            const std::size_t num_lines = (static_cast<std::size_t>(line.value) + 7) / 8;
+            const std::size_t available_lines = std::min(num_lines, cheat_lines.size() - i - 1);
+            for (std::size_t j = 1; j <= available_lines; ++j) {
+                for (const u32 word : {cheat_lines[i + j].first, cheat_lines[i + j].value}) {
+                    for (u32 byte = 0; byte < 4; ++byte) {
+                        patch_data.push_back(static_cast<u8>(word >> (byte * 8)));
+                    }
+                }
+            }
+            if (available_lines < num_lines) {
+                LOG_ERROR(Core_Cheats, "Patch in cheat {} is missing {} lines of data", name,
+                          num_lines - available_lines);
+            }
+            op.value = std::min(line.value, static_cast<u32>(available_lines * 8));
+            i += available_lines;
+        }
+        ops.push_back(op);
+    }
+}
+
 void GatewayCheat::Execute(Core::System& system) const {
     State state;
+    CheatMemory memory(system.Memory());
+    std::optional<u32> pad_state;
 
-    Memory::MemorySystem& memory = system.Memory();
-    auto Read8 = [&memory](VAddr addr) { return memory.Read8(addr); };
-    auto Read16 = [&memory](VAddr addr) { return memory.Read16(addr); };
-    auto Read32 = [&memory](VAddr addr) { return memory.Read32(addr); };
-    auto Write8 = [&memory](VAddr addr, u8 value) { memory.Write8(addr, value); };
-    auto Write16 = [&memory](VAddr addr, u16 value) { memory.Write16(addr, value); };
-    auto Write32 = [&memory](VAddr addr, u32 value) { memory.Write32(addr, value); };
-
-    for (state.current_line_nr = 0; state.current_line_nr < cheat_lines.size();
+    for (state.current_line_nr = 0; state.current_line_nr < ops.size();
          state.current_line_nr++) {
-        auto line = cheat_lines[state.current_line_nr];
+        const Op& op = ops[state.current_line_nr];
         if (state.if_flag > 0) {
-            switch (line.type) {
+            switch (op.type) {
             case CheatType::GreaterThan32:
             case CheatType::LessThan32:
             case CheatType::EqualTo32:
@@ -257,12 +309,6 @@ void GatewayCheat::Execute(Core::System& system) const {
                 // Increment the if_flag to handle the end if correctly
                 state.if_flag++;
                 break;
-            case CheatType::Patch:
-                // EXXXXXXX YYYYYYYY
-                // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-                // We need to call this here to skip the additional patch lines
-                PatchOp(line, state, system, cheat_lines);
-                break;
             case CheatType::Terminator:
                 // D0000000 00000000 - ENDIF
                 TerminateOp(state);
@@ -277,71 +323,69 @@ void GatewayCheat::Execute(Core::System& system) const {
             // Do not execute any other op code
             continue;
         }
-        switch (line.type) {
+        switch (op.type) {
         case CheatType::Null:
             break;
         case CheatType::Write32:
             // 0XXXXXXX YYYYYYYY - word[XXXXXXX+offset] = YYYYYYYY
-            WriteOp<u32>(line, state, Read32, Write32, system);
+            WriteOp<u32>(op, state, memory, system);
             break;
         case CheatType::Write16:
             // 1XXXXXXX 0000YYYY - half[XXXXXXX+offset] = YYYY
-            WriteOp<u16>(line, state, Read16, Write16, system);
+            WriteOp<u16>(op, state, memory, system);
             break;
         case CheatType::Write8:
             // 2XXXXXXX 000000YY - byte[XXXXXXX+offset] = YY
-            WriteOp<u8>(line, state, Read8, Write8, system);
+            WriteOp<u8>(op, state, memory, system);
             break;
         case CheatType::GreaterThan32:
             // 3XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY > word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value > val; });
+            CompOp<u32>(op, state, memory, [&op](u32 val) -> bool { return op.value > val; });
             break;
         case CheatType::LessThan32:
             // 4XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY < word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value < val; });
+            CompOp<u32>(op, state, memory, [&op](u32 val) -> bool { return op.value < val; });
             break;
         case CheatType::EqualTo32:
             // 5XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY == word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value == val; });
+            CompOp<u32>(op, state, memory, [&op](u32 val) -> bool { return op.value == val; });
             break;
         case CheatType::NotEqualTo32:
             // 6XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY != word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value != val; });
+            CompOp<u32>(op, state, memory, [&op](u32 val) -> bool { return op.value != val; });
             break;
         case CheatType::GreaterThan16WithMask:
             // 7XXXXXXX ZZZZYYYY - Execute next block IF YYYY > ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) > (static_cast<u16>(~line.value >> 16) & val);
+            CompOp<u16>(op, state, memory, [&op](u16 val) -> bool {
+                return static_cast<u16>(op.value) > (static_cast<u16>(~op.value >> 16) & val);
             });
             break;
         case CheatType::LessThan16WithMask:
             // 8XXXXXXX ZZZZYYYY - Execute next block IF YYYY < ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) < (static_cast<u16>(~line.value >> 16) & val);
+            CompOp<u16>(op, state, memory, [&op](u16 val) -> bool {
+                return static_cast<u16>(op.value) < (static_cast<u16>(~op.value >> 16) & val);
             });
             break;
         case CheatType::EqualTo16WithMask:
             // 9XXXXXXX ZZZZYYYY - Execute next block IF YYYY = ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) == (static_cast<u16>(~line.value >> 16) & val);
+            CompOp<u16>(op, state, memory, [&op](u16 val) -> bool {
+                return static_cast<u16>(op.value) == (static_cast<u16>(~op.value >> 16) & val);
             });
             break;
         case CheatType::NotEqualTo16WithMask:
             // AXXXXXXX ZZZZYYYY - Execute next block IF YYYY <> ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) != (static_cast<u16>(~line.value >> 16) & val);
+            CompOp<u16>(op, state, memory, [&op](u16 val) -> bool {
+                return static_cast<u16>(op.value) != (static_cast<u16>(~op.value >> 16) & val);
             });
             break;
         case CheatType::LoadOffset:
             // BXXXXXXX 00000000 - offset = word[XXXXXXX+offset]
-            LoadOffsetOp(system.Memory(), line, state);
+            LoadOffsetOp(op, state, memory);
             break;
         case CheatType::Loop: {
             // C0000000 YYYYYYYY - LOOP next block YYYYYYYY times
             // TODO(B3N30): Support nested loops if necessary
-            LoopOp(line, state);
+            LoopOp(op, state);
             break;
         }
         case CheatType::Terminator: {
@@ -361,63 +405,63 @@ void GatewayCheat::Execute(Core::System& system) const {
         }
         case CheatType::SetOffset: {
             // D3000000 XXXXXXXX – Sets the offset to XXXXXXXX
-            SetOffsetOp(line, state);
+            SetOffsetOp(op, state);
             break;
         }
         case CheatType::AddValue: {
             // D4000000 XXXXXXXX – reg += XXXXXXXX
-            AddValueOp(line, state);
+            AddValueOp(op, state);
             break;
         }
         case CheatType::SetValue: {
             // D5000000 XXXXXXXX – reg = XXXXXXXX
-            SetValueOp(line, state);
+            SetValueOp(op, state);
             break;
         }
         case CheatType::IncrementiveWrite32: {
             // D6000000 XXXXXXXX – (32bit) [XXXXXXXX+offset] = reg ; offset += 4
-            IncrementiveWriteOp<u32>(line, state, Read32, Write32, system);
+            IncrementiveWriteOp<u32>(op, state, memory, system);
             break;
         }
         case CheatType::IncrementiveWrite16: {
             // D7000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xffff ; offset += 2
-            IncrementiveWriteOp<u16>(line, state, Read16, Write16, system);
+            IncrementiveWriteOp<u16>(op, state, memory, system);
             break;
         }
         case CheatType::IncrementiveWrite8: {
             // D8000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xff ; offset++
-            IncrementiveWriteOp<u8>(line, state, Read8, Write8, system);
+            IncrementiveWriteOp<u8>(op, state, memory, system);
             break;
         }
         case CheatType::Load32: {
             // D9000000 XXXXXXXX – reg = [XXXXXXXX+offset]
-            LoadOp<u32>(line, state, Read32);
+            LoadOp<u32>(op, state, memory);
             break;
         }
         case CheatType::Load16: {
             // DA000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFFFF
-            LoadOp<u16>(line, state, Read16);
+            LoadOp<u16>(op, state, memory);
             break;
         }
         case CheatType::Load8: {
             // DB000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFF
-            LoadOp<u8>(line, state, Read8);
+            LoadOp<u8>(op, state, memory);
             break;
         }
         case CheatType::AddOffset: {
             // DC000000 XXXXXXXX – offset + XXXXXXXX
-            AddOffsetOp(line, state);
+            AddOffsetOp(op, state);
             break;
         }
         case CheatType::Joker: {
             // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
-            JokerOp(line, state, system);
+            JokerOp(op, state, pad_state, system);
             break;
         }
         case CheatType::Patch: {
             // EXXXXXXX YYYYYYYY
             // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-            PatchOp(line, state, system, cheat_lines);
+            PatchOp(op, state, memory, system, patch_data);
             break;
         }
         }
@@ -55,6 +55,15 @@ public:
         bool valid = true;
     };
 
+    /// Cheat line decoded for execution
+    struct Op {
+        CheatType type;
+        u32 address;
+        u32 value;
+        /// Offset of the bytes to copy in `patch_data`, for patches
+        u32 patch_offset;
+    };
+
     GatewayCheat(std::string name, std::vector<CheatLine> cheat_lines, std::string comments);
     GatewayCheat(std::string name, std::string code, std::string comments);
     ~GatewayCheat();
@@ -80,9 +89,15 @@ public:
     static std::vector<std::unique_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
 private:
+    /// Decodes the lines into `ops` once, so that running the cheat does not parse them again
+    void Compile();
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
     const std::string comments;
+    std::vector<Op> ops;
+    /// Data of all patches, the lines holding it are left out of `ops`
+    std::vector<u8> patch_data;
 };
 } // namespace Cheats
@@ -0,0 +1,59 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "core/clock_scaler.h"
+
+namespace Core {
+
+namespace {
+
+/// Weight of the latest frame in the moving averages
+constexpr double AverageWeight = 0.1;
+
+/// Below this idle share the guest is CPU bound and may use a faster clock
+constexpr double LowIdle = 0.05;
+/// Above this idle share the guest doesn't need the clock it has
+constexpr double HighIdle = 0.25;
+/// The clock is only raised while the host needs less than this share of the frame
+constexpr double HeadroomLoad = 0.85;
+
+} // Anonymous namespace
+
+ClockScaler::ClockScaler(u32 min_percentage, u32 max_percentage)
+    : min_percentage{min_percentage}, max_percentage{std::max(min_percentage, max_percentage)},
+      percentage{min_percentage} {}
+
+u32 ClockScaler::Update(u64 ticks, u64 idle_ticks, double host_load) {
+    // Loading a state moves the counters back, the frame can't be measured then
+    const bool valid = ticks > last_ticks && idle_ticks >= last_idle_ticks;
+    const u64 frame_ticks = ticks - last_ticks;
+    const u64 frame_idle_ticks = idle_ticks - last_idle_ticks;
+    last_ticks = ticks;
+    last_idle_ticks = idle_ticks;
+    if (!valid) {
+        return percentage;
+    }
+
+    const double idle = std::min(static_cast<double>(frame_idle_ticks) / frame_ticks, 1.0);
+    idle_average += (idle - idle_average) * AverageWeight;
+    load_average += (host_load - load_average) * AverageWeight;
+    if (++frames_since_change < SettleFrames) {
+        return percentage;
+    }
+
+    u32 new_percentage = percentage;
+    if (load_average > 1.0 || idle_average > HighIdle) {
+        new_percentage = std::max(percentage, min_percentage + Step) - Step;
+    } else if (idle_average < LowIdle && load_average < HeadroomLoad) {
+        new_percentage = std::min(percentage + Step, max_percentage);
+    }
+    if (new_percentage != percentage) {
+        percentage = new_percentage;
+        frames_since_change = 0;
+    }
+    return percentage;
+}
+
+} // namespace Core
@@ -0,0 +1,51 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+namespace Core {
+
+/**
+ * Picks the emulated CPU clock percentage from how busy the guest and the host are. The clock is
+ * raised while the application core hardly idles and the host has time to spare, and lowered
+ * while the guest idles a lot or the host falls behind. Each change is followed by a settle
+ * period so that both can react to it.
+ */
+class ClockScaler {
+public:
+    /// Percentage points the clock changes by at a time
+    static constexpr u32 Step = 10;
+    /// Frames between two changes
+    static constexpr u32 SettleFrames = 30;
+
+    explicit ClockScaler(u32 min_percentage, u32 max_percentage);
+
+    /**
+     * Records a frame and returns the clock percentage to run the next ones at.
+     * @param ticks Emulated ticks of the application core so far
+     * @param idle_ticks Ticks of the application core spent idle so far
+     * @param host_load Host time of the frame over the time it may take, zero when the speed is
+     * unlimited
+     */
+    u32 Update(u64 ticks, u64 idle_ticks, double host_load);
+
+    u32 GetPercentage() const {
+        return percentage;
+    }
+
+private:
+    u32 min_percentage;
+    u32 max_percentage;
+    u32 percentage;
+    u32 frames_since_change = 0;
+    u64 last_ticks = 0;
+    u64 last_idle_ticks = 0;
+    /// Moving averages of the idle share of the frames and of the host load
+    double idle_average = 0.0;
+    double load_average = 0.0;
+};
+
+} // namespace Core
@@ -2,11 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 #include <boost/serialization/array.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/hle/hle.h"
 #include "audio_core/lle/lle.h"
@@ -19,8 +27,10 @@
 #endif
 #include "core/arm/dyncom/arm_dyncom.h"
 #include "core/cheats/cheats.h"
+#include "core/clock_scaler.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/cpu_manager.h"
 #include "core/dumping/backend.h"
 #ifdef ENABLE_FFMPEG_VIDEO_DUMPER
 #include "core/dumping/ffmpeg_backend.h"
@@ -32,6 +42,7 @@
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/thread.h"
+#include "core/hle/lock.h"
 #include "core/hle/service/apt/applet_manager.h"
 #include "core/hle/service/apt/apt.h"
 #include "core/hle/service/fs/archive.h"
@@ -44,14 +55,37 @@
 #include "core/hw/lcd.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
+#include "core/rewind_buffer.h"
 #include "core/rpc/rpc_server.h"
+#include "core/savestate.h"
 #include "network/network.h"
+#include "video_core/pica.h"
 #include "video_core/rasterizer_cache/custom_tex_manager.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
 
 namespace Core {
 
+namespace {
+
+/// Logs how long each phase of booting takes
+class BootTimer {
+public:
+    /// Logs the time since the previous phase ended
+    void EndPhase(std::string_view phase) {
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - phase_start);
+        LOG_INFO(Core, "Boot phase \"{}\" took {:.2f} ms", phase, elapsed.count() / 1000.0);
+        phase_start = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point phase_start = std::chrono::steady_clock::now();
+};
+
+} // Anonymous namespace
+
 /*static*/ System System::s_instance;
 
 template <>
@@ -129,7 +163,7 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         LOG_INFO(Core, "Begin save");
         try {
             System::SaveState(param);
-            LOG_INFO(Core, "Save completed");
+            LOG_INFO(Core, "Save captured, writing it in the background");
         } catch (const std::exception& e) {
             LOG_ERROR(Core, "Error saving: {}", e.what());
             status_details = e.what();
@@ -138,10 +172,57 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         frame_limiter.WaitOnce();
         return ResultStatus::Success;
     }
+    case Signal::Rewind: {
+        if (Network::GetRoomMember().lock()->IsConnected()) {
+            LOG_ERROR(Core, "Unable to rewind while connected to multiplayer");
+            return ResultStatus::Success;
+        }
+        auto snapshot = rewind_buffer ? rewind_buffer->PopNewest() : std::nullopt;
+        if (!snapshot) {
+            LOG_INFO(Core, "No state left to rewind to");
+            return ResultStatus::Success;
+        }
+        try {
+            DeserializeState(std::move(snapshot->keyframe), false);
+            if (snapshot->delta) {
+                DeserializeState(std::move(*snapshot->delta), true);
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error rewinding: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+        last_rewind_capture = timing->GetGlobalTimeUs();
+        frame_limiter.WaitOnce();
+        return ResultStatus::Success;
+    }
     default:
         break;
     }
 
+    // A state written in the background reports its error once the write is done
+    if (auto error = TakePendingSaveError()) {
+        status_details = std::move(*error);
+        return ResultStatus::ErrorSavestate;
+    }
+
+    if (rewind_buffer) {
+        // Emulated time is used so that the states are evenly spread over gameplay, however fast
+        // it runs. A savestate load can move time backwards.
+        const auto now = timing->GetGlobalTimeUs();
+        const std::chrono::microseconds interval{
+            1000000 / Settings::values.rewind_states_per_second.GetValue()};
+        if (now < last_rewind_capture || now - last_rewind_capture >= interval) {
+            last_rewind_capture = now;
+            try {
+                rewind_buffer->Push(SerializeState(rewind_buffer->GetDeltaBase()));
+            } catch (const std::exception& e) {
+                LOG_ERROR(Core, "Error capturing rewind state, stopping rewind: {}", e.what());
+                rewind_buffer.reset();
+            }
+        }
+    }
+
     // All cores should have executed the same amount of ticks. If this is not the case an event was
     // scheduled with a cycles_into_future smaller then the current downcount.
     // So we have to get those cores to the same global time first
@@ -180,6 +261,7 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             current_core_to_execute->GetTimer().Idle();
             PrepareReschedule();
         } else {
+            PerfStats::SubsystemTimer timer{perf_stats.get(), PerfStats::Subsystem::CPU};
             if (tight_loop) {
                 current_core_to_execute->Run();
             } else {
@@ -198,27 +280,32 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             kernel->GetThreadManager(cpu_core->GetID()).Reschedule();
             max_slice = std::min(max_slice, cpu_core->GetTimer().GetMaxSliceLength());
         }
-        for (auto& cpu_core : cpu_cores) {
-            cpu_core->GetTimer().SetNextSlice(max_slice);
-            auto start_ticks = cpu_core->GetTimer().GetTicks();
-            LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
-                      cpu_core->GetTimer().GetDowncount());
-            running_core = cpu_core.get();
-            kernel->SetRunningCPU(running_core);
-            // If we don't have a currently active thread then don't execute instructions,
-            // instead advance to the next event and try to yield to the next thread
-            if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
-                LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
-                cpu_core->GetTimer().Idle();
-                PrepareReschedule();
-            } else {
-                if (tight_loop) {
-                    cpu_core->Run();
+        if (CanRunCoresInParallel()) {
+            RunCoresInParallel(max_slice, tight_loop);
+        } else {
+            for (auto& cpu_core : cpu_cores) {
+                cpu_core->GetTimer().SetNextSlice(max_slice);
+                auto start_ticks = cpu_core->GetTimer().GetTicks();
+                LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
+                          cpu_core->GetTimer().GetDowncount());
+                running_core = cpu_core.get();
+                kernel->SetRunningCPU(running_core);
+                // If we don't have a currently active thread then don't execute instructions,
+                // instead advance to the next event and try to yield to the next thread
+                if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+                    LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+                    cpu_core->GetTimer().Idle();
+                    PrepareReschedule();
                 } else {
-                    cpu_core->Step();
+                    PerfStats::SubsystemTimer timer{perf_stats.get(), PerfStats::Subsystem::CPU};
+                    if (tight_loop) {
+                        cpu_core->Run();
+                    } else {
+                        cpu_core->Step();
+                    }
                 }
+                max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
             }
-            max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
         }
     }
 
@@ -249,6 +336,7 @@ System::ResultStatus System::SingleStep() {
 
 System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::string& filepath,
                                   Frontend::EmuWindow* secondary_window) {
+    BootTimer boot_timer;
     FileUtil::SetCurrentRomPath(filepath);
     app_loader = Loader::GetLoader(filepath);
     if (!app_loader) {
@@ -281,8 +369,26 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     if (Settings::values.is_new_3ds) {
         num_cores = 4;
     }
+    title_id = 0;
+    if (const auto result = app_loader->ReadProgramId(title_id);
+        result != Loader::ResultStatus::Success) {
+        LOG_ERROR(Core, "Failed to find title id for ROM (Error {})", static_cast<u32>(result));
+    }
+    // The JITs are built by Init, so the profile is picked before it runs
+    jit_profile = Settings::values.use_jit_profiles ? LoadJitProfile(title_id)
+                                                    : JitProfile::Accurate();
+    LOG_INFO(Core, "CPU JIT profile: {}", jit_profile.ToString());
+    boot_timer.EndPhase("Open title");
+
+    // Reading and decompressing the code does not depend on the emulated system, so it runs while
+    // the kernel, the services and the renderer are initialized. The renderer stays on this
+    // thread, since it may need to own the graphics context.
+    auto preload = std::async(std::launch::async, [this] { app_loader->Preload(); });
     ResultStatus init_result{
         Init(emu_window, secondary_window, *system_mode.first, *n3ds_mode.first, num_cores)};
+    boot_timer.EndPhase("Initialize system");
+    preload.wait();
+    boot_timer.EndPhase("Wait for title preload");
     if (init_result != ResultStatus::Success) {
         LOG_CRITICAL(Core, "Failed to initialize system (Error {})!",
                      static_cast<u32>(init_result));
@@ -309,17 +415,28 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
         }
     }
     kernel->SetCurrentProcess(process);
+    boot_timer.EndPhase("Load title");
     cheat_engine = std::make_unique<Cheats::CheatEngine>(*this);
-    title_id = 0;
-    if (app_loader->ReadProgramId(title_id) != Loader::ResultStatus::Success) {
-        LOG_ERROR(Core, "Failed to find title id for ROM (Error {})",
-                  static_cast<u32>(load_result));
-    }
     perf_stats = std::make_unique<PerfStats>(title_id);
 
+    if (const u32 rewind_seconds = Settings::values.rewind_seconds.GetValue()) {
+        rewind_buffer = std::make_unique<RewindBuffer>(
+            rewind_seconds * Settings::values.rewind_states_per_second.GetValue(),
+            std::size_t{Settings::values.rewind_memory_mb.GetValue()} << 20);
+        last_rewind_capture = {};
+    }
+
+    if (Settings::values.auto_cpu_clock) {
+        clock_scaler =
+            std::make_unique<ClockScaler>(Settings::values.auto_cpu_clock_min.GetValue(),
+                                          Settings::values.auto_cpu_clock_max.GetValue());
+        timing->UpdateClockSpeed(clock_scaler->GetPercentage());
+    }
+
     if (Settings::values.custom_textures) {
         custom_tex_manager->FindCustomTextures();
     }
+    boot_timer.EndPhase("Prepare frontend state");
 
     status = ResultStatus::Success;
     m_emu_window = &emu_window;
@@ -338,9 +455,95 @@ void System::PrepareReschedule() {
     reschedule_pending = true;
 }
 
+std::unique_lock<std::recursive_mutex> System::LockHLE() {
+    std::unique_lock lock{HLE::g_hle_lock};
+    ARM_Interface* thread_core = CpuManager::GetThreadCore();
+    if (thread_core && running_core != thread_core) {
+        running_core = thread_core;
+        kernel->SetRunningCPU(thread_core);
+    }
+    return lock;
+}
+
+bool System::CanRunCoresInParallel() const {
+    // Keep the sequential order whenever the execution has to be reproducible or
+    // can be paused at instruction granularity.
+    if (!cpu_manager || GDBStub::IsServerEnabled() ||
+        Movie::GetInstance().GetPlayMode() != Movie::PlayMode::None) {
+        return false;
+    }
+
+    // Memory accesses outside of the JIT fast path go through the current page table of the
+    // memory system, so only cores that execute threads of the same process may run together.
+    const Memory::PageTable* page_table = nullptr;
+    for (const auto& cpu_core : cpu_cores) {
+        const Kernel::Thread* thread =
+            kernel->GetThreadManager(cpu_core->GetID()).GetCurrentThread();
+        if (!thread) {
+            continue;
+        }
+        const auto process = thread->owner_process.lock();
+        if (!process) {
+            return false;
+        }
+        const Memory::PageTable* thread_page_table = process->vm_manager.page_table.get();
+        if (page_table && page_table != thread_page_table) {
+            return false;
+        }
+        page_table = thread_page_table;
+    }
+    return true;
+}
+
+void System::RunCoresInParallel(s64 max_slice, bool tight_loop) {
+    // Cores only synchronize at slice boundaries, so the slice length bounds how far apart their
+    // timers can drift.
+    const s64 max_skew =
+        usToCycles(static_cast<s64>(Settings::values.parallel_cpu_max_skew_us.GetValue()));
+    max_slice = std::min(max_slice, max_skew);
+
+    parallel_cores.clear();
+    for (auto& cpu_core : cpu_cores) {
+        cpu_core->GetTimer().SetNextSlice(max_slice);
+        running_core = cpu_core.get();
+        kernel->SetRunningCPU(running_core);
+        if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+            LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+            cpu_core->GetTimer().Idle();
+            PrepareReschedule();
+        } else {
+            LOG_TRACE(Core_ARM11, "Core {} running in parallel for {} ticks", cpu_core->GetID(),
+                      cpu_core->GetTimer().GetDowncount());
+            parallel_cores.push_back(cpu_core.get());
+        }
+    }
+
+    if (!parallel_cores.empty()) {
+        // The SVCs of the worker threads are accounted as HLE time on top of the slice walltime
+        PerfStats::SubsystemTimer timer{perf_stats.get(), PerfStats::Subsystem::CPU};
+        cpu_manager->RunSlice(parallel_cores, tight_loop);
+    }
+
+    // The workers may have switched the running core while entering the kernel. Restore the state
+    // the sequential loop leaves behind.
+    std::lock_guard lock{HLE::g_hle_lock};
+    running_core = cpu_cores.back().get();
+    kernel->SetRunningCPU(running_core);
+}
+
 PerfStats::Results System::GetAndResetPerfStats() {
-    return (perf_stats && timing) ? perf_stats->GetAndResetStats(timing->GetGlobalTimeUs())
-                                  : PerfStats::Results{};
+    if (!perf_stats || !timing) {
+        return PerfStats::Results{};
+    }
+    PerfStats::Results results = perf_stats->GetAndResetStats(timing->GetGlobalTimeUs());
+    if (dsp_core) {
+        // Sampled by the audio callback, so PerfStats isn't locked from the audio thread
+        results.audio_latency =
+            std::chrono::duration<double>(dsp_core->GetOutputLatency()).count();
+        results.audio_device_latency =
+            std::chrono::duration<double>(dsp_core->GetDeviceLatency()).count();
+    }
+    return results;
 }
 
 void System::Reschedule() {
@@ -359,8 +562,12 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
                                   Frontend::EmuWindow* secondary_window, u32 system_mode,
                                   u8 n3ds_mode, u32 num_cores) {
     LOG_DEBUG(HW_Memory, "initialized OK");
+    BootTimer boot_timer;
 
-    memory = std::make_unique<Memory::MemorySystem>();
+    // Kept from before a state was loaded along with the renderer caching it
+    if (!memory) {
+        memory = std::make_unique<Memory::MemorySystem>();
+    }
 
     timing = std::make_unique<Timing>(num_cores, Settings::values.cpu_clock_percentage.GetValue());
 
@@ -376,15 +583,15 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
         }
 #else
         for (u32 i = 0; i < num_cores; ++i) {
-            cpu_cores.push_back(
-                std::make_shared<ARM_DynCom>(this, *memory, USER32MODE, i, timing->GetTimer(i)));
+            cpu_cores.push_back(std::make_shared<ARM_DynCom>(
+                this, *memory, USER32MODE, i, timing->GetTimer(i), exclusive_monitor.get()));
         }
         LOG_WARNING(Core, "CPU JIT requested, but Dynarmic not available");
 #endif
     } else {
         for (u32 i = 0; i < num_cores; ++i) {
-            cpu_cores.push_back(
-                std::make_shared<ARM_DynCom>(this, *memory, USER32MODE, i, timing->GetTimer(i)));
+            cpu_cores.push_back(std::make_shared<ARM_DynCom>(
+                this, *memory, USER32MODE, i, timing->GetTimer(i), exclusive_monitor.get()));
         }
     }
     running_core = cpu_cores[0].get();
@@ -392,6 +599,11 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     kernel->SetCPUs(cpu_cores);
     kernel->SetRunningCPU(cpu_cores[0].get());
 
+    if (Settings::values.parallel_cpu_cores && Settings::values.use_cpu_jit && num_cores > 1) {
+        cpu_manager = std::make_unique<CpuManager>(cpu_cores);
+    }
+    boot_timer.EndPhase("Kernel and CPU cores");
+
     const auto audio_emulation = Settings::values.audio_emulation.GetValue();
     if (audio_emulation == Settings::AudioEmulation::HLE) {
         dsp_core = std::make_unique<AudioCore::DspHle>(*memory);
@@ -405,8 +617,11 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     dsp_core->SetSink(Settings::values.sink_id.GetValue(),
                       Settings::values.audio_device_id.GetValue());
     dsp_core->EnableStretching(Settings::values.enable_audio_stretching.GetValue());
+    boot_timer.EndPhase("Audio");
 
-    telemetry_session = std::make_unique<Core::TelemetrySession>();
+    if (!telemetry_session) {
+        telemetry_session = std::make_unique<Core::TelemetrySession>();
+    }
 
     rpc_server = std::make_unique<RPC::RPCServer>();
 
@@ -416,22 +631,30 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     HW::Init(*memory);
     Service::Init(*this);
     GDBStub::DeferStart();
+    boot_timer.EndPhase("Services");
 
+    if (VideoCore::g_renderer) {
+        // The renderer outlives loading a state, so that its caches stay warm. The video dumper
+        // and the custom textures it refers to are kept as well.
+        Pica::Init();
+    } else {
 #ifdef ENABLE_FFMPEG_VIDEO_DUMPER
-    video_dumper = std::make_unique<VideoDumper::FFmpegBackend>();
+        video_dumper = std::make_unique<VideoDumper::FFmpegBackend>();
 #else
-    video_dumper = std::make_unique<VideoDumper::NullBackend>();
+        video_dumper = std::make_unique<VideoDumper::NullBackend>();
 #endif
 
-    custom_tex_manager = std::make_unique<VideoCore::CustomTexManager>(*this);
+        custom_tex_manager = std::make_unique<VideoCore::CustomTexManager>(*this);
 
-    VideoCore::ResultStatus result = VideoCore::Init(emu_window, secondary_window, *this);
-    if (result != VideoCore::ResultStatus::Success) {
-        switch (result) {
-        case VideoCore::ResultStatus::ErrorGenericDrivers:
-            return ResultStatus::ErrorVideoCore_ErrorGenericDrivers;
-        default:
-            return ResultStatus::ErrorVideoCore;
+        VideoCore::ResultStatus result = VideoCore::Init(emu_window, secondary_window, *this);
+        boot_timer.EndPhase("Renderer");
+        if (result != VideoCore::ResultStatus::Success) {
+            switch (result) {
+            case VideoCore::ResultStatus::ErrorGenericDrivers:
+                return ResultStatus::ErrorVideoCore_ErrorGenericDrivers;
+            default:
+                return ResultStatus::ErrorVideoCore;
+            }
         }
     }
 
@@ -506,6 +729,10 @@ const VideoDumper::Backend& System::VideoDumper() const {
     return *video_dumper;
 }
 
+RPC::RPCServer& System::RPCServer() {
+    return *rpc_server;
+}
+
 VideoCore::CustomTexManager& System::CustomTexManager() {
     return *custom_tex_manager;
 }
@@ -522,7 +749,59 @@ void System::RegisterSoftwareKeyboard(std::shared_ptr<Frontend::SoftwareKeyboard
     registered_swkbd = std::move(swkbd);
 }
 
+void System::EndCacheInvalidationBatch() {
+    ASSERT(invalidation_batch_depth > 0);
+    if (--invalidation_batch_depth > 0 || pending_invalidations.empty()) {
+        return;
+    }
+
+    std::sort(pending_invalidations.begin(), pending_invalidations.end());
+    u64 start = pending_invalidations.front().first;
+    u64 end = start + pending_invalidations.front().second;
+    const auto invalidate = [this](u64 range_start, u64 range_end) {
+        for (const auto& cpu : cpu_cores) {
+            cpu->InvalidateCacheRange(static_cast<u32>(range_start),
+                                      static_cast<std::size_t>(range_end - range_start));
+        }
+    };
+    for (const auto& [range_start, length] : pending_invalidations) {
+        if (range_start > end) {
+            invalidate(start, end);
+            start = range_start;
+        }
+        end = std::max<u64>(end, range_start + length);
+    }
+    invalidate(start, end);
+    pending_invalidations.clear();
+}
+
+void System::UpdateCpuClock() {
+    if (!clock_scaler || !perf_stats) {
+        return;
+    }
+    // Movies only replay the same way at the clock they were recorded at
+    if (Movie::GetInstance().GetPlayMode() != Movie::PlayMode::None) {
+        LOG_INFO(Core, "Automatic CPU clock disabled for the movie");
+        clock_scaler.reset();
+        timing->UpdateClockSpeed(Settings::values.cpu_clock_percentage.GetValue());
+        return;
+    }
+
+    // The application runs on the first core, the others are mostly idle
+    const auto timer = timing->GetTimer(0);
+    const u32 previous_percentage = clock_scaler->GetPercentage();
+    const u32 percentage = clock_scaler->Update(timer->GetTicks(), timer->GetIdleTicks(),
+                                                perf_stats->GetLastFrameLoad());
+    if (percentage != previous_percentage) {
+        LOG_INFO(Core, "CPU clock changed from {}% to {}%", previous_percentage, percentage);
+    }
+    // Applied every frame, states are loaded with the configured clock
+    timing->UpdateClockSpeed(percentage);
+}
+
 void System::Shutdown(bool is_deserializing) {
+    WaitForPendingSave();
+
     // Log last frame performance stats
     const auto perf_results = GetAndResetPerfStats();
     constexpr auto performance = Common::Telemetry::FieldType::Performance;
@@ -534,21 +813,34 @@ void System::Shutdown(bool is_deserializing) {
     telemetry_session->AddField(performance, "Mean_Frametime_MS",
                                 perf_stats ? perf_stats->GetMeanFrametime() : 0);
 
-    // Shutdown emulation session
-    VideoCore::Shutdown();
+    // Let asynchronous HLE requests finish while the services they use are still around
+    if (kernel) {
+        kernel->WaitForHLEWorkers();
+    }
+
+    // Shutdown emulation session, the GPU thread may still use the renderer. Loading a state
+    // keeps the renderer, its caches and the memory they refer to.
+    GPU::Synchronize();
+    if (!is_deserializing) {
+        VideoCore::Shutdown();
+    }
     HW::Shutdown();
     if (!is_deserializing) {
         GDBStub::Shutdown();
         perf_stats.reset();
         cheat_engine.reset();
         app_loader.reset();
+        delta_state_base.reset();
+        rewind_buffer.reset();
+        clock_scaler.reset();
+        telemetry_session.reset();
     }
-    telemetry_session.reset();
     rpc_server.reset();
     archive_manager.reset();
     service_manager.reset();
     dsp_core.reset();
     kernel.reset();
+    cpu_manager.reset();
     cpu_cores.clear();
     exclusive_monitor.reset();
     timing.reset();
@@ -562,7 +854,9 @@ void System::Shutdown(bool is_deserializing) {
         room_member->SendGameInfo(game_info);
     }
 
-    memory.reset();
+    if (!is_deserializing) {
+        memory.reset();
+    }
 
     if (self_delete_pending)
         FileUtil::Delete(m_filepath);
@@ -608,6 +902,24 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
     }
     ar& num_cores;
 
+    // Service modules that are initialized on first use have to exist before their timing events
+    // and kernel objects are loaded. Older states were made with every module initialized.
+    std::vector<std::string> lazy_modules;
+    if (Archive::is_saving::value) {
+        lazy_modules = service_manager->GetInitializedLazyModules();
+    }
+    if (file_version >= 2) {
+        ar& lazy_modules;
+    } else {
+        for (const auto& service_module : Service::service_module_map) {
+            lazy_modules.push_back(service_module.name);
+        }
+    }
+
+    // Flush on save, don't flush on load. The surfaces that still match guest memory once the
+    // state is done are kept.
+    Memory::RasterizerSuspendCaches(Archive::is_saving::value);
+
     if (Archive::is_loading::value) {
         // When loading, we want to make sure any lingering state gets cleared out before we begin.
         // Shutdown, but persist a few things between loads...
@@ -618,11 +930,9 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         auto n3ds_mode = this->app_loader->LoadKernelN3dsMode();
         [[maybe_unused]] const System::ResultStatus result = Init(
             *m_emu_window, m_secondary_window, *system_mode.first, *n3ds_mode.first, num_cores);
+        service_manager->InitializeLazyModules(lazy_modules);
     }
 
-    // flush on save, don't flush on load
-    bool should_flush = !Archive::is_loading::value;
-    Memory::RasterizerClearAll(should_flush);
     ar&* timing.get();
     for (u32 i = 0; i < num_cores; i++) {
         ar&* cpu_cores[i].get();
@@ -641,6 +951,7 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         throw std::runtime_error("LLE audio not supported for save states");
     }
 
+    memory->SetSerializeFCRAM(!exclude_fcram_from_state);
     ar&* memory.get();
     ar&* kernel.get();
     VideoCore::serialize(ar, file_version);
@@ -656,6 +967,11 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         cheat_engine->Connect();
         VideoCore::g_renderer->Sync();
     }
+
+    // States without FCRAM resume the caches once their FCRAM was restored
+    if (Archive::is_saving::value || !exclude_fcram_from_state) {
+        Memory::RasterizerResumeCaches();
+    }
 }
 
 SERIALIZE_IMPL(System)
@@ -4,11 +4,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iosfwd>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 #include <boost/serialization/version.hpp>
 #include "common/common_types.h"
+#include "core/arm/jit_profile.h"
 #include "core/frontend/applets/mii_selector.h"
 #include "core/frontend/applets/swkbd.h"
 #include "core/loader/loader.h"
@@ -16,8 +24,16 @@
 #include "core/perf_stats.h"
 #include "core/telemetry_session.h"
 
+namespace boost::archive {
+class binary_iarchive;
+}
+
 class ARM_Interface;
 
+namespace FileUtil {
+class IOFile;
+}
+
 namespace Frontend {
 class EmuWindow;
 }
@@ -62,8 +78,13 @@ class RendererBase;
 
 namespace Core {
 
+class ClockScaler;
+class CpuManager;
 class ExclusiveMonitor;
+class RewindBuffer;
 class Timing;
+struct DeltaStateBase;
+struct SerializedState;
 
 class System {
 public:
@@ -122,7 +143,7 @@ public:
     /// Shutdown and then load again
     void Reset();
 
-    enum class Signal : u32 { None, Shutdown, Reset, Save, Load };
+    enum class Signal : u32 { None, Shutdown, Reset, Save, Load, Rewind };
 
     bool SendSignal(Signal signal, u32 param = 0);
 
@@ -159,6 +180,29 @@ public:
         ;
     }
 
+    /**
+     * Makes the emulation run without presenting frames, outputting audio or limiting its speed.
+     * Used to quickly re-simulate frames after restoring an earlier state, the emulated system
+     * itself behaves exactly the same.
+     * @param resimulating Whether the output should be suppressed
+     */
+    void SetResimulating(bool resimulating_) {
+        resimulating = resimulating_;
+    }
+
+    /// Returns true while frames are re-simulated with the output suppressed
+    [[nodiscard]] bool IsResimulating() const {
+        return resimulating;
+    }
+
+    /// Adjusts the CPU clock when it is chosen automatically, called at every presented frame
+    void UpdateCpuClock();
+
+    /// Returns the optimizations the CPU JIT is built with for the loaded title
+    [[nodiscard]] const JitProfile& GetJitProfile() const {
+        return jit_profile;
+    }
+
     /**
      * Returns a reference to the telemetry session for this emulation session.
      * @returns Reference to the telemetry session.
@@ -170,8 +214,20 @@ public:
     /// Prepare the core emulation for a reschedule
     void PrepareReschedule();
 
+    /**
+     * Acquires the HLE lock for the calling host thread. When the cores are running in parallel
+     * this also makes the core owned by the calling thread the running core, so that kernel state
+     * lookups resolve against the caller.
+     */
+    [[nodiscard]] std::unique_lock<std::recursive_mutex> LockHLE();
+
     [[nodiscard]] PerfStats::Results GetAndResetPerfStats();
 
+    /// Returns the performance statistics of the running title, or nullptr if there is none
+    [[nodiscard]] PerfStats* GetPerfStats() {
+        return perf_stats.get();
+    }
+
     /**
      * Gets a reference to the emulated CPU.
      * @returns A reference to the emulated CPU.
@@ -196,11 +252,26 @@ public:
     }
 
     void InvalidateCacheRange(u32 start_address, std::size_t length) {
+        if (invalidation_batch_depth > 0) {
+            pending_invalidations.emplace_back(start_address, length);
+            return;
+        }
         for (const auto& cpu : cpu_cores) {
             cpu->InvalidateCacheRange(start_address, length);
         }
     }
 
+    /**
+     * Defers the InvalidateCacheRange calls until the matching EndCacheInvalidationBatch, which
+     * merges the ranges and invalidates each of them once. Used by HLE code that patches guest code
+     * one word at a time. Batches may be nested.
+     */
+    void BeginCacheInvalidationBatch() {
+        invalidation_batch_depth++;
+    }
+
+    void EndCacheInvalidationBatch();
+
     /**
      * Gets a reference to the emulated DSP.
      * @returns A reference to the emulated DSP.
@@ -265,6 +336,9 @@ public:
     /// Gets a reference to the video dumper backend
     [[nodiscard]] VideoDumper::Backend& VideoDumper();
 
+    /// Gets a reference to the RPC server
+    [[nodiscard]] RPC::RPCServer& RPCServer();
+
     /// Gets a const reference to the video dumper backend
     [[nodiscard]] const VideoDumper::Backend& VideoDumper() const;
 
@@ -300,10 +374,37 @@ public:
         return registered_swkbd;
     }
 
+    /**
+     * Saves the state to a slot. The emulation is only paused while the state is captured,
+     * compressing and writing it happens in the background.
+     */
     void SaveState(u32 slot) const;
 
+    /// Waits for the state being written in the background, keeping the error writing it if any
+    void WaitForPendingSave() const;
+
+    /// Returns the error writing a state in the background once the write is done
+    std::optional<std::string> TakePendingSaveError() const;
+
     void LoadState(u32 slot);
 
+    /**
+     * Serializes the emulated system into a stream, the data of the returned state is left empty.
+     * @param base_page_hashes FCRAM page hashes of the state to make a delta state against, or
+     *                         nullptr for a full state.
+     */
+    SerializedState SerializeState(std::ostream& stream,
+                                   const std::vector<u64>* base_page_hashes) const;
+
+    /// Serializes the emulated system into the data of the returned state
+    [[nodiscard]] SerializedState SerializeState(const std::vector<u64>* base_page_hashes) const;
+
+    /// Restores a state from SerializeState. A delta state is applied on top of the running
+    /// system, which has to be in the base state of the delta.
+    void DeserializeState(std::istream& stream, bool is_delta);
+
+    void DeserializeState(std::string data, bool is_delta);
+
     /// Self delete ncch
     bool SetSelfDelete(const std::string& file) {
         if (m_filepath == file) {
@@ -328,6 +429,12 @@ private:
     /// Reschedule the core emulation
     void Reschedule();
 
+    /// Returns true if the next slice can be executed by running every core on its own host thread
+    [[nodiscard]] bool CanRunCoresInParallel() const;
+
+    /// Runs a slice of max_slice ticks on all cores with a current thread at the same time
+    void RunCoresInParallel(s64 max_slice, bool tight_loop);
+
     /// AppLoader used to load the current executing application
     std::unique_ptr<Loader::AppLoader> app_loader;
 
@@ -335,6 +442,10 @@ private:
     std::vector<std::shared_ptr<ARM_Interface>> cpu_cores;
     ARM_Interface* running_core = nullptr;
 
+    /// Host threads for running the ARM11 cores in parallel, only created when enabled
+    std::unique_ptr<CpuManager> cpu_manager;
+    std::vector<ARM_Interface*> parallel_cores;
+
     /// DSP core
     std::unique_ptr<AudioCore::DspInterface> dsp_core;
 
@@ -390,11 +501,62 @@ private:
     Signal current_signal;
     u32 signal_param;
 
+    /// FCRAM page hashes of the last full savestate, which delta savestates are made against
+    mutable std::unique_ptr<DeltaStateBase> delta_state_base;
+    /// Compression and writing of the last savestate saved
+    mutable std::future<void> pending_save;
+    /// Error writing a savestate, until it is reported by RunLoop
+    mutable std::optional<std::string> pending_save_error;
+    /// Set while serializing a state that stores FCRAM outside of the archive
+    mutable bool exclude_fcram_from_state = false;
+
+    /// Set while frames are re-simulated, read by the video and audio output
+    std::atomic<bool> resimulating = false;
+
+    u32 invalidation_batch_depth = 0;
+    /// Start and length of the ranges invalidated within the current batch
+    std::vector<std::pair<u32, std::size_t>> pending_invalidations;
+
+    /// Recent states to rewind to, when rewinding is enabled
+    std::unique_ptr<RewindBuffer> rewind_buffer;
+    /// Emulated time of the last state pushed to the rewind buffer
+    std::chrono::microseconds last_rewind_capture{};
+
+    /// Picks the CPU clock when auto_cpu_clock is enabled
+    std::unique_ptr<ClockScaler> clock_scaler;
+
+    JitProfile jit_profile;
+
+    /// Loads the payload of a state made of separately compressed sections
+    void LoadSectionedState(FileUtil::IOFile& file, bool is_delta);
+
+    /// Deserializes the system from the archive. For a delta state the FCRAM of its base is kept
+    /// across the restart, the caller then applies the changed pages on top of it.
+    void DeserializeOnBase(boost::archive::binary_iarchive& ia, bool is_delta, bool exclude_fcram);
+
     friend class boost::serialization::access;
     template <typename Archive>
     void serialize(Archive& ar, const unsigned int file_version);
 };
 
+/// Batches the cache invalidations made during its lifetime, see BeginCacheInvalidationBatch
+class ScopedCacheInvalidationBatch {
+public:
+    explicit ScopedCacheInvalidationBatch(System& system_) : system{system_} {
+        system.BeginCacheInvalidationBatch();
+    }
+
+    ~ScopedCacheInvalidationBatch() {
+        system.EndCacheInvalidationBatch();
+    }
+
+    ScopedCacheInvalidationBatch(const ScopedCacheInvalidationBatch&) = delete;
+    ScopedCacheInvalidationBatch& operator=(const ScopedCacheInvalidationBatch&) = delete;
+
+private:
+    System& system;
+};
+
 [[nodiscard]] inline ARM_Interface& GetRunningCore() {
     return System::GetInstance().GetRunningCore();
 }
@@ -413,4 +575,4 @@ private:
 
 } // namespace Core
 
-BOOST_CLASS_VERSION(Core::System, 1)
+BOOST_CLASS_VERSION(Core::System, 2)
@@ -47,67 +47,74 @@ TimingEventType* Timing::RegisterEvent(const std::string& name, TimedCallback ca
     return event_type;
 }
 
-void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type,
-                           std::uintptr_t user_data, std::size_t core_id) {
+Timing::EventHandle Timing::ScheduleEvent(s64 cycles_into_future,
+                                          const TimingEventType* event_type,
+                                          std::uintptr_t user_data, std::size_t core_id) {
     if (event_queue_locked) {
-        return;
+        return {};
     }
 
     ASSERT(event_type != nullptr);
-    Timing::Timer* timer = nullptr;
     if (core_id == std::numeric_limits<std::size_t>::max()) {
-        timer = current_timer;
-    } else {
-        ASSERT(core_id < timers.size());
-        timer = timers.at(core_id).get();
+        const auto itr = std::find_if(timers.begin(), timers.end(), [this](const auto& timer) {
+            return timer.get() == current_timer;
+        });
+        core_id = static_cast<std::size_t>(std::distance(timers.begin(), itr));
     }
+    ASSERT(core_id < timers.size());
+    Timing::Timer* timer = timers[core_id].get();
 
-    s64 timeout = timer->GetTicks() + cycles_into_future;
     if (current_timer == timer) {
+        const s64 timeout = timer->GetTicks() + cycles_into_future;
         // If this event needs to be scheduled before the next advance(), force one early
         if (!timer->is_timer_sane)
             timer->ForceExceptionCheck(cycles_into_future);
 
-        timer->event_queue.emplace_back(
-            Event{timeout, timer->event_fifo_id++, user_data, event_type});
-        std::push_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+        const TimingEventHandle id =
+            timer->event_queue.Push(Event{timeout, timer->event_fifo_id++, user_data, event_type});
+        return {core_id, id};
     } else {
-        timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
-                                   user_data, event_type});
+        // Count the delay from the time of the scheduling core, the other core may only move the
+        // event when its next slice starts
+        const s64 timeout = current_timer->GetTicks() + cycles_into_future;
+        timer->ts_queue.Push(Timer::QueuedEvent{{timeout, 0, user_data, event_type}, false});
+        return {};
     }
 }
 
+void Timing::ScheduleEventThreadsafe(s64 cycles_into_future, const TimingEventType* event_type,
+                                     std::uintptr_t user_data, std::size_t core_id) {
+    ASSERT(event_type != nullptr);
+    ASSERT(core_id < timers.size());
+    timers[core_id]->ts_queue.Push(
+        Timer::QueuedEvent{{cycles_into_future, 0, user_data, event_type}, true});
+}
+
 void Timing::UnscheduleEvent(const TimingEventType* event_type, std::uintptr_t user_data) {
     if (event_queue_locked) {
         return;
     }
     for (auto timer : timers) {
-        auto itr = std::remove_if(
-            timer->event_queue.begin(), timer->event_queue.end(),
+        timer->event_queue.RemoveIf(
             [&](const Event& e) { return e.type == event_type && e.user_data == user_data; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
     }
     // TODO:remove events from ts_queue
 }
 
+void Timing::UnscheduleEvent(const EventHandle& handle) {
+    if (event_queue_locked || !handle.IsValid()) {
+        return;
+    }
+    ASSERT(handle.core_id < timers.size());
+    timers[handle.core_id]->event_queue.Remove(handle.id);
+}
+
 void Timing::RemoveEvent(const TimingEventType* event_type) {
     if (event_queue_locked) {
         return;
     }
     for (auto timer : timers) {
-        auto itr = std::remove_if(timer->event_queue.begin(), timer->event_queue.end(),
-                                  [&](const Event& e) { return e.type == event_type; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        timer->event_queue.RemoveIf([&](const Event& e) { return e.type == event_type; });
     }
     // TODO:remove events from ts_queue
 }
@@ -167,11 +174,18 @@ void Timing::Timer::ForceExceptionCheck(s64 cycles) {
 }
 
 void Timing::Timer::MoveEvents() {
-    for (Event ev; ts_queue.Pop(ev);) {
-        ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    if (ts_queue.Empty()) {
+        return;
     }
+    const s64 ticks = static_cast<s64>(GetTicks());
+    ts_queue.PopAll([this, ticks](QueuedEvent& queued) {
+        Event& ev = queued.event;
+        if (queued.relative) {
+            ev.time += ticks;
+        }
+        ev.fifo_order = event_fifo_id++;
+        event_queue.Push(ev);
+    });
 }
 
 u32 Timing::Timer::StartAdjust() {
@@ -191,10 +205,10 @@ void Timing::Timer::EndAdjust(u32 start_adjust_handle) {
 }
 
 s64 Timing::Timer::GetMaxSliceLength() const {
-    const auto& next_event = event_queue.begin();
-    if (next_event != event_queue.end()) {
-        ASSERT(next_event->time - executed_ticks > 0);
-        return next_event->time - executed_ticks;
+    if (!event_queue.Empty()) {
+        const Event& next_event = event_queue.Top();
+        ASSERT(next_event.time - executed_ticks > 0);
+        return next_event.time - executed_ticks;
     }
     return MAX_SLICE_LENGTH;
 }
@@ -210,10 +224,8 @@ void Timing::Timer::Advance() {
 
     is_timer_sane = true;
 
-    while (!event_queue.empty() && event_queue.front().time <= executed_ticks) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+    while (!event_queue.Empty() && event_queue.Top().time <= executed_ticks) {
+        Event evt = event_queue.Pop();
         if (evt.type->callback != nullptr) {
             evt.type->callback(evt.user_data, static_cast<int>(executed_ticks - evt.time));
         } else {
@@ -228,9 +240,9 @@ void Timing::Timer::SetNextSlice(s64 max_slice_length) {
     slice_length = max_slice_length;
 
     // Still events left (scheduled in the future)
-    if (!event_queue.empty()) {
+    if (!event_queue.Empty()) {
         slice_length = static_cast<int>(
-            std::min<s64>(event_queue.front().time - executed_ticks, max_slice_length));
+            std::min<s64>(event_queue.Top().time - executed_ticks, max_slice_length));
     }
 
     downcount = slice_length;
@@ -17,6 +17,7 @@
  *   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
  */
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <limits>
@@ -29,6 +30,7 @@
 #include "common/logging/log.h"
 #include "common/threadsafe_queue.h"
 #include "core/global.h"
+#include "core/timing_event_queue.h"
 
 // The timing we get from the assembly is 268,111,855.956 Hz
 // It is possible that this number isn't just an integer because the compiler could have
@@ -138,6 +140,16 @@ struct TimingEventType {
 class Timing {
 
 public:
+    /// Identifies a scheduled event so that it can be cancelled without searching for it.
+    struct EventHandle {
+        std::size_t core_id = std::numeric_limits<std::size_t>::max();
+        TimingEventHandle id = INVALID_TIMING_EVENT_HANDLE;
+
+        [[nodiscard]] bool IsValid() const {
+            return id != INVALID_TIMING_EVENT_HANDLE;
+        }
+    };
+
     struct Event {
         s64 time;
         u64 fifo_order;
@@ -210,15 +222,21 @@ public:
 
     private:
         friend class Timing;
-        // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-        // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-        // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-        // accommodated by the standard adaptor class.
-        std::vector<Event> event_queue;
+        // Events are kept in a hierarchical timing wheel, which makes scheduling and cancelling by
+        // handle O(1). HeapEventQueue is the previous binary heap backend, it orders events the
+        // same way and can be swapped in here for comparison.
+        using EventQueue = TimingWheelEventQueue<Event>;
+        EventQueue event_queue;
         u64 event_fifo_id = 0;
         // the queue for storing the events from other threads threadsafe until they will be added
-        // to the event_queue by the emu thread
-        Common::MPSCQueue<Event> ts_queue;
+        // to the event_queue by the emu thread. Events from other cores carry an absolute time,
+        // the time of events from other host threads is relative to the ticks of the timer when
+        // they are moved.
+        struct QueuedEvent {
+            Event event;
+            bool relative;
+        };
+        Common::LockFreeMPSCQueue<QueuedEvent> ts_queue;
         // Are we in a function that has been called from Advance()
         // If events are sheduled from a function that gets called from Advance(),
         // don't change slice_length and downcount.
@@ -246,7 +264,21 @@ public:
             // TODO(SaveState): Remove the next two lines when we break compatibility
             s64 x;
             ar& x; // to keep compatibility with old save states that stored global_timer
-            ar& event_queue;
+            // The events are stored as a vector in the same format as the old binary heap. The
+            // vector is sorted, which is also a valid heap.
+            std::vector<Event> events;
+            if (Archive::is_saving::value) {
+                events.reserve(event_queue.Size());
+                event_queue.ForEach([&events](const Event& event) { events.push_back(event); });
+                std::sort(events.begin(), events.end());
+            }
+            ar& events;
+            if (Archive::is_loading::value) {
+                event_queue.Clear();
+                for (const Event& event : events) {
+                    event_queue.Push(event);
+                }
+            }
             ar& event_fifo_id;
             ar& slice_length;
             ar& downcount;
@@ -265,12 +297,28 @@ public:
      */
     TimingEventType* RegisterEvent(const std::string& name, TimedCallback callback);
 
-    void ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type,
-                       std::uintptr_t user_data = 0,
-                       std::size_t core_id = std::numeric_limits<std::size_t>::max());
+    /**
+     * Schedules an event on the timer of core_id, or the current timer by default.
+     * @returns A handle that can be passed to UnscheduleEvent. Events passed to the timer of
+     * another core from a different thread have no handle.
+     */
+    EventHandle ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type,
+                              std::uintptr_t user_data = 0,
+                              std::size_t core_id = std::numeric_limits<std::size_t>::max());
+
+    /**
+     * Schedules an event from any host thread, e.g. audio, input or network callbacks. The event is
+     * queued without taking a lock and added to the timer of core_id at the start of its next
+     * slice, cycles_into_future is counted from that point.
+     */
+    void ScheduleEventThreadsafe(s64 cycles_into_future, const TimingEventType* event_type,
+                                 std::uintptr_t user_data = 0, std::size_t core_id = 0);
 
     void UnscheduleEvent(const TimingEventType* event_type, std::uintptr_t user_data);
 
+    /// Cancels a scheduled event, does nothing if it has already fired or been cancelled.
+    void UnscheduleEvent(const EventHandle& handle);
+
     /// We only permit one event of each type in the queue at a time.
     void RemoveEvent(const TimingEventType* event_type);
 
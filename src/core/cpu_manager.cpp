@@ -0,0 +1,70 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "common/microprofile.h"
+#include "core/arm/arm_interface.h"
+#include "core/cpu_manager.h"
+
+namespace Core {
+
+static thread_local ARM_Interface* thread_core = nullptr;
+
+CpuManager::CpuManager(std::span<const std::shared_ptr<ARM_Interface>> cores)
+    : workers(cores.size()), start_barrier{cores.size() + 1}, end_barrier{cores.size() + 1} {
+    for (std::size_t i = 0; i < cores.size(); ++i) {
+        workers[i].core = cores[i].get();
+    }
+    threads.reserve(cores.size());
+    for (std::size_t i = 0; i < cores.size(); ++i) {
+        threads.emplace_back([this, i](std::stop_token token) { WorkerLoop(token, i); });
+    }
+}
+
+CpuManager::~CpuManager() {
+    for (auto& thread : threads) {
+        thread.request_stop();
+    }
+    threads.clear();
+}
+
+void CpuManager::RunSlice(std::span<ARM_Interface* const> cores, bool tight_loop_) {
+    tight_loop = tight_loop_;
+    for (auto& worker : workers) {
+        worker.scheduled = std::find(cores.begin(), cores.end(), worker.core) != cores.end();
+    }
+    start_barrier.Sync();
+    end_barrier.Sync();
+}
+
+ARM_Interface* CpuManager::GetThreadCore() {
+    return thread_core;
+}
+
+void CpuManager::WorkerLoop(std::stop_token stop_token, std::size_t index) {
+    const std::string name = fmt::format("CPU core {}", index);
+    Common::SetCurrentThreadName(name.c_str());
+    Common::SetCurrentThreadRole(Common::ThreadRole::Emulation);
+    MicroProfileOnThreadCreate(name.c_str());
+
+    Worker& worker = workers[index];
+    while (start_barrier.Sync(stop_token)) {
+        if (worker.scheduled) {
+            thread_core = worker.core;
+            if (tight_loop) {
+                worker.core->Run();
+            } else {
+                worker.core->Step();
+            }
+            thread_core = nullptr;
+        }
+        if (!end_barrier.Sync(stop_token)) {
+            break;
+        }
+    }
+    MicroProfileOnThreadExit();
+}
+
+} // namespace Core
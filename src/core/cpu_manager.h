@@ -0,0 +1,55 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+
+class ARM_Interface;
+
+namespace Core {
+
+/**
+ * Owns one host thread per emulated ARM11 core and runs a single timing slice on all of them
+ * concurrently. The emu thread remains in charge of slice boundaries: it prepares every core,
+ * calls RunSlice and continues with hardware updates and rescheduling once all cores are done.
+ */
+class CpuManager {
+public:
+    explicit CpuManager(std::span<const std::shared_ptr<ARM_Interface>> cores);
+    ~CpuManager();
+
+    /**
+     * Runs the current slice of each core in cores on its own host thread and blocks until all
+     * of them have finished. The slice length must have already been set on each core timer.
+     * @param tight_loop If false, each core single-steps.
+     */
+    void RunSlice(std::span<ARM_Interface* const> cores, bool tight_loop);
+
+    /// Returns the core executed by the calling host thread, or nullptr for non-core threads.
+    [[nodiscard]] static ARM_Interface* GetThreadCore();
+
+private:
+    void WorkerLoop(std::stop_token stop_token, std::size_t index);
+
+    struct Worker {
+        ARM_Interface* core = nullptr;
+        bool scheduled = false;
+    };
+
+    std::vector<Worker> workers;
+    std::vector<std::jthread> threads;
+    bool tight_loop = true;
+
+    /// Released once by the emu thread to start a slice and once by every worker to end it.
+    Common::Barrier start_barrier;
+    Common::Barrier end_barrier;
+};
+
+} // namespace Core
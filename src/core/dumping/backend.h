@@ -30,7 +30,7 @@ public:
     virtual ~Backend();
     virtual bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) = 0;
     virtual void AddVideoFrame(VideoFrame frame) = 0;
-    virtual void AddAudioFrame(AudioCore::StereoFrame16 frame) = 0;
+    virtual void AddAudioFrame(const AudioCore::StereoFrame16& frame) = 0;
     virtual void AddAudioSample(const std::array<s16, 2>& sample) = 0;
     virtual void StopDumping() = 0;
     virtual bool IsDumping() const = 0;
@@ -45,7 +45,7 @@ public:
         return false;
     }
     void AddVideoFrame(VideoFrame /*frame*/) override {}
-    void AddAudioFrame(AudioCore::StereoFrame16 /*frame*/) override {}
+    void AddAudioFrame(const AudioCore::StereoFrame16& /*frame*/) override {}
     void AddAudioSample(const std::array<s16, 2>& /*sample*/) override {}
     void StopDumping() override {}
     bool IsDumping() const override {
@@ -15,6 +15,7 @@
 #include "video_core/video_core.h"
 
 extern "C" {
+#include <libavutil/hwcontext.h>
 #include <libavutil/pixdesc.h>
 }
 
@@ -133,7 +134,9 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     codec_context->time_base.num = static_cast<int>(GPU::frame_ticks);
     codec_context->time_base.den = static_cast<int>(BASE_CLOCK_RATE_ARM11);
     codec_context->gop_size = 12;
-    codec_context->pix_fmt = codec->pix_fmts ? codec->pix_fmts[0] : AV_PIX_FMT_YUV420P;
+    if (!InitPixelFormat(codec)) {
+        return false;
+    }
     if (format_context->oformat->flags & AVFMT_GLOBALHEADER)
         codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
@@ -160,8 +163,17 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
 
     // Allocate frames
     current_frame.reset(av_frame_alloc());
+    if (hw_frames_context) {
+        hw_frame.reset(av_frame_alloc());
+    }
+
+    // Encoders that take the frames as they are do the color conversion themselves
+    if (sw_pixel_format == pixel_format) {
+        return true;
+    }
+
     scaled_frame.reset(av_frame_alloc());
-    scaled_frame->format = codec_context->pix_fmt;
+    scaled_frame->format = sw_pixel_format;
     scaled_frame->width = layout.width;
     scaled_frame->height = layout.height;
     if (av_frame_get_buffer(scaled_frame.get(), 0) < 0) {
@@ -170,21 +182,112 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     }
 
     // Create SWS Context
-    auto* context = sws_getCachedContext(
-        sws_context.get(), layout.width, layout.height, pixel_format, layout.width, layout.height,
-        codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
+    auto* context = sws_getCachedContext(sws_context.get(), layout.width, layout.height,
+                                         pixel_format, layout.width, layout.height,
+                                         sw_pixel_format, SWS_BICUBIC, nullptr, nullptr, nullptr);
     if (context != sws_context.get())
         sws_context.reset(context);
 
     return true;
 }
 
+bool FFmpegVideoStream::InitPixelFormat(const AVCodec* codec) {
+    if (!codec->pix_fmts) {
+        codec_context->pix_fmt = sw_pixel_format = AV_PIX_FMT_YUV420P;
+        return true;
+    }
+
+    const auto is_hardware = [](AVPixelFormat format) {
+        const AVPixFmtDescriptor* descriptor = av_pix_fmt_desc_get(format);
+        return descriptor && (descriptor->flags & AV_PIX_FMT_FLAG_HWACCEL);
+    };
+
+    // Prefer feeding the frames unconverted, encoders like NVENC convert them on the GPU
+    for (const AVPixelFormat* format = codec->pix_fmts; *format != AV_PIX_FMT_NONE; ++format) {
+        if (*format == pixel_format) {
+            codec_context->pix_fmt = sw_pixel_format = pixel_format;
+            return true;
+        }
+    }
+
+    // Encoders like VAAPI, VideoToolbox and MediaCodec prefer frames in GPU memory
+    const AVPixelFormat preferred_format = codec->pix_fmts[0];
+    if (is_hardware(preferred_format)) {
+        if (InitHWFrames(codec, preferred_format)) {
+            codec_context->pix_fmt = preferred_format;
+            sw_pixel_format = hw_upload_pixel_format;
+            return true;
+        }
+        LOG_WARNING(Render, "Could not set up hardware frames for {}, using software frames",
+                    av_get_pix_fmt_name(preferred_format));
+        hw_frames_context.reset();
+        hw_device_context.reset();
+    }
+
+    for (const AVPixelFormat* format = codec->pix_fmts; *format != AV_PIX_FMT_NONE; ++format) {
+        if (!is_hardware(*format)) {
+            codec_context->pix_fmt = sw_pixel_format = *format;
+            return true;
+        }
+    }
+
+    LOG_ERROR(Render, "Video encoder does not accept any usable pixel format");
+    return false;
+}
+
+bool FFmpegVideoStream::InitHWFrames(const AVCodec* codec, AVPixelFormat hw_pixel_format) {
+    for (int i = 0;; ++i) {
+        const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i);
+        if (!config) {
+            return false;
+        }
+        if (config->pix_fmt != hw_pixel_format ||
+            !(config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_FRAMES_CTX)) {
+            continue;
+        }
+
+        AVBufferRef* device = nullptr;
+        if (av_hwdevice_ctx_create(&device, config->device_type, nullptr, nullptr, 0) < 0) {
+            LOG_ERROR(Render, "Could not create {} device",
+                      av_hwdevice_get_type_name(config->device_type));
+            return false;
+        }
+        hw_device_context.reset(device);
+
+        AVBufferRef* frames = av_hwframe_ctx_alloc(device);
+        if (!frames) {
+            LOG_ERROR(Render, "Could not allocate hardware frames context");
+            return false;
+        }
+        hw_frames_context.reset(frames);
+
+        auto* frames_context = reinterpret_cast<AVHWFramesContext*>(frames->data);
+        frames_context->format = hw_pixel_format;
+        frames_context->sw_format = hw_upload_pixel_format;
+        frames_context->width = static_cast<int>(layout.width);
+        frames_context->height = static_cast<int>(layout.height);
+        frames_context->initial_pool_size = 8;
+        if (av_hwframe_ctx_init(frames) < 0) {
+            LOG_ERROR(Render, "Could not initialize hardware frames context");
+            return false;
+        }
+
+        codec_context->hw_frames_ctx = av_buffer_ref(frames);
+        LOG_INFO(Render, "Uploading video frames to {} for encoding",
+                 av_hwdevice_get_type_name(config->device_type));
+        return true;
+    }
+}
+
 void FFmpegVideoStream::Free() {
     FFmpegStream::Free();
 
     current_frame.reset();
     scaled_frame.reset();
+    hw_frame.reset();
     sws_context.reset();
+    hw_frames_context.reset();
+    hw_device_context.reset();
 }
 
 void FFmpegVideoStream::ProcessFrame(VideoFrame& frame) {
@@ -200,18 +303,37 @@ void FFmpegVideoStream::ProcessFrame(VideoFrame& frame) {
     current_frame->height = layout.height;
 
     // Scale the frame
-    if (av_frame_make_writable(scaled_frame.get()) < 0) {
-        LOG_ERROR(Render, "Video frame dropped: Could not prepare frame");
-        return;
+    AVFrame* encode_frame = current_frame.get();
+    if (scaled_frame) {
+        if (av_frame_make_writable(scaled_frame.get()) < 0) {
+            LOG_ERROR(Render, "Video frame dropped: Could not prepare frame");
+            return;
+        }
+        if (sws_context) {
+            sws_scale(sws_context.get(), current_frame->data, current_frame->linesize, 0,
+                      layout.height, scaled_frame->data, scaled_frame->linesize);
+        }
+        encode_frame = scaled_frame.get();
     }
-    if (sws_context) {
-        sws_scale(sws_context.get(), current_frame->data, current_frame->linesize, 0, layout.height,
-                  scaled_frame->data, scaled_frame->linesize);
+
+    // Upload the frame to the encoder device
+    if (hw_frame) {
+        if (av_hwframe_get_buffer(hw_frames_context.get(), hw_frame.get(), 0) < 0 ||
+            av_hwframe_transfer_data(hw_frame.get(), encode_frame, 0) < 0) {
+            LOG_ERROR(Render, "Video frame dropped: Could not upload frame");
+            av_frame_unref(hw_frame.get());
+            return;
+        }
+        encode_frame = hw_frame.get();
     }
-    scaled_frame->pts = frame_count++;
+    encode_frame->pts = frame_count++;
 
     // Encode frame
-    SendFrame(scaled_frame.get());
+    SendFrame(encode_frame);
+
+    if (hw_frame) {
+        av_frame_unref(hw_frame.get());
+    }
 }
 
 FFmpegAudioStream::~FFmpegAudioStream() {
@@ -301,7 +423,7 @@ bool FFmpegAudioStream::Init(FFmpegMuxer& muxer) {
     auto* context =
         swr_alloc_set_opts(nullptr, codec_context->channel_layout, codec_context->sample_fmt,
                            codec_context->sample_rate, codec_context->channel_layout,
-                           AV_SAMPLE_FMT_S16P, AudioCore::native_sample_rate, 0, nullptr);
+                           AV_SAMPLE_FMT_S16, AudioCore::native_sample_rate, 0, nullptr);
     if (!context) {
         LOG_ERROR(Render, "Could not create SWR context");
         return false;
@@ -336,14 +458,10 @@ void FFmpegAudioStream::Free() {
     av_freep(&resampled_data);
 }
 
-void FFmpegAudioStream::ProcessFrame(const VariableAudioFrame& channel0,
-                                     const VariableAudioFrame& channel1) {
-    ASSERT_MSG(channel0.size() == channel1.size(),
-               "Frames of the two channels must have the same number of samples");
-
+void FFmpegAudioStream::ProcessFrame(AudioSamples samples) {
     const auto sample_size = av_get_bytes_per_sample(codec_context->sample_fmt);
-    std::array<const u8*, 2> src_data = {reinterpret_cast<const u8*>(channel0.data()),
-                                         reinterpret_cast<const u8*>(channel1.data())};
+    // The input is interleaved, so it is a single plane
+    std::array<const u8*, 1> src_data = {reinterpret_cast<const u8*>(samples.data())};
 
     std::array<u8*, 2> dst_data;
     if (av_sample_fmt_is_planar(codec_context->sample_fmt)) {
@@ -354,7 +472,7 @@ void FFmpegAudioStream::ProcessFrame(const VariableAudioFrame& channel0,
     }
 
     auto resampled_count = swr_convert(swr_context.get(), dst_data.data(), frame_size - offset,
-                                       src_data.data(), static_cast<int>(channel0.size()));
+                                       src_data.data(), static_cast<int>(samples.size()));
     if (resampled_count < 0) {
         LOG_ERROR(Render, "Audio frame dropped: Could not resample data");
         return;
@@ -467,9 +585,8 @@ void FFmpegMuxer::ProcessVideoFrame(VideoFrame& frame) {
     video_stream.ProcessFrame(frame);
 }
 
-void FFmpegMuxer::ProcessAudioFrame(const VariableAudioFrame& channel0,
-                                    const VariableAudioFrame& channel1) {
-    audio_stream.ProcessFrame(channel0, channel1);
+void FFmpegMuxer::ProcessAudioFrame(AudioSamples samples) {
+    audio_stream.ProcessFrame(samples);
 }
 
 void FFmpegMuxer::FlushVideo() {
@@ -535,18 +652,32 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
 
     if (audio_processing_thread.joinable())
         audio_processing_thread.join();
+    audio_finished = false;
     audio_processing_thread = std::thread([&] {
-        VariableAudioFrame channel0, channel1;
+        std::vector<std::array<s16, 2>> chunk(audio_samples.Capacity() / 4);
+        const auto process_samples = [&] {
+            const std::size_t count = audio_samples.Pop(chunk.data(), chunk.size());
+            if (count != 0) {
+                audio_samples_popped.Set();
+                ffmpeg.ProcessAudioFrame(AudioSamples{chunk.data(), count});
+            }
+            return count != 0;
+        };
         while (true) {
-            channel0 = audio_frame_queues[0].PopWait();
-            channel1 = audio_frame_queues[1].PopWait();
-            if (channel0.empty()) {
-                // An empty frame marks the end of frame data
+            if (process_samples()) {
+                continue;
+            }
+            if (audio_finished) {
+                // Samples may have been pushed right before dumping stopped
+                while (process_samples()) {
+                }
                 ffmpeg.FlushAudio();
                 break;
             }
-            ffmpeg.ProcessAudioFrame(channel0, channel1);
+            audio_samples_pushed.Wait();
         }
+        // Release a producer still waiting for space
+        audio_samples_popped.Set();
     });
 
     VideoCore::g_renderer->PrepareVideoDumping();
@@ -561,23 +692,24 @@ void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
     event2.Set();
 }
 
-void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
-    std::array<VariableAudioFrame, 2> refactored_frame;
-    for (auto& channel : refactored_frame) {
-        channel.resize(frame.size());
-    }
-    for (std::size_t i = 0; i < frame.size(); i++) {
-        refactored_frame[0][i] = frame[i][0];
-        refactored_frame[1][i] = frame[i][1];
-    }
-
-    audio_frame_queues[0].Push(std::move(refactored_frame[0]));
-    audio_frame_queues[1].Push(std::move(refactored_frame[1]));
+void FFmpegBackend::AddAudioFrame(const AudioCore::StereoFrame16& frame) {
+    PushAudioSamples(frame);
 }
 
 void FFmpegBackend::AddAudioSample(const std::array<s16, 2>& sample) {
-    audio_frame_queues[0].Push(VariableAudioFrame{sample[0]});
-    audio_frame_queues[1].Push(VariableAudioFrame{sample[1]});
+    PushAudioSamples(AudioSamples{&sample, 1});
+}
+
+void FFmpegBackend::PushAudioSamples(AudioSamples samples) {
+    while (true) {
+        const std::size_t pushed = audio_samples.Push(samples.data(), samples.size());
+        audio_samples_pushed.Set();
+        samples = samples.subspan(pushed);
+        if (samples.empty() || !IsDumping()) {
+            return;
+        }
+        audio_samples_popped.Wait();
+    }
 }
 
 void FFmpegBackend::StopDumping() {
@@ -586,10 +718,9 @@ void FFmpegBackend::StopDumping() {
 
     // Flush the video processing queue
     AddVideoFrame(VideoFrame());
-    for (auto i : {0, 1}) {
-        // Flush the audio processing queue
-        audio_frame_queues[i].Push(VariableAudioFrame());
-    }
+    // Flush the audio processing queue
+    audio_finished = true;
+    audio_samples_pushed.Set();
     // Wait until processing ends
     processing_ended.Wait();
 }
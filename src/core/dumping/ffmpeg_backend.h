@@ -10,11 +10,12 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <span>
 #include <thread>
 #include <vector>
 #include "common/common_types.h"
+#include "common/ring_buffer.h"
 #include "common/thread.h"
-#include "common/threadsafe_queue.h"
 #include "core/dumping/backend.h"
 
 extern "C" {
@@ -27,7 +28,8 @@ extern "C" {
 
 namespace VideoDumper {
 
-using VariableAudioFrame = std::vector<s16>;
+/// Interleaved stereo samples at the native sample rate
+using AudioSamples = std::span<const std::array<s16, 2>>;
 
 void InitFFmpegLibraries();
 
@@ -86,15 +88,35 @@ private:
         }
     };
 
+    struct AVBufferRefDeleter {
+        void operator()(AVBufferRef* buffer) const {
+            av_buffer_unref(&buffer);
+        }
+    };
+
+    /// Picks the pixel format the encoder is fed with and sets up hardware frames if needed
+    bool InitPixelFormat(const AVCodec* codec);
+
+    /// Creates the hardware device and frames contexts of an encoder taking hw_pixel_format
+    bool InitHWFrames(const AVCodec* codec, AVPixelFormat hw_pixel_format);
+
     u64 frame_count{};
 
     std::unique_ptr<AVFrame, AVFrameDeleter> current_frame{};
     std::unique_ptr<AVFrame, AVFrameDeleter> scaled_frame{};
+    std::unique_ptr<AVFrame, AVFrameDeleter> hw_frame{};
     std::unique_ptr<SwsContext, SwsContextDeleter> sws_context{};
+    std::unique_ptr<AVBufferRef, AVBufferRefDeleter> hw_device_context{};
+    std::unique_ptr<AVBufferRef, AVBufferRefDeleter> hw_frames_context{};
     Layout::FramebufferLayout layout;
 
+    /// The software pixel format frames are converted to before encoding or uploading
+    AVPixelFormat sw_pixel_format{AV_PIX_FMT_NONE};
+
     /// The pixel format the frames are stored in
     static constexpr AVPixelFormat pixel_format = AVPixelFormat::AV_PIX_FMT_BGRA;
+    /// The pixel format frames are uploaded to hardware frames in, supported by all hw encoders
+    static constexpr AVPixelFormat hw_upload_pixel_format = AVPixelFormat::AV_PIX_FMT_NV12;
 };
 
 /**
@@ -108,7 +130,7 @@ public:
 
     bool Init(FFmpegMuxer& muxer);
     void Free();
-    void ProcessFrame(const VariableAudioFrame& channel0, const VariableAudioFrame& channel1);
+    void ProcessFrame(AudioSamples samples);
     void Flush();
 
 private:
@@ -139,7 +161,7 @@ public:
     bool Init(const std::string& path, const Layout::FramebufferLayout& layout);
     void Free();
     void ProcessVideoFrame(VideoFrame& frame);
-    void ProcessAudioFrame(const VariableAudioFrame& channel0, const VariableAudioFrame& channel1);
+    void ProcessAudioFrame(AudioSamples samples);
     void FlushVideo();
     void FlushAudio();
     void WriteTrailer();
@@ -170,7 +192,7 @@ public:
     ~FFmpegBackend() override;
     bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) override;
     void AddVideoFrame(VideoFrame frame) override;
-    void AddAudioFrame(AudioCore::StereoFrame16 frame) override;
+    void AddAudioFrame(const AudioCore::StereoFrame16& frame) override;
     void AddAudioSample(const std::array<s16, 2>& sample) override;
     void StopDumping() override;
     bool IsDumping() const override;
@@ -178,6 +200,7 @@ public:
 
 private:
     void EndDumping();
+    void PushAudioSamples(AudioSamples samples);
 
     std::atomic_bool is_dumping = false; ///< Whether the backend is currently dumping
 
@@ -189,7 +212,12 @@ private:
     Common::Event event1, event2;
     std::thread video_processing_thread;
 
-    std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
+    /// Samples waiting to be encoded, copied once from the DSP output. When the encoder falls
+    /// behind the DSP waits for space rather than dropping audio.
+    Common::RingBuffer<s16, 0x4000, 2> audio_samples;
+    Common::Event audio_samples_pushed;
+    Common::Event audio_samples_popped;
+    std::atomic_bool audio_finished = false;
     std::thread audio_processing_thread;
 
     Common::Event processing_ended;
@@ -97,6 +97,7 @@ ResultVal<std::unique_ptr<FileBackend>> SDMCArchive::OpenFileBase(const Path& pa
             return ERROR_NOT_FOUND;
         } else {
             // Create the file
+            DiskDirectory::InvalidateCache();
             FileUtil::CreateEmptyFile(full_path);
         }
         break;
@@ -141,6 +142,7 @@ ResultCode SDMCArchive::DeleteFile(const Path& path) const {
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::Delete(full_path)) {
         return RESULT_SUCCESS;
     }
@@ -168,6 +170,7 @@ ResultCode SDMCArchive::RenameFile(const Path& src_path, const Path& dest_path)
     const auto src_path_full = path_parser_src.BuildHostPath(mount_point);
     const auto dest_path_full = path_parser_dest.BuildHostPath(mount_point);
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::Rename(src_path_full, dest_path_full)) {
         return RESULT_SUCCESS;
     }
@@ -209,6 +212,7 @@ static ResultCode DeleteDirectoryHelper(const Path& path, const std::string& mou
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (deleter(full_path)) {
         return RESULT_SUCCESS;
     }
@@ -254,6 +258,7 @@ ResultCode SDMCArchive::CreateFile(const FileSys::Path& path, u64 size) const {
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (size == 0) {
         FileUtil::CreateEmptyFile(full_path);
         return RESULT_SUCCESS;
@@ -297,6 +302,7 @@ ResultCode SDMCArchive::CreateDirectory(const Path& path) const {
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::CreateDir(mount_point + path.AsString())) {
         return RESULT_SUCCESS;
     }
@@ -325,6 +331,7 @@ ResultCode SDMCArchive::RenameDirectory(const Path& src_path, const Path& dest_p
     const auto src_path_full = path_parser_src.BuildHostPath(mount_point);
     const auto dest_path_full = path_parser_dest.BuildHostPath(mount_point);
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::Rename(src_path_full, dest_path_full)) {
         return RESULT_SUCCESS;
     }
@@ -4,7 +4,11 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "common/archives.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
@@ -20,13 +24,76 @@ SERIALIZE_EXPORT_IMPL(FileSys::DiskDirectory)
 
 namespace FileSys {
 
+struct DiskFile::PendingWrites {
+    std::mutex mutex;
+    /// Pending writes by offset, they never overlap or touch each other
+    std::map<u64, std::vector<u8>> ranges;
+    std::size_t bytes = 0;
+};
+
+DiskFile::DiskFile() = default;
+
+DiskFile::DiskFile(FileUtil::IOFile&& file_, const Mode& mode_,
+                   std::unique_ptr<DelayGenerator> delay_generator_)
+    : file(new FileUtil::IOFile(std::move(file_))),
+      pending(AcquirePendingWrites(file->GetFilename())) {
+    delay_generator = std::move(delay_generator_);
+    mode.hex = mode_.hex;
+}
+
+DiskFile::~DiskFile() {
+    Commit();
+}
+
+std::shared_ptr<DiskFile::PendingWrites> DiskFile::AcquirePendingWrites(const std::string& path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<PendingWrites>> files;
+
+    std::scoped_lock lock{mutex};
+    std::erase_if(files, [](const auto& item) { return item.second.expired(); });
+    std::weak_ptr<PendingWrites>& entry = files[path];
+    std::shared_ptr<PendingWrites> writes = entry.lock();
+    if (!writes) {
+        writes = std::make_shared<PendingWrites>();
+        entry = writes;
+    }
+    return writes;
+}
+
 ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length,
                                       u8* buffer) const {
     if (!mode.read_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
+    std::scoped_lock lock{pending->mutex};
     file->Seek(offset, SEEK_SET);
-    return MakeResult<std::size_t>(file->ReadBytes(buffer, length));
+    const std::size_t read = file->ReadBytes(buffer, length);
+    if (pending->ranges.empty()) {
+        return MakeResult<std::size_t>(read);
+    }
+
+    // Pending writes may extend the file, past the host file the data reads as zeroes like it will
+    // once written
+    const u64 size = GetSizeLocked();
+    const std::size_t total = offset < size ? std::min<u64>(length, size - offset) : 0;
+    if (total > read) {
+        std::memset(buffer + read, 0, total - read);
+    }
+
+    const u64 end = offset + total;
+    auto it = pending->ranges.upper_bound(offset);
+    if (it != pending->ranges.begin()) {
+        --it;
+    }
+    for (; it != pending->ranges.end() && it->first < end; ++it) {
+        const u64 start = std::max(offset, it->first);
+        const u64 range_end = std::min<u64>(end, it->first + it->second.size());
+        if (start < range_end) {
+            std::memcpy(buffer + (start - offset), it->second.data() + (start - it->first),
+                        range_end - start);
+        }
+    }
+    return MakeResult<std::size_t>(total);
 }
 
 ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t length, const bool flush,
@@ -34,35 +101,179 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
     if (!mode.write_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
-    file->Seek(offset, SEEK_SET);
-    std::size_t written = file->WriteBytes(buffer, length);
-    if (flush)
-        file->Flush();
-    return MakeResult<std::size_t>(written);
+    std::scoped_lock lock{pending->mutex};
+    auto& ranges = pending->ranges;
+    if (length != 0) {
+        // Extend the range the write starts in or touches, or start a new one
+        const u64 end = offset + length;
+        if (end > GetSizeLocked()) {
+            DiskDirectory::InvalidateCache();
+        }
+        auto it = ranges.upper_bound(offset);
+        if (it != ranges.begin() && std::prev(it)->first + std::prev(it)->second.size() >= offset) {
+            --it;
+        } else {
+            it = ranges.emplace_hint(it, offset, std::vector<u8>{});
+        }
+        const u64 start = it->first;
+        std::vector<u8>& data = it->second;
+        pending->bytes -= data.size();
+        if (data.size() < end - start) {
+            data.resize(end - start);
+        }
+        std::memcpy(data.data() + (offset - start), buffer, length);
+
+        // Absorb the following ranges the write reaches, keeping what they have past its end
+        for (auto next = std::next(it); next != ranges.end() && next->first <= end;) {
+            const u64 next_end = next->first + next->second.size();
+            if (next_end > end) {
+                data.resize(next_end - start);
+                std::memcpy(data.data() + (end - start), next->second.data() + (end - next->first),
+                            next_end - end);
+            }
+            pending->bytes -= next->second.size();
+            next = ranges.erase(next);
+        }
+        pending->bytes += data.size();
+    }
+
+    // The guest is only told about the host failing to take the data when it is written here,
+    // otherwise it learns about it when it flushes or closes the file
+    if ((flush || pending->bytes > MaxDirtyBytes) && !CommitLocked()) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    return MakeResult<std::size_t>(length);
+}
+
+bool DiskFile::Commit() const {
+    std::scoped_lock lock{pending->mutex};
+    return CommitLocked();
+}
+
+bool DiskFile::CommitLocked() const {
+    // Handles that can not write leave the data to the handle that wrote it
+    if (pending->ranges.empty() || !mode.write_flag || !file->IsOpen()) {
+        return true;
+    }
+
+    const u64 host_size = file->GetSize();
+    bool success = true;
+    for (const auto& [offset, data] : pending->ranges) {
+        file->Seek(offset, SEEK_SET);
+        if (file->WriteBytes(data.data(), data.size()) != data.size()) {
+            success = false;
+        }
+    }
+    // The other handles have their own host file buffers, they only see the data once flushed
+    if (!file->Flush()) {
+        success = false;
+    }
+    if (!success) {
+        LOG_ERROR(Service_FS, "Could not write {} bytes of pending data", pending->bytes);
+    }
+    // Listings taken since the writes have the old size, and growing a file does not change the
+    // modification time of its directory
+    if (file->GetSize() != host_size) {
+        DiskDirectory::InvalidateCache();
+    }
+    pending->ranges.clear();
+    pending->bytes = 0;
+    return success;
 }
 
 u64 DiskFile::GetSize() const {
-    return file->GetSize();
+    std::scoped_lock lock{pending->mutex};
+    return GetSizeLocked();
+}
+
+u64 DiskFile::GetSizeLocked() const {
+    const u64 size = file->GetSize();
+    if (pending->ranges.empty()) {
+        return size;
+    }
+    const auto& [offset, data] = *pending->ranges.rbegin();
+    return std::max<u64>(size, offset + data.size());
 }
 
 bool DiskFile::SetSize(const u64 size) const {
-    file->Resize(size);
-    file->Flush();
-    return true;
+    DiskDirectory::InvalidateCache();
+    std::scoped_lock lock{pending->mutex};
+    const bool committed = CommitLocked();
+    const bool resized = file->Resize(size);
+    return file->Flush() && committed && resized;
 }
 
 bool DiskFile::Close() const {
-    return file->Close();
+    std::scoped_lock lock{pending->mutex};
+    const bool committed = CommitLocked();
+    return file->Close() && committed;
+}
+
+bool DiskFile::Flush() const {
+    return Commit();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/// Directories whose listing is kept, the cache starts over when it is full
+constexpr std::size_t MaxCachedDirectories = 64;
+
+struct CachedDirectory {
+    FileUtil::FSTEntry directory;
+    /// Host time of the scan, in seconds since the epoch like modification times
+    s64 scan_time;
+};
+
+struct DirectoryCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, CachedDirectory> directories;
+};
+
+DirectoryCache& GetDirectoryCache() {
+    static DirectoryCache cache;
+    return cache;
+}
+
+} // Anonymous namespace
+
 DiskDirectory::DiskDirectory(const std::string& path) {
-    directory.size = FileUtil::ScanDirectoryTree(path, directory);
-    directory.isDirectory = true;
+    // Modification times only have a resolution of seconds, a listing is only reused when the
+    // directory was last modified before the second it was scanned in
+    const auto status = FileUtil::GetStatus(path);
+    auto& cache = GetDirectoryCache();
+    bool is_cached = false;
+    {
+        std::scoped_lock lock{cache.mutex};
+        const auto it = cache.directories.find(path);
+        if (it != cache.directories.end() && status &&
+            status->modification_time < it->second.scan_time) {
+            directory = it->second.directory;
+            is_cached = true;
+        }
+    }
+
+    if (!is_cached) {
+        const s64 scan_time = static_cast<s64>(std::time(nullptr));
+        directory.size = FileUtil::ScanDirectoryTree(path, directory);
+        directory.isDirectory = true;
+
+        std::scoped_lock lock{cache.mutex};
+        if (cache.directories.size() >= MaxCachedDirectories) {
+            cache.directories.clear();
+        }
+        cache.directories.insert_or_assign(path, CachedDirectory{directory, scan_time});
+    }
     children_iterator = directory.children.begin();
 }
 
+void DiskDirectory::InvalidateCache() {
+    auto& cache = GetDirectoryCache();
+    std::scoped_lock lock{cache.mutex};
+    cache.directories.clear();
+}
+
 u32 DiskDirectory::Read(const u32 count, Entry* entries) {
     u32 entries_read = 0;
 
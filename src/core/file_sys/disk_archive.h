@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,14 +24,22 @@
 
 namespace FileSys {
 
+/**
+ * A file of a host directory backed archive. Writes are kept in memory, merged with the writes
+ * they overlap or touch, and only reach the host file when the guest flushes or closes the file,
+ * when too much data is pending, or before the file is destroyed or serialized. The pending
+ * writes are shared by all open handles of the host file, so each handle reads what the others
+ * wrote.
+ */
 class DiskFile : public FileBackend {
 public:
+    /// Pending data above which writes are written to the host file straight away
+    static constexpr std::size_t MaxDirtyBytes = 0x100000;
+
     DiskFile(FileUtil::IOFile&& file_, const Mode& mode_,
-             std::unique_ptr<DelayGenerator> delay_generator_)
-        : file(new FileUtil::IOFile(std::move(file_))) {
-        delay_generator = std::move(delay_generator_);
-        mode.hex = mode_.hex;
-    }
+             std::unique_ptr<DelayGenerator> delay_generator_);
+
+    ~DiskFile() override;
 
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
@@ -38,31 +47,58 @@ public:
     u64 GetSize() const override;
     bool SetSize(u64 size) const override;
     bool Close() const override;
-
-    void Flush() const override {
-        file->Flush();
-    }
+    bool Flush() const override;
 
 protected:
     Mode mode;
     std::unique_ptr<FileUtil::IOFile> file;
 
 private:
-    DiskFile() = default;
+    struct PendingWrites;
+
+    DiskFile();
+
+    /// Returns the pending writes of the host file at path, shared with its other open handles
+    static std::shared_ptr<PendingWrites> AcquirePendingWrites(const std::string& path);
+
+    /// Writes the pending data to the host file, returns false if it could not be written
+    bool Commit() const;
+
+    /// Like Commit, for callers holding the lock of the pending writes
+    bool CommitLocked() const;
+
+    /// Size including the pending writes, for callers holding the lock of the pending writes
+    u64 GetSizeLocked() const;
+
+    std::shared_ptr<PendingWrites> pending;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        if (Archive::is_saving::value) {
+            Commit();
+        }
         ar& boost::serialization::base_object<FileBackend>(*this);
         ar& mode.hex;
         ar& file;
+        if (Archive::is_loading::value) {
+            pending = AcquirePendingWrites(file->GetFilename());
+        }
     }
     friend class boost::serialization::access;
 };
 
+/**
+ * A directory of a host directory backed archive. Listings are cached, so that opening a directory
+ * again only rescans it when it was changed through an archive or the host directory was modified
+ * since.
+ */
 class DiskDirectory : public DirectoryBackend {
 public:
     explicit DiskDirectory(const std::string& path);
 
+    /// Called by the archives before they change any directory or file size
+    static void InvalidateCache();
+
     ~DiskDirectory() override {
         Close();
     }
@@ -86,8 +86,9 @@ public:
 
     /**
      * Flushes the file
+     * @return true if all data written to the file reached the storage
      */
-    virtual void Flush() const = 0;
+    virtual bool Flush() const = 0;
 
 protected:
     std::unique_ptr<DelayGenerator> delay_generator;
@@ -132,7 +132,9 @@ public:
     bool Close() const override {
         return false;
     }
-    void Flush() const override {}
+    bool Flush() const override {
+        return true;
+    }
 
 private:
     std::shared_ptr<RomFSReader> romfs_file;
@@ -170,7 +172,9 @@ public:
     bool Close() const override {
         return false;
     }
-    void Flush() const override {}
+    bool Flush() const override {
+        return true;
+    }
 
 private:
     std::vector<u8> romfs_file;
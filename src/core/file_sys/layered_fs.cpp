@@ -4,11 +4,16 @@
 
 #include <algorithm>
 #include <cstring>
+#include <ctime>
+#include <sstream>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/vector.hpp>
 #include "common/alignment.h"
 #include "common/archives.h"
 #include "common/assert.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
@@ -54,6 +59,105 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+/// Bump when the layout of LayeredFSIndex changes
+constexpr u32 LayeredFSIndexVersion = 1;
+
+/**
+ * Listings of the replacement directory, saved between boots. A directory whose modification time
+ * did not change still has the same entries, so it does not have to be listed again. The sizes of
+ * the files are always queried, as writing to a file does not touch its directory.
+ */
+struct LayeredFSIndex {
+    struct Entry {
+        std::string name;
+        bool is_directory;
+
+        bool operator==(const Entry&) const = default;
+
+        template <class Archive>
+        void serialize(Archive& ar, const unsigned int) {
+            ar& name;
+            ar& is_directory;
+        }
+    };
+
+    struct Directory {
+        s64 modification_time;
+        std::vector<Entry> entries;
+
+        bool operator==(const Directory&) const = default;
+
+        template <class Archive>
+        void serialize(Archive& ar, const unsigned int) {
+            ar& modification_time;
+            ar& entries;
+        }
+    };
+
+    std::string patch_path;
+    /// Directories modified within the second the index was written may have changed after it
+    s64 index_time{};
+    /// Keyed by the path in the RomFS, with a trailing '/'
+    std::map<std::string, Directory> directories;
+};
+
+static std::string GetIndexPath(const std::string& patch_path) {
+    return fmt::format("{}layered_fs/{:016X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                       Common::ComputeHash64(patch_path.data(), patch_path.size()));
+}
+
+static LayeredFSIndex LoadIndex(const std::string& patch_path) {
+    std::string data;
+    if (FileUtil::ReadFileToString(false, GetIndexPath(patch_path), data) == 0) {
+        return {};
+    }
+
+    LayeredFSIndex index;
+    try {
+        std::istringstream stream{std::move(data), std::ios_base::binary};
+        iarchive ia{stream};
+        u32 version;
+        ia >> version;
+        if (version != LayeredFSIndexVersion) {
+            return {};
+        }
+        ia >> index.patch_path;
+        ia >> index.index_time;
+        ia >> index.directories;
+    } catch (const std::exception& e) {
+        LOG_WARNING(Service_FS, "Could not read the LayeredFS index: {}", e.what());
+        return {};
+    }
+
+    // Guards against hash collisions between mod directories
+    if (index.patch_path != patch_path) {
+        return {};
+    }
+    return index;
+}
+
+static void StoreIndex(const LayeredFSIndex& index) {
+    const std::string path = GetIndexPath(index.patch_path);
+    if (!FileUtil::CreateFullPath(path)) {
+        return;
+    }
+
+    std::ostringstream stream{std::ios_base::binary};
+    {
+        oarchive oa{stream};
+        oa << LayeredFSIndexVersion;
+        oa << index.patch_path;
+        oa << index.index_time;
+        oa << index.directories;
+    }
+    const std::string data = std::move(stream).str();
+    if (FileUtil::WriteStringToFile(false, path, data) != data.size()) {
+        LOG_WARNING(Service_FS, "Could not write the LayeredFS index {}", path);
+        FileUtil::Delete(path);
+    }
+}
+
 LayeredFS::LayeredFS() = default;
 
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
@@ -68,9 +172,17 @@ void LayeredFS::Load() {
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
+    // Read all the metadata at once instead of entry by entry
+    const std::size_t metadata_end =
+        std::max(header.directory_metadata_table.offset + header.directory_metadata_table.length,
+                 header.file_metadata_table.offset + header.file_metadata_table.length);
+    base_metadata.resize(std::min(metadata_end, romfs->GetSize()));
+    base_metadata.resize(romfs->ReadFile(0, base_metadata.size(), base_metadata.data()));
+
     // TODO: is root always the first directory in table?
     root.parent = &root;
     LoadDirectory(root, 0);
+    base_metadata = {};
 
     if (load_relocations) {
         LoadRelocations();
@@ -84,8 +196,7 @@ LayeredFS::~LayeredFS() = default;
 
 u32 LayeredFS::LoadDirectory(Directory& current, u32 offset) {
     DirectoryMetadata metadata;
-    romfs->ReadFile(header.directory_metadata_table.offset + offset, sizeof(metadata),
-                    reinterpret_cast<u8*>(&metadata));
+    ReadBaseMetadata(header.directory_metadata_table.offset + offset, sizeof(metadata), &metadata);
 
     current.name = ReadName(header.directory_metadata_table.offset + offset + sizeof(metadata),
                             metadata.name_length);
@@ -111,8 +222,7 @@ u32 LayeredFS::LoadDirectory(Directory& current, u32 offset) {
 
 u32 LayeredFS::LoadFile(Directory& parent, u32 offset) {
     FileMetadata metadata;
-    romfs->ReadFile(header.file_metadata_table.offset + offset, sizeof(metadata),
-                    reinterpret_cast<u8*>(&metadata));
+    ReadBaseMetadata(header.file_metadata_table.offset + offset, sizeof(metadata), &metadata);
 
     auto file = std::make_unique<File>();
     file->name = ReadName(header.file_metadata_table.offset + offset + sizeof(metadata),
@@ -128,9 +238,17 @@ u32 LayeredFS::LoadFile(Directory& parent, u32 offset) {
     return metadata.next_sibling_offset;
 }
 
+void LayeredFS::ReadBaseMetadata(u32 offset, std::size_t size, void* dest) {
+    if (static_cast<std::size_t>(offset) + size <= base_metadata.size()) {
+        std::memcpy(dest, base_metadata.data() + offset, size);
+    } else {
+        romfs->ReadFile(offset, size, static_cast<u8*>(dest));
+    }
+}
+
 std::string LayeredFS::ReadName(u32 offset, u32 name_length) {
     std::vector<u16_le> buffer(name_length / sizeof(u16_le));
-    romfs->ReadFile(offset, name_length, reinterpret_cast<u8*>(buffer.data()));
+    ReadBaseMetadata(offset, buffer.size() * sizeof(u16_le), buffer.data());
 
     std::u16string name(buffer.size(), 0);
     std::transform(buffer.begin(), buffer.end(), name.begin(), [](u16_le character) {
@@ -144,47 +262,82 @@ void LayeredFS::LoadRelocations() {
         return;
     }
 
-    const FileUtil::DirectoryEntryCallable callback = [this,
-                                                       &callback](u64* /*num_entries_out*/,
-                                                                  const std::string& directory,
-                                                                  const std::string& virtual_name) {
-        auto* parent = directory_path_map.at(directory.substr(patch_path.size() - 1));
+    const LayeredFSIndex old_index = LoadIndex(patch_path);
+    LayeredFSIndex index;
+    index.patch_path = patch_path;
+    index.index_time = static_cast<s64>(std::time(nullptr));
+
+    LoadRelocationDirectory(old_index, index, root);
+
+    if (index.directories != old_index.directories) {
+        StoreIndex(index);
+    }
+}
 
-        if (FileUtil::IsDirectory(directory + virtual_name + DIR_SEP)) {
-            const auto path = (directory + virtual_name + DIR_SEP).substr(patch_path.size() - 1);
+void LayeredFS::LoadRelocationDirectory(const LayeredFSIndex& old_index, LayeredFSIndex& index,
+                                        Directory& current) {
+    // The paths in the RomFS start with '/', patch_path ends with one
+    const std::string directory = patch_path + current.path.substr(1);
+
+    const auto status = FileUtil::GetStatus(directory);
+    const auto cached = old_index.directories.find(current.path);
+    LayeredFSIndex::Directory listing;
+    if (status && cached != old_index.directories.end() &&
+        cached->second.modification_time == status->modification_time &&
+        status->modification_time < old_index.index_time) {
+        listing = cached->second;
+    } else {
+        listing.modification_time = status ? status->modification_time : 0;
+        FileUtil::ForeachDirectoryEntry(
+            nullptr, directory,
+            [&listing](u64* /*num_entries_out*/, const std::string& parent,
+                       const std::string& virtual_name) {
+                const bool is_directory = FileUtil::IsDirectory(parent + virtual_name + DIR_SEP);
+                listing.entries.push_back({virtual_name, is_directory});
+                return true;
+            });
+    }
+
+    for (const auto& entry : listing.entries) {
+        if (entry.is_directory) {
+            const auto path = current.path + entry.name + DIR_SEP;
             if (!directory_path_map.count(path)) { // Add this directory
-                auto directory = std::make_unique<Directory>();
-                directory->name = virtual_name;
-                directory->path = path;
-                directory->parent = parent;
-                directory_path_map.emplace(path, directory.get());
-                parent->directories.emplace_back(std::move(directory));
+                auto child = std::make_unique<Directory>();
+                child->name = entry.name;
+                child->path = path;
+                child->parent = &current;
+                directory_path_map.emplace(path, child.get());
+                current.directories.emplace_back(std::move(child));
                 LOG_INFO(Service_FS, "LayeredFS created directory {}", path);
             }
-            return FileUtil::ForeachDirectoryEntry(nullptr, directory + virtual_name + DIR_SEP,
-                                                   callback);
+            LoadRelocationDirectory(old_index, index, *directory_path_map.at(path));
+            continue;
         }
 
-        const auto path = (directory + virtual_name).substr(patch_path.size() - 1);
+        const auto path = current.path + entry.name;
         if (!file_path_map.count(path)) { // Newly created file
             auto file = std::make_unique<File>();
-            file->name = virtual_name;
+            file->name = entry.name;
             file->path = path;
-            file->parent = parent;
+            file->parent = &current;
             file_path_map.emplace(path, file.get());
-            parent->files.emplace_back(std::move(file));
+            current.files.emplace_back(std::move(file));
             LOG_INFO(Service_FS, "LayeredFS created file {}", path);
         }
 
         auto* file = file_path_map.at(path);
+        const auto file_status = FileUtil::GetStatus(directory + entry.name);
         file->relocation.type = 1;
-        file->relocation.replace_file_path = directory + virtual_name;
-        file->relocation.size = FileUtil::GetSize(directory + virtual_name);
+        file->relocation.replace_file_path = directory + entry.name;
+        file->relocation.size =
+            file_status ? file_status->size : FileUtil::GetSize(directory + entry.name);
         LOG_INFO(Service_FS, "LayeredFS replacement file in use for {}", path);
-        return true;
-    };
+    }
 
-    FileUtil::ForeachDirectoryEntry(nullptr, patch_path, callback);
+    // Directories whose modification time is unknown are always listed
+    if (status) {
+        index.directories.emplace(current.path, std::move(listing));
+    }
 }
 
 void LayeredFS::LoadExtRelocations() {
@@ -329,21 +482,16 @@ void LayeredFS::BuildDirectories() {
     directory_metadata_table.resize(current_directory_offset, 0xFF);
 
     std::size_t written = 0;
-    for (const auto& directory : directory_list) {
+    for (std::size_t i = 0; i < directory_list.size(); i++) {
+        Directory* directory = directory_list[i];
         DirectoryMetadata metadata;
         std::memset(&metadata, 0xFF, sizeof(metadata));
         metadata.parent_directory_offset = directory_metadata_offset_map.at(directory->parent);
 
-        if (directory->parent != directory) {
-            bool flag = false;
-            for (const auto& sibling : directory->parent->directories) {
-                if (flag) {
-                    metadata.next_sibling_offset = directory_metadata_offset_map.at(sibling.get());
-                    break;
-                } else if (sibling.get() == directory) {
-                    flag = true;
-                }
-            }
+        // PrepareBuild lists the children of a directory one after another
+        if (directory->parent != directory && i + 1 < directory_list.size() &&
+            directory_list[i + 1]->parent == directory->parent) {
+            metadata.next_sibling_offset = directory_metadata_offset_map.at(directory_list[i + 1]);
         }
 
         if (!directory->directories.empty()) {
@@ -379,23 +527,16 @@ void LayeredFS::BuildFiles() {
     file_metadata_table.resize(current_file_offset, 0xFF);
 
     std::size_t written = 0;
-    for (const auto& file : file_list) {
+    for (std::size_t i = 0; i < file_list.size(); i++) {
+        File* file = file_list[i];
         FileMetadata metadata;
         std::memset(&metadata, 0xFF, sizeof(metadata));
 
         metadata.parent_directory_offset = directory_metadata_offset_map.at(file->parent);
 
-        bool flag = false;
-        for (const auto& sibling : file->parent->files) {
-            if (sibling->relocation.type == 3) { // removed file
-                continue;
-            }
-            if (flag) {
-                metadata.next_sibling_offset = file_metadata_offset_map.at(sibling.get());
-                break;
-            } else if (sibling.get() == file) {
-                flag = true;
-            }
+        // Like directories, the files of a directory are listed together without removed files
+        if (i + 1 < file_list.size() && file_list[i + 1]->parent == file->parent) {
+            metadata.next_sibling_offset = file_metadata_offset_map.at(file_list[i + 1]);
         }
 
         metadata.file_data_offset = current_data_offset;
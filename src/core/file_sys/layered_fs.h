@@ -33,6 +33,8 @@ struct RomFSHeader {
 };
 static_assert(sizeof(RomFSHeader) == 0x28, "Size of RomFSHeader is not correct");
 
+struct LayeredFSIndex;
+
 /**
  * LayeredFS implementation. This basically adds a layer to another RomFSReader.
  *
@@ -63,6 +65,9 @@ private:
         Directory* parent;
     };
 
+    // Reads from the metadata of the base RomFS, which is held in memory while loading
+    void ReadBaseMetadata(u32 offset, std::size_t size, void* dest);
+
     std::string ReadName(u32 offset, u32 name_length);
 
     // Loads the current directory, then its children.
@@ -76,6 +81,11 @@ private:
     // Load replace/create relocations
     void LoadRelocations();
 
+    // Load the replace/create relocations of a directory, then its children. Directories that did
+    // not change since old_index was written are not listed again.
+    void LoadRelocationDirectory(const LayeredFSIndex& old_index, LayeredFSIndex& index,
+                                 Directory& current);
+
     // Load patch/remove relocations
     void LoadExtRelocations();
 
@@ -106,6 +116,7 @@ private:
     bool load_relocations;
 
     RomFSHeader header;
+    std::vector<u8> base_metadata; // Only held during Load
     Directory root;
     std::unordered_map<std::string, File*> file_path_map;
     std::unordered_map<std::string, Directory*> directory_path_map;
@@ -9,7 +9,9 @@
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/ncch_container.h"
@@ -34,6 +36,23 @@ u64 GetModId(u64 program_id) {
     return program_id;
 }
 
+static std::string GetModsPath(u64 program_id) {
+    return fmt::format("{}mods/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir),
+                       GetModId(program_id));
+}
+
+/// Header of a code cache file, followed by the zstd compressed code
+struct CodeCacheHeader {
+    std::array<u8, 4> magic;
+    u32_le version;
+    u64_le key;
+};
+static_assert(sizeof(CodeCacheHeader) == 16, "CodeCacheHeader should be 16 bytes");
+
+constexpr std::array<u8, 4> code_cache_magic{{'C', 'C', 'O', 'D'}};
+/// Bump when the way the final code is produced changes
+constexpr u32 code_cache_version = 1;
+
 /**
  * Get the decompressed size of an LZSS compressed ExeFS file
  * @param buffer Buffer of compressed file
@@ -114,9 +133,14 @@ static bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decom
     return true;
 }
 
+/// Dumps may be stored in the Zstandard seekable format, they are decompressed as they are read
+static FileUtil::IOFile OpenDumpFile(const std::string& path) {
+    return FileUtil::IOFile(path, "rb", FileUtil::IOFile::DecompressSeekable);
+}
+
 NCCHContainer::NCCHContainer(const std::string& filepath, u32 ncch_offset, u32 partition)
     : ncch_offset(ncch_offset), partition(partition), filepath(filepath) {
-    file = FileUtil::IOFile(filepath, "rb");
+    file = OpenDumpFile(filepath);
 }
 
 Loader::ResultStatus NCCHContainer::OpenFile(const std::string& filepath, u32 ncch_offset,
@@ -124,7 +148,7 @@ Loader::ResultStatus NCCHContainer::OpenFile(const std::string& filepath, u32 nc
     this->filepath = filepath;
     this->ncch_offset = ncch_offset;
     this->partition = partition;
-    file = FileUtil::IOFile(filepath, "rb");
+    file = OpenDumpFile(filepath);
 
     if (!file.IsOpen()) {
         LOG_WARNING(Service_FS, "Failed to open {}", filepath);
@@ -237,49 +261,41 @@ Loader::ResultStatus NCCHContainer::Load() {
                     }
                 }
 
-                SetKeyY(KeySlotID::NCCHSecure1, key_y_primary);
-                if (!IsNormalKeyAvailable(KeySlotID::NCCHSecure1)) {
-                    LOG_ERROR(Service_FS, "Secure1 KeyX missing");
-                    failed_to_decrypt = true;
-                }
-                primary_key = GetNormalKey(KeySlotID::NCCHSecure1);
+                // The key slots are only used to derive the keys here, so they are not modified.
+                // This allows several containers to be loaded at the same time.
+                const auto generate_key = [&failed_to_decrypt](std::size_t slot_id,
+                                                               const AESKey& key_y,
+                                                               const char* name) {
+                    const auto key = GenerateNormalKey(slot_id, key_y);
+                    if (!key) {
+                        LOG_ERROR(Service_FS, "{} KeyX missing", name);
+                        failed_to_decrypt = true;
+                    }
+                    return key.value_or(AESKey{});
+                };
+
+                primary_key = generate_key(KeySlotID::NCCHSecure1, key_y_primary, "Secure1");
 
                 switch (ncch_header.secondary_key_slot) {
                 case 0:
                     LOG_DEBUG(Service_FS, "Secure1 crypto");
-                    SetKeyY(KeySlotID::NCCHSecure1, key_y_secondary);
-                    if (!IsNormalKeyAvailable(KeySlotID::NCCHSecure1)) {
-                        LOG_ERROR(Service_FS, "Secure1 KeyX missing");
-                        failed_to_decrypt = true;
-                    }
-                    secondary_key = GetNormalKey(KeySlotID::NCCHSecure1);
+                    secondary_key =
+                        generate_key(KeySlotID::NCCHSecure1, key_y_secondary, "Secure1");
                     break;
                 case 1:
                     LOG_DEBUG(Service_FS, "Secure2 crypto");
-                    SetKeyY(KeySlotID::NCCHSecure2, key_y_secondary);
-                    if (!IsNormalKeyAvailable(KeySlotID::NCCHSecure2)) {
-                        LOG_ERROR(Service_FS, "Secure2 KeyX missing");
-                        failed_to_decrypt = true;
-                    }
-                    secondary_key = GetNormalKey(KeySlotID::NCCHSecure2);
+                    secondary_key =
+                        generate_key(KeySlotID::NCCHSecure2, key_y_secondary, "Secure2");
                     break;
                 case 10:
                     LOG_DEBUG(Service_FS, "Secure3 crypto");
-                    SetKeyY(KeySlotID::NCCHSecure3, key_y_secondary);
-                    if (!IsNormalKeyAvailable(KeySlotID::NCCHSecure3)) {
-                        LOG_ERROR(Service_FS, "Secure3 KeyX missing");
-                        failed_to_decrypt = true;
-                    }
-                    secondary_key = GetNormalKey(KeySlotID::NCCHSecure3);
+                    secondary_key =
+                        generate_key(KeySlotID::NCCHSecure3, key_y_secondary, "Secure3");
                     break;
                 case 11:
                     LOG_DEBUG(Service_FS, "Secure4 crypto");
-                    SetKeyY(KeySlotID::NCCHSecure4, key_y_secondary);
-                    if (!IsNormalKeyAvailable(KeySlotID::NCCHSecure4)) {
-                        LOG_ERROR(Service_FS, "Secure4 KeyX missing");
-                        failed_to_decrypt = true;
-                    }
-                    secondary_key = GetNormalKey(KeySlotID::NCCHSecure4);
+                    secondary_key =
+                        generate_key(KeySlotID::NCCHSecure4, key_y_secondary, "Secure4");
                     break;
                 }
             }
@@ -430,7 +446,7 @@ Loader::ResultStatus NCCHContainer::Load() {
                     .ProcessData(data, data, sizeof(exefs_header));
             }
 
-            exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_file = OpenDumpFile(filepath);
             has_exefs = true;
         }
 
@@ -467,7 +483,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
             is_tainted = true;
             has_exefs = true;
         } else {
-            exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_file = OpenDumpFile(filepath);
         }
     } else if (FileUtil::Exists(exefsdir_override) && FileUtil::IsDirectory(exefsdir_override)) {
         is_tainted = true;
@@ -514,6 +530,9 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
     // If we don't have any separate files, we'll need a full ExeFS
     if (!exefs_file.IsOpen())
         return Loader::ResultStatus::Error;
+    if (!exefs_mapping.IsOpen()) {
+        exefs_mapping = FileUtil::MappedFile(exefs_file);
+    }
 
     LOG_DEBUG(Service_FS, "{} sections:", kMaxSections);
     // Iterate through the ExeFs archive until we find a section with the specified name...
@@ -529,6 +548,13 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 (section.offset + exefs_offset + sizeof(ExeFs_Header) + ncch_offset);
             exefs_file.Seek(section_offset, SEEK_SET);
 
+            // Points into the mapped file, or is null when the section has to be read
+            const u8* mapped_section = nullptr;
+            const auto mapping = exefs_mapping.GetData();
+            if (static_cast<u64>(section_offset) + section.size <= mapping.size()) {
+                mapped_section = mapping.data() + section_offset;
+            }
+
             std::array<u8, 16> key;
             if (strcmp(section.name, "icon") == 0 || strcmp(section.name, "banner") == 0) {
                 key = primary_key;
@@ -543,25 +569,40 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
                 std::unique_ptr<u8[]> temp_buffer;
-                try {
-                    temp_buffer.reset(new u8[section.size]);
-                } catch (std::bad_alloc&) {
-                    return Loader::ResultStatus::ErrorMemoryAllocationFailed;
-                }
+                const u8* compressed = mapped_section;
+                if (!compressed || is_encrypted) {
+                    try {
+                        temp_buffer.reset(new u8[section.size]);
+                    } catch (std::bad_alloc&) {
+                        return Loader::ResultStatus::ErrorMemoryAllocationFailed;
+                    }
 
-                if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
-                    return Loader::ResultStatus::Error;
+                    if (mapped_section) {
+                        dec.ProcessData(&temp_buffer[0], mapped_section, section.size);
+                    } else {
+                        if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
+                            return Loader::ResultStatus::Error;
 
-                if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                        if (is_encrypted) {
+                            dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                        }
+                    }
+                    compressed = &temp_buffer[0];
                 }
 
                 // Decompress .code section...
-                u32 decompressed_size = LZSS_GetDecompressedSize(&temp_buffer[0], section.size);
+                u32 decompressed_size = LZSS_GetDecompressedSize(compressed, section.size);
                 buffer.resize(decompressed_size);
-                if (!LZSS_Decompress(&temp_buffer[0], section.size, buffer.data(),
-                                     decompressed_size))
+                if (!LZSS_Decompress(compressed, section.size, buffer.data(), decompressed_size))
                     return Loader::ResultStatus::ErrorInvalidFormat;
+            } else if (mapped_section) {
+                // Section is uncompressed and mapped, decrypt it straight into the buffer
+                buffer.resize(section.size);
+                if (is_encrypted) {
+                    dec.ProcessData(buffer.data(), mapped_section, section.size);
+                } else {
+                    std::memcpy(buffer.data(), mapped_section, section.size);
+                }
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
@@ -578,15 +619,13 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
     return Loader::ResultStatus::ErrorNotUsed;
 }
 
-Loader::ResultStatus NCCHContainer::ApplyCodePatch(std::vector<u8>& code) const {
+Loader::ResultStatus NCCHContainer::ReadCodePatch(CodePatch& patch) const {
     struct PatchLocation {
         std::string path;
         bool (*patch_fn)(const std::vector<u8>& patch, std::vector<u8>& code);
     };
 
-    const auto mods_path =
-        fmt::format("{}mods/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir),
-                    GetModId(ncch_header.program_id));
+    const auto mods_path = GetModsPath(ncch_header.program_id);
     const std::array<PatchLocation, 6> patch_paths{{
         {mods_path + "exefs/code.ips", Patch::ApplyIpsPatch},
         {mods_path + "exefs/code.bps", Patch::ApplyBpsPatch},
@@ -601,12 +640,10 @@ Loader::ResultStatus NCCHContainer::ApplyCodePatch(std::vector<u8>& code) const
         if (!file)
             continue;
 
-        std::vector<u8> patch(file.GetSize());
-        if (file.ReadBytes(patch.data(), patch.size()) != patch.size())
-            return Loader::ResultStatus::Error;
-
-        LOG_INFO(Service_FS, "File {} patching code.bin", info.path);
-        if (!info.patch_fn(patch, code))
+        patch.path = info.path;
+        patch.patch_fn = info.patch_fn;
+        patch.data.resize(file.GetSize());
+        if (file.ReadBytes(patch.data.data(), patch.data.size()) != patch.data.size())
             return Loader::ResultStatus::Error;
 
         return Loader::ResultStatus::Success;
@@ -614,6 +651,106 @@ Loader::ResultStatus NCCHContainer::ApplyCodePatch(std::vector<u8>& code) const
     return Loader::ResultStatus::ErrorNotUsed;
 }
 
+Loader::ResultStatus NCCHContainer::ApplyCodePatch(std::vector<u8>& code) const {
+    CodePatch patch;
+    const Loader::ResultStatus result = ReadCodePatch(patch);
+    if (result != Loader::ResultStatus::Success)
+        return result;
+
+    LOG_INFO(Service_FS, "File {} patching code.bin", patch.path);
+    if (!patch.patch_fn(patch.data, code))
+        return Loader::ResultStatus::Error;
+
+    return Loader::ResultStatus::Success;
+}
+
+std::optional<u64> NCCHContainer::GetCodeCacheKey() {
+    if (Load() != Loader::ResultStatus::Success || !has_exefs || is_tainted) {
+        return std::nullopt;
+    }
+    // Plain code is read as fast as the cache would be
+    if (!is_compressed && !is_encrypted) {
+        return std::nullopt;
+    }
+    // Code overridden by LoadOverrideExeFSSection is loaded as is, and never cached
+    const auto mods_path = GetModsPath(ncch_header.program_id);
+    if (FileUtil::Exists(mods_path + "exefs/code.bin") ||
+        FileUtil::Exists(mods_path + "code.bin") ||
+        FileUtil::Exists(filepath + ".exefsdir/code.bin")) {
+        return std::nullopt;
+    }
+
+    // The ExeFS header holds the hash of every section, and the codeset info sizes the .bss
+    u64 key = Common::ComputeStructHash64(exefs_header);
+    key = Common::HashCombine(key, Common::ComputeStructHash64(exheader_header.codeset_info));
+    key = Common::HashCombine(key, ncch_header.program_id);
+
+    CodePatch patch;
+    const Loader::ResultStatus patch_result = ReadCodePatch(patch);
+    if (patch_result == Loader::ResultStatus::Error) {
+        return std::nullopt;
+    }
+    if (patch_result == Loader::ResultStatus::Success) {
+        key = Common::HashCombine(key, Common::ComputeHash64(patch.data.data(), patch.data.size()));
+        key = Common::HashCombine(key, patch.patch_fn == Patch::ApplyBpsPatch);
+    }
+    return key;
+}
+
+std::string NCCHContainer::GetCodeCachePath() const {
+    return fmt::format("{}code/{:016X}.bin", FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                       static_cast<u64>(ncch_header.program_id));
+}
+
+Loader::ResultStatus NCCHContainer::LoadCachedCode(std::vector<u8>& code) {
+    const std::optional<u64> key = GetCodeCacheKey();
+    if (!key) {
+        return Loader::ResultStatus::ErrorNotUsed;
+    }
+
+    FileUtil::IOFile cache_file(GetCodeCachePath(), "rb");
+    CodeCacheHeader header;
+    if (!cache_file || cache_file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != code_cache_magic || header.version != code_cache_version ||
+        header.key != *key) {
+        return Loader::ResultStatus::ErrorNotUsed;
+    }
+
+    std::vector<u8> compressed(cache_file.GetSize() - sizeof(header));
+    if (cache_file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        return Loader::ResultStatus::ErrorNotUsed;
+    }
+    code = Common::Compression::DecompressDataZSTD(compressed);
+    if (code.empty()) {
+        return Loader::ResultStatus::ErrorNotUsed;
+    }
+    LOG_INFO(Service_FS, "Loaded code of {:016X} from the code cache",
+             static_cast<u64>(ncch_header.program_id));
+    return Loader::ResultStatus::Success;
+}
+
+void NCCHContainer::StoreCachedCode(const std::vector<u8>& code) {
+    const std::optional<u64> key = GetCodeCacheKey();
+    if (!key) {
+        return;
+    }
+
+    const std::string path = GetCodeCachePath();
+    const auto compressed = Common::Compression::CompressDataZSTDDefault(code.data(), code.size());
+    if (compressed.empty() || !FileUtil::CreateFullPath(path)) {
+        return;
+    }
+
+    const CodeCacheHeader header{code_cache_magic, code_cache_version, *key};
+    FileUtil::IOFile cache_file(path, "wb");
+    if (!cache_file || cache_file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
+        cache_file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_WARNING(Service_FS, "Could not write the code cache file {}", path);
+        cache_file.Close();
+        FileUtil::Delete(path);
+    }
+}
+
 Loader::ResultStatus NCCHContainer::LoadOverrideExeFSSection(const char* name,
                                                              std::vector<u8>& buffer) {
     std::string override_name;
@@ -630,9 +767,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrideExeFSSection(const char* name,
     else
         return Loader::ResultStatus::Error;
 
-    const auto mods_path =
-        fmt::format("{}mods/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir),
-                    GetModId(ncch_header.program_id));
+    const auto mods_path = GetModsPath(ncch_header.program_id);
     const std::array<std::string, 3> override_paths{{
         mods_path + "exefs/" + override_name,
         mods_path + override_name,
@@ -683,7 +818,7 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<RomFSReader>& romf
         return Loader::ResultStatus::Error;
 
     // We reopen the file, to allow its position to be independent from file's
-    FileUtil::IOFile romfs_file_inner(filepath, "rb");
+    FileUtil::IOFile romfs_file_inner = OpenDumpFile(filepath);
     if (!romfs_file_inner.IsOpen())
         return Loader::ResultStatus::Error;
 
@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include "common/bit_field.h"
@@ -323,6 +324,19 @@ public:
      */
     Loader::ResultStatus ApplyCodePatch(std::vector<u8>& code) const;
 
+    /**
+     * Load the .code section with .bss allocated and patches applied from the code cache. Only
+     * code that is encrypted or compressed in the container is cached.
+     * @return ResultStatus success if the cached code is up to date, ErrorNotUsed otherwise
+     */
+    Loader::ResultStatus LoadCachedCode(std::vector<u8>& code);
+
+    /**
+     * Store the final .code section for LoadCachedCode, after allocating .bss and patching.
+     * @param code The code to store
+     */
+    void StoreCachedCode(const std::vector<u8>& code);
+
     /**
      * Checks whether the NCCH container contains an ExeFS
      * @return bool check result
@@ -370,6 +384,22 @@ private:
     std::string filepath;
     FileUtil::IOFile file;
     FileUtil::IOFile exefs_file;
+    /// Mapped on the first section load, sections are decrypted straight out of it
+    FileUtil::MappedFile exefs_mapping;
+
+    struct CodePatch {
+        std::string path;
+        std::vector<u8> data;
+        bool (*patch_fn)(const std::vector<u8>& patch, std::vector<u8>& code);
+    };
+
+    /// Reads the first .code patch found, returns ErrorNotUsed if there is none
+    Loader::ResultStatus ReadCodePatch(CodePatch& patch) const;
+
+    /// Hash of everything the final .code section is made from, std::nullopt if it is not cached
+    std::optional<u64> GetCodeCacheKey();
+
+    std::string GetCodeCachePath() const;
 };
 
 } // namespace FileSys
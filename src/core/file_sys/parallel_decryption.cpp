@@ -0,0 +1,144 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/file_util.h"
+#include "common/thread_worker.h"
+#include "core/file_sys/parallel_decryption.h"
+
+namespace FileSys {
+
+/// Size of the pieces handed to the workers, and of the reads the decryption overlaps with
+constexpr std::size_t ChunkSize = 0x40000;
+
+/// Shared by all users, nullptr when the host has few cores
+static Common::ThreadWorker* GetWorkers() {
+    // Crypto++ uses AES-NI or the ARMv8 crypto extensions itself, so every core decrypts at several
+    // GB/s and a few threads already outrun the storage
+    static const std::unique_ptr<Common::ThreadWorker> workers =
+        []() -> std::unique_ptr<Common::ThreadWorker> {
+        const u32 num_workers =
+            Common::GetWorkerThreadCount(std::min(std::thread::hardware_concurrency() / 2, 4U));
+        if (num_workers == 0) {
+            return nullptr;
+        }
+        return std::make_unique<Common::ThreadWorker>(num_workers, "AES decryption");
+    }();
+    return workers.get();
+}
+
+static void DecryptCTR(const std::array<u8, 16>& key, const std::array<u8, 16>& ctr, u64 offset,
+                       const u8* source, u8* dest, std::size_t size) {
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption decryption(key.data(), key.size(), ctr.data());
+    decryption.Seek(offset);
+    decryption.ProcessData(dest, source, size);
+}
+
+void DecryptCTRParallel(const std::array<u8, 16>& key, const std::array<u8, 16>& ctr, u64 offset,
+                        const u8* source, u8* dest, std::size_t size) {
+    Common::ThreadWorker* workers = GetWorkers();
+    if (!workers || size < ParallelDecryptionThreshold) {
+        DecryptCTR(key, ctr, offset, source, dest, size);
+        return;
+    }
+
+    const std::size_t num_chunks = (size + ChunkSize - 1) / ChunkSize;
+    std::latch done{static_cast<std::ptrdiff_t>(num_chunks)};
+    for (std::size_t start = 0; start < size; start += ChunkSize) {
+        const std::size_t length = std::min(ChunkSize, size - start);
+        workers->QueueWork([&, start, length] {
+            DecryptCTR(key, ctr, offset + start, source + start, dest + start, length);
+            done.count_down();
+        });
+    }
+    done.wait();
+}
+
+std::size_t ReadDecryptCTRParallel(FileUtil::IOFile& file, const std::array<u8, 16>& key,
+                                   const std::array<u8, 16>& ctr, u64 offset, u8* dest,
+                                   std::size_t size) {
+    Common::ThreadWorker* workers = GetWorkers();
+    if (!workers || size < ParallelDecryptionThreshold) {
+        const std::size_t read_length = file.ReadBytes(dest, size);
+        if (read_length != 0) {
+            DecryptCTR(key, ctr, offset, dest, dest, read_length);
+        }
+        return read_length;
+    }
+
+    const std::size_t num_chunks = (size + ChunkSize - 1) / ChunkSize;
+    std::latch done{static_cast<std::ptrdiff_t>(num_chunks)};
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        const std::size_t start = i * ChunkSize;
+        const std::size_t length = std::min(ChunkSize, size - start);
+        const std::size_t read_length = file.ReadBytes(dest + start, length);
+        total += read_length;
+        workers->QueueWork([&, start, read_length] {
+            if (read_length != 0) {
+                DecryptCTR(key, ctr, offset + start, dest + start, dest + start, read_length);
+            }
+            done.count_down();
+        });
+        if (read_length != length) {
+            // Nothing follows the end of the file, the remaining chunks have no work
+            done.count_down(static_cast<std::ptrdiff_t>(num_chunks - i - 1));
+            break;
+        }
+    }
+    done.wait();
+    return total;
+}
+
+void DecryptCBCParallel(const std::array<u8, 16>& key, std::array<u8, 16>& iv, const u8* source,
+                        u8* dest, std::size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    const auto decrypt = [&key](const u8* chunk_iv, const u8* chunk_source, u8* chunk_dest,
+                                std::size_t length) {
+        CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption decryption(key.data(), key.size(),
+                                                                 chunk_iv);
+        decryption.ProcessData(chunk_dest, chunk_source, length);
+    };
+
+    // The IVs of the chunks are ciphertext, so they are copied before an in place decryption
+    // overwrites them
+    const std::size_t num_chunks = (size + ChunkSize - 1) / ChunkSize;
+    std::vector<std::array<u8, 16>> ivs(num_chunks + 1);
+    ivs[0] = iv;
+    for (std::size_t i = 1; i < num_chunks; i++) {
+        std::memcpy(ivs[i].data(), source + i * ChunkSize - ivs[i].size(), ivs[i].size());
+    }
+    std::memcpy(ivs[num_chunks].data(), source + size - iv.size(), iv.size());
+
+    Common::ThreadWorker* workers = GetWorkers();
+    if (!workers || size < ParallelDecryptionThreshold) {
+        decrypt(ivs[0].data(), source, dest, size);
+        iv = ivs[num_chunks];
+        return;
+    }
+
+    std::latch done{static_cast<std::ptrdiff_t>(num_chunks)};
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        const std::size_t start = i * ChunkSize;
+        const std::size_t length = std::min(ChunkSize, size - start);
+        workers->QueueWork([&, i, start, length] {
+            decrypt(ivs[i].data(), source + start, dest + start, length);
+            done.count_down();
+        });
+    }
+    done.wait();
+    iv = ivs[num_chunks];
+}
+
+} // namespace FileSys
@@ -0,0 +1,44 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace FileUtil {
+class IOFile;
+}
+
+namespace FileSys {
+
+/// Ranges smaller than this are not worth splitting over several threads
+constexpr std::size_t ParallelDecryptionThreshold = 0x100000;
+
+/**
+ * Decrypts an AES-CTR range, starting at byte offset of the keystream. Large ranges are split in
+ * chunks that are decrypted on worker threads. dest may be the same as source.
+ */
+void DecryptCTRParallel(const std::array<u8, 16>& key, const std::array<u8, 16>& ctr, u64 offset,
+                        const u8* source, u8* dest, std::size_t size);
+
+/**
+ * Reads size bytes from the current position of the file and decrypts them like
+ * DecryptCTRParallel. The workers decrypt the chunks already read while the next one is read.
+ * @returns the number of bytes read
+ */
+std::size_t ReadDecryptCTRParallel(FileUtil::IOFile& file, const std::array<u8, 16>& key,
+                                   const std::array<u8, 16>& ctr, u64 offset, u8* dest,
+                                   std::size_t size);
+
+/**
+ * Decrypts an AES-CBC range whose size is a multiple of the block size, splitting large ranges
+ * over the workers like DecryptCTRParallel. iv is the ciphertext block preceding the range, it is
+ * updated to the last ciphertext block of the range so that the next range can continue from it.
+ */
+void DecryptCBCParallel(const std::array<u8, 16>& key, std::array<u8, 16>& iv, const u8* source,
+                        u8* dest, std::size_t size);
+
+} // namespace FileSys
@@ -1,25 +1,191 @@
 #include <algorithm>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+#include <vector>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "common/archives.h"
+#include "common/logging/log.h"
+#include "core/file_sys/parallel_decryption.h"
 #include "core/file_sys/romfs_reader.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::DirectRomFSReader)
 
 namespace FileSys {
 
+/// Size of the cached blocks, large enough that a sequential stream only seeks once per block
+constexpr std::size_t CacheBlockSize = 0x20000;
+/// Number of blocks kept, 4 MiB per RomFS
+constexpr std::size_t MaxCachedBlocks = 32;
+/// Blocks read in one go when a miss continues the previous read
+constexpr std::size_t ReadaheadBlocks = 4;
+
+struct DirectRomFSReader::Cache {
+    struct Block {
+        std::size_t index;
+        std::vector<u8> data;
+    };
+
+    /// Most recently used first
+    std::list<Block> blocks;
+    std::unordered_map<std::size_t, std::list<Block>::iterator> block_map;
+    /// End of the last read, to detect sequential accesses
+    std::size_t last_read_end = 0;
+    CacheStats stats{};
+    /// Destination of the reads that fill the cache
+    std::vector<u8> read_buffer;
+    /// When the file could be mapped, reads decrypt from it straight into their destination
+    FileUtil::MappedFile mapped_file;
+
+    /// The key schedule is only computed once, every read just seeks the keystream
+    std::unique_ptr<CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption> decryption;
+
+    const Block* Find(std::size_t index) {
+        const auto it = block_map.find(index);
+        if (it == block_map.end()) {
+            return nullptr;
+        }
+        blocks.splice(blocks.begin(), blocks, it->second);
+        return &*it->second;
+    }
+
+    /// Takes the least recently used block when the cache is full
+    Block& Insert(std::size_t index) {
+        if (blocks.size() >= MaxCachedBlocks) {
+            block_map.erase(blocks.back().index);
+            blocks.splice(blocks.begin(), blocks, std::prev(blocks.end()));
+        } else {
+            blocks.emplace_front();
+        }
+        Block& block = blocks.front();
+        block.index = index;
+        block_map[index] = blocks.begin();
+        return block;
+    }
+};
+
+DirectRomFSReader::DirectRomFSReader() = default;
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size)
+    : is_encrypted(false), file(std::move(file)), file_offset(file_offset), data_size(data_size) {}
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size, const std::array<u8, 16>& key,
+                                     const std::array<u8, 16>& ctr, std::size_t crypto_offset)
+    : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
+      crypto_offset(crypto_offset), data_size(data_size) {}
+
+DirectRomFSReader::~DirectRomFSReader() {
+    if (cache && cache->stats.misses != 0) {
+        LOG_DEBUG(Service_FS, "RomFS cache: {} hits, {} misses, {} blocks read ahead",
+                  cache->stats.hits, cache->stats.misses, cache->stats.readahead_blocks);
+    }
+}
+
+std::size_t DirectRomFSReader::ReadUncached(std::size_t offset, std::size_t length, u8* buffer) {
+    const bool parallel = is_encrypted && length >= ParallelDecryptionThreshold;
+    const u8* source = buffer;
+    std::size_t read_length;
+    if (cache->mapped_file.IsOpen()) {
+        const auto data = cache->mapped_file.GetData();
+        const std::size_t start = std::min<std::size_t>(file_offset + offset, data.size());
+        read_length = std::min(length, data.size() - start);
+        source = data.data() + start;
+    } else if (parallel) {
+        // Reading the next chunks overlaps with decrypting the previous ones
+        file.Seek(file_offset + offset, SEEK_SET);
+        return ReadDecryptCTRParallel(file, key, ctr, crypto_offset + offset, buffer, length);
+    } else {
+        file.Seek(file_offset + offset, SEEK_SET);
+        read_length = file.ReadBytes(buffer, length);
+    }
+    if (read_length == 0) {
+        return 0;
+    }
+
+    if (parallel) {
+        DecryptCTRParallel(key, ctr, crypto_offset + offset, source, buffer, read_length);
+    } else if (is_encrypted) {
+        if (!cache->decryption) {
+            cache->decryption = std::make_unique<CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption>(
+                key.data(), key.size(), ctr.data());
+        }
+        cache->decryption->Seek(crypto_offset + offset);
+        cache->decryption->ProcessData(buffer, source, read_length);
+    } else if (source != buffer) {
+        std::memcpy(buffer, source, read_length);
+    }
+    return read_length;
+}
+
 std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
-    if (length == 0)
+    if (length == 0 || offset >= data_size)
         return 0; // Crypto++ does not like zero size buffer
-    file.Seek(file_offset + offset, SEEK_SET);
-    std::size_t read_length = std::min(length, static_cast<std::size_t>(data_size) - offset);
-    read_length = file.ReadBytes(buffer, read_length);
-    if (is_encrypted) {
-        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-        d.Seek(crypto_offset + offset);
-        d.ProcessData(buffer, buffer, read_length);
+    const std::size_t read_length = std::min(length, static_cast<std::size_t>(data_size) - offset);
+
+    std::scoped_lock lock{cache_mutex};
+    if (!cache) {
+        cache = std::make_unique<Cache>();
+        cache->mapped_file = FileUtil::MappedFile(file);
     }
-    return read_length;
+    const bool sequential = offset == cache->last_read_end;
+    cache->last_read_end = offset + read_length;
+
+    // Large reads such as whole files would only evict the cache without being reused. Mapped
+    // plain files are already served from the page cache.
+    if (read_length >= CacheBlockSize || (!is_encrypted && cache->mapped_file.IsOpen())) {
+        return ReadUncached(offset, read_length, buffer);
+    }
+
+    std::size_t done = 0;
+    while (done < read_length) {
+        const std::size_t position = offset + done;
+        const std::size_t index = position / CacheBlockSize;
+        const Cache::Block* block = cache->Find(index);
+        if (block) {
+            cache->stats.hits++;
+        } else {
+            cache->stats.misses++;
+            // Sequential streams get the following blocks in the same read
+            const std::size_t num_blocks = sequential ? ReadaheadBlocks : 1;
+            const std::size_t first = index * CacheBlockSize;
+            const std::size_t size =
+                std::min(num_blocks * CacheBlockSize, static_cast<std::size_t>(data_size) - first);
+            std::vector<u8>& data = cache->read_buffer;
+            data.resize(size);
+            data.resize(ReadUncached(first, size, data.data()));
+
+            for (std::size_t i = (size + CacheBlockSize - 1) / CacheBlockSize; i-- > 0;) {
+                if (i != 0 && cache->Find(index + i)) {
+                    continue;
+                }
+                const std::size_t start = std::min(i * CacheBlockSize, data.size());
+                const std::size_t end = std::min(start + CacheBlockSize, data.size());
+                Cache::Block& new_block = cache->Insert(index + i);
+                new_block.data.assign(data.begin() + start, data.begin() + end);
+                if (i != 0) {
+                    cache->stats.readahead_blocks++;
+                }
+            }
+            block = cache->Find(index);
+        }
+
+        const std::size_t block_offset = position - index * CacheBlockSize;
+        if (block_offset >= block->data.size()) {
+            break; // The file is shorter than the RomFS claims
+        }
+        const std::size_t count = std::min(read_length - done, block->data.size() - block_offset);
+        std::memcpy(buffer + done, block->data.data() + block_offset, count);
+        done += count;
+    }
+    return done;
+}
+
+DirectRomFSReader::CacheStats DirectRomFSReader::GetCacheStats() const {
+    std::scoped_lock lock{cache_mutex};
+    return cache ? cache->stats : CacheStats{};
 }
 
 } // namespace FileSys
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <mutex>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
@@ -27,20 +29,26 @@ private:
 
 /**
  * A RomFS reader that directly reads the RomFS file.
+ * The file is memory mapped when possible. Small reads go through an LRU cache of decrypted
+ * blocks, which reads ahead when the accesses are sequential. Large reads are read and decrypted
+ * straight into the destination.
  */
 class DirectRomFSReader : public RomFSReader {
 public:
-    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
-        : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+    struct CacheStats {
+        u64 hits;
+        u64 misses;
+        /// Blocks loaded ahead of a sequential read
+        u64 readahead_blocks;
+    };
+
+    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size);
 
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
                       const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
-                      std::size_t crypto_offset)
-        : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
-          crypto_offset(crypto_offset), data_size(data_size) {}
+                      std::size_t crypto_offset);
 
-    ~DirectRomFSReader() override = default;
+    ~DirectRomFSReader() override;
 
     std::size_t GetSize() const override {
         return data_size;
@@ -48,7 +56,14 @@ public:
 
     std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override;
 
+    CacheStats GetCacheStats() const;
+
 private:
+    struct Cache;
+
+    /// Reads and decrypts a range of the RomFS, without going through the cache
+    std::size_t ReadUncached(std::size_t offset, std::size_t length, u8* buffer);
+
     bool is_encrypted;
     FileUtil::IOFile file;
     std::array<u8, 16> key;
@@ -57,7 +72,11 @@ private:
     u64 crypto_offset;
     u64 data_size;
 
-    DirectRomFSReader() = default;
+    /// Created on the first read, it is not part of the serialized state
+    std::unique_ptr<Cache> cache;
+    mutable std::mutex cache_mutex;
+
+    DirectRomFSReader();
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
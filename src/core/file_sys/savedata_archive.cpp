@@ -79,6 +79,7 @@ ResultVal<std::unique_ptr<FileBackend>> SaveDataArchive::OpenFile(const Path& pa
             return ERROR_FILE_NOT_FOUND;
         } else {
             // Create the file
+            DiskDirectory::InvalidateCache();
             FileUtil::CreateEmptyFile(full_path);
         }
         break;
@@ -123,6 +124,7 @@ ResultCode SaveDataArchive::DeleteFile(const Path& path) const {
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::Delete(full_path)) {
         return RESULT_SUCCESS;
     }
@@ -150,6 +152,7 @@ ResultCode SaveDataArchive::RenameFile(const Path& src_path, const Path& dest_pa
     const auto src_path_full = path_parser_src.BuildHostPath(mount_point);
     const auto dest_path_full = path_parser_dest.BuildHostPath(mount_point);
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::Rename(src_path_full, dest_path_full)) {
         return RESULT_SUCCESS;
     }
@@ -191,6 +194,7 @@ static ResultCode DeleteDirectoryHelper(const Path& path, const std::string& mou
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (deleter(full_path)) {
         return RESULT_SUCCESS;
     }
@@ -236,6 +240,7 @@ ResultCode SaveDataArchive::CreateFile(const FileSys::Path& path, u64 size) cons
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (size == 0) {
         FileUtil::CreateEmptyFile(full_path);
         return RESULT_SUCCESS;
@@ -281,6 +286,7 @@ ResultCode SaveDataArchive::CreateDirectory(const Path& path) const {
         break; // Expected 'success' case
     }
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::CreateDir(mount_point + path.AsString())) {
         return RESULT_SUCCESS;
     }
@@ -309,6 +315,7 @@ ResultCode SaveDataArchive::RenameDirectory(const Path& src_path, const Path& de
     const auto src_path_full = path_parser_src.BuildHostPath(mount_point);
     const auto dest_path_full = path_parser_dest.BuildHostPath(mount_point);
 
+    DiskDirectory::InvalidateCache();
     if (FileUtil::Rename(src_path_full, dest_path_full)) {
         return RESULT_SUCCESS;
     }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <utility>
 
@@ -226,10 +227,11 @@ public:
     }
 
     /**
-     * Gets the framebuffer layout (width, height, and screen regions)
+     * Gets a copy of the framebuffer layout (width, height, and screen regions)
      * @note This method is thread-safe
      */
-    const Layout::FramebufferLayout& GetFramebufferLayout() const {
+    Layout::FramebufferLayout GetFramebufferLayout() const {
+        std::scoped_lock lock{framebuffer_layout_mutex};
         return framebuffer_layout;
     }
 
@@ -269,6 +271,7 @@ protected:
      * @note EmuWindow implementations will usually use this in window resize event handlers.
      */
     void NotifyFramebufferLayoutChanged(const Layout::FramebufferLayout& layout) {
+        std::scoped_lock lock{framebuffer_layout_mutex};
         framebuffer_layout = layout;
     }
 
@@ -288,6 +291,8 @@ private:
     void CreateTouchState();
 
     Layout::FramebufferLayout framebuffer_layout; ///< Current framebuffer layout
+    /// Guards framebuffer_layout, which the present thread reads while the GUI thread resizes
+    mutable std::mutex framebuffer_layout_mutex;
 
     WindowConfig config{};        ///< Internal configuration (changes pending for being applied in
                                   /// ProcessConfigurationChanges)
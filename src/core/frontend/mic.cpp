@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include "core/frontend/mic.h"
 
 #ifdef HAVE_CUBEB
@@ -33,8 +35,8 @@ void NullMic::AdjustSampleRate(u32 sample_rate) {
     parameters.sample_rate = sample_rate;
 }
 
-Samples NullMic::Read() {
-    return {};
+std::size_t NullMic::Read(std::span<u8> dest) {
+    return 0;
 }
 
 StaticMic::StaticMic()
@@ -57,8 +59,12 @@ void StaticMic::StopSampling() {
 
 void StaticMic::AdjustSampleRate(u32 sample_rate) {}
 
-Samples StaticMic::Read() {
-    return (sample_size == 8) ? CACHE_8_BIT : CACHE_16_BIT;
+std::size_t StaticMic::Read(std::span<u8> dest) {
+    const std::vector<u8>& noise = (sample_size == 8) ? CACHE_8_BIT : CACHE_16_BIT;
+    const std::size_t sample_bytes = sample_size == 8 ? 1 : 2;
+    const std::size_t size = std::min(noise.size(), dest.size() / sample_bytes * sample_bytes);
+    std::memcpy(dest.data(), noise.data(), size);
+    return size;
 }
 
 RealMicFactory::~RealMicFactory() = default;
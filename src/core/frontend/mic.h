@@ -5,9 +5,9 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include <vector>
 #include "common/swap.h"
-#include "common/threadsafe_queue.h"
 
 namespace Frontend::Mic {
 
@@ -18,8 +18,6 @@ enum class Signedness : u8 {
     Unsigned,
 };
 
-using Samples = std::vector<u8>;
-
 struct Parameters {
     Signedness sign;
     u8 sample_size;
@@ -43,10 +41,12 @@ public:
 
     /**
      * Called from the actual event timing at a constant period under a given sample rate.
-     * When sampling is enabled this function is expected to return a buffer of 16 samples in ideal
+     * When sampling is enabled this function is expected to provide 16 samples in ideal
      * conditions, but can be lax if the data is coming in from another source like a real mic.
+     * @param dest Where to copy the samples, in the format given by the parameters.
+     * @returns The number of bytes copied, which never splits a sample.
      */
-    virtual Samples Read() = 0;
+    virtual std::size_t Read(std::span<u8> dest) = 0;
 
     /**
      * Adjusts the Parameters. Implementations should update the parameters field in addition to
@@ -94,7 +94,7 @@ public:
 
     void AdjustSampleRate(u32 sample_rate) override;
 
-    Samples Read() override;
+    std::size_t Read(std::span<u8> dest) override;
 };
 
 class StaticMic final : public Interface {
@@ -106,7 +106,7 @@ public:
     void StopSampling() override;
     void AdjustSampleRate(u32 sample_rate) override;
 
-    Samples Read() override;
+    std::size_t Read(std::span<u8> dest) override;
 
 private:
     u16 sample_rate = 0;
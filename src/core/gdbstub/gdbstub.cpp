@@ -13,6 +13,9 @@
 #include <cstring>
 #include <map>
 #include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <fcntl.h>
 #include <fmt/format.h>
 
@@ -41,12 +44,14 @@
 
 namespace GDBStub {
 namespace {
-constexpr int GDB_BUFFER_SIZE = 10000;
+// Large packets let memory be transferred with few round trips
+constexpr int GDB_BUFFER_SIZE = 0x10000;
 
 constexpr char GDB_STUB_START = '$';
 constexpr char GDB_STUB_END = '#';
 constexpr char GDB_STUB_ACK = '+';
 constexpr char GDB_STUB_NACK = '-';
+constexpr u8 GDB_STUB_ESCAPE = '}';
 
 #ifndef SIGTRAP
 constexpr u32 SIGTRAP = 5;
@@ -68,10 +73,9 @@ constexpr u32 D0_REGISTER = 26;
 constexpr u32 FPSCR_REGISTER = 42;
 
 // For sample XML files see the GDB source /gdb/features
-// GDB also wants the l character at the start
 // This XML defines what the registers are for this specific ARM device
 constexpr char target_xml[] =
-    R"(l<?xml version="1.0"?>
+    R"(<?xml version="1.0"?>
 <!DOCTYPE target SYSTEM "gdb-target.dtd">
 <target version="1.0">
   <feature name="org.gnu.gdb.arm.core">
@@ -495,17 +499,18 @@ static void SendPacket(const char packet) {
 /**
  * Send reply to gdb client.
  *
- * @param reply Reply to be sent to client.
+ * @param reply Reply to be sent to client, it may contain binary data.
+ * @param length Length of the reply.
  */
-static void SendReply(const char* reply) {
+static void SendReply(const char* reply, std::size_t length) {
     if (!IsConnected()) {
         return;
     }
 
     memset(command_buffer, 0, sizeof(command_buffer));
 
-    command_length = static_cast<u32>(strlen(reply));
-    if (command_length + 4 > sizeof(command_buffer)) {
+    command_length = static_cast<u32>(length);
+    if (length + 4 > sizeof(command_buffer)) {
         LOG_ERROR(Debug_GDBStub, "command_buffer overflow in SendReply");
         return;
     }
@@ -532,6 +537,74 @@ static void SendReply(const char* reply) {
     }
 }
 
+/**
+ * Send reply to gdb client.
+ *
+ * @param reply Reply to be sent to client.
+ */
+static void SendReply(const char* reply) {
+    SendReply(reply, strlen(reply));
+}
+
+/**
+ * Send the part of a qXfer object requested by the gdb client.
+ *
+ * @param object The whole object.
+ * @param args The offset and length requested by the client, as "offset,length".
+ */
+static void SendXferReply(std::string_view object, const char* args) {
+    const char* separator = strchr(args, ',');
+    if (!separator) {
+        return SendReply("E01");
+    }
+    const u32 offset = HexToInt(reinterpret_cast<const u8*>(args),
+                                static_cast<u32>(separator - args));
+    const u32 length = HexToInt(reinterpret_cast<const u8*>(separator + 1),
+                                static_cast<u32>(strlen(separator + 1)));
+    if (offset >= object.size()) {
+        return SendReply("l");
+    }
+
+    // 'm' tells that there is more to read, 'l' that this is the last part
+    const std::string_view part = object.substr(offset, length);
+    const bool is_last = offset + part.size() == object.size();
+    const std::string reply = fmt::format("{}{}", is_last ? 'l' : 'm', part);
+    SendReply(reply.c_str(), reply.size());
+}
+
+/// Returns the regions of the address space of the current process, in GDB's memory map format.
+static std::string GetMemoryMap() {
+    std::string map = R"(<?xml version="1.0"?>
+<!DOCTYPE memory-map PUBLIC "+//IDN gnu.org//DTD GDB Memory Map V1.0//EN"
+                            "http://sourceware.org/gdb/gdb-memory-map.dtd">
+<memory-map>
+)";
+    const auto process = Core::System::GetInstance().Kernel().GetCurrentProcess();
+    if (process) {
+        // Adjacent mapped areas are merged, GDB does not need to know where they are split
+        std::optional<std::pair<VAddr, u64>> region;
+        const auto flush_region = [&map, &region] {
+            if (region) {
+                map += fmt::format("  <memory type=\"ram\" start=\"0x{:x}\" length=\"0x{:x}\"/>\n",
+                                   region->first, region->second);
+                region.reset();
+            }
+        };
+        for (const auto& [base, vma] : process->vm_manager.vma_map) {
+            if (vma.type == Kernel::VMAType::Free) {
+                flush_region();
+            } else if (region) {
+                region->second += vma.size;
+            } else {
+                region.emplace(base, vma.size);
+            }
+        }
+        flush_region();
+    }
+    map += "</memory-map>\n";
+    return map;
+}
+
 /// Handle query command from gdb client.
 static void HandleQuery() {
     const char* query = reinterpret_cast<const char*>(command_buffer + 1);
@@ -540,11 +613,17 @@ static void HandleQuery() {
     if (strcmp(query, "TStatus") == 0) {
         SendReply("T0");
     } else if (strncmp(query, "Supported", strlen("Supported")) == 0) {
-        // PacketSize needs to be large enough for target xml
-        SendReply("PacketSize=2000;qXfer:features:read+;qXfer:threads:read+");
+        // The buffer holds the packet with its start, end and checksum
+        const std::string supported =
+            fmt::format("PacketSize={:x};qXfer:features:read+;qXfer:threads:read+;"
+                        "qXfer:memory-map:read+;binary-upload+",
+                        GDB_BUFFER_SIZE - 4);
+        SendReply(supported.c_str());
     } else if (strncmp(query, "Xfer:features:read:target.xml:",
                        strlen("Xfer:features:read:target.xml:")) == 0) {
-        SendReply(target_xml);
+        SendXferReply(target_xml, query + strlen("Xfer:features:read:target.xml:"));
+    } else if (strncmp(query, "Xfer:memory-map:read::", strlen("Xfer:memory-map:read::")) == 0) {
+        SendXferReply(GetMemoryMap(), query + strlen("Xfer:memory-map:read::"));
     } else if (strncmp(query, "fThreadInfo", strlen("fThreadInfo")) == 0) {
         std::string val = "m";
         u32 num_cores = Core::GetNumCores();
@@ -559,21 +638,22 @@ static void HandleQuery() {
         SendReply(val.c_str());
     } else if (strncmp(query, "sThreadInfo", strlen("sThreadInfo")) == 0) {
         SendReply("l");
-    } else if (strncmp(query, "Xfer:threads:read", strlen("Xfer:threads:read")) == 0) {
+    } else if (strncmp(query, "Xfer:threads:read::", strlen("Xfer:threads:read::")) == 0) {
         std::string buffer;
-        buffer += "l<?xml version=\"1.0\"?>";
+        buffer += "<?xml version=\"1.0\"?>";
         buffer += "<threads>";
         u32 num_cores = Core::GetNumCores();
         for (u32 i = 0; i < num_cores; ++i) {
             const auto& threads =
                 Core::System::GetInstance().Kernel().GetThreadManager(i).GetThreadList();
             for (const auto& thread : threads) {
-                buffer += fmt::format(R"*(<thread id="{:x}" name="Thread {:x}"></thread>)*",
-                                      thread->GetThreadId(), thread->GetThreadId());
+                buffer += fmt::format(
+                    R"*(<thread id="{:x}" core="{}" name="Thread {:x}"></thread>)*",
+                    thread->GetThreadId(), i, thread->GetThreadId());
             }
         }
         buffer += "</threads>";
-        SendReply(buffer.c_str());
+        SendXferReply(buffer, query + strlen("Xfer:threads:read::"));
     } else {
         SendReply("");
     }
@@ -628,15 +708,15 @@ static void SendSignal(Kernel::Thread* thread, u32 signal, bool full = true) {
         full = false;
     }
 
-    std::string buffer;
+    std::string buffer = fmt::format("T{:02x}", latest_signal);
     if (full) {
-
-        buffer = fmt::format("T{:02x}{:02x}:{:08x};{:02x}:{:08x};{:02x}:{:08x}", latest_signal,
-                             PC_REGISTER, htonl(Core::GetRunningCore().GetPC()), SP_REGISTER,
-                             htonl(Core::GetRunningCore().GetReg(SP_REGISTER)), LR_REGISTER,
-                             htonl(Core::GetRunningCore().GetReg(LR_REGISTER)));
-    } else {
-        buffer = fmt::format("T{:02x}", latest_signal);
+        // All core registers are sent with the stop, so that GDB does not have to ask for them
+        const auto& core = Core::GetRunningCore();
+        for (u32 reg = 0; reg < PC_REGISTER; reg++) {
+            buffer += fmt::format("{:02x}:{:08x};", reg, htonl(core.GetReg(static_cast<int>(reg))));
+        }
+        buffer += fmt::format("{:02x}:{:08x};{:02x}:{:08x}", PC_REGISTER, htonl(core.GetPC()),
+                              CPSR_REGISTER, htonl(core.GetCPSR()));
     }
 
     if (thread) {
@@ -846,7 +926,7 @@ static void ReadMemory() {
     LOG_DEBUG(Debug_GDBStub, "gdb: addr: {:08x} len: {:08x}\n", addr, len);
 
     if (len * 2 > sizeof(reply)) {
-        SendReply("E01");
+        return SendReply("E01");
     }
 
     auto& memory = Core::System::GetInstance().Memory();
@@ -887,6 +967,95 @@ static void WriteMemory() {
     SendReply("OK");
 }
 
+/// Read location in memory specified by gdb client, and send it as binary data.
+static void ReadMemoryBinary() {
+    static u8 reply[GDB_BUFFER_SIZE - 4];
+
+    auto start_offset = command_buffer + 1;
+    auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
+    VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
+
+    start_offset = addr_pos + 1;
+    u32 len =
+        HexToInt(start_offset, static_cast<u32>((command_buffer + command_length) - start_offset));
+
+    LOG_DEBUG(Debug_GDBStub, "gdb: addr: {:08x} len: {:08x}\n", addr, len);
+
+    // Every byte could need to be escaped, 'b' comes first
+    if (len * 2 + 1 > sizeof(reply)) {
+        return SendReply("E01");
+    }
+
+    auto& memory = Core::System::GetInstance().Memory();
+    if (len > 0 &&
+        !memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                                      addr)) {
+        return SendReply("E00");
+    }
+
+    std::vector<u8> data(len);
+    memory.ReadBlock(addr, data.data(), len);
+
+    std::size_t reply_length = 0;
+    reply[reply_length++] = 'b';
+    for (const u8 byte : data) {
+        if (byte == GDB_STUB_START || byte == GDB_STUB_END || byte == GDB_STUB_ESCAPE ||
+            byte == '*') {
+            reply[reply_length++] = GDB_STUB_ESCAPE;
+            reply[reply_length++] = byte ^ 0x20;
+        } else {
+            reply[reply_length++] = byte;
+        }
+    }
+    SendReply(reinterpret_cast<char*>(reply), reply_length);
+}
+
+/// Modify location in memory with binary data received from the gdb client.
+static void WriteMemoryBinary() {
+    u8* const command_end = command_buffer + command_length;
+    auto start_offset = command_buffer + 1;
+    auto addr_pos = std::find(start_offset, command_end, ',');
+    VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
+
+    start_offset = addr_pos + 1;
+    auto len_pos = std::find(start_offset, command_end, ':');
+    u32 len = HexToInt(start_offset, static_cast<u32>(len_pos - start_offset));
+    if (len_pos == command_end) {
+        return SendReply("E01");
+    }
+
+    // GDB writes nothing to find out if binary writes are supported
+    if (len == 0) {
+        return SendReply("OK");
+    }
+
+    auto& memory = Core::System::GetInstance().Memory();
+    if (!memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                                      addr)) {
+        return SendReply("E00");
+    }
+
+    std::vector<u8> data;
+    data.reserve(len);
+    for (const u8* ptr = len_pos + 1; ptr < command_end && data.size() < len; ++ptr) {
+        if (*ptr == GDB_STUB_ESCAPE) {
+            if (++ptr == command_end) {
+                break;
+            }
+            data.push_back(*ptr ^ 0x20);
+        } else {
+            data.push_back(*ptr);
+        }
+    }
+    if (data.size() != len) {
+        return SendReply("E01");
+    }
+
+    memory.WriteBlock(addr, data.data(), len);
+    Core::GetRunningCore().ClearInstructionCache();
+    SendReply("OK");
+}
+
 void Break(bool is_memory_break) {
     send_trap = true;
 
@@ -1093,6 +1262,12 @@ void HandlePacket() {
     case 'M':
         WriteMemory();
         break;
+    case 'x':
+        ReadMemoryBinary();
+        break;
+    case 'X':
+        WriteMemoryBinary();
+        break;
     case 's':
         Step();
         return;
@@ -9,6 +9,7 @@
 #include "common/assert.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/object_pool.h"
 #include "core/hle/kernel/thread.h"
 
 SERIALIZE_EXPORT_IMPL(Kernel::Event)
@@ -19,7 +20,7 @@ Event::Event(KernelSystem& kernel) : WaitObject(kernel) {}
 Event::~Event() {}
 
 std::shared_ptr<Event> KernelSystem::CreateEvent(ResetType reset_type, std::string name) {
-    auto evt{std::make_shared<Event>(*this)};
+    auto evt{MakePooled<Event>(*this)};
 
     evt->signaled = false;
     evt->reset_type = reset_type;
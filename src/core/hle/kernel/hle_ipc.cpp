@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <future>
 #include <vector>
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
@@ -59,6 +61,30 @@ private:
     friend class boost::serialization::access;
 };
 
+class HLERequestContext::AsyncWakeupCallback : public HLERequestContext::WakeupCallback {
+public:
+    explicit AsyncWakeupCallback(std::shared_future<void> done_) : done(std::move(done_)) {}
+
+    void WakeUp(std::shared_ptr<Thread> thread, HLERequestContext& context,
+                ThreadWakeupReason reason) override {
+        // The emulated delay is up, the response may still be being written by the workers
+        if (done.valid()) {
+            done.wait();
+        }
+    }
+
+private:
+    AsyncWakeupCallback() = default;
+    /// Not serialized, the HLE workers are drained before a state is saved
+    std::shared_future<void> done;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<HLERequestContext::WakeupCallback>(*this);
+    }
+    friend class boost::serialization::access;
+};
+
 SessionRequestHandler::SessionInfo::SessionInfo(std::shared_ptr<ServerSession> session,
                                                 std::unique_ptr<SessionDataBase> data)
     : session(std::move(session)), data(std::move(data)) {}
@@ -76,6 +102,37 @@ void SessionRequestHandler::ClientDisconnected(std::shared_ptr<ServerSession> se
         connected_sessions.end());
 }
 
+void SessionRequestHandler::QueueAsyncJob(Common::ThreadWorker& workers, AsyncJob job) {
+    {
+        std::scoped_lock lock{async_mutex};
+        if (num_async_requests >= max_async_requests) {
+            pending_async_jobs.push(std::move(job));
+            return;
+        }
+        num_async_requests++;
+    }
+    StartAsyncJob(workers, std::move(job));
+}
+
+void SessionRequestHandler::StartAsyncJob(Common::ThreadWorker& workers, AsyncJob job) {
+    workers.QueueWork([&workers, handler = shared_from_this(), job = std::move(job)] {
+        job();
+
+        // Hand the slot of this job over to the next queued one
+        AsyncJob next;
+        {
+            std::scoped_lock lock{handler->async_mutex};
+            if (handler->pending_async_jobs.empty()) {
+                handler->num_async_requests--;
+                return;
+            }
+            next = std::move(handler->pending_async_jobs.front());
+            handler->pending_async_jobs.pop();
+        }
+        handler->StartAsyncJob(workers, std::move(next));
+    });
+}
+
 std::shared_ptr<Event> HLERequestContext::SleepClientThread(
     const std::string& reason, std::chrono::nanoseconds timeout,
     std::shared_ptr<WakeupCallback> callback) {
@@ -93,6 +150,57 @@ std::shared_ptr<Event> HLERequestContext::SleepClientThread(
     return event;
 }
 
+void HLERequestContext::RunAsync(std::function<s64(HLERequestContext&)> async_section) {
+    ASSERT(session->hle_handler);
+    // Nothing signals the event, the thread is woken up by the job once it is done. The wakeup
+    // callback writes the response that the job left in the command buffer.
+    SleepClientThread("RunAsync", std::chrono::nanoseconds{-1}, nullptr);
+
+    session->hle_handler->QueueAsyncJob(
+        kernel.GetHLEWorkers(),
+        [context = shared_from_this(), async_section = std::move(async_section)] {
+            const s64 delay_ns = async_section(*context);
+            if (context->retry_after_drain) {
+                context->retry_after_drain = false;
+                context->kernel.AddDrainedRequest(context);
+                return;
+            }
+            context->thread->WakeAfterDelay(std::max<s64>(delay_ns, 0), true);
+        });
+}
+
+void HLERequestContext::RunAsyncWithDelay(s64 delay_ns,
+                                          std::function<void(HLERequestContext&)> async_section) {
+    ASSERT(session->hle_handler);
+    auto done = std::make_shared<std::promise<void>>();
+    SleepClientThread("RunAsyncWithDelay", std::chrono::nanoseconds{-1},
+                      std::make_shared<AsyncWakeupCallback>(done->get_future().share()));
+    thread->WakeAfterDelay(std::max<s64>(delay_ns, 0));
+
+    session->hle_handler->QueueAsyncJob(
+        kernel.GetHLEWorkers(),
+        [context = shared_from_this(), async_section = std::move(async_section), done] {
+            async_section(*context);
+            done->set_value();
+        });
+}
+
+void HLERequestContext::RetryAfterDrain() {
+    retry_after_drain = true;
+}
+
+void HLERequestContext::HandleAgain() {
+    // The session may have been closed, or the thread stopped, in the meantime
+    if (!session->hle_handler || thread->status != ThreadStatus::WaitHleEvent) {
+        return;
+    }
+    const auto wakeup_callback = thread->wakeup_callback;
+    session->hle_handler->HandleSyncRequest(*this);
+    if (thread->wakeup_callback == wakeup_callback) {
+        thread->WakeAfterDelay(0);
+    }
+}
+
 HLERequestContext::HLERequestContext() : kernel(Core::Global<KernelSystem>()) {}
 
 HLERequestContext::HLERequestContext(KernelSystem& kernel, std::shared_ptr<ServerSession> session,
@@ -176,11 +284,11 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(
             VAddr source_address = src_cmdbuf[i];
             IPC::StaticBufferDescInfo buffer_info{descriptor};
 
-            // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
+            // Copy the input buffer into our own vector, reusing its storage if it has any.
+            std::vector<u8>& data = static_buffers[buffer_info.buffer_id];
+            data.resize(buffer_info.size);
             kernel.memory.ReadBlock(src_process, source_address, data.data(), data.size());
 
-            AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
             break;
         }
@@ -294,6 +402,18 @@ void HLERequestContext::ReportUnimplemented() const {
     }
 }
 
+void HLERequestContext::Reset(std::shared_ptr<ServerSession> session_,
+                              std::shared_ptr<Thread> thread_) {
+    session = std::move(session_);
+    thread = std::move(thread_);
+    cmd_buf[0] = 0;
+    request_handles.clear();
+    for (auto& buffer : static_buffers) {
+        buffer.clear();
+    }
+    request_mapped_buffers.clear();
+}
+
 MappedBuffer::MappedBuffer() : memory(&Core::Global<Core::System>().Memory()) {}
 
 MappedBuffer::MappedBuffer(Memory::MemorySystem& memory, std::shared_ptr<Process> process,
@@ -316,6 +436,15 @@ void MappedBuffer::Write(const void* src_buffer, std::size_t offset, std::size_t
     memory->WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
 }
 
+Memory::HostSpans MappedBuffer::GetHostSpans(std::size_t offset, std::size_t size, bool write) {
+    ASSERT(perms & (write ? IPC::W : IPC::R));
+    ASSERT(offset + size <= this->size);
+    return memory->GetHostSpans(*process, address + static_cast<VAddr>(offset), size,
+                                write ? Memory::FlushMode::FlushAndInvalidate
+                                      : Memory::FlushMode::Flush);
+}
+
 } // namespace Kernel
 
 SERIALIZE_EXPORT_IMPL(Kernel::HLERequestContext::ThreadCallback)
+SERIALIZE_EXPORT_IMPL(Kernel::HLERequestContext::AsyncWakeupCallback)
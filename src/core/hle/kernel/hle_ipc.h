@@ -7,7 +7,10 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
 #include <vector>
 #include <boost/container/small_vector.hpp>
@@ -21,13 +24,15 @@
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/memory.h"
 
-namespace Service {
-class ServiceFrameworkBase;
+namespace Common {
+template <class StateType>
+class StatefulThreadWorker;
 }
 
-namespace Memory {
-class MemorySystem;
+namespace Service {
+class ServiceFrameworkBase;
 }
 
 namespace Kernel {
@@ -69,6 +74,14 @@ public:
      */
     virtual void ClientDisconnected(std::shared_ptr<ServerSession> server_session);
 
+    /**
+     * Sets how many requests of this handler may run on the HLE workers at once, further requests
+     * queue up until one of them completes. See HLERequestContext::RunAsync.
+     */
+    void SetMaxAsyncRequests(u32 max_requests) {
+        max_async_requests = max_requests;
+    }
+
     /// Empty placeholder structure for services with no per-session data. The session data classes
     /// in each service must inherit from this.
     struct SessionDataBase {
@@ -115,6 +128,20 @@ protected:
     std::vector<SessionInfo> connected_sessions;
 
 private:
+    using AsyncJob = std::function<void()>;
+
+    /// Runs the job on the workers, or queues it if the handler already has enough jobs running
+    void QueueAsyncJob(Common::StatefulThreadWorker<void>& workers, AsyncJob job);
+    void StartAsyncJob(Common::StatefulThreadWorker<void>& workers, AsyncJob job);
+
+    std::mutex async_mutex;
+    /// By default the requests of a handler run one at a time, so handlers don't need locking
+    u32 max_async_requests = 1;
+    u32 num_async_requests = 0;
+    std::queue<AsyncJob> pending_async_jobs;
+
+    friend class HLERequestContext;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version) {
         ar& connected_sessions;
@@ -132,6 +159,9 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+    /// Returns the host memory of a part of the buffer for in place access, or an empty list if
+    /// it is not backed by regular memory. See MemorySystem::GetHostSpans.
+    Memory::HostSpans GetHostSpans(std::size_t offset, std::size_t size, bool write);
     std::size_t GetSize() const {
         return size;
     }
@@ -242,6 +272,39 @@ public:
                                              std::chrono::nanoseconds timeout,
                                              std::shared_ptr<WakeupCallback> callback);
 
+    /**
+     * Puts the client thread to sleep and runs async_section on the HLE workers, so that blocking
+     * host work like file or network I/O doesn't hold up the other guest threads. The requests of
+     * a handler are limited as set with SessionRequestHandler::SetMaxAsyncRequests.
+     * @param async_section Callable that takes the context, writes the entire command response and
+     * returns the emulated duration of the operation in nanoseconds. The client thread is woken
+     * up that long after the callable finishes. It runs on a worker thread, so it must not touch
+     * kernel objects or the handles of the request.
+     */
+    void RunAsync(std::function<s64(HLERequestContext&)> async_section);
+
+    /**
+     * Like RunAsync, for operations whose emulated duration is known before they run. The client
+     * thread is woken up delay_ns after the request, and async_section runs on the HLE workers
+     * in the meantime. Emulation only waits for it when it is still running once the delay is up,
+     * so the host work is hidden behind the emulated latency instead of adding to it.
+     */
+    void RunAsyncWithDelay(s64 delay_ns, std::function<void(HLERequestContext&)> async_section);
+
+    /**
+     * Gives the request up without a response, for a section run by RunAsync that can't finish
+     * while the HLE workers are drained. The request is handled again from the start once the
+     * state being saved or loaded is complete, see KernelSystem::RetryDrainedRequests. The section
+     * must not have written to the command buffer.
+     */
+    void RetryAfterDrain();
+
+    /**
+     * Handles a request given up with RetryAfterDrain again. The client thread still sleeps from
+     * the first attempt, so a handler that answers right away wakes it up through that.
+     */
+    void HandleAgain();
+
     /**
      * Resolves a object id from the request command buffer into a pointer to an object. See the
      * "HLE handle protocol" section in the class documentation for more details.
@@ -288,8 +351,15 @@ public:
     /// Reports an unimplemented function.
     void ReportUnimplemented() const;
 
+    /**
+     * Prepares the context for another request, dropping the objects, buffers and references of
+     * the previous one while keeping their storage allocated.
+     */
+    void Reset(std::shared_ptr<ServerSession> session, std::shared_ptr<Thread> thread);
+
     class ThreadCallback;
     friend class ThreadCallback;
+    class AsyncWakeupCallback;
 
 private:
     KernelSystem& kernel;
@@ -302,6 +372,8 @@ private:
     std::array<std::vector<u8>, IPC::MAX_STATIC_BUFFERS> static_buffers;
     // The mapped buffers will be created when the IPC request is translated
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
+    // Set by RetryAfterDrain on the worker that runs the asynchronous section
+    bool retry_after_drain = false;
 
     HLERequestContext();
     template <class Archive>
@@ -319,3 +391,4 @@ private:
 } // namespace Kernel
 
 BOOST_CLASS_EXPORT_KEY(Kernel::HLERequestContext::ThreadCallback)
+BOOST_CLASS_EXPORT_KEY(Kernel::HLERequestContext::AsyncWakeupCallback)
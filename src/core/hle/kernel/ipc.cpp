@@ -18,6 +18,39 @@
 
 namespace Kernel {
 
+namespace {
+
+/// Page aligned mapped buffers of at least this size are mapped into the target process instead
+/// of being copied, like the real kernel does for all of them.
+constexpr u32 MinRemapSize = 4 * Memory::CITRA_PAGE_SIZE;
+
+/**
+ * Returns the memory backing the given page aligned range of the process, or null if it cannot be
+ * mapped into another process. This requires the range to be regular memory within a single area,
+ * rasterizer cached pages are copied so that they are flushed first.
+ */
+MemoryRef GetRemappableMemory(const Process& process, VAddr address, u32 size) {
+    const auto vma = process.vm_manager.FindVMA(address);
+    if (vma == process.vm_manager.vma_map.end()) {
+        return nullptr;
+    }
+    const VirtualMemoryArea& area = vma->second;
+    const u32 offset = address - area.base;
+    if (area.type != VMAType::BackingMemory || size > area.size - offset) {
+        return nullptr;
+    }
+    const auto& attributes = process.vm_manager.page_table->attributes;
+    for (VAddr page = address >> Memory::CITRA_PAGE_BITS;
+         page < (address + size) >> Memory::CITRA_PAGE_BITS; page++) {
+        if (attributes[page] != Memory::PageType::Memory) {
+            return nullptr;
+        }
+    }
+    return area.backing_memory + offset;
+}
+
+} // Anonymous namespace
+
 ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySystem& memory,
                                   std::shared_ptr<Thread> src_thread,
                                   std::shared_ptr<Thread> dst_thread, VAddr src_address,
@@ -163,7 +196,7 @@ ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySy
 
                 ASSERT(found != mapped_buffer_context.end());
 
-                if (permissions != IPC::MappedBufferPermissions::R) {
+                if (permissions != IPC::MappedBufferPermissions::R && !found->remapped) {
                     // Copy the modified buffer back into the target process
                     // NOTE: As this is a reply the "source" is the destination and the
                     //       "target" is the source.
@@ -202,15 +235,26 @@ ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySy
                 Memory::IPC_MAPPING_VADDR, Memory::IPC_MAPPING_SIZE, reserve_buffer,
                 Memory::CITRA_PAGE_SIZE, Kernel::MemoryState::Reserved);
 
-            std::shared_ptr<BackingMem> buffer =
-                std::make_shared<BufferMem>(num_pages * Memory::CITRA_PAGE_SIZE);
-            memory.ReadBlock(*src_process, source_address, buffer->GetPtr() + page_offset, size);
+            const u32 mapping_size = num_pages * Memory::CITRA_PAGE_SIZE;
+            MemoryRef source_memory;
+            if (page_offset == 0 && size == mapping_size && size >= MinRemapSize) {
+                source_memory = GetRemappableMemory(*src_process, source_address, size);
+            }
+            const bool remapped = static_cast<bool>(source_memory);
+
+            std::shared_ptr<BackingMem> buffer;
+            if (!remapped) {
+                buffer = std::make_shared<BufferMem>(mapping_size);
+                memory.ReadBlock(*src_process, source_address, buffer->GetPtr() + page_offset,
+                                 size);
+                source_memory = buffer;
+            }
 
             // Map the page(s) into the target process' address space.
             target_address =
                 dst_process->vm_manager
                     .MapBackingMemoryToBase(Memory::IPC_MAPPING_VADDR, Memory::IPC_MAPPING_SIZE,
-                                            buffer, static_cast<u32>(buffer->GetSize()),
+                                            std::move(source_memory), mapping_size,
                                             Kernel::MemoryState::Shared)
                     .Unwrap();
 
@@ -223,7 +267,7 @@ ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySy
 
             mapped_buffer_context.push_back({permissions, size, source_address,
                                              target_address + page_offset, std::move(buffer),
-                                             std::move(reserve_buffer)});
+                                             std::move(reserve_buffer), remapped});
 
             break;
         }
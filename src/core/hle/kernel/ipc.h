@@ -7,6 +7,7 @@
 #include <memory>
 #include <vector>
 #include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/thread.h"
@@ -27,6 +28,8 @@ struct MappedBufferContext {
 
     std::shared_ptr<BackingMem> buffer;
     std::shared_ptr<BackingMem> reserve_buffer;
+    /// Whether the target maps the source pages instead of a copy of them in `buffer`
+    bool remapped{};
 
 private:
     template <class Archive>
@@ -37,6 +40,9 @@ private:
         ar& target_address;
         ar& buffer;
         ar& reserve_buffer;
+        if (file_version >= 1) {
+            ar& remapped;
+        }
     }
     friend class boost::serialization::access;
 };
@@ -49,3 +55,5 @@ ResultCode TranslateCommandBuffer(KernelSystem& system, Memory::MemorySystem& me
                                   std::vector<MappedBufferContext>& mapped_buffer_context,
                                   bool reply);
 } // namespace Kernel
+
+BOOST_CLASS_VERSION(Kernel::MappedBufferContext, 1)
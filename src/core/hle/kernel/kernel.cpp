@@ -7,9 +7,11 @@
 #include <boost/serialization/vector.hpp>
 #include "common/archives.h"
 #include "common/serialization/atomic.h"
+#include "common/thread_worker.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/config_mem.h"
 #include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/memory.h"
@@ -44,6 +46,7 @@ KernelSystem::KernelSystem(Memory::MemorySystem& memory, Core::Timing& timing,
 
 /// Shutdown the kernel
 KernelSystem::~KernelSystem() {
+    waiting_for_hle_workers = true;
     ResetThreadIDs();
 };
 
@@ -144,6 +147,39 @@ const IPCDebugger::Recorder& KernelSystem::GetIPCRecorder() const {
     return *ipc_recorder;
 }
 
+Common::ThreadWorker& KernelSystem::GetHLEWorkers() {
+    // Most sessions never run anything asynchronously, so only start the threads on first use
+    if (!hle_workers) {
+        constexpr std::size_t NumHLEWorkers = 4;
+        hle_workers = std::make_unique<Common::ThreadWorker>(NumHLEWorkers, "HLE:Worker");
+    }
+    return *hle_workers;
+}
+
+void KernelSystem::WaitForHLEWorkers() {
+    if (hle_workers) {
+        waiting_for_hle_workers = true;
+        hle_workers->WaitForRequests();
+        waiting_for_hle_workers = false;
+    }
+}
+
+void KernelSystem::AddDrainedRequest(std::shared_ptr<HLERequestContext> context) {
+    std::scoped_lock lock{drained_requests_mutex};
+    drained_requests.push_back(std::move(context));
+}
+
+void KernelSystem::RetryDrainedRequests() {
+    std::vector<std::shared_ptr<HLERequestContext>> requests;
+    {
+        std::scoped_lock lock{drained_requests_mutex};
+        requests.swap(drained_requests);
+    }
+    for (const auto& context : requests) {
+        context->HandleAgain();
+    }
+}
+
 void KernelSystem::AddNamedPort(std::string name, std::shared_ptr<ClientPort> port) {
     named_ports.emplace(std::move(name), std::move(port));
 }
@@ -176,6 +212,10 @@ void KernelSystem::serialize(Archive& ar, const unsigned int file_version) {
     ar& shared_page_handler;
     ar& stored_processes;
     ar& next_thread_id;
+    // Their client threads sleep until the requests are handled again once the state is loaded
+    if (file_version >= 1) {
+        ar& drained_requests;
+    }
     // Deliberately don't include debugger info to allow debugging through loads
 
     if (Archive::is_loading::value) {
@@ -8,14 +8,21 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "core/hle/kernel/memory.h"
 #include "core/hle/result.h"
 #include "core/memory.h"
 
+namespace Common {
+template <class StateType>
+class StatefulThreadWorker;
+}
+
 namespace ConfigMem {
 class Handler;
 }
@@ -40,6 +47,7 @@ namespace Kernel {
 
 class AddressArbiter;
 class Event;
+class HLERequestContext;
 class Mutex;
 class CodeSet;
 class Process;
@@ -261,6 +269,33 @@ public:
     IPCDebugger::Recorder& GetIPCRecorder();
     const IPCDebugger::Recorder& GetIPCRecorder() const;
 
+    /// Returns the worker threads that run the asynchronous parts of HLE requests
+    Common::StatefulThreadWorker<void>& GetHLEWorkers();
+
+    /**
+     * Waits until the HLE workers are idle. The wakeups of the threads whose requests completed
+     * are queued on the timers by then.
+     */
+    void WaitForHLEWorkers();
+
+    /**
+     * Whether the HLE workers are being waited for. Requests that wait on the host for an unbounded
+     * time, like blocking socket calls, give up when it is set so that the wait can't hang, and are
+     * retried with HLERequestContext::RetryAfterDrain.
+     */
+    bool IsWaitingForHLEWorkers() const {
+        return waiting_for_hle_workers;
+    }
+
+    /// Keeps a request given up while the HLE workers were drained, it is part of the state
+    void AddDrainedRequest(std::shared_ptr<HLERequestContext> context);
+
+    /**
+     * Handles the requests given up while the HLE workers were drained again. Called once the
+     * state being saved or loaded is complete, not on shutdown.
+     */
+    void RetryDrainedRequests();
+
     std::shared_ptr<MemoryRegionInfo> GetMemoryRegion(MemoryRegion region);
 
     void HandleSpecialMapping(VMManager& address_space, const AddressMapping& mapping);
@@ -323,9 +358,17 @@ private:
 
     u32 next_thread_id;
 
+    std::atomic<bool> waiting_for_hle_workers{false};
+    std::mutex drained_requests_mutex;
+    std::vector<std::shared_ptr<HLERequestContext>> drained_requests;
+    // Destructed first, so that no job is left running with the kernel gone
+    std::unique_ptr<Common::StatefulThreadWorker<void>> hle_workers;
+
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version);
 };
 
 } // namespace Kernel
+
+BOOST_CLASS_VERSION(Kernel::KernelSystem, 1)
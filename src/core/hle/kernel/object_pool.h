@@ -0,0 +1,93 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace Kernel {
+
+/**
+ * Free list of blocks of one size. Freed blocks are kept for the next allocation instead of being
+ * returned to the system, so the pool holds as many blocks as were alive at the peak.
+ * The blocks outlive the kernel on purpose, services may still hold objects while it shuts down.
+ */
+template <std::size_t Size, std::size_t Align>
+class BlockPool {
+    static_assert(Align <= alignof(std::max_align_t), "Over-aligned blocks are not supported");
+
+public:
+    static void* Allocate() {
+        std::scoped_lock lock{mutex};
+        if (free_list == nullptr) {
+            return ::operator new(sizeof(Block));
+        }
+        Block* block = free_list;
+        free_list = block->next;
+        return block;
+    }
+
+    static void Free(void* ptr) noexcept {
+        std::scoped_lock lock{mutex};
+        Block* block = static_cast<Block*>(ptr);
+        block->next = free_list;
+        free_list = block;
+    }
+
+private:
+    union Block {
+        Block* next;
+        alignas(Align) std::byte storage[Size];
+    };
+
+    static inline std::mutex mutex;
+    static inline Block* free_list{};
+};
+
+/// Allocator drawing single objects from the BlockPool of their size
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n != 1) {
+            return std::allocator<T>{}.allocate(n);
+        }
+        return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::Allocate());
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        if (n != 1) {
+            std::allocator<T>{}.deallocate(ptr, n);
+            return;
+        }
+        BlockPool<sizeof(T), alignof(T)>::Free(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+/**
+ * Creates a kernel object in pooled memory. The object and its reference count share one block,
+ * like with std::make_shared, so titles creating and closing objects at a high rate reuse blocks.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> MakePooled(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<Args>(args)...);
+}
+
+} // namespace Kernel
@@ -90,8 +90,12 @@ ResultCode ServerSession::HandleSyncRequest(std::shared_ptr<Thread> thread) {
         kernel.memory.ReadBlock(*current_process, thread->GetCommandBufferAddress(), cmd_buf.data(),
                                 cmd_buf.size() * sizeof(u32));
 
-        auto context =
-            std::make_shared<Kernel::HLERequestContext>(kernel, SharedFrom(this), thread);
+        std::shared_ptr<HLERequestContext> context = std::move(cached_context);
+        if (context) {
+            context->Reset(SharedFrom(this), thread);
+        } else {
+            context = std::make_shared<HLERequestContext>(kernel, SharedFrom(this), thread);
+        }
         context->PopulateFromIncomingCommandBuffer(cmd_buf.data(), current_process);
 
         hle_handler->HandleSyncRequest(*context);
@@ -106,6 +110,13 @@ ResultCode ServerSession::HandleSyncRequest(std::shared_ptr<Thread> thread) {
             kernel.memory.WriteBlock(*current_process, thread->GetCommandBufferAddress(),
                                      cmd_buf.data(), cmd_buf.size() * sizeof(u32));
         }
+
+        // Keep the context around for the next request, unless a sleeping thread still needs it.
+        // Its references are dropped first, as holding on to this session would be a cycle.
+        if (context.use_count() == 1) {
+            context->Reset(nullptr, nullptr);
+            cached_context = std::move(context);
+        }
     }
 
     if (thread->status == ThreadStatus::Running) {
@@ -85,8 +85,7 @@ Handler::Handler(Core::Timing& timing) : timing(timing) {
                                              std::bind(&Handler::UpdateTimeCallback, this, _1, _2));
     timing.ScheduleEvent(0, update_time_event, 0, 0);
 
-    float slidestate = Settings::values.factor_3d.GetValue() / 100.0f;
-    shared_page.sliderstate_3d = static_cast<float_le>(slidestate);
+    shared_page.sliderstate_3d = static_cast<float_le>(Settings::Slider3D());
 }
 
 /// Gets system time in 3DS format. The epoch is Jan 1900, and the unit is millisecond.
@@ -36,7 +36,6 @@
 #include "core/hle/kernel/timer.h"
 #include "core/hle/kernel/vm_manager.h"
 #include "core/hle/kernel/wait_object.h"
-#include "core/hle/lock.h"
 #include "core/hle/result.h"
 #include "core/hle/service/plgldr/plgldr.h"
 #include "core/hle/service/service.h"
@@ -358,6 +357,11 @@ private:
     Kernel::KernelSystem& kernel;
     Memory::MemorySystem& memory;
 
+#if MICROPROFILE_ENABLED
+    /// Profiler timers of the implemented SVCs, so every SVC shows up on its own
+    std::array<MicroProfileToken, 180> svc_tokens;
+#endif
+
     friend class SVCWrapper<SVC>;
 
     // ARM interfaces
@@ -2310,23 +2314,41 @@ void SVC::CallSVC(u32 immediate) {
     MICROPROFILE_SCOPE(Kernel_SVC);
 
     // Lock the global kernel mutex when we enter the kernel HLE.
-    std::lock_guard lock{HLE::g_hle_lock};
+    const auto lock = system.LockHLE();
 
     DEBUG_ASSERT_MSG(kernel.GetCurrentProcess()->status == ProcessStatus::Running,
                      "Running threads from exiting processes is unimplemented");
 
     const FunctionDef* info = GetSVCInfo(immediate);
-    LOG_TRACE(Kernel_SVC, "calling {}", info->name);
     if (info) {
+        LOG_TRACE(Kernel_SVC, "calling {}", info->name);
         if (info->func) {
+#if MICROPROFILE_ENABLED
+            MICROPROFILE_SCOPE_TOKEN(svc_tokens[immediate]);
+#endif
+            Core::PerfStats::SubsystemTimer timer{system.GetPerfStats(),
+                                                  Core::PerfStats::Subsystem::HLE};
+            const auto start = Core::PerfStats::Clock::now();
             (this->*(info->func))();
+            if (auto* perf_stats = system.GetPerfStats()) {
+                perf_stats->RecordSVCCall(immediate, info->name,
+                                          Core::PerfStats::Clock::now() - start);
+            }
         } else {
             LOG_ERROR(Kernel_SVC, "unimplemented SVC function {}(..)", info->name);
         }
     }
 }
 
-SVC::SVC(Core::System& system) : system(system), kernel(system.Kernel()), memory(system.Memory()) {}
+SVC::SVC(Core::System& system) : system(system), kernel(system.Kernel()), memory(system.Memory()) {
+#if MICROPROFILE_ENABLED
+    for (std::size_t i = 0; i < SVC_Table.size(); ++i) {
+        svc_tokens[i] = SVC_Table[i].func
+                            ? MicroProfileGetToken("SVC", SVC_Table[i].name, MP_RGB(70, 200, 70))
+                            : MICROPROFILE_INVALID_TOKEN;
+    }
+#endif
+}
 
 u32 SVC::GetReg(std::size_t n) {
     return system.GetRunningCore().GetReg(static_cast<int>(n));
@@ -232,8 +232,9 @@ public:
     /**
      * Schedules an event to wake up the specified thread after the specified delay
      * @param nanoseconds The time this thread will be allowed to sleep for
+     * @param thread_safe_mode Set when scheduling from a host thread other than the emulation one
      */
-    void WakeAfterDelay(s64 nanoseconds);
+    void WakeAfterDelay(s64 nanoseconds, bool thread_safe_mode = false);
 
     /**
      * Sets the result after the thread awakens (from either WaitSynchronization SVC)
@@ -298,6 +299,9 @@ public:
     u32 nominal_priority; ///< Nominal thread priority, as set by the emulated application
     u32 current_priority; ///< Current thread priority, can be temporarily changed
 
+    /// Links in the ready queue of the thread manager, not saved since the queue rebuilds them
+    Common::ThreadQueueListHook<Thread*> queue_hook;
+
     u64 last_running_ticks; ///< CPU tick when thread was last running
 
     s32 processor_id;
@@ -50,6 +50,7 @@ void VMManager::Reset() {
     ASSERT(!is_locked);
 
     vma_map.clear();
+    last_vma = vma_map.end();
 
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma;
@@ -64,9 +65,15 @@ void VMManager::Reset() {
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
     if (target >= MAX_ADDRESS) {
         return vma_map.end();
-    } else {
-        return std::prev(vma_map.upper_bound(target));
     }
+    // Areas are only shrunk in place when split, so checking the bounds is enough for the last
+    // result to be valid.
+    if (last_vma != vma_map.end() && target >= last_vma->second.base &&
+        target - last_vma->second.base < last_vma->second.size) {
+        return last_vma;
+    }
+    last_vma = std::prev(vma_map.upper_bound(target));
+    return last_vma;
 }
 
 ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, MemoryRef memory,
@@ -358,6 +365,7 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     const VMAIter next_vma = std::next(iter);
     if (next_vma != vma_map.end() && iter->second.CanBeMergedWith(next_vma->second)) {
         iter->second.size += next_vma->second.size;
+        last_vma = vma_map.end();
         vma_map.erase(next_vma);
     }
 
@@ -365,6 +373,7 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
         VMAIter prev_vma = std::prev(iter);
         if (prev_vma->second.CanBeMergedWith(iter->second)) {
             prev_vma->second.size += iter->second.size;
+            last_vma = vma_map.end();
             vma_map.erase(iter);
             iter = prev_vma;
         }
@@ -137,7 +137,11 @@ public:
     /// Clears the address space map, re-initializing with a single free area.
     void Reset();
 
-    /// Finds the VMA in which the given address is included in, or `vma_map.end()`.
+    /**
+     * Finds the VMA in which the given address is included in, or `vma_map.end()`. Lookups tend to
+     * hit the same area repeatedly, for example while translating an IPC buffer page by page, so
+     * the last result is checked before walking the map.
+     */
     VMAHandle FindVMA(VAddr target) const;
 
     // TODO(yuriks): Should these functions actually return the handle?
@@ -260,11 +264,15 @@ private:
     // assert. VMManager locks itself after deserialization.
     bool is_locked{};
 
+    /// Area returned by the last FindVMA call, reset whenever an area is erased from the map.
+    mutable VMAHandle last_vma;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         ar& vma_map;
         ar& page_table;
         if (Archive::is_loading::value) {
+            last_vma = vma_map.end();
             is_locked = true;
         }
     }
@@ -6,8 +6,10 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
-#include <cryptopp/aes.h>
-#include <cryptopp/modes.h>
+#include <future>
+#include <optional>
+#include <span>
+#include <cryptopp/sha.h>
 #include <fmt/format.h>
 #include "common/alignment.h"
 #include "common/common_paths.h"
@@ -17,6 +19,7 @@
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/ncch_container.h"
+#include "core/file_sys/parallel_decryption.h"
 #include "core/file_sys/title_metadata.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/client_session.h"
@@ -79,13 +82,58 @@ struct TicketInfo {
 
 static_assert(sizeof(TicketInfo) == 0x18, "Ticket info structure size is wrong");
 
-class CIAFile::DecryptionState {
+class CIAFile::ContentState {
 public:
-    std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> content;
+    struct Content {
+        /// Kept open until the whole content is written
+        FileUtil::IOFile file;
+        /// Ciphertext block preceding the data still to be decrypted
+        std::array<u8, 16> iv;
+        /// Start of a block whose end is in a later write
+        std::vector<u8> partial_block;
+        /// Of the decrypted data, checked against the TMD once the content is complete
+        CryptoPP::SHA256 hash;
+    };
+
+    std::optional<std::array<u8, 16>> title_key;
+    std::vector<Content> contents;
+    /// Decrypted data of the current write
+    std::vector<u8> buffer;
+
+    /// Decrypts the whole blocks of data, carrying the rest over to the next call
+    std::span<const u8> Decrypt(Content& content, std::span<const u8> data);
 };
 
+std::span<const u8> CIAFile::ContentState::Decrypt(Content& content, std::span<const u8> data) {
+    constexpr std::size_t BlockSize = 16;
+    buffer.resize(content.partial_block.size() + data.size());
+
+    // Complete the block left over by the previous write
+    std::size_t consumed = 0;
+    std::size_t decrypted = 0;
+    if (!content.partial_block.empty()) {
+        consumed = std::min(BlockSize - content.partial_block.size(), data.size());
+        content.partial_block.insert(content.partial_block.end(), data.begin(),
+                                     data.begin() + consumed);
+        if (content.partial_block.size() < BlockSize) {
+            return {};
+        }
+        FileSys::DecryptCBCParallel(*title_key, content.iv, content.partial_block.data(),
+                                    buffer.data(), BlockSize);
+        content.partial_block.clear();
+        decrypted = BlockSize;
+    }
+
+    const std::size_t blocks_size = Common::AlignDown(data.size() - consumed, BlockSize);
+    FileSys::DecryptCBCParallel(*title_key, content.iv, data.data() + consumed,
+                                buffer.data() + decrypted, blocks_size);
+    decrypted += blocks_size;
+    content.partial_block.assign(data.begin() + consumed + blocks_size, data.end());
+    return {buffer.data(), decrypted};
+}
+
 CIAFile::CIAFile(Service::FS::MediaType media_type)
-    : media_type(media_type), decryption_state(std::make_unique<DecryptionState>()) {}
+    : media_type(media_type), content_state(std::make_unique<ContentState>()) {}
 
 CIAFile::~CIAFile() {
     Close();
@@ -135,12 +183,11 @@ ResultCode CIAFile::WriteTitleMetadata() {
     auto content_count = container.GetTitleMetadata().GetContentCount();
     content_written.resize(content_count);
 
-    if (auto title_key = container.GetTicket().GetTitleKey()) {
-        decryption_state->content.resize(content_count);
+    content_state->contents.resize(content_count);
+    content_state->title_key = container.GetTicket().GetTitleKey();
+    if (content_state->title_key) {
         for (std::size_t i = 0; i < content_count; ++i) {
-            auto ctr = tmd.GetContentCTRByIndex(i);
-            decryption_state->content[i].SetKeyWithIV(title_key->data(), title_key->size(),
-                                                      ctr.data());
+            content_state->contents[i].iv = tmd.GetContentCTRByIndex(i);
         }
     } else {
         LOG_ERROR(Service_AM, "Can't get title key from ticket");
@@ -156,7 +203,8 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
     // has been written since we might get a written buffer which contains multiple .app
     // contents or only part of a larger .app's contents.
     const u64 offset_max = offset + length;
-    for (std::size_t i = 0; i < container.GetTitleMetadata().GetContentCount(); i++) {
+    const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+    for (std::size_t i = 0; i < tmd.GetContentCount(); i++) {
         if (content_written[i] < container.GetContentSize(i)) {
             // The size, minimum unwritten offset, and maximum unwritten offset of this content
             const u64 size = container.GetContentSize(i);
@@ -174,33 +222,52 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
 
             // Since the incoming TMD has already been written, we can use GetTitleContentPath
             // to get the content paths to write to.
-            FileSys::TitleMetadata tmd = container.GetTitleMetadata();
-            FileUtil::IOFile file(GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update),
-                                  content_written[i] ? "ab" : "wb");
-
-            if (!file.IsOpen()) {
+            auto& content = content_state->contents[i];
+            if (!content.file.IsOpen()) {
+                const std::string path =
+                    GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update);
+                content.file = FileUtil::IOFile(path, content_written[i] ? "ab" : "wb");
+            }
+            if (!content.file.IsOpen()) {
                 return FileSys::ERROR_INSUFFICIENT_SPACE;
             }
 
-            std::vector<u8> temp(buffer + (range_min - offset),
-                                 buffer + (range_min - offset) + available_to_write);
-
+            const u8* source = buffer + (range_min - offset);
+            std::span<const u8> plain{source, static_cast<std::size_t>(available_to_write)};
             if ((tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
-                if (decryption_state->content.size() <= i) {
+                if (!content_state->title_key) {
                     // TODO: There is probably no correct error to return here. What error should be
                     // returned?
                     return FileSys::ERROR_INSUFFICIENT_SPACE;
                 }
-                decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
+                plain = content_state->Decrypt(content, plain);
             }
 
-            file.WriteBytes(temp.data(), temp.size());
+            // Hash the data while it is being written
+            auto hashed = std::async(std::launch::async, [&content, plain] {
+                content.hash.Update(plain.data(), plain.size());
+            });
+            const std::size_t bytes_written = content.file.WriteBytes(plain.data(), plain.size());
+            hashed.wait();
+            if (bytes_written != plain.size()) {
+                return FileSys::ERROR_INSUFFICIENT_SPACE;
+            }
 
             // Keep tabs on how much of this content ID has been written so new range_min
             // values can be calculated.
             content_written[i] += available_to_write;
             LOG_DEBUG(Service_AM, "Wrote {:x} to content {}, total {:x}", available_to_write, i,
                       content_written[i]);
+
+            if (content_written[i] == size) {
+                content.file.Close();
+                std::array<u8, CryptoPP::SHA256::DIGESTSIZE> digest;
+                content.hash.Final(digest.data());
+                if (digest != tmd.GetContentHashByIndex(i)) {
+                    LOG_ERROR(Service_AM, "Hash mismatch in content {}, the CIA may be corrupted",
+                              i);
+                }
+            }
         }
     }
 
@@ -296,6 +363,7 @@ bool CIAFile::Close() const {
     // Install aborted
     if (!complete) {
         LOG_ERROR(Service_AM, "CIAFile closed prematurely, aborting install...");
+        content_state->contents.clear();
         FileUtil::DeleteDir(GetTitlePath(media_type, container.GetTitleMetadata().GetTitleID()));
         return true;
     }
@@ -341,7 +409,9 @@ bool CIAFile::Close() const {
     return true;
 }
 
-void CIAFile::Flush() const {}
+bool CIAFile::Flush() const {
+    return true;
+}
 
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback) {
@@ -372,15 +442,34 @@ InstallStatus InstallCIA(const std::string& path,
         if (!file.IsOpen())
             return InstallStatus::ErrorFailedToOpenFile;
 
-        std::array<u8, 0x10000> buffer;
+        // The next chunk is read while the current one is decrypted and written
+        constexpr std::size_t ChunkSize = 0x400000;
+        std::vector<u8> buffer(ChunkSize);
+        std::vector<u8> next_buffer(ChunkSize);
+        const auto read_chunk = [&file](std::vector<u8>& dest) {
+            return std::async(std::launch::async,
+                              [&file, &dest] { return file.ReadBytes(dest.data(), dest.size()); });
+        };
+
+        const u64 file_size = file.GetSize();
         std::size_t total_bytes_read = 0;
-        while (total_bytes_read != file.GetSize()) {
-            std::size_t bytes_read = file.ReadBytes(buffer.data(), buffer.size());
+        auto next_read = read_chunk(next_buffer);
+        while (total_bytes_read != file_size) {
+            const std::size_t bytes_read = next_read.get();
+            if (bytes_read == 0) {
+                LOG_ERROR(Service_AM, "Failed to read {}", path);
+                return InstallStatus::ErrorAborted;
+            }
+            std::swap(buffer, next_buffer);
+            if (total_bytes_read + bytes_read != file_size) {
+                next_read = read_chunk(next_buffer);
+            }
+
             auto result = installFile.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                            static_cast<u8*>(buffer.data()));
+                                            buffer.data());
 
             if (update_callback)
-                update_callback(total_bytes_read, file.GetSize());
+                update_callback(total_bytes_read, file_size);
             if (result.Failed()) {
                 LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
                           result.Code().raw);
@@ -1283,7 +1372,9 @@ public:
     bool Close() const override {
         return false;
     }
-    void Flush() const override {}
+    bool Flush() const override {
+        return true;
+    }
 
 private:
     std::shared_ptr<Service::FS::File> file;
@@ -81,7 +81,7 @@ public:
     u64 GetSize() const override;
     bool SetSize(u64 size) const override;
     bool Close() const override;
-    void Flush() const override;
+    bool Flush() const override;
 
 private:
     // Whether it's installing an update, and what step of installation it is at
@@ -97,8 +97,8 @@ private:
     std::vector<u64> content_written;
     Service::FS::MediaType media_type;
 
-    class DecryptionState;
-    std::unique_ptr<DecryptionState> decryption_state;
+    class ContentState;
+    std::unique_ptr<ContentState> content_state;
 };
 
 /**
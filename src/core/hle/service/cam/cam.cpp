@@ -36,6 +36,12 @@ void Module::serialize(Archive& ar, const unsigned int file_version) {
         initialized = true;
     }
     if (Archive::is_loading::value && initialized) {
+        for (PortConfig& port : ports) {
+            if (port.capture_result.valid()) {
+                port.capture_result.wait();
+                port.capture_result = {};
+            }
+        }
         for (int i = 0; i < NumCameras; i++) {
             LoadCameraImplementation(cameras[i], i);
         }
@@ -162,6 +168,12 @@ void Module::CompletionEventCallBack(u64 port_id, s64) {
 
     port.is_receiving = false;
     port.completion_event->Signal();
+
+    // Capture the next frame while the guest handles this one, so that the next receiving process
+    // does not wait for the camera and the conversion of its frame
+    if (port.is_busy) {
+        QueueCapture(static_cast<int>(port_id));
+    }
 }
 
 static constexpr std::size_t MaxVsyncTimings = 5;
@@ -189,9 +201,27 @@ void Module::StartReceiving(int port_id) {
     PortConfig& port = ports[port_id];
     port.is_receiving = true;
 
-    // launches a capture task asynchronously
+    // launches a capture task asynchronously, unless the frame was captured in advance
+    if (!port.capture_result.valid()) {
+        QueueCapture(port_id);
+    }
+
+    // schedules a completion event according to the frame rate. The event will block on the
+    // capture task if it is not finished within the expected time
+    const CameraConfig& camera = cameras[port.camera_id];
+    system.CoreTiming().ScheduleEvent(
+        msToCycles(LATENCY_BY_FRAME_RATE[static_cast<int>(camera.frame_rate)]),
+        completion_event_callback, port_id);
+}
+
+void Module::QueueCapture(int port_id) {
+    if (!capture_worker) {
+        capture_worker = std::make_unique<Common::ThreadWorker>(1, "CAM:Capture");
+    }
+
+    PortConfig& port = ports[port_id];
     CameraConfig& camera = cameras[port.camera_id];
-    port.capture_result = std::async(std::launch::async, [&camera, &port, this] {
+    std::packaged_task<std::vector<u16>()> task{[&camera, &port, this] {
         if (is_camera_reload_pending.exchange(false)) {
             // reinitialize the camera according to new settings
             camera.impl->StopCapture();
@@ -199,13 +229,31 @@ void Module::StartReceiving(int port_id) {
             camera.impl->StartCapture();
         }
         return camera.impl->ReceiveFrame();
-    });
+    }};
+    port.capture_result = task.get_future();
+    capture_worker->QueueWork([task = std::move(task)]() mutable { task(); });
+}
 
-    // schedules a completion event according to the frame rate. The event will block on the
-    // capture task if it is not finished within the expected time
-    system.CoreTiming().ScheduleEvent(
-        msToCycles(LATENCY_BY_FRAME_RATE[static_cast<int>(camera.frame_rate)]),
-        completion_event_callback, port_id);
+void Module::DropPrefetchedFrame(int port_id) {
+    PortConfig& port = ports[port_id];
+    if (!port.is_receiving && port.capture_result.valid()) {
+        port.capture_result.wait();
+        port.capture_result = {};
+    }
+}
+
+Camera::CameraInterface& Module::ConfigureCamera(int camera_id) {
+    for (int port_id = 0; port_id < static_cast<int>(ports.size()); ++port_id) {
+        PortConfig& port = ports[port_id];
+        if (port.camera_id != camera_id) {
+            continue;
+        }
+        if (port.is_receiving && port.capture_result.valid()) {
+            port.capture_result.wait();
+        }
+        DropPrefetchedFrame(port_id);
+    }
+    return *cameras[camera_id].impl;
 }
 
 void Module::CancelReceiving(int port_id) {
@@ -220,7 +268,7 @@ void Module::CancelReceiving(int port_id) {
 void Module::ActivatePort(int port_id, int camera_id) {
     if (ports[port_id].is_busy && ports[port_id].camera_id != camera_id) {
         CancelReceiving(port_id);
-        cameras[ports[port_id].camera_id].impl->StopCapture();
+        ConfigureCamera(ports[port_id].camera_id).StopCapture();
         ports[port_id].is_busy = false;
     }
     ports[port_id].is_active = true;
@@ -301,7 +349,7 @@ void Module::Interface::StopCapture(Kernel::HLERequestContext& ctx) {
         for (int i : port_select) {
             if (cam->ports[i].is_busy) {
                 cam->CancelReceiving(i);
-                cam->cameras[cam->ports[i].camera_id].impl->StopCapture();
+                cam->ConfigureCamera(cam->ports[i].camera_id).StopCapture();
                 cam->ports[i].is_busy = false;
             } else {
                 LOG_WARNING(Service_CAM, "port {} already stopped", i);
@@ -682,7 +730,7 @@ void Module::Interface::Activate(Kernel::HLERequestContext& ctx) {
             for (int i = 0; i < 2; ++i) {
                 if (cam->ports[i].is_busy) {
                     cam->CancelReceiving(i);
-                    cam->cameras[cam->ports[i].camera_id].impl->StopCapture();
+                    cam->ConfigureCamera(cam->ports[i].camera_id).StopCapture();
                     cam->ports[i].is_busy = false;
                 }
                 cam->ports[i].is_active = false;
@@ -723,10 +771,11 @@ void Module::Interface::SwitchContext(Kernel::HLERequestContext& ctx) {
         for (int camera : camera_select) {
             cam->cameras[camera].current_context = context;
             const ContextConfig& context_config = cam->cameras[camera].contexts[context];
-            cam->cameras[camera].impl->SetFlip(context_config.flip);
-            cam->cameras[camera].impl->SetEffect(context_config.effect);
-            cam->cameras[camera].impl->SetFormat(context_config.format);
-            cam->cameras[camera].impl->SetResolution(context_config.resolution);
+            Camera::CameraInterface& impl = cam->ConfigureCamera(camera);
+            impl.SetFlip(context_config.flip);
+            impl.SetEffect(context_config.effect);
+            impl.SetFormat(context_config.format);
+            impl.SetResolution(context_config.resolution);
         }
         rb.Push(RESULT_SUCCESS);
     } else {
@@ -751,7 +800,7 @@ void Module::Interface::FlipImage(Kernel::HLERequestContext& ctx) {
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].flip = flip;
                 if (cam->cameras[camera].current_context == context) {
-                    cam->cameras[camera].impl->SetFlip(flip);
+                    cam->ConfigureCamera(camera).SetFlip(flip);
                 }
             }
         }
@@ -784,7 +833,7 @@ void Module::Interface::SetDetailSize(Kernel::HLERequestContext& ctx) {
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].resolution = resolution;
                 if (cam->cameras[camera].current_context == context) {
-                    cam->cameras[camera].impl->SetResolution(resolution);
+                    cam->ConfigureCamera(camera).SetResolution(resolution);
                 }
             }
         }
@@ -814,7 +863,7 @@ void Module::Interface::SetSize(Kernel::HLERequestContext& ctx) {
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].resolution = PRESET_RESOLUTION[size];
                 if (cam->cameras[camera].current_context == context) {
-                    cam->cameras[camera].impl->SetResolution(PRESET_RESOLUTION[size]);
+                    cam->ConfigureCamera(camera).SetResolution(PRESET_RESOLUTION[size]);
                 }
             }
         }
@@ -838,7 +887,7 @@ void Module::Interface::SetFrameRate(Kernel::HLERequestContext& ctx) {
     if (camera_select.IsValid()) {
         for (int camera : camera_select) {
             cam->cameras[camera].frame_rate = frame_rate;
-            cam->cameras[camera].impl->SetFrameRate(frame_rate);
+            cam->ConfigureCamera(camera).SetFrameRate(frame_rate);
         }
         rb.Push(RESULT_SUCCESS);
     } else {
@@ -862,7 +911,7 @@ void Module::Interface::SetEffect(Kernel::HLERequestContext& ctx) {
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].effect = effect;
                 if (cam->cameras[camera].current_context == context) {
-                    cam->cameras[camera].impl->SetEffect(effect);
+                    cam->ConfigureCamera(camera).SetEffect(effect);
                 }
             }
         }
@@ -889,7 +938,7 @@ void Module::Interface::SetOutputFormat(Kernel::HLERequestContext& ctx) {
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].format = format;
                 if (cam->cameras[camera].current_context == context) {
-                    cam->cameras[camera].impl->SetFormat(format);
+                    cam->ConfigureCamera(camera).SetFormat(format);
                 }
             }
         }
@@ -996,9 +1045,10 @@ ResultCode Module::SetPackageParameter(const PackageParameterType& package) {
                 context.flip = package.flip;
                 context.resolution = package.GetResolution();
                 if (context_id == camera.current_context) {
-                    camera.impl->SetEffect(context.effect);
-                    camera.impl->SetFlip(context.flip);
-                    camera.impl->SetResolution(context.resolution);
+                    Camera::CameraInterface& impl = ConfigureCamera(camera_id);
+                    impl.SetEffect(context.effect);
+                    impl.SetFlip(context.flip);
+                    impl.SetResolution(context.resolution);
                 }
             }
         }
@@ -1063,6 +1113,12 @@ void Module::Interface::DriverInitialize(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x39, 0, 0);
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
+    // The camera implementations are replaced, make sure no capture is still using them
+    cam->CancelReceiving(0);
+    cam->CancelReceiving(1);
+    cam->DropPrefetchedFrame(0);
+    cam->DropPrefetchedFrame(1);
+
     for (int camera_id = 0; camera_id < NumCameras; ++camera_id) {
         CameraConfig& camera = cam->cameras[camera_id];
         camera.current_context = 0;
@@ -1095,6 +1151,8 @@ void Module::Interface::DriverFinalize(Kernel::HLERequestContext& ctx) {
 
     cam->CancelReceiving(0);
     cam->CancelReceiving(1);
+    cam->DropPrefetchedFrame(0);
+    cam->DropPrefetchedFrame(1);
 
     for (CameraConfig& camera : cam->cameras) {
         camera.impl = nullptr;
@@ -1130,6 +1188,8 @@ Module::Module(Core::System& system) : system(system) {
 Module::~Module() {
     CancelReceiving(0);
     CancelReceiving(1);
+    DropPrefetchedFrame(0);
+    DropPrefetchedFrame(1);
 }
 
 void Module::ReloadCameraDevices() {
@@ -16,6 +16,7 @@
 #include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/global.h"
 #include "core/hle/result.h"
 #include "core/hle/service/cam/cam_params.h"
@@ -643,6 +644,16 @@ private:
     // and is_receiving = false.
     void StartReceiving(int port_id);
 
+    // Queues the capture of the next frame of the port on the camera worker.
+    void QueueCapture(int port_id);
+
+    // Waits for a frame captured ahead of the next receiving process and discards it.
+    void DropPrefetchedFrame(int port_id);
+
+    // Returns the implementation of the camera for a setting change, waiting for the frames it is
+    // capturing first so that the change applies to the next frame received.
+    Camera::CameraInterface& ConfigureCamera(int camera_id);
+
     // Cancels any ongoing receiving processes at the specified port. This is used by functions that
     // stop capturing.
     // TODO: what is the exact behaviour on real 3DS when stopping capture during an ongoing
@@ -721,7 +732,9 @@ private:
 
         std::deque<s64> vsync_timings;
 
-        std::future<std::vector<u16>> capture_result; // will hold the received frame.
+        // will hold the received frame. Once a receiving process completes, the next frame is
+        // captured in advance while the port is busy.
+        std::future<std::vector<u16>> capture_result;
         Kernel::Process* dest_process{nullptr};
         VAddr dest{0};    // the destination address of the receiving process
         u32 dest_size{0}; // the destination size of the receiving process
@@ -763,6 +776,7 @@ private:
     Core::TimingEventType* completion_event_callback;
     Core::TimingEventType* vsync_interrupt_event_callback;
     std::atomic<bool> is_camera_reload_pending{false};
+    std::unique_ptr<Common::ThreadWorker> capture_worker;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version);
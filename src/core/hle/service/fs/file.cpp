@@ -5,6 +5,7 @@
 #include <boost/serialization/unique_ptr.hpp>
 #include "common/archives.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/file_backend.h"
@@ -18,6 +19,9 @@
 SERIALIZE_EXPORT_IMPL(Service::FS::File)
 SERIALIZE_EXPORT_IMPL(Service::FS::FileSessionSlot)
 
+MICROPROFILE_DEFINE(FS_File_Read, "FS", "File Read", MP_RGB(200, 150, 50));
+MICROPROFILE_DEFINE(FS_File_Write, "FS", "File Write", MP_RGB(200, 120, 50));
+
 namespace Service::FS {
 
 template <class Archive>
@@ -54,6 +58,7 @@ File::File(Kernel::KernelSystem& kernel)
 }
 
 void File::Read(Kernel::HLERequestContext& ctx) {
+    MICROPROFILE_SCOPE(FS_File_Read);
     IPC::RequestParser rp(ctx, 0x0802, 3, 2);
     u64 offset = rp.Pop<u64>();
     u32 length = rp.Pop<u32>();
@@ -70,31 +75,76 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     // This file session might have a specific offset from where to start reading, apply it.
     offset += file->offset;
 
+    const s64 delay = static_cast<s64>(backend->GetReadDelayNs(length));
+
+    // Flush and invalidate the cached surfaces of the target here, the workers must not touch the
+    // rasterizer cache
+    const auto spans = length <= buffer.GetSize() ? buffer.GetHostSpans(0, length, true)
+                                                  : Memory::HostSpans{};
+    if (spans.empty()) {
+        // Not backed by regular memory, the data has to go through the memory system
+        std::scoped_lock lock{backend_mutex};
+        LogOutOfBoundsRead(offset, length);
+
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+        std::vector<u8> data(length);
+        const ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
+        if (read.Failed()) {
+            rb.Push(read.Code());
+            rb.Push<u32>(0);
+        } else {
+            buffer.Write(data.data(), 0, *read);
+            rb.Push(RESULT_SUCCESS);
+            rb.Push<u32>(static_cast<u32>(*read));
+        }
+        rb.PushMappedBuffer(buffer);
+        ctx.SleepClientThread("file::read", std::chrono::nanoseconds{delay}, nullptr);
+        return;
+    }
+
+    // The read itself happens on the HLE workers while the guest waits out the emulated delay,
+    // straight into the guest buffer, which lives as long as the context. Only the delay
+    // generator is used here, which the workers never change.
+    ctx.RunAsyncWithDelay(
+        delay, [this, offset, length, spans, &buffer](Kernel::HLERequestContext& ctx) {
+            std::scoped_lock lock{backend_mutex};
+            LogOutOfBoundsRead(offset, length);
+
+            ResultVal<std::size_t> read = MakeResult<std::size_t>(0);
+            std::size_t total_read = 0;
+            for (const std::span<u8> span : spans) {
+                read = backend->Read(offset + total_read, span.size(), span.data());
+                if (read.Failed()) {
+                    break;
+                }
+                total_read += *read;
+                if (*read < span.size()) {
+                    break;
+                }
+            }
+
+            IPC::RequestBuilder rb(ctx, 0x0802, 2, 2);
+            if (read.Failed()) {
+                rb.Push(read.Code());
+                rb.Push<u32>(0);
+            } else {
+                rb.Push(RESULT_SUCCESS);
+                rb.Push<u32>(static_cast<u32>(total_read));
+            }
+            rb.PushMappedBuffer(buffer);
+        });
+}
+
+void File::LogOutOfBoundsRead(u64 offset, u32 length) const {
     if (offset + length > backend->GetSize()) {
         LOG_ERROR(Service_FS,
                   "Reading from out of bounds offset=0x{:x} length=0x{:08X} file_size=0x{:x}",
                   offset, length, backend->GetSize());
     }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
-    if (read.Failed()) {
-        rb.Push(read.Code());
-        rb.Push<u32>(0);
-    } else {
-        buffer.Write(data.data(), 0, *read);
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*read));
-    }
-    rb.PushMappedBuffer(buffer);
-
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
-    ctx.SleepClientThread("file::read", read_timeout_ns, nullptr);
 }
 
 void File::Write(Kernel::HLERequestContext& ctx) {
+    MICROPROFILE_SCOPE(FS_File_Write);
     IPC::RequestParser rp(ctx, 0x0803, 4, 2);
     u64 offset = rp.Pop<u64>();
     u32 length = rp.Pop<u32>();
@@ -115,9 +165,35 @@ void File::Write(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
+    std::scoped_lock lock{backend_mutex};
+
+    // Write straight from the guest buffer when it is backed by regular memory. The spans make up
+    // a single guest write, so only the last one flushes.
+    const auto spans = length <= buffer.GetSize() ? buffer.GetHostSpans(0, length, false)
+                                                  : Memory::HostSpans{};
+    ResultVal<std::size_t> written;
+    if (!spans.empty()) {
+        std::size_t total_written = 0;
+        for (const std::span<u8> span : spans) {
+            const bool last = total_written + span.size() == length;
+            written = backend->Write(offset + total_written, span.size(), flush != 0 && last,
+                                     span.data());
+            if (written.Failed()) {
+                break;
+            }
+            total_written += *written;
+            if (*written < span.size()) {
+                break;
+            }
+        }
+        if (written.Succeeded()) {
+            written = MakeResult<std::size_t>(total_written);
+        }
+    } else {
+        std::vector<u8> data(length);
+        buffer.Read(data.data(), 0, data.size());
+        written = backend->Write(offset, data.size(), flush != 0, data.data());
+    }
 
     // Update file size
     file->size = backend->GetSize();
@@ -157,6 +233,7 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
     }
 
     file->size = size;
+    std::scoped_lock lock{backend_mutex};
     backend->SetSize(size);
     rb.Push(RESULT_SUCCESS);
 }
@@ -169,9 +246,16 @@ void File::Close(Kernel::HLERequestContext& ctx) {
         LOG_WARNING(Service_FS, "Closing File backend but {} clients still connected",
                     connected_sessions.size());
 
-    backend->Close();
+    // Buffered writes reach the host file here, the guest has to know when they were lost. The
+    // result of Close itself is not meaningful for the read-only backends.
+    bool flushed;
+    {
+        std::scoped_lock lock{backend_mutex};
+        flushed = backend->Flush();
+        backend->Close();
+    }
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(RESULT_SUCCESS);
+    rb.Push(flushed ? RESULT_SUCCESS : FileSys::ERROR_INSUFFICIENT_SPACE);
 }
 
 void File::Flush(Kernel::HLERequestContext& ctx) {
@@ -187,8 +271,8 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    backend->Flush();
-    rb.Push(RESULT_SUCCESS);
+    std::scoped_lock lock{backend_mutex};
+    rb.Push(backend->Flush() ? RESULT_SUCCESS : FileSys::ERROR_INSUFFICIENT_SPACE);
 }
 
 void File::SetPriority(Kernel::HLERequestContext& ctx) {
@@ -224,7 +308,10 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
 
     slot->priority = original_file->priority;
     slot->offset = 0;
-    slot->size = backend->GetSize();
+    {
+        std::scoped_lock lock{backend_mutex};
+        slot->size = backend->GetSize();
+    }
     slot->subfile = false;
 
     rb.Push(RESULT_SUCCESS);
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <boost/serialization/base_object.hpp>
 #include "core/file_sys/archive_backend.h"
 #include "core/global.h"
@@ -73,8 +74,13 @@ private:
     void OpenLinkFile(Kernel::HLERequestContext& ctx);
     void OpenSubFile(Kernel::HLERequestContext& ctx);
 
+    void LogOutOfBoundsRead(u64 offset, u32 length) const;
+
     Kernel::KernelSystem& kernel;
 
+    /// Keeps the backend from being used by other requests while a read runs asynchronously
+    std::mutex backend_mutex;
+
     File(Kernel::KernelSystem& kernel);
     File();
 
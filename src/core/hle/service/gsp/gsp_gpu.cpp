@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <span>
 #include <vector>
 #include "common/archives.h"
 #include "common/bit_field.h"
@@ -486,6 +488,65 @@ void GSP_GPU::SignalInterrupt(InterruptId interrupt_id) {
 
 MICROPROFILE_DEFINE(GPU_GSP_DMA, "GPU", "GSP DMA", MP_RGB(100, 0, 255));
 
+/// Applies a cache maintenance operation to the ranges, merging overlapping and adjacent ones
+static void FlushMergedRegions(std::vector<std::pair<u64, u64>>& ranges, Memory::FlushMode mode) {
+    std::sort(ranges.begin(), ranges.end());
+    std::size_t i = 0;
+    while (i < ranges.size()) {
+        const u64 start = ranges[i].first;
+        u64 end = ranges[i].second;
+        for (i++; i < ranges.size() && ranges[i].first <= end; i++) {
+            end = std::max(end, ranges[i].second);
+        }
+        Memory::RasterizerFlushVirtualRegion(static_cast<VAddr>(start),
+                                             static_cast<u32>(end - start), mode);
+    }
+}
+
+/**
+ * Executes consecutive DMA requests. The sources of all of them are flushed and the destinations
+ * invalidated before the first copy, which is equivalent to doing it per request as the copies
+ * only touch memory, but lets small adjacent requests share a single walk of the cache.
+ */
+static void ExecuteDmaRequests(std::span<const Command* const> commands) {
+    if (commands.empty()) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_GSP_DMA);
+    Memory::MemorySystem& memory = Core::System::GetInstance().Memory();
+
+    // TODO: Consider attempting rasterizer-accelerated surface blit if that usage is ever
+    // possible/likely
+    std::vector<std::pair<u64, u64>> flush_ranges;
+    std::vector<std::pair<u64, u64>> invalidate_ranges;
+    flush_ranges.reserve(commands.size());
+    invalidate_ranges.reserve(commands.size());
+    for (const Command* command : commands) {
+        const auto& dma = command->dma_request;
+        if (dma.size == 0) {
+            continue;
+        }
+        flush_ranges.emplace_back(dma.source_address, u64{dma.source_address} + dma.size);
+        invalidate_ranges.emplace_back(dma.dest_address, u64{dma.dest_address} + dma.size);
+    }
+    FlushMergedRegions(flush_ranges, Memory::FlushMode::Flush);
+    FlushMergedRegions(invalidate_ranges, Memory::FlushMode::Invalidate);
+
+    for (const Command* command : commands) {
+        // TODO(Subv): These memory accesses should not go through the application's memory
+        // mapping. They should go through the GSP module's memory mapping.
+        memory.CopyBlock(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                         command->dma_request.dest_address, command->dma_request.source_address,
+                         command->dma_request.size);
+        SignalInterrupt(InterruptId::DMA);
+
+        if (Pica::g_debug_context)
+            Pica::g_debug_context->OnEvent(Pica::DebugContext::Event::GSPCommandProcessed,
+                                           (void*)command);
+    }
+}
+
 /// Executes the next GSP command
 static void ExecuteCommand(const Command& command, u32 thread_id) {
     // Utility function to convert register ID to address
@@ -497,24 +558,10 @@ static void ExecuteCommand(const Command& command, u32 thread_id) {
 
     // GX request DMA - typically used for copying memory from GSP heap to VRAM
     case CommandId::REQUEST_DMA: {
-        MICROPROFILE_SCOPE(GPU_GSP_DMA);
-        Memory::MemorySystem& memory = Core::System::GetInstance().Memory();
-
-        // TODO: Consider attempting rasterizer-accelerated surface blit if that usage is ever
-        // possible/likely
-        Memory::RasterizerFlushVirtualRegion(command.dma_request.source_address,
-                                             command.dma_request.size, Memory::FlushMode::Flush);
-        Memory::RasterizerFlushVirtualRegion(command.dma_request.dest_address,
-                                             command.dma_request.size,
-                                             Memory::FlushMode::Invalidate);
-
-        // TODO(Subv): These memory accesses should not go through the application's memory mapping.
-        // They should go through the GSP module's memory mapping.
-        memory.CopyBlock(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
-                         command.dma_request.dest_address, command.dma_request.source_address,
-                         command.dma_request.size);
-        SignalInterrupt(InterruptId::DMA);
-        break;
+        const Command* const dma_command = &command;
+        ExecuteDmaRequests({&dma_command, 1});
+        // The debug event was already sent
+        return;
     }
     // TODO: This will need some rework in the future. (why?)
     case CommandId::SUBMIT_GPU_CMDLIST: {
@@ -640,21 +687,33 @@ void GSP_GPU::SetLcdForceBlack(Kernel::HLERequestContext& ctx) {
 void GSP_GPU::TriggerCmdReqQueue(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0xC, 0, 0);
 
+    // Consecutive DMA requests are executed together once a different command or the end of the
+    // queues is reached
+    std::vector<const Command*> dma_requests;
+
     // Iterate through each thread's command queue...
     for (unsigned thread_id = 0; thread_id < 0x4; ++thread_id) {
         CommandBuffer* command_buffer = (CommandBuffer*)GetCommandBuffer(shared_memory, thread_id);
 
         // Iterate through each command...
         for (unsigned i = 0; i < command_buffer->number_commands; ++i) {
-            g_debugger.GXCommandProcessed((u8*)&command_buffer->commands[i]);
+            const Command& command = command_buffer->commands[i];
+            g_debugger.GXCommandProcessed((u8*)&command);
 
             // Decode and execute command
-            ExecuteCommand(command_buffer->commands[i], thread_id);
+            if (command.id == CommandId::REQUEST_DMA) {
+                dma_requests.push_back(&command);
+            } else {
+                ExecuteDmaRequests(dma_requests);
+                dma_requests.clear();
+                ExecuteCommand(command, thread_id);
+            }
 
             // Indicates that command has completed
             command_buffer->number_commands.Assign(command_buffer->number_commands - 1);
         }
     }
+    ExecuteDmaRequests(dma_requests);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
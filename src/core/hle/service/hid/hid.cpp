@@ -110,6 +110,7 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
 
     if (is_device_reload_pending.exchange(false))
         LoadInputDevices();
+    last_pad_sample_time = Core::PerfStats::Clock::now();
 
     using namespace Settings::NativeButton;
     state.a.Assign(buttons[A - BUTTON_HID_BEGIN]->GetStatus());
@@ -218,9 +219,9 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
 
     // TODO(xperia64): How the 3D Slider is updated by the HID module needs to be RE'd
     // and possibly moved to its own Core::Timing event.
-    mem->pad.sliderstate_3d = (Settings::values.factor_3d.GetValue() / 100.0f);
-    system.Kernel().GetSharedPageHandler().Set3DSlider(Settings::values.factor_3d.GetValue() /
-                                                       100.0f);
+    const float slider_3d = Settings::Slider3D();
+    mem->pad.sliderstate_3d = slider_3d;
+    system.Kernel().GetSharedPageHandler().Set3DSlider(slider_3d);
 
     // Reschedule recurrent event
     system.CoreTiming().ScheduleEvent(pad_update_ticks - cycles_late, pad_update_event);
@@ -463,6 +464,17 @@ const PadState& Module::GetState() const {
     return state;
 }
 
+void Module::OnVBlank() {
+    if (Settings::values.late_input_sampling) {
+        system.CoreTiming().UnscheduleEvent(pad_update_event, 0);
+        UpdatePadCallback(0, 0);
+    }
+    if (system.perf_stats && last_pad_sample_time != Core::PerfStats::Clock::time_point{}) {
+        system.perf_stats->RecordInputLatency(Core::PerfStats::Clock::now() -
+                                              last_pad_sample_time);
+    }
+}
+
 std::shared_ptr<Module> GetModule(Core::System& system) {
     auto hid = system.ServiceManager().GetService<Service::HID::Module::Interface>("hid:USER");
     if (!hid)
@@ -17,6 +17,7 @@
 #include "core/core_timing.h"
 #include "core/frontend/input.h"
 #include "core/hle/service/service.h"
+#include "core/perf_stats.h"
 
 namespace Core {
 class System;
@@ -300,6 +301,13 @@ public:
 
     const PadState& GetState() const;
 
+    /**
+     * Called at VBlank once the frame was paced, right before the game is woken up for the next
+     * frame. With late input sampling the pad is sampled again here, and the periodic updates
+     * continue from this point.
+     */
+    void OnVBlank();
+
     // Updating period for each HID device. These empirical values are measured from a 11.2 3DS.
     static constexpr u64 pad_update_ticks = BASE_CLOCK_RATE_ARM11 / 234;
     static constexpr u64 accelerometer_update_ticks = BASE_CLOCK_RATE_ARM11 / 104;
@@ -343,6 +351,9 @@ private:
     int enable_accelerometer_count = 0; // positive means enabled
     int enable_gyroscope_count = 0;     // positive means enabled
 
+    /// Walltime of the last pad update, to measure the age of the input the guest reads
+    Core::PerfStats::Clock::time_point last_pad_sample_time{};
+
     Core::TimingEventType* pad_update_event;
     Core::TimingEventType* accelerometer_update_event;
     Core::TimingEventType* gyroscope_update_event;
@@ -54,24 +54,69 @@ const ResultCode ERROR_WRONG_CERT_HANDLE = // 0xD8A0A0C9
 const ResultCode ERROR_CERT_ALREADY_SET = // 0xD8A0A03D
     ResultCode(61, ErrorModule::HTTP, ErrorSummary::InvalidState, ErrorLevel::Permanent);
 
+#ifdef ENABLE_WEB_SERVICE
+/// Idle connections kept per server, a title rarely has more requests to one server at once
+constexpr std::size_t MaxIdleClientsPerKey = 2;
+
+std::unique_ptr<httplib::Client> ClientPool::Acquire(const Key& key) {
+    std::scoped_lock lock{mutex};
+    const auto it = idle_clients.find(key);
+    if (it == idle_clients.end() || it->second.empty()) {
+        return nullptr;
+    }
+    std::unique_ptr<httplib::Client> client = std::move(it->second.back());
+    it->second.pop_back();
+    return client;
+}
+
+void ClientPool::Release(const Key& key, std::unique_ptr<httplib::Client> client) {
+    std::scoped_lock lock{mutex};
+    auto& clients = idle_clients[key];
+    if (clients.size() < MaxIdleClientsPerKey) {
+        clients.push_back(std::move(client));
+    }
+}
+#endif
+
+Context::~Context() {
+    // The request workers may still be sending the request
+    if (request_future.valid()) {
+        request_future.wait();
+    }
+}
+
 void Context::MakeRequest() {
     ASSERT(state == RequestState::NotStarted);
 
 #ifdef ENABLE_WEB_SERVICE
-    std::unique_ptr<httplib::Client> client = std::make_unique<httplib::Client>(url.c_str());
-    SSL_CTX* ctx = client->ssl_context();
-    if (ctx) {
-        if (auto client_cert = ssl_config.client_cert_ctx.lock()) {
-            SSL_CTX_use_certificate_ASN1(ctx, static_cast<int>(client_cert->certificate.size()),
-                                         client_cert->certificate.data());
-            SSL_CTX_use_PrivateKey_ASN1(EVP_PKEY_RSA, ctx, client_cert->private_key.data(),
-                                        static_cast<long>(client_cert->private_key.size()));
+    // The URL still has the terminator read from the guest buffer
+    const std::string_view full_url{url.c_str()};
+    const std::size_t scheme_end = full_url.find("://");
+    const std::size_t path_start =
+        full_url.find('/', scheme_end == std::string_view::npos ? 0 : scheme_end + 3);
+
+    const auto client_cert = ssl_config.client_cert_ctx.lock();
+    const ClientPool::Key key{std::string{full_url.substr(0, path_start)},
+                              client_cert ? client_cert->handle : 0};
+    std::unique_ptr<httplib::Client> client = client_pool->Acquire(key);
+    if (!client) {
+        client = std::make_unique<httplib::Client>(key.scheme_host_port);
+        client->set_keep_alive(true);
+        SSL_CTX* ctx = client->ssl_context();
+        if (ctx) {
+            if (client_cert) {
+                SSL_CTX_use_certificate_ASN1(ctx,
+                                             static_cast<int>(client_cert->certificate.size()),
+                                             client_cert->certificate.data());
+                SSL_CTX_use_PrivateKey_ASN1(EVP_PKEY_RSA, ctx, client_cert->private_key.data(),
+                                            static_cast<long>(client_cert->private_key.size()));
+            }
+
+            // TODO(B3N30): Check for SSLOptions-Bits and set the verify method accordingly
+            // https://www.3dbrew.org/wiki/SSL_Services#SSLOpt
+            // Hack: Since for now RootCerts are not implemented we set the VerifyMode to None.
+            SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
         }
-
-        // TODO(B3N30): Check for SSLOptions-Bits and set the verify method accordingly
-        // https://www.3dbrew.org/wiki/SSL_Services#SSLOpt
-        // Hack: Since for now RootCerts are not implemented we set the VerifyMode to None.
-        SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
     }
 
     state = RequestState::InProgress;
@@ -86,7 +131,8 @@ void Context::MakeRequest() {
     httplib::Request request;
     httplib::Error error;
     request.method = request_method_strings.at(method);
-    request.path = url;
+    request.path = path_start == std::string_view::npos ? "/"
+                                                        : std::string{full_url.substr(path_start)};
     // TODO(B3N30): Add post data body
     request.progress = [this](u64 current, u64 total) -> bool {
         // TODO(B3N30): Is there a state that shows response header are available
@@ -106,6 +152,7 @@ void Context::MakeRequest() {
         LOG_DEBUG(Service_HTTP, "Request successful");
         // TODO(B3N30): Verify this state on HW
         state = RequestState::ReadyToDownloadContent;
+        client_pool->Release(key, std::move(client));
     }
 #else
     LOG_ERROR(Service_HTTP, "Tried to make request but WebServices is not enabled in this build");
@@ -222,10 +269,7 @@ void HTTP_C::BeginRequest(Kernel::HLERequestContext& ctx) {
     // trying to enqueue any more will either fail (BeginRequestAsync), or block (BeginRequest)
     // Note that you only can have 8 Contexts at a time. So this difference shouldn't matter
     // Then there are 3? worker threads that pop the requests from the queue and send them
-    // For now make every request async in it's own thread.
-
-    itr->second.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second));
+    QueueRequest(itr->second);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -275,10 +319,7 @@ void HTTP_C::BeginRequestAsync(Kernel::HLERequestContext& ctx) {
     // trying to enqueue any more will either fail (BeginRequestAsync), or block (BeginRequest)
     // Note that you only can have 8 Contexts at a time. So this difference shouldn't matter
     // Then there are 3? worker threads that pop the requests from the queue and send them
-    // For now make every request async in it's own thread.
-
-    itr->second.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second));
+    QueueRequest(itr->second);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -348,6 +389,9 @@ void HTTP_C::CreateContext(Kernel::HLERequestContext& ctx) {
     contexts[context_counter].socket_buffer_size = 0;
     contexts[context_counter].handle = context_counter;
     contexts[context_counter].session_id = session_data->session_id;
+#ifdef ENABLE_WEB_SERVICE
+    contexts[context_counter].client_pool = &client_pool;
+#endif
 
     session_data->num_http_contexts++;
 
@@ -791,6 +835,12 @@ void HTTP_C::Finalize(Kernel::HLERequestContext& ctx) {
     LOG_WARNING(Service_HTTP, "(STUBBED) called");
 }
 
+void HTTP_C::QueueRequest(Context& context) {
+    auto task = std::make_shared<std::packaged_task<void()>>([&context] { context.MakeRequest(); });
+    context.request_future = task->get_future();
+    request_workers.QueueWork([task] { (*task)(); });
+}
+
 void HTTP_C::DecryptClCertA() {
     static constexpr u32 iv_length = 16;
 
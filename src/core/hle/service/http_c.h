@@ -5,7 +5,9 @@
 #pragma once
 
 #include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -23,6 +25,7 @@
 #endif
 #include <httplib.h>
 #endif
+#include "common/thread_worker.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/service/service.h"
 
@@ -112,6 +115,31 @@ private:
     friend class boost::serialization::access;
 };
 
+#ifdef ENABLE_WEB_SERVICE
+/// Keeps the connections of finished requests open, so that further requests to the same server
+/// skip the TCP and TLS handshakes.
+class ClientPool {
+public:
+    /// Requests may share a client if they use the same server and the same client cert
+    struct Key {
+        std::string scheme_host_port;
+        ClientCertContext::Handle client_cert; ///< 0 when no client cert is used
+
+        auto operator<=>(const Key&) const = default;
+    };
+
+    /// Takes an idle client for the key, returns nullptr if there is none.
+    std::unique_ptr<httplib::Client> Acquire(const Key& key);
+
+    /// Gives back a client after a successful request, so that its connection can be reused.
+    void Release(const Key& key, std::unique_ptr<httplib::Client> client);
+
+private:
+    std::mutex mutex;
+    std::map<Key, std::vector<std::unique_ptr<httplib::Client>>> idle_clients;
+};
+#endif
+
 /// Represents an HTTP context.
 class Context final {
 public:
@@ -120,6 +148,7 @@ public:
     Context() = default;
     Context(const Context&) = delete;
     Context& operator=(const Context&) = delete;
+    ~Context();
 
     void MakeRequest();
 
@@ -215,6 +244,7 @@ public:
     std::atomic<u64> total_download_size_bytes;
 #ifdef ENABLE_WEB_SERVICE
     httplib::Response response;
+    ClientPool* client_pool = nullptr;
 #endif
 };
 
@@ -410,6 +440,9 @@ private:
 
     void DecryptClCertA();
 
+    /// Runs the request of the context on the request workers
+    void QueueRequest(Context& context);
+
     std::shared_ptr<Kernel::SharedMemory> shared_memory = nullptr;
 
     /// The next number to use when a new HTTP session is initalized.
@@ -421,9 +454,19 @@ private:
     /// The next handle number to use when a new ClientCert context is created.
     ClientCertContext::Handle client_certs_counter = 0;
 
+#ifdef ENABLE_WEB_SERVICE
+    /// Connections shared by the requests of all contexts
+    ClientPool client_pool;
+#endif
+
     /// Global list of HTTP contexts currently opened.
     std::unordered_map<Context::Handle, Context> contexts;
 
+    /// Hardware sends the queued requests from about 3 threads as well. Destructed before the
+    /// contexts, dropping the requests that haven't started yet.
+    static constexpr std::size_t NumRequestWorkers = 3;
+    Common::ThreadWorker request_workers{NumRequestWorkers, "HTTP:Worker"};
+
     /// Global list of  ClientCert contexts currently opened.
     std::unordered_map<ClientCertContext::Handle, std::shared_ptr<ClientCertContext>> client_certs;
 
@@ -195,6 +195,28 @@ VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
     return SegmentTagToAddress(symbol_entry.symbol_position);
 }
 
+const ExportedSymbols& CROHelper::GetExportedSymbols(ExportIndex& export_index) const {
+    const auto [it, inserted] = export_index.try_emplace(module_address);
+    if (!inserted) {
+        return it->second;
+    }
+
+    ExportedSymbols& symbols = it->second;
+    u32 export_strings_size = GetField(ExportStringsSize);
+    u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
+    symbols.reserve(export_named_symbol_num);
+    for (u32 i = 0; i < export_named_symbol_num; ++i) {
+        ExportNamedSymbolEntry entry;
+        GetEntry(system.Memory(), i, entry);
+        VAddr symbol_address = SegmentTagToAddress(entry.symbol_position);
+        if (symbol_address != 0) {
+            symbols.emplace(system.Memory().ReadCString(entry.name_offset, export_strings_size),
+                            symbol_address);
+        }
+    }
+    return symbols;
+}
+
 ResultCode CROHelper::RebaseHeader(u32 cro_size) {
     ResultCode error = CROFormatError(0x11);
 
@@ -747,7 +769,18 @@ void CROHelper::UnrebaseHeader() {
     }
 }
 
-ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
+ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address, ExportIndex& export_index) {
+    // Gathers the exports of every module once, in the order they are searched
+    std::vector<std::pair<CROHelper, const ExportedSymbols*>> sources;
+    ResultCode result = ForEachAutoLinkCRO(
+        process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+            sources.emplace_back(source, &source.GetExportedSymbols(export_index));
+            return MakeResult<bool>(true);
+        });
+    if (result.IsError()) {
+        return result;
+    }
+
     u32 import_strings_size = GetField(ImportStringsSize);
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
@@ -758,32 +791,27 @@ ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
         system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
-        if (!relocation_entry.is_batch_resolved) {
-            ResultCode result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        system.Memory().ReadCString(entry.name_offset, import_strings_size);
-                    u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
-
-                    if (symbol_address != 0) {
-                        LOG_TRACE(Service_LDR, "CRO \"{}\" imports \"{}\" from \"{}\"",
-                                  ModuleName(), symbol_name, source.ModuleName());
+        if (relocation_entry.is_batch_resolved) {
+            continue;
+        }
 
-                        ResultCode result = ApplyRelocationBatch(relocation_addr, symbol_address);
-                        if (result.IsError()) {
-                            LOG_ERROR(Service_LDR, "Error applying relocation batch {:08X}",
-                                      result.raw);
-                            return result;
-                        }
+        std::string symbol_name =
+            system.Memory().ReadCString(entry.name_offset, import_strings_size);
+        for (const auto& [source, exported_symbols] : sources) {
+            const auto symbol = exported_symbols->find(symbol_name);
+            if (symbol == exported_symbols->end()) {
+                continue;
+            }
 
-                        return MakeResult<bool>(false);
-                    }
+            LOG_TRACE(Service_LDR, "CRO \"{}\" imports \"{}\" from \"{}\"", ModuleName(),
+                      symbol_name, source.ModuleName());
 
-                    return MakeResult<bool>(true);
-                });
+            result = ApplyRelocationBatch(relocation_addr, symbol->second);
             if (result.IsError()) {
+                LOG_ERROR(Service_LDR, "Error applying relocation batch {:08X}", result.raw);
                 return result;
             }
+            break;
         }
     }
     return RESULT_SUCCESS;
@@ -908,7 +936,8 @@ ResultCode CROHelper::ApplyModuleImport(VAddr crs_address) {
     return RESULT_SUCCESS;
 }
 
-ResultCode CROHelper::ApplyExportNamedSymbol(CROHelper target) {
+ResultCode CROHelper::ApplyExportNamedSymbol(CROHelper target,
+                                             const ExportedSymbols& exported_symbols) {
     LOG_DEBUG(Service_LDR, "CRO \"{}\" exports named symbols to \"{}\"", ModuleName(),
               target.ModuleName());
     u32 target_import_strings_size = target.GetField(ImportStringsSize);
@@ -924,10 +953,10 @@ ResultCode CROHelper::ApplyExportNamedSymbol(CROHelper target) {
         if (!relocation_entry.is_batch_resolved) {
             std::string symbol_name =
                 system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
-            u32 symbol_address = FindExportNamedSymbol(symbol_name);
-            if (symbol_address != 0) {
+            const auto symbol = exported_symbols.find(symbol_name);
+            if (symbol != exported_symbols.end()) {
                 LOG_TRACE(Service_LDR, "    exports symbol \"{}\"", symbol_name);
-                ResultCode result = target.ApplyRelocationBatch(relocation_addr, symbol_address);
+                ResultCode result = target.ApplyRelocationBatch(relocation_addr, symbol->second);
                 if (result.IsError()) {
                     LOG_ERROR(Service_LDR, "Error applying relocation batch {:08X}", result.raw);
                     return result;
@@ -938,7 +967,8 @@ ResultCode CROHelper::ApplyExportNamedSymbol(CROHelper target) {
     return RESULT_SUCCESS;
 }
 
-ResultCode CROHelper::ResetExportNamedSymbol(CROHelper target) {
+ResultCode CROHelper::ResetExportNamedSymbol(CROHelper target,
+                                             const ExportedSymbols& exported_symbols) {
     LOG_DEBUG(Service_LDR, "CRO \"{}\" unexports named symbols to \"{}\"", ModuleName(),
               target.ModuleName());
     u32 unresolved_symbol = target.GetOnUnresolvedAddress();
@@ -955,8 +985,7 @@ ResultCode CROHelper::ResetExportNamedSymbol(CROHelper target) {
         if (relocation_entry.is_batch_resolved) {
             std::string symbol_name =
                 system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
-            u32 symbol_address = FindExportNamedSymbol(symbol_name);
-            if (symbol_address != 0) {
+            if (exported_symbols.contains(symbol_name)) {
                 LOG_TRACE(Service_LDR, "    unexports symbol \"{}\"", symbol_name);
                 ResultCode result =
                     target.ApplyRelocationBatch(relocation_addr, unresolved_symbol, true);
@@ -1253,7 +1282,8 @@ ResultCode CROHelper::VerifyHash(u32 cro_size, VAddr crr) const {
     return RESULT_SUCCESS;
 }
 
-ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
+ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix,
+                           ExportIndex& export_index) {
     ResultCode result = RESULT_SUCCESS;
 
     {
@@ -1292,7 +1322,7 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
         });
 
         // Imports named symbols from other modules
-        result = ApplyImportNamedSymbol(crs_address);
+        result = ApplyImportNamedSymbol(crs_address, export_index);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying symbol import {:08X}", result.raw);
             return result;
@@ -1307,9 +1337,11 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
     }
 
     // Exports symbols to other modules
+    const ExportedSymbols& exported_symbols = GetExportedSymbols(export_index);
     result = ForEachAutoLinkCRO(process, system, crs_address,
-                                [this](CROHelper target) -> ResultVal<bool> {
-                                    ResultCode result = ApplyExportNamedSymbol(target);
+                                [&](CROHelper target) -> ResultVal<bool> {
+                                    ResultCode result =
+                                        ApplyExportNamedSymbol(target, exported_symbols);
                                     if (result.IsError())
                                         return result;
 
@@ -1327,7 +1359,7 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
     return RESULT_SUCCESS;
 }
 
-ResultCode CROHelper::Unlink(VAddr crs_address) {
+ResultCode CROHelper::Unlink(VAddr crs_address, ExportIndex& export_index) {
 
     // Resets all imported named symbols
     ResultCode result = ResetImportNamedSymbol();
@@ -1352,9 +1384,11 @@ ResultCode CROHelper::Unlink(VAddr crs_address) {
 
     // Resets all symbols in other modules imported from this module
     // Note: the RO service seems only searching in auto-link modules
+    const ExportedSymbols& exported_symbols = GetExportedSymbols(export_index);
     result = ForEachAutoLinkCRO(process, system, crs_address,
-                                [this](CROHelper target) -> ResultVal<bool> {
-                                    ResultCode result = ResetExportNamedSymbol(target);
+                                [&](CROHelper target) -> ResultVal<bool> {
+                                    ResultCode result =
+                                        ResetExportNamedSymbol(target, exported_symbols);
                                     if (result.IsError())
                                         return result;
 
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -29,6 +31,15 @@ namespace Service::LDR {
 static constexpr u32 CRO_HEADER_SIZE = 0x138;
 static constexpr u32 CRO_HASH_SIZE = 0x80;
 
+/// Addresses of the named symbols exported by a module, keyed by symbol name
+using ExportedSymbols = std::unordered_map<std::string, VAddr>;
+
+/**
+ * Named symbols exported by the loaded modules of a process, keyed by module address. A module is
+ * indexed the first time its exports are searched, and must be removed when it is unloaded.
+ */
+using ExportIndex = std::unordered_map<VAddr, ExportedSymbols>;
+
 /// Represents a loaded module (CRO) with interfaces manipulating it.
 class CROHelper final {
 public:
@@ -77,16 +88,18 @@ public:
      * Links this module with all registered auto-link module.
      * @param crs_address the virtual address of the static module
      * @param link_on_load_bug_fix true if links when loading and fixes the bug
+     * @param export_index the exported symbols of the loaded modules
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
-    ResultCode Link(VAddr crs_address, bool link_on_load_bug_fix);
+    ResultCode Link(VAddr crs_address, bool link_on_load_bug_fix, ExportIndex& export_index);
 
     /**
      * Unlinks this module with other modules.
      * @param crs_address the virtual address of the static module
+     * @param export_index the exported symbols of the loaded modules
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
-    ResultCode Unlink(VAddr crs_address);
+    ResultCode Unlink(VAddr crs_address, ExportIndex& export_index);
 
     /**
      * Clears all relocations to zero.
@@ -523,6 +536,14 @@ private:
      */
     VAddr FindExportNamedSymbol(const std::string& name) const;
 
+    /**
+     * Gets all exported named symbols of this module, reading them into the index if this module
+     * is not in it yet.
+     * @param export_index the exported symbols of the loaded modules
+     * @return the symbols of this module in the index
+     */
+    const ExportedSymbols& GetExportedSymbols(ExportIndex& export_index) const;
+
     /**
      * Rebases offsets in module header according to module address.
      * @param cro_size the size of the CRO file
@@ -650,9 +671,10 @@ private:
      * Looks up all imported named symbols of this module in all registered auto-link modules, and
      * resolves them if found.
      * @param crs_address the virtual address of the static module
+     * @param export_index the exported symbols of the loaded modules
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
-    ResultCode ApplyImportNamedSymbol(VAddr crs_address);
+    ResultCode ApplyImportNamedSymbol(VAddr crs_address, ExportIndex& export_index);
 
     /**
      * Resets all imported named symbols of this module to unresolved state.
@@ -683,16 +705,18 @@ private:
     /**
      * Resolves target module's imported named symbols that exported by this module.
      * @param target the module to resolve.
+     * @param exported_symbols the named symbols exported by this module
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
-    ResultCode ApplyExportNamedSymbol(CROHelper target);
+    ResultCode ApplyExportNamedSymbol(CROHelper target, const ExportedSymbols& exported_symbols);
 
     /**
      * Resets target's named symbols imported from this module to unresolved state.
      * @param target the module to reset.
+     * @param exported_symbols the named symbols exported by this module
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
-    ResultCode ResetExportNamedSymbol(CROHelper target);
+    ResultCode ResetExportNamedSymbol(CROHelper target, const ExportedSymbols& exported_symbols);
 
     /**
      * Resolves imported indexed and anonymous symbols in the target module which imports this
@@ -61,6 +61,8 @@ static bool VerifyBufferState(Kernel::Process& process, VAddr buffer_ptr, u32 si
 
 void RO::Initialize(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x01, 3, 2);
+    // Relocations invalidate every word they patch, merge them into a few ranges
+    Core::ScopedCacheInvalidationBatch invalidation_batch{system};
     VAddr crs_buffer_ptr = rp.Pop<u32>();
     u32 crs_size = rp.Pop<u32>();
     VAddr crs_address = rp.Pop<u32>();
@@ -168,6 +170,7 @@ void RO::UnloadCRR(Kernel::HLERequestContext& ctx) {
 
 void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
     IPC::RequestParser rp(ctx, link_on_load_bug_fix ? 0x09 : 0x04, 11, 2);
+    Core::ScopedCacheInvalidationBatch invalidation_batch{system};
     VAddr cro_buffer_ptr = rp.Pop<u32>();
     VAddr cro_address = rp.Pop<u32>();
     u32 cro_size = rp.Pop<u32>();
@@ -284,7 +287,9 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
         return;
     }
 
-    result = cro.Link(slot->loaded_crs, link_on_load_bug_fix);
+    // A module that failed to load at this address may have been indexed
+    slot->export_index.erase(cro_address);
+    result = cro.Link(slot->loaded_crs, link_on_load_bug_fix, slot->export_index);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error linking CRO {:08X}", result.raw);
         process->Unmap(cro_address, cro_buffer_ptr, cro_size, Kernel::VMAPermission::ReadWrite,
@@ -335,6 +340,7 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
 
 void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x05, 3, 2);
+    Core::ScopedCacheInvalidationBatch invalidation_batch{system};
     VAddr cro_address = rp.Pop<u32>();
     u32 zero = rp.Pop<u32>();
     VAddr cro_buffer_ptr = rp.Pop<u32>();
@@ -372,7 +378,8 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
 
     cro.Unregister(slot->loaded_crs);
 
-    ResultCode result = cro.Unlink(slot->loaded_crs);
+    ResultCode result = cro.Unlink(slot->loaded_crs, slot->export_index);
+    slot->export_index.erase(cro_address);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error unlinking CRO {:08X}", result.raw);
         rb.Push(result);
@@ -405,6 +412,7 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
 
 void RO::LinkCRO(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x06, 1, 2);
+    Core::ScopedCacheInvalidationBatch invalidation_batch{system};
     VAddr cro_address = rp.Pop<u32>();
     auto process = rp.PopObject<Kernel::Process>();
 
@@ -435,7 +443,7 @@ void RO::LinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_INFO(Service_LDR, "Linking CRO \"{}\"", cro.ModuleName());
 
-    ResultCode result = cro.Link(slot->loaded_crs, false);
+    ResultCode result = cro.Link(slot->loaded_crs, false, slot->export_index);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error linking CRO {:08X}", result.raw);
     }
@@ -445,6 +453,7 @@ void RO::LinkCRO(Kernel::HLERequestContext& ctx) {
 
 void RO::UnlinkCRO(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x07, 1, 2);
+    Core::ScopedCacheInvalidationBatch invalidation_batch{system};
     VAddr cro_address = rp.Pop<u32>();
     auto process = rp.PopObject<Kernel::Process>();
 
@@ -475,7 +484,7 @@ void RO::UnlinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_INFO(Service_LDR, "Unlinking CRO \"{}\"", cro.ModuleName());
 
-    ResultCode result = cro.Unlink(slot->loaded_crs);
+    ResultCode result = cro.Unlink(slot->loaded_crs, slot->export_index);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error unlinking CRO {:08X}", result.raw);
     }
@@ -485,6 +494,7 @@ void RO::UnlinkCRO(Kernel::HLERequestContext& ctx) {
 
 void RO::Shutdown(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x08, 1, 2);
+    Core::ScopedCacheInvalidationBatch invalidation_batch{system};
     VAddr crs_buffer_ptr = rp.Pop<u32>();
     auto process = rp.PopObject<Kernel::Process>();
 
@@ -511,6 +521,7 @@ void RO::Shutdown(Kernel::HLERequestContext& ctx) {
     }
 
     slot->loaded_crs = 0;
+    slot->export_index.clear();
     rb.Push(result);
 }
 
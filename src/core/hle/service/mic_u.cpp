@@ -76,25 +76,23 @@ struct State {
     u8 sample_size = 0;
     SampleRate sample_rate = SampleRate::Rate16360;
 
-    void WriteSamples(const std::vector<u8>& samples) {
-        u32 bytes_total_written = 0;
-        const std::size_t remaining_space = size - offset;
-        std::size_t bytes_to_write = std::min(samples.size(), remaining_space);
-
+    /// Copies the samples the mic has captured straight into the shared memory buffer
+    void ReadSamples(Frontend::Mic::Interface& mic) {
         // Write as many samples as we can to the buffer.
-        // TODO if the sample size is 16bit, this could theoretically cut a sample in the case where
-        // the application configures an odd size
-        std::memcpy(sharedmem_buffer + offset, samples.data(), bytes_to_write);
-        offset += static_cast<u32>(bytes_to_write);
-        bytes_total_written += static_cast<u32>(bytes_to_write);
+        const std::size_t remaining_space = offset < size ? size - offset : 0;
+        const std::size_t bytes_written = mic.Read({sharedmem_buffer + offset, remaining_space});
+        if (bytes_written == 0 && remaining_space != 0) {
+            return;
+        }
+        offset += static_cast<u32>(bytes_written);
 
         // If theres any samples left to write after we looped, go ahead and write them now
-        if (looped_buffer && samples.size() > bytes_total_written) {
-            offset = initial_offset;
-            bytes_to_write = std::min(samples.size() - bytes_total_written, size);
-            std::memcpy(sharedmem_buffer + offset, samples.data() + bytes_total_written,
-                        bytes_to_write);
-            offset += static_cast<u32>(bytes_to_write);
+        if (looped_buffer && bytes_written == remaining_space && initial_offset < size) {
+            const std::size_t looped_bytes_written =
+                mic.Read({sharedmem_buffer + initial_offset, size - initial_offset});
+            if (looped_bytes_written != 0) {
+                offset = initial_offset + static_cast<u32>(looped_bytes_written);
+            }
         }
 
         // The last 4 bytes of the shared memory contains the latest offset
@@ -167,10 +165,9 @@ struct MIC_U::Impl {
             return;
         }
 
-        Frontend::Mic::Samples samples = mic->Read();
-        if (!samples.empty()) {
-            // write the samples to sharedmem page
-            state.WriteSamples(samples);
+        // write the samples to sharedmem page
+        if (state.sharedmem_buffer) {
+            state.ReadSamples(*mic);
         }
 
         // schedule next run
@@ -6,6 +6,7 @@
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
@@ -63,37 +64,38 @@ const std::array<ServiceModuleInfo, 41> service_module_map{
      {"PXI", 0x00040130'00001402, PXI::InstallInterfaces},
 
      {"ERR", 0x00040030'00008A02, ERR::InstallInterfaces},
-     {"AC", 0x00040130'00002402, AC::InstallInterfaces},
-     {"ACT", 0x00040130'00003802, ACT::InstallInterfaces},
-     {"AM", 0x00040130'00001502, AM::InstallInterfaces},
-     {"BOSS", 0x00040130'00003402, BOSS::InstallInterfaces},
+     {"AC", 0x00040130'00002402, AC::InstallInterfaces, {"ac:i", "ac:u"}},
+     {"ACT", 0x00040130'00003802, ACT::InstallInterfaces, {"act:a", "act:u"}},
+     {"AM", 0x00040130'00001502, AM::InstallInterfaces, {"am:app", "am:net", "am:sys", "am:u"}},
+     {"BOSS", 0x00040130'00003402, BOSS::InstallInterfaces, {"boss:P", "boss:U"}},
      {"CAM", 0x00040130'00001602,
       [](Core::System& system) {
           CAM::InstallInterfaces(system);
           Y2R::InstallInterfaces(system);
       }},
-     {"CECD", 0x00040130'00002602, CECD::InstallInterfaces},
+     {"CECD", 0x00040130'00002602, CECD::InstallInterfaces, {"cecd:ndm", "cecd:s", "cecd:u"}},
      {"CFG", 0x00040130'00001702, CFG::InstallInterfaces},
-     {"DLP", 0x00040130'00002802, DLP::InstallInterfaces},
+     {"DLP", 0x00040130'00002802, DLP::InstallInterfaces, {"dlp:CLNT", "dlp:FKCL", "dlp:SRVR"}},
      {"DSP", 0x00040130'00001A02, DSP::InstallInterfaces},
-     {"FRD", 0x00040130'00003202, FRD::InstallInterfaces},
+     {"FRD", 0x00040130'00003202, FRD::InstallInterfaces, {"frd:a", "frd:u"}},
      {"GSP", 0x00040130'00001C02, GSP::InstallInterfaces},
      {"HID", 0x00040130'00001D02, HID::InstallInterfaces},
      {"IR", 0x00040130'00003302, IR::InstallInterfaces},
      {"MIC", 0x00040130'00002002, MIC::InstallInterfaces},
-     {"MVD", 0x00040130'20004102, MVD::InstallInterfaces},
+     {"MVD", 0x00040130'20004102, MVD::InstallInterfaces, {"mvd:std"}},
      {"NDM", 0x00040130'00002B02, NDM::InstallInterfaces},
-     {"NEWS", 0x00040130'00003502, NEWS::InstallInterfaces},
+     {"NEWS", 0x00040130'00003502, NEWS::InstallInterfaces, {"news:s", "news:u"}},
      {"NFC", 0x00040130'00004002, NFC::InstallInterfaces},
-     {"NIM", 0x00040130'00002C02, NIM::InstallInterfaces},
+     {"NIM", 0x00040130'00002C02, NIM::InstallInterfaces, {"nim:aoc", "nim:s", "nim:u"}},
      {"NS", 0x00040130'00008002, APT::InstallInterfaces},
-     {"NWM", 0x00040130'00002D02, NWM::InstallInterfaces},
+     {"NWM", 0x00040130'00002D02, NWM::InstallInterfaces,
+      {"nwm::CEC", "nwm::EXT", "nwm::INF", "nwm::SAP", "nwm::SOC", "nwm::TST", "nwm::UDS"}},
      {"PTM", 0x00040130'00002202, PTM::InstallInterfaces},
-     {"QTM", 0x00040130'00004202, QTM::InstallInterfaces},
+     {"QTM", 0x00040130'00004202, QTM::InstallInterfaces, {"qtm:c", "qtm:s", "qtm:sp", "qtm:u"}},
      {"CSND", 0x00040130'00002702, CSND::InstallInterfaces},
-     {"HTTP", 0x00040130'00002902, HTTP::InstallInterfaces},
+     {"HTTP", 0x00040130'00002902, HTTP::InstallInterfaces, {"http:C"}},
      {"SOC", 0x00040130'00002E02, SOC::InstallInterfaces},
-     {"SSL", 0x00040130'00002F02, SSL::InstallInterfaces},
+     {"SSL", 0x00040130'00002F02, SSL::InstallInterfaces, {"ssl:C"}},
      {"PS", 0x00040130'00003102, PS::InstallInterfaces},
      {"PLGLDR", 0x00040130'00006902, PLGLDR::InstallInterfaces},
      // no HLE implementation
@@ -124,7 +126,14 @@ const std::array<ServiceModuleInfo, 41> service_module_map{
 
 ServiceFrameworkBase::ServiceFrameworkBase(const char* service_name, u32 max_sessions,
                                            InvokerFn* handler_invoker)
-    : service_name(service_name), max_sessions(max_sessions), handler_invoker(handler_invoker) {}
+    : service_name(service_name), max_sessions(max_sessions), handler_invoker(handler_invoker) {
+#if MICROPROFILE_ENABLED
+    // File and directory sessions have no service name
+    profile_token = MicroProfileGetToken(
+        "HLE", this->service_name.empty() ? "Unnamed" : this->service_name.c_str(),
+        MP_RGB(200, 160, 70));
+#endif
+}
 
 ServiceFrameworkBase::~ServiceFrameworkBase() = default;
 
@@ -179,7 +188,18 @@ void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context)
 
     LOG_TRACE(Service, "{}",
               MakeFunctionString(info->name, GetServiceName(), context.CommandBuffer()));
+
+#if MICROPROFILE_ENABLED
+    MICROPROFILE_SCOPE_TOKEN(profile_token);
+#endif
+    auto* perf_stats = Core::System::GetInstance().GetPerfStats();
+    Core::PerfStats::SubsystemTimer timer{perf_stats, Core::PerfStats::Subsystem::HLE};
+    const auto start = Core::PerfStats::Clock::now();
     handler_invoker(this, info->handler_callback, context);
+    if (perf_stats) {
+        perf_stats->RecordServiceCall(service_name, header_code, info->name,
+                                      Core::PerfStats::Clock::now() - start);
+    }
 }
 
 std::string ServiceFrameworkBase::GetFunctionName(u32 header) const {
@@ -214,11 +234,20 @@ static bool AttemptLLE(const ServiceModuleInfo& service_module) {
 void Init(Core::System& core) {
     SM::ServiceManager::InstallInterfaces(core);
 
+    std::size_t num_deferred = 0;
     for (const auto& service_module : service_module_map) {
-        if (!AttemptLLE(service_module) && service_module.init_function != nullptr)
+        if (AttemptLLE(service_module) || service_module.init_function == nullptr) {
+            continue;
+        }
+        if (service_module.lazy_ports.empty()) {
             service_module.init_function(core);
+        } else {
+            core.ServiceManager().RegisterLazyModule(
+                service_module.name, service_module.lazy_ports, service_module.init_function);
+            num_deferred++;
+        }
     }
-    LOG_DEBUG(Service, "initialized OK");
+    LOG_DEBUG(Service, "initialized OK, {} modules deferred until first use", num_deferred);
 }
 
 } // namespace Service
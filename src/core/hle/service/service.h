@@ -9,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/container/flat_map.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -100,6 +101,9 @@ private:
     /// Maximum number of concurrent sessions that this service can handle.
     u32 max_sessions;
 
+    /// Profiler timer of the service, shared by its instances
+    u64 profile_token = 0;
+
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
     boost::container::flat_map<u32, FunctionInfoBase> handlers;
@@ -192,6 +196,8 @@ struct ServiceModuleInfo {
     std::string name;
     u64 title_id;
     std::function<void(Core::System&)> init_function;
+    /// When not empty, the HLE module is only initialized once one of these ports is first used
+    std::vector<std::string> lazy_ports;
 };
 
 extern const std::array<ServiceModuleInfo, 41> service_module_map;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <tuple>
 #include "common/assert.h"
 #include "core/core.h"
@@ -47,10 +48,54 @@ ResultVal<std::shared_ptr<Kernel::ServerPort>> ServiceManager::RegisterService(
     return MakeResult(std::move(server_port));
 }
 
+void ServiceManager::RegisterLazyModule(std::string module_name,
+                                        std::vector<std::string> port_names,
+                                        std::function<void(Core::System&)> init_function) {
+    const std::size_t index = lazy_modules.size();
+    lazy_modules.push_back({std::move(module_name), std::move(init_function), false});
+    for (auto& port_name : port_names) {
+        lazy_ports.emplace(std::move(port_name), index);
+    }
+}
+
+std::vector<std::string> ServiceManager::GetInitializedLazyModules() const {
+    return initialized_lazy_modules;
+}
+
+void ServiceManager::InitializeLazyModules(const std::vector<std::string>& module_names) {
+    for (const auto& module_name : module_names) {
+        const auto it = std::find_if(lazy_modules.begin(), lazy_modules.end(),
+                                     [&](const LazyModule& m) { return m.name == module_name; });
+        if (it == lazy_modules.end() || it->initialized) {
+            continue;
+        }
+        it->initialized = true;
+        initialized_lazy_modules.push_back(it->name);
+        it->init_function(system);
+    }
+}
+
+void ServiceManager::InitializeLazyModule(const std::string& port_name) const {
+    const auto it = lazy_ports.find(port_name);
+    if (it == lazy_ports.end()) {
+        return;
+    }
+    LazyModule& lazy_module = lazy_modules[it->second];
+    if (lazy_module.initialized) {
+        return;
+    }
+    LOG_DEBUG(Service, "Initializing service module {} on first use of {}", lazy_module.name,
+              port_name);
+    lazy_module.initialized = true;
+    initialized_lazy_modules.push_back(lazy_module.name);
+    lazy_module.init_function(system);
+}
+
 ResultVal<std::shared_ptr<Kernel::ClientPort>> ServiceManager::GetServicePort(
     const std::string& name) {
 
     CASCADE_CODE(ValidateServiceName(name));
+    InitializeLazyModule(name);
     auto it = registered_services.find(name);
     if (it == registered_services.end()) {
         return ERR_SERVICE_NOT_REGISTERED;
@@ -4,10 +4,12 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/split_member.hpp>
 #include <boost/serialization/string.hpp>
@@ -53,6 +55,18 @@ public:
 
     ResultVal<std::shared_ptr<Kernel::ServerPort>> RegisterService(std::string name,
                                                                    unsigned int max_sessions);
+    /**
+     * Defers the initialization of a service module until one of its ports is first looked up,
+     * either by the guest or through GetService.
+     * @param module_name name of the module, in the service module map
+     * @param port_names the services that init_function registers
+     */
+    void RegisterLazyModule(std::string module_name, std::vector<std::string> port_names,
+                            std::function<void(Core::System&)> init_function);
+    /// Returns the names of the deferred modules that have been initialized, in that order.
+    std::vector<std::string> GetInitializedLazyModules() const;
+    /// Initializes the given deferred modules, in order. Unknown names are ignored.
+    void InitializeLazyModules(const std::vector<std::string>& module_names);
     ResultVal<std::shared_ptr<Kernel::ClientPort>> GetServicePort(const std::string& name);
     ResultVal<std::shared_ptr<Kernel::ClientSession>> ConnectToService(const std::string& name);
     // For IPC Recorder
@@ -62,6 +76,7 @@ public:
     std::shared_ptr<T> GetService(const std::string& service_name) const {
         static_assert(std::is_base_of_v<Kernel::SessionRequestHandler, T>,
                       "Not a base of ServiceFrameworkBase");
+        InitializeLazyModule(service_name);
         auto service = registered_services.find(service_name);
         if (service == registered_services.end()) {
             LOG_DEBUG(Service, "Can't find service: {}", service_name);
@@ -75,9 +90,27 @@ public:
     }
 
 private:
+    struct LazyModule {
+        std::string name;
+        std::function<void(Core::System&)> init_function;
+        bool initialized;
+    };
+
+    /// Initializes the deferred module that provides the port, if there is one.
+    void InitializeLazyModule(const std::string& port_name) const;
+
     Core::System& system;
     std::weak_ptr<SRV> srv_interface;
 
+    /// Deferred modules and the order they were initialized in. Their state is saved by
+    /// Core::System before anything else, since the modules register timing events and kernel
+    /// objects that the rest of the state refers to. Looking up a service (which may be const)
+    /// initializes its module, hence mutable.
+    mutable std::vector<LazyModule> lazy_modules;
+    mutable std::vector<std::string> initialized_lazy_modules;
+    /// Port name -> index in lazy_modules
+    std::unordered_map<std::string, std::size_t> lazy_ports;
+
     /// Map of registered services, retrieved using GetServicePort or ConnectToService.
     std::unordered_map<std::string, std::shared_ptr<Kernel::ClientPort>> registered_services;
 
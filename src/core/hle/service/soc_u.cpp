@@ -48,6 +48,7 @@
 #define ERRNO(x) WSA##x
 #define GET_ERRNO WSAGetLastError()
 #define poll(x, y, z) WSAPoll(x, y, z);
+#define SHUT_RDWR SD_BOTH
 #else
 #define ERRNO(x) x
 #define GET_ERRNO errno
@@ -60,6 +61,12 @@ namespace Service::SOC {
 
 const s32 SOCKET_ERROR_VALUE = -1;
 
+/// Longest a HLE worker waits on the host at once before it checks whether it has to give up
+constexpr s32 AsyncWaitSliceMs = 50;
+
+/// Blocking calls wait on the HLE workers, the others are not kept from running by that many
+constexpr u32 MaxAsyncRequests = 2;
+
 /// Holds the translation from system network errors to 3DS network errors
 static const std::unordered_map<int, int> error_map = {{
     {E2BIG, 1},
@@ -238,20 +245,6 @@ struct CTRPollFD {
     Events events;  ///< Events to poll for (input)
     Events revents; ///< Events received (output)
 
-    /// Converts a platform-specific pollfd to a 3ds specific structure
-    static CTRPollFD FromPlatform(SOC::SOC_U& socu, pollfd const& fd) {
-        CTRPollFD result;
-        result.events.hex = Events::TranslateTo3DS(fd.events).hex;
-        result.revents.hex = Events::TranslateTo3DS(fd.revents).hex;
-        for (auto iter = socu.open_sockets.begin(); iter != socu.open_sockets.end(); ++iter) {
-            if (iter->second.socket_fd == fd.fd) {
-                result.fd = iter->first;
-                break;
-            }
-        }
-        return result;
-    }
-
     /// Converts a 3ds specific pollfd to a platform-specific structure
     static pollfd ToPlatform(SOC::SOC_U& socu, CTRPollFD const& fd) {
         pollfd result;
@@ -362,9 +355,95 @@ void SOC_U::PostTimerAdjust() {
     Core::System::GetInstance().GetRunningCore().GetTimer().EndAdjust(timer_adjust_handle);
 }
 
+/// Marks a call on the HLE workers as using a socket, returns false if the guest closed it already
+static bool BeginSocketOp(SocketOps& ops) {
+    std::scoped_lock lock{ops.mutex};
+    ++ops.running;
+    return !ops.closed;
+}
+
+static void EndSocketOp(SocketOps& ops) {
+    {
+        std::scoped_lock lock{ops.mutex};
+        --ops.running;
+    }
+    ops.done.notify_all();
+}
+
+static bool IsSocketClosed(SocketOps& ops) {
+    std::scoped_lock lock{ops.mutex};
+    return ops.closed;
+}
+
+/// Whether the guest closed one of the sockets of a call, null entries are unknown sockets
+static bool IsAnySocketClosed(const std::vector<std::shared_ptr<SocketOps>>& ops) {
+    return std::any_of(ops.begin(), ops.end(), [](const auto& socket_ops) {
+        return socket_ops && IsSocketClosed(*socket_ops);
+    });
+}
+
+/**
+ * Closes a socket once the calls using it on the HLE workers are done, so that they never use the
+ * descriptor after it was closed or reused. Shutting the socket down wakes the calls waiting on it.
+ */
+static int CloseSocket(const SocketHolder& holder) {
+    {
+        std::unique_lock lock{holder.ops->mutex};
+        holder.ops->closed = true;
+        if (holder.ops->running > 0) {
+            ::shutdown(holder.socket_fd, SHUT_RDWR);
+            holder.ops->done.wait(lock, [&holder] { return holder.ops->running == 0; });
+        }
+    }
+    return closesocket(holder.socket_fd);
+}
+
+/**
+ * Waits like poll, but in short slices so that a HLE worker stops waiting when the workers are
+ * drained for a save state or the shutdown, or when the guest closes one of the sockets.
+ * @param ops Trackers of the sockets of fds, on which the caller began its call.
+ * @param timeout Timeout in milliseconds, negative to wait until a socket is ready.
+ * @param ret Set to the poll result, 0 when the wait ended because a socket was closed.
+ * @returns False when the wait was given up because the workers are being drained.
+ */
+static bool WaitForSockets(const Kernel::KernelSystem& kernel, std::vector<pollfd>& fds,
+                           const std::vector<std::shared_ptr<SocketOps>>& ops, s32 timeout,
+                           s32& ret) {
+    while (true) {
+        if (IsAnySocketClosed(ops)) {
+            ret = 0;
+            return true;
+        }
+        const s32 slice = timeout < 0 ? AsyncWaitSliceMs : std::min(timeout, AsyncWaitSliceMs);
+        ret = ::poll(fds.data(), static_cast<u32>(fds.size()), slice);
+        if (ret != 0 || slice == timeout) {
+            return true;
+        }
+        if (kernel.IsWaitingForHLEWorkers()) {
+            return false;
+        }
+        if (timeout > 0) {
+            timeout -= slice;
+        }
+    }
+}
+
+/**
+ * Waits on a HLE worker until a blocking socket has data or a connection to accept, or was closed.
+ * @returns False when the wait was given up because the workers are being drained.
+ */
+static bool WaitForReadable(const Kernel::KernelSystem& kernel, decltype(pollfd::fd) socket_fd,
+                            const std::shared_ptr<SocketOps>& ops) {
+    std::vector<pollfd> fds(1);
+    fds[0].fd = socket_fd;
+    fds[0].events = POLLIN;
+    s32 ret;
+    return WaitForSockets(kernel, fds, {ops}, -1, ret);
+}
+
 void SOC_U::CleanupSockets() {
-    for (auto sock : open_sockets)
-        closesocket(sock.second.socket_fd);
+    for (const auto& sock : open_sockets)
+        CloseSocket(sock.second);
     open_sockets.clear();
 }
 
@@ -499,6 +578,7 @@ void SOC_U::Fcntl(Kernel::HLERequestContext& ctx) {
             posix_ret = TranslateError(GET_ERRNO);
             return;
         }
+        fd_info->second.blocking = (ctr_arg & 4) == 0;
 #endif
     } else {
         LOG_ERROR(Service_SOC, "Unsupported command ({}) in fcntl call", ctr_cmd);
@@ -530,8 +610,8 @@ void SOC_U::Listen(Kernel::HLERequestContext& ctx) {
 
 void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
     // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
+    // preventing graceful shutdown when closing the emulator. Unlike the receive functions, it
+    // adds to the socket table, which the HLE workers must not touch.
     IPC::RequestParser rp(ctx, 0x04, 2, 2);
     const auto socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -600,7 +680,7 @@ void SOC_U::Close(Kernel::HLERequestContext& ctx) {
     s32 ret = 0;
 
     PreTimerAdjust();
-    ret = closesocket(fd_info->second.socket_fd);
+    ret = CloseSocket(fd_info->second);
     PostTimerAdjust();
 
     open_sockets.erase(socket_handle);
@@ -666,44 +746,69 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
     rp.PopPID();
     auto& buffer = rp.PopMappedBuffer();
 
-    CTRSockAddr ctr_src_addr;
-    std::vector<u8> output_buff(len);
-    std::vector<u8> addr_buff(sizeof(ctr_src_addr));
-    sockaddr src_addr;
-    socklen_t src_addr_len = sizeof(src_addr);
-
-    s32 ret = -1;
-    PreTimerAdjust();
-    if (addr_len > 0) {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, &src_addr, &src_addr_len);
-        if (ret >= 0 && src_addr_len > 0) {
-            ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-            std::memcpy(addr_buff.data(), &ctr_src_addr, sizeof(ctr_src_addr));
+    // Doesn't touch the socket table, so that it can run on the HLE workers
+    const auto receive = [socket_fd = fd_info->second.socket_fd, len, flags, addr_len,
+                          &buffer](Kernel::HLERequestContext& ctx, bool closed) {
+        CTRSockAddr ctr_src_addr;
+        std::vector<u8> output_buff(len);
+        std::vector<u8> addr_buff(sizeof(ctr_src_addr));
+        sockaddr src_addr;
+        socklen_t src_addr_len = sizeof(src_addr);
+
+        s32 ret = SOCKET_ERROR_VALUE;
+        int error = ERRNO(EBADF);
+        if (closed) {
+            addr_buff.resize(0);
+        } else if (addr_len > 0) {
+            ret = ::recvfrom(socket_fd, reinterpret_cast<char*>(output_buff.data()), len, flags,
+                             &src_addr, &src_addr_len);
+            error = GET_ERRNO;
+            if (ret >= 0 && src_addr_len > 0) {
+                ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
+                std::memcpy(addr_buff.data(), &ctr_src_addr, sizeof(ctr_src_addr));
+            }
+        } else {
+            ret = ::recvfrom(socket_fd, reinterpret_cast<char*>(output_buff.data()), len, flags,
+                             NULL, 0);
+            error = GET_ERRNO;
+            addr_buff.resize(0);
         }
-    } else {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, NULL, 0);
-        addr_buff.resize(0);
-    }
-    PostTimerAdjust();
-    if (ret == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(GET_ERRNO);
-    } else {
-        buffer.Write(output_buff.data(), 0, ret);
+        if (ret == SOCKET_ERROR_VALUE) {
+            ret = TranslateError(error);
+        } else {
+            buffer.Write(output_buff.data(), 0, ret);
+        }
+
+        IPC::RequestBuilder rb(ctx, 0x7, 2, 4);
+        rb.Push(RESULT_SUCCESS);
+        rb.Push(ret);
+        rb.PushStaticBuffer(std::move(addr_buff), 0);
+        rb.PushMappedBuffer(buffer);
+    };
+
+    if (!fd_info->second.blocking) {
+        PreTimerAdjust();
+        receive(ctx, false);
+        PostTimerAdjust();
+        return;
     }
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 4);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
-    rb.PushStaticBuffer(std::move(addr_buff), 0);
-    rb.PushMappedBuffer(buffer);
+    // Park the guest thread until data arrives instead of blocking the emulation
+    ctx.RunAsync([&kernel = Core::System::GetInstance().Kernel(),
+                  socket_fd = fd_info->second.socket_fd, ops = fd_info->second.ops,
+                  receive](Kernel::HLERequestContext& ctx) {
+        const bool open = BeginSocketOp(*ops);
+        SCOPE_EXIT({ EndSocketOp(*ops); });
+        if (open && !WaitForReadable(kernel, socket_fd, ops)) {
+            ctx.RetryAfterDrain();
+            return s64{0};
+        }
+        receive(ctx, !open || IsSocketClosed(*ops));
+        return s64{0};
+    });
 }
 
 void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
     IPC::RequestParser rp(ctx, 0x08, 4, 2);
     u32 socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -717,44 +822,97 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
     u32 addr_len = rp.Pop<u32>();
     rp.PopPID();
 
-    CTRSockAddr ctr_src_addr;
-    std::vector<u8> output_buff(len);
-    std::vector<u8> addr_buff(sizeof(ctr_src_addr));
-    sockaddr src_addr;
-    socklen_t src_addr_len = sizeof(src_addr);
+    // Doesn't touch the socket table, so that it can run on the HLE workers
+    const auto receive = [socket_fd = fd_info->second.socket_fd, len, flags,
+                          addr_len](Kernel::HLERequestContext& ctx, bool closed) {
+        CTRSockAddr ctr_src_addr;
+        std::vector<u8> output_buff(len);
+        std::vector<u8> addr_buff(sizeof(ctr_src_addr));
+        sockaddr src_addr;
+        socklen_t src_addr_len = sizeof(src_addr);
+
+        s32 ret = SOCKET_ERROR_VALUE;
+        int error = ERRNO(EBADF);
+        if (closed) {
+            addr_buff.resize(0);
+        } else if (addr_len > 0) {
+            // Only get src adr if input adr available
+            ret = ::recvfrom(socket_fd, reinterpret_cast<char*>(output_buff.data()), len, flags,
+                             &src_addr, &src_addr_len);
+            error = GET_ERRNO;
+            if (ret >= 0 && src_addr_len > 0) {
+                ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
+                std::memcpy(addr_buff.data(), &ctr_src_addr, sizeof(ctr_src_addr));
+            }
+        } else {
+            ret = ::recvfrom(socket_fd, reinterpret_cast<char*>(output_buff.data()), len, flags,
+                             NULL, 0);
+            error = GET_ERRNO;
+            addr_buff.resize(0);
+        }
 
-    s32 ret = -1;
-    PreTimerAdjust();
-    if (addr_len > 0) {
-        // Only get src adr if input adr available
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, &src_addr, &src_addr_len);
-        if (ret >= 0 && src_addr_len > 0) {
-            ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-            std::memcpy(addr_buff.data(), &ctr_src_addr, sizeof(ctr_src_addr));
+        s32 total_received = ret;
+        if (ret == SOCKET_ERROR_VALUE) {
+            ret = TranslateError(error);
+            total_received = 0;
         }
-    } else {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, NULL, 0);
-        addr_buff.resize(0);
+
+        // Write only the data we received to avoid overwriting parts of the buffer with zeros
+        output_buff.resize(total_received);
+
+        IPC::RequestBuilder rb(ctx, 0x08, 3, 4);
+        rb.Push(RESULT_SUCCESS);
+        rb.Push(ret);
+        rb.Push(total_received);
+        rb.PushStaticBuffer(std::move(output_buff), 0);
+        rb.PushStaticBuffer(std::move(addr_buff), 1);
+    };
+
+    if (!fd_info->second.blocking) {
+        PreTimerAdjust();
+        receive(ctx, false);
+        PostTimerAdjust();
+        return;
     }
-    PostTimerAdjust();
 
-    s32 total_received = ret;
-    if (ret == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(GET_ERRNO);
-        total_received = 0;
+    // Park the guest thread until data arrives instead of blocking the emulation
+    ctx.RunAsync([&kernel = Core::System::GetInstance().Kernel(),
+                  socket_fd = fd_info->second.socket_fd, ops = fd_info->second.ops,
+                  receive](Kernel::HLERequestContext& ctx) {
+        const bool open = BeginSocketOp(*ops);
+        SCOPE_EXIT({ EndSocketOp(*ops); });
+        if (open && !WaitForReadable(kernel, socket_fd, ops)) {
+            ctx.RetryAfterDrain();
+            return s64{0};
+        }
+        receive(ctx, !open || IsSocketClosed(*ops));
+        return s64{0};
+    });
+}
+
+/// Writes the response of a Poll request. The guest handles are kept from the request, so that the
+/// socket table isn't needed and this can run on the HLE workers.
+static void WritePollResponse(Kernel::HLERequestContext& ctx, std::vector<CTRPollFD>& ctr_fds,
+                              const std::vector<pollfd>& platform_pollfd, s32 ret, int error) {
+    // Now update the output 3ds_pollfd structure
+    for (std::size_t i = 0; i < ctr_fds.size(); i++) {
+        ctr_fds[i].events.hex = CTRPollFD::Events::TranslateTo3DS(platform_pollfd[i].events).hex;
+        ctr_fds[i].revents.hex = CTRPollFD::Events::TranslateTo3DS(platform_pollfd[i].revents).hex;
     }
 
-    // Write only the data we received to avoid overwriting parts of the buffer with zeros
-    output_buff.resize(total_received);
+    std::vector<u8> output_fds(ctr_fds.size() * sizeof(CTRPollFD));
+    std::memcpy(output_fds.data(), ctr_fds.data(), ctr_fds.size() * sizeof(CTRPollFD));
+
+    if (ret == SOCKET_ERROR_VALUE) {
+        LOG_ERROR(Service_SOC, "Socket error: {}", error);
+
+        ret = TranslateError(error);
+    }
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(3, 4);
+    IPC::RequestBuilder rb(ctx, 0x14, 2, 2);
     rb.Push(RESULT_SUCCESS);
     rb.Push(ret);
-    rb.Push(total_received);
-    rb.PushStaticBuffer(std::move(output_buff), 0);
-    rb.PushStaticBuffer(std::move(addr_buff), 1);
+    rb.PushStaticBuffer(std::move(output_fds), 0);
 }
 
 void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
@@ -775,31 +933,58 @@ void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
         platform_pollfd[i] = CTRPollFD::ToPlatform(*this, ctr_fds[i]);
     }
 
-    PreTimerAdjust();
-    s32 ret = ::poll(platform_pollfd.data(), nfds, timeout);
-    PostTimerAdjust();
-
-    // Now update the output 3ds_pollfd structure
-    for (u32 i = 0; i < nfds; i++) {
-        ctr_fds[i] = CTRPollFD::FromPlatform(*this, platform_pollfd[i]);
+    if (timeout == 0) {
+        PreTimerAdjust();
+        s32 ret = ::poll(platform_pollfd.data(), nfds, timeout);
+        PostTimerAdjust();
+        WritePollResponse(ctx, ctr_fds, platform_pollfd, ret, GET_ERRNO);
+        return;
     }
 
-    std::vector<u8> output_fds(nfds * sizeof(CTRPollFD));
-    std::memcpy(output_fds.data(), ctr_fds.data(), nfds * sizeof(CTRPollFD));
-
-    if (ret == SOCKET_ERROR_VALUE) {
-        int err = GET_ERRNO;
-        LOG_ERROR(Service_SOC, "Socket error: {}", err);
-
-        ret = TranslateError(GET_ERRNO);
+    std::vector<std::shared_ptr<SocketOps>> ops(nfds);
+    for (u32 i = 0; i < nfds; i++) {
+        const auto iter = open_sockets.find(ctr_fds[i].fd);
+        if (iter != open_sockets.end()) {
+            ops[i] = iter->second.ops;
+        }
     }
 
-    size_t test = platform_pollfd.size();
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-    rb.Push(RESULT_SUCCESS);
-    rb.Push(ret);
-    rb.PushStaticBuffer(std::move(output_fds), 0);
+    // Park the guest thread while waiting, the other threads keep running in the meantime
+    ctx.RunAsync([&kernel = Core::System::GetInstance().Kernel(), ctr_fds = std::move(ctr_fds),
+                  platform_pollfd = std::move(platform_pollfd), ops = std::move(ops),
+                  timeout](Kernel::HLERequestContext& ctx) mutable {
+        for (const auto& socket_ops : ops) {
+            if (socket_ops) {
+                BeginSocketOp(*socket_ops);
+            }
+        }
+        SCOPE_EXIT({
+            for (const auto& socket_ops : ops) {
+                if (socket_ops) {
+                    EndSocketOp(*socket_ops);
+                }
+            }
+        });
+        s32 ret;
+        if (!WaitForSockets(kernel, platform_pollfd, ops, timeout, ret)) {
+            ctx.RetryAfterDrain();
+            return s64{0};
+        }
+        const int error = GET_ERRNO;
+
+        // The sockets closed by the guest meanwhile are reported like poll reports invalid ones
+        if (IsAnySocketClosed(ops)) {
+            for (std::size_t i = 0; i < ops.size(); i++) {
+                if (ops[i] && IsSocketClosed(*ops[i])) {
+                    platform_pollfd[i].revents = POLLNVAL;
+                }
+            }
+            ret = static_cast<s32>(std::count_if(platform_pollfd.begin(), platform_pollfd.end(),
+                                                 [](const pollfd& fd) { return fd.revents != 0; }));
+        }
+        WritePollResponse(ctx, ctr_fds, platform_pollfd, ret, error);
+        return s64{0};
+    });
 }
 
 void SOC_U::GetSockName(Kernel::HLERequestContext& ctx) {
@@ -1137,6 +1322,7 @@ SOC_U::SOC_U() : ServiceFramework("soc:U") {
     };
 
     RegisterHandlers(functions);
+    SetMaxAsyncRequests(MaxAsyncRequests);
 
 #ifdef _WIN32
     WSADATA data;
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <boost/serialization/unordered_map.hpp>
 #include "core/hle/result.h"
@@ -15,6 +18,14 @@ class System;
 
 namespace Service::SOC {
 
+/// Tracks the calls that use a socket on the HLE workers, so that closing it waits for them
+struct SocketOps {
+    std::mutex mutex;
+    std::condition_variable done;
+    u32 running = 0;     ///< Calls running on the workers, guarded by mutex
+    bool closed = false; ///< Set by the guest closing the socket, guarded by mutex
+};
+
 /// Holds information about a particular socket
 struct SocketHolder {
 #ifdef _WIN32
@@ -24,7 +35,10 @@ struct SocketHolder {
     u32 socket_fd; ///< The socket descriptor
 #endif // _WIN32
 
-    bool blocking; ///< Whether the socket is blocking or not, it is only read on Windows.
+    bool blocking; ///< Whether the socket is blocking or not
+
+    /// Not serialized, the HLE workers are drained before a state is saved
+    std::shared_ptr<SocketOps> ops = std::make_shared<SocketOps>();
 
 private:
     template <class Archive>
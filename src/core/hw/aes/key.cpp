@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <boost/iostreams/device/file_descriptor.hpp>
@@ -76,12 +77,16 @@ struct KeySlot {
 
     void GenerateNormalKey() {
         if (x && y) {
-            normal = Lrot128(Add128(Xor128(Lrot128(*x, 2), *y), generator_constant), 87);
+            normal = ScrambleKey(*x, *y);
         } else {
             normal = {};
         }
     }
 
+    static AESKey ScrambleKey(const AESKey& key_x, const AESKey& key_y) {
+        return Lrot128(Add128(Xor128(Lrot128(key_x, 2), key_y), generator_constant), 87);
+    }
+
     void Clear() {
         x.reset();
         y.reset();
@@ -498,6 +503,9 @@ void LoadPresetKeys() {
 } // namespace
 
 void InitKeys(bool force) {
+    // Loaders may run on several threads, e.g. when the game list is populated
+    static std::mutex mutex;
+    std::scoped_lock lock{mutex};
     static bool initialized = false;
     if (initialized && !force)
         return;
@@ -530,6 +538,14 @@ AESKey GetNormalKey(std::size_t slot_id) {
     return key_slots.at(slot_id).normal.value_or(AESKey{});
 }
 
+std::optional<AESKey> GenerateNormalKey(std::size_t slot_id, const AESKey& key_y) {
+    const auto& key_x = key_slots.at(slot_id).x;
+    if (!key_x) {
+        return std::nullopt;
+    }
+    return KeySlot::ScrambleKey(*key_x, key_y);
+}
+
 void SelectCommonKeyIndex(u8 index) {
     key_slots[KeySlotID::TicketCommonKey].SetKeyY(common_key_y_slots.at(index));
 }
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cstddef>
+#include <optional>
 #include "common/common_types.h"
 
 namespace HW::AES {
@@ -64,6 +65,13 @@ void SetNormalKey(std::size_t slot_id, const AESKey& key);
 bool IsNormalKeyAvailable(std::size_t slot_id);
 AESKey GetNormalKey(std::size_t slot_id);
 
+/**
+ * Generates the normal key that the slot would have with the given KeyY, without changing the
+ * slot. Unlike SetKeyY followed by GetNormalKey, this is safe to call from several threads.
+ * @return the normal key, or nothing when the slot has no KeyX
+ */
+std::optional<AESKey> GenerateNormalKey(std::size_t slot_id, const AESKey& key_y);
+
 void SelectCommonKeyIndex(u8 index);
 
 } // namespace HW::AES
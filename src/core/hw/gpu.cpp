@@ -2,24 +2,33 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include <cstring>
+#include <memory>
 #include <numeric>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
+#include "common/thread_worker.h"
 #include "common/vector_math.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp.h"
+#include "core/hle/service/hid/hid.h"
 #include "core/hw/gpu.h"
 #include "core/hw/hw.h"
 #include "core/memory.h"
+#include "core/rpc/rpc_server.h"
 #include "core/tracer/recorder.h"
 #include "video_core/command_processor.h"
 #include "video_core/debug_utils/debug_utils.h"
+#include "video_core/frame_skipper.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_base.h"
 #include "video_core/utils.h"
@@ -32,6 +41,25 @@ Memory::MemorySystem* g_memory;
 
 /// Event id for CoreTiming
 static Core::TimingEventType* vblank_event;
+static Core::TimingEventType* job_finished_event;
+static Core::TimingEventType* interrupt_event;
+
+/// Runs the GPU work when async GPU emulation is enabled, nullptr otherwise
+static std::unique_ptr<Common::ThreadWorker> gpu_thread;
+static std::unique_ptr<VideoCore::FrameSkipper> frame_skipper;
+static thread_local bool is_gpu_thread = false;
+
+/// GPU work triggered by a register write. The work itself may run on the GPU thread, but its
+/// effects on the registers are always applied on the emulation thread by FinishJob.
+enum class Job : u32 {
+    MemoryFill0,
+    MemoryFill1,
+    DisplayTransfer,
+    CommandList,
+};
+
+/// Set in the event data of a finished job that signals its interrupt
+constexpr std::uintptr_t JobSignalsInterrupt = 1 << 16;
 
 template <typename T>
 inline void Read(T& var, const u32 raw_addr) {
@@ -47,32 +75,50 @@ inline void Read(T& var, const u32 raw_addr) {
     var = g_regs[addr / 4];
 }
 
-static Common::Vec4<u8> DecodePixel(Regs::PixelFormat input_format, const u8* src_pixel) {
-    switch (input_format) {
-    case Regs::PixelFormat::RGBA8:
+template <Regs::PixelFormat format>
+static Common::Vec4<u8> DecodePixel(const u8* src_pixel) {
+    if constexpr (format == Regs::PixelFormat::RGBA8) {
         return Common::Color::DecodeRGBA8(src_pixel);
-
-    case Regs::PixelFormat::RGB8:
+    } else if constexpr (format == Regs::PixelFormat::RGB8) {
         return Common::Color::DecodeRGB8(src_pixel);
-
-    case Regs::PixelFormat::RGB565:
+    } else if constexpr (format == Regs::PixelFormat::RGB565) {
         return Common::Color::DecodeRGB565(src_pixel);
-
-    case Regs::PixelFormat::RGB5A1:
+    } else if constexpr (format == Regs::PixelFormat::RGB5A1) {
         return Common::Color::DecodeRGB5A1(src_pixel);
-
-    case Regs::PixelFormat::RGBA4:
+    } else {
         return Common::Color::DecodeRGBA4(src_pixel);
+    }
+}
 
-    default:
-        LOG_ERROR(HW_GPU, "Unknown source framebuffer format {:x}", input_format);
-        return {0, 0, 0, 0};
+template <Regs::PixelFormat format>
+static void EncodePixel(const Common::Vec4<u8>& color, u8* dst_pixel) {
+    if constexpr (format == Regs::PixelFormat::RGBA8) {
+        Common::Color::EncodeRGBA8(color, dst_pixel);
+    } else if constexpr (format == Regs::PixelFormat::RGB8) {
+        Common::Color::EncodeRGB8(color, dst_pixel);
+    } else if constexpr (format == Regs::PixelFormat::RGB565) {
+        Common::Color::EncodeRGB565(color, dst_pixel);
+    } else if constexpr (format == Regs::PixelFormat::RGB5A1) {
+        Common::Color::EncodeRGB5A1(color, dst_pixel);
+    } else {
+        Common::Color::EncodeRGBA4(color, dst_pixel);
     }
 }
 
 MICROPROFILE_DEFINE(GPU_DisplayTransfer, "GPU", "DisplayTransfer", MP_RGB(100, 100, 255));
 MICROPROFILE_DEFINE(GPU_CmdlistProcessing, "GPU", "Cmdlist Processing", MP_RGB(100, 255, 100));
 
+/// Repeats the pattern over size bytes, copying ever larger filled blocks instead of single values
+static void FillPattern(u8* dst, std::size_t size, const void* pattern, std::size_t pattern_size) {
+    std::size_t filled = std::min(pattern_size, size);
+    std::memcpy(dst, pattern, filled);
+    while (filled < size) {
+        const std::size_t copy_size = std::min(filled, size - filled);
+        std::memcpy(dst + filled, dst, copy_size);
+        filled += copy_size;
+    }
+}
+
 static void MemoryFill(const Regs::MemoryFillConfig& config) {
     const PAddr start_addr = config.GetStartAddress();
     const PAddr end_addr = config.GetEndAddress();
@@ -103,27 +149,132 @@ static void MemoryFill(const Regs::MemoryFillConfig& config) {
     Memory::RasterizerInvalidateRegion(config.GetStartAddress(),
                                        config.GetEndAddress() - config.GetStartAddress());
 
+    const std::size_t size = end - start;
     if (config.fill_24bit) {
-        // fill with 24-bit values
-        for (u8* ptr = start; ptr < end; ptr += 3) {
-            ptr[0] = config.value_24bit_r;
-            ptr[1] = config.value_24bit_g;
-            ptr[2] = config.value_24bit_b;
-        }
+        // fill with 24-bit values, the last value may extend past the end like on hardware
+        const std::array<u8, 3> value = {static_cast<u8>(config.value_24bit_r),
+                                         static_cast<u8>(config.value_24bit_g),
+                                         static_cast<u8>(config.value_24bit_b)};
+        FillPattern(start, Common::AlignUp(size, value.size()), value.data(), value.size());
     } else if (config.fill_32bit) {
         // fill with 32-bit values
-        if (end > start) {
-            u32 value = config.value_32bit;
-            std::size_t len = (end - start) / sizeof(u32);
-            for (std::size_t i = 0; i < len; ++i)
-                memcpy(&start[i * sizeof(u32)], &value, sizeof(u32));
-        }
+        const u32 value = config.value_32bit;
+        FillPattern(start, Common::AlignDown(size, sizeof(value)), &value, sizeof(value));
     } else {
         // fill with 16-bit values
-        u16 value_16bit = config.value_16bit.Value();
-        for (u8* ptr = start; ptr < end; ptr += sizeof(u16))
-            memcpy(ptr, &value_16bit, sizeof(u16));
+        const u16 value = config.value_16bit.Value();
+        FillPattern(start, Common::AlignUp(size, sizeof(value)), &value, sizeof(value));
+    }
+}
+
+/// Display transfers with at least this many output pixels are split over the transfer workers
+constexpr u32 ParallelTransferPixels = 256 * 256;
+
+/// Helps with large software display transfers, nullptr when the host has few cores
+static std::unique_ptr<Common::ThreadWorker> transfer_workers;
+
+using TransferRowsFn = void (*)(const Regs::DisplayTransferConfig& config, const u8* src_pointer,
+                                u8* dst_pointer, u32 y_begin, u32 y_end);
+
+/**
+ * Converts the output rows [y_begin, y_end) of a display transfer. The formats are template
+ * parameters so the pixel conversion is inlined, and anything that only depends on the
+ * configuration is hoisted out of the pixel loop.
+ */
+template <Regs::PixelFormat input_format, Regs::PixelFormat output_format>
+static void TransferRows(const Regs::DisplayTransferConfig& config, const u8* src_pointer,
+                         u8* dst_pointer, u32 y_begin, u32 y_end) {
+    constexpr u32 src_bytes_per_pixel = Regs::BytesPerPixel(input_format);
+    constexpr u32 dst_bytes_per_pixel = Regs::BytesPerPixel(output_format);
+
+    const u32 horizontal_scale = config.scaling != config.NoScale ? 1 : 0;
+    const u32 vertical_scale = config.scaling == config.ScaleXY ? 1 : 0;
+    const u32 output_width = config.output_width >> horizontal_scale;
+    const u32 output_height = config.output_height >> vertical_scale;
+    const u32 input_width = config.input_width;
+    const bool input_linear = config.input_linear;
+    const bool dont_swizzle = config.dont_swizzle;
+    const auto scaling = config.scaling.Value();
+
+    for (u32 y = y_begin; y < y_end; ++y) {
+        // Calculate the y position of the input image based on the output position and scale.
+        // The output is flipped afterwards to account for the scaling options.
+        const u32 input_y = y << vertical_scale;
+        const u32 output_y = config.flip_vertically ? output_height - y - 1 : y;
+
+        const u32 src_linear_row = input_y * input_width * src_bytes_per_pixel;
+        const u32 src_tiled_row = (input_y & ~7) * input_width * src_bytes_per_pixel;
+        const u32 dst_linear_row = output_y * output_width * dst_bytes_per_pixel;
+        const u32 dst_tiled_row = (output_y & ~7) * output_width * dst_bytes_per_pixel;
+
+        for (u32 x = 0; x < output_width; ++x) {
+            const u32 input_x = x << horizontal_scale;
+
+            u32 src_offset;
+            u32 dst_offset;
+            if (input_linear) {
+                // Interpret the input as linear and the output as tiled, unless not swizzling
+                src_offset = src_linear_row + input_x * src_bytes_per_pixel;
+                dst_offset = dont_swizzle ? dst_linear_row + x * dst_bytes_per_pixel
+                                          : VideoCore::GetMortonOffset(x, output_y,
+                                                                       dst_bytes_per_pixel) +
+                                                dst_tiled_row;
+            } else {
+                // Interpret the input as tiled and the output as linear, unless not swizzling
+                src_offset =
+                    VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
+                    src_tiled_row;
+                dst_offset = dont_swizzle ? VideoCore::GetMortonOffset(x, output_y,
+                                                                       dst_bytes_per_pixel) +
+                                                dst_tiled_row
+                                          : dst_linear_row + x * dst_bytes_per_pixel;
+            }
+
+            // Downscaled pixels are neighbours in the tiled input
+            const u8* src_pixel = src_pointer + src_offset;
+            Common::Vec4<u8> src_color = DecodePixel<input_format>(src_pixel);
+            if (scaling == config.ScaleX) {
+                const Common::Vec4<u8> pixel =
+                    DecodePixel<input_format>(src_pixel + src_bytes_per_pixel);
+                src_color = ((src_color + pixel) / 2).Cast<u8>();
+            } else if (scaling == config.ScaleXY) {
+                const Common::Vec4<u8> pixel1 =
+                    DecodePixel<input_format>(src_pixel + 1 * src_bytes_per_pixel);
+                const Common::Vec4<u8> pixel2 =
+                    DecodePixel<input_format>(src_pixel + 2 * src_bytes_per_pixel);
+                const Common::Vec4<u8> pixel3 =
+                    DecodePixel<input_format>(src_pixel + 3 * src_bytes_per_pixel);
+                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
+            }
+
+            EncodePixel<output_format>(src_color, dst_pointer + dst_offset);
+        }
+    }
+}
+
+template <Regs::PixelFormat input_format, std::size_t... output_formats>
+static constexpr std::array<TransferRowsFn, sizeof...(output_formats)> MakeTransferRowsTable(
+    std::index_sequence<output_formats...>) {
+    return {&TransferRows<input_format, static_cast<Regs::PixelFormat>(output_formats)>...};
+}
+
+/// Returns the row converter for the format pair, nullptr when a format is unknown
+static TransferRowsFn MakeTransferRows(Regs::PixelFormat input_format,
+                                       Regs::PixelFormat output_format) {
+    constexpr std::size_t NumFormats = 5;
+    static constexpr std::array<std::array<TransferRowsFn, NumFormats>, NumFormats> table = {
+        MakeTransferRowsTable<Regs::PixelFormat::RGBA8>(std::make_index_sequence<NumFormats>{}),
+        MakeTransferRowsTable<Regs::PixelFormat::RGB8>(std::make_index_sequence<NumFormats>{}),
+        MakeTransferRowsTable<Regs::PixelFormat::RGB565>(std::make_index_sequence<NumFormats>{}),
+        MakeTransferRowsTable<Regs::PixelFormat::RGB5A1>(std::make_index_sequence<NumFormats>{}),
+        MakeTransferRowsTable<Regs::PixelFormat::RGBA4>(std::make_index_sequence<NumFormats>{}),
+    };
+    const auto input_index = static_cast<std::size_t>(input_format);
+    const auto output_index = static_cast<std::size_t>(output_format);
+    if (input_index >= NumFormats || output_index >= NumFormats) {
+        return nullptr;
     }
+    return table[input_index][output_index];
 }
 
 static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
@@ -193,113 +344,30 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), input_size);
     Memory::RasterizerInvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
-    for (u32 y = 0; y < output_height; ++y) {
-        for (u32 x = 0; x < output_width; ++x) {
-            Common::Vec4<u8> src_color;
-
-            // Calculate the [x,y] position of the input image
-            // based on the current output position and the scale
-            u32 input_x = x << horizontal_scale;
-            u32 input_y = y << vertical_scale;
-
-            u32 output_y;
-            if (config.flip_vertically) {
-                // Flip the y value of the output data,
-                // we do this after calculating the [x,y] position of the input image
-                // to account for the scaling options.
-                output_y = output_height - y - 1;
-            } else {
-                output_y = y;
-            }
-
-            u32 dst_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.output_format);
-            u32 src_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.input_format);
-            u32 src_offset;
-            u32 dst_offset;
-
-            if (config.input_linear) {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as linear and the output as tiled
-                    u32 coarse_y = output_y & ~7;
-                    u32 stride = output_width * dst_bytes_per_pixel;
-
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 coarse_y * stride;
-                } else {
-                    // Both input and output are linear
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                }
-            } else {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as tiled and the output as linear
-                    u32 coarse_y = input_y & ~7;
-                    u32 stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 coarse_y * stride;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                } else {
-                    // Both input and output are tiled
-                    u32 out_coarse_y = output_y & ~7;
-                    u32 out_stride = output_width * dst_bytes_per_pixel;
-
-                    u32 in_coarse_y = input_y & ~7;
-                    u32 in_stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 in_coarse_y * in_stride;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 out_coarse_y * out_stride;
-                }
-            }
-
-            const u8* src_pixel = src_pointer + src_offset;
-            src_color = DecodePixel(config.input_format, src_pixel);
-            if (config.scaling == config.ScaleX) {
-                Common::Vec4<u8> pixel =
-                    DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
-                src_color = ((src_color + pixel) / 2).Cast<u8>();
-            } else if (config.scaling == config.ScaleXY) {
-                Common::Vec4<u8> pixel1 =
-                    DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
-                Common::Vec4<u8> pixel2 =
-                    DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
-                Common::Vec4<u8> pixel3 =
-                    DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
-                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
-            }
-
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Regs::PixelFormat::RGBA8:
-                Common::Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB8:
-                Common::Color::EncodeRGB8(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB565:
-                Common::Color::EncodeRGB565(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB5A1:
-                Common::Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGBA4:
-                Common::Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
+    const auto transfer_rows = MakeTransferRows(config.input_format, config.output_format);
+    if (!transfer_rows) {
+        LOG_ERROR(HW_GPU, "Unknown display transfer formats {:x} -> {:x}",
+                  static_cast<u32>(config.input_format.Value()),
+                  static_cast<u32>(config.output_format.Value()));
+        return;
+    }
 
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
-                          static_cast<u32>(config.output_format.Value()));
-                break;
-            }
-        }
+    // Large transfers are split into bands of whole tiles, the calling thread takes the last one
+    const u32 num_workers =
+        transfer_workers ? static_cast<u32>(transfer_workers->NumWorkers()) : 0;
+    if (num_workers == 0 || output_width * output_height < ParallelTransferPixels) {
+        transfer_rows(config, src_pointer, dst_pointer, 0, output_height);
+        return;
+    }
+    const u32 band_height = Common::AlignUp(std::max(output_height / (num_workers + 1), 1U), 8);
+    u32 y_begin = 0;
+    for (; y_begin + band_height < output_height; y_begin += band_height) {
+        transfer_workers->QueueWork([=, &config] {
+            transfer_rows(config, src_pointer, dst_pointer, y_begin, y_begin + band_height);
+        });
     }
+    transfer_rows(config, src_pointer, dst_pointer, y_begin, output_height);
+    transfer_workers->WaitForRequests();
 }
 
 static void TextureCopy(const Regs::DisplayTransferConfig& config) {
@@ -384,6 +452,106 @@ static void TextureCopy(const Regs::DisplayTransferConfig& config) {
     }
 }
 
+/**
+ * Applies the effects of a job on the registers. Whether the job signals its interrupt is
+ * decided by the registers it was triggered with, the title may have rewritten them since.
+ */
+static void FinishJob(Job job, bool signal_interrupt) {
+    // The marks of the job have to be in place before the title sees it complete
+    g_memory->ApplyDeferredRasterizerMarks();
+
+    switch (job) {
+    case Job::MemoryFill0:
+    case Job::MemoryFill1: {
+        const bool is_second_filler = job == Job::MemoryFill1;
+        auto& config = g_regs.memory_fill_config[is_second_filler];
+
+        if (signal_interrupt) {
+            if (!is_second_filler) {
+                Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC0);
+            } else {
+                Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC1);
+            }
+        }
+
+        // Reset "trigger" flag and set the "finished" flag
+        // NOTE: This was confirmed to happen on hardware even if "address_start" is zero.
+        config.trigger.Assign(0);
+        config.finished.Assign(1);
+        break;
+    }
+    case Job::DisplayTransfer:
+        g_regs.display_transfer_config.trigger = 0;
+        Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PPF);
+        break;
+    case Job::CommandList:
+        g_regs.command_processor_config.trigger = 0;
+        break;
+    }
+}
+
+static void JobFinishedCallback(std::uintptr_t user_data, s64 cycles_late) {
+    FinishJob(static_cast<Job>(user_data & ~JobSignalsInterrupt),
+              (user_data & JobSignalsInterrupt) != 0);
+}
+
+static void InterruptCallback(std::uintptr_t user_data, s64 cycles_late) {
+    Service::GSP::SignalInterrupt(static_cast<Service::GSP::InterruptId>(user_data));
+}
+
+/**
+ * Runs the work of a job, on the GPU thread if possible. Queued jobs run in order, and their
+ * completion is reported to the emulation thread in the same order, so a title sees the trigger
+ * bits clear and the interrupts fire as if the GPU just took longer.
+ */
+template <typename Work>
+static void RunJob(Job job, bool signal_interrupt, Work&& work) {
+    // The debugger and the tracer expect the work to be done by the time the write returns
+    if (!gpu_thread || Pica::g_debug_context) {
+        Synchronize();
+        {
+            Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                                  Core::PerfStats::Subsystem::GPU};
+            work();
+        }
+        FinishJob(job, signal_interrupt);
+        return;
+    }
+
+    const std::uintptr_t user_data =
+        static_cast<std::uintptr_t>(job) | (signal_interrupt ? JobSignalsInterrupt : 0);
+    gpu_thread->QueueWork([user_data, work = std::forward<Work>(work)] {
+        is_gpu_thread = true;
+        {
+            Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                                  Core::PerfStats::Subsystem::GPU};
+            work();
+        }
+        Core::System::GetInstance().CoreTiming().ScheduleEventThreadsafe(
+            0, job_finished_event, user_data);
+    });
+}
+
+void Synchronize() {
+    if (gpu_thread && !is_gpu_thread) {
+        gpu_thread->WaitForRequests();
+        g_memory->ApplyDeferredRasterizerMarks();
+    }
+}
+
+bool IsGpuThread() {
+    return is_gpu_thread;
+}
+
+void SignalInterrupt(Service::GSP::InterruptId interrupt_id) {
+    if (is_gpu_thread) {
+        Core::System::GetInstance().CoreTiming().ScheduleEventThreadsafe(
+            0, interrupt_event, static_cast<std::uintptr_t>(interrupt_id));
+        return;
+    }
+    Service::GSP::SignalInterrupt(interrupt_id);
+}
+
 template <typename T>
 inline void Write(u32 addr, const T data) {
     addr -= HW::VADDR_GPU;
@@ -403,34 +571,23 @@ inline void Write(u32 addr, const T data) {
     case GPU_REG_INDEX(memory_fill_config[0].trigger):
     case GPU_REG_INDEX(memory_fill_config[1].trigger): {
         const bool is_second_filler = (index != GPU_REG_INDEX(memory_fill_config[0].trigger));
-        auto& config = g_regs.memory_fill_config[is_second_filler];
+        const auto& config = g_regs.memory_fill_config[is_second_filler];
 
         if (config.trigger) {
-            MemoryFill(config);
-            LOG_TRACE(HW_GPU, "MemoryFill from {:#010X} to {:#010X}", config.GetStartAddress(),
-                      config.GetEndAddress());
-
             // It seems that it won't signal interrupt if "address_start" is zero.
             // TODO: hwtest this
-            if (config.GetStartAddress() != 0) {
-                if (!is_second_filler) {
-                    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC0);
-                } else {
-                    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC1);
-                }
-            }
-
-            // Reset "trigger" flag and set the "finish" flag
-            // NOTE: This was confirmed to happen on hardware even if "address_start" is zero.
-            config.trigger.Assign(0);
-            config.finished.Assign(1);
+            const bool signal_interrupt = config.GetStartAddress() != 0;
+            const Job job = is_second_filler ? Job::MemoryFill1 : Job::MemoryFill0;
+            RunJob(job, signal_interrupt, [config] {
+                MemoryFill(config);
+                LOG_TRACE(HW_GPU, "MemoryFill from {:#010X} to {:#010X}",
+                          config.GetStartAddress(), config.GetEndAddress());
+            });
         }
         break;
     }
 
     case GPU_REG_INDEX(display_transfer_config.trigger): {
-        MICROPROFILE_SCOPE(GPU_DisplayTransfer);
-
         const auto& config = g_regs.display_transfer_config;
         if (config.trigger & 1) {
 
@@ -438,28 +595,30 @@ inline void Write(u32 addr, const T data) {
                 Pica::g_debug_context->OnEvent(Pica::DebugContext::Event::IncomingDisplayTransfer,
                                                nullptr);
 
-            if (config.is_texture_copy) {
-                TextureCopy(config);
-                LOG_TRACE(HW_GPU,
-                          "TextureCopy: {:#X} bytes from {:#010X}({}+{})-> "
-                          "{:#010X}({}+{}), flags {:#010X}",
-                          config.texture_copy.size, config.GetPhysicalInputAddress(),
-                          config.texture_copy.input_width * 16, config.texture_copy.input_gap * 16,
-                          config.GetPhysicalOutputAddress(), config.texture_copy.output_width * 16,
-                          config.texture_copy.output_gap * 16, config.flags);
-            } else {
-                DisplayTransfer(config);
-                LOG_TRACE(HW_GPU,
-                          "DisplayTransfer: {:#010X}({}x{})-> "
-                          "{:#010X}({}x{}), dst format {:x}, flags {:#010X}",
-                          config.GetPhysicalInputAddress(), config.input_width.Value(),
-                          config.input_height.Value(), config.GetPhysicalOutputAddress(),
-                          config.output_width.Value(), config.output_height.Value(),
-                          static_cast<u32>(config.output_format.Value()), config.flags);
-            }
-
-            g_regs.display_transfer_config.trigger = 0;
-            Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PPF);
+            RunJob(Job::DisplayTransfer, true, [config] {
+                MICROPROFILE_SCOPE(GPU_DisplayTransfer);
+
+                if (config.is_texture_copy) {
+                    TextureCopy(config);
+                    LOG_TRACE(HW_GPU,
+                              "TextureCopy: {:#X} bytes from {:#010X}({}+{})-> "
+                              "{:#010X}({}+{}), flags {:#010X}",
+                              config.texture_copy.size, config.GetPhysicalInputAddress(),
+                              config.texture_copy.input_width * 16,
+                              config.texture_copy.input_gap * 16, config.GetPhysicalOutputAddress(),
+                              config.texture_copy.output_width * 16,
+                              config.texture_copy.output_gap * 16, config.flags);
+                } else {
+                    DisplayTransfer(config);
+                    LOG_TRACE(HW_GPU,
+                              "DisplayTransfer: {:#010X}({}x{})-> "
+                              "{:#010X}({}x{}), dst format {:x}, flags {:#010X}",
+                              config.GetPhysicalInputAddress(), config.input_width.Value(),
+                              config.input_height.Value(), config.GetPhysicalOutputAddress(),
+                              config.output_width.Value(), config.output_height.Value(),
+                              static_cast<u32>(config.output_format.Value()), config.flags);
+                }
+            });
         }
         break;
     }
@@ -468,11 +627,11 @@ inline void Write(u32 addr, const T data) {
     case GPU_REG_INDEX(command_processor_config.trigger): {
         const auto& config = g_regs.command_processor_config;
         if (config.trigger & 1) {
-            MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
-
-            Pica::CommandProcessor::ProcessCommandList(config.GetPhysicalAddress(), config.size);
-
-            g_regs.command_processor_config.trigger = 0;
+            const PAddr address = config.GetPhysicalAddress();
+            RunJob(Job::CommandList, false, [address, size = config.size] {
+                MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
+                Pica::CommandProcessor::ProcessCommandList(address, size);
+            });
         }
         break;
     }
@@ -503,8 +662,35 @@ template void Write<u16>(u32 addr, const u16 data);
 template void Write<u8>(u32 addr, const u8 data);
 
 /// Update hardware
+/// Decides whether the draws of the frame starting at this VBlank are skipped
+static void UpdateFrameSkip(Core::System& system) {
+    const Core::PerfStats* perf_stats = system.GetPerfStats();
+    if (!frame_skipper || !perf_stats) {
+        return;
+    }
+    const double load = perf_stats->GetLastFrameLoad();
+    // Downloads write rendered data to guest memory, the game may depend on it
+    const bool readback =
+        VideoCore::g_renderer->Rasterizer()->GetLastFrameCacheStats().downloads != 0;
+    VideoCore::g_skip_draws = frame_skipper->BeginFrame(load, readback);
+}
+
 static void VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
-    VideoCore::g_renderer->SwapBuffers();
+    auto& system = Core::System::GetInstance();
+    // Re-simulated frames are never shown, and are not paced either
+    if (!system.IsResimulating()) {
+        // The presented frame may be read from surfaces the GPU thread is still rendering to
+        Synchronize();
+        VideoCore::g_renderer->SwapBuffers();
+        UpdateFrameSkip(system);
+        system.UpdateCpuClock();
+
+        // Games read the pad once the interrupts below wake them up for the next frame
+        if (const auto hid = Service::HID::GetModule(system)) {
+            hid->OnVBlank();
+        }
+    }
+    system.RPCServer().OnFrame();
 
     // Signal to GSP that GPU interrupt has occurred
     // TODO(yuriks): hwtest to determine if PDC0 is for the Top screen and PDC1 for the Sub
@@ -515,7 +701,7 @@ static void VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
     Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PDC1);
 
     // Reschedule recurrent event
-    Core::System::GetInstance().CoreTiming().ScheduleEvent(frame_ticks - cycles_late, vblank_event);
+    system.CoreTiming().ScheduleEvent(frame_ticks - cycles_late, vblank_event);
 }
 
 /// Initialize hardware
@@ -551,13 +737,42 @@ void Init(Memory::MemorySystem& memory) {
 
     Core::Timing& timing = Core::System::GetInstance().CoreTiming();
     vblank_event = timing.RegisterEvent("GPU::VBlankCallback", VBlankCallback);
+    job_finished_event = timing.RegisterEvent("GPU::JobFinishedCallback", JobFinishedCallback);
+    interrupt_event = timing.RegisterEvent("GPU::InterruptCallback", InterruptCallback);
     timing.ScheduleEvent(frame_ticks, vblank_event);
 
+    // OpenGL contexts are bound to the emulation thread, so only Vulkan can render from another
+    if (Settings::values.async_gpu) {
+        if (Settings::values.graphics_api.GetValue() == Settings::GraphicsAPI::Vulkan) {
+            gpu_thread = std::make_unique<Common::ThreadWorker>(1, "GPU");
+            gpu_thread->QueueWork([] { Common::SetCurrentThreadRole(Common::ThreadRole::Render); });
+        } else {
+            LOG_WARNING(HW_GPU, "Async GPU emulation requires the Vulkan renderer, disabling it");
+        }
+    }
+
+    if (const u32 max_skip = Settings::values.frame_skip.GetValue(); max_skip > 0) {
+        frame_skipper = std::make_unique<VideoCore::FrameSkipper>(max_skip);
+    }
+
+    // Software transfers are mostly bound by memory bandwidth, a few threads are plenty
+    const u32 num_transfer_workers =
+        Common::GetWorkerThreadCount(std::min(std::thread::hardware_concurrency() / 2, 3U));
+    if (num_transfer_workers > 0) {
+        transfer_workers =
+            std::make_unique<Common::ThreadWorker>(num_transfer_workers, "GPU transfer");
+    }
+
     LOG_DEBUG(HW_GPU, "initialized OK");
 }
 
 /// Shutdown hardware
 void Shutdown() {
+    Synchronize();
+    gpu_thread.reset();
+    transfer_workers.reset();
+    frame_skipper.reset();
+    VideoCore::g_skip_draws = false;
     LOG_DEBUG(HW_GPU, "shutdown OK");
 }
 
@@ -18,6 +18,10 @@ namespace Memory {
 class MemorySystem;
 }
 
+namespace Service::GSP {
+enum class InterruptId : u8;
+}
+
 namespace GPU {
 
 // Measured on hardware to be 2240568 timer cycles or 4481136 ARM11 cycles
@@ -58,7 +62,7 @@ struct Regs {
     /**
      * Returns the number of bytes per pixel.
      */
-    static int BytesPerPixel(PixelFormat format) {
+    static constexpr int BytesPerPixel(PixelFormat format) {
         switch (format) {
         case PixelFormat::RGBA8:
             return 4;
@@ -322,6 +326,19 @@ void Read(T& var, const u32 addr);
 template <typename T>
 void Write(u32 addr, const T data);
 
+/**
+ * Waits until the GPU thread, when it is enabled, has run all the queued memory fills, display
+ * transfers and command lists. Has to be called before the emulation thread accesses state that
+ * the GPU work uses, like the rasterizer caches or the Pica state.
+ */
+void Synchronize();
+
+/// Returns whether the calling thread is the GPU thread
+bool IsGpuThread();
+
+/// Signals a GSP interrupt, deferring it to the emulation thread when called from the GPU thread
+void SignalInterrupt(Service::GSP::InterruptId interrupt_id);
+
 /// Initialize hardware
 void Init(Memory::MemorySystem& memory);
 
@@ -24,54 +24,57 @@ static const std::size_t TILE_SIZE = 8 * 8;
 using ImageTile = std::array<u32, TILE_SIZE>;
 
 /// Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles.
-static void ConvertYUVToRGB(InputFormat input_format, const u8* input_Y, const u8* input_U,
-                            const u8* input_V, ImageTile output[], unsigned int width,
-                            unsigned int height, const CoefficientSet& coefficients) {
+template <InputFormat input_format>
+static void ConvertYUVToRGB(const u8* input_Y, const u8* input_U, const u8* input_V,
+                            ImageTile output[], unsigned int width, unsigned int height,
+                            const CoefficientSet& coefficients) {
+    constexpr bool is_interleaved = input_format == InputFormat::YUYV422_Interleaved;
+    constexpr bool is_420 = input_format == InputFormat::YUV420_Indiv8 ||
+                            input_format == InputFormat::YUV420_Indiv16;
+
+    // This conversion process is bit-exact with hardware, as far as could be tested.
+    const auto& c = coefficients;
+    const auto convert = [&c](s32 Y, s32 r_chroma, s32 g_chroma, s32 b_chroma) {
+        const s32 cY = c[0] * Y;
+
+        const s32 rounding_offset = 0x18;
+        const s32 r = ((cY + r_chroma) >> 3) + c[5] + rounding_offset;
+        const s32 g = ((cY + g_chroma) >> 3) + c[6] + rounding_offset;
+        const s32 b = ((cY + b_chroma) >> 3) + c[7] + rounding_offset;
+
+        return ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
+               ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) | ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+    };
 
     for (unsigned int y = 0; y < height; ++y) {
-        for (unsigned int x = 0; x < width; ++x) {
-            s32 Y = 0;
-            s32 U = 0;
-            s32 V = 0;
-            switch (input_format) {
-            case InputFormat::YUV422_Indiv8:
-            case InputFormat::YUV422_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[(y * width + x) / 2];
-                V = input_V[(y * width + x) / 2];
-                break;
-            case InputFormat::YUV420_Indiv8:
-            case InputFormat::YUV420_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[((y / 2) * width + x) / 2];
-                V = input_V[((y / 2) * width + x) / 2];
-                break;
-            case InputFormat::YUYV422_Interleaved:
-                Y = input_Y[(y * width + x) * 2];
-                U = input_Y[(y * width + (x / 2) * 2) * 2 + 1];
-                V = input_Y[(y * width + (x / 2) * 2) * 2 + 3];
-                break;
+        const unsigned int chroma_y = is_420 ? y / 2 : y;
+        const u8* row_Y = input_Y + y * width * (is_interleaved ? 2 : 1);
+        const u8* row_U = is_interleaved ? nullptr : input_U + chroma_y * width / 2;
+        const u8* row_V = is_interleaved ? nullptr : input_V + chroma_y * width / 2;
+
+        // Both pixels of a pair share their chroma, and the width is a multiple of 8
+        for (unsigned int x = 0; x < width; x += 2) {
+            s32 Y0, Y1, U, V;
+            if constexpr (is_interleaved) {
+                const u8* yuyv = row_Y + x * 2;
+                Y0 = yuyv[0];
+                U = yuyv[1];
+                Y1 = yuyv[2];
+                V = yuyv[3];
+            } else {
+                Y0 = row_Y[x];
+                Y1 = row_Y[x + 1];
+                U = row_U[x / 2];
+                V = row_V[x / 2];
             }
 
-            // This conversion process is bit-exact with hardware, as far as could be tested.
-            auto& c = coefficients;
-            s32 cY = c[0] * Y;
-
-            s32 r = cY + c[1] * V;
-            s32 g = cY - c[2] * V - c[3] * U;
-            s32 b = cY + c[4] * U;
-
-            const s32 rounding_offset = 0x18;
-            r = (r >> 3) + c[5] + rounding_offset;
-            g = (g >> 3) + c[6] + rounding_offset;
-            b = (b >> 3) + c[7] + rounding_offset;
-
-            unsigned int tile = x / 8;
-            unsigned int tile_x = x % 8;
-            u32* out = &output[tile][y * 8 + tile_x];
-            *out = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
-                   ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
-                   ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+            const s32 r_chroma = c[1] * V;
+            const s32 g_chroma = -c[2] * V - c[3] * U;
+            const s32 b_chroma = c[4] * U;
+
+            u32* out = &output[x / 8][y * 8 + x % 8];
+            out[0] = convert(Y0, r_chroma, g_chroma, b_chroma);
+            out[1] = convert(Y1, r_chroma, g_chroma, b_chroma);
         }
     }
 }
@@ -102,8 +105,12 @@ static void ReceiveData(Memory::MemorySystem& memory, u8* output, ConversionBuff
 
 /// Convert intermediate RGB32 format to the final output format while simulating an outgoing CDMA
 /// transfer.
+template <OutputFormat output_format>
 static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionBuffer& buf,
-                     int amount_of_data, OutputFormat output_format, u8 alpha) {
+                     int amount_of_data, u8 alpha) {
+    constexpr std::ptrdiff_t bytes_per_pixel = output_format == OutputFormat::RGBA8  ? 4
+                                               : output_format == OutputFormat::RGB8 ? 3
+                                                                                     : 2;
 
     u8* output = memory.GetPointer(buf.address);
 
@@ -113,24 +120,16 @@ static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionB
             u32 color = *input++;
             Common::Vec4<u8> col_vec{(u8)(color >> 24), (u8)(color >> 16), (u8)(color >> 8), alpha};
 
-            switch (output_format) {
-            case OutputFormat::RGBA8:
+            if constexpr (output_format == OutputFormat::RGBA8) {
                 Common::Color::EncodeRGBA8(col_vec, output);
-                output += 4;
-                break;
-            case OutputFormat::RGB8:
+            } else if constexpr (output_format == OutputFormat::RGB8) {
                 Common::Color::EncodeRGB8(col_vec, output);
-                output += 3;
-                break;
-            case OutputFormat::RGB5A1:
+            } else if constexpr (output_format == OutputFormat::RGB5A1) {
                 Common::Color::EncodeRGB5A1(col_vec, output);
-                output += 2;
-                break;
-            case OutputFormat::RGB565:
+            } else {
                 Common::Color::EncodeRGB565(col_vec, output);
-                output += 2;
-                break;
             }
+            output += bytes_per_pixel;
 
             amount_of_data -= 1;
         }
@@ -323,10 +322,25 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration& cv
             break;
         }
 
-        // Note(yuriks): If additional optimization is required, input_format can be moved to a
-        // template parameter, so that its dispatch can be moved to outside the inner loop.
-        ConvertYUVToRGB(cvt.input_format, input_Y, input_U, input_V, tiles.get(),
-                        cvt.input_line_width, row_height, cvt.coefficients);
+        switch (cvt.input_format) {
+        case InputFormat::YUV422_Indiv8:
+        case InputFormat::YUV422_Indiv16:
+            ConvertYUVToRGB<InputFormat::YUV422_Indiv8>(input_Y, input_U, input_V, tiles.get(),
+                                                        cvt.input_line_width, row_height,
+                                                        cvt.coefficients);
+            break;
+        case InputFormat::YUV420_Indiv8:
+        case InputFormat::YUV420_Indiv16:
+            ConvertYUVToRGB<InputFormat::YUV420_Indiv8>(input_Y, input_U, input_V, tiles.get(),
+                                                        cvt.input_line_width, row_height,
+                                                        cvt.coefficients);
+            break;
+        case InputFormat::YUYV422_Interleaved:
+            ConvertYUVToRGB<InputFormat::YUYV422_Interleaved>(input_Y, input_U, input_V,
+                                                              tiles.get(), cvt.input_line_width,
+                                                              row_height, cvt.coefficients);
+            break;
+        }
 
         u32* output_buffer = reinterpret_cast<u32*>(data_buffer.get());
 
@@ -371,10 +385,22 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration& cv
             }
         }
 
-        // Note(yuriks): If additional optimization is required, output_format can be moved to a
-        // template parameter, so that its dispatch can be moved to outside the inner loop.
-        SendData(memory, reinterpret_cast<u32*>(data_buffer.get()), cvt.dst, (int)row_data_size,
-                 cvt.output_format, (u8)cvt.alpha);
+        const u32* rgb_buffer = reinterpret_cast<u32*>(data_buffer.get());
+        const u8 alpha = static_cast<u8>(cvt.alpha);
+        switch (cvt.output_format) {
+        case OutputFormat::RGBA8:
+            SendData<OutputFormat::RGBA8>(memory, rgb_buffer, cvt.dst, (int)row_data_size, alpha);
+            break;
+        case OutputFormat::RGB8:
+            SendData<OutputFormat::RGB8>(memory, rgb_buffer, cvt.dst, (int)row_data_size, alpha);
+            break;
+        case OutputFormat::RGB5A1:
+            SendData<OutputFormat::RGB5A1>(memory, rgb_buffer, cvt.dst, (int)row_data_size, alpha);
+            break;
+        case OutputFormat::RGB565:
+            SendData<OutputFormat::RGB565>(memory, rgb_buffer, cvt.dst, (int)row_data_size, alpha);
+            break;
+        }
     }
 }
 } // namespace HW::Y2R
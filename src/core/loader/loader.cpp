@@ -33,7 +33,7 @@ FileType IdentifyFile(FileUtil::IOFile& file) {
 }
 
 FileType IdentifyFile(const std::string& file_name) {
-    FileUtil::IOFile file(file_name, "rb");
+    FileUtil::IOFile file(file_name, "rb", FileUtil::IOFile::DecompressSeekable);
     if (!file.IsOpen()) {
         LOG_ERROR(Loader, "Failed to load file {}", file_name);
         return FileType::Unknown;
@@ -115,7 +115,7 @@ static std::unique_ptr<AppLoader> GetFileLoader(FileUtil::IOFile&& file, FileTyp
 }
 
 std::unique_ptr<AppLoader> GetLoader(const std::string& filename) {
-    FileUtil::IOFile file(filename, "rb");
+    FileUtil::IOFile file(filename, "rb", FileUtil::IOFile::DecompressSeekable);
     if (!file.IsOpen()) {
         LOG_ERROR(Loader, "Failed to load file {}", filename);
         return nullptr;
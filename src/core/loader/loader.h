@@ -101,6 +101,13 @@ public:
      */
     virtual ResultStatus Load(std::shared_ptr<Kernel::Process>& process) = 0;
 
+    /**
+     * Does the part of Load that only reads the file, such as parsing the containers and
+     * decompressing the code, so that it can run while the system is being initialized. Load
+     * has to be called afterwards and must not run at the same time.
+     */
+    virtual void Preload() {}
+
     /**
      * Loads the system mode that this application needs.
      * This function defaults to 2 (96MB allocated to the application) if it can't read the
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <locale>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <fmt/format.h>
 #include "common/logging/log.h"
@@ -75,6 +76,61 @@ std::pair<std::optional<u8>, ResultStatus> AppLoader_NCCH::LoadKernelN3dsMode()
                           ResultStatus::Success);
 }
 
+ResultStatus AppLoader_NCCH::LoadContainers() {
+    ResultStatus result = base_ncch.Load();
+    if (result != ResultStatus::Success)
+        return result;
+
+    if (!is_update_checked) {
+        u64_le ncch_program_id;
+        ReadProgramId(ncch_program_id);
+        update_ncch.OpenFile(Service::AM::GetTitleContentPath(Service::FS::MediaType::SDMC,
+                                                              ncch_program_id | UPDATE_MASK));
+        if (update_ncch.Load() == ResultStatus::Success) {
+            overlay_ncch = &update_ncch;
+        }
+        is_update_checked = true;
+    }
+    return ResultStatus::Success;
+}
+
+ResultStatus AppLoader_NCCH::LoadCode(std::vector<u8>& code) {
+    // Cached code already has .bss allocated and patches applied
+    if (overlay_ncch->LoadCachedCode(code) == ResultStatus::Success) {
+        return ResultStatus::Success;
+    }
+    if (ReadCode(code) != ResultStatus::Success) {
+        return ResultStatus::Error;
+    }
+    if (IsGbaVirtualConsole(code)) {
+        LOG_ERROR(Loader, "Encountered unsupported GBA Virtual Console code section.");
+        return ResultStatus::ErrorGbaTitle;
+    }
+
+    // TODO(yuriks): Not sure if the bss size is added to the page-aligned .data size or just
+    //               to the regular size. Playing it safe for now.
+    const u32 bss_page_size =
+        (overlay_ncch->exheader_header.codeset_info.bss_size + 0xFFF) & ~0xFFF;
+    code.resize(code.size() + bss_page_size, 0);
+
+    // Apply patches now that the entire codeset (including .bss) has been allocated
+    const ResultStatus patch_result = overlay_ncch->ApplyCodePatch(code);
+    if (patch_result != ResultStatus::Success && patch_result != ResultStatus::ErrorNotUsed)
+        return patch_result;
+    overlay_ncch->StoreCachedCode(code);
+    return ResultStatus::Success;
+}
+
+void AppLoader_NCCH::Preload() {
+    if (is_loaded || preloaded_code || LoadContainers() != ResultStatus::Success) {
+        // Load reports the error
+        return;
+    }
+    std::vector<u8> code;
+    const ResultStatus result = LoadCode(code);
+    preloaded_code.emplace(result, std::move(code));
+}
+
 ResultStatus AppLoader_NCCH::LoadExec(std::shared_ptr<Kernel::Process>& process) {
     using Kernel::CodeSet;
 
@@ -82,14 +138,17 @@ ResultStatus AppLoader_NCCH::LoadExec(std::shared_ptr<Kernel::Process>& process)
         return ResultStatus::ErrorNotLoaded;
 
     std::vector<u8> code;
+    ResultStatus code_result;
+    if (preloaded_code) {
+        code_result = preloaded_code->first;
+        code = std::move(preloaded_code->second);
+        preloaded_code.reset();
+    } else {
+        code_result = LoadCode(code);
+    }
     u64_le program_id;
-    if (ResultStatus::Success == ReadCode(code) &&
+    if (code_result == ResultStatus::Success &&
         ResultStatus::Success == ReadProgramId(program_id)) {
-        if (IsGbaVirtualConsole(code)) {
-            LOG_ERROR(Loader, "Encountered unsupported GBA Virtual Console code section.");
-            return ResultStatus::ErrorGbaTitle;
-        }
-
         std::string process_name = Common::StringFromFixedZeroTerminatedBuffer(
             (const char*)overlay_ncch->exheader_header.codeset_info.name, 8);
 
@@ -107,10 +166,8 @@ ResultStatus AppLoader_NCCH::LoadExec(std::shared_ptr<Kernel::Process>& process)
         codeset->RODataSegment().size =
             overlay_ncch->exheader_header.codeset_info.ro.num_max_pages * Memory::CITRA_PAGE_SIZE;
 
-        // TODO(yuriks): Not sure if the bss size is added to the page-aligned .data size or just
-        //               to the regular size. Playing it safe for now.
+        // The code already has the .bss appended by LoadCode
         u32 bss_page_size = (overlay_ncch->exheader_header.codeset_info.bss_size + 0xFFF) & ~0xFFF;
-        code.resize(code.size() + bss_page_size, 0);
 
         codeset->DataSegment().offset =
             codeset->RODataSegment().offset + codeset->RODataSegment().size;
@@ -120,11 +177,6 @@ ResultStatus AppLoader_NCCH::LoadExec(std::shared_ptr<Kernel::Process>& process)
                 Memory::CITRA_PAGE_SIZE +
             bss_page_size;
 
-        // Apply patches now that the entire codeset (including .bss) has been allocated
-        const ResultStatus patch_result = overlay_ncch->ApplyCodePatch(code);
-        if (patch_result != ResultStatus::Success && patch_result != ResultStatus::ErrorNotUsed)
-            return patch_result;
-
         codeset->entrypoint = codeset->CodeSegment().addr;
         codeset->memory = std::move(code);
 
@@ -159,7 +211,7 @@ ResultStatus AppLoader_NCCH::LoadExec(std::shared_ptr<Kernel::Process>& process)
         process->Run(priority, stack_size);
         return ResultStatus::Success;
     }
-    return ResultStatus::Error;
+    return code_result == ResultStatus::Success ? ResultStatus::Error : code_result;
 }
 
 void AppLoader_NCCH::ParseRegionLockoutInfo() {
@@ -194,7 +246,7 @@ ResultStatus AppLoader_NCCH::Load(std::shared_ptr<Kernel::Process>& process) {
     if (is_loaded)
         return ResultStatus::ErrorAlreadyLoaded;
 
-    ResultStatus result = base_ncch.Load();
+    ResultStatus result = LoadContainers();
     if (result != ResultStatus::Success)
         return result;
 
@@ -203,13 +255,6 @@ ResultStatus AppLoader_NCCH::Load(std::shared_ptr<Kernel::Process>& process) {
 
     LOG_INFO(Loader, "Program ID: {}", program_id);
 
-    update_ncch.OpenFile(Service::AM::GetTitleContentPath(Service::FS::MediaType::SDMC,
-                                                          ncch_program_id | UPDATE_MASK));
-    result = update_ncch.Load();
-    if (result == ResultStatus::Success) {
-        overlay_ncch = &update_ncch;
-    }
-
     auto& system = Core::System::GetInstance();
     system.TelemetrySession().AddField(Common::Telemetry::FieldType::Session, "ProgramId",
                                        program_id);
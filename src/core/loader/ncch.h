@@ -5,6 +5,9 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/file_sys/ncch_container.h"
@@ -67,7 +70,19 @@ public:
 
     ResultStatus ReadTitle(std::string& title) override;
 
+    void Preload() override;
+
 private:
+    /// Loads the base NCCH and the update NCCH if one is installed
+    ResultStatus LoadContainers();
+
+    /**
+     * Reads the .code section, with .bss allocated and patches applied
+     * @param code Reference to buffer to store the code
+     * @return ResultStatus result of function
+     */
+    ResultStatus LoadCode(std::vector<u8>& code);
+
     /**
      * Loads .code section into memory for booting
      * @param process The newly created process
@@ -84,6 +99,10 @@ private:
     FileSys::NCCHContainer base_ncch;
     FileSys::NCCHContainer update_ncch;
     FileSys::NCCHContainer* overlay_ncch;
+    bool is_update_checked = false;
+
+    /// Result of LoadCode when it was run by Preload, consumed by LoadExec
+    std::optional<std::pair<ResultStatus, std::vector<u8>>> preloaded_code;
 
     std::string filepath;
 };
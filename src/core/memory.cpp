@@ -4,6 +4,8 @@
 
 #include <array>
 #include <cstring>
+#include <mutex>
+#include <optional>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/binary_object.hpp>
 #include "audio_core/dsp_interface.h"
@@ -11,16 +13,19 @@
 #include "common/assert.h"
 #include "common/atomic_ops.h"
 #include "common/common_types.h"
+#include "common/host_memory.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "common/swap.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
+#include "core/cpu_manager.h"
 #include "core/global.h"
 #include "core/hle/kernel/memory.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/lock.h"
 #include "core/hle/service/plgldr/plgldr.h"
+#include "core/hw/gpu.h"
 #include "core/hw/hw.h"
 #include "core/memory.h"
 #include "video_core/renderer_base.h"
@@ -35,10 +40,16 @@ namespace Memory {
 
 void PageTable::Clear() {
     pointers.raw.fill(nullptr);
-    pointers.refs.fill(MemoryRef());
+    for (auto& block : pointers.refs) {
+        block.reset();
+    }
     attributes.fill(PageType::Unmapped);
 }
 
+u8* PageTable::GetFastmemPointer() const {
+    return fastmem_arena ? fastmem_arena->VirtualBasePointer() : nullptr;
+}
+
 class RasterizerCacheMarker {
 public:
     void Mark(VAddr addr, bool cached) {
@@ -89,16 +100,35 @@ private:
 
 class MemorySystem::Impl {
 public:
-    // Visual Studio would try to allocate these on compile time if they are std::array, which would
+    static constexpr std::size_t FCRAM_OFFSET = 0;
+    static constexpr std::size_t VRAM_OFFSET = FCRAM_OFFSET + FCRAM_N3DS_SIZE;
+    static constexpr std::size_t N3DS_EXTRA_RAM_OFFSET = VRAM_OFFSET + VRAM_SIZE;
+    static constexpr std::size_t BACKING_SIZE = N3DS_EXTRA_RAM_OFFSET + N3DS_EXTRA_RAM_SIZE;
+
+    /// Shared memory backing FCRAM, VRAM and the N3DS extra RAM when fastmem is available
+    std::unique_ptr<Common::HostMemory> host_memory;
+    // Visual Studio would try to allocate this on compile time if it was a std::array, which would
     // exceed the memory limit.
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
+    std::unique_ptr<Common::LargePageMemory> fallback_memory;
+
+    u8* fcram = nullptr;
+    u8* vram = nullptr;
+    u8* n3ds_extra_ram = nullptr;
+    bool serialize_fcram = true;
 
     std::shared_ptr<PageTable> current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
     std::vector<std::shared_ptr<PageTable>> page_table_list;
 
+    struct DeferredMark {
+        PAddr start;
+        u32 size;
+        bool cached;
+    };
+    /// Cache marks of the GPU thread, waiting for the emulation thread to apply them
+    std::vector<DeferredMark> deferred_marks;
+    std::mutex deferred_marks_mutex;
+
     AudioCore::DspInterface* dsp = nullptr;
 
     std::shared_ptr<BackingMem> fcram_mem;
@@ -111,13 +141,13 @@ public:
     const u8* GetPtr(Region r) const {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -126,13 +156,13 @@ public:
     u8* GetPtr(Region r) {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -153,6 +183,106 @@ public:
         }
     }
 
+    /// Reserves the host mirror of a page table and maps every page that is already mapped.
+    void CreateFastmemArena(PageTable& page_table) {
+        if (!host_memory) {
+            return;
+        }
+        auto arena = std::make_shared<Common::VirtualArena>(*host_memory, std::size_t{1} << 32);
+        if (!arena->IsValid()) {
+            return;
+        }
+        page_table.fastmem_arena = std::move(arena);
+        UpdateFastmem(page_table, 0, PAGE_TABLE_NUM_ENTRIES);
+    }
+
+    /**
+     * Mirrors the given pages of a page table in its fastmem arena. Pages of type `Memory` that are
+     * backed by FCRAM, VRAM or the N3DS extra RAM are mapped, every other page is left inaccessible
+     * so that the JIT falls back to the page table when it touches it.
+     */
+    void UpdateFastmem(PageTable& page_table, std::size_t first_page, std::size_t num_pages) {
+        if (!page_table.fastmem_arena) {
+            return;
+        }
+        Common::VirtualArena& arena = *page_table.fastmem_arena;
+        const u8* backing_base = host_memory->BackingBasePointer();
+        const auto backing_offset = [&](std::size_t page) -> std::optional<std::size_t> {
+            const u8* pointer = page_table.GetPointerArray()[page];
+            if (page_table.attributes[page] != PageType::Memory || pointer < backing_base ||
+                pointer >= backing_base + BACKING_SIZE) {
+                return std::nullopt;
+            }
+            return static_cast<std::size_t>(pointer - backing_base);
+        };
+
+        // Coalesce runs of pages that are contiguous in the backing to keep the mapping count low.
+        const std::size_t end_page = first_page + num_pages;
+        std::size_t page = first_page;
+        while (page < end_page) {
+            const std::size_t run_start = page;
+            const auto run_offset = backing_offset(page);
+            do {
+                page++;
+            } while (page < end_page && [&] {
+                const auto offset = backing_offset(page);
+                if (!run_offset) {
+                    return !offset;
+                }
+                return offset && *offset == *run_offset + (page - run_start) * CITRA_PAGE_SIZE;
+            }());
+
+            const std::size_t vaddr = run_start * CITRA_PAGE_SIZE;
+            const std::size_t length = (page - run_start) * CITRA_PAGE_SIZE;
+            if (run_offset) {
+                arena.Map(vaddr, *run_offset, length);
+            } else {
+                arena.Unmap(vaddr, length);
+            }
+        }
+    }
+
+    /**
+     * Switches the given virtual pages between `Memory` and `RasterizerCachedMemory` in every page
+     * table, the fastmem arenas are only updated for the range of pages that actually changed.
+     */
+    void MarkPagesCached(VAddr vaddr, u32 num_pages, bool cached) {
+        const PageType from = cached ? PageType::Memory : PageType::RasterizerCachedMemory;
+        const PageType to = cached ? PageType::RasterizerCachedMemory : PageType::Memory;
+        const std::size_t first_page = vaddr >> CITRA_PAGE_BITS;
+        const std::size_t end_page = first_page + num_pages;
+
+        for (std::size_t page = first_page; page < end_page; ++page) {
+            cache_marker.Mark(static_cast<VAddr>(page << CITRA_PAGE_BITS), cached);
+        }
+
+        for (const auto& page_table : page_table_list) {
+            std::size_t first_changed = end_page;
+            std::size_t last_changed = first_page;
+            for (std::size_t page = first_page; page < end_page; ++page) {
+                PageType& page_type = page_table->attributes[page];
+                if (page_type == PageType::Unmapped) {
+                    // It is not necessary for a process to have this region mapped into its
+                    // address space, for example, a system module need not have a VRAM mapping.
+                    continue;
+                }
+                ASSERT(page_type == from);
+                page_type = to;
+                if (cached) {
+                    page_table->pointers[page] = nullptr;
+                } else {
+                    page_table->pointers[page] =
+                        GetPointerForRasterizerCache(static_cast<VAddr>(page << CITRA_PAGE_BITS));
+                }
+                first_changed = std::min(first_changed, page);
+                last_changed = page;
+            }
+            if (first_changed != end_page) {
+                UpdateFastmem(*page_table, first_changed, last_changed - first_changed + 1);
+            }
+        }
+    }
+
     /**
      * This function should only be called for virtual addreses with attribute `PageType::Special`.
      */
@@ -302,13 +432,18 @@ private:
     void serialize(Archive& ar, const unsigned int file_version) {
         bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
         ar& save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
+        ar& boost::serialization::make_binary_object(vram, Memory::VRAM_SIZE);
+        const std::size_t fcram_size = save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE;
+        ar& boost::serialization::make_binary_object(fcram, serialize_fcram ? fcram_size : 0);
         ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+            n3ds_extra_ram, save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
         ar& cache_marker;
         ar& page_table_list;
+        if (Archive::is_loading::value) {
+            for (const auto& page_table : page_table_list) {
+                CreateFastmemArena(*page_table);
+            }
+        }
         // dsp is set from Core::System at startup
         ar& current_page_table;
         ar& fcram_mem;
@@ -349,7 +484,28 @@ MemorySystem::Impl::Impl()
     : fcram_mem(std::make_shared<BackingMemImpl<Region::FCRAM>>(*this)),
       vram_mem(std::make_shared<BackingMemImpl<Region::VRAM>>(*this)),
       n3ds_extra_ram_mem(std::make_shared<BackingMemImpl<Region::N3DS>>(*this)),
-      dsp_mem(std::make_shared<BackingMemImpl<Region::DSP>>(*this)) {}
+      dsp_mem(std::make_shared<BackingMemImpl<Region::DSP>>(*this)) {
+    // The JIT needs a 4 GiB window of address space for every page table.
+    if (Settings::values.use_fastmem && sizeof(void*) == 8) {
+        host_memory = std::make_unique<Common::HostMemory>(BACKING_SIZE);
+        if (!host_memory->IsValid()) {
+            LOG_WARNING(HW_Memory, "Fastmem is not supported on this host");
+            host_memory.reset();
+        }
+    }
+
+    u8* base;
+    if (host_memory) {
+        base = host_memory->BackingBasePointer();
+    } else {
+        fallback_memory = std::make_unique<Common::LargePageMemory>(BACKING_SIZE);
+        ASSERT_MSG(fallback_memory->IsValid(), "Failed to allocate the emulated memory");
+        base = fallback_memory->Pointer();
+    }
+    fcram = base + FCRAM_OFFSET;
+    vram = base + VRAM_OFFSET;
+    n3ds_extra_ram = base + N3DS_EXTRA_RAM_OFFSET;
+}
 
 MemorySystem::MemorySystem() : impl(std::make_unique<Impl>()) {}
 MemorySystem::~MemorySystem() = default;
@@ -377,6 +533,7 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
     RasterizerFlushVirtualRegion(base << CITRA_PAGE_BITS, size * CITRA_PAGE_SIZE,
                                  FlushMode::FlushAndInvalidate);
 
+    const u32 first_page = base;
     u32 end = base + size;
     while (base != end) {
         ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
@@ -394,6 +551,8 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
         if (memory != nullptr && memory.GetSize() > CITRA_PAGE_SIZE)
             memory += CITRA_PAGE_SIZE;
     }
+
+    impl->UpdateFastmem(page_table, first_page, size);
 }
 
 void MemorySystem::MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, MemoryRef target) {
@@ -424,6 +583,7 @@ MemoryRef MemorySystem::GetPointerForRasterizerCache(VAddr addr) const {
 }
 
 void MemorySystem::RegisterPageTable(std::shared_ptr<PageTable> page_table) {
+    impl->CreateFastmemArena(*page_table);
     impl->page_table_list.push_back(page_table);
 }
 
@@ -434,6 +594,17 @@ void MemorySystem::UnregisterPageTable(std::shared_ptr<PageTable> page_table) {
     }
 }
 
+/**
+ * The memory slow paths reach into emulated hardware and the rasterizer, which are owned by the emu
+ * thread. Core threads running in parallel need to hold the HLE lock while they take them.
+ */
+static std::unique_lock<std::recursive_mutex> LockForSlowPath() {
+    if (Core::CpuManager::GetThreadCore()) {
+        return Core::System::GetInstance().LockHLE();
+    }
+    return {};
+}
+
 template <typename T>
 T ReadMMIO(MMIORegionPointer mmio_handler, VAddr addr);
 
@@ -447,6 +618,8 @@ T MemorySystem::Read(const VAddr vaddr) {
         return value;
     }
 
+    const auto lock = LockForSlowPath();
+
     // Custom Luma3ds mapping
     // Is there a more efficient way to do this?
     if (vaddr & (1 << 31)) {
@@ -500,6 +673,8 @@ void MemorySystem::Write(const VAddr vaddr, const T data) {
         return;
     }
 
+    const auto lock = LockForSlowPath();
+
     // Custom Luma3ds mapping
     // Is there a more efficient way to do this?
     if (vaddr & (1 << 31)) {
@@ -546,6 +721,8 @@ bool MemorySystem::WriteExclusive(const VAddr vaddr, const T data, const T expec
         return Common::AtomicCompareAndSwap(volatile_pointer, data, expected);
     }
 
+    const auto lock = LockForSlowPath();
+
     PageType type = impl->current_page_table->attributes[vaddr >> CITRA_PAGE_BITS];
     switch (type) {
     case PageType::Unmapped:
@@ -694,19 +871,43 @@ MemoryRef MemorySystem::GetPhysicalRef(PAddr address) const {
 }
 
 /// For a rasterizer-accessible PAddr, gets a list of all possible VAddr
-static std::vector<VAddr> PhysicalToVirtualAddressForRasterizer(PAddr addr) {
+/// Virtual aliases of a run of physical pages that map linearly to each of them
+struct RasterizerAliases {
+    std::array<VAddr, 2> vaddrs{};
+    std::size_t count = 0;
+    u32 num_pages = 1;
+};
+
+static RasterizerAliases PhysicalToVirtualRangeForRasterizer(PAddr addr, u32 max_pages) {
+    const auto make_aliases = [addr, max_pages](PAddr region_end,
+                                                std::initializer_list<VAddr> vaddrs) {
+        RasterizerAliases aliases;
+        std::copy(vaddrs.begin(), vaddrs.end(), aliases.vaddrs.begin());
+        aliases.count = vaddrs.size();
+        aliases.num_pages = std::min(max_pages, (region_end - addr) >> CITRA_PAGE_BITS);
+        return aliases;
+    };
+
+    const PAddr plugin_fb_addr = Service::PLGLDR::PLG_LDR::GetPluginFBAddr();
+    const PAddr plugin_fb_end = plugin_fb_addr + PLUGIN_3GX_FB_SIZE;
     if (addr >= VRAM_PADDR && addr < VRAM_PADDR_END) {
-        return {addr - VRAM_PADDR + VRAM_VADDR};
+        return make_aliases(VRAM_PADDR_END, {addr - VRAM_PADDR + VRAM_VADDR});
     }
-    if (addr >= Service::PLGLDR::PLG_LDR::GetPluginFBAddr() &&
-        addr < Service::PLGLDR::PLG_LDR::GetPluginFBAddr() + PLUGIN_3GX_FB_SIZE) {
-        return {addr - Service::PLGLDR::PLG_LDR::GetPluginFBAddr() + PLUGIN_3GX_FB_VADDR};
+    if (addr >= plugin_fb_addr && addr < plugin_fb_end) {
+        return make_aliases(plugin_fb_end, {addr - plugin_fb_addr + PLUGIN_3GX_FB_VADDR});
     }
+    // Runs in FCRAM must stop where the plugin framebuffer starts
+    const auto fcram_end = [&](PAddr region_end) {
+        return plugin_fb_addr > addr ? std::min(region_end, plugin_fb_addr) : region_end;
+    };
     if (addr >= FCRAM_PADDR && addr < FCRAM_PADDR_END) {
-        return {addr - FCRAM_PADDR + LINEAR_HEAP_VADDR, addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR};
+        return make_aliases(fcram_end(FCRAM_PADDR_END),
+                            {addr - FCRAM_PADDR + LINEAR_HEAP_VADDR,
+                             addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR});
     }
     if (addr >= FCRAM_PADDR_END && addr < FCRAM_N3DS_PADDR_END) {
-        return {addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR};
+        return make_aliases(fcram_end(FCRAM_N3DS_PADDR_END),
+                            {addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR});
     }
     // While the physical <-> virtual mapping is 1:1 for the regions supported by the cache,
     // some games (like Pokemon Super Mystery Dungeon) will try to use textures that go beyond
@@ -723,48 +924,34 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
         return;
     }
 
-    u32 num_pages = ((start + size - 1) >> CITRA_PAGE_BITS) - (start >> CITRA_PAGE_BITS) + 1;
-    PAddr paddr = start;
+    // The page tables and fastmem are in use by the CPU while the GPU thread runs
+    if (GPU::IsGpuThread()) {
+        std::scoped_lock lock{impl->deferred_marks_mutex};
+        impl->deferred_marks.push_back({start, size, cached});
+        return;
+    }
 
-    for (unsigned i = 0; i < num_pages; ++i, paddr += CITRA_PAGE_SIZE) {
-        for (VAddr vaddr : PhysicalToVirtualAddressForRasterizer(paddr)) {
-            impl->cache_marker.Mark(vaddr, cached);
-            for (auto page_table : impl->page_table_list) {
-                PageType& page_type = page_table->attributes[vaddr >> CITRA_PAGE_BITS];
+    u32 num_pages = ((start + size - 1) >> CITRA_PAGE_BITS) - (start >> CITRA_PAGE_BITS) + 1;
+    PAddr paddr = start & ~CITRA_PAGE_MASK;
 
-                if (cached) {
-                    // Switch page type to cached if now cached
-                    switch (page_type) {
-                    case PageType::Unmapped:
-                        // It is not necessary for a process to have this region mapped into its
-                        // address space, for example, a system module need not have a VRAM mapping.
-                        break;
-                    case PageType::Memory:
-                        page_type = PageType::RasterizerCachedMemory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] = nullptr;
-                        break;
-                    default:
-                        UNREACHABLE();
-                    }
-                } else {
-                    // Switch page type to uncached if now uncached
-                    switch (page_type) {
-                    case PageType::Unmapped:
-                        // It is not necessary for a process to have this region mapped into its
-                        // address space, for example, a system module need not have a VRAM mapping.
-                        break;
-                    case PageType::RasterizerCachedMemory: {
-                        page_type = PageType::Memory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] =
-                            GetPointerForRasterizerCache(vaddr & ~CITRA_PAGE_MASK);
-                        break;
-                    }
-                    default:
-                        UNREACHABLE();
-                    }
-                }
-            }
+    while (num_pages > 0) {
+        const RasterizerAliases aliases = PhysicalToVirtualRangeForRasterizer(paddr, num_pages);
+        for (std::size_t i = 0; i < aliases.count; ++i) {
+            impl->MarkPagesCached(aliases.vaddrs[i], aliases.num_pages, cached);
         }
+        paddr += aliases.num_pages << CITRA_PAGE_BITS;
+        num_pages -= aliases.num_pages;
+    }
+}
+
+void MemorySystem::ApplyDeferredRasterizerMarks() {
+    std::vector<Impl::DeferredMark> marks;
+    {
+        std::scoped_lock lock{impl->deferred_marks_mutex};
+        marks.swap(impl->deferred_marks);
+    }
+    for (const auto& mark : marks) {
+        RasterizerMarkRegionCached(mark.start, mark.size, mark.cached);
     }
 }
 
@@ -773,6 +960,7 @@ void RasterizerFlushRegion(PAddr start, u32 size) {
         return;
     }
 
+    GPU::Synchronize();
     VideoCore::g_renderer->Rasterizer()->FlushRegion(start, size);
 }
 
@@ -781,6 +969,7 @@ void RasterizerInvalidateRegion(PAddr start, u32 size) {
         return;
     }
 
+    GPU::Synchronize();
     VideoCore::g_renderer->Rasterizer()->InvalidateRegion(start, size);
 }
 
@@ -791,17 +980,26 @@ void RasterizerFlushAndInvalidateRegion(PAddr start, u32 size) {
         return;
     }
 
+    GPU::Synchronize();
     VideoCore::g_renderer->Rasterizer()->FlushAndInvalidateRegion(start, size);
 }
 
-void RasterizerClearAll(bool flush) {
-    // Since pages are unmapped on shutdown after video core is shutdown, the renderer may be
-    // null here
+void RasterizerSuspendCaches(bool flush) {
     if (VideoCore::g_renderer == nullptr) {
         return;
     }
 
-    VideoCore::g_renderer->Rasterizer()->ClearAll(flush);
+    GPU::Synchronize();
+    VideoCore::g_renderer->Rasterizer()->SuspendCaches(flush);
+}
+
+void RasterizerResumeCaches() {
+    if (VideoCore::g_renderer == nullptr) {
+        return;
+    }
+
+    GPU::Synchronize();
+    VideoCore::g_renderer->Rasterizer()->ResumeCaches();
 }
 
 void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
@@ -811,6 +1009,8 @@ void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
         return;
     }
 
+    GPU::Synchronize();
+
     VAddr end = start + size;
 
     auto CheckRegion = [&](VAddr region_start, VAddr region_end, PAddr paddr_region_start) {
@@ -872,6 +1072,51 @@ void MemorySystem::ReadBlock(VAddr src_addr, void* dest_buffer, std::size_t size
     return impl->ReadBlockImpl<false>(process, src_addr, dest_buffer, size);
 }
 
+HostSpans MemorySystem::GetHostSpans(const Kernel::Process& process, const VAddr vaddr,
+                                     const std::size_t size, FlushMode mode) {
+    auto& page_table = *process.vm_manager.page_table;
+    HostSpans spans;
+    bool rasterizer_cached = false;
+
+    std::size_t remaining_size = size;
+    std::size_t page_index = vaddr >> CITRA_PAGE_BITS;
+    std::size_t page_offset = vaddr & CITRA_PAGE_MASK;
+
+    while (remaining_size > 0) {
+        const std::size_t length = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
+        const VAddr current_vaddr =
+            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
+
+        u8* pointer;
+        switch (page_table.attributes[page_index]) {
+        case PageType::Memory:
+            pointer = page_table.pointers[page_index] + page_offset;
+            break;
+        case PageType::RasterizerCachedMemory:
+            pointer = impl->GetPointerForRasterizerCache(current_vaddr).GetPtr();
+            rasterizer_cached = true;
+            break;
+        default:
+            return {};
+        }
+
+        if (!spans.empty() && spans.back().data() + spans.back().size() == pointer) {
+            spans.back() = {spans.back().data(), spans.back().size() + length};
+        } else {
+            spans.emplace_back(pointer, length);
+        }
+
+        page_index++;
+        page_offset = 0;
+        remaining_size -= length;
+    }
+
+    if (rasterizer_cached) {
+        RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(size), mode);
+    }
+    return spans;
+}
+
 void MemorySystem::Write8(const VAddr addr, const u8 data) {
     Write<u8>(addr, data);
 }
@@ -1067,18 +1312,18 @@ void WriteMMIO<u64>(MMIORegionPointer mmio_handler, VAddr addr, const u64 data)
 }
 
 u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+    ASSERT(pointer >= impl->fcram && pointer <= impl->fcram + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram);
 }
 
 u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
@@ -1086,6 +1331,14 @@ MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
     return MemoryRef(impl->fcram_mem, offset);
 }
 
+std::size_t MemorySystem::GetSavedFCRAMSize() const {
+    return Settings::values.is_new_3ds.GetValue() ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE;
+}
+
+void MemorySystem::SetSerializeFCRAM(bool serialize) {
+    impl->serialize_fcram = serialize;
+}
+
 void MemorySystem::SetDSP(AudioCore::DspInterface& dsp) {
     impl->dsp = &dsp;
 }
@@ -3,17 +3,26 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <memory>
+#include <span>
 #include <string>
+#include <boost/container/small_vector.hpp>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "common/memory_ref.h"
 #include "core/mmio.h"
 
 class ARM_Interface;
 
+namespace Common {
+class VirtualArena;
+}
+
 namespace Kernel {
 class Process;
 }
@@ -75,13 +84,26 @@ struct PageTable {
     // The reason for this rigmarole is to keep the 'raw' and 'refs' arrays in sync.
     // We need 'raw' for dynarmic and 'refs' for serialization
     struct Pointers {
+        /// Each block of 'refs' covers 4 MiB of the address space
+        static constexpr std::size_t REFS_BLOCK_BITS = 10;
+        static constexpr std::size_t REFS_BLOCK_SIZE = std::size_t{1} << REFS_BLOCK_BITS;
+        static constexpr std::size_t REFS_NUM_BLOCKS = PAGE_TABLE_NUM_ENTRIES / REFS_BLOCK_SIZE;
+        using RefsBlock = std::array<MemoryRef, REFS_BLOCK_SIZE>;
 
         struct Entry {
             Entry(Pointers& pointers_, VAddr idx_) : pointers(pointers_), idx(idx_) {}
 
             Entry& operator=(MemoryRef value) {
                 pointers.raw[idx] = value.GetPtr();
-                pointers.refs[idx] = std::move(value);
+                auto& block = pointers.refs[idx >> REFS_BLOCK_BITS];
+                if (!block) {
+                    // Unmapping a page of a block that was never mapped needs no storage
+                    if (!value) {
+                        return *this;
+                    }
+                    block = std::make_unique<RefsBlock>();
+                }
+                (*block)[idx & (REFS_BLOCK_SIZE - 1)] = std::move(value);
                 return *this;
             }
 
@@ -100,7 +122,9 @@ struct PageTable {
 
     private:
         std::array<u8*, PAGE_TABLE_NUM_ENTRIES> raw;
-        std::array<MemoryRef, PAGE_TABLE_NUM_ENTRIES> refs;
+        /// Only the blocks of the address space that were ever mapped are allocated, since a
+        /// process maps a small part of it and a MemoryRef is several times larger than 'raw'
+        std::array<std::unique_ptr<RefsBlock>, REFS_NUM_BLOCKS> refs;
         friend struct PageTable;
     };
 
@@ -122,17 +146,70 @@ struct PageTable {
         return pointers.raw;
     }
 
+    const std::array<u8*, PAGE_TABLE_NUM_ENTRIES>& GetPointerArray() const {
+        return pointers.raw;
+    }
+
+    /**
+     * Host mirror of the whole address space for the JIT. Only pages of type `Memory` are
+     * accessible in it, accesses to any other page fault. Set up by MemorySystem when the page
+     * table is registered, null if fastmem is unavailable.
+     */
+    std::shared_ptr<Common::VirtualArena> fastmem_arena;
+
+    /// Returns the base of the fastmem arena, or nullptr if there is none.
+    u8* GetFastmemPointer() const;
+
     void Clear();
 
 private:
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int) {
-        ar& pointers.refs;
+    void serialize(Archive& ar, const unsigned int file_version) {
+        if (file_version == 0) {
+            // Older states store a reference for every page
+            auto refs = std::make_unique<std::array<MemoryRef, PAGE_TABLE_NUM_ENTRIES>>();
+            ar&* refs;
+            for (auto& block : pointers.refs) {
+                block.reset();
+            }
+            for (std::size_t i = 0; i < PAGE_TABLE_NUM_ENTRIES; i++) {
+                pointers[i] = std::move((*refs)[i]);
+            }
+        } else {
+            u32 num_blocks = 0;
+            if (Archive::is_saving::value) {
+                num_blocks = static_cast<u32>(
+                    std::count_if(pointers.refs.begin(), pointers.refs.end(),
+                                  [](const auto& block) { return block != nullptr; }));
+            }
+            ar& num_blocks;
+            if (Archive::is_loading::value) {
+                pointers.raw.fill(nullptr);
+                for (auto& block : pointers.refs) {
+                    block.reset();
+                }
+                for (u32 i = 0; i < num_blocks; i++) {
+                    u32 index;
+                    ar& index;
+                    auto& block = pointers.refs.at(index);
+                    block = std::make_unique<Pointers::RefsBlock>();
+                    ar&* block;
+                    for (std::size_t j = 0; j < Pointers::REFS_BLOCK_SIZE; j++) {
+                        pointers.raw[(index << Pointers::REFS_BLOCK_BITS) + j] =
+                            (*block)[j].GetPtr();
+                    }
+                }
+            } else {
+                for (u32 index = 0; index < Pointers::REFS_NUM_BLOCKS; index++) {
+                    if (pointers.refs[index]) {
+                        ar& index;
+                        ar&* pointers.refs[index];
+                    }
+                }
+            }
+        }
         ar& special_regions;
         ar& attributes;
-        for (std::size_t i = 0; i < PAGE_TABLE_NUM_ENTRIES; i++) {
-            pointers.raw[i] = pointers.refs[i].GetPtr();
-        }
     }
     friend class boost::serialization::access;
 };
@@ -273,11 +350,20 @@ enum class FlushMode {
     FlushAndInvalidate,
 };
 
+/// Host memory backing a range of guest memory, in guest address order
+using HostSpans = boost::container::small_vector<std::span<u8>, 4>;
+
+/**
+ * Detaches the rasterizer cache from guest memory before a state is saved or loaded.
+ * If flush is true, the rasterizer should flush any cached resources to RAM first.
+ */
+void RasterizerSuspendCaches(bool flush);
+
 /**
- * Flushes and invalidates all memory in the rasterizer cache and removes any leftover state
- * If flush is true, the rasterizer should flush any cached resources to RAM before clearing
+ * Reattaches the rasterizer cache once the state is saved or loaded, cached resources whose guest
+ * memory changed are evicted.
  */
-void RasterizerClearAll(bool flush);
+void RasterizerResumeCaches();
 
 /**
  * Flushes and invalidates any externally cached rasterizer resources touching the given virtual
@@ -535,6 +621,23 @@ public:
      */
     void WriteBlock(VAddr dest_addr, const void* src_buffer, std::size_t size);
 
+    /**
+     * Gets the host memory backing a range of a given process' address space, so that it can be
+     * read or written in place instead of copying it through ReadBlock or WriteBlock.
+     *
+     * @param process The process to get the memory of.
+     * @param vaddr   The virtual address the range starts at.
+     * @param size    The size of the range, in bytes.
+     * @param mode    How rasterizer cached memory in the range is prepared. Use Flush to only read
+     *                the memory, and FlushAndInvalidate if it is going to be written.
+     *
+     * @returns The host spans covering the range, where pages with contiguous backing share one
+     *          span. The list is empty if any page of the range is unmapped or MMIO, callers
+     *          should then fall back to ReadBlock or WriteBlock.
+     */
+    HostSpans GetHostSpans(const Kernel::Process& process, VAddr vaddr, std::size_t size,
+                           FlushMode mode);
+
     /**
      * Zeros a range of bytes within the current process' address space at the specified
      * virtual address.
@@ -575,6 +678,12 @@ public:
      */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
+    /**
+     * Applies the marks made on the GPU thread, in order. Called on the emulation thread once
+     * GPU work completes, see GPU::Synchronize.
+     */
+    void ApplyDeferredRasterizerMarks();
+
     /// Gets a pointer to the memory region beginning at the specified physical address.
     u8* GetPhysicalPointer(PAddr address);
 
@@ -599,6 +708,15 @@ public:
     /// Gets a serializable ref to FCRAM with the given offset
     MemoryRef GetFCRAMRef(std::size_t offset) const;
 
+    /// Returns the size of the part of FCRAM held by savestates, which depends on the model
+    std::size_t GetSavedFCRAMSize() const;
+
+    /**
+     * Sets whether serializing the memory system includes FCRAM. Delta savestates leave it out
+     * and store the pages that changed since their base state on their own.
+     */
+    void SetSerializeFCRAM(bool serialize);
+
     /// Registers page table for rasterizer cache marking
     void RegisterPageTable(std::shared_ptr<PageTable> page_table);
 
@@ -641,6 +759,7 @@ public:
 
 } // namespace Memory
 
+BOOST_CLASS_VERSION(Memory::PageTable, 1)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::FCRAM>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::VRAM>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::DSP>)
@@ -9,6 +9,7 @@
 #include <numeric>
 #include <sstream>
 #include <thread>
+#include <utility>
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
@@ -27,6 +28,55 @@ constexpr std::size_t IgnoreFrames = 5;
 
 namespace Core {
 
+namespace {
+/// Innermost subsystem timer running on this thread
+thread_local PerfStats::SubsystemTimer* current_subsystem_timer = nullptr;
+} // Anonymous namespace
+
+const char* PerfStats::GetSubsystemName(Subsystem subsystem) {
+    switch (subsystem) {
+    case Subsystem::CPU:
+        return "cpu";
+    case Subsystem::HLE:
+        return "hle";
+    case Subsystem::GPU:
+        return "gpu";
+    case Subsystem::Rasterizer:
+        return "rasterizer";
+    case Subsystem::ShaderCompile:
+        return "shader_compile";
+    case Subsystem::Audio:
+        return "audio";
+    case Subsystem::FrameLimiter:
+        return "frame_limiter";
+    default:
+        return "unknown";
+    }
+}
+
+PerfStats::SubsystemTimer::SubsystemTimer(PerfStats* perf_stats, Subsystem subsystem)
+    : perf_stats(perf_stats), subsystem(subsystem) {
+    if (!perf_stats) {
+        return;
+    }
+    parent = std::exchange(current_subsystem_timer, this);
+    start = Clock::now();
+}
+
+PerfStats::SubsystemTimer::~SubsystemTimer() {
+    if (!perf_stats) {
+        return;
+    }
+    const auto elapsed = Clock::now() - start;
+    current_subsystem_timer = parent;
+    if (parent) {
+        parent->nested += elapsed;
+    }
+    perf_stats->subsystem_ns[static_cast<std::size_t>(subsystem)].fetch_add(
+        duration_cast<std::chrono::nanoseconds>(elapsed - nested).count(),
+        std::memory_order_relaxed);
+}
+
 PerfStats::PerfStats(u64 title_id) : title_id(title_id) {}
 
 PerfStats::~PerfStats() {
@@ -44,6 +94,9 @@ PerfStats::~PerfStats() {
         fmt::format("{}/{:%F-%H-%M}_{:016X}.csv", path, *std::localtime(&t), title_id);
     FileUtil::IOFile file(filename, "w");
     file.WriteString(stream.str());
+
+    DumpCallStats(fmt::format("{}/{:%F-%H-%M}_{:016X}_hle.csv", path, *std::localtime(&t),
+                              title_id));
 }
 
 void PerfStats::BeginSystemFrame() {
@@ -63,7 +116,9 @@ void PerfStats::EndSystemFrame() {
     }
     accumulated_frametime += frame_time;
     system_frames += 1;
+    total_system_frames += 1;
 
+    previous_frame_time = frame_time;
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
 }
@@ -74,6 +129,27 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
+void PerfStats::RecordPresentLatency(Clock::duration latency) {
+    std::lock_guard lock{object_mutex};
+
+    accumulated_present_latency += latency;
+    present_latency_samples += 1;
+}
+
+void PerfStats::RecordInputLatency(Clock::duration latency) {
+    std::lock_guard lock{object_mutex};
+
+    accumulated_input_latency += latency;
+    input_latency_samples += 1;
+}
+
+void PerfStats::RecordGpuTime(std::chrono::nanoseconds gpu_time) {
+    std::lock_guard lock{object_mutex};
+
+    accumulated_gpu_time += gpu_time;
+    gpu_time_samples += 1;
+}
+
 double PerfStats::GetMeanFrametime() const {
     std::lock_guard lock{object_mutex};
 
@@ -86,6 +162,18 @@ double PerfStats::GetMeanFrametime() const {
     return sum / static_cast<double>(current_index - IgnoreFrames);
 }
 
+u64 PerfStats::GetNumSystemFrames() const {
+    std::lock_guard lock{object_mutex};
+
+    return total_system_frames;
+}
+
+double PerfStats::GetLastFrametime() const {
+    std::lock_guard lock{object_mutex};
+
+    return std::chrono::duration<double, std::milli>(previous_frame_time).count();
+}
+
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
     std::lock_guard lock(object_mutex);
 
@@ -101,6 +189,25 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     results.frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
+    results.present_latency =
+        present_latency_samples == 0
+            ? 0.0
+            : duration_cast<DoubleSecs>(accumulated_present_latency).count() /
+                  static_cast<double>(present_latency_samples);
+    results.input_latency =
+        input_latency_samples == 0
+            ? 0.0
+            : duration_cast<DoubleSecs>(accumulated_input_latency).count() /
+                  static_cast<double>(input_latency_samples);
+    results.gpu_time = gpu_time_samples == 0
+                           ? 0.0
+                           : duration_cast<DoubleSecs>(accumulated_gpu_time).count() /
+                                 static_cast<double>(gpu_time_samples);
+    for (std::size_t i = 0; i < NumSubsystems; ++i) {
+        const u64 ns = subsystem_ns[i].exchange(0, std::memory_order_relaxed);
+        results.subsystem_time[i] =
+            system_frames == 0 ? 0.0 : ns / 1'000'000'000.0 / static_cast<double>(system_frames);
+    }
 
     // Reset counters
     reset_point = now;
@@ -108,6 +215,12 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    accumulated_present_latency = Clock::duration::zero();
+    present_latency_samples = 0;
+    accumulated_input_latency = Clock::duration::zero();
+    input_latency_samples = 0;
+    accumulated_gpu_time = std::chrono::nanoseconds::zero();
+    gpu_time_samples = 0;
 
     return results;
 }
@@ -119,6 +232,92 @@ double PerfStats::GetLastFrameTimeScale() const {
     return duration_cast<DoubleSecs>(previous_frame_length).count() / FRAME_LENGTH;
 }
 
+double PerfStats::GetLastFrameLoad() const {
+    std::lock_guard lock{object_mutex};
+
+    const u16 frame_limit = Settings::values.frame_limit.GetValue();
+    return duration_cast<DoubleSecs>(previous_frame_time).count() * GPU::SCREEN_REFRESH_RATE *
+           frame_limit / 100.0;
+}
+
+void PerfStats::RecordSVCCall(u32 svc_id, const char* name, Clock::duration host_time) {
+    SVCCounters& counters = svc_counters[svc_id & 0xFF];
+    counters.name.store(name, std::memory_order_relaxed);
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.host_ns.fetch_add(duration_cast<std::chrono::nanoseconds>(host_time).count(),
+                               std::memory_order_relaxed);
+}
+
+void PerfStats::RecordServiceCall(std::string_view service_name, u32 header,
+                                  const char* function_name, Clock::duration host_time) {
+    const u64 key = std::hash<std::string_view>{}(service_name) ^
+                    (static_cast<u64>(header) * 0x9E3779B97F4A7C15ULL);
+    const u64 host_ns = duration_cast<std::chrono::nanoseconds>(host_time).count();
+
+    std::lock_guard lock{service_counters_mutex};
+    auto [it, inserted] = service_counters.try_emplace(key);
+    ServiceCounters& counters = it->second;
+    if (inserted) {
+        counters.name = fmt::format("{}::{}", service_name, function_name);
+        counters.header = header;
+    }
+    counters.calls++;
+    counters.host_ns += host_ns;
+}
+
+std::vector<PerfStats::CallStats> PerfStats::GetSVCCallStats() const {
+    std::vector<CallStats> stats;
+    for (u32 id = 0; id < svc_counters.size(); ++id) {
+        const SVCCounters& counters = svc_counters[id];
+        const u64 calls = counters.calls.load(std::memory_order_relaxed);
+        if (calls == 0) {
+            continue;
+        }
+        const char* name = counters.name.load(std::memory_order_relaxed);
+        stats.push_back(CallStats{name ? name : "Unknown", id, calls,
+                                  counters.host_ns.load(std::memory_order_relaxed)});
+    }
+    return stats;
+}
+
+std::vector<PerfStats::CallStats> PerfStats::GetServiceCallStats() const {
+    std::vector<CallStats> stats;
+    {
+        std::lock_guard lock{service_counters_mutex};
+        stats.reserve(service_counters.size());
+        for (const auto& [key, counters] : service_counters) {
+            stats.push_back(
+                CallStats{counters.name, counters.header, counters.calls, counters.host_ns});
+        }
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const CallStats& a, const CallStats& b) { return a.host_ns > b.host_ns; });
+    return stats;
+}
+
+bool PerfStats::DumpCallStats(const std::string& path) const {
+    const auto svc_stats = GetSVCCallStats();
+    const auto service_stats = GetServiceCallStats();
+    if (svc_stats.empty() && service_stats.empty()) {
+        return false;
+    }
+
+    std::string csv = "type,name,id,calls,host_ns,mean_ns\n";
+    const auto append = [&csv](std::string_view type, const CallStats& stats) {
+        csv += fmt::format("{},{},{:#010x},{},{},{}\n", type, stats.name, stats.id, stats.calls,
+                           stats.host_ns, stats.host_ns / stats.calls);
+    };
+    for (const CallStats& stats : svc_stats) {
+        append("svc", stats);
+    }
+    for (const CallStats& stats : service_stats) {
+        append("service", stats);
+    }
+
+    FileUtil::IOFile file(path, "w");
+    return file.IsOpen() && file.WriteString(csv) == csv.size();
+}
+
 void FrameLimiter::WaitOnce() {
     if (frame_advancing_enabled) {
         // Frame advancing is enabled: wait on event instead of doing framelimiting
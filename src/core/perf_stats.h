@@ -9,6 +9,10 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include "common/common_types.h"
 #include "common/thread.h"
 
@@ -25,6 +29,44 @@ public:
 
     using Clock = std::chrono::high_resolution_clock;
 
+    /// Host components whose walltime is accounted separately
+    enum class Subsystem : u32 {
+        CPU,           ///< Guest code running in the JIT or the interpreter
+        HLE,           ///< SVCs and HLE service commands
+        GPU,           ///< PICA command list processing
+        Rasterizer,    ///< Draw submission to the host graphics API
+        ShaderCompile, ///< Waits for host shaders and pipelines to be built
+        Audio,         ///< DSP frame generation and LLE DSP slices
+        FrameLimiter,  ///< Sleeping to hold the emulation at the target speed
+        Count,
+    };
+    static constexpr std::size_t NumSubsystems = static_cast<std::size_t>(Subsystem::Count);
+
+    /// Returns the identifier of a subsystem used in reports, e.g. "shader_compile"
+    static const char* GetSubsystemName(Subsystem subsystem);
+
+    /**
+     * Accounts the walltime of its scope to a subsystem. The time of timers nested on the same
+     * thread is only accounted to the innermost one, so an SVC is not also counted as CPU time.
+     * Does nothing when constructed with a null PerfStats.
+     */
+    class SubsystemTimer {
+    public:
+        SubsystemTimer(PerfStats* perf_stats, Subsystem subsystem);
+        ~SubsystemTimer();
+
+        SubsystemTimer(const SubsystemTimer&) = delete;
+        SubsystemTimer& operator=(const SubsystemTimer&) = delete;
+
+    private:
+        PerfStats* perf_stats;
+        Subsystem subsystem;
+        SubsystemTimer* parent = nullptr;
+        Clock::time_point start;
+        /// Walltime of the nested timers that ended
+        Clock::duration nested = Clock::duration::zero();
+    };
+
     struct Results {
         /// System FPS (LCD VBlanks) in Hz
         double system_fps;
@@ -34,12 +76,34 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Walltime between queueing a frame for presentation and presenting it, in seconds
+        double present_latency;
+        /// GPU time per measured frame, in seconds, zero when GPU timing is off
+        double gpu_time;
+        /// Audio queued between the DSP and the audio sink, in seconds
+        double audio_latency;
+        /// Latency of the audio output device, in seconds, zero when the sink cannot report it
+        double audio_device_latency;
+        /// Walltime between sampling the host input and the start of the frame reading it, in
+        /// seconds
+        double input_latency;
+        /// Walltime per system frame spent in each subsystem, in seconds
+        std::array<double, NumSubsystems> subsystem_time;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /// Accounts the presentation latency of the frame that was presented last.
+    void RecordPresentLatency(Clock::duration latency);
+
+    /// Accounts the age of the input sample the guest reads in the frame that starts now.
+    void RecordInputLatency(Clock::duration latency);
+
+    /// Accounts the GPU time the renderer measured for a past frame.
+    void RecordGpuTime(std::chrono::nanoseconds gpu_time);
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     /**
@@ -47,13 +111,65 @@ public:
      */
     double GetMeanFrametime() const;
 
+    /// Returns the number of system frames since the start of emulation, it is never reset.
+    u64 GetNumSystemFrames() const;
+
+    /// Returns the walltime of the previous system frame excluding frame limiting, in milliseconds.
+    double GetLastFrametime() const;
+
     /**
      * Gets the ratio between walltime and the emulated time of the previous system frame. This is
      * useful for scaling inputs or outputs moving between the two time domains.
      */
     double GetLastFrameTimeScale() const;
 
+    /**
+     * Returns the walltime of the previous system frame excluding frame limiting, over the time it
+     * may take at the speed limit. Zero when the speed is unlimited.
+     */
+    double GetLastFrameLoad() const;
+
+    /// Number of calls and cumulative host time of an SVC or an HLE service command
+    struct CallStats {
+        /// SVC name, or service and command name
+        std::string name;
+        /// SVC id, or command header
+        u32 id;
+        u64 calls;
+        u64 host_ns;
+    };
+
+    /// Accounts a call of the SVC with the given id. This is lock free, as every SVC records one.
+    void RecordSVCCall(u32 svc_id, const char* name, Clock::duration host_time);
+
+    /// Accounts a call of the HLE service command with the given header.
+    void RecordServiceCall(std::string_view service_name, u32 header, const char* function_name,
+                           Clock::duration host_time);
+
+    /// Returns the statistics of the SVCs that were called since the start of emulation.
+    std::vector<CallStats> GetSVCCallStats() const;
+
+    /// Returns the statistics of the service commands that were called since the start of
+    /// emulation.
+    std::vector<CallStats> GetServiceCallStats() const;
+
+    /// Writes the SVC and service command statistics to a CSV file. Returns false on failure.
+    bool DumpCallStats(const std::string& path) const;
+
 private:
+    struct SVCCounters {
+        std::atomic<const char*> name{};
+        std::atomic<u64> calls{};
+        std::atomic<u64> host_ns{};
+    };
+
+    struct ServiceCounters {
+        std::string name;
+        u32 header;
+        u64 calls;
+        u64 host_ns;
+    };
+
     mutable std::mutex object_mutex;
 
     /// Title ID for the game that is running. 0 if there is no game running yet
@@ -73,8 +189,22 @@ private:
     Clock::duration accumulated_frametime = Clock::duration::zero();
     /// Cumulative number of system frames (LCD VBlanks) presented since last reset
     u32 system_frames = 0;
+    /// Number of system frames presented since the start of emulation
+    u64 total_system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Cumulative presentation latency of the frames recorded since last reset
+    Clock::duration accumulated_present_latency = Clock::duration::zero();
+    /// Cumulative number of presentation latencies recorded since last reset
+    u32 present_latency_samples = 0;
+    /// Cumulative input sample age of the frames recorded since last reset
+    Clock::duration accumulated_input_latency = Clock::duration::zero();
+    /// Cumulative number of input sample ages recorded since last reset
+    u32 input_latency_samples = 0;
+    /// Cumulative GPU time of the frames measured since last reset
+    std::chrono::nanoseconds accumulated_gpu_time = std::chrono::nanoseconds::zero();
+    /// Cumulative number of GPU frame times recorded since last reset
+    u32 gpu_time_samples = 0;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
@@ -82,6 +212,18 @@ private:
     Clock::time_point frame_begin = reset_point;
     /// Total visible duration (including frame-limiting, etc.) of the previous system frame
     Clock::duration previous_frame_length = Clock::duration::zero();
+    /// Duration of the previous system frame without the waits of frame limiting
+    Clock::duration previous_frame_time = Clock::duration::zero();
+
+    /// Cumulative walltime of each subsystem since last reset, in nanoseconds
+    std::array<std::atomic<u64>, NumSubsystems> subsystem_ns{};
+
+    /// Per SVC id call counters
+    std::array<SVCCounters, 0x100> svc_counters{};
+
+    mutable std::mutex service_counters_mutex;
+    /// Service command call counters, keyed by a hash of the service name and command header
+    std::unordered_map<u64, ServiceCounters> service_counters;
 };
 
 class FrameLimiter {
@@ -0,0 +1,102 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/assert.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
+#include "core/rewind_buffer.h"
+#include "core/savestate.h"
+
+namespace Core {
+
+/// Favour speed, states are compressed twice a second or so
+constexpr s32 RewindCompressionLevel = 1;
+
+static std::string Decompress(const std::vector<u8>& compressed) {
+    const std::vector<u8> data = Common::Compression::DecompressDataZSTD(compressed);
+    return std::string{reinterpret_cast<const char*>(data.data()), data.size()};
+}
+
+RewindBuffer::RewindBuffer(std::size_t max_states_, std::size_t max_bytes_)
+    : max_states{std::max<std::size_t>(max_states_, 1)}, max_bytes{max_bytes_},
+      max_deltas_per_keyframe{std::max<std::size_t>(max_states / 4, 1)},
+      worker{std::make_unique<Common::ThreadWorker>(1, "Rewind")} {}
+
+RewindBuffer::~RewindBuffer() = default;
+
+const std::vector<u64>* RewindBuffer::GetDeltaBase() const {
+    return force_keyframe ? nullptr : &keyframe_page_hashes;
+}
+
+void RewindBuffer::Push(SerializedState&& state) {
+    const bool is_keyframe = force_keyframe;
+    if (is_keyframe) {
+        keyframe_page_hashes = std::move(state.page_hashes);
+        num_deltas = 0;
+        force_keyframe = false;
+    } else {
+        // Deltas that store many pages are nearly as large as a keyframe
+        force_keyframe = ++num_deltas >= max_deltas_per_keyframe ||
+                         state.num_dirty_pages > keyframe_page_hashes.size() / 4;
+    }
+
+    worker->QueueWork([this, is_keyframe, data = std::move(state.data)] {
+        Append(Entry{is_keyframe,
+                     Common::Compression::CompressDataZSTD(reinterpret_cast<const u8*>(data.data()),
+                                                           data.size(), RewindCompressionLevel)});
+    });
+}
+
+void RewindBuffer::Append(Entry&& entry) {
+    std::scoped_lock lock{mutex};
+    size += entry.compressed.size();
+    entries.push_back(std::move(entry));
+
+    // Drop the oldest keyframe with its deltas, but always keep the newest keyframe
+    while (entries.size() > max_states || size > max_bytes) {
+        const auto next_keyframe = std::find_if(entries.begin() + 1, entries.end(),
+                                                [](const Entry& e) { return e.is_keyframe; });
+        if (next_keyframe == entries.end()) {
+            break;
+        }
+        for (auto it = entries.begin(); it != next_keyframe; ++it) {
+            size -= it->compressed.size();
+        }
+        entries.erase(entries.begin(), next_keyframe);
+    }
+}
+
+std::optional<RewindBuffer::Snapshot> RewindBuffer::PopNewest() {
+    worker->WaitForRequests();
+
+    std::scoped_lock lock{mutex};
+    if (entries.empty()) {
+        return std::nullopt;
+    }
+    const Entry newest = std::move(entries.back());
+    entries.pop_back();
+    size -= newest.compressed.size();
+
+    if (newest.is_keyframe) {
+        // Nothing is left that the next state could be a delta against
+        force_keyframe = true;
+        return Snapshot{Decompress(newest.compressed), std::nullopt};
+    }
+
+    const auto keyframe = std::find_if(entries.rbegin(), entries.rend(),
+                                       [](const Entry& e) { return e.is_keyframe; });
+    ASSERT_MSG(keyframe != entries.rend(), "Rewind delta without a keyframe");
+    if (num_deltas > 0) {
+        num_deltas--;
+    }
+    return Snapshot{Decompress(keyframe->compressed), Decompress(newest.compressed)};
+}
+
+std::size_t RewindBuffer::GetSize() const {
+    std::scoped_lock lock{mutex};
+    return size;
+}
+
+} // namespace Core
@@ -0,0 +1,79 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+template <class StateType>
+class StatefulThreadWorker;
+}
+
+namespace Core {
+
+struct SerializedState;
+
+/**
+ * Ring of recent states of the emulated system kept in host memory. Keyframes are full states and
+ * the other states only store the FCRAM pages that changed since the latest keyframe. States are
+ * compressed on a worker thread, and the oldest keyframe is dropped along with its deltas once the
+ * ring holds too many states or too much memory.
+ */
+class RewindBuffer {
+public:
+    /// State to restore, the delta is applied on top of the keyframe when there is one
+    struct Snapshot {
+        std::string keyframe;
+        std::optional<std::string> delta;
+    };
+
+    explicit RewindBuffer(std::size_t max_states, std::size_t max_bytes);
+    ~RewindBuffer();
+
+    /// Returns the page hashes the next state should be a delta against, or nullptr if the next
+    /// state has to be a keyframe.
+    [[nodiscard]] const std::vector<u64>* GetDeltaBase() const;
+
+    /// Queues a state from System::SerializeState for compression
+    void Push(SerializedState&& state);
+
+    /// Removes the newest state and returns it, or std::nullopt if the buffer is empty
+    [[nodiscard]] std::optional<Snapshot> PopNewest();
+
+    /// Number of compressed bytes held
+    [[nodiscard]] std::size_t GetSize() const;
+
+private:
+    struct Entry {
+        bool is_keyframe;
+        std::vector<u8> compressed;
+    };
+
+    void Append(Entry&& entry);
+
+    const std::size_t max_states;
+    const std::size_t max_bytes;
+    /// Keyframes are forced after this many deltas, so that the ring is made of several segments
+    const std::size_t max_deltas_per_keyframe;
+
+    /// FCRAM page hashes of the newest keyframe, only accessed by the emulation thread
+    std::vector<u64> keyframe_page_hashes;
+    std::size_t num_deltas = 0;
+    bool force_keyframe = true;
+
+    mutable std::mutex mutex;
+    std::deque<Entry> entries;
+    std::size_t size = 0;
+
+    std::unique_ptr<Common::StatefulThreadWorker<void>> worker;
+};
+
+} // namespace Core
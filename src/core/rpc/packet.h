@@ -14,6 +14,9 @@ enum class PacketType {
     Undefined = 0,
     ReadMemory,
     WriteMemory,
+    // Version 2
+    ReadMemoryBatch,  ///< Ranges of u32 address and u32 size, read back to back into the reply
+    WriteMemoryBatch, ///< Ranges of u32 address and u32 size, each followed by its data
 };
 
 struct PacketHeader {
@@ -23,9 +26,10 @@ struct PacketHeader {
     u32 packet_size;
 };
 
-constexpr u32 CURRENT_VERSION = 1;
+constexpr u32 CURRENT_VERSION = 2;
 constexpr u32 MIN_PACKET_SIZE = sizeof(PacketHeader);
-constexpr u32 MAX_PACKET_DATA_SIZE = 32;
+// Large enough to save round trips, small enough to not fragment the UDP datagrams
+constexpr u32 MAX_PACKET_DATA_SIZE = 1024;
 constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
 constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
 
@@ -1,10 +1,13 @@
+#include <vector>
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
+#include "core/rpc/shared_memory_server.h"
 
 namespace RPC {
 
@@ -37,23 +40,99 @@ void RPCServer::HandleReadMemory(Packet& packet, u32 address, u32 data_size) {
     packet.SendReply();
 }
 
-void RPCServer::HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size) {
+static bool IsWritableAddress(u32 address) {
     // Only allow writing to certain memory regions
-    if ((address >= Memory::PROCESS_IMAGE_VADDR && address <= Memory::PROCESS_IMAGE_VADDR_END) ||
-        (address >= Memory::HEAP_VADDR && address <= Memory::HEAP_VADDR_END) ||
-        (address >= Memory::N3DS_EXTRA_RAM_VADDR && address <= Memory::N3DS_EXTRA_RAM_VADDR_END)) {
-        // Note: Memory write occurs asynchronously from the state of the emulator
-        Core::System::GetInstance().Memory().WriteBlock(
-            *Core::System::GetInstance().Kernel().GetCurrentProcess(), address, data, data_size);
-        // If the memory happens to be executable code, make sure the changes become visible
-
-        // Is current core correct here?
-        Core::System::GetInstance().InvalidateCacheRange(address, data_size);
+    return (address >= Memory::PROCESS_IMAGE_VADDR && address <= Memory::PROCESS_IMAGE_VADDR_END) ||
+           (address >= Memory::HEAP_VADDR && address <= Memory::HEAP_VADDR_END) ||
+           (address >= Memory::N3DS_EXTRA_RAM_VADDR && address <= Memory::N3DS_EXTRA_RAM_VADDR_END);
+}
+
+static void WriteMemory(u32 address, const u8* data, u32 data_size) {
+    if (!IsWritableAddress(address)) {
+        return;
     }
+    // Note: Memory write occurs asynchronously from the state of the emulator
+    Core::System::GetInstance().Memory().WriteBlock(
+        *Core::System::GetInstance().Kernel().GetCurrentProcess(), address, data, data_size);
+    // If the memory happens to be executable code, make sure the changes become visible
+
+    // Is current core correct here?
+    Core::System::GetInstance().InvalidateCacheRange(address, data_size);
+}
+
+void RPCServer::HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size) {
+    WriteMemory(address, data, data_size);
     packet.SetPacketDataSize(0);
     packet.SendReply();
 }
 
+bool RPCServer::HandleReadMemoryBatch(Packet& packet) {
+    constexpr u32 range_size = sizeof(u32) * 2;
+    const u32 request_size = packet.GetPacketDataSize();
+    if (request_size % range_size != 0) {
+        return false;
+    }
+
+    // The ranges are overwritten by the reply, so they are parsed first
+    struct Range {
+        u32 address;
+        u32 size;
+    };
+    std::vector<Range> ranges(request_size / range_size);
+    std::memcpy(ranges.data(), packet.GetPacketData().data(), request_size);
+    u32 reply_size = 0;
+    for (const auto& range : ranges) {
+        if (range.size > MAX_READ_SIZE - reply_size) {
+            return false;
+        }
+        reply_size += range.size;
+    }
+
+    // Note: Memory read occurs asynchronously from the state of the emulator
+    auto& memory = Core::System::GetInstance().Memory();
+    const auto& process = *Core::System::GetInstance().Kernel().GetCurrentProcess();
+    u8* reply_data = packet.GetPacketData().data();
+    for (const auto& range : ranges) {
+        memory.ReadBlock(process, range.address, reply_data, range.size);
+        reply_data += range.size;
+    }
+    packet.SetPacketDataSize(reply_size);
+    packet.SendReply();
+    return true;
+}
+
+bool RPCServer::HandleWriteMemoryBatch(Packet& packet) {
+    const u8* data = packet.GetPacketData().data();
+    const u8* const end = data + packet.GetPacketDataSize();
+
+    // The whole batch is checked before anything is written
+    for (const u8* range = data; range != end;) {
+        u32 size;
+        if (end - range < static_cast<std::ptrdiff_t>(sizeof(u32) * 2)) {
+            return false;
+        }
+        std::memcpy(&size, range + sizeof(u32), sizeof(size));
+        range += sizeof(u32) * 2;
+        if (size > static_cast<std::size_t>(end - range)) {
+            return false;
+        }
+        range += size;
+    }
+
+    while (data != end) {
+        u32 address;
+        u32 size;
+        std::memcpy(&address, data, sizeof(address));
+        std::memcpy(&size, data + sizeof(u32), sizeof(size));
+        data += sizeof(u32) * 2;
+        WriteMemory(address, data, size);
+        data += size;
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+    return true;
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
@@ -63,6 +142,13 @@ bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
                 return true;
             }
             break;
+        case PacketType::ReadMemoryBatch:
+        case PacketType::WriteMemoryBatch:
+            if (packet_header.version >= 2 && packet_header.packet_size > 0 &&
+                packet_header.packet_size <= MAX_PACKET_DATA_SIZE) {
+                return true;
+            }
+            break;
         default:
             break;
         }
@@ -95,6 +181,12 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
                 success = true;
             }
             break;
+        case PacketType::ReadMemoryBatch:
+            success = HandleReadMemoryBatch(*request_packet);
+            break;
+        case PacketType::WriteMemoryBatch:
+            success = HandleWriteMemoryBatch(*request_packet);
+            break;
         default:
             break;
         }
@@ -121,13 +213,23 @@ void RPCServer::QueueRequest(std::unique_ptr<RPC::Packet> request) {
     request_queue.Push(std::move(request));
 }
 
+void RPCServer::OnFrame() {
+    if (shared_memory_server) {
+        shared_memory_server->OnFrame();
+    }
+}
+
 void RPCServer::Start() {
     const auto threadFunction = [this]() { HandleRequestsLoop(); };
     request_handler_thread = std::thread(threadFunction);
     server.Start();
+    if (Settings::values.rpc_shared_memory.GetValue()) {
+        shared_memory_server = std::make_unique<SharedMemoryServer>();
+    }
 }
 
 void RPCServer::Stop() {
+    shared_memory_server.reset();
     server.Stop();
     request_handler_thread.join();
 }
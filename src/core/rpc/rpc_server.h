@@ -15,6 +15,7 @@ namespace RPC {
 
 class Packet;
 struct PacketHeader;
+class SharedMemoryServer;
 
 class RPCServer {
 public:
@@ -23,11 +24,16 @@ public:
 
     void QueueRequest(std::unique_ptr<RPC::Packet> request);
 
+    /// Called by the emulation thread at the end of every emulated frame
+    void OnFrame();
+
 private:
     void Start();
     void Stop();
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size);
+    bool HandleReadMemoryBatch(Packet& packet);
+    bool HandleWriteMemoryBatch(Packet& packet);
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop();
@@ -35,6 +41,8 @@ private:
     Server server;
     Common::SPSCQueue<std::unique_ptr<Packet>> request_queue;
     std::thread request_handler_thread;
+    /// Only created when the shared memory transport is enabled
+    std::unique_ptr<SharedMemoryServer> shared_memory_server;
 };
 
 } // namespace RPC
@@ -0,0 +1,117 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#if !defined(_WIN32) && !defined(ANDROID)
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <new>
+#include "common/error.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+#include "core/rpc/shared_memory_server.h"
+
+namespace RPC {
+
+#if defined(_WIN32) || defined(ANDROID)
+
+SharedMemoryServer::SharedMemoryServer() {
+    LOG_WARNING(RPC_Server, "Shared memory is not supported on this platform");
+}
+
+SharedMemoryServer::~SharedMemoryServer() = default;
+
+void SharedMemoryServer::OnFrame() {}
+
+#else
+
+SharedMemoryServer::SharedMemoryServer() {
+    const int fd = shm_open(SharedMemoryName, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd == -1) {
+        LOG_ERROR(RPC_Server, "Failed to create shared memory: {}", GetLastErrorMsg());
+        return;
+    }
+    if (ftruncate(fd, sizeof(SharedMemoryLayout)) != 0) {
+        LOG_ERROR(RPC_Server, "Failed to resize shared memory: {}", GetLastErrorMsg());
+        close(fd);
+        shm_unlink(SharedMemoryName);
+        return;
+    }
+    void* base =
+        mmap(nullptr, sizeof(SharedMemoryLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(RPC_Server, "Failed to map shared memory: {}", GetLastErrorMsg());
+        shm_unlink(SharedMemoryName);
+        return;
+    }
+    layout = new (base) SharedMemoryLayout{};
+    layout->version = SharedMemoryVersion;
+    // Tools check the magic last, once it is set the layout is ready
+    std::atomic_thread_fence(std::memory_order_release);
+    layout->magic = SharedMemoryMagic;
+
+    // Tools that do not need to wait for frames can poll `frame` instead
+    sem_t* semaphore = sem_open(SharedMemoryFrameSemaphoreName, O_CREAT, 0600, 0);
+    if (semaphore == SEM_FAILED) {
+        LOG_WARNING(RPC_Server, "Failed to create the frame semaphore: {}", GetLastErrorMsg());
+    } else {
+        frame_semaphore = semaphore;
+    }
+    LOG_INFO(RPC_Server, "Shared memory server started at {}", SharedMemoryName);
+}
+
+SharedMemoryServer::~SharedMemoryServer() {
+    if (frame_semaphore) {
+        sem_close(static_cast<sem_t*>(frame_semaphore));
+        sem_unlink(SharedMemoryFrameSemaphoreName);
+    }
+    if (layout) {
+        munmap(layout, sizeof(SharedMemoryLayout));
+        shm_unlink(SharedMemoryName);
+    }
+}
+
+void SharedMemoryServer::OnFrame() {
+    if (!layout) {
+        return;
+    }
+
+    auto& system = Core::System::GetInstance();
+    const auto process = system.Kernel().GetCurrentProcess();
+    layout->sequence.fetch_add(1, std::memory_order_acq_rel);
+    if (process) {
+        // The ranges may be changed by the tool at any time, so every value is read once and
+        // checked before it is used
+        const u32 num_ranges = std::min(layout->num_ranges, SharedMemoryMaxRanges);
+        u32 data_size = 0;
+        for (u32 i = 0; i < num_ranges; i++) {
+            const SharedMemoryLayout::Range range = layout->ranges[i];
+            if (range.size > SharedMemoryDataSize - data_size) {
+                continue;
+            }
+            system.Memory().ReadBlock(*process, range.address, layout->data.data() + data_size,
+                                      range.size);
+            data_size += range.size;
+        }
+        layout->data_size = data_size;
+    }
+    layout->frame.fetch_add(1, std::memory_order_relaxed);
+    layout->sequence.fetch_add(1, std::memory_order_release);
+
+    if (frame_semaphore) {
+        sem_post(static_cast<sem_t*>(frame_semaphore));
+    }
+}
+
+#endif
+
+} // namespace RPC
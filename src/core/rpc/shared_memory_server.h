@@ -0,0 +1,73 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include "common/common_types.h"
+
+namespace RPC {
+
+/// Name of the POSIX shared memory object tools open to observe the emulated memory
+constexpr char SharedMemoryName[] = "/citra_rpc";
+/// Name of the POSIX semaphore that is posted once per emulated frame
+constexpr char SharedMemoryFrameSemaphoreName[] = "/citra_rpc_frame";
+
+constexpr u32 SharedMemoryMagic = 0x43505243; // "CRPC"
+constexpr u32 SharedMemoryVersion = 1;
+constexpr u32 SharedMemoryMaxRanges = 256;
+constexpr u32 SharedMemoryDataSize = 0x100000;
+
+/**
+ * Layout of the shared memory. The tool writes the ranges to watch, preferably right after a
+ * frame was posted. At the end of every frame the emulator copies them back to back into `data`,
+ * while `sequence` is odd, and then posts the frame semaphore. A copy of `data` is consistent if
+ * `sequence` was even and unchanged before and after it, like with a seqlock.
+ */
+struct SharedMemoryLayout {
+    struct Range {
+        u32 address;
+        u32 size;
+    };
+
+    u32 magic;
+    u32 version;
+    std::atomic<u32> sequence;
+    /// Number of frames emulated since the server started
+    std::atomic<u32> frame;
+
+    // Written by the tool
+    u32 num_ranges;
+    std::array<Range, SharedMemoryMaxRanges> ranges;
+
+    // Written by the emulator
+    /// Bytes copied to `data` for the last frame, ranges that do not fit are skipped
+    u32 data_size;
+    std::array<u8, SharedMemoryDataSize> data;
+};
+static_assert(std::atomic<u32>::is_always_lock_free,
+              "The shared memory needs lock free atomics to be used by another process");
+
+/**
+ * Exposes the emulated memory to tools on the same host through shared memory, without copying
+ * it over sockets. Not available on Windows and Android.
+ */
+class SharedMemoryServer {
+public:
+    SharedMemoryServer();
+    ~SharedMemoryServer();
+
+    SharedMemoryServer(const SharedMemoryServer&) = delete;
+    SharedMemoryServer& operator=(const SharedMemoryServer&) = delete;
+
+    /// Copies the watched ranges and notifies the tool, called by the emulation thread at VBlank
+    void OnFrame();
+
+private:
+    SharedMemoryLayout* layout = nullptr;
+    void* frame_semaphore = nullptr;
+};
+
+} // namespace RPC
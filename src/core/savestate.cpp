@@ -2,12 +2,26 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <utility>
 #include <boost/serialization/binary_object.hpp>
+#include <boost/serialization/vector.hpp>
 #include <cryptopp/hex.h>
 #include "common/archives.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/scope_exit.h"
+#include "common/settings.h"
+#include "common/thread_worker.h"
 #include "common/zstd_compression.h"
 #include "core/cheats/cheats.h"
 #include "core/core.h"
@@ -24,8 +38,14 @@ struct CSTHeader {
     u64_le program_id;           /// ID of the ROM being executed. Also called title_id
     std::array<u8, 20> revision; /// Git hash of the revision this savestate was created with
     u64_le time;                 /// The time when this save state was created
+    u8 is_delta;                 /// Whether only the FCRAM pages changed since the base are saved
+    u8 base_slot;                /// Slot of the full state that a delta state was made against
+    u64_le base_time;            /// The time when the base state was created
+    u8 version;                  /// Layout of the payload, 0 for a single compressed archive
+    u64_le id;                   /// Unique ID of this state, 0 in states made before it
+    u64_le base_id;              /// Unique ID of the base state
 
-    std::array<u8, 216> reserved; /// Make heading 256 bytes so it has consistent size
+    std::array<u8, 189> reserved; /// Make heading 256 bytes so it has consistent size
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -37,6 +57,31 @@ static_assert(sizeof(CSTHeader) == 256, "CSTHeader should be 256 bytes");
 
 constexpr std::array<u8, 4> header_magic_bytes{{'C', 'S', 'T', 0x1B}};
 
+/// Payload version made of independently compressed sections, see CSTSection
+constexpr u8 SectionedStateVersion = 2;
+
+enum class CSTSectionType : u32 {
+    Archive = 0,    ///< Archive of the system without FCRAM
+    FCRAMBlock = 1, ///< FCRAMBlockSize bytes of FCRAM, starting at the block index times that
+};
+
+/// Entry of the section table, which follows the header of a sectioned state. The compressed
+/// sections follow the table in the same order.
+#pragma pack(push, 1)
+struct CSTSection {
+    u32_le type;
+    u32_le index;
+    u64_le compressed_size;
+    u64_le size;
+};
+static_assert(sizeof(CSTSection) == 24, "CSTSection should be 24 bytes");
+#pragma pack(pop)
+
+/// FCRAM is split in blocks so that it is compressed in parallel, and delta states only store the
+/// blocks that changed.
+constexpr std::size_t FCRAMBlockPages = 64;
+constexpr std::size_t FCRAMBlockSize = FCRAMBlockPages * Memory::CITRA_PAGE_SIZE;
+
 std::string GetSaveStatePath(u64 program_id, u32 slot) {
     const u64 movie_id = Movie::GetInstance().GetCurrentMovieID();
     if (movie_id) {
@@ -49,6 +94,26 @@ std::string GetSaveStatePath(u64 program_id, u32 slot) {
     }
 }
 
+static bool ReadHeader(FileUtil::IOFile& file, CSTHeader& header) {
+    return file && file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+           header.filetype == header_magic_bytes;
+}
+
+static bool ReadHeader(const std::string& path, CSTHeader& header) {
+    FileUtil::IOFile file(path, "rb");
+    return ReadHeader(file, header);
+}
+
+static std::vector<u64> HashFCRAMPages(const Memory::MemorySystem& memory) {
+    std::vector<u64> hashes(memory.GetSavedFCRAMSize() / Memory::CITRA_PAGE_SIZE);
+    const u8* fcram = memory.GetFCRAMPointer(0);
+    for (std::size_t page = 0; page < hashes.size(); ++page) {
+        hashes[page] =
+            Common::ComputeHash64(fcram + page * Memory::CITRA_PAGE_SIZE, Memory::CITRA_PAGE_SIZE);
+    }
+    return hashes;
+}
+
 std::vector<SaveStateInfo> ListSaveStates(u64 program_id) {
     std::vector<SaveStateInfo> result;
     for (u32 slot = 1; slot <= SaveStateSlotCount; ++slot) {
@@ -97,41 +162,326 @@ std::vector<SaveStateInfo> ListSaveStates(u64 program_id) {
     return result;
 }
 
-void System::SaveState(u32 slot) const {
-    std::ostringstream sstream{std::ios_base::binary};
+SerializedState System::SerializeState(std::ostream& stream,
+                                       const std::vector<u64>* base_page_hashes) const {
+    // The jobs of asynchronous HLE requests are not part of the state, only their results are
+    kernel->WaitForHLEWorkers();
+    // The requests given up for the drain run again once guest memory was read
+    SCOPE_EXIT({ kernel->RetryDrainedRequests(); });
+
+    SerializedState state;
     // Serialize
-    oarchive oa{sstream};
+    oarchive oa{stream};
+    exclude_fcram_from_state = base_page_hashes != nullptr;
+    SCOPE_EXIT({ exclude_fcram_from_state = false; });
     oa&* this;
 
-    const std::string& str{sstream.str()};
-    auto buffer = Common::Compression::CompressDataZSTDDefault(
-        reinterpret_cast<const u8*>(str.data()), str.size());
+    // Hash FCRAM after serializing, as that flushes the rasterizer cache to memory
+    state.page_hashes = HashFCRAMPages(*memory);
+    if (base_page_hashes) {
+        std::vector<u32> dirty_pages;
+        for (u32 page = 0; page < state.page_hashes.size(); ++page) {
+            if (state.page_hashes[page] != (*base_page_hashes)[page]) {
+                dirty_pages.push_back(page);
+            }
+        }
+        oa& dirty_pages;
+        for (const u32 page : dirty_pages) {
+            oa& boost::serialization::make_binary_object(
+                const_cast<u8*>(memory->GetFCRAMPointer(page * Memory::CITRA_PAGE_SIZE)),
+                Memory::CITRA_PAGE_SIZE);
+        }
+        state.num_dirty_pages = dirty_pages.size();
+    }
+
+    return state;
+}
+
+SerializedState System::SerializeState(const std::vector<u64>* base_page_hashes) const {
+    std::ostringstream sstream{std::ios_base::binary};
+    SerializedState state = SerializeState(sstream, base_page_hashes);
+    state.data = std::move(sstream).str();
+    return state;
+}
+
+void System::DeserializeOnBase(iarchive& ia, bool is_delta, bool exclude_fcram) {
+    // Deserializing restarts the system, so the FCRAM of the base of a delta state is kept aside
+    // meanwhile.
+    std::vector<u8> base_fcram;
+    if (is_delta) {
+        const u8* fcram = memory->GetFCRAMPointer(0);
+        base_fcram.assign(fcram, fcram + memory->GetSavedFCRAMSize());
+    }
+    {
+        exclude_fcram_from_state = exclude_fcram;
+        SCOPE_EXIT({ exclude_fcram_from_state = false; });
+        ia&* this;
+    }
+    if (is_delta) {
+        std::memcpy(memory->GetFCRAMPointer(0), base_fcram.data(), base_fcram.size());
+    }
+}
+
+void System::DeserializeState(std::istream& stream, bool is_delta) {
+    iarchive ia{stream};
+    DeserializeOnBase(ia, is_delta, is_delta);
+
+    if (!is_delta) {
+        kernel->RetryDrainedRequests();
+        return;
+    }
+
+    std::vector<u32> dirty_pages;
+    ia& dirty_pages;
+    for (const u32 page : dirty_pages) {
+        if (page >= memory->GetSavedFCRAMSize() / Memory::CITRA_PAGE_SIZE) {
+            throw std::runtime_error("Invalid FCRAM page in state");
+        }
+        ia& boost::serialization::make_binary_object(
+            memory->GetFCRAMPointer(page * Memory::CITRA_PAGE_SIZE), Memory::CITRA_PAGE_SIZE);
+    }
+
+    // Surfaces are checked against FCRAM once its pages are restored
+    Memory::RasterizerResumeCaches();
+    kernel->RetryDrainedRequests();
+}
+
+void System::DeserializeState(std::string data, bool is_delta) {
+    std::istringstream sstream{std::move(data), std::ios_base::binary};
+    DeserializeState(sstream, is_delta);
+}
+
+/// Runs the jobs on as many threads as the host has cores
+static void RunInParallel(std::size_t num_jobs, const std::function<void(std::size_t)>& job) {
+    const u32 num_cores = Common::GetWorkerThreadCount(std::thread::hardware_concurrency());
+    const std::size_t num_threads = std::clamp<std::size_t>(num_cores, 1, num_jobs);
+    Common::ThreadWorker workers{num_threads, "SaveState"};
+    for (std::size_t i = 0; i < num_jobs; ++i) {
+        workers.QueueWork([&job, i] { job(i); });
+    }
+    workers.WaitForRequests();
+}
+
+/// Compresses the archive and the copied FCRAM blocks of a state and writes them to path
+static void WriteSectionedState(const std::string& path, const CSTHeader& header,
+                                const std::string& archive, const std::vector<u32>& blocks,
+                                const std::vector<u8>& fcram_blocks) {
+    std::vector<CSTSection> sections(blocks.size() + 1);
+    std::vector<std::vector<u8>> compressed(sections.size());
+    sections[0] = {static_cast<u32>(CSTSectionType::Archive), 0, 0, archive.size()};
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        sections[i + 1] = {static_cast<u32>(CSTSectionType::FCRAMBlock), blocks[i], 0,
+                           FCRAMBlockSize};
+    }
+    RunInParallel(sections.size(), [&](std::size_t i) {
+        const u8* data = i == 0 ? reinterpret_cast<const u8*>(archive.data())
+                                : fcram_blocks.data() + (i - 1) * FCRAMBlockSize;
+        compressed[i] = Common::Compression::CompressDataZSTDDefault(data, sections[i].size);
+        sections[i].compressed_size = compressed[i].size();
+    });
+    if (std::any_of(compressed.begin(), compressed.end(),
+                    [](const std::vector<u8>& section) { return section.empty(); })) {
+        throw std::runtime_error("Could not compress the state");
+    }
 
-    const auto path = GetSaveStatePath(title_id, slot);
     if (!FileUtil::CreateFullPath(path)) {
         throw std::runtime_error("Could not create path " + path);
     }
 
-    FileUtil::IOFile file(path, "wb");
+    // Written aside and moved in place once complete, so that a partial state is never listed
+    const std::string temp_path = path + ".tmp";
+    FileUtil::IOFile file(temp_path, "wb");
     if (!file) {
-        throw std::runtime_error("Could not open file " + path);
+        throw std::runtime_error("Could not open file " + temp_path);
+    }
+
+    const u32_le num_sections = static_cast<u32>(sections.size());
+    bool written = file.WriteBytes(&header, sizeof(header)) == sizeof(header) &&
+                   file.WriteBytes(&num_sections, sizeof(num_sections)) == sizeof(num_sections) &&
+                   file.WriteArray(sections.data(), sections.size()) == sections.size();
+    for (const std::vector<u8>& section : compressed) {
+        written = written && file.WriteBytes(section.data(), section.size()) == section.size();
+    }
+    if (!file.Close() || !written) {
+        FileUtil::Delete(temp_path);
+        throw std::runtime_error("Could not write to file " + temp_path);
+    }
+    // Renaming doesn't replace files on every platform
+    if ((FileUtil::Exists(path) && !FileUtil::Delete(path)) || !FileUtil::Rename(temp_path, path)) {
+        FileUtil::Delete(temp_path);
+        throw std::runtime_error("Could not replace file " + path);
+    }
+}
+
+void System::SaveState(u32 slot) const {
+    // The previous state may still be written, and become the base of this one
+    WaitForPendingSave();
+
+    // A delta state needs its base to stay around, so it never replaces the base itself
+    bool save_delta = false;
+    if (Settings::values.delta_savestates && delta_state_base && delta_state_base->slot != slot) {
+        CSTHeader base_header;
+        save_delta = ReadHeader(GetSaveStatePath(title_id, delta_state_base->slot), base_header) &&
+                     base_header.program_id == title_id &&
+                     base_header.time == delta_state_base->time &&
+                     base_header.id == delta_state_base->id;
+    }
+
+    // The jobs of asynchronous HLE requests are not part of the state, only their results are
+    kernel->WaitForHLEWorkers();
+    // The requests given up for the drain run again once guest memory was read
+    SCOPE_EXIT({ kernel->RetryDrainedRequests(); });
+
+    std::ostringstream sstream{std::ios_base::binary};
+    {
+        oarchive oa{sstream};
+        exclude_fcram_from_state = true;
+        SCOPE_EXIT({ exclude_fcram_from_state = false; });
+        oa&* this;
+    }
+    std::string archive = std::move(sstream).str();
+
+    // Hash FCRAM after serializing, as that flushes the rasterizer cache to memory
+    std::vector<u64> page_hashes = HashFCRAMPages(*memory);
+    std::vector<u32> blocks;
+    for (u32 block = 0; block < page_hashes.size() / FCRAMBlockPages; ++block) {
+        const auto first = page_hashes.begin() + block * FCRAMBlockPages;
+        if (!save_delta || !std::equal(first, first + FCRAMBlockPages,
+                                       delta_state_base->page_hashes.begin() +
+                                           block * FCRAMBlockPages)) {
+            blocks.push_back(block);
+        }
+    }
+
+    // Copy the FCRAM blocks to save, the emulation resumes while they are compressed
+    std::vector<u8> fcram_blocks(blocks.size() * FCRAMBlockSize);
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        std::memcpy(fcram_blocks.data() + i * FCRAMBlockSize,
+                    memory->GetFCRAMPointer(blocks[i] * FCRAMBlockSize), FCRAMBlockSize);
+    }
+    if (save_delta) {
+        LOG_INFO(Core, "Saving {} of {} FCRAM blocks on top of the state in slot {}",
+                 blocks.size(), page_hashes.size() / FCRAMBlockPages, delta_state_base->slot);
     }
 
     CSTHeader header{};
     header.filetype = header_magic_bytes;
     header.program_id = title_id;
+    header.version = SectionedStateVersion;
+    if (save_delta) {
+        header.is_delta = 1;
+        header.base_slot = static_cast<u8>(delta_state_base->slot);
+        header.base_time = delta_state_base->time;
+        header.base_id = delta_state_base->id;
+    }
     std::string rev_bytes;
     CryptoPP::StringSource(Common::g_scm_rev, true,
                            new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
     std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(header.revision));
-    header.time = std::chrono::duration_cast<std::chrono::seconds>(
-                      std::chrono::system_clock::now().time_since_epoch())
-                      .count();
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    header.time = std::chrono::duration_cast<std::chrono::seconds>(now).count();
+    // The time only has second resolution, two quick saves to a slot would look the same
+    header.id = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+
+    // Compression and writing only use the copies, so they run after the emulation resumed
+    pending_save = std::async(
+        std::launch::async,
+        [this, slot, save_delta, header, path = GetSaveStatePath(title_id, slot),
+         archive = std::move(archive), blocks = std::move(blocks),
+         fcram_blocks = std::move(fcram_blocks), page_hashes = std::move(page_hashes)]() mutable {
+            WriteSectionedState(path, header, archive, blocks, fcram_blocks);
+            if (!save_delta) {
+                delta_state_base = std::make_unique<DeltaStateBase>(
+                    DeltaStateBase{slot, header.time, header.id, std::move(page_hashes)});
+            }
+            LOG_INFO(Core, "Saved state to {}", path);
+        });
+}
+
+void System::WaitForPendingSave() const {
+    if (!pending_save.valid()) {
+        return;
+    }
+    try {
+        pending_save.get();
+    } catch (const std::exception& e) {
+        LOG_ERROR(Core, "Error saving: {}", e.what());
+        pending_save_error = e.what();
+    }
+}
+
+std::optional<std::string> System::TakePendingSaveError() const {
+    if (pending_save.valid() &&
+        pending_save.wait_for(std::chrono::seconds{0}) == std::future_status::ready) {
+        WaitForPendingSave();
+    }
+    return std::exchange(pending_save_error, std::nullopt);
+}
 
-    if (file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
-        file.WriteBytes(buffer.data(), buffer.size()) != buffer.size()) {
-        throw std::runtime_error("Could not write to file " + path);
+void System::LoadSectionedState(FileUtil::IOFile& file, bool is_delta) {
+    u32_le num_sections;
+    if (file.ReadBytes(&num_sections, sizeof(num_sections)) != sizeof(num_sections) ||
+        num_sections * sizeof(CSTSection) > file.GetSize()) {
+        throw std::runtime_error("Could not read the section table of the state");
     }
+    std::vector<CSTSection> sections(num_sections);
+    if (file.ReadArray(sections.data(), sections.size()) != sections.size()) {
+        throw std::runtime_error("Could not read the section table of the state");
+    }
+
+    std::vector<std::vector<u8>> compressed(sections.size());
+    std::optional<std::size_t> archive_section;
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        if (sections[i].compressed_size > file.GetSize()) {
+            throw std::runtime_error("Invalid section in the state");
+        }
+        compressed[i].resize(sections[i].compressed_size);
+        if (file.ReadBytes(compressed[i].data(), compressed[i].size()) != compressed[i].size()) {
+            throw std::runtime_error("Could not read a section of the state");
+        }
+        if (sections[i].type == static_cast<u32>(CSTSectionType::Archive)) {
+            archive_section = i;
+        }
+    }
+    if (!archive_section) {
+        throw std::runtime_error("The state has no archive");
+    }
+
+    std::string archive(sections[*archive_section].size, '\0');
+    if (!Common::Compression::DecompressDataZSTD(
+            compressed[*archive_section].data(), compressed[*archive_section].size(),
+            reinterpret_cast<u8*>(archive.data()), archive.size())) {
+        throw std::runtime_error("Could not decompress the archive of the state");
+    }
+    compressed[*archive_section] = {};
+
+    {
+        std::istringstream sstream{std::move(archive), std::ios_base::binary};
+        iarchive ia{sstream};
+        DeserializeOnBase(ia, is_delta, true);
+    }
+
+    const std::size_t num_blocks = memory->GetSavedFCRAMSize() / FCRAMBlockSize;
+    std::atomic<bool> failed = false;
+    RunInParallel(sections.size(), [&](std::size_t i) {
+        const CSTSection& section = sections[i];
+        if (section.type != static_cast<u32>(CSTSectionType::FCRAMBlock)) {
+            return;
+        }
+        if (section.index >= num_blocks || section.size != FCRAMBlockSize ||
+            !Common::Compression::DecompressDataZSTD(
+                compressed[i].data(), compressed[i].size(),
+                memory->GetFCRAMPointer(section.index * FCRAMBlockSize), FCRAMBlockSize)) {
+            failed = true;
+        }
+    });
+    if (failed) {
+        throw std::runtime_error("Could not decompress the FCRAM of the state");
+    }
+
+    // Surfaces are checked against FCRAM once its blocks are restored
+    Memory::RasterizerResumeCaches();
+    kernel->RetryDrainedRequests();
 }
 
 void System::LoadState(u32 slot) {
@@ -139,27 +489,47 @@ void System::LoadState(u32 slot) {
         throw std::runtime_error("Unable to load while connected to multiplayer");
     }
 
+    // The state may be the one still being written
+    WaitForPendingSave();
+
     const auto path = GetSaveStatePath(title_id, slot);
 
-    std::vector<u8> decompressed;
-    {
-        std::vector<u8> buffer(FileUtil::GetSize(path) - sizeof(CSTHeader));
+    FileUtil::IOFile file(path, "rb");
+    CSTHeader header;
+    if (!ReadHeader(file, header)) {
+        throw std::runtime_error("Could not read the header of " + path);
+    }
 
-        FileUtil::IOFile file(path, "rb");
-        file.Seek(sizeof(CSTHeader), SEEK_SET); // Skip header
-        if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
-            throw std::runtime_error("Could not read from file at " + path);
+    // Delta states are loaded on top of their base state
+    std::unique_ptr<DeltaStateBase> base;
+    if (header.is_delta) {
+        CSTHeader base_header;
+        if (!ReadHeader(GetSaveStatePath(title_id, header.base_slot), base_header) ||
+            base_header.time != header.base_time || base_header.id != header.base_id ||
+            base_header.is_delta) {
+            throw std::runtime_error(
+                fmt::format("The base state in slot {} of this state was replaced",
+                            header.base_slot));
         }
-        decompressed = Common::Compression::DecompressDataZSTD(buffer);
+        LoadState(header.base_slot);
+        base = std::move(delta_state_base);
+    }
+
+    if (header.version == SectionedStateVersion) {
+        LoadSectionedState(file, header.is_delta != 0);
+    } else {
+        // Older states are a single archive, decompressed while it is deserialized
+        Common::Compression::ZSTDDecompressStreambuf streambuf{file};
+        std::istream stream{&streambuf};
+        DeserializeState(stream, header.is_delta != 0);
     }
-    std::istringstream sstream{
-        std::string{reinterpret_cast<char*>(decompressed.data()), decompressed.size()},
-        std::ios_base::binary};
-    decompressed.clear();
 
-    // Deserialize
-    iarchive ia{sstream};
-    ia&* this;
+    if (header.is_delta) {
+        delta_state_base = std::move(base);
+    } else {
+        delta_state_base = std::make_unique<DeltaStateBase>(
+            DeltaStateBase{slot, header.time, header.id, HashFCRAMPages(*memory)});
+    }
 }
 
 } // namespace Core
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 #include "common/common_types.h"
 
@@ -22,6 +23,25 @@ struct SaveStateInfo {
 
 constexpr u32 SaveStateSlotCount = 10; // Maximum count of savestate slots
 
+/// A full savestate that delta savestates can be made against
+struct DeltaStateBase {
+    u32 slot;
+    /// Creation time and unique ID of the state, to notice the slot being overwritten
+    u64 time;
+    u64 id;
+    /// Hash of every FCRAM page as saved in the state
+    std::vector<u64> page_hashes;
+};
+
+/// Uncompressed state of the emulated system, as written by System::SerializeState
+struct SerializedState {
+    std::string data;
+    /// Hash of every FCRAM page at the time of the state
+    std::vector<u64> page_hashes;
+    /// Number of FCRAM pages stored by a delta state
+    std::size_t num_dirty_pages = 0;
+};
+
 std::vector<SaveStateInfo> ListSaveStates(u64 program_id);
 
 } // namespace Core
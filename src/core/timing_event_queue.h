@@ -0,0 +1,347 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <vector>
+#include "common/assert.h"
+#include "common/common_types.h"
+
+namespace Core {
+
+/**
+ * Event queue backends used by Core::Timing. Both order events by (time, fifo_order) through the
+ * event's operator<, and expose the same interface:
+ *
+ *   Handle Push(const Event& event)    Inserts an event and returns a handle for cancelling it
+ *   bool Remove(Handle handle)         Cancels the event of a handle if it is still queued
+ *   std::size_t RemoveIf(pred)         Cancels every queued event matching pred
+ *   const Event& Top() const           Returns the earliest event, the queue must not be empty
+ *   Event Pop()                        Removes and returns the earliest event
+ *   void ForEach(func) const           Calls func for every queued event in unspecified order
+ */
+using TimingEventHandle = u64;
+
+constexpr TimingEventHandle INVALID_TIMING_EVENT_HANDLE = std::numeric_limits<u64>::max();
+
+/**
+ * Binary min-heap stored in a vector. Insertion and removal of the earliest event are
+ * O(log n), cancellation needs a linear scan and rebuilding the heap.
+ */
+template <typename Event>
+class HeapEventQueue {
+public:
+    using Handle = TimingEventHandle;
+
+    Handle Push(const Event& event) {
+        const Handle handle = next_handle++;
+        heap.push_back({event, handle});
+        std::push_heap(heap.begin(), heap.end(), std::greater<>());
+        return handle;
+    }
+
+    bool Remove(Handle handle) {
+        return RemoveEntries([handle](const Entry& entry) { return entry.handle == handle; }) != 0;
+    }
+
+    template <typename Pred>
+    std::size_t RemoveIf(Pred&& pred) {
+        return RemoveEntries([&pred](const Entry& entry) { return pred(entry.event); });
+    }
+
+    [[nodiscard]] bool Empty() const {
+        return heap.empty();
+    }
+
+    [[nodiscard]] std::size_t Size() const {
+        return heap.size();
+    }
+
+    [[nodiscard]] const Event& Top() const {
+        return heap.front().event;
+    }
+
+    Event Pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        Event event = std::move(heap.back().event);
+        heap.pop_back();
+        return event;
+    }
+
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (const Entry& entry : heap) {
+            func(entry.event);
+        }
+    }
+
+    void Clear() {
+        heap.clear();
+    }
+
+private:
+    struct Entry {
+        Event event;
+        Handle handle;
+
+        bool operator>(const Entry& other) const {
+            return other.event < event;
+        }
+    };
+
+    template <typename Pred>
+    std::size_t RemoveEntries(Pred&& pred) {
+        const auto itr = std::remove_if(heap.begin(), heap.end(), pred);
+        const auto removed = static_cast<std::size_t>(std::distance(itr, heap.end()));
+        // Removing random items breaks the invariant so we have to re-establish it.
+        if (removed != 0) {
+            heap.erase(itr, heap.end());
+            std::make_heap(heap.begin(), heap.end(), std::greater<>());
+        }
+        return removed;
+    }
+
+    std::vector<Entry> heap;
+    Handle next_handle = 0;
+};
+
+/**
+ * Hierarchical timing wheel. Level L has 64 slots that are 64^L ticks wide, and an event lives in
+ * the lowest level whose range around the current wheel time contains it. Events further away
+ * than the last level are kept in an overflow list.
+ *
+ * Insertion and cancellation by handle are O(1). Finding the earliest event only looks at the
+ * first occupied slot of the lowest occupied level. When an event is popped from a coarse slot,
+ * the rest of that slot is redistributed to finer levels, so every event is touched at most once
+ * per level on its way out.
+ */
+template <typename Event>
+class TimingWheelEventQueue {
+public:
+    using Handle = TimingEventHandle;
+
+    Handle Push(const Event& event) {
+        u32 index;
+        if (free_nodes.empty()) {
+            index = static_cast<u32>(nodes.size());
+            nodes.emplace_back();
+        } else {
+            index = free_nodes.back();
+            free_nodes.pop_back();
+        }
+        Node& node = nodes[index];
+        node.event = event;
+        node.used = true;
+        Link(index);
+        size++;
+
+        if (cached_min != INVALID_INDEX && event < nodes[cached_min].event) {
+            cached_min = index;
+        }
+        return (static_cast<u64>(node.generation) << 32) | index;
+    }
+
+    bool Remove(Handle handle) {
+        const u32 index = static_cast<u32>(handle);
+        if (index >= nodes.size() || !nodes[index].used ||
+            nodes[index].generation != static_cast<u32>(handle >> 32)) {
+            return false;
+        }
+        Release(index);
+        return true;
+    }
+
+    template <typename Pred>
+    std::size_t RemoveIf(Pred&& pred) {
+        std::size_t removed = 0;
+        for (u32 index = 0; index < nodes.size(); ++index) {
+            if (nodes[index].used && pred(nodes[index].event)) {
+                Release(index);
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    [[nodiscard]] bool Empty() const {
+        return size == 0;
+    }
+
+    [[nodiscard]] std::size_t Size() const {
+        return size;
+    }
+
+    [[nodiscard]] const Event& Top() const {
+        return nodes[FindMin()].event;
+    }
+
+    Event Pop() {
+        const u32 index = FindMin();
+        const u32 level = nodes[index].level;
+        const u32 slot = nodes[index].slot;
+        Event event = std::move(nodes[index].event);
+        Release(index);
+
+        // Events can be queued with a time that is already in the past, never go backwards.
+        const s64 old_base = base;
+        base = std::max(base, event.time);
+        if (level != 0 && base != old_base) {
+            // The remaining events of this slot now fall into the range of a finer level.
+            u32 item = Head(level, slot);
+            Head(level, slot) = INVALID_INDEX;
+            if (level < NUM_LEVELS) {
+                occupied[level] &= ~(u64{1} << slot);
+            }
+            while (item != INVALID_INDEX) {
+                const u32 next = nodes[item].next;
+                Link(item);
+                item = next;
+            }
+        }
+        return event;
+    }
+
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (const Node& node : nodes) {
+            if (node.used) {
+                func(node.event);
+            }
+        }
+    }
+
+    void Clear() {
+        nodes.clear();
+        free_nodes.clear();
+        for (auto& level : heads) {
+            level.fill(INVALID_INDEX);
+        }
+        overflow_head = INVALID_INDEX;
+        occupied.fill(0);
+        size = 0;
+        base = 0;
+        cached_min = INVALID_INDEX;
+    }
+
+private:
+    static constexpr u32 SLOT_BITS = 6;
+    static constexpr u32 NUM_SLOTS = 1 << SLOT_BITS;
+    static constexpr u32 NUM_LEVELS = 8;
+    static constexpr u32 INVALID_INDEX = std::numeric_limits<u32>::max();
+
+    struct Node {
+        Event event{};
+        u32 prev = INVALID_INDEX;
+        u32 next = INVALID_INDEX;
+        u32 generation = 0;
+        u8 level = 0;
+        u8 slot = 0;
+        bool used = false;
+    };
+
+    u32& Head(u32 level, u32 slot) {
+        return level < NUM_LEVELS ? heads[level][slot] : overflow_head;
+    }
+
+    /// Inserts a node into the slot its time maps to, relative to the current wheel time.
+    void Link(u32 index) {
+        Node& node = nodes[index];
+        const u64 key = static_cast<u64>(std::max(node.event.time, base));
+        const u64 diff = key ^ static_cast<u64>(base);
+        const u32 level = diff == 0 ? 0 : (63 - std::countl_zero(diff)) / SLOT_BITS;
+        u32 slot = 0;
+        if (level < NUM_LEVELS) {
+            slot = static_cast<u32>(key >> (level * SLOT_BITS)) & (NUM_SLOTS - 1);
+            occupied[level] |= u64{1} << slot;
+        }
+        node.level = static_cast<u8>(std::min(level, NUM_LEVELS));
+        node.slot = static_cast<u8>(slot);
+
+        u32& head = Head(node.level, slot);
+        node.prev = INVALID_INDEX;
+        node.next = head;
+        if (head != INVALID_INDEX) {
+            nodes[head].prev = index;
+        }
+        head = index;
+    }
+
+    void Unlink(u32 index) {
+        Node& node = nodes[index];
+        if (node.prev != INVALID_INDEX) {
+            nodes[node.prev].next = node.next;
+        } else {
+            Head(node.level, node.slot) = node.next;
+            if (node.next == INVALID_INDEX && node.level < NUM_LEVELS) {
+                occupied[node.level] &= ~(u64{1} << node.slot);
+            }
+        }
+        if (node.next != INVALID_INDEX) {
+            nodes[node.next].prev = node.prev;
+        }
+    }
+
+    void Release(u32 index) {
+        Unlink(index);
+        Node& node = nodes[index];
+        node.used = false;
+        node.event = {};
+        node.generation++;
+        free_nodes.push_back(index);
+        size--;
+        if (cached_min == index) {
+            cached_min = INVALID_INDEX;
+        }
+    }
+
+    u32 FindMin() const {
+        ASSERT(size != 0);
+        if (cached_min != INVALID_INDEX) {
+            return cached_min;
+        }
+        // All events of a level are later than those of the levels below it, and within a level
+        // the slots before the one of the wheel time are empty. So the earliest event is in the
+        // first occupied slot of the lowest occupied level, or in the overflow list.
+        u32 item = overflow_head;
+        for (u32 level = 0; level < NUM_LEVELS; ++level) {
+            if (occupied[level] != 0) {
+                item = heads[level][std::countr_zero(occupied[level])];
+                break;
+            }
+        }
+        u32 min = item;
+        for (; item != INVALID_INDEX; item = nodes[item].next) {
+            if (nodes[item].event < nodes[min].event) {
+                min = item;
+            }
+        }
+        cached_min = min;
+        return min;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<u32> free_nodes;
+    std::array<std::array<u32, NUM_SLOTS>, NUM_LEVELS> heads = MakeEmptyHeads();
+    u32 overflow_head = INVALID_INDEX;
+    std::array<u64, NUM_LEVELS> occupied{};
+    std::size_t size = 0;
+    /// Current wheel time, no queued event maps to a slot before it
+    s64 base = 0;
+    mutable u32 cached_min = INVALID_INDEX;
+
+    static constexpr std::array<std::array<u32, NUM_SLOTS>, NUM_LEVELS> MakeEmptyHeads() {
+        std::array<std::array<u32, NUM_SLOTS>, NUM_LEVELS> result{};
+        for (auto& level : result) {
+            level.fill(INVALID_INDEX);
+        }
+        return result;
+    }
+};
+
+} // namespace Core
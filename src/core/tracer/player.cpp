@@ -0,0 +1,174 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/hw/gpu.h"
+#include "core/hw/hw.h"
+#include "core/hw/lcd.h"
+#include "core/memory.h"
+#include "core/tracer/player.h"
+#include "video_core/pica_state.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
+
+namespace CiTrace {
+
+/// The recorder stores IO registers at their physical address, see HW::Write
+constexpr u32 IOPhysicalBase = 0x10100000;
+constexpr u32 IOVirtualBase = 0x1EC00000;
+
+Player::Player(Memory::MemorySystem& memory_) : memory{memory_} {}
+
+Player::~Player() = default;
+
+bool Player::Load(const std::string& filename) {
+    FileUtil::IOFile file(filename, "rb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(HW_GPU, "Failed to open CiTrace {}", filename);
+        return false;
+    }
+    file_data.resize(file.GetSize());
+    if (file.ReadBytes(file_data.data(), file_data.size()) != file_data.size() ||
+        file_data.size() < sizeof(CTHeader)) {
+        LOG_ERROR(HW_GPU, "Failed to read CiTrace {}", filename);
+        return false;
+    }
+
+    std::memcpy(&header, file_data.data(), sizeof(CTHeader));
+    if (std::memcmp(header.magic, CTHeader::ExpectedMagicWord(), 4) != 0 ||
+        header.version != CTHeader::ExpectedVersion()) {
+        LOG_ERROR(HW_GPU, "{} is not a CiTrace of version {}", filename,
+                  CTHeader::ExpectedVersion());
+        return false;
+    }
+    const u64 stream_end =
+        header.stream_offset + u64{header.stream_size} * sizeof(CTStreamElement);
+    if (stream_end > file_data.size()) {
+        LOG_ERROR(HW_GPU, "CiTrace {} is truncated", filename);
+        return false;
+    }
+
+    stream.resize(header.stream_size);
+    std::memcpy(stream.data(), file_data.data() + header.stream_offset,
+                stream.size() * sizeof(CTStreamElement));
+    num_frames = std::count_if(stream.begin(), stream.end(), [](const CTStreamElement& element) {
+        return element.type == FrameMarker;
+    });
+    next_element = 0;
+    return true;
+}
+
+void Player::Reset() {
+    // Replayed jobs may still be running on the GPU thread
+    GPU::Synchronize();
+    next_element = 0;
+
+    const auto& initial = header.initial_state_offsets;
+    const auto restore = [this](void* dest, std::size_t dest_size, u32 offset, u32 size) {
+        const std::vector<u32> words = ReadInitialState(offset, size);
+        std::memcpy(dest, words.data(), std::min(dest_size, words.size() * sizeof(u32)));
+    };
+    restore(&GPU::g_regs, sizeof(GPU::g_regs), initial.gpu_registers, initial.gpu_registers_size);
+    restore(&LCD::g_regs, sizeof(LCD::g_regs), initial.lcd_registers, initial.lcd_registers_size);
+    restore(&Pica::g_state.regs, sizeof(Pica::g_state.regs), initial.pica_registers,
+            initial.pica_registers_size);
+
+    auto& vs = Pica::g_state.vs;
+    restore(vs.program_code.data(), sizeof(vs.program_code), initial.vs_program_binary,
+            initial.vs_program_binary_size);
+    restore(vs.swizzle_data.data(), sizeof(vs.swizzle_data), initial.vs_swizzle_data,
+            initial.vs_swizzle_data_size);
+    vs.MarkProgramCodeDirty();
+    vs.MarkSwizzleDataDirty();
+
+    // Attributes and uniforms are stored as four float24 words, of which three are written
+    const auto restore_vectors = [this](std::span<Common::Vec4<Pica::float24>> dest, u32 offset,
+                                        u32 size) {
+        const std::vector<u32> words = ReadInitialState(offset, size);
+        for (std::size_t i = 0; i < std::min(dest.size(), words.size() / 4); i++) {
+            for (std::size_t comp = 0; comp < 3; comp++) {
+                dest[i][comp] = Pica::float24::FromRaw(words[4 * i + comp]);
+            }
+        }
+    };
+    restore_vectors(Pica::g_state.input_default_attributes.attr, initial.default_attributes,
+                    initial.default_attributes_size);
+    restore_vectors(vs.uniforms.f, initial.vs_float_uniforms, initial.vs_float_uniforms_size);
+
+    VideoCore::g_renderer->Rasterizer()->SyncEntireState();
+}
+
+bool Player::ReplayFrame() {
+    while (next_element < stream.size()) {
+        const CTStreamElement& element = stream[next_element++];
+        switch (element.type) {
+        case FrameMarker:
+            // The presented frame may be read from surfaces the GPU thread is rendering to
+            GPU::Synchronize();
+            VideoCore::g_renderer->SwapBuffers();
+            return true;
+        case MemoryLoad:
+            LoadMemory(element.memory_load);
+            break;
+        case RegisterWrite:
+            WriteRegister(element.register_write);
+            break;
+        default:
+            LOG_ERROR(HW_GPU, "Unknown CiTrace stream element {:#x}",
+                      static_cast<u32>(element.type));
+            break;
+        }
+    }
+    return false;
+}
+
+std::vector<u32> Player::ReadInitialState(u32 offset, u32 size) const {
+    if (offset + u64{size} * sizeof(u32) > file_data.size()) {
+        LOG_ERROR(HW_GPU, "CiTrace initial state at {:#x} is out of bounds", offset);
+        return {};
+    }
+    std::vector<u32> words(size);
+    std::memcpy(words.data(), file_data.data() + offset, size * sizeof(u32));
+    return words;
+}
+
+void Player::LoadMemory(const CTMemoryLoad& load) {
+    const PAddr addr = load.physical_address;
+    if (load.size == 0 || load.file_offset + u64{load.size} > file_data.size() ||
+        !memory.IsValidPhysicalAddress(addr) ||
+        !memory.IsValidPhysicalAddress(addr + load.size - 1)) {
+        LOG_ERROR(HW_GPU, "Skipping invalid CiTrace memory load of {:#x} bytes at {:#010x}",
+                  load.size, addr);
+        return;
+    }
+
+    GPU::Synchronize();
+    std::memcpy(memory.GetPhysicalPointer(addr), file_data.data() + load.file_offset, load.size);
+    VideoCore::g_renderer->Rasterizer()->InvalidateRegion(addr, load.size);
+}
+
+void Player::WriteRegister(const CTRegisterWrite& write) {
+    const u32 addr = write.physical_address - IOPhysicalBase + IOVirtualBase;
+    switch (write.size) {
+    case CTRegisterWrite::SIZE_8:
+        HW::Write<u8>(addr, static_cast<u8>(write.value));
+        break;
+    case CTRegisterWrite::SIZE_16:
+        HW::Write<u16>(addr, static_cast<u16>(write.value));
+        break;
+    case CTRegisterWrite::SIZE_32:
+        HW::Write<u32>(addr, static_cast<u32>(write.value));
+        break;
+    case CTRegisterWrite::SIZE_64:
+        HW::Write<u64>(addr, write.value);
+        break;
+    }
+}
+
+} // namespace CiTrace
@@ -0,0 +1,61 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "core/tracer/citrace.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+namespace CiTrace {
+
+/**
+ * Replays a recorded CiTrace against the emulated GPU. Memory loads are written to physical
+ * memory and register writes go through the MMIO handlers, so the commands run on whatever
+ * renderer is active without the guest CPU.
+ */
+class Player {
+public:
+    explicit Player(Memory::MemorySystem& memory);
+    ~Player();
+
+    /// Loads the trace at filename, returns false if it is not a valid CiTrace
+    bool Load(const std::string& filename);
+
+    /// Returns the number of frame markers in the loaded trace
+    [[nodiscard]] std::size_t GetNumFrames() const noexcept {
+        return num_frames;
+    }
+
+    /// Restores the register and shader state at recording start and rewinds the stream
+    void Reset();
+
+    /**
+     * Replays the stream up to and including the next frame marker, which presents the frame.
+     * @returns false once the end of the stream was reached.
+     */
+    bool ReplayFrame();
+
+private:
+    /// Returns the initial state block at the given offset and size, in u32 units
+    std::vector<u32> ReadInitialState(u32 offset, u32 size) const;
+
+    void LoadMemory(const CTMemoryLoad& load);
+
+    void WriteRegister(const CTRegisterWrite& write);
+
+    Memory::MemorySystem& memory;
+    std::vector<u8> file_data;
+    CTHeader header{};
+    std::vector<CTStreamElement> stream;
+    std::size_t num_frames{};
+    std::size_t next_element{};
+};
+
+} // namespace CiTrace
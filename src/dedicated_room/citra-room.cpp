@@ -58,6 +58,8 @@ static void PrintHelp(const char* argv0) {
                  "--ban-list-file     The file for storing the room ban list\n"
                  "--log-file          The file for storing the room log\n"
                  "--enable-citra-mods Allow Citra Community Moderators to moderate on your room\n"
+                 "--stats-interval    Log the network stats of the members every that many\n"
+                 "                    seconds\n"
                  "-h, --help          Display this help and exit\n"
                  "-v, --version       Output version information and exit\n";
 }
@@ -180,6 +182,7 @@ int main(int argc, char** argv) {
     u64 preferred_game_id = 0;
     u32 port = Network::DefaultRoomPort;
     u32 max_members = 16;
+    u32 stats_interval = 0;
     bool enable_citra_mods = false;
 
     static struct option long_options[] = {
@@ -196,6 +199,7 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-citra-mods", no_argument, 0, 'e'},
+        {"stats-interval", required_argument, 0, 's'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -244,6 +248,9 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_citra_mods = true;
                 break;
+            case 's':
+                stats_interval = strtoul(optarg, &endarg, 0);
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -335,6 +342,7 @@ int main(int argc, char** argv) {
 
     Network::Init();
     if (std::shared_ptr<Network::Room> room = Network::GetRoom().lock()) {
+        room->SetStatsLogInterval(std::chrono::seconds{stats_interval});
         if (!room->Create(room_name, room_description, "", port, password, max_members, username,
                           preferred_game, preferred_game_id, std::move(verify_backend), ban_list,
                           enable_citra_mods)) {
@@ -14,6 +14,9 @@ struct Values {
     std::string web_api_url;
     std::string citra_username;
     std::string citra_token;
+
+    // Multiplayer
+    bool enable_direct_connections;
 } extern values;
 
 } // namespace NetSettings
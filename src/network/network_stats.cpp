@@ -0,0 +1,51 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "enet/enet.h"
+#include "network/network_stats.h"
+
+namespace Network {
+
+void NetworkStatsCollector::Sample(u32 round_trip_time_ms_, u32 round_trip_time_variance_ms_,
+                                   u32 packet_loss_) {
+    const auto bucket = std::lower_bound(RoundTripTimeBucketBoundsMs.begin(),
+                                         RoundTripTimeBucketBoundsMs.end(), round_trip_time_ms_);
+
+    std::scoped_lock lock{sample_mutex};
+    round_trip_time_ms = round_trip_time_ms_;
+    round_trip_time_variance_ms = round_trip_time_variance_ms_;
+    packet_loss = static_cast<float>(packet_loss_) / ENET_PEER_PACKET_LOSS_SCALE;
+    round_trip_time_histogram[bucket - RoundTripTimeBucketBoundsMs.begin()]++;
+}
+
+NetworkStats NetworkStatsCollector::Get() const {
+    NetworkStats stats;
+    stats.packets_sent = packets_sent.load(std::memory_order_relaxed);
+    stats.packets_received = packets_received.load(std::memory_order_relaxed);
+    stats.bytes_sent = bytes_sent.load(std::memory_order_relaxed);
+    stats.bytes_received = bytes_received.load(std::memory_order_relaxed);
+
+    std::scoped_lock lock{sample_mutex};
+    stats.round_trip_time_ms = round_trip_time_ms;
+    stats.round_trip_time_variance_ms = round_trip_time_variance_ms;
+    stats.packet_loss = packet_loss;
+    stats.round_trip_time_histogram = round_trip_time_histogram;
+    return stats;
+}
+
+void NetworkStatsCollector::Reset() {
+    packets_sent = 0;
+    packets_received = 0;
+    bytes_sent = 0;
+    bytes_received = 0;
+
+    std::scoped_lock lock{sample_mutex};
+    round_trip_time_ms = 0;
+    round_trip_time_variance_ms = 0;
+    packet_loss = 0.0f;
+    round_trip_time_histogram = {};
+}
+
+} // namespace Network
@@ -0,0 +1,71 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include "common/common_types.h"
+
+namespace Network {
+
+/// Upper bounds in ms of the round trip time histogram buckets, the last bucket is unbounded
+constexpr std::array<u32, 7> RoundTripTimeBucketBoundsMs{10, 20, 40, 80, 160, 320, 640};
+constexpr std::size_t NumRoundTripTimeBuckets = RoundTripTimeBucketBoundsMs.size() + 1;
+
+/// Quality of the connection between a room member and the room
+struct NetworkStats {
+    u64 packets_sent = 0;     ///< Packets sent over the connection
+    u64 packets_received = 0; ///< Packets received over the connection
+    u64 bytes_sent = 0;       ///< Bytes of the sent packets
+    u64 bytes_received = 0;   ///< Bytes of the received packets
+    u32 round_trip_time_ms = 0;          ///< Mean round trip time measured by ENet
+    u32 round_trip_time_variance_ms = 0; ///< Variance of the round trip time measured by ENet
+    float packet_loss = 0.0f; ///< Recent fraction of reliable packets that ENet had to resend
+    /// The round trip times sampled once a second, counted per RoundTripTimeBucketBoundsMs bucket
+    std::array<u32, NumRoundTripTimeBuckets> round_trip_time_histogram{};
+};
+
+/**
+ * Collects the NetworkStats of a connection. The network thread counts the packets and samples the
+ * ENet peer, other threads may read the stats at any time.
+ */
+class NetworkStatsCollector {
+public:
+    void AddSent(std::size_t bytes) {
+        packets_sent.fetch_add(1, std::memory_order_relaxed);
+        bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void AddReceived(std::size_t bytes) {
+        packets_received.fetch_add(1, std::memory_order_relaxed);
+        bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * Records the round trip time and packet loss the ENet peer measured.
+     * @param packet_loss Packet loss scaled by ENET_PEER_PACKET_LOSS_SCALE.
+     */
+    void Sample(u32 round_trip_time_ms, u32 round_trip_time_variance_ms, u32 packet_loss);
+
+    NetworkStats Get() const;
+
+    /// Clears the stats for a new connection
+    void Reset();
+
+private:
+    std::atomic<u64> packets_sent{0};
+    std::atomic<u64> packets_received{0};
+    std::atomic<u64> bytes_sent{0};
+    std::atomic<u64> bytes_received{0};
+
+    mutable std::mutex sample_mutex; ///< Protects the members below
+    u32 round_trip_time_ms = 0;
+    u32 round_trip_time_variance_ms = 0;
+    float packet_loss = 0.0f;
+    std::array<u32, NumRoundTripTimeBuckets> round_trip_time_histogram{};
+};
+
+} // namespace Network
@@ -4,12 +4,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iomanip>
 #include <mutex>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -42,12 +44,28 @@ public:
         /// Data of the user, often including authenticated forum username.
         VerifyUser::UserData user_data;
         ENetPeer* peer; ///< The remote peer.
+        std::shared_ptr<NetworkStatsCollector> network_stats =
+            std::make_shared<NetworkStatsCollector>();
+        u16 direct_port = 0; ///< Port for direct connections, 0 if the member doesn't accept any
     };
     using MemberList = std::vector<Member>;
     MemberList members;              ///< Information about the members of this room
     mutable std::mutex member_mutex; ///< Mutex for locking the members list
     /// This should be a std::shared_mutex as soon as C++17 is supported
 
+    struct RelayTarget {
+        MacAddress mac_address;
+        ENetPeer* peer;
+        NetworkStatsCollector* network_stats;
+    };
+    /// Copy of the member addresses used to relay WiFi packets. It is only used by the room
+    /// thread, so relaying does not have to lock the member list. Updated whenever members change.
+    std::vector<RelayTarget> relay_targets;
+    /// Stats of the members by peer, to count the received packets. Updated with relay_targets.
+    std::unordered_map<const ENetPeer*, NetworkStatsCollector*> peer_stats;
+
+    std::chrono::seconds stats_log_interval{0}; ///< How often the member stats are logged
+
     UsernameBanList username_ban_list; ///< List of banned usernames
     IPBanList ip_ban_list;             ///< List of banned IP addresses
     mutable std::mutex ban_list_mutex; ///< Mutex for the ban lists
@@ -65,6 +83,15 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /// Dispatches a received event to its handler.
+    void HandleEvent(ENetEvent& event);
+
+    /// Rebuilds relay_targets from the member list.
+    void UpdateRelayTargets();
+
+    /// Samples the round trip times of the members, and logs the stats when it is time to.
+    void SampleNetworkStats(bool log);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -223,10 +250,12 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Broadcasts this packet to all members except the sender, or sends it to its destination.
+     * The packet is forwarded as is instead of being copied.
      * @param event The ENet event containing the data
+     * @return whether the packet was handed to ENet, in which case it must not be destroyed
      */
-    void HandleWifiPacket(const ENetEvent* event);
+    bool HandleWifiPacket(ENetEvent* event);
 
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
@@ -245,57 +274,139 @@ public:
      * to all other clients.
      */
     void HandleClientDisconnection(ENetPeer* client);
+
+    /**
+     * Stores the port a member accepts direct connections on, and announces it.
+     * @param event The ENet event that was received.
+     */
+    void HandleDirectEndpointPacket(const ENetEvent* event);
+
+    /**
+     * Sends the addresses the members accept direct connections on to those members. Members
+     * that did not ask for direct connections are not told about the others, nor listed.
+     */
+    void BroadcastDirectEndpoints();
 };
 
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
+    using Clock = std::chrono::steady_clock;
+    auto last_sample = Clock::now();
+    auto last_log = last_sample;
     while (state != State::Closed) {
-        ENetEvent event;
-        if (enet_host_service(server, &event, 16) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
+        const auto now = Clock::now();
+        if (now - last_sample >= std::chrono::seconds{1}) {
+            const bool log =
+                stats_log_interval.count() > 0 && now - last_log >= stats_log_interval;
+            SampleNetworkStats(log);
+            last_sample = now;
+            if (log) {
+                last_log = now;
             }
         }
+
+        ENetEvent event;
+        if (enet_host_service(server, &event, 16) <= 0) {
+            continue;
+        }
+        // Handle everything that has already arrived before sending anything. The packets that
+        // are relayed to a member are then sent together, instead of flushing once per packet.
+        do {
+            HandleEvent(event);
+        } while (enet_host_check_events(server, &event) > 0);
+        enet_host_flush(server);
     }
     // Close the connection to all members:
     SendCloseMessage();
 }
 
+void Room::RoomImpl::HandleEvent(ENetEvent& event) {
+    switch (event.type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        if (const auto stats = peer_stats.find(event.peer); stats != peer_stats.end()) {
+            stats->second->AddReceived(event.packet->dataLength);
+        }
+        switch (event.packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(&event);
+            break;
+        case IdSetGameInfo:
+            HandleGameNamePacket(&event);
+            break;
+        case IdWifiPacket:
+        case IdWifiPacketBatch:
+            if (HandleWifiPacket(&event)) {
+                return;
+            }
+            break;
+        case IdChatMessage:
+            HandleChatPacket(&event);
+            break;
+        case IdDirectEndpoint:
+            HandleDirectEndpointPacket(&event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(&event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(&event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(&event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(&event);
+            break;
+        }
+        enet_packet_destroy(event.packet);
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+}
+
+void Room::RoomImpl::UpdateRelayTargets() {
+    std::lock_guard lock(member_mutex);
+    relay_targets.clear();
+    peer_stats.clear();
+    for (const auto& member : members) {
+        relay_targets.push_back({member.mac_address, member.peer, member.network_stats.get()});
+        peer_stats.emplace(member.peer, member.network_stats.get());
+    }
+}
+
+void Room::RoomImpl::SampleNetworkStats(bool log) {
+    for (const auto& target : relay_targets) {
+        target.network_stats->Sample(target.peer->roundTripTime,
+                                     target.peer->roundTripTimeVariance, target.peer->packetLoss);
+    }
+    if (!log) {
+        return;
+    }
+
+    std::lock_guard lock(member_mutex);
+    for (const auto& member : members) {
+        const NetworkStats stats = member.network_stats->Get();
+        std::string histogram;
+        for (const u32 count : stats.round_trip_time_histogram) {
+            histogram += (histogram.empty() ? "" : ",") + std::to_string(count);
+        }
+        // One line of key=value pairs per member, so that the log can be parsed by monitoring
+        LOG_INFO(Network,
+                 "Member stats: nickname={} rtt_ms={} rtt_variance_ms={} packet_loss={:.3f} "
+                 "packets_sent={} packets_received={} bytes_sent={} bytes_received={} "
+                 "rtt_histogram={}",
+                 member.nickname, stats.round_trip_time_ms, stats.round_trip_time_variance_ms,
+                 stats.packet_loss, stats.packets_sent, stats.packets_received, stats.bytes_sent,
+                 stats.bytes_received, histogram);
+    }
+}
+
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
@@ -405,6 +516,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         std::lock_guard lock(member_mutex);
         members.push_back(std::move(member));
     }
+    UpdateRelayTargets();
 
     // Notify everyone that the room information has changed.
     BroadcastRoomInformation();
@@ -451,6 +563,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         enet_peer_disconnect(target_member->peer, 0);
         members.erase(target_member);
     }
+    UpdateRelayTargets();
 
     // Announce the change to all clients.
     SendStatusMessage(IdMemberKicked, nickname, username, ip);
@@ -494,6 +607,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         enet_peer_disconnect(target_member->peer, 0);
         members.erase(target_member);
     }
+    UpdateRelayTargets();
 
     {
         std::lock_guard lock(ban_list_mutex);
@@ -832,6 +946,64 @@ void Room::RoomImpl::BroadcastRoomInformation() {
         enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
     enet_host_broadcast(server, 0, enet_packet);
     enet_host_flush(server);
+
+    // The room information goes out whenever the members change, so do the endpoints
+    BroadcastDirectEndpoints();
+}
+
+void Room::RoomImpl::HandleDirectEndpointPacket(const ENetEvent* event) {
+    Packet in_packet;
+    in_packet.Append(event->packet->data, event->packet->dataLength);
+
+    in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+    u16 direct_port;
+    in_packet >> direct_port;
+    if (!in_packet) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(member_mutex);
+        auto member =
+            std::find_if(members.begin(), members.end(), [event](const Member& member) -> bool {
+                return member.peer == event->peer;
+            });
+        if (member == members.end()) {
+            return;
+        }
+        member->direct_port = direct_port;
+    }
+    BroadcastDirectEndpoints();
+}
+
+void Room::RoomImpl::BroadcastDirectEndpoints() {
+    std::lock_guard lock(member_mutex);
+    const auto num_endpoints = static_cast<u32>(std::count_if(
+        members.begin(), members.end(), [](const Member& member) { return member.direct_port; }));
+    if (num_endpoints == 0) {
+        return;
+    }
+
+    Packet packet;
+    packet << static_cast<u8>(IdDirectEndpoints);
+    packet << num_endpoints;
+    for (const auto& member : members) {
+        if (member.direct_port) {
+            packet << member.mac_address;
+            // The address the room sees, behind NAT the public one
+            packet << static_cast<u32>(member.peer->address.host);
+            packet << member.direct_port;
+        }
+    }
+
+    ENetPacket* enet_packet =
+        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    for (const auto& member : members) {
+        if (member.direct_port) {
+            enet_peer_send(member.peer, 0, enet_packet);
+        }
+    }
+    enet_host_flush(server);
 }
 
 MacAddress Room::RoomImpl::GenerateMacAddress() {
@@ -846,52 +1018,47 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
     return result_mac;
 }
 
-void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+bool Room::RoomImpl::HandleWifiPacket(ENetEvent* event) {
+    // Message type, WifiPacket type, channel and transmitter address precede the destination.
+    // Batches have two other bytes in place of the type and channel.
+    constexpr std::size_t DestinationOffset = 3 * sizeof(u8) + sizeof(MacAddress);
+    ENetPacket* enet_packet = event->packet;
+    if (enet_packet->dataLength < DestinationOffset + sizeof(MacAddress)) {
+        return false;
+    }
     MacAddress destination_address;
-    in_packet >> destination_address;
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    std::memcpy(destination_address.data(), enet_packet->data + DestinationOffset,
+                destination_address.size());
 
+    // ENet reference counts the packet and frees it once every peer it was queued for is done
+    enet_packet->flags = ENET_PACKET_FLAG_RELIABLE;
+    bool sent_packet = false;
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
-        for (const auto& member : members) {
-            if (member.peer != event->peer) {
+        for (const auto& target : relay_targets) {
+            if (target.peer != event->peer) {
                 sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
+                target.network_stats->AddSent(enet_packet->dataLength);
+                enet_peer_send(target.peer, 0, enet_packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto target = std::find_if(relay_targets.begin(), relay_targets.end(),
+                                         [&destination_address](const RelayTarget& target) {
+                                             return target.mac_address == destination_address;
+                                         });
+        if (target != relay_targets.end()) {
+            sent_packet = true;
+            target->network_stats->AddSent(enet_packet->dataLength);
+            enet_peer_send(target->peer, 0, enet_packet);
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
-    enet_host_flush(server);
+    return sent_packet;
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -997,6 +1164,8 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
         }
     }
 
+    UpdateRelayTargets();
+
     // Announce the change to all clients.
     enet_peer_disconnect(client, 0);
     if (!nickname.empty())
@@ -1076,6 +1245,7 @@ std::vector<Room::Member> Room::GetRoomMemberList() const {
         member.avatar_url = member_impl.user_data.avatar_url;
         member.mac_address = member_impl.mac_address;
         member.game_info = member_impl.game_info;
+        member.network_stats = member_impl.network_stats->Get();
         member_list.push_back(member);
     }
     return member_list;
@@ -1104,8 +1274,14 @@ void Room::Destroy() {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
     }
+    room_impl->relay_targets.clear();
+    room_impl->peer_stats.clear();
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
 }
 
+void Room::SetStatsLogInterval(std::chrono::seconds interval) {
+    room_impl->stats_log_interval = interval;
+}
+
 } // namespace Network
@@ -5,15 +5,17 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
 #include "common/common_types.h"
+#include "network/network_stats.h"
 #include "network/verify_user.h"
 
 namespace Network {
 
-constexpr u32 network_version = 4; ///< The version of this Room and RoomMember
+constexpr u32 network_version = 5; ///< The version of this Room and RoomMember
 
 constexpr u16 DefaultRoomPort = 24872;
 
@@ -76,6 +78,14 @@ enum RoomMessageTypes : u8 {
     IdModPermissionDenied,
     IdModNoSuchUser,
     IdJoinSuccessAsMod,
+    /// Several WifiPackets from one transmitter to one destination. The addresses are at the same
+    /// offsets as in IdWifiPacket.
+    IdWifiPacketBatch,
+    /// Direct connections between members. Rooms and members that don't know them ignore them,
+    /// and the traffic stays relayed.
+    IdDirectEndpoint,  ///< The port a member accepts direct connections on
+    IdDirectEndpoints, ///< The endpoints of all members that accept direct connections
+    IdDirectHello,     ///< Sent over a direct connection to tell the MAC address of the sender
 };
 
 /// Types of system status messages
@@ -102,6 +112,8 @@ public:
         std::string avatar_url;   ///< Url to the member's avatar. Can be empty.
         GameInfo game_info;       ///< The current game of the member
         MacAddress mac_address;   ///< The assigned mac address of the member.
+        /// Connection quality of the member. Only the relayed WiFi packets count as sent.
+        NetworkStats network_stats;
     };
 
     Room();
@@ -165,6 +177,12 @@ public:
      */
     void Destroy();
 
+    /**
+     * Sets how often the network stats of every member are logged, zero disables this. Has to be
+     * called before the room is created.
+     */
+    void SetStatsLogInterval(std::chrono::seconds interval);
+
 private:
     class RoomImpl;
     std::unique_ptr<RoomImpl> room_impl;
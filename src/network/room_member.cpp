@@ -4,12 +4,18 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <list>
+#include <map>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <thread>
 #include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
 #include "enet/enet.h"
+#include "network/network_settings.h"
 #include "network/packet.h"
 #include "network/room_member.h"
 
@@ -17,6 +23,20 @@ namespace Network {
 
 constexpr u32 ConnectionTimeoutMs = 5000;
 
+/// Batches with at least this many bytes of frames are compressed
+constexpr std::size_t BatchCompressionThreshold = 512;
+/// Fast, the frames are compressed on the member thread right before sending
+constexpr s32 BatchCompressionLevel = 1;
+/// Upper bound for the uncompressed frames of a received batch
+constexpr u32 MaxBatchSize = 0x100000;
+/// Batch flag set when the frames are compressed with zstd
+constexpr u8 BatchFlagCompressed = 1 << 0;
+/// Frame type used in batches for a beacon that equals the last full beacon of the transmitter
+constexpr u8 RepeatedBeaconType = 0xFF;
+/// A full beacon is sent at least this often (about once a second), so that members which
+/// joined or missed it still learn about the network
+constexpr u32 BeaconRefreshInterval = 10;
+
 class RoomMember::RoomMemberImpl {
 public:
     ENetHost* client = nullptr; ///< ENet network interface.
@@ -47,6 +67,28 @@ public:
     std::unique_ptr<std::thread> loop_thread;
     std::mutex send_list_mutex;  ///< Mutex that controls access to the `send_list` variable.
     std::list<Packet> send_list; ///< A list that stores all packets to send the async
+    /// WifiPackets to send with the next batch, also protected by `send_list_mutex`
+    std::list<WifiPacket> wifi_send_list;
+
+    /// Last beacon that was sent in full, and how many repeats of it were sent since. Both are
+    /// only used by the member loop.
+    std::optional<WifiPacket> last_sent_beacon;
+    u32 repeated_beacons = 0;
+    /// Last full beacon received from each transmitter, used to expand repeated beacons
+    std::map<MacAddress, std::vector<u8>> last_received_beacons;
+
+    /// Quality of the connection to the room
+    NetworkStatsCollector network_stats;
+
+    /// Host for direct connections to other members, only created when they are enabled. It is
+    /// only used by the member loop, like everything below.
+    ENetHost* direct_host = nullptr;
+    /// Endpoints of the members that accept direct connections, as seen by the room
+    std::map<MacAddress, ENetAddress> direct_endpoints;
+    /// Connections that were started to the members, but did not say hello yet
+    std::map<MacAddress, ENetPeer*> direct_connecting;
+    /// Connections to the members that said hello, WifiPackets to them skip the room
+    std::map<MacAddress, ENetPeer*> direct_peers;
 
     template <typename T>
     using CallbackSet = std::set<CallbackHandle<T>>;
@@ -78,6 +120,13 @@ public:
      */
     void Send(Packet&& packet);
 
+    /**
+     * Sends the queued WifiPackets. Consecutive packets with the same destination are sent as one
+     * batch, which is compressed when it is large, and repeated beacons are shortened.
+     * @param packets The packets to send
+     */
+    void SendWifiPackets(const std::list<WifiPacket>& packets);
+
     /**
      * Sends a request to the server, asking for permission to join a room with the specified
      * nickname and preferred mac.
@@ -105,8 +154,19 @@ public:
     /**
      * Extracts a WifiPacket from a received ENet packet.
      * @param event The  ENet event that was received.
+     * @param sender MAC address a direct connection said hello with, its frames have to be
+     * transmitted from it. Not set for the packets relayed by the room.
+     */
+    void HandleWifiPackets(const ENetEvent* event,
+                           std::optional<MacAddress> sender = std::nullopt);
+
+    /**
+     * Extracts the WifiPackets of a batch from a received ENet packet.
+     * @param event The ENet event that was received.
+     * @param sender As for HandleWifiPackets.
      */
-    void HandleWifiPackets(const ENetEvent* event);
+    void HandleWifiPacketBatch(const ENetEvent* event,
+                               std::optional<MacAddress> sender = std::nullopt);
 
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
@@ -127,6 +187,42 @@ public:
      */
     void HandleModBanListResponsePacket(const ENetEvent* event);
 
+    /**
+     * Creates the host for the direct connections and tells the room its port.
+     */
+    void StartDirectConnections();
+
+    /**
+     * Connects to the members listed in a received ENet packet, and drops the direct connections
+     * to members that are not listed anymore.
+     * @param event The ENet event that was received.
+     */
+    void HandleDirectEndpointsPacket(const ENetEvent* event);
+
+    /**
+     * Receives the events of the direct connections and dispatches their WifiPackets.
+     * @param timeout_ms How long to wait for the first event
+     */
+    void ServiceDirectConnections(u32 timeout_ms);
+
+    /**
+     * Checks the MAC address sent over a new direct connection against the endpoints listed by
+     * the room, and uses the connection for that member if they match.
+     * @param event The ENet event that was received.
+     */
+    void HandleDirectHelloPacket(const ENetEvent* event);
+
+    /**
+     * Forgets a direct connection after it was closed or reset.
+     * @param peer The peer of the connection
+     */
+    void RemoveDirectPeer(const ENetPeer* peer);
+
+    /**
+     * Closes all direct connections and destroys their host.
+     */
+    void StopDirectConnections();
+
     /**
      * Disconnects the RoomMember from the Room
      */
@@ -156,17 +252,25 @@ bool RoomMember::RoomMemberImpl::IsConnected() const {
 }
 
 void RoomMember::RoomMemberImpl::MemberLoop() {
+    using Clock = std::chrono::steady_clock;
+    auto last_stats_sample = Clock::now();
     // Receive packets while the connection is open
     while (IsConnected()) {
         std::lock_guard lock(network_mutex);
+        // The direct connections are serviced as well, neither host may block the other for long
+        const u32 service_timeout_ms = direct_host ? 1 : 16;
         ENetEvent event;
-        if (enet_host_service(client, &event, 16) > 0) {
+        if (enet_host_service(client, &event, service_timeout_ms) > 0) {
             switch (event.type) {
             case ENET_EVENT_TYPE_RECEIVE:
+                network_stats.AddReceived(event.packet->dataLength);
                 switch (event.packet->data[0]) {
                 case IdWifiPacket:
                     HandleWifiPackets(&event);
                     break;
+                case IdWifiPacketBatch:
+                    HandleWifiPacketBatch(&event);
+                    break;
                 case IdChatMessage:
                     HandleChatPacket(&event);
                     break;
@@ -176,6 +280,9 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
                 case IdRoomInformation:
                     HandleRoomInformationPacket(&event);
                     break;
+                case IdDirectEndpoints:
+                    HandleDirectEndpointsPacket(&event);
+                    break;
                 case IdJoinSuccess:
                 case IdJoinSuccessAsMod:
                     // The join request was successful, we are now in the room.
@@ -188,6 +295,9 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
                     } else {
                         SetState(State::Joined);
                     }
+                    if (NetSettings::values.enable_direct_connections && !direct_host) {
+                        StartDirectConnections();
+                    }
                     break;
                 case IdModBanListResponse:
                     HandleModBanListResponsePacket(&event);
@@ -252,18 +362,35 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
                 break;
             }
         }
+        if (direct_host) {
+            ServiceDirectConnections(service_timeout_ms);
+        }
 
         std::list<Packet> packets;
+        std::list<WifiPacket> wifi_packets;
         {
             std::lock_guard lock(send_list_mutex);
             packets.swap(send_list);
+            wifi_packets.swap(wifi_send_list);
         }
         for (const auto& packet : packets) {
             ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
                                                         ENET_PACKET_FLAG_RELIABLE);
+            network_stats.AddSent(packet.GetDataSize());
             enet_peer_send(server, 0, enetPacket);
         }
+        // Everything queued since the last iteration, about one frame, is batched
+        SendWifiPackets(wifi_packets);
         enet_host_flush(client);
+        if (direct_host) {
+            enet_host_flush(direct_host);
+        }
+
+        if (const auto now = Clock::now(); now - last_stats_sample >= std::chrono::seconds{1}) {
+            network_stats.Sample(server->roundTripTime, server->roundTripTimeVariance,
+                                 server->packetLoss);
+            last_stats_sample = now;
+        }
     }
     Disconnect();
 };
@@ -277,6 +404,95 @@ void RoomMember::RoomMemberImpl::Send(Packet&& packet) {
     send_list.push_back(std::move(packet));
 }
 
+void RoomMember::RoomMemberImpl::SendWifiPackets(const std::list<WifiPacket>& packets) {
+    const auto send = [this](const Packet& packet, ENetPeer* direct_peer) {
+        ENetPacket* enet_packet = enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                                                     ENET_PACKET_FLAG_RELIABLE);
+        if (direct_peer) {
+            enet_peer_send(direct_peer, 0, enet_packet);
+            return;
+        }
+        network_stats.AddSent(packet.GetDataSize());
+        enet_peer_send(server, 0, enet_packet);
+    };
+
+    auto it = packets.begin();
+    while (it != packets.end()) {
+        const WifiPacket& first = *it;
+        // Broadcasts, and so all beacons, are always relayed by the room
+        const auto direct_peer = direct_peers.find(first.destination_address);
+        ENetPeer* const peer = direct_peer != direct_peers.end() ? direct_peer->second : nullptr;
+        Packet frames;
+        u32 num_frames = 0;
+        bool has_repeated_beacon = false;
+        for (; it != packets.end() && it->destination_address == first.destination_address &&
+               it->transmitter_address == first.transmitter_address;
+             ++it) {
+            const WifiPacket& wifi_packet = *it;
+            bool is_repeated_beacon = false;
+            if (wifi_packet.type == WifiPacket::PacketType::Beacon) {
+                is_repeated_beacon = last_sent_beacon && repeated_beacons < BeaconRefreshInterval &&
+                                     last_sent_beacon->channel == wifi_packet.channel &&
+                                     last_sent_beacon->data == wifi_packet.data;
+                if (is_repeated_beacon) {
+                    repeated_beacons++;
+                } else {
+                    last_sent_beacon = wifi_packet;
+                    repeated_beacons = 0;
+                }
+            }
+            has_repeated_beacon |= is_repeated_beacon;
+
+            if (is_repeated_beacon) {
+                frames << RepeatedBeaconType;
+                frames << wifi_packet.channel;
+                frames << u32{0};
+            } else {
+                frames << static_cast<u8>(wifi_packet.type);
+                frames << wifi_packet.channel;
+                frames << wifi_packet.data;
+            }
+            num_frames++;
+        }
+
+        // A lone frame is sent as is, batching it would only add overhead
+        if (num_frames == 1 && !has_repeated_beacon) {
+            Packet packet;
+            packet << static_cast<u8>(IdWifiPacket);
+            packet << static_cast<u8>(first.type);
+            packet << first.channel;
+            packet << first.transmitter_address;
+            packet << first.destination_address;
+            packet << first.data;
+            send(packet, peer);
+            continue;
+        }
+
+        const auto* frames_data = static_cast<const u8*>(frames.GetData());
+        std::vector<u8> compressed;
+        if (frames.GetDataSize() >= BatchCompressionThreshold) {
+            compressed = Common::Compression::CompressDataZSTD(frames_data, frames.GetDataSize(),
+                                                               BatchCompressionLevel);
+        }
+        const bool is_compressed = !compressed.empty() && compressed.size() < frames.GetDataSize();
+
+        Packet packet;
+        packet << static_cast<u8>(IdWifiPacketBatch);
+        packet << static_cast<u8>(is_compressed ? BatchFlagCompressed : 0);
+        packet << u8{0}; // Unused, keeps the addresses where the room reads them
+        packet << first.transmitter_address;
+        packet << first.destination_address;
+        packet << num_frames;
+        packet << static_cast<u32>(frames.GetDataSize());
+        if (is_compressed) {
+            packet.Append(compressed.data(), compressed.size());
+        } else {
+            packet.Append(frames_data, frames.GetDataSize());
+        }
+        send(packet, peer);
+    }
+}
+
 void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
                                                  const std::string& console_id_hash,
                                                  const MacAddress& preferred_mac,
@@ -334,6 +550,8 @@ void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* ev
             }
         }
     }
+    // Members that just joined need the full beacon
+    last_sent_beacon.reset();
     Invoke(room_information);
 }
 
@@ -348,7 +566,8 @@ void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
     packet >> mac_address;
 }
 
-void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
+void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event,
+                                                   std::optional<MacAddress> sender) {
     WifiPacket wifi_packet{};
     Packet packet;
     packet.Append(event->packet->data, event->packet->dataLength);
@@ -367,9 +586,99 @@ void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
     packet >> wifi_packet.destination_address;
     packet >> wifi_packet.data;
 
+    if (sender && wifi_packet.transmitter_address != *sender) {
+        LOG_WARNING(Network, "Ignoring a direct WifiPacket sent for another member");
+        return;
+    }
+    if (type == WifiPacket::PacketType::Beacon) {
+        last_received_beacons[wifi_packet.transmitter_address] = wifi_packet.data;
+    }
     Invoke<WifiPacket>(wifi_packet);
 }
 
+void RoomMember::RoomMemberImpl::HandleWifiPacketBatch(const ENetEvent* event,
+                                                       std::optional<MacAddress> sender) {
+    Packet packet;
+    packet.Append(event->packet->data, event->packet->dataLength);
+
+    // Ignore the first byte, which is the message id.
+    packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+
+    u8 flags;
+    packet >> flags;
+    packet.IgnoreBytes(sizeof(u8)); // Unused
+    MacAddress transmitter_address;
+    packet >> transmitter_address;
+    MacAddress destination_address;
+    packet >> destination_address;
+    u32 num_frames;
+    packet >> num_frames;
+    u32 frames_size;
+    packet >> frames_size;
+    if (!packet || frames_size > MaxBatchSize) {
+        LOG_ERROR(Network, "Received an invalid WifiPacket batch");
+        return;
+    }
+    if (sender && transmitter_address != *sender) {
+        LOG_WARNING(Network, "Ignoring a direct WifiPacket batch sent for another member");
+        return;
+    }
+
+    // The frames follow the message type, flags, unused byte, addresses, count and size
+    constexpr std::size_t header_size = 3 * sizeof(u8) + 2 * sizeof(MacAddress) + 2 * sizeof(u32);
+    const u8* payload = event->packet->data + header_size;
+    const std::size_t payload_size = event->packet->dataLength - header_size;
+    Packet frames;
+    if (flags & BatchFlagCompressed) {
+        std::vector<u8> decompressed(frames_size);
+        if (!Common::Compression::DecompressDataZSTD(payload, payload_size, decompressed.data(),
+                                                     decompressed.size())) {
+            LOG_ERROR(Network, "Could not decompress a WifiPacket batch");
+            return;
+        }
+        frames.Append(decompressed.data(), decompressed.size());
+    } else {
+        frames.Append(payload, payload_size);
+    }
+
+    for (u32 i = 0; i < num_frames; ++i) {
+        u8 frame_type;
+        frames >> frame_type;
+        WifiPacket wifi_packet{};
+        frames >> wifi_packet.channel;
+        u32 data_size;
+        frames >> data_size;
+        if (!frames || data_size > frames_size) {
+            LOG_ERROR(Network, "Received a truncated WifiPacket batch");
+            return;
+        }
+        wifi_packet.transmitter_address = transmitter_address;
+        wifi_packet.destination_address = destination_address;
+
+        if (frame_type == RepeatedBeaconType) {
+            const auto beacon = last_received_beacons.find(transmitter_address);
+            if (beacon == last_received_beacons.end()) {
+                // The full beacon was missed, the next refresh will carry it
+                continue;
+            }
+            wifi_packet.type = WifiPacket::PacketType::Beacon;
+            wifi_packet.data = beacon->second;
+        } else {
+            wifi_packet.type = static_cast<WifiPacket::PacketType>(frame_type);
+            wifi_packet.data.resize(data_size);
+            frames.Read(wifi_packet.data.data(), data_size);
+            if (!frames) {
+                LOG_ERROR(Network, "Received a truncated WifiPacket batch");
+                return;
+            }
+            if (wifi_packet.type == WifiPacket::PacketType::Beacon) {
+                last_received_beacons[transmitter_address] = wifi_packet.data;
+            }
+        }
+        Invoke<WifiPacket>(wifi_packet);
+    }
+}
+
 void RoomMember::RoomMemberImpl::HandleChatPacket(const ENetEvent* event) {
     Packet packet;
     packet.Append(event->packet->data, event->packet->dataLength);
@@ -414,8 +723,185 @@ void RoomMember::RoomMemberImpl::HandleModBanListResponsePacket(const ENetEvent*
     Invoke<Room::BanList>(ban_list);
 }
 
+void RoomMember::RoomMemberImpl::StartDirectConnections() {
+    ENetAddress address{};
+    address.host = ENET_HOST_ANY;
+    address.port = 0; // Any free port, the room tells the others which one
+    direct_host = enet_host_create(&address, MaxConcurrentConnections, NumChannels, 0, 0);
+    if (!direct_host) {
+        LOG_WARNING(Network, "Could not create the host for direct connections");
+        return;
+    }
+
+    Packet packet;
+    packet << static_cast<u8>(IdDirectEndpoint);
+    packet << direct_host->address.port;
+    Send(std::move(packet));
+}
+
+void RoomMember::RoomMemberImpl::HandleDirectEndpointsPacket(const ENetEvent* event) {
+    if (!direct_host) {
+        return;
+    }
+
+    Packet packet;
+    packet.Append(event->packet->data, event->packet->dataLength);
+
+    // Ignore the first byte, which is the message id.
+    packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+
+    u32 num_endpoints;
+    packet >> num_endpoints;
+    std::map<MacAddress, ENetAddress> endpoints;
+    for (u32 i = 0; i < num_endpoints && packet; ++i) {
+        MacAddress member_mac;
+        ENetAddress address{};
+        packet >> member_mac;
+        packet >> address.host;
+        packet >> address.port;
+        if (member_mac != mac_address) {
+            endpoints.emplace(member_mac, address);
+        }
+    }
+    if (!packet) {
+        LOG_ERROR(Network, "Received an invalid list of direct endpoints");
+        return;
+    }
+
+    // Members that left or moved are reached through the room again
+    for (auto* connections : {&direct_connecting, &direct_peers}) {
+        for (auto it = connections->begin(); it != connections->end();) {
+            const auto endpoint = endpoints.find(it->first);
+            if (endpoint == endpoints.end() ||
+                endpoint->second.host != it->second->address.host) {
+                enet_peer_reset(it->second);
+                it = connections->erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    direct_endpoints = std::move(endpoints);
+
+    // Both members connect to each other at the same time, which gets the packets through most
+    // NATs that keep the port of a mapping
+    for (const auto& [member_mac, address] : direct_endpoints) {
+        if (direct_peers.contains(member_mac) || direct_connecting.contains(member_mac)) {
+            continue;
+        }
+        if (ENetPeer* peer = enet_host_connect(direct_host, &address, NumChannels, 0)) {
+            direct_connecting.emplace(member_mac, peer);
+        }
+    }
+}
+
+void RoomMember::RoomMemberImpl::ServiceDirectConnections(u32 timeout_ms) {
+    ENetEvent event;
+    while (enet_host_service(direct_host, &event, timeout_ms) > 0) {
+        timeout_ms = 0;
+        switch (event.type) {
+        case ENET_EVENT_TYPE_CONNECT: {
+            // Our MAC address is only told to the members that the room listed
+            const bool is_listed = std::any_of(
+                direct_endpoints.begin(), direct_endpoints.end(), [&event](const auto& endpoint) {
+                    return endpoint.second.host == event.peer->address.host;
+                });
+            if (!is_listed) {
+                enet_peer_reset(event.peer);
+                RemoveDirectPeer(event.peer);
+                break;
+            }
+            Packet packet;
+            packet << static_cast<u8>(IdDirectHello);
+            packet << mac_address;
+            enet_peer_send(event.peer, 0,
+                           enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                                              ENET_PACKET_FLAG_RELIABLE));
+            break;
+        }
+        case ENET_EVENT_TYPE_RECEIVE: {
+            if (event.packet->dataLength == 0) {
+                enet_packet_destroy(event.packet);
+                break;
+            }
+            const auto direct_peer = std::find_if(
+                direct_peers.begin(), direct_peers.end(),
+                [&event](const auto& connection) { return connection.second == event.peer; });
+            const bool is_known = direct_peer != direct_peers.end();
+            switch (event.packet->data[0]) {
+            case IdDirectHello:
+                HandleDirectHelloPacket(&event);
+                break;
+            // WifiPackets are only taken from members that said hello, and only as sent by them
+            case IdWifiPacket:
+                if (is_known) {
+                    HandleWifiPackets(&event, direct_peer->first);
+                }
+                break;
+            case IdWifiPacketBatch:
+                if (is_known) {
+                    HandleWifiPacketBatch(&event, direct_peer->first);
+                }
+                break;
+            }
+            enet_packet_destroy(event.packet);
+            break;
+        }
+        case ENET_EVENT_TYPE_DISCONNECT:
+            RemoveDirectPeer(event.peer);
+            break;
+        case ENET_EVENT_TYPE_NONE:
+            break;
+        }
+    }
+}
+
+void RoomMember::RoomMemberImpl::HandleDirectHelloPacket(const ENetEvent* event) {
+    Packet packet;
+    packet.Append(event->packet->data, event->packet->dataLength);
+
+    // Ignore the first byte, which is the message id.
+    packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+
+    MacAddress member_mac;
+    packet >> member_mac;
+    const auto endpoint = direct_endpoints.find(member_mac);
+    if (!packet || endpoint == direct_endpoints.end() ||
+        endpoint->second.host != event->peer->address.host) {
+        LOG_WARNING(Network, "Ignoring a direct connection from an unknown member");
+        enet_peer_reset(event->peer);
+        RemoveDirectPeer(event->peer);
+        return;
+    }
+
+    // When both connections go through, the first one that says hello is kept
+    if (!direct_peers.contains(member_mac)) {
+        direct_peers.emplace(member_mac, event->peer);
+    }
+}
+
+void RoomMember::RoomMemberImpl::RemoveDirectPeer(const ENetPeer* peer) {
+    for (auto* connections : {&direct_connecting, &direct_peers}) {
+        std::erase_if(*connections,
+                      [peer](const auto& connection) { return connection.second == peer; });
+    }
+}
+
+void RoomMember::RoomMemberImpl::StopDirectConnections() {
+    direct_endpoints.clear();
+    direct_connecting.clear();
+    direct_peers.clear();
+    if (direct_host) {
+        enet_host_destroy(direct_host);
+        direct_host = nullptr;
+    }
+}
+
 void RoomMember::RoomMemberImpl::Disconnect() {
+    StopDirectConnections();
     member_information.clear();
+    last_sent_beacon.reset();
+    last_received_beacons.clear();
     room_information.member_slots = 0;
     room_information.name.clear();
 
@@ -572,6 +1058,7 @@ void RoomMember::Join(const std::string& nick, const std::string& console_id_has
     int net = enet_host_service(room_member_impl->client, &event, ConnectionTimeoutMs);
     if (net > 0 && event.type == ENET_EVENT_TYPE_CONNECT) {
         room_member_impl->nickname = nick;
+        room_member_impl->network_stats.Reset();
         room_member_impl->StartLoop();
         room_member_impl->SendJoinRequest(nick, console_id_hash, preferred_mac, password, token);
         SendGameInfo(room_member_impl->current_game_info);
@@ -586,15 +1073,13 @@ bool RoomMember::IsConnected() const {
     return room_member_impl->IsConnected();
 }
 
+NetworkStats RoomMember::GetNetworkStats() const {
+    return room_member_impl->network_stats.Get();
+}
+
 void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
-    Packet packet;
-    packet << static_cast<u8>(IdWifiPacket);
-    packet << static_cast<u8>(wifi_packet.type);
-    packet << wifi_packet.channel;
-    packet << wifi_packet.transmitter_address;
-    packet << wifi_packet.destination_address;
-    packet << wifi_packet.data;
-    room_member_impl->Send(std::move(packet));
+    std::lock_guard lock(room_member_impl->send_list_mutex);
+    room_member_impl->wifi_send_list.push_back(wifi_packet);
 }
 
 void RoomMember::SendChatMessage(const std::string& message) {
@@ -156,6 +156,11 @@ public:
      */
     bool IsConnected() const;
 
+    /**
+     * Returns the quality of the connection to the room since it was joined.
+     */
+    NetworkStats GetNetworkStats() const;
+
     /**
      * Attempts to join a room at the specified address and port, using the specified nickname.
      * A console ID hash is passed in to check console ID conflicts.
@@ -0,0 +1,64 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/codec.h"
+#include "tests/test_data.h"
+
+using namespace AudioCore;
+
+TEST_CASE("Codec: PCM samples are widened to stereo", "[audio_core]") {
+    const std::vector<u8> data{0x01, 0x80, 0xFF, 0x7F};
+
+    const StereoBuffer16 pcm8_mono = Codec::DecodePCM8(1, data.data(), 4);
+    REQUIRE(pcm8_mono.size() == 4);
+    REQUIRE(pcm8_mono[1] == std::array<s16, 2>{-0x8000, -0x8000});
+    REQUIRE(pcm8_mono[3] == std::array<s16, 2>{0x7F00, 0x7F00});
+
+    const StereoBuffer16 pcm8_stereo = Codec::DecodePCM8(2, data.data(), 2);
+    REQUIRE(pcm8_stereo[0] == std::array<s16, 2>{0x0100, -0x8000});
+    REQUIRE(pcm8_stereo[1] == std::array<s16, 2>{-0x0100, 0x7F00});
+
+    const StereoBuffer16 pcm16_mono = Codec::DecodePCM16(1, data.data(), 2);
+    REQUIRE(pcm16_mono[0] == std::array<s16, 2>{-0x7FFF, -0x7FFF});
+    REQUIRE(pcm16_mono[1] == std::array<s16, 2>{0x7FFF, 0x7FFF});
+
+    const StereoBuffer16 pcm16_stereo = Codec::DecodePCM16(2, data.data(), 1);
+    REQUIRE(pcm16_stereo[0] == std::array<s16, 2>{-0x7FFF, 0x7FFF});
+}
+
+TEST_CASE("Codec: Buffered and in place decoding match", "[audio_core]") {
+    // Long enough to cross several of the chunks the buffered variants decode at a time
+    constexpr std::size_t SampleCount = 2001;
+    const std::vector<u8> data = Tests::MakeTestData(SampleCount * 4);
+    std::vector<std::array<s16, 2>> output(SampleCount + 1);
+
+    for (const unsigned num_channels : {1u, 2u}) {
+        const StereoBuffer16 pcm8 = Codec::DecodePCM8(num_channels, data.data(), SampleCount);
+        Codec::DecodePCM8(num_channels, data.data(), {output.data(), SampleCount});
+        REQUIRE(std::equal(pcm8.begin(), pcm8.end(), output.begin(), output.end() - 1));
+
+        const StereoBuffer16 pcm16 = Codec::DecodePCM16(num_channels, data.data(), SampleCount);
+        Codec::DecodePCM16(num_channels, data.data(), {output.data(), SampleCount});
+        REQUIRE(std::equal(pcm16.begin(), pcm16.end(), output.begin(), output.end() - 1));
+    }
+
+    std::array<s16, 16> coeffs;
+    for (std::size_t i = 0; i < coeffs.size(); i++) {
+        coeffs[i] = static_cast<s16>((i % 2 == 0 ? 0x800 : -0x400) + static_cast<int>(i) * 16);
+    }
+    Codec::ADPCMState buffered_state{100, -100};
+    Codec::ADPCMState in_place_state = buffered_state;
+
+    // Odd lengths decode one extra sample to keep the buffer a multiple of two
+    const StereoBuffer16 adpcm =
+        Codec::DecodeADPCM(data.data(), SampleCount, coeffs, buffered_state);
+    REQUIRE(adpcm.size() == SampleCount + 1);
+    Codec::DecodeADPCM(data.data(), coeffs, in_place_state, output);
+    REQUIRE(std::equal(adpcm.begin(), adpcm.end(), output.begin(), output.end()));
+    REQUIRE(buffered_state.yn1 == in_place_state.yn1);
+    REQUIRE(buffered_state.yn2 == in_place_state.yn2);
+}
@@ -0,0 +1,42 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/interpolate.h"
+
+using namespace AudioCore;
+
+TEST_CASE("AudioInterp::Polyphase: Unit rate passes samples through", "[audio_core]") {
+    AudioInterp::State state;
+    AudioInterp::StereoBuffer16 input;
+    for (s16 i = 0; i < 200; i++) {
+        input.push_back({static_cast<s16>(i * 100), static_cast<s16>(-i * 100)});
+    }
+
+    StereoFrame16 output{};
+    std::size_t outputi = 0;
+    AudioInterp::Polyphase(state, input, 1.0f, output, outputi);
+    REQUIRE(outputi == output.size());
+
+    // There is a two-sample predelay
+    for (std::size_t i = 2; i < output.size(); i++) {
+        REQUIRE(output[i][0] == static_cast<s16>((i - 2) * 100));
+        REQUIRE(output[i][1] == static_cast<s16>(-static_cast<int>(i - 2) * 100));
+    }
+}
+
+TEST_CASE("AudioInterp::Polyphase: Constant signals keep their level", "[audio_core]") {
+    AudioInterp::State state;
+    state.xn1 = state.xn2 = state.xn3 = {1000, -1000};
+    AudioInterp::StereoBuffer16 input(400, {1000, -1000});
+
+    StereoFrame16 output{};
+    std::size_t outputi = 0;
+    AudioInterp::Polyphase(state, input, 1.37f, output, outputi);
+    REQUIRE(outputi == output.size());
+    for (const auto& sample : output) {
+        REQUIRE(sample[0] == 1000);
+        REQUIRE(sample[1] == -1000);
+    }
+}
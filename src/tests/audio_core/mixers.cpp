@@ -0,0 +1,69 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include "audio_core/hle/mixers.h"
+
+using AudioCore::QuadFrame32;
+using AudioCore::samples_per_frame;
+using AudioCore::HLE::DspConfiguration;
+using AudioCore::HLE::IntermediateMixSamples;
+using AudioCore::HLE::Mixers;
+
+namespace {
+
+void SetVolume(DspConfiguration& config, float volume) {
+    config.volume_0_dirty.Assign(1);
+    config.volume_1_dirty.Assign(1);
+    config.volume_2_dirty.Assign(1);
+    for (auto& mix_volume : config.volume) {
+        mix_volume = volume;
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Mixers: Intermediate mixes are downmixed to stereo", "[audio_core]") {
+    Mixers mixers;
+    auto config = std::make_unique<DspConfiguration>();
+    SetVolume(*config, 1.0f);
+    const auto read_samples = std::make_unique<IntermediateMixSamples>();
+    auto write_samples = std::make_unique<IntermediateMixSamples>();
+
+    std::array<QuadFrame32, 3> input{};
+    input[0].fill({100, 200, 300, 400});
+    input[2].fill({32000, 32767, 0, 0});
+    mixers.Tick(*config, *read_samples, *write_samples, input);
+
+    const auto output = mixers.GetOutput();
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        REQUIRE(output[i][0] == 32400);
+        // The right channel saturates
+        REQUIRE(output[i][1] == 32767);
+    }
+}
+
+TEST_CASE("Mixers: Benchmark", "[.benchmark][audio_core]") {
+    Mixers mixers;
+    auto config = std::make_unique<DspConfiguration>();
+    SetVolume(*config, 0.5f);
+    const auto read_samples = std::make_unique<IntermediateMixSamples>();
+    auto write_samples = std::make_unique<IntermediateMixSamples>();
+
+    std::array<QuadFrame32, 3> input{};
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        const s32 value = static_cast<s32>(i * 400) - 32000;
+        for (auto& mix : input) {
+            mix[i] = {value, -value, value / 2, -value / 2};
+        }
+    }
+
+    BENCHMARK("Tick") {
+        mixers.Tick(*config, *read_samples, *write_samples, input);
+        return mixers.GetOutput()[0][0];
+    };
+}
@@ -0,0 +1,124 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/hle/frame_capture.h"
+#include "audio_core/hle/offline_renderer.h"
+#include "common/file_util.h"
+#include "core/memory.h"
+
+using namespace AudioCore;
+using namespace AudioCore::HLE;
+
+namespace {
+
+constexpr u32 NumSamples = 1000;
+constexpr std::size_t NumFrames = 32;
+
+using Configuration = SourceConfiguration::Configuration;
+
+/// Plays a looping mono PCM16 buffer on the first source, into the first intermediate mix
+void ConfigurePlayback(SharedMemory& read) {
+    Configuration& config = read.source_configurations.config[0];
+    config.enable = 1;
+    config.enable_dirty.Assign(1);
+    config.gain[0][0] = 1.0f;
+    config.gain[0][1] = 1.0f;
+    config.gain_0_dirty.Assign(1);
+    config.rate_multiplier = 0.75f;
+    config.rate_multiplier_dirty.Assign(1);
+    config.interpolation_mode = Configuration::InterpolationMode::Linear;
+    config.interpolation_dirty.Assign(1);
+    config.physical_address = Memory::FCRAM_PADDR;
+    config.length = NumSamples;
+    config.mono_or_stereo.Assign(Configuration::MonoOrStereo::Mono);
+    config.format.Assign(Configuration::Format::PCM16);
+    config.is_looping.Assign(1);
+    config.embedded_buffer_dirty.Assign(1);
+
+    DspConfiguration& dsp_config = read.dsp_configuration;
+    dsp_config.volume_0_dirty.Assign(1);
+    dsp_config.volume[0] = 1.0f;
+}
+
+/// Turns on a low-pass simple filter on the first source
+void ConfigureFilter(SharedMemory& read) {
+    Configuration& config = read.source_configurations.config[0];
+    config.simple_filter_enabled.Assign(1);
+    config.filters_enabled_dirty.Assign(1);
+    config.simple_filter.b0 = static_cast<s16>(0x2000);
+    config.simple_filter.a1 = static_cast<s16>(0x6000);
+    config.simple_filter_dirty.Assign(1);
+}
+
+void ClearDirty(SharedMemory& read) {
+    read.source_configurations.config[0].dirty_raw = 0;
+    read.dsp_configuration.dirty_raw = 0;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("OfflineRenderer: Captured frames replay to the captured output", "[audio_core]") {
+    Memory::MemorySystem memory;
+    u8* const samples = memory.GetFCRAMPointer(0);
+    for (u32 i = 0; i < NumSamples; i++) {
+        const s16 sample = static_cast<s16>(std::sin(i * 0.05) * 20000.0);
+        std::memcpy(samples + i * sizeof(s16), &sample, sizeof(s16));
+    }
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_dsp_capture_test.bin").string();
+    {
+        FrameCaptureWriter writer(path);
+        REQUIRE(writer.IsOpen());
+        OfflineRenderer renderer(memory);
+        renderer.SetCapture(&writer);
+
+        auto read = std::make_unique<SharedMemory>();
+        ConfigurePlayback(*read);
+        for (std::size_t i = 0; i < NumFrames; i++) {
+            if (i == NumFrames / 2) {
+                ConfigureFilter(*read);
+            }
+            const StereoFrame16 output = renderer.RenderFrame(*read);
+            REQUIRE(HashFrame(output) != HashFrame(StereoFrame16{}));
+            ClearDirty(*read);
+        }
+    }
+
+    // The capture has to bring back the samples the sources read
+    std::memset(samples, 0, NumSamples * sizeof(s16));
+
+    const std::vector<CapturedFrame> frames = LoadFrameCapture(path);
+    REQUIRE(frames.size() == NumFrames);
+    OfflineRenderer renderer(memory);
+    const OfflineRenderer::ReplayResult result = renderer.Replay(frames);
+    REQUIRE(result.num_frames == NumFrames);
+    REQUIRE(result.num_mismatches == 0);
+
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("OfflineRenderer: Benchmark", "[.benchmark][audio_core]") {
+    // Captures are made with the dump_dsp_frames setting
+    const char* const path = std::getenv("CITRA_DSP_CAPTURE");
+    if (!path) {
+        WARN("CITRA_DSP_CAPTURE is not set, nothing to replay");
+        return;
+    }
+    const std::vector<CapturedFrame> frames = LoadFrameCapture(path);
+    REQUIRE(!frames.empty());
+
+    Memory::MemorySystem memory;
+    OfflineRenderer renderer(memory);
+    const OfflineRenderer::ReplayResult result = renderer.Replay(frames);
+    WARN(result.num_frames << " frames replayed at " << result.frames_per_second
+                           << " frames per second");
+    REQUIRE(result.num_mismatches == 0);
+}
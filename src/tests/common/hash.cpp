@@ -0,0 +1,34 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+#include "common/hash.h"
+
+TEST_CASE("ComputeHash64: Every byte affects the hash", "[common]") {
+    std::vector<u8> data(256);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>(i);
+    }
+    const u64 hash = Common::ComputeHash64(data.data(), data.size());
+    REQUIRE(hash == Common::ComputeHash64(data.data(), data.size()));
+    for (std::size_t i = 0; i < data.size(); i += 37) {
+        data[i] ^= 1;
+        REQUIRE(hash != Common::ComputeHash64(data.data(), data.size()));
+        data[i] ^= 1;
+    }
+}
+
+TEST_CASE("ComputeHash64: Benchmark", "[.benchmark][common]") {
+    const std::vector<u8> data(1024 * 1024, 0x5A);
+
+    BENCHMARK("Hash 1 MiB") {
+        return Common::ComputeHash64(data.data(), data.size());
+    };
+    BENCHMARK("Hash 64 bytes") {
+        return Common::ComputeHash64(data.data(), 64);
+    };
+}
@@ -0,0 +1,86 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "common/zstd_compression.h"
+#include "tests/test_data.h"
+
+namespace {
+
+std::string GetTempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SeekableZSTD: Compressed files are read as their data", "[common]") {
+    constexpr std::size_t FrameSize = 0x10000;
+    const std::vector<u8> data = Tests::MakeCompressibleTestData(FrameSize * 9 + 0x1234);
+    const std::string plain_path = GetTempPath("citra_seekable_zstd_plain.bin");
+    const std::string compressed_path = GetTempPath("citra_seekable_zstd_compressed.bin");
+    FileUtil::IOFile(plain_path, "wb").WriteBytes(data.data(), data.size());
+    {
+        FileUtil::IOFile source(plain_path, "rb");
+        FileUtil::IOFile destination(compressed_path, "wb");
+        REQUIRE(Common::Compression::CompressSeekableZSTD(source, destination, 3, FrameSize));
+    }
+    REQUIRE(FileUtil::GetSize(compressed_path) < data.size());
+
+    FileUtil::IOFile file(compressed_path, "rb", FileUtil::IOFile::DecompressSeekable);
+    REQUIRE(file.IsOpen());
+    REQUIRE(file.IsDecompressed());
+    REQUIRE(file.GetSize() == data.size());
+
+    // Within a frame, across frames, whole frames and up to the end
+    const std::vector<std::pair<std::size_t, std::size_t>> ranges{
+        {0x100, 0x10},
+        {FrameSize - 8, 16},
+        {FrameSize * 2, FrameSize * 3},
+        {FrameSize * 3 + 5, FrameSize * 4},
+        {data.size() - 0x20, 0x100},
+    };
+    for (const auto& [offset, length] : ranges) {
+        std::vector<u8> result(length);
+        REQUIRE(file.Seek(offset, SEEK_SET));
+        const std::size_t expected_length = std::min(length, data.size() - offset);
+        REQUIRE(file.ReadBytes(result.data(), result.size()) == expected_length);
+        REQUIRE(file.Tell() == offset + expected_length);
+        REQUIRE(std::equal(result.begin(), result.begin() + expected_length,
+                           data.begin() + offset));
+        file.Clear();
+    }
+
+    // Decompressed files have nothing to map and can't be written
+    REQUIRE(!FileUtil::MappedFile(file).IsOpen());
+    REQUIRE(file.WriteBytes(data.data(), 1) == 0);
+    file.Close();
+
+    // Other files are read unchanged
+    FileUtil::IOFile plain(plain_path, "rb", FileUtil::IOFile::DecompressSeekable);
+    REQUIRE(!plain.IsDecompressed());
+    REQUIRE(plain.GetSize() == data.size());
+    plain.Close();
+
+    FileUtil::Delete(plain_path);
+    FileUtil::Delete(compressed_path);
+}
+
+TEST_CASE("ZSTD: Benchmark", "[.benchmark][common]") {
+    const std::vector<u8> data = Tests::MakeCompressibleTestData(4 * 1024 * 1024);
+    const std::vector<u8> compressed =
+        Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+
+    BENCHMARK("Compress 4 MiB") {
+        return Common::Compression::CompressDataZSTDDefault(data.data(), data.size()).size();
+    };
+    BENCHMARK("Decompress 4 MiB") {
+        return Common::Compression::DecompressDataZSTD(compressed).size();
+    };
+}
@@ -0,0 +1,62 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/core_timing.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+namespace {
+
+/// Counts r0 up to limit with a compare and branch pair, then spins on a branch to itself.
+void WriteCountingLoop(TestEnvironment& test_env, u32 cmp_instruction) {
+    test_env.SetMemory32(0x00, 0xE3A00000); // mov r0, #0
+    test_env.SetMemory32(0x04, 0xE2800001); // add r0, r0, #1
+    test_env.SetMemory32(0x08, cmp_instruction);
+    test_env.SetMemory32(0x0C, 0x1AFFFFFC); // bne #0x04
+    test_env.SetMemory32(0x10, 0xEAFFFFFE); // b +#0
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ARM_DynCom (block): linked branches", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    WriteCountingLoop(test_env, 0xE3500C01); // cmp r0, #0x100
+
+    auto timer = std::make_shared<Core::Timing::Timer>();
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE, 0, timer);
+
+    // Both outcomes of bne get linked on the first iterations, the rest go through the links.
+    dyncom.SetPC(0);
+    dyncom.Run();
+    REQUIRE(dyncom.GetReg(0) == 0x100);
+    REQUIRE(dyncom.GetPC() == 0x10);
+
+    // Stepping reuses the linked blocks but must still stop after every instruction.
+    dyncom.SetPC(0);
+    for (u32 i = 0; i < 5; ++i) {
+        dyncom.Step();
+    }
+    REQUIRE(dyncom.GetReg(0) == 2);
+    REQUIRE(dyncom.GetPC() == 0x08);
+}
+
+TEST_CASE("ARM_DynCom (block): Benchmark", "[.benchmark][arm_dyncom]") {
+    TestEnvironment test_env(false);
+    WriteCountingLoop(test_env, 0xE3500801); // cmp r0, #0x10000
+
+    auto timer = std::make_shared<Core::Timing::Timer>();
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE, 0, timer);
+
+    BENCHMARK("Counting loop") {
+        dyncom.SetPC(0);
+        dyncom.Run();
+        return dyncom.GetReg(0);
+    };
+}
+
+} // namespace ArmTests
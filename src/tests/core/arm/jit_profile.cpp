@@ -0,0 +1,57 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "core/arm/jit_profile.h"
+
+using Core::JitProfile;
+
+TEST_CASE("JitProfile: The default profile is accurate", "[core][arm]") {
+    REQUIRE(JitProfile{} == JitProfile::Accurate());
+
+    const JitProfile profile =
+        Core::ParseJitProfiles("0004000000030800 unsafe_inaccurate_nan=1\n", 0x0004000000030800);
+    REQUIRE(profile.unsafe_inaccurate_nan);
+    REQUIRE(!Core::ParseJitProfiles("", 0x0004000000030800).unsafe_inaccurate_nan);
+}
+
+TEST_CASE("JitProfile: Options are applied in order", "[core][arm]") {
+    JitProfile profile;
+    REQUIRE(Core::ParseJitProfileOptions(profile, "fastmem=0  unsafe_ignore_global_monitor=1"));
+    REQUIRE(!profile.fastmem);
+    REQUIRE(profile.unsafe_ignore_global_monitor);
+
+    REQUIRE(Core::ParseJitProfileOptions(profile, "accurate fastmem=0"));
+    JitProfile expected = JitProfile::Accurate();
+    expected.fastmem = false;
+    REQUIRE(profile == expected);
+}
+
+TEST_CASE("JitProfile: Invalid options are reported", "[core][arm]") {
+    JitProfile profile;
+    REQUIRE(!Core::ParseJitProfileOptions(profile, "block_linking=2 fast_dispatch=0"));
+    REQUIRE(!Core::ParseJitProfileOptions(profile, "no_such_option=1"));
+    REQUIRE(!Core::ParseJitProfileOptions(profile, "block_linking"));
+    REQUIRE(profile.block_linking);
+    REQUIRE(!profile.fast_dispatch);
+}
+
+TEST_CASE("JitProfile: Overrides only apply to their title", "[core][arm]") {
+    const std::string overrides = "# Comment\n"
+                                  "\n"
+                                  "0004000000030800 accurate\n"
+                                  "not_a_title_id fastmem=0\n"
+                                  "0004000000030700 fastmem=0\n"
+                                  "0004000000030800 return_stack_buffer=0\n";
+
+    JitProfile expected = JitProfile::Accurate();
+    expected.return_stack_buffer = false;
+    REQUIRE(Core::ParseJitProfiles(overrides, 0x0004000000030800) == expected);
+
+    expected = JitProfile{};
+    expected.fastmem = false;
+    REQUIRE(Core::ParseJitProfiles(overrides, 0x0004000000030700) == expected);
+
+    REQUIRE(Core::ParseJitProfiles(overrides, 0x0004000000030600) == JitProfile{});
+}
@@ -0,0 +1,64 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "core/arm/sharded_exclusive_monitor.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+TEST_CASE("ShardedExclusiveMonitor", "[core][arm]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.MapSharedPages(process->vm_manager);
+    memory.SetCurrentPageTable(process->vm_manager.page_table);
+
+    constexpr VAddr addr = Memory::SHARED_PAGE_VADDR;
+    Core::ShardedExclusiveMonitor monitor(memory, 2);
+
+    SECTION("a reserved write succeeds once") {
+        const u32 value = monitor.ExclusiveRead32(0, addr);
+        REQUIRE(monitor.ExclusiveWrite32(0, addr, value + 1));
+        REQUIRE(memory.Read32(addr) == value + 1);
+        REQUIRE(!monitor.ExclusiveWrite32(0, addr, value + 2));
+        REQUIRE(memory.Read32(addr) == value + 1);
+    }
+
+    SECTION("a write of another core to the granule breaks the reservation") {
+        monitor.ExclusiveRead32(0, addr);
+        const u32 value = monitor.ExclusiveRead32(1, addr + 4);
+        REQUIRE(monitor.ExclusiveWrite32(1, addr + 4, value + 1));
+        REQUIRE(!monitor.ExclusiveWrite32(0, addr, 0));
+
+        const Core::ExclusiveMonitorStatistics stats = monitor.GetStatistics();
+        REQUIRE(stats.reads == 2);
+        REQUIRE(stats.writes == 2);
+        REQUIRE(stats.failed_writes == 1);
+        REQUIRE(stats.contended_writes == 1);
+    }
+
+    SECTION("reservations on other granules are kept") {
+        monitor.ExclusiveRead32(0, addr);
+        monitor.ExclusiveRead32(1, addr + 8);
+        REQUIRE(monitor.ExclusiveWrite32(1, addr + 8, 1));
+        REQUIRE(monitor.ExclusiveWrite32(0, addr, 2));
+    }
+
+    SECTION("plain stores and clears are false retries") {
+        const u32 value = monitor.ExclusiveRead32(0, addr);
+        memory.Write32(addr, value + 1);
+        REQUIRE(!monitor.ExclusiveWrite32(0, addr, value + 2));
+
+        monitor.ExclusiveRead32(0, addr);
+        monitor.ClearExclusive(0);
+        REQUIRE(!monitor.ExclusiveWrite32(0, addr, value + 2));
+
+        const Core::ExclusiveMonitorStatistics stats = monitor.GetStatistics();
+        REQUIRE(stats.failed_writes == 2);
+        REQUIRE(stats.contended_writes == 0);
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "core/clock_scaler.h"
+
+namespace {
+
+constexpr u64 FrameTicks = 4468724;
+
+struct Guest {
+    u64 ticks = 0;
+    u64 idle_ticks = 0;
+};
+
+/// Runs frames where the application core idles for `idle` of the frame
+u32 Run(Core::ClockScaler& scaler, Guest& guest, double idle, double host_load, u32 frames) {
+    u32 percentage = 0;
+    for (u32 frame = 0; frame < frames; frame++) {
+        guest.ticks += FrameTicks;
+        guest.idle_ticks += static_cast<u64>(FrameTicks * idle);
+        percentage = scaler.Update(guest.ticks, guest.idle_ticks, host_load);
+    }
+    return percentage;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ClockScaler: Busy guests get a faster clock while the host keeps up", "[core]") {
+    Core::ClockScaler scaler{100, 150};
+    Guest guest;
+    REQUIRE(scaler.GetPercentage() == 100);
+    REQUIRE(Run(scaler, guest, 0.0, 0.5, Core::ClockScaler::SettleFrames) == 110);
+    REQUIRE(Run(scaler, guest, 0.0, 0.5, Core::ClockScaler::SettleFrames - 1) == 110);
+    REQUIRE(Run(scaler, guest, 0.0, 0.5, 1000) == 150);
+}
+
+TEST_CASE("ClockScaler: The clock goes down when it isn't needed or can't be afforded",
+          "[core]") {
+    Core::ClockScaler scaler{100, 200};
+    Guest guest;
+    Run(scaler, guest, 0.0, 0.5, 1000);
+    REQUIRE(scaler.GetPercentage() == 200);
+
+    REQUIRE(Run(scaler, guest, 0.0, 1.5, 1000) == 100);
+
+    Run(scaler, guest, 0.0, 0.5, 1000);
+    REQUIRE(Run(scaler, guest, 0.5, 0.5, 1000) == 100);
+}
+
+TEST_CASE("ClockScaler: Stays put between the thresholds", "[core]") {
+    Core::ClockScaler idle_scaler{100, 200};
+    Guest idle_guest;
+    REQUIRE(Run(idle_scaler, idle_guest, 0.1, 0.5, 1000) == 100);
+
+    Core::ClockScaler loaded_scaler{100, 200};
+    Guest loaded_guest;
+    REQUIRE(Run(loaded_scaler, loaded_guest, 0.0, 0.95, 1000) == 100);
+}
+
+TEST_CASE("ClockScaler: Counters moving back are skipped", "[core]") {
+    Core::ClockScaler scaler{100, 200};
+    Guest guest;
+    Run(scaler, guest, 0.0, 0.5, 10);
+    guest = {};
+    REQUIRE(scaler.Update(0, 0, 0.5) == 100);
+    REQUIRE(Run(scaler, guest, 0.0, 0.5, 1000) == 200);
+}
@@ -2,11 +2,14 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include <array>
 #include <bitset>
 #include <string>
+#include <thread>
+#include <vector>
 #include "common/file_util.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -196,4 +199,104 @@ TEST_CASE("CoreTiming[ChainScheduling]", "[core]") {
     REQUIRE(MAX_SLICE_LENGTH == timing.GetTimer(0)->GetDowncount());
 }
 
+TEST_CASE("CoreTiming[ThreadsafeScheduling]", "[core]") {
+    constexpr int NUM_THREADS = 4;
+    constexpr int EVENTS_PER_THREAD = 1000;
+
+    Core::Timing timing(1, 100);
+
+    int fired = 0;
+    Core::TimingEventType* cb =
+        timing.RegisterEvent("callback", [&fired](std::uintptr_t user_data, s64 cycles_late) {
+            REQUIRE(user_data < NUM_THREADS);
+            REQUIRE(0 == cycles_late);
+            ++fired;
+        });
+
+    // Enter slice 0
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&timing, cb, i] {
+            for (int j = 0; j < EVENTS_PER_THREAD; ++j) {
+                timing.ScheduleEventThreadsafe(100, cb, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The events are only picked up at the end of the slice and counted from there
+    timing.GetTimer(0)->AddTicks(timing.GetTimer(0)->GetDowncount());
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+    REQUIRE(0 == fired);
+    REQUIRE(100 == timing.GetTimer(0)->GetDowncount());
+
+    timing.GetTimer(0)->AddTicks(timing.GetTimer(0)->GetDowncount());
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+    REQUIRE(NUM_THREADS * EVENTS_PER_THREAD == fired);
+    REQUIRE(MAX_SLICE_LENGTH == timing.GetTimer(0)->GetDowncount());
+}
+
+TEST_CASE("CoreTiming[CrossCoreScheduling]", "[core]") {
+    Core::Timing timing(2, 100);
+
+    Core::TimingEventType* cb = timing.RegisterEvent("callback", CallbackTemplate<0>);
+
+    // Enter slice 0 on both cores
+    for (std::size_t core = 0; core < 2; ++core) {
+        timing.GetTimer(core)->Advance();
+        timing.GetTimer(core)->SetNextSlice();
+    }
+
+    // Core 0 is further ahead than core 1, the delay is counted from the time of core 0
+    timing.GetTimer(0)->AddTicks(1000);
+    timing.ScheduleEvent(500, cb, CB_IDS[0], 1);
+
+    timing.SetCurrentTimer(1);
+    timing.GetTimer(1)->Advance();
+    timing.GetTimer(1)->SetNextSlice();
+    REQUIRE(1500 == timing.GetTimer(1)->GetDowncount());
+
+    callbacks_ran_flags = 0;
+    expected_callback = CB_IDS[0];
+    lateness = 0;
+    timing.GetTimer(1)->AddTicks(timing.GetTimer(1)->GetDowncount());
+    timing.GetTimer(1)->Advance();
+    REQUIRE(callbacks_ran_flags.test(0));
+}
+
+static int benchmark_fired = 0;
+
+static void BenchmarkCallback(std::uintptr_t, s64) {
+    ++benchmark_fired;
+}
+
+TEST_CASE("CoreTiming: Benchmark", "[.benchmark][core]") {
+    constexpr int NUM_EVENTS = 256;
+    Core::Timing timing(1, 100);
+    Core::TimingEventType* cb = timing.RegisterEvent("benchmark", BenchmarkCallback);
+    auto timer = timing.GetTimer(0);
+    timer->Advance();
+    timer->SetNextSlice();
+
+    BENCHMARK("Schedule and run 256 events") {
+        benchmark_fired = 0;
+        for (int i = 0; i < NUM_EVENTS; i++) {
+            timing.ScheduleEvent(16 * (i % 32 + 1), cb, i);
+        }
+        while (benchmark_fired < NUM_EVENTS) {
+            timer->AddTicks(timer->GetDowncount());
+            timer->Advance();
+            timer->SetNextSlice();
+        }
+        return benchmark_fired;
+    };
+}
+
 // TODO: Add tests for multiple timers
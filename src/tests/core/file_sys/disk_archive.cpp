@@ -0,0 +1,171 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "core/file_sys/disk_archive.h"
+
+namespace {
+
+std::vector<u8> ReadHostFile(const std::string& path) {
+    std::vector<u8> data(FileUtil::GetSize(path));
+    FileUtil::IOFile(path, "rb").ReadBytes(data.data(), data.size());
+    return data;
+}
+
+u64 GetListedSize(const std::string& path) {
+    FileSys::DiskDirectory directory(path);
+    FileSys::Entry entry{};
+    REQUIRE(directory.Read(1, &entry) == 1);
+    return entry.file_size;
+}
+
+u32 CountEntries(const std::string& path) {
+    FileSys::DiskDirectory directory(path);
+    std::vector<FileSys::Entry> entries(16);
+    return directory.Read(static_cast<u32>(entries.size()), entries.data());
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DiskFile: Writes are held until the guest flushes", "[core][file_sys]") {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_disk_file_test.bin").string();
+    const std::vector<u8> initial(0x100, 0xAA);
+    FileUtil::IOFile(path, "wb").WriteBytes(initial.data(), initial.size());
+
+    FileSys::Mode mode{};
+    mode.read_flag.Assign(1);
+    mode.write_flag.Assign(1);
+    FileSys::DiskFile file(FileUtil::IOFile(path, "r+b"), mode, nullptr);
+
+    // Small writes that overlap, touch and extend the file, written in no particular order
+    std::vector<u8> expected = initial;
+    expected.resize(0x180);
+    const auto write = [&](u64 offset, std::size_t length, u8 value) {
+        const std::vector<u8> data(length, value);
+        REQUIRE(*file.Write(offset, length, false, data.data()) == length);
+        std::fill(expected.begin() + offset, expected.begin() + offset + length, value);
+    };
+    write(0x20, 0x10, 1);
+    write(0x40, 0x10, 2);
+    write(0x28, 0x20, 3);
+    write(0x50, 0x08, 4);
+    write(0x10, 0x90, 5);
+    write(0x170, 0x10, 6);
+    write(0x08, 0x04, 7);
+
+    // Nothing reached the host file yet, but reads see the writes and the zeroes before 0x170
+    REQUIRE(ReadHostFile(path) == initial);
+    REQUIRE(file.GetSize() == expected.size());
+    std::vector<u8> result(0x200);
+    REQUIRE(*file.Read(0, result.size(), result.data()) == expected.size());
+    result.resize(expected.size());
+    REQUIRE(result == expected);
+
+    REQUIRE(file.Flush());
+    REQUIRE(ReadHostFile(path) == expected);
+
+    // Writes that ask for a flush are on the host file once they return
+    write(0x100, 0x10, 8);
+    REQUIRE(*file.Write(0x110, 0x10, true, expected.data() + 0x110) == 0x10);
+    REQUIRE(ReadHostFile(path) == expected);
+
+    file.Close();
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("DiskFile: Handles of a file share the pending writes", "[core][file_sys]") {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_disk_file_shared_test.bin").string();
+    const std::vector<u8> initial(0x40, 0xAA);
+    FileUtil::IOFile(path, "wb").WriteBytes(initial.data(), initial.size());
+
+    FileSys::Mode write_mode{};
+    write_mode.read_flag.Assign(1);
+    write_mode.write_flag.Assign(1);
+    FileSys::Mode read_mode{};
+    read_mode.read_flag.Assign(1);
+    FileSys::DiskFile writer(FileUtil::IOFile(path, "r+b"), write_mode, nullptr);
+    FileSys::DiskFile reader(FileUtil::IOFile(path, "rb"), read_mode, nullptr);
+
+    const std::vector<u8> data(0x20, 0x55);
+    REQUIRE(*writer.Write(0x30, data.size(), false, data.data()) == data.size());
+    std::vector<u8> expected = initial;
+    expected.resize(0x50);
+    std::fill(expected.begin() + 0x30, expected.end(), 0x55);
+
+    // The other handle sees the write before it reaches the host file, and closing it leaves the
+    // data to the handle that wrote it
+    REQUIRE(reader.GetSize() == expected.size());
+    std::vector<u8> result(expected.size());
+    REQUIRE(*reader.Read(0, result.size(), result.data()) == expected.size());
+    REQUIRE(result == expected);
+    REQUIRE(reader.Flush());
+    reader.Close();
+    REQUIRE(ReadHostFile(path) == initial);
+
+    REQUIRE(writer.Close());
+    REQUIRE(ReadHostFile(path) == expected);
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("DiskDirectory: Listings are reused until something changes", "[core][file_sys]") {
+    const auto root = std::filesystem::temp_directory_path() / "citra_disk_directory_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    const std::string path = root.string();
+    FileUtil::CreateEmptyFile(path + "/a");
+
+    // Directories modified within the second of the scan are always scanned again
+    const auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    std::filesystem::last_write_time(root, past);
+    FileSys::DiskDirectory::InvalidateCache();
+    REQUIRE(CountEntries(path) == 1);
+
+    // A file added behind the archives' back to a directory that looks unmodified is not seen
+    FileUtil::CreateEmptyFile(path + "/b");
+    std::filesystem::last_write_time(root, past);
+    REQUIRE(CountEntries(path) == 1);
+
+    // Changes through an archive invalidate the listings
+    FileSys::DiskDirectory::InvalidateCache();
+    REQUIRE(CountEntries(path) == 2);
+
+    // So do modifications of the host directory
+    FileUtil::CreateEmptyFile(path + "/c");
+    REQUIRE(CountEntries(path) == 3);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("DiskDirectory: Listings see files grown by a commit", "[core][file_sys]") {
+    const auto root = std::filesystem::temp_directory_path() / "citra_disk_directory_size_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    const std::string path = root.string();
+    const std::string file_path = path + "/a";
+    FileUtil::CreateEmptyFile(file_path);
+
+    FileSys::Mode mode{};
+    mode.read_flag.Assign(1);
+    mode.write_flag.Assign(1);
+    FileSys::DiskFile file(FileUtil::IOFile(file_path, "r+b"), mode, nullptr);
+    const std::vector<u8> data(0x40, 0x55);
+    REQUIRE(*file.Write(0, data.size(), false, data.data()) == data.size());
+
+    // The listing is taken while the write is pending, in a directory that looks unmodified
+    const auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    std::filesystem::last_write_time(root, past);
+    REQUIRE(GetListedSize(path) == 0);
+
+    REQUIRE(file.Flush());
+    REQUIRE(GetListedSize(path) == data.size());
+
+    file.Close();
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,108 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "core/file_sys/layered_fs.h"
+
+namespace {
+
+class MemoryRomFS : public FileSys::RomFSReader {
+public:
+    explicit MemoryRomFS(std::vector<u8> data_) : data(std::move(data_)) {}
+
+    std::size_t GetSize() const override {
+        return data.size();
+    }
+
+    std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override {
+        const std::size_t count = std::min(length, data.size() - std::min(offset, data.size()));
+        std::memcpy(buffer, data.data() + offset, count);
+        return count;
+    }
+
+private:
+    std::vector<u8> data;
+};
+
+/// A RomFS with an empty root directory
+std::shared_ptr<FileSys::RomFSReader> MakeEmptyRomFS() {
+    std::vector<u8> data(0x60, 0xFF);
+    FileSys::RomFSHeader header{};
+    header.header_length = sizeof(header);
+    header.directory_hash_table = {0x28, 0xC};
+    header.directory_metadata_table = {0x34, 0x18};
+    header.file_hash_table = {0x4C, 0xC};
+    header.file_metadata_table = {0x58, 0};
+    header.file_data_offset = 0x60;
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    // Root directory: no parent, sibling, children or files, and an empty name
+    const std::array<u32, 6> root{0, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0};
+    std::memcpy(data.data() + 0x34, root.data(), sizeof(root));
+    return std::make_shared<MemoryRomFS>(std::move(data));
+}
+
+std::vector<u8> ReadAll(FileSys::RomFSReader& romfs) {
+    std::vector<u8> data(romfs.GetSize());
+    REQUIRE(romfs.ReadFile(0, data.size(), data.data()) == data.size());
+    return data;
+}
+
+void WriteFile(const std::filesystem::path& path, std::size_t size) {
+    std::filesystem::create_directories(path.parent_path());
+    const std::vector<u8> data(size, static_cast<u8>(size));
+    FileUtil::IOFile(path.string(), "wb").WriteBytes(data.data(), data.size());
+}
+
+} // Anonymous namespace
+
+TEST_CASE("LayeredFS: Rebuilt RomFS loads back unchanged", "[core][file_sys]") {
+    const auto root = std::filesystem::temp_directory_path() / "citra_layered_fs_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "cache");
+    FileUtil::UpdateUserPath(FileUtil::UserPath::CacheDir, (root / "cache").string());
+
+    const auto patch = root / "romfs";
+    WriteFile(patch / "top.txt", 3);
+    WriteFile(patch / "a" / "1.bin", 5);
+    WriteFile(patch / "a" / "2.bin", 17);
+    WriteFile(patch / "a" / "3.bin", 1);
+    WriteFile(patch / "b" / "c" / "4.bin", 40);
+    const std::string patch_path = patch.string() + "/";
+
+    // Directories modified within the second of indexing are always listed again
+    const auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    for (const auto& directory : {patch, patch / "a", patch / "b", patch / "b" / "c"}) {
+        std::filesystem::last_write_time(directory, past);
+    }
+
+    FileSys::LayeredFS layered(MakeEmptyRomFS(), patch_path, "");
+    const std::vector<u8> image = ReadAll(layered);
+
+    // Parsing the generated metadata must find every entry again
+    FileSys::LayeredFS reloaded(std::make_shared<MemoryRomFS>(image), "", "", false);
+    REQUIRE(ReadAll(reloaded) == image);
+
+    // The second load lists the directories from the index
+    REQUIRE(!std::filesystem::is_empty(root / "cache" / "layered_fs"));
+    FileSys::LayeredFS indexed(MakeEmptyRomFS(), patch_path, "");
+    REQUIRE(ReadAll(indexed) == image);
+
+    // Growing a file in place leaves its directory untouched, the new size must still be seen
+    WriteFile(patch / "a" / "1.bin", 21);
+    FileSys::LayeredFS grown(MakeEmptyRomFS(), patch_path, "");
+    REQUIRE(grown.GetSize() == layered.GetSize() + 16);
+
+    // Adding a file updates the modification time of its directory
+    WriteFile(patch / "b" / "c" / "5.bin", 1);
+    FileSys::LayeredFS added(MakeEmptyRomFS(), patch_path, "");
+    REQUIRE(added.GetSize() > grown.GetSize());
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,93 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/file_util.h"
+#include "core/file_sys/parallel_decryption.h"
+#include "tests/test_data.h"
+
+namespace {
+
+const std::array<u8, 16> Key{0x0F, 0x1E, 0x2D, 0x3C, 0x4B, 0x5A, 0x69, 0x78,
+                             0x87, 0x96, 0xA5, 0xB4, 0xC3, 0xD2, 0xE1, 0xF0};
+const std::array<u8, 16> Ctr{0xFF, 0xEE, 0xDD, 0xCC, 0xBB, 0xAA, 0x99, 0x88,
+                             0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00};
+
+std::vector<u8> DecryptSerial(const std::vector<u8>& data, u64 offset) {
+    std::vector<u8> result(data.size());
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption decryption(Key.data(), Key.size(), Ctr.data());
+    decryption.Seek(offset);
+    decryption.ProcessData(result.data(), data.data(), data.size());
+    return result;
+}
+
+std::vector<u8> DecryptSerialCBC(const std::vector<u8>& data) {
+    std::vector<u8> result(data.size());
+    CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption decryption(Key.data(), Key.size(), Ctr.data());
+    decryption.ProcessData(result.data(), data.data(), data.size());
+    return result;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DecryptCTRParallel: Matches serial decryption", "[core][file_sys]") {
+    // An offset that is not block aligned and sizes around the parallel threshold and chunks
+    constexpr u64 Offset = 0x1234567;
+    for (const std::size_t size : {0x1000, 0x100000, 0x100001, 0x3ABCDE}) {
+        const std::vector<u8> data = Tests::MakeTestData(size);
+        const std::vector<u8> expected = DecryptSerial(data, Offset);
+
+        std::vector<u8> result(size);
+        FileSys::DecryptCTRParallel(Key, Ctr, Offset, data.data(), result.data(), size);
+        REQUIRE(result == expected);
+
+        result = data;
+        FileSys::DecryptCTRParallel(Key, Ctr, Offset, result.data(), result.data(), size);
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("DecryptCBCParallel: Continues across calls like serial decryption", "[core][file_sys]") {
+    constexpr std::size_t Size = 0x3ABCD0;
+    const std::vector<u8> data = Tests::MakeTestData(Size);
+    const std::vector<u8> expected = DecryptSerialCBC(data);
+
+    // Split into a small and a large call, the second decrypting in place
+    constexpr std::size_t Split = 0x10010;
+    std::vector<u8> result = data;
+    std::array<u8, 16> iv = Ctr;
+    FileSys::DecryptCBCParallel(Key, iv, data.data(), result.data(), Split);
+    REQUIRE(std::equal(iv.begin(), iv.end(), data.begin() + Split - iv.size()));
+    FileSys::DecryptCBCParallel(Key, iv, result.data() + Split, result.data() + Split,
+                                Size - Split);
+    REQUIRE(result == expected);
+}
+
+TEST_CASE("ReadDecryptCTRParallel: Stops at the end of the file", "[core][file_sys]") {
+    constexpr std::size_t FileSize = 0x2F0123;
+    constexpr std::size_t Start = 0x100;
+    const std::vector<u8> data = Tests::MakeTestData(FileSize);
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_parallel_decryption_test.bin").string();
+    FileUtil::IOFile(path, "wb").WriteBytes(data.data(), data.size());
+
+    FileUtil::IOFile file(path, "rb");
+    file.Seek(Start, SEEK_SET);
+    std::vector<u8> result(FileSize);
+    REQUIRE(FileSys::ReadDecryptCTRParallel(file, Key, Ctr, 0x40, result.data(), result.size()) ==
+            FileSize - Start);
+    result.resize(FileSize - Start);
+
+    const std::vector<u8> expected =
+        DecryptSerial(std::vector<u8>(data.begin() + Start, data.end()), 0x40);
+    REQUIRE(result == expected);
+
+    file.Close();
+    FileUtil::Delete(path);
+}
@@ -0,0 +1,86 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/file_util.h"
+#include "core/file_sys/romfs_reader.h"
+#include "tests/test_data.h"
+
+namespace {
+
+constexpr std::size_t FileOffset = 0x1000;
+constexpr std::size_t DataSize = 0x123456;
+constexpr std::size_t CryptoOffset = 0x400;
+
+const std::array<u8, 16> Key{0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+                             0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE};
+const std::array<u8, 16> Ctr{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                             0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+
+/// Writes the RomFS after some padding, encrypting it when asked to
+std::string WriteRomFS(const std::vector<u8>& data, bool encrypted) {
+    std::vector<u8> contents(FileOffset);
+    contents.insert(contents.end(), data.begin(), data.end());
+    if (encrypted) {
+        CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption e(Key.data(), Key.size(), Ctr.data());
+        e.Seek(CryptoOffset);
+        e.ProcessData(contents.data() + FileOffset, contents.data() + FileOffset, data.size());
+    }
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_romfs_reader_test.bin").string();
+    FileUtil::IOFile file(path, "wb");
+    file.WriteBytes(contents.data(), contents.size());
+    return path;
+}
+
+/// Mixes small sequential and random reads, plus one large read
+void CheckReads(FileSys::DirectRomFSReader& reader, const std::vector<u8>& data) {
+    std::vector<u8> buffer(DataSize);
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < 2000; i++) {
+        const std::size_t length = 1 + (i * 977) % 0x3000;
+        if (i % 5 == 0) {
+            offset = (i * 0x9E3779B1) % DataSize;
+        }
+        const std::size_t read = reader.ReadFile(offset, length, buffer.data());
+        REQUIRE(read == std::min(length, DataSize - offset));
+        REQUIRE(std::equal(buffer.begin(), buffer.begin() + read, data.begin() + offset));
+        offset = (offset + read) % DataSize;
+    }
+
+    REQUIRE(reader.ReadFile(0x10, DataSize, buffer.data()) == DataSize - 0x10);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + DataSize - 0x10, data.begin() + 0x10));
+    REQUIRE(reader.ReadFile(DataSize, 0x10, buffer.data()) == 0);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DirectRomFSReader: Cached reads match the file", "[core][file_sys]") {
+    const std::vector<u8> data = Tests::MakeTestData(DataSize);
+
+    SECTION("plain") {
+        const std::string path = WriteRomFS(data, false);
+        FileSys::DirectRomFSReader reader(FileUtil::IOFile(path, "rb"), FileOffset, DataSize);
+        CheckReads(reader, data);
+        FileUtil::Delete(path);
+    }
+
+    SECTION("encrypted") {
+        const std::string path = WriteRomFS(data, true);
+        FileSys::DirectRomFSReader reader(FileUtil::IOFile(path, "rb"), FileOffset, DataSize, Key,
+                                          Ctr, CryptoOffset);
+        CheckReads(reader, data);
+
+        const auto stats = reader.GetCacheStats();
+        REQUIRE(stats.hits > stats.misses);
+        REQUIRE(stats.readahead_blocks > 0);
+        FileUtil::Delete(path);
+    }
+}
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include "common/archives.h"
 #include "core/core.h"
@@ -391,4 +392,88 @@ TEST_CASE("HLERequestContext::WriteToOutgoingCommandBuffer", "[core][kernel]") {
     }
 }
 
+TEST_CASE("HLERequestContext::Reset", "[core][kernel]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto [server, client] = kernel.CreateSessionPair();
+    HLERequestContext context(kernel, server, nullptr);
+
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    auto mem = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE);
+    MemoryRef buffer{mem};
+    std::fill(buffer.GetPtr(), buffer.GetPtr() + buffer.GetSize(), 0xAB);
+
+    VAddr target_address = 0x10000000;
+    auto result = process->vm_manager.MapBackingMemory(
+        target_address, buffer, static_cast<u32>(buffer.GetSize()), MemoryState::Private);
+    REQUIRE(result.Code() == RESULT_SUCCESS);
+
+    auto a = MakeObject(kernel);
+    Handle a_handle = process->handle_table.Create(a).Unwrap();
+    const u32_le input[]{
+        IPC::MakeHeader(0, 0, 4),
+        IPC::StaticBufferDesc(buffer.GetSize(), 0),
+        target_address,
+        IPC::CopyHandleDesc(),
+        a_handle,
+    };
+
+    context.PopulateFromIncomingCommandBuffer(input, process);
+    REQUIRE(context.GetStaticBuffer(0) == mem->Vector());
+    const u8* static_buffer_data = context.GetStaticBuffer(0).data();
+
+    context.Reset(server, nullptr);
+    REQUIRE(context.GetStaticBuffer(0).empty());
+    REQUIRE(a.use_count() == 2);
+
+    // The same request again lands in the storage of the previous one
+    context.PopulateFromIncomingCommandBuffer(input, process);
+    REQUIRE(context.GetIncomingHandle(context.CommandBuffer()[4]) == a);
+    REQUIRE(context.GetStaticBuffer(0).data() == static_buffer_data);
+
+    REQUIRE(process->vm_manager.UnmapRange(target_address, static_cast<u32>(buffer.GetSize())) ==
+            RESULT_SUCCESS);
+}
+
+TEST_CASE("HLERequestContext: Benchmark", "[.benchmark][core][kernel]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto [server, client] = kernel.CreateSessionPair();
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    auto mem = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE);
+    MemoryRef buffer{mem};
+    VAddr target_address = 0x10000000;
+    auto result = process->vm_manager.MapBackingMemory(
+        target_address, buffer, static_cast<u32>(buffer.GetSize()), MemoryState::Private);
+    REQUIRE(result.Code() == RESULT_SUCCESS);
+
+    const u32_le input[]{
+        IPC::MakeHeader(0, 1, 4),
+        0x12345678,
+        IPC::StaticBufferDesc(0x100, 0),
+        target_address,
+        IPC::MappedBufferDesc(buffer.GetSize(), IPC::R),
+        target_address,
+    };
+
+    // A fresh context per request, as every request used to get
+    BENCHMARK("Translate with new contexts") {
+        auto context = std::make_shared<HLERequestContext>(kernel, server, nullptr);
+        context->PopulateFromIncomingCommandBuffer(input, process);
+        return context->CommandBuffer()[1];
+    };
+
+    auto context = std::make_shared<HLERequestContext>(kernel, server, nullptr);
+    BENCHMARK("Translate with a reused context") {
+        context->Reset(server, nullptr);
+        context->PopulateFromIncomingCommandBuffer(input, process);
+        return context->CommandBuffer()[1];
+    };
+}
+
 } // namespace Kernel
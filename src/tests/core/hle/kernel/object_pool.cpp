@@ -0,0 +1,30 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "core/hle/kernel/object_pool.h"
+
+namespace {
+
+struct PooledObject {
+    explicit PooledObject(int value) : value{value} {}
+    int value;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("MakePooled: Freed blocks are reused", "[core][kernel]") {
+    auto first = Kernel::MakePooled<PooledObject>(1);
+    REQUIRE(first->value == 1);
+    const void* block = first.get();
+    first.reset();
+
+    auto second = Kernel::MakePooled<PooledObject>(2);
+    REQUIRE(second->value == 2);
+    REQUIRE(second.get() == block);
+
+    auto third = Kernel::MakePooled<PooledObject>(3);
+    REQUIRE(third.get() != second.get());
+    REQUIRE(second->value == 2);
+}
@@ -0,0 +1,136 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <vector>
+#include "common/thread_queue_list.h"
+
+namespace {
+
+struct TestThread {
+    unsigned int priority = 0;
+    Common::ThreadQueueListHook<TestThread*> queue_hook;
+};
+
+using ReadyQueue = Common::ThreadQueueList<TestThread*, 64>;
+
+/**
+ * Mimics ThreadManager on a busy title: the running thread is preempted or yields, others wake
+ * up or change priority, and the best ready thread is picked after every step.
+ */
+u64 RunChurn(ReadyQueue& queue, std::vector<TestThread>& threads, u32 seed, int steps) {
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<unsigned int> priority_dist{0, 63};
+    std::uniform_int_distribution<std::size_t> thread_dist{0, threads.size() - 1};
+
+    for (TestThread& thread : threads) {
+        thread.priority = priority_dist(rng);
+        queue.push_back(thread.priority, &thread);
+    }
+
+    u64 checksum = 0;
+    TestThread* running = nullptr;
+    for (int step = 0; step < steps; ++step) {
+        TestThread& other = threads[thread_dist(rng)];
+        const unsigned int new_priority = priority_dist(rng);
+        if (queue.contains(&other) != static_cast<unsigned int>(-1)) {
+            queue.move(&other, other.priority, new_priority);
+        }
+        other.priority = new_priority;
+
+        TestThread* next = running ? queue.pop_first_better(running->priority) : nullptr;
+        if (!running || next) {
+            if (running) {
+                queue.push_front(running->priority, running);
+            }
+            running = next ? next : queue.pop_first();
+        } else if (step % 4 == 0) {
+            // Yield to threads of the same priority
+            queue.push_back(running->priority, running);
+            running = queue.pop_first();
+        }
+        checksum += running ? running->priority : 0;
+    }
+    return checksum;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ThreadQueueList: Ordering", "[kernel]") {
+    ReadyQueue queue;
+    std::vector<TestThread> threads(4);
+    queue.push_back(10, &threads[0]);
+    queue.push_back(5, &threads[1]);
+    queue.push_back(10, &threads[2]);
+    queue.push_front(10, &threads[3]);
+
+    REQUIRE(queue.contains(&threads[2]) == 10);
+    REQUIRE(queue.get_first() == &threads[1]);
+    REQUIRE(queue.pop_first_better(5) == nullptr);
+    REQUIRE(queue.pop_first_better(6) == &threads[1]);
+    REQUIRE(queue.empty(5));
+
+    queue.rotate(10);
+    REQUIRE(queue.pop_first() == &threads[0]);
+    queue.remove(10, &threads[3]);
+    REQUIRE(queue.contains(&threads[3]) == static_cast<unsigned int>(-1));
+    REQUIRE(queue.pop_first() == &threads[2]);
+    REQUIRE(queue.pop_first() == nullptr);
+}
+
+TEST_CASE("ThreadQueueList: Queueing a queued thread moves it", "[kernel]") {
+    ReadyQueue queue;
+    std::vector<TestThread> threads(3);
+    queue.push_back(10, &threads[0]);
+    queue.push_back(10, &threads[1]);
+    queue.push_back(20, &threads[2]);
+
+    // Pushing again moves the thread within its level or to another level
+    queue.push_back(10, &threads[0]);
+    REQUIRE(queue.get_first() == &threads[1]);
+    queue.push_front(20, &threads[1]);
+    REQUIRE(queue.contains(&threads[1]) == 20);
+
+    // move() with a stale old priority still takes the thread out of its current level
+    queue.move(&threads[2], 5, 30);
+    REQUIRE(queue.contains(&threads[2]) == 30);
+
+    REQUIRE(queue.pop_first() == &threads[0]);
+    REQUIRE(queue.pop_first() == &threads[1]);
+    REQUIRE(queue.pop_first() == &threads[2]);
+    REQUIRE(queue.pop_first() == nullptr);
+}
+
+TEST_CASE("ThreadQueueList: Churn keeps every thread queued once", "[kernel]") {
+    ReadyQueue queue;
+    std::vector<TestThread> threads(48);
+    RunChurn(queue, threads, 0, 10000);
+
+    // Everything but the running thread is queued, at its current priority and in order
+    std::size_t num_queued = 0;
+    unsigned int last_priority = 0;
+    while (TestThread* thread = queue.pop_first()) {
+        REQUIRE(thread->priority >= last_priority);
+        last_priority = thread->priority;
+        num_queued++;
+    }
+    REQUIRE(num_queued == threads.size() - 1);
+    for (TestThread& thread : threads) {
+        REQUIRE(queue.contains(&thread) == static_cast<unsigned int>(-1));
+    }
+}
+
+TEST_CASE("ThreadQueueList: Benchmark", "[.benchmark][kernel]") {
+    ReadyQueue queue;
+    std::vector<TestThread> threads(48);
+
+    BENCHMARK("Scheduling churn") {
+        const u64 checksum = RunChurn(queue, threads, 0, 100000);
+        queue.clear();
+        return checksum;
+    };
+}
@@ -2,7 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+
+#include <vector>
 #include "core/core_timing.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
@@ -52,3 +55,33 @@ TEST_CASE("memory.IsValidVirtualAddress", "[core][memory]") {
         CHECK(memory.IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("MemorySystem: Benchmark", "[.benchmark][core][memory]") {
+    constexpr u32 size = 0x10000;
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+    memory.SetCurrentPageTable(process->vm_manager.page_table);
+    std::vector<u8> buffer(size);
+
+    BENCHMARK("Read32 64 KiB") {
+        u32 sum = 0;
+        for (u32 offset = 0; offset < size; offset += sizeof(u32)) {
+            sum += memory.Read32(Memory::VRAM_VADDR + offset);
+        }
+        return sum;
+    };
+    BENCHMARK("Write32 64 KiB") {
+        for (u32 offset = 0; offset < size; offset += sizeof(u32)) {
+            memory.Write32(Memory::VRAM_VADDR + offset, offset);
+        }
+    };
+    BENCHMARK("ReadBlock 64 KiB") {
+        memory.ReadBlock(*process, Memory::VRAM_VADDR, buffer.data(), size);
+        return buffer[0];
+    };
+}
@@ -53,6 +53,33 @@ TEST_CASE("Memory Basics", "[kernel][memory]") {
         CHECK(vma->second.backing_memory.GetPtr() == nullptr);
     }
 
+    SECTION("finding areas after they were merged") {
+        auto pages = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE * 2);
+        MemoryRef first{pages};
+        MemoryRef second{pages, Memory::CITRA_PAGE_SIZE};
+        // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
+        auto manager = std::make_unique<Kernel::VMManager>(memory, process);
+        auto result = manager->MapBackingMemory(Memory::HEAP_VADDR, first, Memory::CITRA_PAGE_SIZE,
+                                                Kernel::MemoryState::Private);
+        REQUIRE(result.Code() == RESULT_SUCCESS);
+        CHECK(manager->FindVMA(Memory::HEAP_VADDR)->second.size == Memory::CITRA_PAGE_SIZE);
+
+        const VAddr second_vaddr = Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE;
+        CHECK(manager->FindVMA(second_vaddr)->second.type == Kernel::VMAType::Free);
+        result = manager->MapBackingMemory(second_vaddr, second, Memory::CITRA_PAGE_SIZE,
+                                           Kernel::MemoryState::Private);
+        REQUIRE(result.Code() == RESULT_SUCCESS);
+
+        auto vma = manager->FindVMA(second_vaddr);
+        CHECK(vma->second.base == Memory::HEAP_VADDR);
+        CHECK(vma->second.size == Memory::CITRA_PAGE_SIZE * 2);
+        CHECK(manager->FindVMA(Memory::HEAP_VADDR) == vma);
+
+        ResultCode code = manager->UnmapRange(Memory::HEAP_VADDR, Memory::CITRA_PAGE_SIZE * 2);
+        REQUIRE(code == RESULT_SUCCESS);
+        CHECK(manager->FindVMA(second_vaddr)->second.type == Kernel::VMAType::Free);
+    }
+
     SECTION("changing memory permissions") {
         // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
         auto manager = std::make_unique<Kernel::VMManager>(memory, process);
@@ -0,0 +1,44 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <chrono>
+#include <thread>
+#include "core/perf_stats.h"
+
+using namespace std::chrono_literals;
+using Core::PerfStats;
+
+TEST_CASE("PerfStats: Nested subsystem time is only accounted to the innermost timer", "[core]") {
+    PerfStats perf_stats(0);
+    const auto begin = PerfStats::Clock::now();
+    {
+        PerfStats::SubsystemTimer cpu_timer{&perf_stats, PerfStats::Subsystem::CPU};
+        std::this_thread::sleep_for(2ms);
+        PerfStats::SubsystemTimer hle_timer{&perf_stats, PerfStats::Subsystem::HLE};
+        std::this_thread::sleep_for(10ms);
+    }
+    const std::chrono::duration<double> elapsed = PerfStats::Clock::now() - begin;
+    {
+        // Timers without statistics account nothing
+        PerfStats::SubsystemTimer timer{nullptr, PerfStats::Subsystem::GPU};
+    }
+    perf_stats.EndSystemFrame();
+
+    const PerfStats::Results results = perf_stats.GetAndResetStats(0us);
+    const auto time = [&results](PerfStats::Subsystem subsystem) {
+        return results.subsystem_time[static_cast<std::size_t>(subsystem)];
+    };
+    REQUIRE(time(PerfStats::Subsystem::CPU) >= 0.002);
+    REQUIRE(time(PerfStats::Subsystem::HLE) >= 0.010);
+    REQUIRE(time(PerfStats::Subsystem::CPU) + time(PerfStats::Subsystem::HLE) <= elapsed.count());
+    REQUIRE(time(PerfStats::Subsystem::GPU) == 0.0);
+
+    // The subsystem time is reset with the other statistics
+    perf_stats.EndSystemFrame();
+    constexpr std::array<double, PerfStats::NumSubsystems> zero{};
+    REQUIRE(perf_stats.GetAndResetStats(0us).subsystem_time == zero);
+}
@@ -0,0 +1,63 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "core/rewind_buffer.h"
+#include "core/savestate.h"
+
+namespace {
+
+Core::SerializedState MakeState(std::string data, std::size_t num_dirty_pages = 0) {
+    return Core::SerializedState{std::move(data), std::vector<u64>(16), num_dirty_pages};
+}
+
+} // Anonymous namespace
+
+TEST_CASE("RewindBuffer: Deltas are restored on top of their keyframe", "[core]") {
+    Core::RewindBuffer buffer(16, std::size_t{1} << 20);
+    REQUIRE(buffer.GetDeltaBase() == nullptr);
+
+    buffer.Push(MakeState("keyframe"));
+    REQUIRE(buffer.GetDeltaBase() != nullptr);
+    buffer.Push(MakeState("delta 1", 1));
+    buffer.Push(MakeState("delta 2", 1));
+
+    auto snapshot = buffer.PopNewest();
+    REQUIRE(snapshot);
+    REQUIRE(snapshot->keyframe == "keyframe");
+    REQUIRE(snapshot->delta == "delta 2");
+
+    snapshot = buffer.PopNewest();
+    REQUIRE(snapshot->delta == "delta 1");
+    REQUIRE(buffer.GetDeltaBase() != nullptr);
+
+    snapshot = buffer.PopNewest();
+    REQUIRE(snapshot->keyframe == "keyframe");
+    REQUIRE(!snapshot->delta);
+    REQUIRE(buffer.GetDeltaBase() == nullptr);
+    REQUIRE(!buffer.PopNewest());
+}
+
+TEST_CASE("RewindBuffer: Large deltas force a keyframe", "[core]") {
+    Core::RewindBuffer buffer(8, std::size_t{1} << 20);
+    buffer.Push(MakeState("keyframe"));
+    buffer.Push(MakeState("delta", 5));
+    REQUIRE(buffer.GetDeltaBase() == nullptr);
+}
+
+TEST_CASE("RewindBuffer: The oldest keyframe is dropped with its deltas", "[core]") {
+    // Capacity 4 allows a single delta per keyframe
+    Core::RewindBuffer buffer(4, std::size_t{1} << 20);
+    for (int segment = 0; segment < 3; ++segment) {
+        const std::string name = std::to_string(segment);
+        buffer.Push(MakeState("keyframe " + name));
+        buffer.Push(MakeState("delta " + name, 1));
+    }
+
+    REQUIRE(buffer.PopNewest()->delta == "delta 2");
+    REQUIRE(buffer.PopNewest()->keyframe == "keyframe 2");
+    REQUIRE(buffer.PopNewest()->delta == "delta 1");
+    REQUIRE(buffer.PopNewest()->keyframe == "keyframe 1");
+    REQUIRE(!buffer.PopNewest());
+}
@@ -0,0 +1,121 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <tuple>
+#include <vector>
+#include "core/timing_event_queue.h"
+
+namespace {
+
+struct TestEvent {
+    s64 time;
+    u64 fifo_order;
+
+    bool operator<(const TestEvent& other) const {
+        return std::tie(time, fifo_order) < std::tie(other.time, other.fifo_order);
+    }
+
+    bool operator==(const TestEvent& other) const {
+        return time == other.time && fifo_order == other.fifo_order;
+    }
+};
+
+/**
+ * Runs a random sequence of schedules, cancellations and pops and returns the popped events, so
+ * that both backends can be checked to pop the same events in the same order.
+ */
+template <typename Queue>
+std::vector<TestEvent> RunWorkload(u32 seed, s64 max_delay) {
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<s64> delay_dist{0, max_delay};
+    std::uniform_int_distribution<int> op_dist{0, 9};
+
+    Queue queue;
+    std::vector<Core::TimingEventHandle> handles;
+    std::vector<TestEvent> popped;
+    s64 now = 0;
+    u64 fifo = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const int op = op_dist(rng);
+        if (op < 5 || queue.Empty()) {
+            // Occasionally schedule events that are already due
+            const s64 delay = op == 0 ? -delay_dist(rng) % 100 : delay_dist(rng);
+            handles.push_back(queue.Push({now + delay, fifo++}));
+        } else if (op < 7 && !handles.empty()) {
+            const std::size_t index = rng() % handles.size();
+            queue.Remove(handles[index]);
+            handles.erase(handles.begin() + index);
+        } else {
+            const TestEvent event = queue.Pop();
+            now = std::max(now, event.time);
+            popped.push_back(event);
+        }
+    }
+    while (!queue.Empty()) {
+        popped.push_back(queue.Pop());
+    }
+    return popped;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("TimingWheelEventQueue: Ordering", "[core][timing]") {
+    Core::TimingWheelEventQueue<TestEvent> queue;
+    queue.Push({1000, 0});
+    queue.Push({5, 1});
+    const auto handle = queue.Push({1 << 20, 2});
+    queue.Push({5, 3});
+    queue.Push({s64{1} << 50, 4});
+    queue.Push({70, 5});
+
+    REQUIRE(queue.Size() == 6);
+    REQUIRE(queue.Remove(handle));
+    REQUIRE(!queue.Remove(handle));
+
+    const std::vector<TestEvent> expected{{5, 1}, {5, 3}, {70, 5}, {1000, 0}, {s64{1} << 50, 4}};
+    for (const TestEvent& event : expected) {
+        REQUIRE(queue.Top() == event);
+        REQUIRE(queue.Pop() == event);
+    }
+    REQUIRE(queue.Empty());
+}
+
+TEST_CASE("TimingWheelEventQueue: Stale handles", "[core][timing]") {
+    Core::TimingWheelEventQueue<TestEvent> queue;
+    const auto first = queue.Push({10, 0});
+    REQUIRE(queue.Pop() == TestEvent{10, 0});
+
+    // The node of the popped event is reused, the old handle must not cancel the new event.
+    const auto second = queue.Push({20, 1});
+    REQUIRE(!queue.Remove(first));
+    REQUIRE(queue.Size() == 1);
+    REQUIRE(queue.Remove(second));
+    REQUIRE(queue.Empty());
+}
+
+TEST_CASE("TimingWheelEventQueue: Matches HeapEventQueue", "[core][timing]") {
+    for (const s64 max_delay : {s64{50}, s64{100000}, s64{1} << 40}) {
+        for (u32 seed = 0; seed < 4; ++seed) {
+            const auto wheel = RunWorkload<Core::TimingWheelEventQueue<TestEvent>>(seed, max_delay);
+            const auto heap = RunWorkload<Core::HeapEventQueue<TestEvent>>(seed, max_delay);
+            REQUIRE(wheel == heap);
+        }
+    }
+}
+
+TEST_CASE("TimingEventQueue: Benchmark", "[.benchmark][core][timing]") {
+    // Resembles the emulated hardware: a few hundred events within a frame.
+    constexpr s64 MAX_DELAY = 268111856 / 60;
+
+    BENCHMARK("HeapEventQueue") {
+        return RunWorkload<Core::HeapEventQueue<TestEvent>>(0, MAX_DELAY).size();
+    };
+    BENCHMARK("TimingWheelEventQueue") {
+        return RunWorkload<Core::TimingWheelEventQueue<TestEvent>>(0, MAX_DELAY).size();
+    };
+}
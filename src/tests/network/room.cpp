@@ -0,0 +1,99 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "network/network.h"
+#include "network/room.h"
+#include "network/room_member.h"
+
+namespace {
+
+/// Not the default port, so that the test does not collide with a room hosted on the machine
+constexpr u16 TestRoomPort = Network::DefaultRoomPort + 1;
+constexpr std::size_t NumMembers = 16;
+
+template <typename Predicate>
+bool WaitFor(Predicate&& predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{30};
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
+
+} // Anonymous namespace
+
+// Drives synthetic members against a room the way citra-room hosts it. Opens local sockets, so it
+// is hidden by default.
+TEST_CASE("Room: Relays WiFi packets between many members", "[.benchmark][network]") {
+    REQUIRE(Network::Init());
+    Network::Room room;
+    REQUIRE(room.Create("Load test", "", "127.0.0.1", TestRoomPort, "", NumMembers));
+
+    std::atomic<std::size_t> received{0};
+    std::vector<std::unique_ptr<Network::RoomMember>> members;
+    std::vector<Network::RoomMember::CallbackHandle<Network::WifiPacket>> handles;
+    for (std::size_t i = 0; i < NumMembers; ++i) {
+        auto& member = members.emplace_back(std::make_unique<Network::RoomMember>());
+        handles.push_back(member->BindOnWifiPacketReceived(
+            [&received](const Network::WifiPacket&) { received++; }));
+        member->Join("member" + std::to_string(i), "console" + std::to_string(i), "127.0.0.1",
+                     TestRoomPort);
+    }
+    REQUIRE(WaitFor([&] {
+        for (const auto& member : members) {
+            if (member->GetState() != Network::RoomMember::State::Joined &&
+                member->GetState() != Network::RoomMember::State::Moderator) {
+                return false;
+            }
+        }
+        return room.GetRoomMemberList().size() == NumMembers;
+    }));
+
+    Network::WifiPacket packet{};
+    packet.type = Network::WifiPacket::PacketType::Data;
+    packet.data.resize(256);
+    packet.destination_address = Network::BroadcastMac;
+
+    // Every member broadcasts one packet, which the room relays to all the others
+    const auto broadcast_round = [&] {
+        const std::size_t expected = received + NumMembers * (NumMembers - 1);
+        for (auto& member : members) {
+            packet.transmitter_address = member->GetMacAddress();
+            member->SendWifiPacket(packet);
+        }
+        return WaitFor([&] { return received >= expected; });
+    };
+    REQUIRE(broadcast_round());
+
+    // A packet with a destination only reaches that member
+    const std::size_t before_unicast = received;
+    packet.transmitter_address = members[0]->GetMacAddress();
+    packet.destination_address = members[1]->GetMacAddress();
+    members[0]->SendWifiPacket(packet);
+    REQUIRE(WaitFor([&] { return received == before_unicast + 1; }));
+    packet.destination_address = Network::BroadcastMac;
+
+    BENCHMARK("Broadcast round with 16 members") {
+        return broadcast_round();
+    };
+
+    for (std::size_t i = 0; i < NumMembers; ++i) {
+        members[i]->Unbind(handles[i]);
+        members[i]->Leave();
+    }
+    room.Destroy();
+    Network::Shutdown();
+}
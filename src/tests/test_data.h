@@ -0,0 +1,34 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Tests {
+
+/// Returns deterministic bytes that don't repeat at any block or page size a test may use.
+inline std::vector<u8> MakeTestData(std::size_t size) {
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size; i++) {
+        u32 x = static_cast<u32>(i) * 0x9E3779B1U;
+        x ^= x >> 15;
+        x *= 0x85EBCA77U;
+        data[i] = static_cast<u8>(x >> 24);
+    }
+    return data;
+}
+
+/// Returns deterministic bytes that compress well but still differ between 64KiB frames.
+inline std::vector<u8> MakeCompressibleTestData(std::size_t size) {
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size; i++) {
+        data[i] = static_cast<u8>((i / 64) * 13 + (i % 7));
+    }
+    return data;
+}
+
+} // namespace Tests
@@ -0,0 +1,56 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/dynamic_resolution.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+u16 Run(VideoCore::DynamicResolution& controller, std::chrono::nanoseconds gpu_time, u32 frames,
+        u16 min_scale = 1, u16 max_scale = 4) {
+    u16 scale = 0;
+    for (u32 frame = 0; frame < frames; frame++) {
+        scale = controller.Update(gpu_time, min_scale, max_scale);
+    }
+    return scale;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DynamicResolution: Starts at the highest scale", "[video_core]") {
+    VideoCore::DynamicResolution controller;
+    REQUIRE(controller.GetScale() == 0);
+    REQUIRE(controller.Update(10ms, 1, 3) == 3);
+}
+
+TEST_CASE("DynamicResolution: Overloaded frames lower the scale one step at a time",
+          "[video_core]") {
+    VideoCore::DynamicResolution controller;
+    REQUIRE(Run(controller, 20ms, 30) == 4);
+    REQUIRE(Run(controller, 20ms, 40) == 3);
+    REQUIRE(Run(controller, 20ms, 120) == 1);
+    REQUIRE(Run(controller, 20ms, 120, 2) == 2);
+}
+
+TEST_CASE("DynamicResolution: The scale is only raised with headroom", "[video_core]") {
+    VideoCore::DynamicResolution controller;
+    Run(controller, 20ms, 1000);
+    REQUIRE(controller.GetScale() == 1);
+
+    // 4 ms at 1x is expected to take 16 ms at 2x, which is too close to the budget
+    REQUIRE(Run(controller, 4ms, 1000) == 1);
+
+    // 2 ms at 1x is expected to take 8 ms at 2x, where 3x would take 18 ms
+    REQUIRE(Run(controller, 2ms, 10) == 2);
+    REQUIRE(Run(controller, 8ms, 1000) == 2);
+}
+
+TEST_CASE("DynamicResolution: Follows changes to the bounds", "[video_core]") {
+    VideoCore::DynamicResolution controller;
+    REQUIRE(controller.Update(10ms, 1, 4) == 4);
+    REQUIRE(controller.Update(10ms, 1, 2) == 2);
+    REQUIRE(controller.Update(10ms, 3, 5) == 3);
+}
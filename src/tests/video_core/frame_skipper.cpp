@@ -0,0 +1,57 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/frame_skipper.h"
+
+namespace {
+
+/// Runs frames that take `drawn` or `skipped` of the frame budget, returns the skipped frames
+u32 Run(VideoCore::FrameSkipper& skipper, double drawn, double skipped, u32 frames) {
+    u32 num_skipped = 0;
+    for (u32 frame = 0; frame < frames; frame++) {
+        num_skipped += skipper.BeginFrame(skipper.IsSkipping() ? skipped : drawn, false);
+    }
+    return num_skipped;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("FrameSkipper: Frames that fit are all drawn", "[video_core]") {
+    VideoCore::FrameSkipper skipper{4};
+    REQUIRE(Run(skipper, 0.9, 0.1, 100) == 0);
+    REQUIRE(skipper.GetLevel() == 0);
+
+    VideoCore::FrameSkipper disabled{0};
+    REQUIRE(Run(disabled, 2.0, 0.1, 100) == 0);
+}
+
+TEST_CASE("FrameSkipper: Skips as many frames as needed to keep up", "[video_core]") {
+    // A drawn and a skipped frame take 1.6 / 2 of the budget, one skipped frame is enough
+    VideoCore::FrameSkipper skipper{4};
+    Run(skipper, 1.5, 0.1, 100);
+    REQUIRE(skipper.GetLevel() == 1);
+    REQUIRE(Run(skipper, 1.5, 0.1, 100) == 50);
+
+    // Lighter frames lower the level again
+    Run(skipper, 0.8, 0.1, 100);
+    REQUIRE(skipper.GetLevel() == 0);
+}
+
+TEST_CASE("FrameSkipper: Never skips more than the maximum", "[video_core]") {
+    VideoCore::FrameSkipper skipper{2};
+    Run(skipper, 10.0, 0.1, 100);
+    REQUIRE(skipper.GetLevel() == 2);
+}
+
+TEST_CASE("FrameSkipper: Readbacks stop skipping for a while", "[video_core]") {
+    VideoCore::FrameSkipper skipper{4};
+    Run(skipper, 3.0, 0.1, 100);
+    REQUIRE(skipper.GetLevel() > 0);
+
+    REQUIRE(!skipper.BeginFrame(3.0, true));
+    REQUIRE(skipper.GetLevel() == 0);
+    REQUIRE(Run(skipper, 3.0, 0.1, VideoCore::FrameSkipper::ReadbackCooldownFrames - 1) == 0);
+    REQUIRE(Run(skipper, 3.0, 0.1, 100) > 0);
+}
@@ -0,0 +1,67 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <utility>
+#include <vector>
+#include "video_core/rasterizer_cache/page_counter.h"
+
+using Runs = std::vector<std::pair<u32, u32>>;
+
+static Runs Update(VideoCore::PageCounter& counter, u32 page_start, u32 page_end, int delta) {
+    Runs runs;
+    counter.Update(page_start, page_end, delta,
+                   [&runs](u32 first, u32 count) { runs.emplace_back(first, count); });
+    return runs;
+}
+
+TEST_CASE("PageCounter: Reports pages switching between zero and non-zero", "[video_core]") {
+    VideoCore::PageCounter counter;
+
+    REQUIRE(Update(counter, 10, 200, 1) == Runs{{10, 190}});
+    // Overlapping ranges only report the newly cached part
+    REQUIRE(Update(counter, 150, 300, 1) == Runs{{200, 100}});
+    REQUIRE(counter.Count(160) == 2);
+
+    REQUIRE(Update(counter, 10, 200, -1) == Runs{{10, 140}});
+    REQUIRE(counter.Count(160) == 1);
+    REQUIRE(Update(counter, 150, 300, -1) == Runs{{150, 150}});
+    REQUIRE(counter.Count(160) == 0);
+}
+
+TEST_CASE("PageCounter: Splits runs around pages that did not change", "[video_core]") {
+    VideoCore::PageCounter counter;
+
+    Update(counter, 64, 65, 1);
+    Update(counter, 130, 132, 1);
+    REQUIRE(Update(counter, 0, 256, 1) == Runs{{0, 64}, {65, 65}, {132, 124}});
+    REQUIRE(Update(counter, 0, 256, -1) == Runs{{0, 64}, {65, 65}, {132, 124}});
+}
+
+TEST_CASE("PageCounter: Clear reports every cached run", "[video_core]") {
+    VideoCore::PageCounter counter;
+
+    Update(counter, 5, 70, 3);
+    Update(counter, 1000, 1001, 1);
+
+    Runs runs;
+    counter.Clear([&runs](u32 first, u32 count) { runs.emplace_back(first, count); });
+    REQUIRE(runs == Runs{{5, 65}, {1000, 1}});
+    REQUIRE(counter.Count(5) == 0);
+    REQUIRE(Update(counter, 5, 6, 1) == Runs{{5, 1}});
+}
+
+TEST_CASE("PageCounter: ForEachRun keeps the counts", "[video_core]") {
+    VideoCore::PageCounter counter;
+
+    Update(counter, 60, 130, 1);
+    Update(counter, 128, 129, 1);
+
+    Runs runs;
+    counter.ForEachRun([&runs](u32 first, u32 count) { runs.emplace_back(first, count); });
+    REQUIRE(runs == Runs{{60, 70}});
+    REQUIRE(counter.Count(128) == 2);
+    REQUIRE(Update(counter, 60, 130, -1) == Runs{{60, 68}, {129, 1}});
+}
@@ -0,0 +1,78 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <vector>
+#include "video_core/rasterizer_cache/texture_codec.h"
+#include "tests/test_data.h"
+
+using VideoCore::PixelFormat;
+
+namespace {
+
+constexpr u32 Width = 64;
+constexpr u32 Height = 32;
+
+template <PixelFormat format>
+void CheckRoundTrip() {
+    constexpr u32 bytes_per_pixel = VideoCore::GetFormatBpp(format) / 8;
+    std::vector<u8> tiled = Tests::MakeTestData(Width * Height * bytes_per_pixel);
+    std::vector<u8> linear(tiled.size());
+    const u32 size = static_cast<u32>(tiled.size());
+
+    VideoCore::MortonCopy<true, format>(Width, Height, 0, size, linear, tiled);
+    // The linear buffer is stored bottom up
+    for (u32 y = 0; y < Height; y++) {
+        for (u32 x = 0; x < Width; x++) {
+            const u32 tiled_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) +
+                                     (y & ~7) * Width * bytes_per_pixel;
+            const u32 linear_offset = ((Height - 1 - y) * Width + x) * bytes_per_pixel;
+            REQUIRE(std::memcmp(&linear[linear_offset], &tiled[tiled_offset], bytes_per_pixel) ==
+                    0);
+        }
+    }
+
+    std::vector<u8> swizzled(tiled.size());
+    VideoCore::MortonCopy<false, format>(Width, Height, 0, size, linear, swizzled);
+    REQUIRE(swizzled == tiled);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MortonCopy: Unconverted formats match the morton layout", "[video_core]") {
+    CheckRoundTrip<PixelFormat::RGBA8>();
+    CheckRoundTrip<PixelFormat::RGB8>();
+    CheckRoundTrip<PixelFormat::RGB565>();
+    CheckRoundTrip<PixelFormat::D16>();
+}
+
+TEST_CASE("MortonCopy: Benchmark", "[.benchmark][video_core]") {
+    std::vector<u8> tiled(1024 * 1024 * 4);
+    std::vector<u8> linear(tiled.size() * 4);
+    const u32 size = static_cast<u32>(tiled.size());
+
+    BENCHMARK("Unswizzle RGBA8") {
+        VideoCore::MortonCopy<true, PixelFormat::RGBA8>(1024, 1024, 0, size, linear, tiled);
+        return linear[0];
+    };
+    BENCHMARK("Unswizzle RGBA8 converted") {
+        VideoCore::MortonCopy<true, PixelFormat::RGBA8, true>(1024, 1024, 0, size, linear, tiled);
+        return linear[0];
+    };
+    BENCHMARK("Swizzle RGB565") {
+        VideoCore::MortonCopy<false, PixelFormat::RGB565>(1024, 1024, 0, size / 2, linear, tiled);
+        return tiled[0];
+    };
+    BENCHMARK("Decode ETC1") {
+        VideoCore::MortonCopy<true, PixelFormat::ETC1>(1024, 1024, 0, size / 8, linear, tiled);
+        return linear[0];
+    };
+    BENCHMARK("Decode ETC1A4") {
+        VideoCore::MortonCopy<true, PixelFormat::ETC1A4>(1024, 1024, 0, size / 4, linear, tiled);
+        return linear[0];
+    };
+}
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <nihstro/inline_assembly.h>
@@ -162,4 +163,99 @@ TEST_CASE("Nested Loop", "[video_core][shader][shader_jit]") {
     }
 }
 
+TEST_CASE("Interpreter matches JIT", "[video_core][shader][shader_jit]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_c0 = SourceRegister::MakeFloat(0);
+    const auto sh_temp0 = SourceRegister::MakeTemporary(0);
+    const auto sh_temp1 = SourceRegister::MakeTemporary(1);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto shader_test = ShaderTest({
+        // clang-format off
+        {OpCode::Id::MUL, sh_temp0, sh_input, sh_c0},
+        {OpCode::Id::DP4, sh_temp1, sh_input, sh_c0},
+        {OpCode::Id::ADD, sh_temp0, sh_temp0, sh_temp1},
+        {OpCode::Id::MAX, sh_temp0, sh_temp0, sh_input},
+        {OpCode::Id::MOV, sh_output, sh_temp0},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+    shader_test.shader_setup->uniforms.f[0] =
+        Common::MakeVec(float24::FromFloat32(0.5f), float24::FromFloat32(-2.f),
+                        float24::FromFloat32(4.f), float24::FromFloat32(1.f));
+
+    const auto run = [&](bool interpreter, float input) {
+        Pica::Shader::UnitState shader_unit;
+        shader_unit.registers.input[0] =
+            Common::MakeVec(float24::FromFloat32(input), float24::FromFloat32(input + 1.f),
+                            float24::FromFloat32(-input), float24::FromFloat32(2.f));
+        shader_unit.registers.output[0] = Common::Vec4<float24>::AssignToAll(float24::Zero());
+        if (interpreter) {
+            shader_test.shader_interpreter.Run(*shader_test.shader_setup, shader_unit);
+        } else {
+            shader_test.shader_jit.Run(*shader_test.shader_setup, shader_unit, 0);
+        }
+        return shader_unit.registers.output[0];
+    };
+
+    for (const float input : {-3.f, 0.f, 0.25f, 7.f}) {
+        const auto jit_output = run(false, input);
+        const auto interpreter_output = run(true, input);
+        for (std::size_t i = 0; i < 4; ++i) {
+            REQUIRE(interpreter_output[i].ToFloat32() == Catch::Approx(jit_output[i].ToFloat32()));
+        }
+    }
+}
+
+TEST_CASE("Vertex shader benchmark", "[.benchmark][video_core][shader][shader_jit]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_c0 = SourceRegister::MakeFloat(0);
+    const auto sh_c1 = SourceRegister::MakeFloat(1);
+    const auto sh_temp0 = SourceRegister::MakeTemporary(0);
+    const auto sh_temp1 = SourceRegister::MakeTemporary(1);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    // Mix of the dot products, multiplies and special functions of a typical transform shader
+    auto shader_test = ShaderTest({
+        // clang-format off
+        {OpCode::Id::DP4, sh_temp0, sh_input, sh_c0},
+        {OpCode::Id::DP4, sh_temp1, sh_input, sh_c1},
+        {OpCode::Id::MUL, sh_temp0, sh_temp0, sh_temp1},
+        {OpCode::Id::RSQ, sh_temp1, sh_temp0},
+        {OpCode::Id::ADD, sh_temp0, sh_temp0, sh_temp1},
+        {OpCode::Id::MOV, sh_output, sh_temp0},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+    shader_test.shader_setup->uniforms.f[0] =
+        Common::MakeVec(float24::FromFloat32(0.5f), float24::FromFloat32(0.25f),
+                        float24::FromFloat32(1.f), float24::FromFloat32(2.f));
+    shader_test.shader_setup->uniforms.f[1] =
+        Common::MakeVec(float24::FromFloat32(1.f), float24::FromFloat32(0.5f),
+                        float24::FromFloat32(0.25f), float24::FromFloat32(0.125f));
+
+    // Roughly the vertex count of a character model
+    constexpr int num_vertices = 1024;
+
+    BENCHMARK("JIT") {
+        Pica::Shader::UnitState shader_unit;
+        float sum = 0.f;
+        for (int i = 0; i < num_vertices; ++i) {
+            shader_test.RunJit(shader_unit, static_cast<float>(i));
+            sum += shader_unit.registers.output[0].x.ToFloat32();
+        }
+        return sum;
+    };
+
+    BENCHMARK("Interpreter") {
+        Pica::Shader::UnitState shader_unit;
+        float sum = 0.f;
+        for (int i = 0; i < num_vertices; ++i) {
+            shader_test.RunInterpreter(shader_unit, static_cast<float>(i));
+            sum += shader_unit.registers.output[0].x.ToFloat32();
+        }
+        return sum;
+    };
+}
+
 #endif // CITRA_ARCH(x86_64)
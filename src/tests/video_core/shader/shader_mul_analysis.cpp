@@ -0,0 +1,73 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <catch2/catch_test_macros.hpp>
+#include <nihstro/inline_assembly.h>
+#include "video_core/shader/shader_mul_analysis.h"
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+
+static std::unique_ptr<Pica::Shader::ShaderSetup> CompileShaderSetup(
+    std::initializer_list<nihstro::InlineAsm> code) {
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
+
+    auto shader = std::make_unique<Pica::Shader::ShaderSetup>();
+
+    std::transform(shbin.program.begin(), shbin.program.end(), shader->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   shader->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+
+    return shader;
+}
+
+TEST_CASE("AccurateMulAnalysis", "[video_core][shader]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_c0 = SourceRegister::MakeFloat(0);
+    const auto sh_temp0 = SourceRegister::MakeTemporary(0);
+    const auto sh_temp1 = SourceRegister::MakeTemporary(1);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    const auto setup = CompileShaderSetup({
+        // clang-format off
+        {OpCode::Id::SGE, sh_temp0, sh_input, sh_c0},
+        {OpCode::Id::ADD, sh_temp1, sh_input, sh_c0},
+        {OpCode::Id::MUL, sh_output, sh_input, sh_c0},
+        {OpCode::Id::MUL, sh_output, sh_temp0, sh_temp0},
+        {OpCode::Id::DP3, sh_output, sh_temp1, sh_temp1},
+        {OpCode::Id::MUL, sh_output, sh_temp0, sh_temp1},
+        {OpCode::Id::MAX, sh_temp0, sh_temp0, sh_temp1},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+    const Pica::Shader::AccurateMulAnalysis analysis{setup->program_code, setup->swizzle_data};
+
+    // Uniforms and inputs may be anything
+    REQUIRE(analysis.NeedsSanitize(2));
+    // Squares never compute 0 * inf
+    REQUIRE_FALSE(analysis.NeedsSanitize(3));
+    REQUIRE_FALSE(analysis.NeedsSanitize(4));
+    // The sum may overflow, and the MAX of it makes the result of SGE not always finite either
+    REQUIRE(analysis.NeedsSanitize(5));
+
+    const auto finite_setup = CompileShaderSetup({
+        // clang-format off
+        {OpCode::Id::SGE, sh_temp0, sh_input, sh_c0},
+        {OpCode::Id::SLT, sh_temp1, sh_input, sh_c0},
+        {OpCode::Id::MAX, sh_temp0, sh_temp0, sh_temp1},
+        {OpCode::Id::MUL, sh_output, sh_temp0, sh_temp1},
+        {OpCode::Id::MUL, sh_output, sh_temp0, sh_input},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+    const Pica::Shader::AccurateMulAnalysis finite_analysis{finite_setup->program_code,
+                                                            finite_setup->swizzle_data};
+
+    REQUIRE_FALSE(finite_analysis.NeedsSanitize(3));
+    REQUIRE(finite_analysis.NeedsSanitize(4));
+}
@@ -0,0 +1,96 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include "core/memory.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/regs_pipeline.h"
+#include "video_core/shader/shader.h"
+#include "video_core/vertex_loader.h"
+#include "video_core/video_core.h"
+
+using Pica::PipelineRegs;
+
+namespace {
+
+/// Interleaved vertex with a float position, a byte color and a short texture coordinate
+struct TestVertex {
+    float position[3];
+    u8 color[4];
+    s16 texcoord[2];
+};
+static_assert(sizeof(TestVertex) == 20);
+
+PipelineRegs MakeRegs() {
+    PipelineRegs regs{};
+    auto& attributes = regs.vertex_attributes;
+    attributes.base_address.Assign(Memory::VRAM_PADDR / 16);
+    attributes.format0.Assign(PipelineRegs::VertexAttributeFormat::FLOAT);
+    attributes.size0.Assign(2);
+    attributes.format1.Assign(PipelineRegs::VertexAttributeFormat::UBYTE);
+    attributes.size1.Assign(3);
+    attributes.format2.Assign(PipelineRegs::VertexAttributeFormat::SHORT);
+    attributes.size2.Assign(1);
+    attributes.max_attribute_index.Assign(2);
+
+    auto& loader = attributes.attribute_loaders[0];
+    loader.comp0.Assign(0);
+    loader.comp1.Assign(1);
+    loader.comp2.Assign(2);
+    loader.component_count.Assign(3);
+    loader.byte_count.Assign(sizeof(TestVertex));
+    return regs;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("VertexLoader: Interleaved attributes", "[video_core]") {
+    Memory::MemorySystem memory;
+    VideoCore::g_memory = &memory;
+
+    constexpr TestVertex vertex{{1.0f, -2.0f, 0.5f}, {255, 128, 0, 1}, {-3, 7}};
+    std::memcpy(memory.GetPhysicalPointer(Memory::VRAM_PADDR + sizeof(TestVertex)), &vertex,
+                sizeof(vertex));
+
+    const PipelineRegs regs = MakeRegs();
+    Pica::VertexLoader loader(regs);
+    Pica::Shader::AttributeBuffer input{};
+    Pica::DebugUtils::MemoryAccessTracker memory_accesses;
+    loader.LoadVertex(regs.vertex_attributes.GetPhysicalBaseAddress(), 1, 1, input,
+                      memory_accesses);
+
+    REQUIRE(input.attr[0][0].ToFloat32() == 1.0f);
+    REQUIRE(input.attr[0][1].ToFloat32() == -2.0f);
+    REQUIRE(input.attr[0][2].ToFloat32() == 0.5f);
+    REQUIRE(input.attr[0][3].ToFloat32() == 1.0f);
+    REQUIRE(input.attr[1][0].ToFloat32() == 255.0f);
+    REQUIRE(input.attr[1][3].ToFloat32() == 1.0f);
+    REQUIRE(input.attr[2][0].ToFloat32() == -3.0f);
+    REQUIRE(input.attr[2][1].ToFloat32() == 7.0f);
+
+    VideoCore::g_memory = nullptr;
+}
+
+TEST_CASE("VertexLoader: Benchmark", "[.benchmark][video_core]") {
+    Memory::MemorySystem memory;
+    VideoCore::g_memory = &memory;
+
+    const PipelineRegs regs = MakeRegs();
+    Pica::VertexLoader loader(regs);
+    Pica::Shader::AttributeBuffer input{};
+    Pica::DebugUtils::MemoryAccessTracker memory_accesses;
+    const u32 base_address = regs.vertex_attributes.GetPhysicalBaseAddress();
+
+    BENCHMARK("LoadVertex x1024") {
+        for (int vertex = 0; vertex < 1024; vertex++) {
+            loader.LoadVertex(base_address, vertex, vertex, input, memory_accesses);
+        }
+        return input.attr[0][0].ToFloat32();
+    };
+
+    VideoCore::g_memory = nullptr;
+}
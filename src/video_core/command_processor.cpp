@@ -2,15 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
 #include "common/vector_math.h"
+#include "core/core.h"
 #include "core/hle/service/gsp/gsp.h"
 #include "core/hw/gpu.h"
 #include "core/memory.h"
@@ -39,6 +43,68 @@ constexpr std::array<u32, 16> expand_bits_to_bytes{
 
 MICROPROFILE_DEFINE(GPU_Drawing, "GPU", "Drawing", MP_RGB(50, 50, 240));
 
+static Core::PerfStats* GetPerfStats() {
+    return Core::System::GetInstance().GetPerfStats();
+}
+
+/**
+ * Post-transform cache of the vertex shader outputs of an indexed draw, keyed by vertex index. The
+ * default cache is a small circular buffer, the size has been tuned for optimal balance between
+ * hit-rate and the cost of lookup. The large cache is direct-mapped and skips far more shader
+ * runs, at the cost of dropping the state that shaders carry from one vertex to the next.
+ */
+class VertexCache {
+public:
+    static constexpr std::size_t SMALL_SIZE = 32;
+    static constexpr std::size_t LARGE_SIZE = 1024;
+
+    /// Empties the cache at the start of a draw
+    void Reset(bool large_) {
+        large = large_;
+        ids.assign(large ? LARGE_SIZE : SMALL_SIZE, INVALID_ID);
+        entries.resize(ids.size());
+        pos = 0;
+        hits = 0;
+        misses = 0;
+    }
+
+    /// Returns the cached output of the vertex, or nullptr on a miss
+    const Shader::AttributeBuffer* Find(u32 vertex) {
+        const auto it =
+            large ? ids.begin() + vertex % LARGE_SIZE : std::find(ids.begin(), ids.end(), vertex);
+        if (it == ids.end() || *it != vertex) {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        return &entries[it - ids.begin()];
+    }
+
+    void Insert(u32 vertex, const Shader::AttributeBuffer& output) {
+        std::size_t slot = vertex % LARGE_SIZE;
+        if (!large) {
+            slot = pos;
+            pos = (pos + 1) % SMALL_SIZE;
+        }
+        ids[slot] = vertex;
+        entries[slot] = output;
+    }
+
+    u32 hits = 0;
+    u32 misses = 0;
+
+private:
+    /// Vertex indices are at most 16-bit
+    static constexpr u32 INVALID_ID = 0xFFFFFFFF;
+
+    bool large = false;
+    std::vector<u32> ids;
+    std::vector<Shader::AttributeBuffer> entries;
+    std::size_t pos = 0;
+};
+
+static VertexCache vertex_cache;
+
 static const char* GetShaderSetupTypeName(Shader::ShaderSetup& setup) {
     if (&setup == &g_state.vs) {
         return "vertex shader";
@@ -143,7 +209,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
     switch (id) {
     // Trigger IRQ
     case PICA_REG_INDEX(trigger_irq):
-        Service::GSP::SignalInterrupt(Service::GSP::InterruptId::P3D);
+        GPU::SignalInterrupt(Service::GSP::InterruptId::P3D);
         break;
 
     case PICA_REG_INDEX(pipeline.triangle_topology):
@@ -244,6 +310,8 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
                     // TODO: If drawing after every immediate mode triangle kills performance,
                     // change it to flush triangles whenever a drawing config register changes
                     // See: https://github.com/citra-emu/citra/pull/2866#issuecomment-327011550
+                    Core::PerfStats::SubsystemTimer timer{GetPerfStats(),
+                                                          Core::PerfStats::Subsystem::Rasterizer};
                     VideoCore::g_renderer->Rasterizer()->DrawTriangles();
                     if (g_debug_context) {
                         g_debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch,
@@ -275,6 +343,11 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
     case PICA_REG_INDEX(pipeline.trigger_draw_indexed): {
         MICROPROFILE_SCOPE(GPU_Drawing);
 
+        // Vertices left in the assembler carry over to the next draw, those batches are kept
+        if (VideoCore::g_skip_draws && g_state.primitive_assembler.IsEmpty()) {
+            break;
+        }
+
 #if PICA_LOG_TEV
         DebugUtils::DumpTevStageConfig(regs.GetTevStages());
 #endif
@@ -298,13 +371,25 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
             // this, so this is left unimplemented for now. Revisit this when an issue is found in
             // games.
         } else {
-            accelerate_draw = false;
+            // In the point mode each GS invocation takes the outputs of a fixed number of
+            // vertices, which the hardware renderer passes as one host primitive
+            const u32 vs_outputs = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+            const u32 invocation_vertices = (regs.gs.max_input_attribute_index + 1) / vs_outputs;
+            accelerate_draw = accelerate_draw &&
+                              regs.pipeline.gs_config.mode == PipelineRegs::GSMode::Point &&
+                              invocation_vertices != 0 &&
+                              (regs.pipeline.num_vertices % invocation_vertices) == 0;
         }
 
         bool is_indexed = (id == PICA_REG_INDEX(pipeline.trigger_draw_indexed));
 
-        if (accelerate_draw &&
-            VideoCore::g_renderer->Rasterizer()->AccelerateDrawBatch(is_indexed)) {
+        bool accelerated = false;
+        if (accelerate_draw) {
+            Core::PerfStats::SubsystemTimer timer{GetPerfStats(),
+                                                  Core::PerfStats::Subsystem::Rasterizer};
+            accelerated = VideoCore::g_renderer->Rasterizer()->AccelerateDrawBatch(is_indexed);
+        }
+        if (accelerated) {
             if (g_debug_context) {
                 g_debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch, nullptr);
             }
@@ -343,16 +428,9 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
 
         DebugUtils::MemoryAccessTracker memory_accesses;
 
-        // Simple circular-replacement vertex cache
-        // The size has been tuned for optimal balance between hit-rate and the cost of lookup
-        const std::size_t VERTEX_CACHE_SIZE = 32;
-        std::array<bool, VERTEX_CACHE_SIZE> vertex_cache_valid{};
-        std::array<u16, VERTEX_CACHE_SIZE> vertex_cache_ids;
-        std::array<Shader::AttributeBuffer, VERTEX_CACHE_SIZE> vertex_cache;
+        vertex_cache.Reset(Settings::values.large_vertex_cache.GetValue());
         Shader::AttributeBuffer vs_output;
 
-        unsigned int vertex_cache_pos = 0;
-
         auto* shader_engine = Shader::GetEngine();
         Shader::UnitState shader_unit;
 
@@ -383,12 +461,9 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
                                               size);
                 }
 
-                for (unsigned int i = 0; i < VERTEX_CACHE_SIZE; ++i) {
-                    if (vertex_cache_valid[i] && vertex == vertex_cache_ids[i]) {
-                        vs_output = vertex_cache[i];
-                        vertex_cache_hit = true;
-                        break;
-                    }
+                if (const auto* cached = vertex_cache.Find(vertex)) {
+                    vs_output = *cached;
+                    vertex_cache_hit = true;
                 }
             }
 
@@ -406,10 +481,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
                 shader_unit.WriteOutput(regs.vs, vs_output);
 
                 if (is_indexed) {
-                    vertex_cache[vertex_cache_pos] = vs_output;
-                    vertex_cache_valid[vertex_cache_pos] = true;
-                    vertex_cache_ids[vertex_cache_pos] = vertex;
-                    vertex_cache_pos = (vertex_cache_pos + 1) % VERTEX_CACHE_SIZE;
+                    vertex_cache.Insert(vertex, vs_output);
                 }
             }
 
@@ -417,12 +489,21 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
             g_state.geometry_pipeline.SubmitVertex(vs_output);
         }
 
+        if (is_indexed) {
+            LOG_TRACE(HW_GPU, "Vertex cache: {} hits, {} misses", vertex_cache.hits,
+                      vertex_cache.misses);
+        }
+
         for (auto& range : memory_accesses.ranges) {
             g_debug_context->recorder->MemoryAccessed(
                 VideoCore::g_memory->GetPhysicalPointer(range.first), range.second, range.first);
         }
 
-        VideoCore::g_renderer->Rasterizer()->DrawTriangles();
+        {
+            Core::PerfStats::SubsystemTimer timer{GetPerfStats(),
+                                                  Core::PerfStats::Subsystem::Rasterizer};
+            VideoCore::g_renderer->Rasterizer()->DrawTriangles();
+        }
         if (g_debug_context) {
             g_debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch, nullptr);
         }
@@ -0,0 +1,104 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "video_core/compile_report.h"
+
+namespace VideoCore {
+
+CompileReport g_compile_report;
+
+namespace {
+
+constexpr std::array<const char*, static_cast<std::size_t>(CompileEventType::Count)> TypeNames{
+    "gl_vertex_shader",   "gl_geometry_shader", "gl_fragment_shader",
+    "gl_program_link",    "gl_precompiled_link", "vk_vertex_shader",
+    "vk_geometry_shader", "vk_fragment_shader", "vk_pipeline_build",
+    "vk_pipeline_link",   "vk_pipeline_wait",
+};
+
+double ToMilliseconds(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // Anonymous namespace
+
+void CompileReport::Record(const CompileEvent& event) {
+    std::scoped_lock lock{mutex};
+    events.push_back(event);
+}
+
+std::vector<CompileEvent> CompileReport::GetEvents() const {
+    std::scoped_lock lock{mutex};
+    return events;
+}
+
+bool CompileReport::Write(const std::string& path) const {
+    const std::vector<CompileEvent> snapshot = GetEvents();
+
+    struct Summary {
+        u64 count;
+        u64 blocked;
+        std::chrono::nanoseconds total;
+        std::chrono::nanoseconds blocked_total;
+        std::chrono::nanoseconds max;
+    };
+    std::array<Summary, TypeNames.size()> summaries{};
+    for (const CompileEvent& event : snapshot) {
+        Summary& summary = summaries[static_cast<std::size_t>(event.type)];
+        summary.count++;
+        summary.total += event.duration;
+        summary.max = std::max(summary.max, event.duration);
+        if (event.blocked) {
+            summary.blocked++;
+            summary.blocked_total += event.duration;
+        }
+    }
+
+    std::string out = fmt::format("# Compile report, {} events over {} frames\n",
+                                  snapshot.size(), GetFrame());
+    out += "# type count blocked total_ms blocked_ms max_ms\n";
+    for (std::size_t i = 0; i < summaries.size(); i++) {
+        const Summary& summary = summaries[i];
+        if (summary.count == 0) {
+            continue;
+        }
+        out += fmt::format("{} {} {} {:.3f} {:.3f} {:.3f}\n", TypeNames[i], summary.count,
+                           summary.blocked, ToMilliseconds(summary.total),
+                           ToMilliseconds(summary.blocked_total), ToMilliseconds(summary.max));
+    }
+
+    out += "\n# frame type config_hash duration_ms blocked\n";
+    for (const CompileEvent& event : snapshot) {
+        out += fmt::format("{} {} {:016x} {:.3f} {}\n", event.frame,
+                           TypeNames[static_cast<std::size_t>(event.type)], event.config_hash,
+                           ToMilliseconds(event.duration), event.blocked ? 1 : 0);
+    }
+
+    return FileUtil::WriteStringToFile(true, path, out) == out.size();
+}
+
+void CompileReport::Clear() {
+    std::scoped_lock lock{mutex};
+    events.clear();
+    frame.store(0, std::memory_order_relaxed);
+}
+
+ScopedCompileEvent::~ScopedCompileEvent() {
+    if (discarded) {
+        return;
+    }
+    g_compile_report.Record({
+        .type = type,
+        .config_hash = config_hash,
+        .frame = g_compile_report.GetFrame(),
+        .duration = std::chrono::steady_clock::now() - start,
+        .blocked = blocked,
+    });
+}
+
+} // namespace VideoCore
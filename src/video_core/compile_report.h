@@ -0,0 +1,101 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+enum class CompileEventType : u32 {
+    GLVertexShader,
+    GLGeometryShader,
+    GLFragmentShader,
+    /// Program linked from the shaders of the current configuration
+    GLProgramLink,
+    /// Program loaded from the precompiled disk cache
+    GLPrecompiledLink,
+    VKVertexShader,
+    VKGeometryShader,
+    VKFragmentShader,
+    VKPipelineBuild,
+    VKPipelineLink,
+    /// Command recording waited for a pipeline still being built
+    VKPipelineWait,
+    Count,
+};
+
+struct CompileEvent {
+    CompileEventType type;
+    /// Hash of the configuration the shader or pipeline was built for
+    u64 config_hash;
+    /// Frame the event ended in
+    u64 frame;
+    std::chrono::nanoseconds duration;
+    /// Whether the emulated frame waited for the event to finish
+    bool blocked;
+};
+
+/**
+ * Collects the shader compilations and pipeline builds of a session, to tell which of them
+ * caused stutter. Events may be recorded from any thread.
+ */
+class CompileReport {
+public:
+    void Record(const CompileEvent& event);
+
+    /// Advances the frame the following events are attributed to
+    void TickFrame() {
+        frame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    u64 GetFrame() const {
+        return frame.load(std::memory_order_relaxed);
+    }
+
+    std::vector<CompileEvent> GetEvents() const;
+
+    /// Writes a summary per event type followed by every event, returns false on failure
+    bool Write(const std::string& path) const;
+
+    void Clear();
+
+private:
+    mutable std::mutex mutex;
+    std::vector<CompileEvent> events;
+    std::atomic<u64> frame{};
+};
+
+extern CompileReport g_compile_report;
+
+/// Records the time between its construction and destruction as a compile event
+class ScopedCompileEvent {
+public:
+    explicit ScopedCompileEvent(CompileEventType type, u64 config_hash, bool blocked)
+        : type{type}, config_hash{config_hash}, blocked{blocked},
+          start{std::chrono::steady_clock::now()} {}
+    ~ScopedCompileEvent();
+
+    ScopedCompileEvent(const ScopedCompileEvent&) = delete;
+    ScopedCompileEvent& operator=(const ScopedCompileEvent&) = delete;
+
+    /// Drops the event, for work that turned out to be a cache lookup
+    void Discard() {
+        discarded = true;
+    }
+
+private:
+    CompileEventType type;
+    u64 config_hash;
+    bool blocked;
+    bool discarded{};
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace VideoCore
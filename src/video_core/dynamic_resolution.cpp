@@ -0,0 +1,59 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/logging/log.h"
+#include "video_core/dynamic_resolution.h"
+
+namespace VideoCore {
+
+/// GPU time available to a frame when emulating at full speed
+constexpr std::chrono::nanoseconds FrameBudget = std::chrono::microseconds{16'667};
+/// Frames measured after a scale change before the scale may change again
+constexpr u32 SettleFrames = 60;
+/// Lower the scale when the average frame takes more than this fraction of the budget, in percent
+constexpr s64 DownscalePercent = 90;
+/// Raise the scale only when the frame is expected to take less than this fraction at it
+constexpr s64 UpscalePercent = 75;
+
+u16 DynamicResolution::Update(std::chrono::nanoseconds gpu_time, u16 min_scale, u16 max_scale) {
+    min_scale = std::clamp<u16>(min_scale, 1, max_scale);
+    if (scale < min_scale || scale > max_scale) {
+        SetScale(scale == 0 ? max_scale : std::clamp(scale, min_scale, max_scale));
+        return scale;
+    }
+
+    // Exponential moving average with a weight of 1/8, seeded with the first sample
+    average_time = num_samples == 0 ? gpu_time : average_time + (gpu_time - average_time) / 8;
+    if (++num_samples < SettleFrames) {
+        return scale;
+    }
+
+    // The GPU time follows the number of pixels, which grows with the square of the scale
+    const auto budget = FrameBudget.count();
+    const auto average = average_time.count();
+    if (scale > min_scale && average * 100 > budget * DownscalePercent) {
+        SetScale(scale - 1);
+    } else if (scale < max_scale) {
+        const s64 next = scale + 1;
+        const s64 expected = average * next * next / (s64{scale} * scale);
+        if (expected * 100 < budget * UpscalePercent) {
+            SetScale(scale + 1);
+        }
+    }
+    return scale;
+}
+
+void DynamicResolution::SetScale(u16 new_scale) {
+    if (scale != 0) {
+        LOG_DEBUG(Render, "Changing render scale from {}x to {}x, average GPU time {} us", scale,
+                  new_scale,
+                  std::chrono::duration_cast<std::chrono::microseconds>(average_time).count());
+    }
+    scale = new_scale;
+    num_samples = 0;
+    average_time = {};
+}
+
+} // namespace VideoCore
@@ -0,0 +1,38 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Picks the scale render targets are drawn at from the GPU time of recent frames. The scale is
+ * lowered when frames take most of the frame budget and raised again only when the expected
+ * time at the higher scale leaves enough headroom. Each change is followed by a settle period
+ * so that the scale does not oscillate between two steps.
+ */
+class DynamicResolution {
+public:
+    /// Records the GPU time of a frame and returns the scale to render the next frames at
+    u16 Update(std::chrono::nanoseconds gpu_time, u16 min_scale, u16 max_scale);
+
+    /// Returns the current scale, zero before the first update
+    u16 GetScale() const noexcept {
+        return scale;
+    }
+
+private:
+    /// Changes the scale and restarts measurements, the old average doesn't apply to it
+    void SetScale(u16 new_scale);
+
+private:
+    u16 scale{};
+    u32 num_samples{};
+    std::chrono::nanoseconds average_time{};
+};
+
+} // namespace VideoCore
@@ -0,0 +1,80 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <thread>
+#include "common/microprofile.h"
+#include "video_core/frame_pacer.h"
+
+MICROPROFILE_DEFINE(FramePacer_Wait, "Frame Pacer", "Wait For Present", MP_RGB(128, 128, 192));
+
+namespace VideoCore {
+
+/// Never block the render thread longer than this, the window might be hidden or minimized
+constexpr auto MaxPresentWait = std::chrono::milliseconds{100};
+/// Presents further apart than this are pauses rather than refresh intervals
+constexpr auto MaxPresentInterval = std::chrono::milliseconds{100};
+/// Headroom kept before the expected present to absorb jitter of the frame work
+constexpr auto PaceMargin = std::chrono::milliseconds{2};
+
+/// Exponential moving average with a weight of 1/8 for the new sample
+static FramePacer::Clock::duration Average(FramePacer::Clock::duration average,
+                                           FramePacer::Clock::duration sample) {
+    return average + (sample - average) / 8;
+}
+
+FramePacer::Clock::time_point FramePacer::FrameQueued() {
+    std::scoped_lock lock{mutex};
+    const auto now = Clock::now();
+    if (frame_start != Clock::time_point{}) {
+        work_time = Average(work_time, now - frame_start);
+    }
+    last_queued = now;
+    frame_pending = true;
+    return now;
+}
+
+void FramePacer::FramePresented(Clock::time_point queued_time) {
+    std::scoped_lock lock{mutex};
+    const auto now = Clock::now();
+    present_latency = now - queued_time;
+    if (last_present != Clock::time_point{} && now - last_present < MaxPresentInterval) {
+        present_interval = Average(present_interval, now - last_present);
+    }
+    last_present = now;
+    if (queued_time >= last_queued) {
+        frame_pending = false;
+        present_cv.notify_one();
+    }
+}
+
+void FramePacer::Pace(bool enabled) {
+    if (!enabled) {
+        std::scoped_lock lock{mutex};
+        frame_start = Clock::now();
+        return;
+    }
+
+    Clock::time_point start_target;
+    {
+        MICROPROFILE_SCOPE(FramePacer_Wait);
+        std::unique_lock lock{mutex};
+        present_cv.wait_for(lock, MaxPresentWait, [this] { return !frame_pending; });
+
+        // Start so that the frame is queued right before the next present
+        const auto slack = std::max(present_interval - work_time - PaceMargin, Clock::duration{});
+        start_target = std::min(last_present + slack, Clock::now() + present_interval);
+    }
+    std::this_thread::sleep_until(start_target);
+
+    std::scoped_lock lock{mutex};
+    frame_start = Clock::now();
+}
+
+FramePacer::Clock::duration FramePacer::GetPresentLatency() const {
+    std::scoped_lock lock{mutex};
+    return present_latency;
+}
+
+} // namespace VideoCore
@@ -0,0 +1,58 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace VideoCore {
+
+/**
+ * Paces the render thread against the presentation thread. When enabled at most one rendered
+ * frame waits for presentation, and the start of the next emulated frame is delayed so that it
+ * is queued just before the display consumes it, which keeps input latency close to one frame.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Render thread calls this when a frame is handed to the presentation thread
+    Clock::time_point FrameQueued();
+
+    /// Presentation thread calls this once the frame queued at queued_time was presented
+    void FramePresented(Clock::time_point queued_time);
+
+    /**
+     * Render thread calls this before emulating the next frame. When pacing is enabled this
+     * waits for the previously queued frame to be presented and sleeps until the next frame
+     * has to start to be ready for the following present.
+     */
+    void Pace(bool enabled);
+
+    /// Returns the time between queueing and presenting the last presented frame
+    Clock::duration GetPresentLatency() const;
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable present_cv;
+
+    /// Whether the last queued frame is still waiting for presentation
+    bool frame_pending{};
+    /// Point when the render thread started working on the current frame
+    Clock::time_point frame_start{};
+    /// Point when the last frame was queued
+    Clock::time_point last_queued{};
+    /// Point when the last frame was presented
+    Clock::time_point last_present{};
+    /// Averaged time between two presents, this is the refresh interval when vsync is enabled
+    Clock::duration present_interval{std::chrono::microseconds{16'667}};
+    /// Averaged time the render thread needs from the start of a frame until it is queued
+    Clock::duration work_time{};
+    /// Time between queueing and presenting the last presented frame
+    Clock::duration present_latency{};
+};
+
+} // namespace VideoCore
@@ -0,0 +1,61 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/frame_skipper.h"
+
+namespace VideoCore {
+
+namespace {
+
+/// Weight of the latest frame in the moving averages
+constexpr double LoadWeight = 0.25;
+
+/// Skipping is only lowered when the frames would still fit with some margin, to not oscillate
+constexpr double LowerLoad = 0.95;
+
+} // Anonymous namespace
+
+bool FrameSkipper::BeginFrame(double load, bool readback) {
+    if (max_skip == 0) {
+        return false;
+    }
+
+    double& average = skipping ? skipped_load : drawn_load;
+    average = average == 0.0 ? load : average + (load - average) * LoadWeight;
+
+    // Draws of skipped frames are lost, so titles reading rendered data back need all of them
+    if (readback) {
+        readback_cooldown = ReadbackCooldownFrames;
+    }
+    if (readback_cooldown > 0) {
+        readback_cooldown--;
+        level = 0;
+        position = 0;
+        skipping = false;
+        return false;
+    }
+
+    if (position < level) {
+        position++;
+        skipping = true;
+        return true;
+    }
+
+    if (CycleLoad(level) > 1.0) {
+        if (level < max_skip) {
+            level++;
+        }
+    } else if (level > 0 && CycleLoad(level - 1) < LowerLoad) {
+        level--;
+    }
+    position = 0;
+    skipping = false;
+    return false;
+}
+
+double FrameSkipper::CycleLoad(u32 skip) const {
+    return (drawn_load + skip * skipped_load) / (skip + 1);
+}
+
+} // namespace VideoCore
@@ -0,0 +1,55 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Decides which frames have their draws skipped when the host can not render every frame at the
+ * target speed. After each drawn frame the next `level` frames are skipped, the level is raised
+ * while the frames take longer than they may and lowered once one less skipped frame would fit.
+ */
+class FrameSkipper {
+public:
+    /// Frames drawn in a row after rendered data was read back to guest memory
+    static constexpr u32 ReadbackCooldownFrames = 600;
+
+    explicit FrameSkipper(u32 max_skip) : max_skip{max_skip} {}
+
+    /**
+     * Called at the beginning of every frame, returns whether its draws are skipped.
+     * @param load Host time the previous frame took over the time it may take at the target
+     * speed, zero when the speed is unlimited
+     * @param readback Whether the previous frame read rendered data back to guest memory
+     */
+    bool BeginFrame(double load, bool readback);
+
+    bool IsSkipping() const {
+        return skipping;
+    }
+
+    /// Number of frames skipped after each drawn frame
+    u32 GetLevel() const {
+        return level;
+    }
+
+private:
+    /// Average load of a drawn frame followed by `skip` skipped frames
+    double CycleLoad(u32 skip) const;
+
+    u32 max_skip;
+    u32 level = 0;
+    /// Frames skipped since the last drawn frame
+    u32 position = 0;
+    u32 readback_cooldown = 0;
+    bool skipping = false;
+    /// Moving averages of the load of the drawn and the skipped frames
+    double drawn_load = 0.0;
+    double skipped_load = 0.0;
+};
+
+} // namespace VideoCore
@@ -2,14 +2,111 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include "common/alignment.h"
 #include "core/memory.h"
 #include "video_core/pica_state.h"
 #include "video_core/rasterizer_accelerated.h"
+#include "video_core/video_core.h"
 
 namespace VideoCore {
 
+/// Maps each PICA register to the dirty groups that a write to it affects
+static constexpr std::array<u16, Pica::Regs::NUM_REGS> MakeDirtyRegsTable() {
+    std::array<u16, Pica::Regs::NUM_REGS> table{};
+    const auto assign = [&table](std::size_t begin, std::size_t end, DirtyRegs group) {
+        for (std::size_t id = begin; id < end; ++id) {
+            table[id] = 1 << static_cast<u32>(group);
+        }
+    };
+    const auto add = [&table](std::size_t begin, std::size_t end, DirtyRegs group) {
+        for (std::size_t id = begin; id < end; ++id) {
+            table[id] |= 1 << static_cast<u32>(group);
+        }
+    };
+    constexpr std::size_t vs_end = PICA_REG_INDEX(vs) + sizeof(Pica::ShaderRegs) / sizeof(u32);
+
+    assign(PICA_REG_INDEX(gs), PICA_REG_INDEX(vs), DirtyRegs::GeometryShader);
+    assign(PICA_REG_INDEX(vs), vs_end, DirtyRegs::VertexShader);
+    // The uniform registers are part of the shader units, but only dirty their uniforms
+    assign(PICA_REG_INDEX(vs.bool_uniforms), PICA_REG_INDEX(vs.bool_uniforms) + 1,
+           DirtyRegs::VSUniforms);
+    assign(PICA_REG_INDEX(vs.int_uniforms), PICA_REG_INDEX(vs.int_uniforms) + 4,
+           DirtyRegs::VSUniforms);
+    assign(PICA_REG_INDEX(vs.uniform_setup), PICA_REG_INDEX(vs.uniform_setup.set_value) + 8,
+           DirtyRegs::VSUniforms);
+    assign(PICA_REG_INDEX(gs.bool_uniforms), PICA_REG_INDEX(gs.bool_uniforms) + 1,
+           DirtyRegs::GSUniforms);
+    assign(PICA_REG_INDEX(gs.int_uniforms), PICA_REG_INDEX(gs.int_uniforms) + 4,
+           DirtyRegs::GSUniforms);
+    assign(PICA_REG_INDEX(gs.uniform_setup), PICA_REG_INDEX(gs.uniform_setup.set_value) + 8,
+           DirtyRegs::GSUniforms);
+
+    // The GS unit shares the program code and swizzle data uploaded to the VS units
+    add(PICA_REG_INDEX(vs.program.set_word), PICA_REG_INDEX(vs.program.set_word) + 8,
+        DirtyRegs::GeometryShader);
+    add(PICA_REG_INDEX(vs.swizzle_patterns.set_word),
+        PICA_REG_INDEX(vs.swizzle_patterns.set_word) + 8, DirtyRegs::GeometryShader);
+
+    // Pipeline registers that configure the GS stage
+    add(PICA_REG_INDEX(pipeline.use_gs), PICA_REG_INDEX(pipeline.use_gs) + 1,
+        DirtyRegs::GeometryShader);
+    add(PICA_REG_INDEX(pipeline.gs_unit_exclusive_configuration),
+        PICA_REG_INDEX(pipeline.gs_unit_exclusive_configuration) + 1, DirtyRegs::GeometryShader);
+    add(PICA_REG_INDEX(pipeline.vs_outmap_total_minus_1_a),
+        PICA_REG_INDEX(pipeline.vs_outmap_total_minus_1_a) + 1, DirtyRegs::GeometryShader);
+    add(PICA_REG_INDEX(pipeline.gs_config), PICA_REG_INDEX(pipeline.gs_config) + 1,
+        DirtyRegs::GeometryShader);
+
+    // Both shader configs map the VS outputs to semantics
+    add(PICA_REG_INDEX(rasterizer.vs_output_total), PICA_REG_INDEX(rasterizer.vs_output_total) + 1,
+        DirtyRegs::VertexShader);
+    add(PICA_REG_INDEX(rasterizer.vs_output_attributes),
+        PICA_REG_INDEX(rasterizer.vs_output_attributes) + 7, DirtyRegs::VertexShader);
+    add(PICA_REG_INDEX(rasterizer.vs_output_total), PICA_REG_INDEX(rasterizer.vs_output_total) + 1,
+        DirtyRegs::GeometryShader);
+    add(PICA_REG_INDEX(rasterizer.vs_output_attributes),
+        PICA_REG_INDEX(rasterizer.vs_output_attributes) + 7, DirtyRegs::GeometryShader);
+    add(PICA_REG_INDEX(vs.output_mask), PICA_REG_INDEX(vs.output_mask) + 1,
+        DirtyRegs::GeometryShader);
+    return table;
+}
+
+constexpr std::array<u16, Pica::Regs::NUM_REGS> DirtyRegsTable = MakeDirtyRegsTable();
+
+/// Most vertices a run of merged draws holds, so that its indices fit in 16 bits
+constexpr u32 MaxMergedVertices = 0x10000;
+/// Most indices a run of merged draws holds
+constexpr u32 MaxMergedIndices = 0x10000;
+/// Vertex buffer space reserved for a run of merged draws
+constexpr u32 MergedVertexBytes = 256 * 1024;
+
+/// Returns true if writes to the register only select the vertices of the next draw
+static bool IsDrawParameterRegister(u32 id) {
+    if (id >= PICA_REG_INDEX(pipeline.vertex_attributes.attribute_loaders) &&
+        id < PICA_REG_INDEX(pipeline.index_array)) {
+        // Only the data offsets of the attribute loaders, not their layout
+        return (id - PICA_REG_INDEX(pipeline.vertex_attributes.attribute_loaders)) % 3 == 0;
+    }
+    switch (id) {
+    case PICA_REG_INDEX(framebuffer.framebuffer):     // Framebuffer invalidate
+    case PICA_REG_INDEX(framebuffer.framebuffer) + 1: // Framebuffer flush
+    case PICA_REG_INDEX(pipeline.vertex_attributes):  // Base address
+    case PICA_REG_INDEX(pipeline.index_array):
+    case PICA_REG_INDEX(pipeline.num_vertices):
+    case PICA_REG_INDEX(pipeline.vertex_offset):
+    case PICA_REG_INDEX(pipeline.trigger_draw):
+    case PICA_REG_INDEX(pipeline.trigger_draw_indexed):
+    case PICA_REG_INDEX(pipeline.gpu_mode):
+    case PICA_REG_INDEX(pipeline.restart_primitive):
+        return true;
+    default:
+        return false;
+    }
+}
+
 static Common::Vec4f ColorRGBA8(const u32 color) {
     const auto rgba =
         Common::Vec4u{color >> 0 & 0xFF, color >> 8 & 0xFF, color >> 16 & 0xFF, color >> 24 & 0xFF};
@@ -52,7 +149,7 @@ RasterizerAccelerated::HardwareVertex::HardwareVertex(const Pica::Shader::Output
 
 RasterizerAccelerated::RasterizerAccelerated(Memory::MemorySystem& memory_)
     : memory{memory_}, regs{Pica::g_state.regs} {
-    uniform_block_data.lighting_lut_dirty.fill(true);
+    MarkLUTsDirty();
 }
 
 /**
@@ -128,7 +225,229 @@ RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray
     return {vertex_min, vertex_max, vs_input_size};
 }
 
+u32 RasterizerAccelerated::GetMergedVertexCapacity(bool is_indexed,
+                                                   const VertexArrayInfo& info) const {
+    u32 stride = 0;
+    for (const auto& loader : regs.pipeline.vertex_attributes.attribute_loaders) {
+        if (loader.component_count != 0 && loader.byte_count != 0) {
+            stride += loader.byte_count;
+        }
+    }
+    const u32 vertex_num = info.vs_input_index_max - info.vs_input_index_min + 1;
+    if (stride == 0 || vertex_num > MaxMergedVertices ||
+        (is_indexed && regs.pipeline.num_vertices > MaxMergedIndices)) {
+        return 0;
+    }
+
+    // Keep the loader regions 4 byte aligned
+    const u32 capacity = Common::AlignUp(std::max(MergedVertexBytes / stride, vertex_num), 4);
+    return std::min(capacity, MaxMergedVertices);
+}
+
+u32 RasterizerAccelerated::GetMergedVertexSize(u32 vertex_capacity) const {
+    u32 size = 0;
+    for (const auto& loader : regs.pipeline.vertex_attributes.attribute_loaders) {
+        if (loader.component_count != 0 && loader.byte_count != 0) {
+            size += loader.byte_count * vertex_capacity;
+        }
+    }
+    return size;
+}
+
+u32 RasterizerAccelerated::MergedDraw::GetVertexSize() const {
+    u32 size = 0;
+    u32 used_size = 0;
+    for (const u32 stride : loader_strides) {
+        if (stride != 0) {
+            used_size = size + stride * num_vertices;
+            size += stride * vertex_capacity;
+        }
+    }
+    return used_size;
+}
+
+void RasterizerAccelerated::BeginMergedDraw(u8* vertex_data, u32 vertex_capacity, bool is_indexed,
+                                            const VertexArrayInfo& info) {
+    const auto& loaders = regs.pipeline.vertex_attributes.attribute_loaders;
+    for (std::size_t i = 0; i < merged_draw.loader_strides.size(); ++i) {
+        const bool enabled = loaders[i].component_count != 0 && loaders[i].byte_count != 0;
+        merged_draw.loader_strides[i] = enabled ? loaders[i].byte_count.Value() : 0;
+    }
+
+    const auto target_range = [](PAddr addr, u32 size) {
+        return addr != 0 ? std::make_pair(addr, addr + size) : std::make_pair(PAddr{0}, PAddr{0});
+    };
+    const auto& framebuffer = regs.framebuffer.framebuffer;
+    const u32 num_pixels = framebuffer.GetWidth() * framebuffer.GetHeight();
+    merged_draw.targets[0] = target_range(
+        framebuffer.GetColorBufferPhysicalAddress(),
+        num_pixels * Pica::FramebufferRegs::BytesPerColorPixel(framebuffer.color_format));
+    merged_draw.targets[1] = target_range(
+        framebuffer.GetDepthBufferPhysicalAddress(),
+        num_pixels * Pica::FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format));
+
+    merged_draw.vertex_data = vertex_data;
+    merged_draw.vertex_capacity = vertex_capacity;
+    merged_draw.num_vertices = 0;
+    merged_draw.is_indexed = is_indexed;
+    merged_draw.indices.clear();
+    AppendMergedIndices(info);
+    merged_draw.num_vertices = info.vs_input_index_max - info.vs_input_index_min + 1;
+    merged_draw.num_draws = 1;
+}
+
+bool RasterizerAccelerated::MergeDraw(bool is_indexed) {
+    if (is_indexed != merged_draw.is_indexed || IsVertexShaderDirty()) {
+        return false;
+    }
+    if (is_indexed &&
+        merged_draw.indices.size() + regs.pipeline.num_vertices > MaxMergedIndices) {
+        return false;
+    }
+
+    // Flushing the vertex data ends the run if it was rendered by the run itself
+    const VertexArrayInfo info = AnalyzeVertexArray(is_indexed);
+    const u32 vertex_num = info.vs_input_index_max - info.vs_input_index_min + 1;
+    const auto& vertex_attributes = regs.pipeline.vertex_attributes;
+    const PAddr base_address = vertex_attributes.GetPhysicalBaseAddress();
+    for (const auto& loader : vertex_attributes.attribute_loaders) {
+        if (loader.component_count != 0 && loader.byte_count != 0) {
+            FlushRegion(base_address + loader.data_offset +
+                            info.vs_input_index_min * loader.byte_count,
+                        loader.byte_count * vertex_num);
+        }
+    }
+    if (merged_draw.num_draws == 0 ||
+        merged_draw.num_vertices + vertex_num > merged_draw.vertex_capacity) {
+        return false;
+    }
+
+    u8* region = merged_draw.vertex_data;
+    for (const auto& loader : vertex_attributes.attribute_loaders) {
+        if (loader.component_count == 0 || loader.byte_count == 0) {
+            continue;
+        }
+        const PAddr data_addr =
+            base_address + loader.data_offset + info.vs_input_index_min * loader.byte_count;
+        std::memcpy(region + merged_draw.num_vertices * loader.byte_count,
+                    memory.GetPhysicalPointer(data_addr), loader.byte_count * vertex_num);
+        region += loader.byte_count * merged_draw.vertex_capacity;
+    }
+
+    AppendMergedIndices(info);
+    merged_draw.num_vertices += vertex_num;
+    merged_draw.num_draws++;
+    draw_stats.merged++;
+    return true;
+}
+
+void RasterizerAccelerated::AppendMergedIndices(const VertexArrayInfo& info) {
+    if (!merged_draw.is_indexed) {
+        return;
+    }
+
+    const auto& index_info = regs.pipeline.index_array;
+    const u8* index_address_8 = memory.GetPhysicalPointer(
+        regs.pipeline.vertex_attributes.GetPhysicalBaseAddress() + index_info.offset);
+    const u16* index_address_16 = reinterpret_cast<const u16*>(index_address_8);
+    const bool index_u16 = index_info.format != 0;
+
+    const u32 base_vertex = merged_draw.num_vertices - info.vs_input_index_min;
+    for (u32 index = 0; index < regs.pipeline.num_vertices; ++index) {
+        const u32 vertex = index_u16 ? index_address_16[index] : index_address_8[index];
+        merged_draw.indices.push_back(static_cast<u16>(vertex + base_vertex));
+    }
+}
+
+bool RasterizerAccelerated::OverlapsMergedTargets(PAddr addr, u32 size) const {
+    if (merged_draw.num_draws == 0) {
+        return false;
+    }
+    return std::any_of(merged_draw.targets.begin(), merged_draw.targets.end(),
+                       [addr, size](const auto& target) {
+                           return addr < target.second && target.first < addr + size;
+                       });
+}
+
+bool RasterizerAccelerated::IsVertexShaderDirty() {
+    // The accurate multiplication toggle is part of the vertex shader config
+    if (vs_accurate_mul != VideoCore::g_hw_shader_accurate_mul) {
+        vs_accurate_mul = VideoCore::g_hw_shader_accurate_mul;
+        MarkDirty(DirtyRegs::VertexShader);
+    }
+    return IsDirty(DirtyRegs::VertexShader);
+}
+
+void RasterizerAccelerated::MarkLUTsDirty() {
+    for (auto& range : uniform_block_data.lighting_lut_dirty) {
+        range = {0, 256};
+    }
+    uniform_block_data.lighting_lut_dirty_any = true;
+    uniform_block_data.fog_lut_dirty = {0, 128};
+    uniform_block_data.proctex_noise_lut_dirty = {0, 128};
+    uniform_block_data.proctex_color_map_dirty = {0, 128};
+    uniform_block_data.proctex_alpha_map_dirty = {0, 128};
+    uniform_block_data.proctex_lut_dirty = {0, 256};
+    uniform_block_data.proctex_diff_lut_dirty = {0, 256};
+}
+
+/// Converts the entries of range from source into dest and narrows range to the changed entries
+template <typename Range, typename Source, typename Dest, typename Convert>
+static bool SyncLUTRange(Range& range, const Source& source, Dest& dest, Convert&& convert) {
+    u32 begin = range.end;
+    u32 end = range.begin;
+    for (u32 entry = range.begin; entry < range.end; entry++) {
+        const auto value = convert(source[entry]);
+        if (value != dest[entry]) {
+            dest[entry] = value;
+            begin = std::min(begin, entry);
+            end = entry + 1;
+        }
+    }
+    range = {begin, end};
+    return !range.Empty();
+}
+
+bool RasterizerAccelerated::SyncLUTData() {
+    const auto to_value = [](const auto& entry) {
+        return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+    };
+    const auto to_color = [](const auto& entry) {
+        const auto rgba = entry.ToVector() / 255.0f;
+        return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+    };
+
+    bool changed = false;
+    if (uniform_block_data.lighting_lut_dirty_any) {
+        for (std::size_t index = 0; index < lighting_lut_data.size(); index++) {
+            changed |= SyncLUTRange(uniform_block_data.lighting_lut_dirty[index],
+                                    Pica::g_state.lighting.luts[index], lighting_lut_data[index],
+                                    to_value);
+        }
+        uniform_block_data.lighting_lut_dirty_any = false;
+    }
+
+    const auto& proctex = Pica::g_state.proctex;
+    changed |= SyncLUTRange(uniform_block_data.fog_lut_dirty, Pica::g_state.fog.lut, fog_lut_data,
+                            to_value);
+    changed |= SyncLUTRange(uniform_block_data.proctex_noise_lut_dirty, proctex.noise_table,
+                            proctex_noise_lut_data, to_value);
+    changed |= SyncLUTRange(uniform_block_data.proctex_color_map_dirty, proctex.color_map_table,
+                            proctex_color_map_data, to_value);
+    changed |= SyncLUTRange(uniform_block_data.proctex_alpha_map_dirty, proctex.alpha_map_table,
+                            proctex_alpha_map_data, to_value);
+    changed |= SyncLUTRange(uniform_block_data.proctex_lut_dirty, proctex.color_table,
+                            proctex_lut_data, to_color);
+    changed |= SyncLUTRange(uniform_block_data.proctex_diff_lut_dirty, proctex.color_diff_table,
+                            proctex_diff_lut_data, to_color);
+    return changed;
+}
+
 void RasterizerAccelerated::SyncEntireState() {
+    FlushMergedDraw();
+    dirty_regs.set();
+    MarkLUTsDirty();
+
     // Sync renderer-specific fixed-function state
     SyncFixedState();
 
@@ -166,6 +485,12 @@ void RasterizerAccelerated::SyncEntireState() {
 }
 
 void RasterizerAccelerated::NotifyPicaRegisterChanged(u32 id) {
+    // The pending draws use the state from before the write
+    if (merged_draw.num_draws != 0 && !IsDrawParameterRegister(id)) {
+        FlushMergedDraw();
+    }
+    dirty_regs |= decltype(dirty_regs){DirtyRegsTable[id]};
+
     switch (id) {
     // Depth modifiers
     case PICA_REG_INDEX(rasterizer.viewport_depth_range):
@@ -197,7 +522,8 @@ void RasterizerAccelerated::NotifyPicaRegisterChanged(u32 id) {
     case PICA_REG_INDEX(texturing.fog_lut_data[5]):
     case PICA_REG_INDEX(texturing.fog_lut_data[6]):
     case PICA_REG_INDEX(texturing.fog_lut_data[7]):
-        uniform_block_data.fog_lut_dirty = true;
+        // The offset was already advanced past the written entry
+        uniform_block_data.fog_lut_dirty.Add((regs.texturing.fog_lut_offset - 1) % 128);
         break;
 
     // ProcTex state
@@ -221,26 +547,28 @@ void RasterizerAccelerated::NotifyPicaRegisterChanged(u32 id) {
     case PICA_REG_INDEX(texturing.proctex_lut_data[4]):
     case PICA_REG_INDEX(texturing.proctex_lut_data[5]):
     case PICA_REG_INDEX(texturing.proctex_lut_data[6]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[7]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[7]): {
         using Pica::TexturingRegs;
+        const u32 index = (regs.texturing.proctex_lut_config.index - 1) & 0xFF;
         switch (regs.texturing.proctex_lut_config.ref_table.Value()) {
         case TexturingRegs::ProcTexLutTable::Noise:
-            uniform_block_data.proctex_noise_lut_dirty = true;
+            uniform_block_data.proctex_noise_lut_dirty.Add(index % 128);
             break;
         case TexturingRegs::ProcTexLutTable::ColorMap:
-            uniform_block_data.proctex_color_map_dirty = true;
+            uniform_block_data.proctex_color_map_dirty.Add(index % 128);
             break;
         case TexturingRegs::ProcTexLutTable::AlphaMap:
-            uniform_block_data.proctex_alpha_map_dirty = true;
+            uniform_block_data.proctex_alpha_map_dirty.Add(index % 128);
             break;
         case TexturingRegs::ProcTexLutTable::Color:
-            uniform_block_data.proctex_lut_dirty = true;
+            uniform_block_data.proctex_lut_dirty.Add(index);
             break;
         case TexturingRegs::ProcTexLutTable::ColorDiff:
-            uniform_block_data.proctex_diff_lut_dirty = true;
+            uniform_block_data.proctex_diff_lut_dirty.Add(index);
             break;
         }
         break;
+    }
 
     // Alpha test
     case PICA_REG_INDEX(framebuffer.output_merger.alpha_test):
@@ -581,7 +909,7 @@ void RasterizerAccelerated::NotifyPicaRegisterChanged(u32 id) {
     case PICA_REG_INDEX(lighting.lut_data[6]):
     case PICA_REG_INDEX(lighting.lut_data[7]): {
         const auto& lut_config = regs.lighting.lut_config;
-        uniform_block_data.lighting_lut_dirty[lut_config.type] = true;
+        uniform_block_data.lighting_lut_dirty[lut_config.type].Add((lut_config.index - 1) & 0xFF);
         uniform_block_data.lighting_lut_dirty_any = true;
         break;
     }
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <bitset>
 #include "common/vector_math.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/regs_texturing.h"
@@ -19,6 +21,16 @@ struct Regs;
 
 namespace VideoCore {
 
+/// Groups of PICA registers whose writes are tracked, so the state derived from them is only
+/// rebuilt when one of their registers changed
+enum class DirtyRegs : u32 {
+    GeometryShader, ///< GS unit, GS pipeline setup and the VS output mapping
+    VertexShader,   ///< VS configuration, program code and output mapping
+    VSUniforms,     ///< VS bool, int and float uniforms
+    GSUniforms,     ///< GS bool, int and float uniforms
+    NumGroups,
+};
+
 class RasterizerAccelerated : public RasterizerInterface {
 public:
     RasterizerAccelerated(Memory::MemorySystem& memory);
@@ -100,18 +112,60 @@ protected:
     /// Syncs the clip coefficients to match the PICA register
     void SyncClipCoef();
 
+    /// Returns true if a register of the group was written since the group was last cleared
+    bool IsDirty(DirtyRegs group) const {
+        return dirty_regs.test(static_cast<std::size_t>(group));
+    }
+
+    void MarkDirty(DirtyRegs group) {
+        dirty_regs.set(static_cast<std::size_t>(group));
+    }
+
+    void ClearDirty(DirtyRegs group) {
+        dirty_regs.reset(static_cast<std::size_t>(group));
+    }
+
+    /// Returns true if the vertex shader config has to be rebuilt for the next draw
+    bool IsVertexShaderDirty();
+
+    /// Marks every entry of the lighting, fog and proctex LUTs as written
+    void MarkLUTsDirty();
+
+    /// Converts the written LUT entries into the host LUT data. The dirty ranges are narrowed to
+    /// the entries whose value changed, returns true if any LUT has to be uploaded
+    bool SyncLUTData();
+
 protected:
+    /// Range of lookup table entries that have to be uploaded
+    struct LUTRange {
+        u32 begin = 0;
+        u32 end = 0;
+
+        bool Empty() const {
+            return begin >= end;
+        }
+
+        void Add(u32 entry) {
+            begin = Empty() ? entry : std::min(begin, entry);
+            end = std::max(end, entry + 1);
+        }
+
+        void Clear() {
+            begin = end = 0;
+        }
+    };
+
     /// Structure that keeps tracks of the uniform state
     struct UniformBlockData {
         Pica::Shader::UniformData data{};
-        std::array<bool, Pica::LightingRegs::NumLightingSampler> lighting_lut_dirty{};
+        std::array<LUTRange, Pica::LightingRegs::NumLightingSampler> lighting_lut_dirty{};
         bool lighting_lut_dirty_any = true;
-        bool fog_lut_dirty = true;
-        bool proctex_noise_lut_dirty = true;
-        bool proctex_color_map_dirty = true;
-        bool proctex_alpha_map_dirty = true;
-        bool proctex_lut_dirty = true;
-        bool proctex_diff_lut_dirty = true;
+        LUTRange fog_lut_dirty{};
+        LUTRange proctex_noise_lut_dirty{};
+        LUTRange proctex_color_map_dirty{};
+        LUTRange proctex_alpha_map_dirty{};
+        LUTRange proctex_lut_dirty{};
+        LUTRange proctex_diff_lut_dirty{};
         bool dirty = true;
     };
 
@@ -139,6 +193,54 @@ protected:
     /// Retrieve the range and the size of the input vertex
     VertexArrayInfo AnalyzeVertexArray(bool is_indexed, u32 stride_alignment = 1);
 
+    /// Returns the number of vertices a run of merged draws started by the current draw can hold,
+    /// zero if the current draw can't start a run
+    u32 GetMergedVertexCapacity(bool is_indexed, const VertexArrayInfo& info) const;
+
+    /// Returns the size of the vertex buffer space reserved for a run, each attribute loader has
+    /// its own region of vertex_capacity vertices
+    u32 GetMergedVertexSize(u32 vertex_capacity) const;
+
+    /// Starts a run with the current draw, its vertices are already stored at vertex_data
+    void BeginMergedDraw(u8* vertex_data, u32 vertex_capacity, bool is_indexed,
+                         const VertexArrayInfo& info);
+
+    /// Appends the current draw to the pending run, returns false if it can't be merged
+    bool MergeDraw(bool is_indexed);
+
+    /// Appends the indices of the current draw, rebased to the end of the loader regions
+    void AppendMergedIndices(const VertexArrayInfo& info);
+
+    /// Returns true if the region overlaps a render target of the pending run
+    bool OverlapsMergedTargets(PAddr addr, u32 size) const;
+
+    /// Issues the pending run of merged draws
+    virtual void FlushMergedDraw() {}
+
+    /// Consecutive accelerated draws that share all of their state, issued as a single draw
+    struct MergedDraw {
+        /// Reserved vertex buffer space of the run
+        u8* vertex_data{};
+        /// Strides of the attribute loader regions, zero for disabled loaders
+        std::array<u32, 12> loader_strides{};
+        u32 vertex_capacity{}; ///< Vertices that fit in each loader region
+        u32 num_vertices{};    ///< Vertices stored in each loader region
+        u32 num_draws{};       ///< PICA draws in the run, zero when none is pending
+        bool is_indexed{};
+        /// Indices of all draws, rebased to the loader regions
+        std::vector<u16> indices;
+        /// Address ranges of the color and depth buffers
+        std::array<std::pair<PAddr, PAddr>, 2> targets{};
+
+        /// Returns the used size of the reserved vertex buffer space
+        u32 GetVertexSize() const;
+    };
+
+    struct DrawStats {
+        u64 submitted = 0; ///< Host draws issued for accelerated PICA draws
+        u64 merged = 0;    ///< PICA draws merged into the draw of an earlier one
+    };
+
 protected:
     Memory::MemorySystem& memory;
     Pica::Regs& regs;
@@ -146,6 +248,10 @@ protected:
     VertexArrayInfo vertex_info{};
     std::vector<HardwareVertex> vertex_batch;
     bool shader_dirty = true;
+    std::bitset<static_cast<std::size_t>(DirtyRegs::NumGroups)> dirty_regs{~0ULL};
+    bool vs_accurate_mul = false;
+    MergedDraw merged_draw{};
+    DrawStats draw_stats{};
 
     UniformBlockData uniform_block_data{};
     std::array<std::array<Common::Vec2f, 256>, Pica::LightingRegs::NumLightingSampler>
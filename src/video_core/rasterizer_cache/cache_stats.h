@@ -0,0 +1,88 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <utility>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/// Activity of the rasterizer cache, counted over one frame or over the whole session
+struct RasterizerCacheStats {
+    u64 surfaces_created{};
+    u64 surfaces_destroyed{};
+    u64 texture_hits{};
+    u64 texture_misses{};
+    u64 framebuffer_hits{};
+    u64 framebuffer_misses{};
+    u64 uploads{};
+    u64 uploaded_bytes{};
+    u64 hash_skipped_uploads{};
+    u64 hash_skipped_bytes{};
+    u64 downloads{};
+    u64 downloaded_bytes{};
+    u64 flushes{};
+    u64 flushed_bytes{};
+    u64 invalidations{};
+    u64 invalidated_bytes{};
+    u64 codec_reinterprets{};
+    /// Reinterpretations without a reinterpreter, the surface is loaded from guest memory
+    u64 reinterpret_fallbacks{};
+    /// Times the cache waited on the GPU to read back a batch of downloads
+    u64 download_stalls{};
+    /// Surfaces kept across a saved or loaded state, as their guest memory was unchanged
+    u64 state_kept_surfaces{};
+    /// Surfaces dropped by a saved or loaded state
+    u64 state_evicted_surfaces{};
+    /// Cube faces copied from a face surface that changed since the cube was last used
+    u64 cube_face_copies{};
+    /// Cube faces that were left as they were since their face surface did not change
+    u64 cube_face_skips{};
+    /// Clears that became the load operation of a render pass or were overwritten before use
+    u64 elided_clears{};
+    /// Texture copies with an output stride no surface has, done on the GPU one line at a time
+    u64 line_texture_copies{};
+
+    using Field = std::pair<const char*, u64 RasterizerCacheStats::*>;
+
+    /// Names and members of all counters, in the order they are shown
+    static constexpr std::array<Field, 25> Fields{{
+        {"surfaces_created", &RasterizerCacheStats::surfaces_created},
+        {"surfaces_destroyed", &RasterizerCacheStats::surfaces_destroyed},
+        {"texture_hits", &RasterizerCacheStats::texture_hits},
+        {"texture_misses", &RasterizerCacheStats::texture_misses},
+        {"framebuffer_hits", &RasterizerCacheStats::framebuffer_hits},
+        {"framebuffer_misses", &RasterizerCacheStats::framebuffer_misses},
+        {"uploads", &RasterizerCacheStats::uploads},
+        {"uploaded_bytes", &RasterizerCacheStats::uploaded_bytes},
+        {"hash_skipped_uploads", &RasterizerCacheStats::hash_skipped_uploads},
+        {"hash_skipped_bytes", &RasterizerCacheStats::hash_skipped_bytes},
+        {"downloads", &RasterizerCacheStats::downloads},
+        {"downloaded_bytes", &RasterizerCacheStats::downloaded_bytes},
+        {"flushes", &RasterizerCacheStats::flushes},
+        {"flushed_bytes", &RasterizerCacheStats::flushed_bytes},
+        {"invalidations", &RasterizerCacheStats::invalidations},
+        {"invalidated_bytes", &RasterizerCacheStats::invalidated_bytes},
+        {"codec_reinterprets", &RasterizerCacheStats::codec_reinterprets},
+        {"reinterpret_fallbacks", &RasterizerCacheStats::reinterpret_fallbacks},
+        {"download_stalls", &RasterizerCacheStats::download_stalls},
+        {"state_kept_surfaces", &RasterizerCacheStats::state_kept_surfaces},
+        {"state_evicted_surfaces", &RasterizerCacheStats::state_evicted_surfaces},
+        {"cube_face_copies", &RasterizerCacheStats::cube_face_copies},
+        {"cube_face_skips", &RasterizerCacheStats::cube_face_skips},
+        {"elided_clears", &RasterizerCacheStats::elided_clears},
+        {"line_texture_copies", &RasterizerCacheStats::line_texture_copies},
+    }};
+
+    RasterizerCacheStats& operator+=(const RasterizerCacheStats& other) {
+        for (const auto& [name, member] : Fields) {
+            this->*member += other.*member;
+        }
+        return *this;
+    }
+};
+
+} // namespace VideoCore
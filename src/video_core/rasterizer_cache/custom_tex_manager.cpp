@@ -2,11 +2,15 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <thread>
 #include "common/bit_util.h"
 #include "common/file_util.h"
 #include "common/hash.h"
 #include "common/image_util.h"
+#include "common/scope_exit.h"
 #include "common/scratch_buffer.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "video_core/rasterizer_cache/custom_tex_manager.h"
 #include "video_core/rasterizer_cache/surface_params.h"
@@ -17,6 +21,37 @@ namespace {
 
 using namespace Common;
 
+/// Name of the pack manifest, delete it after adding or removing textures to index them again
+constexpr char ManifestName[] = "manifest.ctm";
+constexpr u32 ManifestMagic = 0x4D544321; // "!CTM"
+constexpr u32 ManifestVersion = 2;
+
+/// Number of textures that may wait for the dumper, each one holds a copy of its pixels
+constexpr u32 MaxPendingDumps = 64;
+
+struct ManifestHeader {
+    u32 magic;
+    u32 version;
+    u32 num_entries;
+    u32 reserved{};
+};
+static_assert(sizeof(ManifestHeader) == 16);
+
+/// Followed by path_size bytes of the texture path relative to the pack directory
+struct ManifestEntry {
+    u64 hash;
+    u32 width;
+    u32 height;
+    u64 staging_size;
+    u64 file_size;
+    s64 modification_time;
+    u32 format;
+    u32 file_format;
+    u32 path_size;
+    u32 reserved{};
+};
+static_assert(sizeof(ManifestEntry) == 56);
+
 CustomFileFormat MakeFileFormat(std::string_view ext) {
     if (ext == "png") {
         return CustomFileFormat::PNG;
@@ -67,7 +102,8 @@ void CustomTexManager::FindCustomTextures() {
     // If custom textures isn't enabled we don't want to create the thread pool
     // so don't do it in the constructor, do it here instead.
     workers = std::make_unique<Common::ThreadWorker>(
-        std::max(std::thread::hardware_concurrency(), 2U) - 1, "Custom textures");
+        Common::GetWorkerThreadCount(std::max(std::thread::hardware_concurrency(), 2U) - 1),
+        "Custom textures");
 
     // Custom textures are currently stored as
     // [TitleID]/tex1_[width]x[height]_[64-bit hash]_[format].png
@@ -80,6 +116,52 @@ void CustomTexManager::FindCustomTextures() {
         FileUtil::CreateFullPath(load_path);
     }
 
+    // Packs with a manifest are loaded without walking the directory tree or opening any file
+    const std::string manifest_path = load_path + ManifestName;
+    bool manifest_stale = false;
+    const bool has_manifest = ReadManifest(load_path, manifest_path, manifest_stale);
+    if (!has_manifest) {
+        ScanTextures(load_path);
+    }
+
+    // Assign each texture to the hash map
+    for (const auto& texture : custom_textures) {
+        if (!texture) {
+            continue;
+        }
+        const unsigned long long hash = texture->hash;
+        auto [it, new_texture] = custom_texture_map.try_emplace(hash);
+        if (!new_texture) {
+            LOG_ERROR(Render, "Textures {} and {} conflict, ignoring!",
+                      custom_texture_map[hash]->path, texture->path);
+            continue;
+        }
+        it->second = texture.get();
+    }
+
+    if ((!has_manifest || manifest_stale) && !custom_texture_map.empty()) {
+        WriteManifest(load_path, manifest_path);
+    }
+
+    // Decode everything up front, preloaded textures are never released
+    preloaded = Settings::values.preload_textures.GetValue();
+    if (preloaded) {
+        for (const auto& [hash, texture] : custom_texture_map) {
+            texture->state = DecodeState::Pending;
+            workers->QueueWork([this, texture] {
+                LoadTexture(*texture);
+                texture->MarkDecoded();
+            });
+        }
+        workers->WaitForRequests();
+        LOG_INFO(Render, "Preloaded {} custom textures, {} MiB", custom_texture_map.size(),
+                 decoded_memory.load() >> 20);
+    }
+
+    textures_loaded = true;
+}
+
+void CustomTexManager::ScanTextures(const std::string& load_path) {
     FileUtil::FSTEntry texture_dir;
     std::vector<FileUtil::FSTEntry> textures;
     // 64 nested folders should be plenty for most cases
@@ -135,23 +217,119 @@ void CustomTexManager::FindCustomTextures() {
     }
 
     workers->WaitForRequests();
+}
 
-    // Assign each texture to the hash map
-    for (const auto& texture : custom_textures) {
-        if (!texture) {
-            continue;
+bool CustomTexManager::ReadManifest(const std::string& load_path,
+                                    const std::string& manifest_path, bool& stale) {
+    FileUtil::IOFile file{manifest_path, "rb"};
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    // The manifest is small compared to the pack, read it with a single sequential read
+    std::vector<u8> manifest(file.GetSize());
+    if (manifest.size() < sizeof(ManifestHeader) ||
+        file.ReadBytes(manifest.data(), manifest.size()) != manifest.size()) {
+        return false;
+    }
+
+    ManifestHeader header;
+    std::memcpy(&header, manifest.data(), sizeof(header));
+    if (header.magic != ManifestMagic || header.version != ManifestVersion) {
+        LOG_WARNING(Render, "Ignoring outdated custom texture manifest {}", manifest_path);
+        return false;
+    }
+
+    std::size_t offset = sizeof(header);
+    custom_textures.resize(header.num_entries);
+    for (auto& texture : custom_textures) {
+        ManifestEntry entry;
+        if (offset + sizeof(entry) > manifest.size()) {
+            break;
         }
-        const unsigned long long hash = texture->hash;
-        auto [it, new_texture] = custom_texture_map.try_emplace(hash);
-        if (!new_texture) {
-            LOG_ERROR(Render, "Textures {} and {} conflict, ignoring!",
-                      custom_texture_map[hash]->path, texture->path);
+        std::memcpy(&entry, manifest.data() + offset, sizeof(entry));
+        offset += sizeof(entry);
+        if (offset + entry.path_size > manifest.size()) {
+            break;
+        }
+
+        texture = std::make_unique<CustomTexture>();
+        texture->width = entry.width;
+        texture->height = entry.height;
+        texture->hash = entry.hash;
+        texture->format = static_cast<CustomPixelFormat>(entry.format);
+        texture->file_format = static_cast<CustomFileFormat>(entry.file_format);
+        texture->path = load_path;
+        texture->path.append(reinterpret_cast<const char*>(manifest.data() + offset),
+                             entry.path_size);
+        texture->staging_size = entry.staging_size;
+        texture->file_size = entry.file_size;
+        texture->modification_time = entry.modification_time;
+        offset += entry.path_size;
+    }
+
+    if (offset != manifest.size()) {
+        LOG_ERROR(Render, "Custom texture manifest {} is corrupted, rescanning", manifest_path);
+        custom_textures.clear();
+        return false;
+    }
+
+    // A stat is far cheaper than parsing the file, so files replaced in the pack are still noticed.
+    // Without a status, like on Android, the manifest has to be trusted.
+    std::size_t num_changed = 0;
+    for (auto& texture : custom_textures) {
+        const auto status = FileUtil::GetStatus(texture->path);
+        if (!status || (status->size == texture->file_size &&
+                        status->modification_time == texture->modification_time)) {
             continue;
         }
-        it->second = texture.get();
+        QueryTexture(*texture);
+        num_changed++;
+    }
+    if (num_changed > 0) {
+        LOG_INFO(Render, "{} custom textures changed since {} was written", num_changed,
+                 manifest_path);
+        stale = true;
     }
 
-    textures_loaded = true;
+    LOG_INFO(Render, "Loaded {} custom textures from {}", custom_textures.size(), manifest_path);
+    return true;
+}
+
+void CustomTexManager::WriteManifest(const std::string& load_path,
+                                     const std::string& manifest_path) {
+    FileUtil::IOFile file{manifest_path, "wb"};
+    if (!file.IsOpen()) {
+        LOG_WARNING(Render, "Unable to write custom texture manifest {}", manifest_path);
+        return;
+    }
+
+    const ManifestHeader header = {
+        .magic = ManifestMagic,
+        .version = ManifestVersion,
+        .num_entries = static_cast<u32>(custom_texture_map.size()),
+    };
+    file.WriteObject(header);
+
+    for (const auto& [hash, texture] : custom_texture_map) {
+        // Paths are stored relative to the pack, so manifests can be shipped with it
+        const std::string_view path = std::string_view{texture->path}.substr(load_path.size());
+        const ManifestEntry entry = {
+            .hash = texture->hash,
+            .width = texture->width,
+            .height = texture->height,
+            .staging_size = texture->staging_size,
+            .file_size = texture->file_size,
+            .modification_time = texture->modification_time,
+            .format = static_cast<u32>(texture->format),
+            .file_format = static_cast<u32>(texture->file_format),
+            .path_size = static_cast<u32>(path.size()),
+        };
+        file.WriteObject(entry);
+        file.WriteString(path);
+    }
+    LOG_INFO(Render, "Wrote manifest of {} custom textures to {}", custom_texture_map.size(),
+             manifest_path);
 }
 
 u64 CustomTexManager::ComputeHash(const SurfaceParams& params, std::span<u8> data) {
@@ -188,6 +366,16 @@ void CustomTexManager::DumpTexture(const SurfaceParams& params, u32 level, std::
         return;
     }
 
+    // Skip the texture for now if the dumper is behind, it is dumped on a later upload
+    if (num_pending_dumps >= MaxPendingDumps) {
+        return;
+    }
+    if (!dump_workers) {
+        dump_workers = std::make_unique<Common::ThreadWorker>(
+            Common::GetWorkerThreadCount(std::max(std::thread::hardware_concurrency() / 2, 1U)),
+            "Texture dumper");
+    }
+
     // Allocate a temporary buffer for the thread to use
     const u32 decoded_size = width * height * 4;
     ScratchBuffer<u8> pixels(data_size + decoded_size);
@@ -195,8 +383,11 @@ void CustomTexManager::DumpTexture(const SurfaceParams& params, u32 level, std::
 
     // Proceed with the dump.
     const u64 program_id = system.Kernel().GetCurrentProcess()->codeset->program_id;
-    auto dump = [width, height, params, level, data_hash, format, data_size, program_id,
-                 pixels = std::move(pixels)]() mutable {
+    const s32 compression_level = Settings::values.dump_textures_fast.GetValue() ? 1 : 6;
+    auto dump = [this, width, height, params, level, data_hash, format, data_size, program_id,
+                 compression_level, pixels = std::move(pixels)]() mutable {
+        SCOPE_EXIT({ num_pending_dumps--; });
+
         // Decode and convert to RGBA8
         const std::span encoded = pixels.Span().first(data_size);
         const std::span decoded = pixels.Span(data_size);
@@ -212,10 +403,11 @@ void CustomTexManager::DumpTexture(const SurfaceParams& params, u32 level, std::
 
         dump_path +=
             fmt::format("tex1_{}x{}_{:016X}_{}_mip{}.png", width, height, data_hash, format, level);
-        EncodePNG(dump_path, decoded, width, height);
+        EncodePNG(dump_path, decoded, width, height, compression_level);
     };
 
-    workers->QueueWork(std::move(dump));
+    num_pending_dumps++;
+    dump_workers->QueueWork(std::move(dump));
     dumped_textures.insert(data_hash);
 }
 
@@ -233,6 +425,7 @@ CustomTexture& CustomTexManager::GetTexture(u64 data_hash) {
 }
 
 void CustomTexManager::DecodeToStaging(CustomTexture& texture, StagingData& staging) {
+    texture.last_used_frame = frame_tick;
     if (texture.state == DecodeState::Decoded) {
         // Nothing to do here, just copy over the data
         ASSERT_MSG(staging.size == texture.staging_size,
@@ -254,42 +447,108 @@ void CustomTexManager::DecodeToStaging(CustomTexture& texture, StagingData& stag
     texture.state = DecodeState::Pending;
 
     const auto decode = [this, &texture, mapped = staging.mapped]() {
-        // Read the file this is potentially the most expensive step
-        FileUtil::IOFile file{texture.path, "rb"};
-        ScratchBuffer<u8> file_data{file.GetSize()};
-        file.ReadBytes(file_data.Data(), file.GetSize());
-
-        // Resize the decoded data buffer
-        std::vector<u8>& decoded_data = texture.data;
-        decoded_data.resize(texture.staging_size);
-
-        // Decode
-        switch (texture.file_format) {
-        case CustomFileFormat::PNG:
-            if (!DecodePNG(file_data.Span(), decoded_data)) {
-                LOG_ERROR(Render, "Failed to decode png {}", texture.path);
-            }
-            if (compatibility_mode) {
-                const u32 stride = texture.width * 4;
-                FlipTexture(decoded_data, texture.width, texture.height, stride);
-            }
-            break;
-        case CustomFileFormat::DDS:
-        case CustomFileFormat::KTX:
-            // Compressed formats don't need CPU decoding and must be pre-flipped.
-            LoadDDSKTX(file_data.Span(), decoded_data);
-            break;
-        }
+        LoadTexture(texture);
 
         // Copy it over to the staging memory and notify the backend that decode is done,
-        std::memcpy(mapped.data(), decoded_data.data(), decoded_data.size());
+        std::memcpy(mapped.data(), texture.data.data(), texture.data.size());
         texture.MarkDecoded();
     };
 
     workers->QueueWork(std::move(decode));
 }
 
+bool CustomTexManager::StreamTexture(CustomTexture& texture) {
+    texture.last_used_frame = frame_tick;
+    const DecodeState state = texture.state;
+    if (state == DecodeState::Decoded || !Settings::values.async_custom_loading.GetValue()) {
+        return true;
+    }
+    if (state == DecodeState::Pending) {
+        return false;
+    }
+
+    texture.state = DecodeState::Pending;
+    workers->QueueWork([this, &texture] {
+        LoadTexture(texture);
+        texture.MarkDecoded();
+    });
+    return false;
+}
+
+void CustomTexManager::TickFrame() {
+    frame_tick++;
+
+    const u64 budget = u64{Settings::values.custom_textures_cache_size.GetValue()} << 20;
+    if (preloaded || budget == 0 || decoded_memory <= budget) {
+        return;
+    }
+
+    // Release down to a fraction of the budget, so this does not run again on the next frame
+    std::vector<CustomTexture*> decoded;
+    for (const auto& [hash, texture] : custom_texture_map) {
+        if (texture->state == DecodeState::Decoded) {
+            decoded.push_back(texture);
+        }
+    }
+    std::ranges::sort(decoded, [](const CustomTexture* lhs, const CustomTexture* rhs) {
+        return lhs->last_used_frame < rhs->last_used_frame;
+    });
+
+    const u64 target = budget / 4 * 3;
+    std::size_t num_released = 0;
+    for (CustomTexture* texture : decoded) {
+        if (decoded_memory <= target) {
+            break;
+        }
+        decoded_memory -= texture->data.size();
+        std::vector<u8>().swap(texture->data);
+        texture->state = DecodeState::None;
+        num_released++;
+    }
+
+    LOG_DEBUG(Render, "Released {} custom textures, {} bytes of a {} byte budget in use",
+              num_released, decoded_memory.load(), budget);
+}
+
+void CustomTexManager::LoadTexture(CustomTexture& texture) {
+    // Read the file this is potentially the most expensive step
+    FileUtil::IOFile file{texture.path, "rb"};
+    ScratchBuffer<u8> file_data{file.GetSize()};
+    file.ReadBytes(file_data.Data(), file.GetSize());
+
+    // Resize the decoded data buffer
+    std::vector<u8>& decoded_data = texture.data;
+    decoded_data.resize(texture.staging_size);
+
+    // Decode
+    switch (texture.file_format) {
+    case CustomFileFormat::PNG:
+        if (!DecodePNG(file_data.Span(), decoded_data)) {
+            LOG_ERROR(Render, "Failed to decode png {}", texture.path);
+        }
+        if (compatibility_mode) {
+            const u32 stride = texture.width * 4;
+            FlipTexture(decoded_data, texture.width, texture.height, stride);
+        }
+        break;
+    case CustomFileFormat::DDS:
+    case CustomFileFormat::KTX:
+        // Compressed formats don't need CPU decoding and must be pre-flipped.
+        if (!LoadDDSKTX(file_data.Span(), decoded_data)) {
+            LOG_ERROR(Render, "Failed to load dds/ktx {}", texture.path);
+        }
+        break;
+    }
+
+    decoded_memory += decoded_data.size();
+}
+
 void CustomTexManager::QueryTexture(CustomTexture& texture) {
+    if (const auto status = FileUtil::GetStatus(texture.path)) {
+        texture.file_size = status->size;
+        texture.modification_time = status->modification_time;
+    }
+
     // Read the file
     FileUtil::IOFile file{texture.path, "rb"};
     ScratchBuffer<u8> data{file.GetSize()};
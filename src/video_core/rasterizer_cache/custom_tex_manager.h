@@ -42,8 +42,12 @@ struct CustomTexture {
     CustomFileFormat file_format;
     std::string path;
     std::size_t staging_size;
+    /// Size and modification time of the file when it was queried
+    u64 file_size{};
+    s64 modification_time{};
     std::vector<u8> data;
     std::atomic<DecodeState> state{};
+    u64 last_used_frame{};
 
     operator bool() const noexcept {
         return hash != 0;
@@ -75,23 +79,54 @@ public:
     /// Decodes the data in texture to a consumable format
     void DecodeToStaging(CustomTexture& texture, StagingData& staging);
 
+    /**
+     * Starts decoding the texture in the background when streaming is enabled.
+     * Returns true when the texture can be uploaded without waiting on the decode.
+     */
+    bool StreamTexture(CustomTexture& texture);
+
+    /// Releases the decoded data of the least recently used textures beyond the memory budget
+    void TickFrame();
+
     bool CompatibilityMode() const noexcept {
         return compatibility_mode;
     }
 
 private:
+    /// Walks the pack directory and queries every texture file in it
+    void ScanTextures(const std::string& load_path);
+
+    /**
+     * Loads the textures listed in the manifest of the pack. Returns false if there is none.
+     * Textures whose file changed since the manifest was written are queried again, and stale is
+     * set so the manifest gets rewritten.
+     */
+    bool ReadManifest(const std::string& load_path, const std::string& manifest_path,
+                      bool& stale);
+
+    /// Writes the textures found in the pack to its manifest
+    void WriteManifest(const std::string& load_path, const std::string& manifest_path);
+
     /// Fills the texture structure with information from the file in path
     void QueryTexture(CustomTexture& texture);
 
+    /// Reads and decodes the file of the texture into its data buffer
+    void LoadTexture(CustomTexture& texture);
+
 private:
     Core::System& system;
     std::unique_ptr<Common::ThreadWorker> workers;
+    std::atomic<u32> num_pending_dumps{};
+    std::unique_ptr<Common::ThreadWorker> dump_workers;
     std::unordered_set<u64> dumped_textures;
     std::unordered_map<u64, CustomTexture*> custom_texture_map;
     std::vector<std::unique_ptr<CustomTexture>> custom_textures;
     std::vector<u8> temp_buffer;
     CustomTexture dummy_texture{};
+    std::atomic<u64> decoded_memory{};
+    u64 frame_tick{};
     bool textures_loaded{};
+    bool preloaded{};
     bool compatibility_mode{true};
 };
 
@@ -0,0 +1,147 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <vector>
+#include "common/assert.h"
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Counts the surfaces overlapping each page of the physical address space. Next to the counters
+ * it keeps a bitmap of the pages with a non-zero count, so that pages switching between cached
+ * and uncached can be found and reported a whole word of pages at a time.
+ */
+class PageCounter {
+    static constexpr u32 NUM_PAGES = 1U << 20;
+    static constexpr u32 WORD_BITS = 64;
+
+public:
+    PageCounter() : counts(NUM_PAGES), bitmap(NUM_PAGES / WORD_BITS) {}
+
+    /**
+     * Adds delta to the count of every page in [page_start, page_end).
+     * @param func Called as func(first_page, num_pages) for every run of pages that went from zero
+     * to non-zero or back.
+     */
+    template <typename Func>
+    void Update(u32 page_start, u32 page_end, int delta, Func&& func) {
+        ASSERT(page_start <= page_end && page_end <= NUM_PAGES);
+        RunCollector<Func> runs{func};
+        for (u32 page = page_start; page < page_end;) {
+            const u32 word = page / WORD_BITS;
+            const u32 first_bit = page % WORD_BITS;
+            const u32 last_bit = std::min<u32>(page_end - word * WORD_BITS, WORD_BITS);
+            const u64 range_mask = MakeMask(first_bit, last_bit);
+
+            u64 flipped;
+            if (delta > 0) {
+                flipped = range_mask & ~bitmap[word];
+                bitmap[word] |= range_mask;
+                for (u32 i = page; i < word * WORD_BITS + last_bit; ++i) {
+                    ASSERT(counts[i] <= std::numeric_limits<u16>::max() - delta);
+                    counts[i] = static_cast<u16>(counts[i] + delta);
+                }
+            } else {
+                u64 zero_mask = 0;
+                for (u32 i = page; i < word * WORD_BITS + last_bit; ++i) {
+                    ASSERT(counts[i] >= -delta);
+                    counts[i] = static_cast<u16>(counts[i] + delta);
+                    zero_mask |= u64{counts[i] == 0} << (i % WORD_BITS);
+                }
+                flipped = zero_mask & bitmap[word];
+                bitmap[word] &= ~flipped;
+            }
+            runs.AddMask(word, flipped);
+            page = word * WORD_BITS + last_bit;
+        }
+        runs.Flush();
+    }
+
+    /**
+     * Resets every count to zero.
+     * @param func Called as func(first_page, num_pages) for every run of pages that had a non-zero
+     * count.
+     */
+    template <typename Func>
+    void Clear(Func&& func) {
+        RunCollector<Func> runs{func};
+        for (u32 word = 0; word < bitmap.size(); ++word) {
+            if (bitmap[word] == 0) {
+                continue;
+            }
+            runs.AddMask(word, bitmap[word]);
+            std::fill_n(counts.begin() + word * WORD_BITS, WORD_BITS, u16{0});
+            bitmap[word] = 0;
+        }
+        runs.Flush();
+    }
+
+    /**
+     * Calls func(first_page, num_pages) for every run of pages with a non-zero count, without
+     * changing the counts.
+     */
+    template <typename Func>
+    void ForEachRun(Func&& func) const {
+        RunCollector<Func> runs{func};
+        for (u32 word = 0; word < bitmap.size(); ++word) {
+            runs.AddMask(word, bitmap[word]);
+        }
+        runs.Flush();
+    }
+
+    [[nodiscard]] u16 Count(u32 page) const {
+        return counts[page];
+    }
+
+private:
+    static constexpr u64 MakeMask(u32 first_bit, u32 last_bit) {
+        const u64 upper = last_bit == WORD_BITS ? ~u64{0} : (u64{1} << last_bit) - 1;
+        return upper & ~((u64{1} << first_bit) - 1);
+    }
+
+    /// Merges runs of set bits across words before passing them on.
+    template <typename Func>
+    struct RunCollector {
+        Func& func;
+        u32 run_start = 0;
+        u32 run_end = 0;
+
+        void AddMask(u32 word, u64 mask) {
+            while (mask != 0) {
+                const u32 first = static_cast<u32>(std::countr_zero(mask));
+                const u32 length = static_cast<u32>(std::countr_one(mask >> first));
+                Add(word * WORD_BITS + first, word * WORD_BITS + first + length);
+                mask = length + first == WORD_BITS ? 0 : mask & ~MakeMask(0, first + length);
+            }
+        }
+
+        void Add(u32 start, u32 end) {
+            if (run_end != run_start && start == run_end) {
+                run_end = end;
+                return;
+            }
+            Flush();
+            run_start = start;
+            run_end = end;
+        }
+
+        void Flush() {
+            if (run_end != run_start) {
+                func(run_start, run_end - run_start);
+            }
+            run_start = run_end = 0;
+        }
+    };
+
+    std::vector<u16> counts;
+    std::vector<u64> bitmap;
+};
+
+} // namespace VideoCore
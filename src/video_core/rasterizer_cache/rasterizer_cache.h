@@ -7,6 +7,7 @@
 #include <boost/container/small_vector.hpp>
 #include <boost/range/iterator_range.hpp>
 #include "common/alignment.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/memory.h"
@@ -34,7 +35,11 @@ RasterizerCache<T>::RasterizerCache(Memory::MemorySystem& memory_,
     : memory{memory_}, runtime{runtime_}, custom_tex_manager{custom_tex_manager_},
       resolution_scale_factor{VideoCore::GetResolutionScaleFactor()},
       dump_textures{Settings::values.dump_textures.GetValue()},
-      use_custom_textures{Settings::values.custom_textures.GetValue()} {
+      use_custom_textures{Settings::values.custom_textures.GetValue()},
+      gpu_texture_decoding{Settings::values.gpu_texture_decoding.GetValue()},
+      hash_texture_uploads{Settings::values.hash_texture_uploads.GetValue()},
+      memory_budget{static_cast<u64>(Settings::values.texture_memory_budget.GetValue()) << 20} {
+    page_table.resize(NUM_PAGES);
 
     using TextureConfig = Pica::TexturingRegs::TextureConfig;
 
@@ -66,6 +71,16 @@ RasterizerCache<T>::RasterizerCache(Memory::MemorySystem& memory_,
 
 template <class T>
 RasterizerCache<T>::~RasterizerCache() {
+    RasterizerCacheStats totals = GetTotalStats();
+    totals += stats;
+    if (hash_texture_uploads) {
+        LOG_DEBUG(HW_GPU, "Uploaded {} bytes, skipped {} unchanged uploads totaling {} bytes",
+                  totals.uploaded_bytes, totals.hash_skipped_uploads, totals.hash_skipped_bytes);
+    }
+    if (totals.codec_reinterprets != 0 || totals.reinterpret_fallbacks != 0) {
+        LOG_DEBUG(HW_GPU, "Reinterpreted {} regions with the texture codec, {} through memory",
+                  totals.codec_reinterprets, totals.reinterpret_fallbacks);
+    }
 #ifndef ANDROID
     // This is for switching renderers, which is unsupported on Android, and costly on shutdown
     ClearAll(false);
@@ -121,11 +136,19 @@ bool RasterizerCache<T>::AccelerateTextureCopy(const GPU::Regs::DisplayTransferC
     }
 
     SurfaceParams src_info = slot_surfaces[src_surface_id];
+    const u32 row_bytes = src_info.BytesInPixels(src_rect.GetWidth() / src_info.res_scale) *
+                          (src_info.is_tiled ? 8 : 1);
     if (output_gap != 0 &&
-        (output_width != src_info.BytesInPixels(src_rect.GetWidth() / src_info.res_scale) *
-                             (src_info.is_tiled ? 8 : 1) ||
+        (output_width != row_bytes ||
          output_gap % src_info.BytesInPixels(src_info.is_tiled ? 64 : 1) != 0)) {
-        return false;
+        // No surface has rows this far apart, but every output line can still be its own copy
+        if (output_width % row_bytes != 0) {
+            return false;
+        }
+        const u32 line_rows = output_width / row_bytes * (src_info.is_tiled ? 8 : 1);
+        return CopyTextureLines(src_surface_id, src_rect, src_info.LevelOf(src_params.addr),
+                                config.GetPhysicalOutputAddress(), line_rows,
+                                output_width + output_gap);
     }
 
     SurfaceParams dst_params = src_info;
@@ -296,15 +319,7 @@ void RasterizerCache<T>::ForEachSurfaceInRegion(PAddr addr, size_t size, Func&&
     static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
     boost::container::small_vector<SurfaceId, 32> surfaces;
     ForEachPage(addr, size, [this, &surfaces, addr, size, func](u64 page) {
-        const auto it = page_table.find(page);
-        if (it == page_table.end()) {
-            if constexpr (BOOL_BREAK) {
-                return false;
-            } else {
-                return;
-            }
-        }
-        for (const SurfaceId surface_id : it->second) {
+        for (const SurfaceId surface_id : page_table[page]) {
             Surface& surface = slot_surfaces[surface_id];
             if (surface.picked) {
                 continue;
@@ -413,6 +428,9 @@ SurfaceId RasterizerCache<T>::FindMatch(const SurfaceParams& params, ScaleMatch
         });
     });
 
+    if (match_surface) {
+        slot_surfaces[match_surface].last_used_frame = frame_tick;
+    }
     return match_surface;
 }
 
@@ -617,7 +635,13 @@ auto RasterizerCache<T>::GetTextureSurface(const Pica::Texture::TextureInfo& inf
         return slot_surfaces[NULL_SURFACE_ID];
     }
 
+    const u64 surfaces_created = stats.surfaces_created;
     SurfaceId surface_id = GetSurface(params, ScaleMatch::Ignore, true);
+    if (stats.surfaces_created == surfaces_created) {
+        stats.texture_hits++;
+    } else {
+        stats.texture_misses++;
+    }
     return surface_id ? slot_surfaces[surface_id] : slot_surfaces[NULL_SURFACE_ID];
 }
 
@@ -660,22 +684,27 @@ auto RasterizerCache<T>::GetTextureCube(const TextureCubeConfig& config) -> Surf
         Surface& face_surface = GetTextureSurface(info, config.levels - 1);
         Surface& cube = slot_surfaces[params.cube_id];
 
-        if (face_surface.ModificationTick() != params.ticks[i]) {
-            const u32 scaled_size = cube.GetScaledWidth();
-            for (u32 level = 0; level < face_surface.levels; level++) {
-                const TextureCopy texture_copy = {
-                    .src_level = level,
-                    .dst_level = level,
-                    .src_layer = 0,
-                    .dst_layer = static_cast<u32>(i),
-                    .src_offset = {0, 0},
-                    .dst_offset = {0, 0},
-                    .extent = {scaled_size >> level, scaled_size >> level},
-                };
-                runtime.CopyTextures(face_surface, cube, texture_copy);
-            }
-            params.ticks[i] = face_surface.ModificationTick();
+        if (face_surface.ModificationTick() == params.ticks[i]) {
+            stats.cube_face_skips++;
+            continue;
+        }
+
+        // Only the faces that changed are copied, along with their levels
+        const u32 scaled_size = cube.GetScaledWidth();
+        for (u32 level = 0; level < face_surface.levels; level++) {
+            const TextureCopy texture_copy = {
+                .src_level = level,
+                .dst_level = level,
+                .src_layer = 0,
+                .dst_layer = static_cast<u32>(i),
+                .src_offset = {0, 0},
+                .dst_offset = {0, 0},
+                .extent = {scaled_size >> level, scaled_size >> level},
+            };
+            runtime.CopyTextures(face_surface, cube, texture_copy);
         }
+        params.ticks[i] = face_surface.ModificationTick();
+        stats.cube_face_copies++;
     }
 
     return slot_surfaces[params.cube_id];
@@ -715,7 +744,9 @@ auto RasterizerCache<T>::GetFramebufferSurfaces(bool using_color_fb, bool using_
     // get color and depth surfaces
     SurfaceParams color_params;
     color_params.is_tiled = true;
-    color_params.res_scale = resolution_scale_factor;
+    // Dynamic resolution only changes the scale of new render targets, existing surfaces keep
+    // theirs and are blitted between scales like any other mismatch until they are replaced
+    color_params.res_scale = VideoCore::GetRenderTargetScaleFactor();
     color_params.width = config.GetWidth();
     color_params.height = config.GetHeight();
     SurfaceParams depth_params = color_params;
@@ -739,6 +770,7 @@ auto RasterizerCache<T>::GetFramebufferSurfaces(bool using_color_fb, bool using_
         using_depth_fb = false;
     }
 
+    const u64 surfaces_created = stats.surfaces_created;
     Common::Rectangle<u32> color_rect{};
     SurfaceId color_surface_id{};
     if (using_color_fb)
@@ -766,6 +798,11 @@ auto RasterizerCache<T>::GetFramebufferSurfaces(bool using_color_fb, bool using_
     } else if (depth_surface_id) {
         fb_rect = depth_rect;
     }
+    if (stats.surfaces_created == surfaces_created) {
+        stats.framebuffer_hits++;
+    } else {
+        stats.framebuffer_misses++;
+    }
 
     Surface* const color = color_surface_id ? &slot_surfaces[color_surface_id] : nullptr;
     Surface* const depth_stencil = depth_surface_id ? &slot_surfaces[depth_surface_id] : nullptr;
@@ -834,6 +871,64 @@ auto RasterizerCache<T>::GetTexCopySurface(const SurfaceParams& params) -> Surfa
     return std::make_pair(match_id, rect);
 }
 
+template <class T>
+bool RasterizerCache<T>::CopyTextureLines(SurfaceId src_surface_id, Rect2D src_rect,
+                                          u32 src_level, PAddr dst_addr, u32 line_rows,
+                                          u32 line_stride) {
+    // Every line may become a surface of its own, so copies with many lines are left to the CPU
+    constexpr u32 MaxTextureCopyLines = 64;
+
+    const SurfaceParams src_info = slot_surfaces[src_surface_id];
+    const u32 scaled_line_rows = line_rows * src_info.res_scale;
+    const u32 num_lines = src_rect.GetHeight() / scaled_line_rows;
+    if (num_lines == 0 || num_lines > MaxTextureCopyLines ||
+        num_lines * scaled_line_rows != src_rect.GetHeight()) {
+        return false;
+    }
+
+    for (u32 line = 0; line < num_lines; line++) {
+        SurfaceParams dst_params = src_info;
+        dst_params.addr = dst_addr + line * line_stride;
+        dst_params.width = src_rect.GetWidth() / src_info.res_scale;
+        dst_params.stride = dst_params.width;
+        dst_params.height = line_rows;
+        dst_params.UpdateParams();
+
+        const auto [dst_surface_id, dst_rect] =
+            GetSurfaceSubRect(dst_params, ScaleMatch::Upscale, false);
+        if (!dst_surface_id) {
+            return false;
+        }
+        Surface& src_surface = slot_surfaces[src_surface_id];
+        Surface& dst_surface = slot_surfaces[dst_surface_id];
+        if (dst_surface.type == SurfaceType::Texture ||
+            !CheckFormatsBlittable(src_surface.pixel_format, dst_surface.pixel_format) ||
+            dst_rect.GetWidth() != src_rect.GetWidth() ||
+            dst_rect.GetHeight() != scaled_line_rows) {
+            return false;
+        }
+
+        // Tiled surfaces start at the top row, linear ones at the bottom row
+        const u32 line_offset = line * scaled_line_rows;
+        const u32 line_bottom = src_info.is_tiled
+                                    ? src_rect.top - line_offset - scaled_line_rows
+                                    : src_rect.bottom + line_offset;
+        const TextureCopy texture_copy = {
+            .src_level = src_level,
+            .dst_level = dst_surface.LevelOf(dst_params.addr),
+            .src_offset = {src_rect.left, line_bottom},
+            .dst_offset = {dst_rect.left, dst_rect.bottom},
+            .extent = {src_rect.GetWidth(), scaled_line_rows},
+        };
+        runtime.CopyTextures(src_surface, dst_surface, texture_copy);
+
+        InvalidateRegion(dst_params.addr, dst_params.size, dst_surface_id);
+    }
+
+    stats.line_texture_copies++;
+    return true;
+}
+
 template <class T>
 void RasterizerCache<T>::DuplicateSurface(SurfaceId src_id, SurfaceId dst_id) {
     Surface& src_surface = slot_surfaces[src_id];
@@ -852,6 +947,7 @@ void RasterizerCache<T>::DuplicateSurface(SurfaceId src_id, SurfaceId dst_id) {
         .extent = {src_rect.GetWidth(), src_rect.GetHeight()},
     };
     runtime.CopyTextures(src_surface, dst_surface, texture_copy);
+    dst_surface.ClearUploadHashes();
 
     dst_surface.invalid_regions -= src_surface.GetInterval();
     dst_surface.invalid_regions += src_surface.invalid_regions;
@@ -865,6 +961,7 @@ void RasterizerCache<T>::DuplicateSurface(SurfaceId src_id, SurfaceId dst_id) {
 
     for (const auto& interval : regions) {
         dirty_regions.set({interval, dst_id});
+        MarkDirtyPages(interval);
     }
 }
 
@@ -894,6 +991,11 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
             level_regions.erase(interval);
             surface.MarkValid(interval);
         };
+        // The level no longer matches guest memory once parts of it come from other surfaces
+        const auto NotifyCopied = [&](SurfaceInterval interval) {
+            surface.upload_hashes[level] = 0;
+            NotifyValidated(interval);
+        };
 
         while (!level_regions.empty()) {
             const SurfaceInterval interval = *level_regions.begin();
@@ -905,20 +1007,23 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
                 Surface& copy_surface = slot_surfaces[copy_surface_id];
                 const SurfaceInterval copy_interval = copy_surface.GetCopyableInterval(params);
                 CopySurface(copy_surface, surface, copy_interval);
-                NotifyValidated(copy_interval);
+                NotifyCopied(copy_interval);
                 continue;
             }
 
             // Try to find surface in cache with different format
             // that can can be reinterpreted to the requested format.
             if (ValidateByReinterpretation(surface, params, interval)) {
-                NotifyValidated(interval);
+                NotifyCopied(interval);
                 continue;
             }
             // Could not find a matching reinterpreter, check if we need to implement a
             // reinterpreter
-            if (NoUnimplementedReinterpretations(surface, params, interval) &&
-                !IntervalHasInvalidPixelFormat(params, interval)) {
+            const bool implemented = NoUnimplementedReinterpretations(surface, params, interval);
+            if (!implemented) {
+                stats.reinterpret_fallbacks++;
+            }
+            if (implemented && !IntervalHasInvalidPixelFormat(params, interval)) {
                 // No surfaces were found in the cache that had a matching bit-width.
                 // If the region was created entirely on the GPU,
                 // assume it was a developer mistake and skip flushing.
@@ -932,14 +1037,15 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
 
             // Load data from 3DS memory
             FlushRegion(params.addr, params.size);
-            UploadSurface(surface, interval);
+            UploadSurface(surface_id, interval);
             NotifyValidated(params.GetInterval());
         }
     }
 }
 
 template <class T>
-void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interval) {
+void RasterizerCache<T>::UploadSurface(SurfaceId surface_id, SurfaceInterval interval) {
+    Surface& surface = slot_surfaces[surface_id];
     const SurfaceParams load_info = surface.FromInterval(interval);
     ASSERT(load_info.addr >= surface.addr && load_info.end <= surface.end);
 
@@ -951,6 +1057,24 @@ void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interva
     }
 
     const auto upload_data = source_ptr.GetWriteBytes(load_info.end - load_info.addr);
+    const u32 level = surface.LevelOf(load_info.addr);
+
+    // Skip levels that were rewritten with the data they were last uploaded from. Partial
+    // uploads leave the rest of the level untouched, so only whole levels are hashed.
+    u64& upload_hash = surface.upload_hashes[level];
+    if (hash_texture_uploads && interval == surface.LevelInterval(level)) {
+        const u64 hash = Common::ComputeHash64(upload_data.data(), upload_data.size());
+        if (hash == upload_hash) {
+            stats.hash_skipped_uploads++;
+            stats.hash_skipped_bytes += upload_data.size();
+            return;
+        }
+        upload_hash = hash;
+    } else {
+        upload_hash = 0;
+    }
+    stats.uploads++;
+    stats.uploaded_bytes += upload_data.size();
 
     // Check if we need to dump the texture
     if (dump_textures) {
@@ -958,29 +1082,116 @@ void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interva
     }
 
     // Check if we need to replace the texture
-    if (use_custom_textures && UploadCustomSurface(surface, load_info, upload_data)) {
+    if (use_custom_textures && UploadCustomSurface(surface_id, load_info, upload_data)) {
+        upload_hash = 0;
         return;
     }
 
+    // Filtered scaled uploads may reuse the result of identical guest data
+    u64 source_hash = upload_hash;
+    const bool is_filtered = surface.res_scale != 1 && runtime.IsUploadFiltered() &&
+                             (surface.type == SurfaceType::Color ||
+                              surface.type == SurfaceType::Texture);
+    if (source_hash == 0 && is_filtered) {
+        source_hash = Common::ComputeHash64(upload_data.data(), upload_data.size());
+    }
+
     // Upload the 3DS texture to the host GPU
     const u32 upload_size = load_info.width * load_info.height * surface.GetInternalBytesPerPixel();
+    if (UseGpuCodec(surface, load_info, false)) {
+        // The tiled data is copied as is and decoded by the GPU right after it
+        const u32 tiled_size = static_cast<u32>(upload_data.size());
+        const u32 linear_offset = Common::AlignUp(tiled_size, 16);
+        const StagingData staging = runtime.FindStaging(linear_offset + upload_size, true);
+        std::memcpy(staging.mapped.data(), upload_data.data(), tiled_size);
+
+        const BufferTextureCopy upload = {
+            .buffer_offset = linear_offset,
+            .buffer_size = upload_size,
+            .texture_rect = surface.GetSubRect(load_info),
+            .texture_level = surface.LevelOf(load_info.addr),
+            .source_hash = source_hash,
+        };
+        surface.UploadTiled(upload, staging);
+        return;
+    }
+
     const StagingData staging = runtime.FindStaging(upload_size, true);
 
-    DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging.mapped,
-                  runtime.NeedsConvertion(surface.pixel_format));
+    DecodeUpload(load_info, upload_data, staging.mapped,
+                 runtime.NeedsConvertion(surface.pixel_format));
 
     const BufferTextureCopy upload = {
         .buffer_offset = 0,
         .buffer_size = staging.size,
         .texture_rect = surface.GetSubRect(load_info),
         .texture_level = surface.LevelOf(load_info.addr),
+        .source_hash = source_hash,
     };
     surface.Upload(upload, staging);
 }
 
 template <class T>
-bool RasterizerCache<T>::UploadCustomSurface(Surface& surface, const SurfaceParams& load_info,
+void RasterizerCache<T>::DecodeUpload(const SurfaceParams& load_info, std::span<u8> upload_data,
+                                      std::span<u8> staging_data, bool convert) {
+    // Below this many pixels the cost of waking the workers outweighs decoding on one thread
+    constexpr u32 MIN_PARALLEL_PIXELS = 256 * 256;
+
+    const u32 num_pixels = load_info.width * load_info.height;
+    const bool is_etc1 = load_info.pixel_format == PixelFormat::ETC1 ||
+                         load_info.pixel_format == PixelFormat::ETC1A4;
+    const bool is_whole_rect =
+        load_info.is_tiled && load_info.stride == load_info.width &&
+        load_info.end - load_info.addr == load_info.BytesInPixels(num_pixels);
+    if (!is_etc1 || !is_whole_rect || num_pixels < MIN_PARALLEL_PIXELS) {
+        DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging_data, convert);
+        return;
+    }
+
+    if (!decode_workers) {
+        decode_workers = std::make_unique<Common::ThreadWorker>(
+            Common::GetWorkerThreadCount(std::max(std::thread::hardware_concurrency(), 2U) - 1),
+            "Texture decode");
+    }
+
+    // Each worker decodes a band of tile rows. Tile rows are stored bottom up in the
+    // linear buffer, so the first band of the guest data is written at its end.
+    const u32 tile_rows = load_info.height / 8;
+    const u32 num_workers = static_cast<u32>(decode_workers->NumWorkers());
+    const u32 rows_per_band = (tile_rows + num_workers - 1) / num_workers;
+    const u32 tiled_row_size = load_info.BytesInPixels(load_info.width * 8);
+    const u32 linear_row_size = load_info.width * 8 * 4;
+    for (u32 row = 0; row < tile_rows; row += rows_per_band) {
+        const u32 num_rows = std::min(rows_per_band, tile_rows - row);
+        SurfaceParams band = load_info;
+        band.addr = load_info.addr + row * tiled_row_size;
+        band.end = band.addr + num_rows * tiled_row_size;
+        band.height = num_rows * 8;
+
+        const auto source = upload_data.subspan(row * tiled_row_size, num_rows * tiled_row_size);
+        const auto dest = staging_data.subspan((tile_rows - row - num_rows) * linear_row_size,
+                                               num_rows * linear_row_size);
+        decode_workers->QueueWork([band, source, dest, convert] {
+            DecodeTexture(band, band.addr, band.end, source, dest, convert);
+        });
+    }
+    decode_workers->WaitForRequests();
+}
+
+template <class T>
+bool RasterizerCache<T>::UseGpuCodec(const Surface& surface, const SurfaceParams& info,
+                                     bool encode) const {
+    // The shader works on whole levels, partial intervals are left to the CPU
+    const bool is_whole_rect = info.is_tiled && info.stride == info.width &&
+                               info.end - info.addr == info.BytesInPixels(info.width * info.height);
+    return gpu_texture_decoding && is_whole_rect &&
+           runtime.SupportsGpuCodec(surface.pixel_format, encode);
+}
+
+template <class T>
+bool RasterizerCache<T>::UploadCustomSurface(SurfaceId surface_id, const SurfaceParams& load_info,
                                              std::span<u8> upload_data) {
+    Surface& surface = slot_surfaces[surface_id];
     const u32 level = surface.LevelOf(load_info.addr);
     const bool is_base_level = level == 0;
     const u64 hash = custom_tex_manager.ComputeHash(load_info, upload_data);
@@ -996,6 +1207,15 @@ bool RasterizerCache<T>::UploadCustomSurface(Surface& surface, const SurfacePara
         return false;
     }
 
+    // Show the guest texture until the custom texture has been decoded in the background
+    if (is_base_level && !surface.IsCustom() && !custom_tex_manager.StreamTexture(texture)) {
+        const auto streaming = std::make_pair(surface_id, &std::as_const(texture));
+        if (std::ranges::find(streaming_surfaces, streaming) == streaming_surfaces.end()) {
+            streaming_surfaces.push_back(streaming);
+        }
+        return false;
+    }
+
     // Swap the internal surface allocation to the desired dimentions and format
     if (is_base_level && !surface.Swap(texture.width, texture.height, texture.format)) {
         // This means the backend doesn't support the custom compression format.
@@ -1034,34 +1254,97 @@ bool RasterizerCache<T>::UploadCustomSurface(Surface& surface, const SurfacePara
 }
 
 template <class T>
-void RasterizerCache<T>::DownloadSurface(Surface& surface, SurfaceInterval interval) {
+auto RasterizerCache<T>::PrepareDownload(SurfaceId surface_id, SurfaceInterval interval)
+    -> SurfaceDownload {
+    Surface& surface = slot_surfaces[surface_id];
     const SurfaceParams flush_info = surface.FromInterval(interval);
     const u32 flush_start = boost::icl::first(interval);
     const u32 flush_end = boost::icl::last_next(interval);
     ASSERT(flush_start >= surface.addr && flush_end <= surface.end);
 
+    // When the GPU swizzles the texels the tiled data is placed before the linear data
+    const bool use_gpu_codec = flush_start == flush_info.addr && flush_end == flush_info.end &&
+                               UseGpuCodec(surface, flush_info, true);
+    const u32 linear_offset = use_gpu_codec ? Common::AlignUp(flush_end - flush_start, 16) : 0;
     const u32 flush_size =
         flush_info.width * flush_info.height * surface.GetInternalBytesPerPixel();
-    const StagingData staging = runtime.FindStaging(flush_size, false);
 
-    const BufferTextureCopy download = {
-        .buffer_offset = 0,
-        .buffer_size = staging.size,
-        .texture_rect = surface.GetSubRect(flush_info),
-        .texture_level = surface.LevelOf(flush_start),
+    return SurfaceDownload{
+        .surface_id = surface_id,
+        .flush_info = flush_info,
+        .flush_start = flush_start,
+        .flush_end = flush_end,
+        .linear_offset = linear_offset,
+        .staging_size = Common::AlignUp(linear_offset + flush_size, 16),
+        .use_gpu_codec = use_gpu_codec,
     };
-    surface.Download(download, staging);
+}
+
+template <class T>
+void RasterizerCache<T>::DownloadSurfaces(std::span<const SurfaceDownload> downloads) {
+    // Keep batches well below the size of the backend download buffers
+    constexpr u32 MAX_BATCH_SIZE = 8 * 1024 * 1024;
+
+    while (!downloads.empty()) {
+        std::size_t count = 1;
+        u32 batch_size = downloads[0].staging_size;
+        while (count < downloads.size() &&
+               batch_size + downloads[count].staging_size <= MAX_BATCH_SIZE) {
+            batch_size += downloads[count++].staging_size;
+        }
+        const auto batch = downloads.first(count);
+        downloads = downloads.subspan(count);
+
+        // Record all copies of the batch into one staging allocation before waiting
+        const StagingData staging = runtime.FindStaging(batch_size, false);
+        u32 offset = 0;
+        for (const SurfaceDownload& download : batch) {
+            Surface& surface = slot_surfaces[download.surface_id];
+            const StagingData download_staging = {
+                .size = download.staging_size,
+                .mapped = staging.mapped.subspan(offset, download.staging_size),
+                .buffer_offset = staging.buffer_offset + offset,
+            };
+            const BufferTextureCopy copy = {
+                .buffer_offset = download.linear_offset,
+                .buffer_size = download.staging_size - download.linear_offset,
+                .texture_rect = surface.GetSubRect(download.flush_info),
+                .texture_level = surface.LevelOf(download.flush_start),
+            };
+            if (download.use_gpu_codec) {
+                surface.DownloadTiled(copy, download_staging);
+            } else {
+                surface.Download(copy, download_staging);
+            }
+            offset += download.staging_size;
+        }
 
-    runtime.Finish();
+        runtime.Finish();
+        stats.download_stalls++;
 
-    MemoryRef dest_ptr = memory.GetPhysicalRef(flush_start);
-    if (!dest_ptr) [[unlikely]] {
-        return;
-    }
+        offset = 0;
+        for (const SurfaceDownload& download : batch) {
+            const auto source = staging.mapped.subspan(offset, download.staging_size);
+            offset += download.staging_size;
 
-    const auto download_dest = dest_ptr.GetWriteBytes(flush_end - flush_start);
-    EncodeTexture(flush_info, flush_start, flush_end, staging.mapped, download_dest,
-                  runtime.NeedsConvertion(surface.pixel_format));
+            MemoryRef dest_ptr = memory.GetPhysicalRef(download.flush_start);
+            if (!dest_ptr) [[unlikely]] {
+                continue;
+            }
+            stats.downloads++;
+            stats.downloaded_bytes += download.flush_end - download.flush_start;
+
+            const auto download_dest =
+                dest_ptr.GetWriteBytes(download.flush_end - download.flush_start);
+            if (download.use_gpu_codec) {
+                std::memcpy(download_dest.data(), source.data(), download_dest.size());
+                continue;
+            }
+            const Surface& surface = slot_surfaces[download.surface_id];
+            EncodeTexture(download.flush_info, download.flush_start, download.flush_end, source,
+                          download_dest, runtime.NeedsConvertion(surface.pixel_format));
+        }
+    }
 }
 
 template <class T>
@@ -1162,44 +1445,240 @@ bool RasterizerCache<T>::ValidateByReinterpretation(Surface& surface, SurfacePar
         }
     }
 
+    // Any other color format of the same size goes through the texture codec, which encodes the
+    // source to guest bytes and decodes them as the destination format without leaving the GPU
+    if (!gpu_texture_decoding || !runtime.SupportsGpuCodec(dest_format, false)) {
+        return false;
+    }
+    static constexpr std::array color_formats = {
+        PixelFormat::RGBA8, PixelFormat::RGB8, PixelFormat::RGB5A1, PixelFormat::RGB565,
+        PixelFormat::RGBA4,
+    };
+    for (const PixelFormat format : color_formats) {
+        if (format == dest_format || GetFormatBpp(format) != surface.GetFormatBpp() ||
+            !runtime.SupportsGpuCodec(format, true)) {
+            continue;
+        }
+        params.pixel_format = format;
+        const SurfaceId source_id =
+            FindMatch<MatchFlags::Copy>(params, ScaleMatch::Ignore, interval);
+        if (!source_id) {
+            continue;
+        }
+
+        // The codec works on whole rows of tiles, which only line up when the strides match
+        Surface& source = slot_surfaces[source_id];
+        const SurfaceParams copy_params = surface.FromInterval(source.GetCopyableInterval(params));
+        if (!copy_params.is_tiled || copy_params.width != copy_params.stride ||
+            source.stride != surface.stride) {
+            continue;
+        }
+        if (runtime.ReinterpretTiled(source, surface, source.GetSubRect(copy_params),
+                                     surface.GetSubRect(copy_params))) {
+            stats.codec_reinterprets++;
+            return true;
+        }
+    }
+
     return false;
 }
 
 template <class T>
 void RasterizerCache<T>::ClearAll(bool flush) {
-    const auto flush_interval = PageMap::interval_type::right_open(0x0, 0xFFFFFFFF);
     // Force flush all surfaces from the cache
-    if (flush) {
+    if (flush && !suspended) {
         FlushRegion(0x0, 0xFFFFFFFF);
     }
-    // Unmark all of the marked pages
-    for (auto& pair : RangeFromInterval(cached_pages, flush_interval)) {
-        const auto interval = pair.first & flush_interval;
-
-        const PAddr interval_start_addr = boost::icl::first(interval) << Memory::CITRA_PAGE_BITS;
-        const PAddr interval_end_addr = boost::icl::last_next(interval) << Memory::CITRA_PAGE_BITS;
-        const u32 interval_size = interval_end_addr - interval_start_addr;
-
-        memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, false);
-    }
+    // Unmark all of the marked pages, a suspended cache has unmarked them already
+    cached_pages.Clear([this](u32 first_page, u32 num_pages) {
+        if (!suspended) {
+            memory.RasterizerMarkRegionCached(first_page << Memory::CITRA_PAGE_BITS,
+                                              num_pages << Memory::CITRA_PAGE_BITS, false);
+        }
+    });
+    suspended = false;
+    suspended_surfaces.clear();
 
     // Remove the whole cache without really looking at it.
-    cached_pages -= flush_interval;
     dirty_regions -= SurfaceInterval(0x0, 0xFFFFFFFF);
-    page_table.clear();
+    dirty_pages.reset();
+    for (auto& surface_ids : page_table) {
+        surface_ids.clear();
+    }
     remove_surfaces.clear();
+    surface_memory = 0;
+}
+
+template <class T>
+void RasterizerCache<T>::Suspend(bool flush) {
+    if (suspended) {
+        return;
+    }
+    if (flush) {
+        FlushAll();
+    }
+
+    // Surfaces holding data that was not written back can't be checked against guest memory
+    for (const auto& surface_ids : page_table) {
+        for (const SurfaceId surface_id : surface_ids) {
+            Surface& surface = slot_surfaces[surface_id];
+            if (surface.picked) {
+                continue;
+            }
+            surface.picked = true;
+            const u64 hash = IsSurfaceDirty(surface_id, surface) ? 0 : HashGuestMemory(surface);
+            suspended_surfaces.emplace_back(surface_id, hash);
+        }
+    }
+    for (const auto& [surface_id, hash] : suspended_surfaces) {
+        slot_surfaces[surface_id].picked = false;
+    }
+
+    // The state sees the pages as regular memory, the counts are kept to mark them again later
+    cached_pages.ForEachRun([this](u32 first_page, u32 num_pages) {
+        memory.RasterizerMarkRegionCached(first_page << Memory::CITRA_PAGE_BITS,
+                                          num_pages << Memory::CITRA_PAGE_BITS, false);
+    });
+    suspended = true;
+}
+
+template <class T>
+void RasterizerCache<T>::Resume() {
+    if (!suspended) {
+        return;
+    }
+
+    // Pages are not marked while suspended, so unregistering leaves the page tables alone
+    u64 num_kept = 0;
+    for (const auto& [surface_id, hash] : suspended_surfaces) {
+        if (hash != 0 && HashGuestMemory(slot_surfaces[surface_id]) == hash) {
+            num_kept++;
+            continue;
+        }
+        UnregisterSurface(surface_id);
+    }
+    const u64 num_evicted = suspended_surfaces.size() - num_kept;
+    stats.state_kept_surfaces += num_kept;
+    stats.state_evicted_surfaces += num_evicted;
+    suspended_surfaces.clear();
+
+    // Whatever was not written back belonged to the previous state
+    dirty_regions.clear();
+    dirty_pages.reset();
+
+    suspended = false;
+    cached_pages.ForEachRun([this](u32 first_page, u32 num_pages) {
+        memory.RasterizerMarkRegionCached(first_page << Memory::CITRA_PAGE_BITS,
+                                          num_pages << Memory::CITRA_PAGE_BITS, true);
+    });
+
+    LOG_DEBUG(HW_GPU, "Kept {} surfaces across the state, evicted {}", num_kept, num_evicted);
+}
+
+template <class T>
+void RasterizerCache<T>::TickFrame() {
+    // Surfaces used within this many frames are likely to be needed again soon
+    constexpr u64 MIN_UNUSED_FRAMES = 60;
+
+    {
+        std::scoped_lock lock{stats_mutex};
+        last_frame_stats = std::exchange(stats, {});
+        total_stats += last_frame_stats;
+    }
+
+    frame_tick++;
+    if (use_custom_textures) {
+        custom_tex_manager.TickFrame();
+
+        // Reload the surfaces whose custom texture finished streaming in
+        std::erase_if(streaming_surfaces, [this](const auto& streaming) {
+            const auto [surface_id, texture] = streaming;
+            if (texture->state == DecodeState::Pending) {
+                return false;
+            }
+            Surface& surface = slot_surfaces[surface_id];
+            if (!IsSurfaceDirty(surface_id, surface)) {
+                surface.MarkInvalid(surface.GetInterval());
+                surface.ClearUploadHashes();
+            }
+            return true;
+        });
+    }
+
+    const u64 budget = memory_budget ? memory_budget : runtime.GetSurfaceMemoryBudget();
+    if (budget == 0 || surface_memory + runtime.GetRecycledMemory() <= budget) {
+        return;
+    }
+
+    // Only surfaces which can be reloaded from guest memory are evicted
+    std::vector<SurfaceId> candidates;
+    for (const auto& surface_ids : page_table) {
+        for (const SurfaceId surface_id : surface_ids) {
+            Surface& surface = slot_surfaces[surface_id];
+            if (surface.picked || frame_tick - surface.last_used_frame < MIN_UNUSED_FRAMES ||
+                surface_id == render_targets.color_surface_id ||
+                surface_id == render_targets.depth_surface_id ||
+                IsSurfaceDirty(surface_id, surface)) {
+                continue;
+            }
+            surface.picked = true;
+            candidates.push_back(surface_id);
+        }
+    }
+
+    std::ranges::sort(candidates, [this](SurfaceId lhs, SurfaceId rhs) {
+        return slot_surfaces[lhs].last_used_frame < slot_surfaces[rhs].last_used_frame;
+    });
+
+    u32 num_evicted = 0;
+    for (const SurfaceId surface_id : candidates) {
+        if (surface_memory <= budget) {
+            slot_surfaces[surface_id].picked = false;
+            continue;
+        }
+        UnregisterSurface(surface_id);
+        num_evicted++;
+    }
+
+    // Evicted textures end up in the runtime recycler, release them if that is not enough
+    const u64 recycled_memory = runtime.GetRecycledMemory();
+    if (recycled_memory != 0 && surface_memory + recycled_memory > budget) {
+        runtime.Clear();
+    }
+
+    if (num_evicted > 0) {
+        LOG_DEBUG(HW_GPU, "Evicted {} surfaces, {} bytes of a {} byte budget in use",
+                  num_evicted, surface_memory, budget);
+    }
+}
+
+template <class T>
+RasterizerCacheStats RasterizerCache<T>::GetLastFrameStats() const {
+    std::scoped_lock lock{stats_mutex};
+    return last_frame_stats;
+}
+
+template <class T>
+RasterizerCacheStats RasterizerCache<T>::GetTotalStats() const {
+    std::scoped_lock lock{stats_mutex};
+    return total_stats;
 }
 
 template <class T>
 void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, SurfaceId flush_surface_id) {
-    if (size == 0) [[unlikely]] {
+    if (size == 0 || suspended) [[unlikely]] {
         return;
     }
 
     MICROPROFILE_SCOPE(RasterizerCache_Flush);
+    stats.flushes++;
 
     const SurfaceInterval flush_interval(addr, addr + size);
+    if (!HasDirtyPages(flush_interval)) {
+        return;
+    }
     SurfaceRegions flushed_intervals{};
+    boost::container::small_vector<SurfaceDownload, 4> downloads;
 
     for (const auto& [dirty_interval, surface_id] :
          RangeFromInterval(dirty_regions, flush_interval)) {
@@ -1219,14 +1698,20 @@ void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, SurfaceId flush_surfa
         if (surface.type == SurfaceType::Fill) {
             DownloadFillSurface(surface, interval);
         } else {
-            DownloadSurface(surface, interval);
+            downloads.push_back(PrepareDownload(surface_id, interval));
         }
 
         flushed_intervals += interval;
     }
 
+    DownloadSurfaces({downloads.data(), downloads.size()});
+
     // Reset dirty regions
     dirty_regions -= flushed_intervals;
+    for (const auto& interval : flushed_intervals) {
+        UpdateDirtyPages(interval);
+    }
+    stats.flushed_bytes += boost::icl::length(flushed_intervals);
 }
 
 template <class T>
@@ -1236,11 +1721,13 @@ void RasterizerCache<T>::FlushAll() {
 
 template <class T>
 void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region_owner_id) {
-    if (size == 0) [[unlikely]] {
+    if (size == 0 || suspended) [[unlikely]] {
         return;
     }
 
     MICROPROFILE_SCOPE(RasterizerCache_Invalidation);
+    stats.invalidations++;
+    stats.invalidated_bytes += size;
 
     const SurfaceInterval invalid_interval{addr, addr + size};
     if (region_owner_id) {
@@ -1252,6 +1739,7 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region
         // Surfaces can't have a gap
         ASSERT(region_owner.width == region_owner.stride);
         region_owner.MarkValid(invalid_interval);
+        region_owner.ClearUploadHashes();
     }
 
     ForEachSurfaceInRegion(addr, size, [&](SurfaceId surface_id, Surface& surface) {
@@ -1267,20 +1755,28 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region
             return;
         }
 
+        const bool was_fully_invalid = surface.IsFullyInvalid();
         const SurfaceInterval interval = surface.GetInterval() & invalid_interval;
         surface.MarkInvalid(interval);
 
         // If the surface has no salvageable data it should be removed from the cache to avoid
-        // clogging the data structure
+        // clogging the data structure. Surfaces with upload hashes are kept until the next
+        // CPU write, in case the guest rewrote them with the same data.
         if (surface.IsFullyInvalid()) {
-            remove_surfaces.push_back(surface_id);
+            const bool keep = hash_texture_uploads && !region_owner_id && !was_fully_invalid &&
+                              surface.HasUploadHashes();
+            if (!keep) {
+                remove_surfaces.push_back(surface_id);
+            }
         }
     });
 
     if (region_owner_id) {
         dirty_regions.set({invalid_interval, region_owner_id});
-    } else {
+        MarkDirtyPages(invalid_interval);
+    } else if (HasDirtyPages(invalid_interval)) {
         dirty_regions.erase(invalid_interval);
+        UpdateDirtyPages(invalid_interval);
     }
 
     for (SurfaceId remove_id : remove_surfaces) {
@@ -1294,6 +1790,8 @@ SurfaceId RasterizerCache<T>::CreateSurface(const SurfaceParams& params) {
     SurfaceId surface_id = slot_surfaces.insert(runtime, params);
     Surface& surface = slot_surfaces[surface_id];
     surface.MarkInvalid(surface.GetInterval());
+    surface.last_used_frame = frame_tick;
+    stats.surfaces_created++;
     return surface_id;
 }
 
@@ -1303,6 +1801,7 @@ void RasterizerCache<T>::RegisterSurface(SurfaceId surface_id) {
     ASSERT_MSG(!surface.registered, "Trying to register an already registered surface");
 
     surface.registered = true;
+    surface_memory += SurfaceMemory(surface);
     UpdatePagesCachedCount(surface.addr, surface.size, 1);
     ForEachPage(surface.addr, surface.size,
                 [&](u64 page) { page_table[page].push_back(surface_id); });
@@ -1314,15 +1813,13 @@ void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
     ASSERT_MSG(surface.registered, "Trying to unregister an already unregistered surface");
 
     surface.registered = false;
+    surface_memory -= SurfaceMemory(surface);
+    std::erase_if(streaming_surfaces,
+                  [surface_id](const auto& streaming) { return streaming.first == surface_id; });
     UpdatePagesCachedCount(surface.addr, surface.size, -1);
 
     ForEachPage(surface.addr, surface.size, [&](u64 page) {
-        const auto page_it = page_table.find(page);
-        if (page_it == page_table.end()) {
-            ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}", page << CITRA_PAGEBITS);
-            return;
-        }
-        std::vector<SurfaceId>& surface_ids = page_it->second;
+        auto& surface_ids = page_table[page];
         const auto vector_it = std::find(surface_ids.begin(), surface_ids.end(), surface_id);
         if (vector_it == surface_ids.end()) {
             ASSERT_MSG(false, "Unregistering unregistered surface in page=0x{:x}",
@@ -1333,56 +1830,102 @@ void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
     });
 
     slot_surfaces.erase(surface_id);
+    stats.surfaces_destroyed++;
 }
 
 template <class T>
 void RasterizerCache<T>::UnregisterAll() {
     FlushAll();
-    for (auto& [page, surfaces] : page_table) {
+    for (auto& surfaces : page_table) {
         while (!surfaces.empty()) {
             UnregisterSurface(surfaces.back());
         }
     }
-    page_table.clear();
     texture_cube_cache.clear();
     remove_surfaces.clear();
     runtime.Clear();
 }
 
 template <class T>
-void RasterizerCache<T>::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
-    const u32 num_pages =
-        ((addr + size - 1) >> Memory::CITRA_PAGE_BITS) - (addr >> Memory::CITRA_PAGE_BITS) + 1;
-    const u32 page_start = addr >> Memory::CITRA_PAGE_BITS;
-    const u32 page_end = page_start + num_pages;
-
-    // Interval maps will erase segments if count reaches 0, so if delta is negative we have to
-    // subtract after iterating
-    const auto pages_interval = PageMap::interval_type::right_open(page_start, page_end);
-    if (delta > 0) {
-        cached_pages.add({pages_interval, delta});
+u64 RasterizerCache<T>::SurfaceMemory(const Surface& surface) {
+    const u64 layers = surface.texture_type == TextureType::CubeMap ? 6 : 1;
+    u64 texels = 0;
+    for (u32 level = 0; level < surface.levels; level++) {
+        texels += (surface.GetScaledWidth() >> level) * (surface.GetScaledHeight() >> level);
     }
+    return texels * layers * surface.GetInternalBytesPerPixel();
+}
 
-    for (const auto& pair : RangeFromInterval(cached_pages, pages_interval)) {
-        const auto interval = pair.first & pages_interval;
-        const int count = pair.second;
-
-        const PAddr interval_start_addr = boost::icl::first(interval) << Memory::CITRA_PAGE_BITS;
-        const PAddr interval_end_addr = boost::icl::last_next(interval) << Memory::CITRA_PAGE_BITS;
-        const u32 interval_size = interval_end_addr - interval_start_addr;
+template <class T>
+u64 RasterizerCache<T>::HashGuestMemory(const Surface& surface) {
+    MemoryRef source_ptr = memory.GetPhysicalRef(surface.addr);
+    if (!source_ptr || source_ptr.GetSize() < surface.size) [[unlikely]] {
+        return 0;
+    }
+    return Common::ComputeHash64(source_ptr.GetPtr(), surface.size);
+}
 
-        if (delta > 0 && count == delta) {
-            memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, true);
-        } else if (delta < 0 && count == -delta) {
-            memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, false);
-        } else {
-            ASSERT(count >= 0);
+template <class T>
+bool RasterizerCache<T>::IsSurfaceDirty(SurfaceId surface_id, const Surface& surface) const {
+    if (!HasDirtyPages(surface.GetInterval())) {
+        return false;
+    }
+    for (const auto& pair : RangeFromInterval(dirty_regions, surface.GetInterval())) {
+        if (pair.second == surface_id) {
+            return true;
         }
     }
+    return false;
+}
 
-    if (delta < 0) {
-        cached_pages.add({pages_interval, delta});
+template <class T>
+bool RasterizerCache<T>::HasDirtyPages(const SurfaceInterval& interval) const {
+    const u64 page_end =
+        std::min<u64>((u64{interval.upper()} - 1) >> CITRA_PAGEBITS, NUM_PAGES - 1);
+    for (u64 page = interval.lower() >> CITRA_PAGEBITS; page <= page_end; page++) {
+        if (dirty_pages.test(page)) {
+            return true;
+        }
     }
+    return false;
+}
+
+template <class T>
+void RasterizerCache<T>::MarkDirtyPages(const SurfaceInterval& interval) {
+    ForEachPage(interval.lower(), boost::icl::length(interval),
+                [this](u64 page) { dirty_pages.set(page); });
+}
+
+template <class T>
+void RasterizerCache<T>::UpdateDirtyPages(const SurfaceInterval& interval) {
+    ForEachPage(interval.lower(), boost::icl::length(interval), [this](u64 page) {
+        if (!dirty_pages.test(page)) {
+            return;
+        }
+        const u64 page_start = page << CITRA_PAGEBITS;
+        const SurfaceInterval page_interval{
+            static_cast<PAddr>(page_start),
+            static_cast<PAddr>(std::min<u64>(page_start + (u64{1} << CITRA_PAGEBITS),
+                                             0xFFFFFFFF))};
+        if (!boost::icl::intersects(dirty_regions, page_interval)) {
+            dirty_pages.reset(page);
+        }
+    });
+}
+
+template <class T>
+void RasterizerCache<T>::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
+    const u32 page_start = addr >> Memory::CITRA_PAGE_BITS;
+    const u32 page_end = ((addr + size - 1) >> Memory::CITRA_PAGE_BITS) + 1;
+
+    // Only pages that switch between cached and uncached need their page table entries updated
+    cached_pages.Update(page_start, page_end, delta, [this, delta](u32 first_page, u32 num_pages) {
+        if (suspended) {
+            return;
+        }
+        memory.RasterizerMarkRegionCached(first_page << Memory::CITRA_PAGE_BITS,
+                                          num_pages << Memory::CITRA_PAGE_BITS, delta > 0);
+    });
 }
 
 } // namespace VideoCore
@@ -5,10 +5,17 @@
 #pragma once
 
 #include <algorithm>
+#include <bitset>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <boost/container/small_vector.hpp>
 #include <boost/icl/interval_map.hpp>
+#include "common/thread_worker.h"
+#include "video_core/rasterizer_cache/cache_stats.h"
+#include "video_core/rasterizer_cache/page_counter.h"
 #include "video_core/rasterizer_cache/sampler_params.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/utils.h"
@@ -37,11 +44,14 @@ enum class MatchFlags {
 DECLARE_ENUM_FLAG_OPERATORS(MatchFlags);
 
 class CustomTexManager;
+struct CustomTexture;
 
 template <class T>
 class RasterizerCache {
     /// Address shift for caching surfaces into a hash table
     static constexpr u64 CITRA_PAGEBITS = 18;
+    /// Number of pages covering the 32-bit physical address space
+    static constexpr std::size_t NUM_PAGES = std::size_t{1} << (32 - CITRA_PAGEBITS);
 
     using Runtime = typename T::Runtime;
     using Surface = typename T::Surface;
@@ -54,7 +64,6 @@ class RasterizerCache {
                                                 boost::icl::inter_section, SurfaceInterval>;
 
     using SurfaceRect_Tuple = std::pair<SurfaceId, Common::Rectangle<u32>>;
-    using PageMap = boost::icl::interval_map<u32, int>;
 
     struct RenderTargets {
         SurfaceId color_surface_id;
@@ -63,7 +72,19 @@ class RasterizerCache {
 
     struct CubeParams {
         SurfaceId cube_id;
-        std::array<s64, 6> ticks{};
+        /// Modification ticks of the face surfaces when they were last copied to the cube, ticks
+        /// are unique across surfaces so a face surface that was replaced is copied again
+        std::array<u64, 6> ticks{};
+    };
+
+    struct SurfaceDownload {
+        SurfaceId surface_id;
+        SurfaceParams flush_info;
+        PAddr flush_start;
+        PAddr flush_end;
+        u32 linear_offset; ///< Non zero when the GPU swizzles, the tiled data is placed first
+        u32 staging_size;
+        bool use_gpu_codec;
     };
 
 public:
@@ -115,6 +136,11 @@ public:
     /// Get a surface that matches a "texture copy" display transfer config
     SurfaceRect_Tuple GetTexCopySurface(const SurfaceParams& params);
 
+    /// Copies the rectangle of the surface to output lines of line_rows unscaled rows each,
+    /// placed line_stride bytes apart from dst_addr, as one surface copy per line
+    bool CopyTextureLines(SurfaceId src_surface_id, Rect2D src_rect, u32 src_level,
+                          PAddr dst_addr, u32 line_rows, u32 line_stride);
+
     /// Write any cached resources overlapping the region back to memory (if dirty)
     void FlushRegion(PAddr addr, u32 size, SurfaceId flush_surface_id = {});
 
@@ -127,12 +153,30 @@ public:
     /// Clear all cached resources tracked by this cache manager
     void ClearAll(bool flush);
 
+    /// Detaches the surfaces from guest memory while a state is saved or loaded, remembering the
+    /// guest memory each of them was loaded from. Memory accesses are ignored until Resume.
+    void Suspend(bool flush);
+
+    /// Keeps the suspended surfaces whose guest memory is unchanged and evicts the others
+    void Resume();
+
+    /// Evicts surfaces that have not been used recently when over the memory budget
+    void TickFrame();
+
+    /// Returns the statistics of the last frame, safe to call from any thread
+    RasterizerCacheStats GetLastFrameStats() const;
+
+    /// Returns the statistics of all frames since the cache was created, safe to call from any
+    /// thread
+    RasterizerCacheStats GetTotalStats() const;
+
 private:
     /// Iterate over all page indices in a range
     template <typename Func>
     void ForEachPage(PAddr addr, size_t size, Func&& func) {
         static constexpr bool RETURNS_BOOL = std::is_same_v<std::invoke_result<Func, u64>, bool>;
-        const u64 page_end = (addr + size - 1) >> CITRA_PAGEBITS;
+        const u64 page_end =
+            std::min<u64>((u64{addr} + size - 1) >> CITRA_PAGEBITS, NUM_PAGES - 1);
         for (u64 page = addr >> CITRA_PAGEBITS; page <= page_end; ++page) {
             if constexpr (RETURNS_BOOL) {
                 if (func(page)) {
@@ -160,14 +204,24 @@ private:
     void ValidateSurface(SurfaceId surface_id, PAddr addr, u32 size);
 
     /// Copies pixel data in interval from the guest VRAM to the host GPU surface
-    void UploadSurface(Surface& surface, SurfaceInterval interval);
+    void UploadSurface(SurfaceId surface_id, SurfaceInterval interval);
+
+    /// Decodes the guest data of an upload, splitting large ETC1 textures across workers
+    void DecodeUpload(const SurfaceParams& load_info, std::span<u8> upload_data,
+                      std::span<u8> staging_data, bool convert);
+
+    /// Returns true if the backend can decode, or encode, the whole tiled interval on the GPU
+    bool UseGpuCodec(const Surface& surface, const SurfaceParams& info, bool encode) const;
 
     /// Uploads a custom texture associated with upload_data to the target surface
-    bool UploadCustomSurface(Surface& surface, const SurfaceParams& load_info,
+    bool UploadCustomSurface(SurfaceId surface_id, const SurfaceParams& load_info,
                              std::span<u8> upload_data);
 
-    /// Copies pixel data in interval from the host GPU surface to the guest VRAM
-    void DownloadSurface(Surface& surface, SurfaceInterval interval);
+    /// Computes the staging layout of a download of interval from the host GPU surface
+    SurfaceDownload PrepareDownload(SurfaceId surface_id, SurfaceInterval interval);
+
+    /// Copies the pixel data of the downloads to the guest VRAM, waiting on the GPU once per batch
+    void DownloadSurfaces(std::span<const SurfaceDownload> downloads);
 
     /// Downloads a fill surface to guest VRAM
     void DownloadFillSurface(Surface& surface, SurfaceInterval interval);
@@ -195,6 +249,24 @@ private:
     /// Unregisters all surfaces from the cache
     void UnregisterAll();
 
+    /// Returns the approximate host memory used by the surface's texture
+    static u64 SurfaceMemory(const Surface& surface);
+
+    /// Returns the hash of the guest memory covered by the surface, zero if it is not mapped
+    u64 HashGuestMemory(const Surface& surface);
+
+    /// Returns true if the surface holds GPU written data that has not been flushed
+    bool IsSurfaceDirty(SurfaceId surface_id, const Surface& surface) const;
+
+    /// Returns true if any page of the interval may hold data that has not been flushed
+    bool HasDirtyPages(const SurfaceInterval& interval) const;
+
+    /// Marks the pages of an interval that was added to the dirty regions
+    void MarkDirtyPages(const SurfaceInterval& interval);
+
+    /// Clears the pages of an interval that no longer overlap the dirty regions
+    void UpdateDirtyPages(const SurfaceInterval& interval);
+
     /// Increase/decrease the number of surface in pages touching the specified region
     void UpdatePagesCachedCount(PAddr addr, u32 size, int delta);
 
@@ -202,15 +274,23 @@ private:
     Memory::MemorySystem& memory;
     Runtime& runtime;
     CustomTexManager& custom_tex_manager;
-    PageMap cached_pages;
+    PageCounter cached_pages;
     SurfaceMap dirty_regions;
     std::vector<SurfaceId> remove_surfaces;
+    /// Surfaces detached by Suspend with the hash of their guest memory, zero if they were dirty
+    std::vector<std::pair<SurfaceId, u64>> suspended_surfaces;
+    bool suspended{};
+    /// Surfaces showing the guest texture while their custom texture streams in
+    std::vector<std::pair<SurfaceId, const CustomTexture*>> streaming_surfaces;
     u16 resolution_scale_factor;
 
     // The internal surface cache is based on buckets of 256KB.
     // This fits better for the purpose of this cache as textures are normaly
-    // large in size.
-    std::unordered_map<u64, std::vector<SurfaceId>, Common::IdentityHash<u64>> page_table;
+    // large in size. The buckets are indexed directly, as the whole physical address space only
+    // needs a few thousands of them.
+    std::vector<boost::container::small_vector<SurfaceId, 4>> page_table;
+    /// Pages overlapping dirty_regions, lets most flushes skip looking at the interval map
+    std::bitset<NUM_PAGES> dirty_pages;
     std::unordered_map<SamplerParams, SamplerId> samplers;
     std::unordered_map<TextureCubeConfig, CubeParams> texture_cube_cache;
 
@@ -221,6 +301,22 @@ private:
     // Custom textures
     bool dump_textures;
     bool use_custom_textures;
+    bool gpu_texture_decoding;
+    bool hash_texture_uploads;
+
+    /// Surface memory tracking, a budget of zero leaves the choice to the runtime
+    u64 memory_budget;
+    u64 surface_memory{};
+    u64 frame_tick{};
+
+    /// Statistics of the current frame, folded into the others by TickFrame
+    RasterizerCacheStats stats{};
+    mutable std::mutex stats_mutex;
+    RasterizerCacheStats last_frame_stats{};
+    RasterizerCacheStats total_stats{};
+
+    /// Created on the first upload that is large enough to be split
+    std::unique_ptr<Common::ThreadWorker> decode_workers;
 };
 
 } // namespace VideoCore
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <atomic>
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "video_core/rasterizer_cache/surface_base.h"
@@ -9,7 +10,13 @@
 
 namespace VideoCore {
 
-SurfaceBase::SurfaceBase(const SurfaceParams& params) : SurfaceParams{params} {}
+SurfaceBase::SurfaceBase(const SurfaceParams& params)
+    : SurfaceParams{params}, modification_tick{NextModificationTick()} {}
+
+u64 SurfaceBase::NextModificationTick() {
+    static std::atomic<u64> next_tick{1};
+    return next_tick.fetch_add(1, std::memory_order_relaxed);
+}
 
 bool SurfaceBase::CanFill(const SurfaceParams& dest_surface, SurfaceInterval fill_interval) const {
     if (type == SurfaceType::Fill && IsRegionValid(fill_interval) &&
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <boost/icl/interval_set.hpp>
 #include "video_core/rasterizer_cache/surface_params.h"
@@ -39,12 +40,12 @@ public:
 
     void MarkValid(SurfaceInterval interval) {
         invalid_regions.erase(interval);
-        modification_tick++;
+        modification_tick = NextModificationTick();
     }
 
     void MarkInvalid(SurfaceInterval interval) {
         invalid_regions.insert(interval);
-        modification_tick++;
+        modification_tick = NextModificationTick();
     }
 
     bool IsFullyInvalid() const {
@@ -52,6 +53,16 @@ public:
         return *invalid_regions.equal_range(interval).first == interval;
     }
 
+    /// Returns true when every level holds exactly the guest data it was last uploaded from
+    bool HasUploadHashes() const {
+        return std::all_of(upload_hashes.begin(), upload_hashes.begin() + levels,
+                           [](u64 hash) { return hash != 0; });
+    }
+
+    void ClearUploadHashes() {
+        upload_hashes.fill(0);
+    }
+
     /// Returns true when this surface can be used to fill the fill_interval of dest_surface
     bool CanFill(const SurfaceParams& dest_surface, SurfaceInterval fill_interval) const;
 
@@ -68,6 +79,10 @@ private:
     /// Returns the fill buffer value starting from copy_addr
     std::array<u8, 4> MakeFillBuffer(PAddr copy_addr);
 
+    /// Returns a tick no surface had before. Surfaces are often recreated in the slot of the one
+    /// they replace, unique ticks keep users that remember a tick from mistaking one for the other.
+    static u64 NextModificationTick();
+
 public:
     bool registered = false;
     bool picked = false;
@@ -76,7 +91,9 @@ public:
     SurfaceRegions invalid_regions;
     std::array<u8, 4> fill_data;
     u32 fill_size = 0;
-    u64 modification_tick = 1;
+    u64 modification_tick;
+    u64 last_used_frame = 0;
+    std::array<u64, MAX_PICA_LEVELS> upload_hashes{};
 };
 
 } // namespace VideoCore
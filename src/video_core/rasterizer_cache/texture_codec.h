@@ -87,33 +87,34 @@ constexpr void DecodePixel4(u32 x, u32 y, const u8* source_tile, u8* dest_pixel)
 }
 
 template <PixelFormat format>
-constexpr void DecodePixelETC1(u32 x, u32 y, const u8* source_tile, u8* dest_pixel) {
-    constexpr u32 subtile_width = 4;
-    constexpr u32 subtile_height = 4;
+constexpr void DecodeTileETC1(u32 stride, const u8* source_tile, u8* linear_tile) {
     constexpr bool has_alpha = format == PixelFormat::ETC1A4;
     constexpr std::size_t subtile_size = has_alpha ? 16 : 8;
 
-    const u32 subtile_index = (x / subtile_width) + 2 * (y / subtile_height);
-    x %= subtile_width;
-    y %= subtile_height;
-
-    const u8* subtile_ptr = source_tile + subtile_index * subtile_size;
-
-    u8 alpha = 255;
-    if constexpr (has_alpha) {
-        u64_le packed_alpha;
-        std::memcpy(&packed_alpha, subtile_ptr, sizeof(u64));
-        subtile_ptr += sizeof(u64);
-
-        alpha = Common::Color::Convert4To8((packed_alpha >> (4 * (x * subtile_width + y))) & 0xF);
+    // Each subtile is decoded at once instead of parsing its header again for every texel
+    std::array<Common::Vec3<u8>, 16> texels;
+    for (u32 subtile_index = 0; subtile_index < 4; subtile_index++) {
+        const u8* subtile_ptr = source_tile + subtile_index * subtile_size;
+        u64 packed_alpha = 0;
+        if constexpr (has_alpha) {
+            packed_alpha = MakeInt<u64_le>(subtile_ptr);
+            subtile_ptr += sizeof(u64);
+        }
+        Pica::Texture::DecodeETC1Subtile(MakeInt<u64_le>(subtile_ptr), texels);
+
+        const u32 subtile_x = (subtile_index % 2) * 4;
+        const u32 subtile_y = (subtile_index / 2) * 4;
+        for (u32 y = 0; y < 4; y++) {
+            u8* linear_row = linear_tile + ((7 - subtile_y - y) * stride + subtile_x) * 4;
+            for (u32 x = 0; x < 4; x++) {
+                u8* dest_pixel = linear_row + x * 4;
+                std::memcpy(dest_pixel, texels[y * 4 + x].AsArray(), 3);
+                dest_pixel[3] = has_alpha ? Common::Color::Convert4To8(
+                                                (packed_alpha >> (4 * (x * 4 + y))) & 0xF)
+                                          : 255;
+            }
+        }
     }
-
-    const u64_le subtile_data = MakeInt<u64_le>(subtile_ptr);
-    const auto rgb = Pica::Texture::SampleETC1Subtile(subtile_data, x, y);
-
-    // Copy the uncompressed pixel to the destination
-    std::memcpy(dest_pixel, rgb.AsArray(), 3);
-    dest_pixel[3] = alpha;
 }
 
 template <PixelFormat format, bool converted>
@@ -202,6 +203,26 @@ constexpr void EncodePixel4(u32 x, u32 y, const u8* source_pixel, u8* dest_tile_
     }
 }
 
+/// Returns true if pixels of the format are copied without changes by DecodePixel/EncodePixel
+template <PixelFormat format, bool converted>
+constexpr bool IsRawCopy() {
+    switch (format) {
+    case PixelFormat::IA8:
+    case PixelFormat::RG8:
+    case PixelFormat::I8:
+    case PixelFormat::A8:
+    case PixelFormat::IA4:
+    case PixelFormat::I4:
+    case PixelFormat::A4:
+    case PixelFormat::ETC1:
+    case PixelFormat::ETC1A4:
+    case PixelFormat::D24S8:
+        return false;
+    default:
+        return !converted && GetFormatBpp(format) / 8 == GetBytesPerPixel(format);
+    }
+}
+
 template <bool morton_to_linear, PixelFormat format, bool converted>
 constexpr void MortonCopyTile(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
     constexpr u32 bytes_per_pixel = GetFormatBpp(format) / 8;
@@ -209,6 +230,28 @@ constexpr void MortonCopyTile(u32 stride, std::span<u8> tile_buffer, std::span<u
     constexpr bool is_compressed = format == PixelFormat::ETC1 || format == PixelFormat::ETC1A4;
     constexpr bool is_4bit = format == PixelFormat::I4 || format == PixelFormat::A4;
 
+    if constexpr (IsRawCopy<format, converted>()) {
+        // Horizontally adjacent pixel pairs are adjacent in morton order as well,
+        // so the tile can be copied two pixels at a time.
+        constexpr u32 pair_size = 2 * bytes_per_pixel;
+        for (u32 y = 0; y < 8; y++) {
+            u8* linear_row = linear_buffer.data() + (7 - y) * stride * bytes_per_pixel;
+            for (u32 x = 0; x < 8; x += 2) {
+                u8* tiled_pair = tile_buffer.data() + MortonInterleave(x, y) * bytes_per_pixel;
+                u8* linear_pair = linear_row + x * bytes_per_pixel;
+                if constexpr (morton_to_linear) {
+                    std::memcpy(linear_pair, tiled_pair, pair_size);
+                } else {
+                    std::memcpy(tiled_pair, linear_pair, pair_size);
+                }
+            }
+        }
+        return;
+    } else if constexpr (is_compressed && morton_to_linear) {
+        DecodeTileETC1<format>(stride, tile_buffer.data(), linear_buffer.data());
+        return;
+    }
+
     for (u32 y = 0; y < 8; y++) {
         for (u32 x = 0; x < 8; x++) {
             const auto tiled_pixel = tile_buffer.subspan(
@@ -216,9 +259,7 @@ constexpr void MortonCopyTile(u32 stride, std::span<u8> tile_buffer, std::span<u
             const auto linear_pixel = linear_buffer.subspan(
                 ((7 - y) * stride + x) * linear_bytes_per_pixel, linear_bytes_per_pixel);
             if constexpr (morton_to_linear) {
-                if constexpr (is_compressed) {
-                    DecodePixelETC1<format>(x, y, tile_buffer.data(), linear_pixel.data());
-                } else if constexpr (is_4bit) {
+                if constexpr (is_4bit) {
                     DecodePixel4<format>(x, y, tile_buffer.data(), linear_pixel.data());
                 } else {
                     DecodePixel<format, converted>(tiled_pixel.data(), linear_pixel.data());
@@ -4,6 +4,7 @@
 
 #include "common/assert.h"
 #include "video_core/rasterizer_cache/custom_tex_manager.h"
+#include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/texture_codec.h"
 #include "video_core/rasterizer_cache/utils.h"
@@ -44,6 +45,32 @@ void EncodeTexture(const SurfaceParams& surface_info, PAddr start_addr, PAddr en
     UNREACHABLE();
 }
 
+TextureCodecParams MakeTextureCodecParams(PixelFormat format, u32 width, u32 height,
+                                          u32 tiled_offset, u32 linear_offset, bool convert,
+                                          bool encode) {
+    ASSERT(tiled_offset % 4 == 0 && linear_offset % 4 == 0);
+    const bool is_texture = GetFormatType(format) == SurfaceType::Texture;
+    ASSERT_MSG(!encode || !is_texture, "Texture formats cannot be encoded on the GPU");
+
+    const u32 tiled_size = width * height * GetFormatBpp(format) / 8;
+    const u32 flags = (encode ? TextureCodecParams::Encode : 0) |
+                      (convert || is_texture ? TextureCodecParams::Convert : 0);
+    // Converted decodes write one texel per invocation, everything else one word. Unconverted
+    // linear data has the guest texel size so both cases are sized by the tiled data
+    const bool per_texel = !encode && (flags & TextureCodecParams::Convert);
+    const u32 count = per_texel ? width * height : tiled_size / 4;
+
+    return TextureCodecParams{
+        .tiled_offset = tiled_offset / 4,
+        .linear_offset = linear_offset / 4,
+        .width = width,
+        .height = height,
+        .format = static_cast<u32>(format),
+        .flags = flags,
+        .count = count,
+    };
+}
+
 u32 MipLevels(u32 width, u32 height, u32 max_level) {
     u32 levels = 1;
     while (width > 8 && height > 8) {
@@ -81,6 +81,7 @@ struct BufferTextureCopy {
     u32 buffer_size;
     Rect2D texture_rect;
     u32 texture_level;
+    u64 source_hash{}; ///< Hash of the guest data being uploaded, zero when unknown
 };
 
 enum class DecodeState : u32;
@@ -112,8 +113,36 @@ struct TextureCubeConfig {
     }
 };
 
+/// Parameters of the texture codec compute shader, matches CodecInfo in texture_codec.comp
+struct TextureCodecParams {
+    static constexpr u32 Encode = 1;
+    static constexpr u32 Convert = 2;
+
+    u32 tiled_offset;  ///< Offset of the tiled data in the bound buffer, in words
+    u32 linear_offset; ///< Offset of the linear data in the bound buffer, in words
+    u32 width;
+    u32 height;
+    u32 format;
+    u32 flags;
+    u32 count; ///< Number of shader invocations
+};
+static_assert(sizeof(TextureCodecParams) == 7 * sizeof(u32));
+
+enum class PixelFormat : u32;
 class SurfaceParams;
 
+/**
+ * Fills the texture codec shader parameters for a whole tiled surface level.
+ *
+ * @param tiled_offset Byte offset of the tiled data, must be 4 byte aligned.
+ * @param linear_offset Byte offset of the linear data, must be 4 byte aligned.
+ * @param convert Whether the pixel format needs to be converted. Texture formats always are.
+ * @param encode Whether to swizzle the linear data instead of unswizzling the tiled data.
+ */
+TextureCodecParams MakeTextureCodecParams(PixelFormat format, u32 width, u32 height,
+                                          u32 tiled_offset, u32 linear_offset, bool convert,
+                                          bool encode);
+
 u32 MipLevels(u32 width, u32 height, u32 max_level);
 
 /**
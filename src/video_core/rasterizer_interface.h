@@ -8,6 +8,7 @@
 #include <functional>
 #include "common/common_types.h"
 #include "core/hw/gpu.h"
+#include "video_core/rasterizer_cache/cache_stats.h"
 
 namespace Pica::Shader {
 struct OutputVertex;
@@ -54,6 +55,15 @@ public:
     /// Removes as much state as possible from the rasterizer in preparation for a save/load state
     virtual void ClearAll(bool flush) = 0;
 
+    /// Detaches the caches from guest memory while a state is saved or loaded
+    virtual void SuspendCaches(bool flush) {
+        ClearAll(flush);
+    }
+
+    /// Reattaches the caches after a state was saved or loaded, dropping what no longer matches
+    /// guest memory
+    virtual void ResumeCaches() {}
+
     /// Attempt to use a faster method to perform a display transfer with is_texture_copy = 0
     virtual bool AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
         return false;
@@ -80,5 +90,18 @@ public:
 
     /// Synchronizes the graphics API state with the PICA state
     virtual void SyncEntireState() {}
+
+    /// Notifies the rasterizer that a frame has been presented
+    virtual void TickFrame() {}
+
+    /// Returns the activity of the texture cache during the last presented frame
+    virtual RasterizerCacheStats GetLastFrameCacheStats() const {
+        return {};
+    }
+
+    /// Returns the activity of the texture cache since the rasterizer was created
+    virtual RasterizerCacheStats GetTotalCacheStats() const {
+        return {};
+    }
 };
 } // namespace VideoCore
@@ -19,7 +19,7 @@ void RendererBase::RefreshBaseSettings() {
 
 void RendererBase::UpdateCurrentFramebufferLayout(bool is_portrait_mode) {
     const auto update_layout = [is_portrait_mode](Frontend::EmuWindow& window) {
-        const Layout::FramebufferLayout& layout = window.GetFramebufferLayout();
+        const Layout::FramebufferLayout layout = window.GetFramebufferLayout();
         window.UpdateCurrentFramebufferLayout(layout.width, layout.height, is_portrait_mode);
     };
     update_layout(render_window);
@@ -0,0 +1,54 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <thread>
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "core/tracer/recorder.h"
+#include "video_core/compile_report.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/renderer_null/renderer_null.h"
+
+namespace Null {
+
+RendererNull::RendererNull(Core::System& system, Frontend::EmuWindow& window,
+                           Frontend::EmuWindow* secondary_window)
+    : RendererBase{window, secondary_window}, system{system} {
+    LOG_INFO(Render, "Using the null renderer, nothing is drawn or presented");
+}
+
+RendererNull::~RendererNull() = default;
+
+void RendererNull::SwapBuffers() {
+    if (settings.screenshot_requested.exchange(false)) {
+        LOG_WARNING(Render, "The null renderer can't take screenshots, ignoring the request");
+    }
+
+    m_current_frame++;
+    rasterizer.TickFrame();
+    VideoCore::g_compile_report.TickFrame();
+
+    system.perf_stats->EndSystemFrame();
+    render_window.PollEvents();
+
+    {
+        Core::PerfStats::SubsystemTimer timer{system.perf_stats.get(),
+                                              Core::PerfStats::Subsystem::FrameLimiter};
+        system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    }
+    system.perf_stats->BeginSystemFrame();
+
+    if (Pica::g_debug_context && Pica::g_debug_context->recorder) {
+        Pica::g_debug_context->recorder->FrameFinished();
+    }
+}
+
+void RendererNull::TryPresent(int timeout_ms, bool is_secondary) {
+    // There is never a frame to present, waiting keeps the presentation loops from spinning
+    std::this_thread::sleep_for(std::chrono::milliseconds{timeout_ms});
+}
+
+} // namespace Null
@@ -0,0 +1,61 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+
+namespace Core {
+class System;
+}
+
+namespace Null {
+
+/**
+ * Rasterizer that draws nothing. Guest memory is the only copy of every surface, so memory fills
+ * and display transfers are done by the software paths of the GPU and stay visible to the CPU.
+ * Render targets keep whatever those wrote to them.
+ */
+class RasterizerNull : public VideoCore::RasterizerInterface {
+public:
+    void AddTriangle(const Pica::Shader::OutputVertex& v0, const Pica::Shader::OutputVertex& v1,
+                     const Pica::Shader::OutputVertex& v2) override {}
+    void DrawTriangles() override {}
+    void NotifyPicaRegisterChanged(u32 id) override {}
+    void FlushAll() override {}
+    void FlushRegion(PAddr addr, u32 size) override {}
+    void InvalidateRegion(PAddr addr, u32 size) override {}
+    void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
+    void ClearAll(bool flush) override {}
+
+    /// Claims every batch, so that its vertices are not shaded on the CPU only to be dropped
+    bool AccelerateDrawBatch(bool is_indexed) override {
+        return true;
+    }
+};
+
+/// Renderer for runs that need the game logic but not its output, frames are never presented
+class RendererNull : public VideoCore::RendererBase {
+public:
+    explicit RendererNull(Core::System& system, Frontend::EmuWindow& window,
+                          Frontend::EmuWindow* secondary_window);
+    ~RendererNull() override;
+
+    [[nodiscard]] VideoCore::RasterizerInterface* Rasterizer() override {
+        return &rasterizer;
+    }
+
+    void SwapBuffers() override;
+    void TryPresent(int timeout_ms, bool is_secondary) override;
+    void PrepareVideoDumping() override {}
+    void CleanupVideoDumping() override {}
+    void Sync() override {}
+
+private:
+    Core::System& system;
+    RasterizerNull rasterizer;
+};
+
+} // namespace Null
@@ -55,43 +55,72 @@ void FrameDumperOpenGL::PresentLoop() {
 
         glWaitSync(frame->render_fence.handle, 0, GL_TIMEOUT_IGNORED);
 
+        Readback& readback = readbacks[next_readback];
         glBindFramebuffer(GL_READ_FRAMEBUFFER, frame->present.handle);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[current_pbo].handle);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo.handle);
         glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback.fence.Create();
 
         // Insert fence for the main thread to block on
         frame->present_fence.Create();
         glFlush();
 
-        // Bind the previous PBO and read the pixels
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[next_pbo].handle);
-        GLubyte* pixels = static_cast<GLubyte*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
-        VideoDumper::VideoFrame frame_data{layout.width, layout.height, pixels};
-        video_dumper.AddVideoFrame(std::move(frame_data));
-        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        next_readback = (next_readback + 1) % NUM_READBACKS;
+        num_pending_readbacks++;
+
+        // Download the readbacks that are done, only block when every PBO is in use
+        while (num_pending_readbacks > 0 &&
+               DownloadReadback(num_pending_readbacks == NUM_READBACKS)) {
+        }
+    }
 
-        current_pbo = (current_pbo + 1) % 2;
-        next_pbo = (current_pbo + 1) % 2;
+    // Hand over the frames that are still being read back
+    while (num_pending_readbacks > 0 && video_dumper.IsDumping()) {
+        DownloadReadback(true);
     }
 
     CleanupOpenGLObjects();
 }
 
+bool FrameDumperOpenGL::DownloadReadback(bool wait) {
+    const std::size_t index =
+        (next_readback + NUM_READBACKS - num_pending_readbacks) % NUM_READBACKS;
+    Readback& readback = readbacks[index];
+    const GLenum status = glClientWaitSync(readback.fence.handle, 0, wait ? GL_TIMEOUT_IGNORED : 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    readback.fence.Release();
+    num_pending_readbacks--;
+
+    const auto& layout = GetLayout();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo.handle);
+    GLubyte* pixels = static_cast<GLubyte*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    VideoDumper::VideoFrame frame_data{layout.width, layout.height, pixels};
+    video_dumper.AddVideoFrame(std::move(frame_data));
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
 void FrameDumperOpenGL::InitializeOpenGLObjects() {
     const auto& layout = GetLayout();
-    for (auto& buffer : pbos) {
-        buffer.Create();
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+    for (auto& readback : readbacks) {
+        readback.pbo.Create();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo.handle);
         glBufferData(GL_PIXEL_PACK_BUFFER, layout.width * layout.height * 4, nullptr,
                      GL_STREAM_READ);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     }
+    next_readback = 0;
+    num_pending_readbacks = 0;
 }
 
 void FrameDumperOpenGL::CleanupOpenGLObjects() {
-    for (auto& buffer : pbos) {
-        buffer.Release();
+    for (auto& readback : readbacks) {
+        readback.pbo.Release();
+        readback.fence.Release();
     }
 }
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <thread>
@@ -43,15 +44,27 @@ private:
     void CleanupOpenGLObjects();
     void PresentLoop();
 
+    /// Hands the oldest pending readback to the video dumper. Returns false when wait is not set
+    /// and the readback has not finished yet.
+    bool DownloadReadback(bool wait);
+
+    /// Number of frames that can be read back at the same time
+    static constexpr std::size_t NUM_READBACKS = 3;
+
+    struct Readback {
+        OGLBuffer pbo;
+        OGLSync fence;
+    };
+
     VideoDumper::Backend& video_dumper;
     std::unique_ptr<Frontend::GraphicsContext> context;
     std::thread present_thread;
     std::atomic_bool stop_requested{false};
 
-    // PBOs used to dump frames faster
-    std::array<OGLBuffer, 2> pbos;
-    GLuint current_pbo = 1;
-    GLuint next_pbo = 0;
+    // Ring of PBOs that are downloaded once their fence signals, so dumping does not stall
+    std::array<Readback, NUM_READBACKS> readbacks;
+    std::size_t next_readback = 0;
+    std::size_t num_pending_readbacks = 0;
 };
 
 } // namespace OpenGL
@@ -155,6 +155,7 @@ void Driver::CheckExtensionSupport() {
     arb_direct_state_access = GLAD_GL_ARB_direct_state_access;
     ext_texture_compression_s3tc = GLAD_GL_EXT_texture_compression_s3tc;
     arb_texture_compression_bptc = GLAD_GL_ARB_texture_compression_bptc;
+    compute_shaders = is_gles ? GLAD_GL_ES_VERSION_3_1 : GLAD_GL_VERSION_4_3;
 }
 
 void Driver::FindBugs() {
@@ -83,6 +83,11 @@ public:
         return arb_direct_state_access;
     }
 
+    /// Returns true if the context supports compute shaders and storage buffers
+    bool HasComputeShaders() const {
+        return compute_shaders;
+    }
+
 private:
     void ReportDriverInfo();
     void DeduceVendor();
@@ -98,6 +103,7 @@ private:
     bool arb_buffer_storage{};
     bool ext_clip_cull_distance{};
     bool arb_direct_state_access{};
+    bool compute_shaders{};
     bool ext_texture_compression_s3tc{};
     bool arb_texture_compression_bptc{};
 
@@ -0,0 +1,74 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/renderer_opengl/gl_driver.h"
+#include "video_core/renderer_opengl/gl_gpu_timer.h"
+
+namespace OpenGL {
+
+GPUTimer::GPUTimer(const Driver& driver)
+    // Timestamp queries are an extension on GLES
+    : supported{!driver.IsOpenGLES()} {}
+
+GPUTimer::~GPUTimer() = default;
+
+void GPUTimer::Begin(Granularity scope_granularity) {
+    if (scope_granularity != granularity || scope_open) {
+        return;
+    }
+
+    Frame& frame = frames[frame_index];
+    if (frame.num_used + 2 > frame.queries.size()) {
+        frame.queries.resize(frame.num_used + 2);
+        frame.queries[frame.num_used].Create();
+        frame.queries[frame.num_used + 1].Create();
+    }
+    glQueryCounter(frame.queries[frame.num_used].handle, GL_TIMESTAMP);
+    scope_open = true;
+}
+
+void GPUTimer::End(Granularity scope_granularity) {
+    if (scope_granularity != granularity || !scope_open) {
+        return;
+    }
+
+    Frame& frame = frames[frame_index];
+    glQueryCounter(frame.queries[frame.num_used + 1].handle, GL_TIMESTAMP);
+    frame.num_used += 2;
+    scope_open = false;
+}
+
+std::optional<std::chrono::nanoseconds> GPUTimer::EndFrame() {
+    // Scopes may not cross frames
+    End(granularity);
+    frame_index = (frame_index + 1) % frames.size();
+
+    // The next frame is the oldest one, its queries are usually complete by now. If they aren't,
+    // the frame is left out of the measurements.
+    std::optional<std::chrono::nanoseconds> result;
+    Frame& frame = frames[frame_index];
+    if (frame.num_used != 0) {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(frame.queries[frame.num_used - 1].handle, GL_QUERY_RESULT_AVAILABLE,
+                            &available);
+        if (available) {
+            GLuint64 total = 0;
+            for (std::size_t i = 0; i < frame.num_used; i += 2) {
+                GLuint64 begin = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(frame.queries[i].handle, GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(frame.queries[i + 1].handle, GL_QUERY_RESULT, &end);
+                total += end - begin;
+            }
+            result = std::chrono::nanoseconds{total};
+        }
+        frame.num_used = 0;
+    }
+
+    granularity = supported ? Settings::values.gpu_timing.GetValue() : Granularity::Off;
+    Begin(Granularity::Frame);
+    return result;
+}
+
+} // namespace OpenGL
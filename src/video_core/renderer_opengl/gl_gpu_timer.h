@@ -0,0 +1,72 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <vector>
+#include "common/settings.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+class Driver;
+
+/**
+ * Measures the GPU time of frames, render passes or draws with timestamp queries. The queries of
+ * a frame are read back a few frames later, so measuring never stalls the pipeline.
+ */
+class GPUTimer {
+    using Granularity = Settings::GpuTimingOption;
+
+public:
+    explicit GPUTimer(const Driver& driver);
+    ~GPUTimer();
+
+    /// Starts a timed scope, if timing is enabled at the given granularity
+    void Begin(Granularity granularity);
+
+    /// Ends the scope started with the same granularity
+    void End(Granularity granularity);
+
+    /**
+     * Ends the current frame and starts the next one.
+     * @returns the summed time of the scopes of the oldest pending frame, once it is available
+     */
+    std::optional<std::chrono::nanoseconds> EndFrame();
+
+    /// Times a scope of the given granularity for its lifetime
+    class Scope {
+    public:
+        Scope(GPUTimer& timer_, Granularity granularity_)
+            : timer{timer_}, granularity{granularity_} {
+            timer.Begin(granularity);
+        }
+        ~Scope() {
+            timer.End(granularity);
+        }
+
+    private:
+        GPUTimer& timer;
+        Granularity granularity;
+    };
+
+private:
+    struct Frame {
+        /// Pairs of begin and end timestamps
+        std::vector<OGLQuery> queries;
+        std::size_t num_used{};
+    };
+
+    /// Frames whose results may not be ready yet, like the dynamic resolution queries
+    std::array<Frame, 3> frames;
+    std::size_t frame_index{};
+    Granularity granularity{Granularity::Off};
+    bool scope_open{};
+    bool supported;
+};
+
+} // namespace OpenGL
@@ -28,10 +28,25 @@ MICROPROFILE_DEFINE(OpenGL_Drawing, "OpenGL", "Drawing", MP_RGB(128, 128, 192));
 using VideoCore::SurfaceType;
 
 constexpr std::size_t VERTEX_BUFFER_SIZE = 16 * 1024 * 1024;
+constexpr std::size_t VERTEX_CACHE_SIZE = 32 * 1024 * 1024;
 constexpr std::size_t INDEX_BUFFER_SIZE = 1 * 1024 * 1024;
 constexpr std::size_t UNIFORM_BUFFER_SIZE = 2 * 1024 * 1024;
 constexpr std::size_t TEXTURE_BUFFER_SIZE = 1 * 1024 * 1024;
 
+// Layout of the LUT buffer, the RGBA LUTs are placed last to keep them 16 byte aligned
+constexpr std::size_t LIGHTING_LUT_OFFSET = 0;
+constexpr std::size_t FOG_LUT_OFFSET =
+    LIGHTING_LUT_OFFSET + sizeof(Common::Vec2f) * 256 * Pica::LightingRegs::NumLightingSampler;
+constexpr std::size_t PROCTEX_NOISE_LUT_OFFSET = FOG_LUT_OFFSET + sizeof(Common::Vec2f) * 128;
+constexpr std::size_t PROCTEX_COLOR_MAP_OFFSET =
+    PROCTEX_NOISE_LUT_OFFSET + sizeof(Common::Vec2f) * 128;
+constexpr std::size_t PROCTEX_ALPHA_MAP_OFFSET =
+    PROCTEX_COLOR_MAP_OFFSET + sizeof(Common::Vec2f) * 128;
+constexpr std::size_t PROCTEX_LUT_OFFSET = PROCTEX_ALPHA_MAP_OFFSET + sizeof(Common::Vec2f) * 128;
+constexpr std::size_t PROCTEX_DIFF_LUT_OFFSET = PROCTEX_LUT_OFFSET + sizeof(Common::Vec4f) * 256;
+constexpr std::size_t LUT_BUFFER_SIZE = PROCTEX_DIFF_LUT_OFFSET + sizeof(Common::Vec4f) * 256;
+static_assert(PROCTEX_LUT_OFFSET % sizeof(Common::Vec4f) == 0);
+
 } // Anonymous namespace
 
 RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory,
@@ -45,7 +60,7 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory,
                                                                          UNIFORM_BUFFER_SIZE},
       index_buffer{GL_ELEMENT_ARRAY_BUFFER, INDEX_BUFFER_SIZE}, texture_buffer{GL_TEXTURE_BUFFER,
                                                                                TEXTURE_BUFFER_SIZE},
-      texture_lf_buffer{GL_TEXTURE_BUFFER, TEXTURE_BUFFER_SIZE} {
+      vertex_cache{VERTEX_CACHE_SIZE}, gpu_timer{driver} {
 
     // Clipping plane 0 is always enabled for PICA fixed clip plane z <= 0
     state.clip_distance[0] = true;
@@ -57,6 +72,8 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory,
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_buffer_alignment);
     uniform_size_aligned_vs =
         Common::AlignUp<std::size_t>(sizeof(Pica::Shader::VSUniformData), uniform_buffer_alignment);
+    uniform_size_aligned_gs =
+        Common::AlignUp<std::size_t>(sizeof(Pica::Shader::GSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs =
         Common::AlignUp<std::size_t>(sizeof(Pica::Shader::UniformData), uniform_buffer_alignment);
 
@@ -98,6 +115,31 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory,
     // Create render framebuffer
     framebuffer.Create();
 
+    // Allocate the LUT buffer, it mirrors the host LUT data so it starts zeroed out like it
+    const std::vector<u8> lut_zero(LUT_BUFFER_SIZE);
+    lut_buffer.Create();
+    glBindBuffer(GL_TEXTURE_BUFFER, lut_buffer.handle);
+    glBufferData(GL_TEXTURE_BUFFER, LUT_BUFFER_SIZE, lut_zero.data(), GL_DYNAMIC_DRAW);
+
+    // The LUTs never move within the buffer
+    for (u32 index = 0; index < Pica::LightingRegs::NumLightingSampler; index++) {
+        uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
+            static_cast<GLint>((LIGHTING_LUT_OFFSET + index * sizeof(lighting_lut_data[0])) /
+                               sizeof(Common::Vec2f));
+    }
+    uniform_block_data.data.fog_lut_offset =
+        static_cast<GLint>(FOG_LUT_OFFSET / sizeof(Common::Vec2f));
+    uniform_block_data.data.proctex_noise_lut_offset =
+        static_cast<GLint>(PROCTEX_NOISE_LUT_OFFSET / sizeof(Common::Vec2f));
+    uniform_block_data.data.proctex_color_map_offset =
+        static_cast<GLint>(PROCTEX_COLOR_MAP_OFFSET / sizeof(Common::Vec2f));
+    uniform_block_data.data.proctex_alpha_map_offset =
+        static_cast<GLint>(PROCTEX_ALPHA_MAP_OFFSET / sizeof(Common::Vec2f));
+    uniform_block_data.data.proctex_lut_offset =
+        static_cast<GLint>(PROCTEX_LUT_OFFSET / sizeof(Common::Vec4f));
+    uniform_block_data.data.proctex_diff_lut_offset =
+        static_cast<GLint>(PROCTEX_DIFF_LUT_OFFSET / sizeof(Common::Vec4f));
+
     // Allocate and bind texture buffer lut textures
     texture_buffer_lut_lf.Create();
     texture_buffer_lut_rg.Create();
@@ -107,11 +149,11 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory,
     state.texture_buffer_lut_rgba.texture_buffer = texture_buffer_lut_rgba.handle;
     state.Apply();
     glActiveTexture(TextureUnits::TextureBufferLUT_LF.Enum());
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, texture_lf_buffer.Handle());
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, lut_buffer.handle);
     glActiveTexture(TextureUnits::TextureBufferLUT_RG.Enum());
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, texture_buffer.Handle());
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, lut_buffer.handle);
     glActiveTexture(TextureUnits::TextureBufferLUT_RGBA.Enum());
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, texture_buffer.Handle());
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, lut_buffer.handle);
 
     // Bind index buffer for hardware shader path
     state.draw.vertex_array = hw_vao.handle;
@@ -125,10 +167,16 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory,
     RasterizerOpenGL::SyncEntireState();
 }
 
-RasterizerOpenGL::~RasterizerOpenGL() = default;
+RasterizerOpenGL::~RasterizerOpenGL() {
+    LOG_DEBUG(Render_OpenGL, "Submitted {} accelerated draws, {} PICA draws were merged into them",
+              draw_stats.submitted, draw_stats.merged);
+    LOG_DEBUG(Render_OpenGL, "Served {} vertex ranges from the vertex cache, uploaded {} bytes",
+              vertex_cache.NumHits(), vertex_cache.UploadedBytes());
+}
 
 void RasterizerOpenGL::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
+    FlushMergedDraw();
     shader_program_manager.LoadDiskCache(stop_loading, callback);
 }
 
@@ -154,21 +202,25 @@ static constexpr std::array<GLenum, 4> vs_attrib_types{
 };
 
 void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
-                                        GLuint vs_input_index_min, GLuint vs_input_index_max) {
+                                        GLuint vs_input_index_min, GLuint vs_input_index_max,
+                                        u32 vertex_capacity, const CachedOffsets* cached_offsets) {
     MICROPROFILE_SCOPE(OpenGL_VAO);
     const auto& vertex_attributes = regs.pipeline.vertex_attributes;
     PAddr base_address = vertex_attributes.GetPhysicalBaseAddress();
 
     state.draw.vertex_array = hw_vao.handle;
-    state.draw.vertex_buffer = vertex_buffer.Handle();
+    state.draw.vertex_buffer = cached_offsets ? vertex_cache.Handle() : vertex_buffer.Handle();
     state.Apply();
 
     std::array<bool, 16> enable_attributes{};
 
-    for (const auto& loader : vertex_attributes.attribute_loaders) {
+    for (std::size_t loader_index = 0; loader_index < CachedOffsets{}.size(); ++loader_index) {
+        const auto& loader = vertex_attributes.attribute_loaders[loader_index];
         if (loader.component_count == 0 || loader.byte_count == 0) {
             continue;
         }
+        const GLintptr loader_offset =
+            cached_offsets ? (*cached_offsets)[loader_index] : buffer_offset;
 
         u32 offset = 0;
         for (u32 comp = 0; comp < loader.component_count && comp < 12; ++comp) {
@@ -184,7 +236,7 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
                         vertex_attributes.GetFormat(attribute_index))];
                     GLsizei stride = loader.byte_count;
                     glVertexAttribPointer(input_reg, size, type, GL_FALSE, stride,
-                                          reinterpret_cast<GLvoid*>(buffer_offset + offset));
+                                          reinterpret_cast<GLvoid*>(loader_offset + offset));
                     enable_attributes[input_reg] = true;
 
                     offset += vertex_attributes.GetStride(attribute_index);
@@ -197,6 +249,10 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
             }
         }
 
+        if (cached_offsets) {
+            continue;
+        }
+
         PAddr data_addr =
             base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
 
@@ -206,8 +262,8 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
         res_cache.FlushRegion(data_addr, data_size);
         std::memcpy(array_ptr, memory.GetPhysicalPointer(data_addr), data_size);
 
-        array_ptr += data_size;
-        buffer_offset += data_size;
+        array_ptr += loader.byte_count * vertex_capacity;
+        buffer_offset += loader.byte_count * vertex_capacity;
     }
 
     for (std::size_t i = 0; i < enable_attributes.size(); ++i) {
@@ -233,18 +289,34 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
 
 bool RasterizerOpenGL::SetupVertexShader() {
     MICROPROFILE_SCOPE(OpenGL_VS);
-    return shader_program_manager.UseProgrammableVertexShader(regs, Pica::g_state.vs);
+    if (!IsVertexShaderDirty()) {
+        return true;
+    }
+    if (!shader_program_manager.UseProgrammableVertexShader(regs, Pica::g_state.vs)) {
+        return false;
+    }
+    ClearDirty(VideoCore::DirtyRegs::VertexShader);
+    return true;
 }
 
 bool RasterizerOpenGL::SetupGeometryShader() {
     MICROPROFILE_SCOPE(OpenGL_GS);
-
-    if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        LOG_ERROR(Render_OpenGL, "Accelerate draw doesn't support geometry shader");
-        return false;
+    if (!IsDirty(VideoCore::DirtyRegs::GeometryShader)) {
+        return true;
     }
 
-    shader_program_manager.UseFixedGeometryShader(regs);
+    if (regs.pipeline.use_gs == Pica::PipelineRegs::UseGS::No) {
+        shader_program_manager.UseFixedGeometryShader(regs);
+    } else {
+        // Only the point mode feeds a fixed number of vertices to each GS invocation
+        if (regs.pipeline.variable_primitive != 0 || regs.gs.input_to_uniform != 0) {
+            return false;
+        }
+        if (!shader_program_manager.UseProgrammableGeometryShader(regs, Pica::g_state.gs)) {
+            return false;
+        }
+    }
+    ClearDirty(VideoCore::DirtyRegs::GeometryShader);
     return true;
 }
 
@@ -258,6 +330,13 @@ bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
         }
     }
 
+    if (merged_draw.num_draws != 0) {
+        if (MergeDraw(is_indexed)) {
+            return true;
+        }
+        FlushMergedDraw();
+    }
+
     if (!SetupVertexShader())
         return false;
 
@@ -283,9 +362,69 @@ static GLenum MakePrimitiveMode(Pica::PipelineRegs::TriangleTopology topology) {
     return GL_TRIANGLES;
 }
 
-bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
-    const GLenum primitive_mode = MakePrimitiveMode(regs.pipeline.triangle_topology);
-    auto [vs_input_index_min, vs_input_index_max, vs_input_size] = AnalyzeVertexArray(is_indexed);
+/// Returns the primitive that passes the vertices of one GS invocation in the point mode
+static GLenum MakeGSPrimitiveMode(const Pica::Regs& regs) {
+    const u32 num_inputs = regs.gs.max_input_attribute_index + 1;
+    switch (num_inputs / (regs.pipeline.vs_outmap_total_minus_1_a + 1)) {
+    case 1:
+        return GL_POINTS;
+    case 2:
+        return GL_LINES;
+    case 3:
+        return GL_TRIANGLES;
+    case 4:
+        return GL_LINES_ADJACENCY;
+    case 6:
+        return GL_TRIANGLES_ADJACENCY;
+    default:
+        UNREACHABLE();
+    }
+
+    return GL_POINTS;
+}
+
+std::optional<RasterizerOpenGL::CachedOffsets> RasterizerOpenGL::FindCachedVertexArray(
+    GLuint vs_input_index_min, GLuint vs_input_index_max) {
+    const auto& vertex_attributes = regs.pipeline.vertex_attributes;
+    const PAddr base_address = vertex_attributes.GetPhysicalBaseAddress();
+    const u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
+
+    CachedOffsets cached_offsets{};
+    bool all_cached = true;
+    const u64 generation = vertex_cache.Generation();
+    for (std::size_t loader_index = 0; loader_index < cached_offsets.size(); ++loader_index) {
+        const auto& loader = vertex_attributes.attribute_loaders[loader_index];
+        if (loader.component_count == 0 || loader.byte_count == 0) {
+            continue;
+        }
+        const PAddr data_addr =
+            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
+        const u32 data_size = loader.byte_count * vertex_num;
+        res_cache.FlushRegion(data_addr, data_size);
+
+        // Keep looking up the other loaders, so they are remembered for the next draw
+        const auto offset =
+            vertex_cache.Find(data_addr, {memory.GetPhysicalPointer(data_addr), data_size});
+        if (offset) {
+            cached_offsets[loader_index] = *offset;
+        } else {
+            all_cached = false;
+        }
+    }
+
+    // The offsets of the loaders looked up before the cache was cleared are gone
+    if (vertex_cache.Generation() != generation) {
+        return std::nullopt;
+    }
+    return all_cached ? std::make_optional(cached_offsets) : std::nullopt;
+}
+
+bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed, bool mergeable) {
+    const bool use_gs = regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No;
+    const GLenum primitive_mode =
+        use_gs ? MakeGSPrimitiveMode(regs) : MakePrimitiveMode(regs.pipeline.triangle_topology);
+    const VertexArrayInfo info = AnalyzeVertexArray(is_indexed);
+    auto [vs_input_index_min, vs_input_index_max, vs_input_size] = info;
 
     if (vs_input_size > VERTEX_BUFFER_SIZE) {
         LOG_WARNING(Render_OpenGL, "Too large vertex input size {}", vs_input_size);
@@ -295,15 +434,45 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
     state.draw.vertex_buffer = vertex_buffer.Handle();
     state.Apply();
 
+    // Static geometry is drawn straight from the vertex cache
+    const auto cached_offsets = FindCachedVertexArray(vs_input_index_min, vs_input_index_max);
+
+    // Triangle lists are kept pending, so the following draws with the same state can be
+    // appended to them
+    const u32 merged_capacity = !cached_offsets && mergeable && !use_gs &&
+                                        primitive_mode == GL_TRIANGLES
+                                    ? GetMergedVertexCapacity(is_indexed, info)
+                                    : 0;
+    if (merged_capacity != 0) {
+        const u32 merged_size = GetMergedVertexSize(merged_capacity);
+        const auto [buffer_ptr, buffer_offset, _] = vertex_buffer.Map(merged_size, 4);
+        SetupVertexArray(buffer_ptr, static_cast<GLintptr>(buffer_offset), vs_input_index_min,
+                         vs_input_index_max, merged_capacity);
+        BeginMergedDraw(buffer_ptr, merged_capacity, is_indexed, info);
+
+        shader_program_manager.ApplyTo(state);
+        state.Apply();
+        return true;
+    }
+
     u8* buffer_ptr;
     GLintptr buffer_offset;
-    std::tie(buffer_ptr, buffer_offset, std::ignore) = vertex_buffer.Map(vs_input_size, 4);
-    SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max);
-    vertex_buffer.Unmap(vs_input_size);
+    const u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
+    if (cached_offsets) {
+        SetupVertexArray(nullptr, 0, vs_input_index_min, vs_input_index_max, vertex_num,
+                         &*cached_offsets);
+    } else {
+        std::tie(buffer_ptr, buffer_offset, std::ignore) = vertex_buffer.Map(vs_input_size, 4);
+        SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max,
+                         vertex_num);
+        vertex_buffer.Unmap(vs_input_size);
+    }
 
     shader_program_manager.ApplyTo(state);
     state.Apply();
+    draw_stats.submitted++;
 
+    GPUTimer::Scope draw_scope{gpu_timer, Settings::GpuTimingOption::Draw};
     if (is_indexed) {
         bool index_u16 = regs.pipeline.index_array.format != 0;
         std::size_t index_buffer_size = regs.pipeline.num_vertices * (index_u16 ? 2 : 1);
@@ -330,6 +499,33 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
     return true;
 }
 
+void RasterizerOpenGL::FlushMergedDraw() {
+    if (merged_draw.num_draws == 0) {
+        return;
+    }
+    merged_draw.num_draws = 0;
+    draw_stats.submitted++;
+
+    // Restore the bindings of the run, the rasterizer cache may have changed them
+    state.Apply();
+    vertex_buffer.Unmap(merged_draw.GetVertexSize());
+
+    GPUTimer::Scope draw_scope{gpu_timer, Settings::GpuTimingOption::Draw};
+    if (!merged_draw.is_indexed) {
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(merged_draw.num_vertices));
+        return;
+    }
+
+    const std::size_t index_buffer_size = merged_draw.indices.size() * sizeof(u16);
+    const auto [buffer_ptr, buffer_offset, _] = index_buffer.Map(index_buffer_size, 4);
+    std::memcpy(buffer_ptr, merged_draw.indices.data(), index_buffer_size);
+    index_buffer.Unmap(index_buffer_size);
+
+    glDrawRangeElements(GL_TRIANGLES, 0, merged_draw.num_vertices - 1,
+                        static_cast<GLsizei>(merged_draw.indices.size()), GL_UNSIGNED_SHORT,
+                        reinterpret_cast<const void*>(buffer_offset));
+}
+
 void RasterizerOpenGL::DrawTriangles() {
     if (vertex_batch.empty())
         return;
@@ -338,6 +534,13 @@ void RasterizerOpenGL::DrawTriangles() {
 
 bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     MICROPROFILE_SCOPE(OpenGL_Drawing);
+    FlushMergedDraw();
+
+    // Skip the draw until its fragment shader is built
+    if (!shader_program_manager.IsFragmentShaderReady()) {
+        vertex_batch.clear();
+        return true;
+    }
 
     const bool shadow_rendering = regs.framebuffer.IsShadowRendering();
     const bool has_stencil = regs.framebuffer.HasStencil();
@@ -370,6 +573,11 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     if (shadow_rendering) {
         state.image_shadow_buffer = framebuffer.Attachment(SurfaceType::Color);
     }
+    // A change of render targets starts a new pass
+    if (state.draw.draw_framebuffer != framebuffer.Handle()) {
+        gpu_timer.End(Settings::GpuTimingOption::Renderpass);
+        gpu_timer.Begin(Settings::GpuTimingOption::Renderpass);
+    }
     state.draw.draw_framebuffer = framebuffer.Handle();
     state.Apply();
 
@@ -401,6 +609,7 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     }
 
     // Sync and bind the texture surfaces
+    has_feedback_loop = false;
     SyncTextureUnits(framebuffer);
 
     // Sync and bind the shader
@@ -411,7 +620,6 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
 
     // Sync the LUTs within the texture buffer
     SyncAndUploadLUTs();
-    SyncAndUploadLUTsLF();
 
     // Sync the uniform data
     UploadUniforms(accelerate);
@@ -429,12 +637,17 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     // Draw the vertex batch
     bool succeeded = true;
     if (accelerate) {
-        succeeded = AccelerateDrawBatchInternal(is_indexed);
+        // Draws that rely on barriers or on a copy of the framebuffer are issued right away
+        const bool mergeable = !shadow_rendering && !has_feedback_loop;
+        succeeded = AccelerateDrawBatchInternal(is_indexed, mergeable);
     } else {
         state.draw.vertex_array = sw_vao.handle;
         state.draw.vertex_buffer = vertex_buffer.Handle();
         shader_program_manager.UseTrivialVertexShader();
         shader_program_manager.UseTrivialGeometryShader();
+        // The next accelerated draw has to bind its shaders again
+        MarkDirty(VideoCore::DirtyRegs::VertexShader);
+        MarkDirty(VideoCore::DirtyRegs::GeometryShader);
         shader_program_manager.ApplyTo(state);
         state.Apply();
 
@@ -448,6 +661,7 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
             std::memcpy(vbo, vertex_batch.data() + base_vertex, vertex_size);
             vertex_buffer.Unmap(vertex_size);
 
+            GPUTimer::Scope draw_scope{gpu_timer, Settings::GpuTimingOption::Draw};
             glDrawArrays(GL_TRIANGLES, static_cast<GLint>(offset / sizeof(HardwareVertex)),
                          static_cast<GLsizei>(vertices));
         }
@@ -559,6 +773,7 @@ bool RasterizerOpenGL::IsFeedbackLoop(u32 texture_index, const Framebuffer& fram
     }
 
     // Make a temporary copy of the framebuffer to sample from
+    has_feedback_loop = true;
     Surface temp_surface{runtime, framebuffer.ColorParams()};
     const VideoCore::TextureCopy copy = {
         .src_level = 0,
@@ -642,41 +857,74 @@ void RasterizerOpenGL::NotifyFixedFunctionPicaRegisterChanged(u32 id) {
 }
 
 void RasterizerOpenGL::FlushAll() {
+    FlushMergedDraw();
     res_cache.FlushAll();
 }
 
 void RasterizerOpenGL::FlushRegion(PAddr addr, u32 size) {
+    if (OverlapsMergedTargets(addr, size)) {
+        FlushMergedDraw();
+    }
     res_cache.FlushRegion(addr, size);
 }
 
 void RasterizerOpenGL::InvalidateRegion(PAddr addr, u32 size) {
+    FlushMergedDraw();
     res_cache.InvalidateRegion(addr, size);
 }
 
 void RasterizerOpenGL::FlushAndInvalidateRegion(PAddr addr, u32 size) {
+    FlushMergedDraw();
     res_cache.FlushRegion(addr, size);
     res_cache.InvalidateRegion(addr, size);
 }
 
 void RasterizerOpenGL::ClearAll(bool flush) {
+    FlushMergedDraw();
     res_cache.ClearAll(flush);
 }
 
+void RasterizerOpenGL::SuspendCaches(bool flush) {
+    FlushMergedDraw();
+    res_cache.Suspend(flush);
+}
+
+void RasterizerOpenGL::ResumeCaches() {
+    res_cache.Resume();
+}
+
+void RasterizerOpenGL::TickFrame() {
+    FlushMergedDraw();
+    res_cache.TickFrame();
+}
+
+VideoCore::RasterizerCacheStats RasterizerOpenGL::GetLastFrameCacheStats() const {
+    return res_cache.GetLastFrameStats();
+}
+
+VideoCore::RasterizerCacheStats RasterizerOpenGL::GetTotalCacheStats() const {
+    return res_cache.GetTotalStats();
+}
+
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
+    FlushMergedDraw();
     return res_cache.AccelerateDisplayTransfer(config);
 }
 
 bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) {
+    FlushMergedDraw();
     return res_cache.AccelerateTextureCopy(config);
 }
 
 bool RasterizerOpenGL::AccelerateFill(const GPU::Regs::MemoryFillConfig& config) {
+    FlushMergedDraw();
     return res_cache.AccelerateFill(config);
 }
 
 bool RasterizerOpenGL::AccelerateDisplay(const GPU::Regs::FramebufferConfig& config,
                                          PAddr framebuffer_addr, u32 pixel_stride,
                                          ScreenInfo& screen_info) {
+    FlushMergedDraw();
     if (framebuffer_addr == 0) {
         return false;
     }
@@ -851,176 +1099,63 @@ void RasterizerOpenGL::SyncDepthTest() {
             : GL_ALWAYS;
 }
 
-void RasterizerOpenGL::SyncAndUploadLUTsLF() {
-    constexpr std::size_t max_size =
-        sizeof(Common::Vec2f) * 256 * Pica::LightingRegs::NumLightingSampler +
-        sizeof(Common::Vec2f) * 128; // fog
-
-    if (!uniform_block_data.lighting_lut_dirty_any && !uniform_block_data.fog_lut_dirty) {
-        return;
-    }
-
-    glBindBuffer(GL_TEXTURE_BUFFER, texture_lf_buffer.Handle());
-
-    std::size_t bytes_used = 0;
-    const auto [buffer, offset, invalidate] =
-        texture_lf_buffer.Map(max_size, sizeof(Common::Vec4f));
-
-    // Sync the lighting luts
-    if (uniform_block_data.lighting_lut_dirty_any || invalidate) {
-        for (unsigned index = 0; index < uniform_block_data.lighting_lut_dirty.size(); index++) {
-            if (uniform_block_data.lighting_lut_dirty[index] || invalidate) {
-                std::array<Common::Vec2f, 256> new_data;
-                const auto& source_lut = Pica::g_state.lighting.luts[index];
-                std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
-                               [](const auto& entry) {
-                                   return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                               });
-
-                if (new_data != lighting_lut_data[index] || invalidate) {
-                    lighting_lut_data[index] = new_data;
-                    std::memcpy(buffer + bytes_used, new_data.data(),
-                                new_data.size() * sizeof(Common::Vec2f));
-                    uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
-                        static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec2f));
-                    uniform_block_data.dirty = true;
-                    bytes_used += new_data.size() * sizeof(Common::Vec2f);
-                }
-                uniform_block_data.lighting_lut_dirty[index] = false;
-            }
-        }
-        uniform_block_data.lighting_lut_dirty_any = false;
-    }
-
-    // Sync the fog lut
-    if (uniform_block_data.fog_lut_dirty || invalidate) {
-        std::array<Common::Vec2f, 128> new_data;
-
-        std::transform(Pica::g_state.fog.lut.begin(), Pica::g_state.fog.lut.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != fog_lut_data || invalidate) {
-            fog_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec2f));
-            uniform_block_data.data.fog_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec2f);
-        }
-        uniform_block_data.fog_lut_dirty = false;
-    }
-
-    texture_lf_buffer.Unmap(bytes_used);
-}
-
 void RasterizerOpenGL::SyncAndUploadLUTs() {
-    const auto& proctex = Pica::g_state.proctex;
-    constexpr std::size_t max_size =
-        sizeof(Common::Vec2f) * 128 * 3 + // proctex: noise + color + alpha
-        sizeof(Common::Vec4f) * 256 +     // proctex
-        sizeof(Common::Vec4f) * 256;      // proctex diff
-
-    if (!uniform_block_data.proctex_noise_lut_dirty &&
-        !uniform_block_data.proctex_color_map_dirty &&
-        !uniform_block_data.proctex_alpha_map_dirty && !uniform_block_data.proctex_lut_dirty &&
-        !uniform_block_data.proctex_diff_lut_dirty) {
+    if (!SyncLUTData()) {
         return;
     }
 
+    struct LUTCopy {
+        GLintptr src_offset;
+        GLintptr dst_offset;
+        GLsizeiptr size;
+    };
+    std::array<LUTCopy, Pica::LightingRegs::NumLightingSampler + 6> copies;
+    std::size_t num_copies = 0;
+
     glBindBuffer(GL_TEXTURE_BUFFER, texture_buffer.Handle());
 
     std::size_t bytes_used = 0;
-    const auto [buffer, offset, invalidate] = texture_buffer.Map(max_size, sizeof(Common::Vec4f));
-
-    // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
-    auto SyncProcTexValueLUT =
-        [this, buffer = buffer, offset = offset, invalidate = invalidate,
-         &bytes_used](const std::array<Pica::State::ProcTex::ValueEntry, 128>& lut,
-                      std::array<Common::Vec2f, 128>& lut_data, GLint& lut_offset) {
-            std::array<Common::Vec2f, 128> new_data;
-            std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
-                return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-            });
-
-            if (new_data != lut_data || invalidate) {
-                lut_data = new_data;
-                std::memcpy(buffer + bytes_used, new_data.data(),
-                            new_data.size() * sizeof(Common::Vec2f));
-                lut_offset = static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec2f));
-                uniform_block_data.dirty = true;
-                bytes_used += new_data.size() * sizeof(Common::Vec2f);
-            }
-        };
-
-    // Sync the proctex noise lut
-    if (uniform_block_data.proctex_noise_lut_dirty || invalidate) {
-        SyncProcTexValueLUT(proctex.noise_table, proctex_noise_lut_data,
-                            uniform_block_data.data.proctex_noise_lut_offset);
-        uniform_block_data.proctex_noise_lut_dirty = false;
-    }
-
-    // Sync the proctex color map
-    if (uniform_block_data.proctex_color_map_dirty || invalidate) {
-        SyncProcTexValueLUT(proctex.color_map_table, proctex_color_map_data,
-                            uniform_block_data.data.proctex_color_map_offset);
-        uniform_block_data.proctex_color_map_dirty = false;
-    }
-
-    // Sync the proctex alpha map
-    if (uniform_block_data.proctex_alpha_map_dirty || invalidate) {
-        SyncProcTexValueLUT(proctex.alpha_map_table, proctex_alpha_map_data,
-                            uniform_block_data.data.proctex_alpha_map_offset);
-        uniform_block_data.proctex_alpha_map_dirty = false;
-    }
+    const auto [buffer, offset, invalidate] =
+        texture_buffer.Map(LUT_BUFFER_SIZE, sizeof(Common::Vec4f));
 
-    // Sync the proctex lut
-    if (uniform_block_data.proctex_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_table.begin(), proctex.color_table.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_lut_data || invalidate) {
-            proctex_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            uniform_block_data.data.proctex_lut_offset =
-                static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec4f));
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
+    // Stage the changed entries of each LUT, they are copied to the LUT buffer after unmapping
+    const auto stage_range = [&](LUTRange& range, const auto& lut_data, std::size_t lut_offset) {
+        if (range.Empty()) {
+            return;
         }
-        uniform_block_data.proctex_lut_dirty = false;
-    }
+        constexpr std::size_t entry_size = sizeof(lut_data[0]);
+        const std::size_t size = (range.end - range.begin) * entry_size;
+        std::memcpy(buffer + bytes_used, &lut_data[range.begin], size);
+        copies[num_copies++] = {static_cast<GLintptr>(offset + bytes_used),
+                                static_cast<GLintptr>(lut_offset + range.begin * entry_size),
+                                static_cast<GLsizeiptr>(size)};
+        bytes_used += size;
+        range.Clear();
+    };
 
-    // Sync the proctex difference lut
-    if (uniform_block_data.proctex_diff_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_diff_table.begin(), proctex.color_diff_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_diff_lut_data || invalidate) {
-            proctex_diff_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            uniform_block_data.data.proctex_diff_lut_offset =
-                static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec4f));
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
-        }
-        uniform_block_data.proctex_diff_lut_dirty = false;
+    for (std::size_t index = 0; index < lighting_lut_data.size(); index++) {
+        stage_range(uniform_block_data.lighting_lut_dirty[index], lighting_lut_data[index],
+                    LIGHTING_LUT_OFFSET + index * sizeof(lighting_lut_data[0]));
     }
+    stage_range(uniform_block_data.fog_lut_dirty, fog_lut_data, FOG_LUT_OFFSET);
+    stage_range(uniform_block_data.proctex_noise_lut_dirty, proctex_noise_lut_data,
+                PROCTEX_NOISE_LUT_OFFSET);
+    stage_range(uniform_block_data.proctex_color_map_dirty, proctex_color_map_data,
+                PROCTEX_COLOR_MAP_OFFSET);
+    stage_range(uniform_block_data.proctex_alpha_map_dirty, proctex_alpha_map_data,
+                PROCTEX_ALPHA_MAP_OFFSET);
+    stage_range(uniform_block_data.proctex_lut_dirty, proctex_lut_data, PROCTEX_LUT_OFFSET);
+    stage_range(uniform_block_data.proctex_diff_lut_dirty, proctex_diff_lut_data,
+                PROCTEX_DIFF_LUT_OFFSET);
 
     texture_buffer.Unmap(bytes_used);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, texture_buffer.Handle());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, lut_buffer.handle);
+    for (std::size_t i = 0; i < num_copies; i++) {
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, copies[i].src_offset,
+                            copies[i].dst_offset, copies[i].size);
+    }
 }
 
 void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
@@ -1029,25 +1164,44 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
     state.draw.uniform_buffer = uniform_buffer.Handle();
     state.Apply();
 
-    bool sync_vs = accelerate_draw;
+    const bool use_gs = regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No;
+    bool sync_vs = accelerate_draw && IsDirty(VideoCore::DirtyRegs::VSUniforms);
+    bool sync_gs = accelerate_draw && use_gs && IsDirty(VideoCore::DirtyRegs::GSUniforms);
     bool sync_fs = uniform_block_data.dirty;
 
-    if (!sync_vs && !sync_fs) {
+    if (!sync_vs && !sync_gs && !sync_fs) {
         return;
     }
 
-    std::size_t uniform_size = uniform_size_aligned_vs + uniform_size_aligned_fs;
+    std::size_t uniform_size =
+        uniform_size_aligned_vs + uniform_size_aligned_gs + uniform_size_aligned_fs;
     std::size_t used_bytes = 0;
     const auto [uniforms, offset, invalidate] =
         uniform_buffer.Map(uniform_size, uniform_buffer_alignment);
+    if (invalidate) {
+        // The VS and GS uniforms bound by an earlier draw may have been overwritten
+        MarkDirty(VideoCore::DirtyRegs::VSUniforms);
+        MarkDirty(VideoCore::DirtyRegs::GSUniforms);
+    }
 
-    if (sync_vs) {
+    if (accelerate_draw && IsDirty(VideoCore::DirtyRegs::VSUniforms)) {
         Pica::Shader::VSUniformData vs_uniforms;
         vs_uniforms.uniforms.SetFromRegs(regs.vs, Pica::g_state.vs);
         std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
         glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(Pica::Shader::UniformBindings::VS),
                           uniform_buffer.Handle(), offset + used_bytes, sizeof(vs_uniforms));
         used_bytes += uniform_size_aligned_vs;
+        ClearDirty(VideoCore::DirtyRegs::VSUniforms);
+    }
+
+    if (accelerate_draw && use_gs && IsDirty(VideoCore::DirtyRegs::GSUniforms)) {
+        Pica::Shader::GSUniformData gs_uniforms;
+        gs_uniforms.uniforms.SetFromRegs(regs.gs, Pica::g_state.gs);
+        std::memcpy(uniforms + used_bytes, &gs_uniforms, sizeof(gs_uniforms));
+        glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(Pica::Shader::UniformBindings::GS),
+                          uniform_buffer.Handle(), offset + used_bytes, sizeof(gs_uniforms));
+        used_bytes += uniform_size_aligned_gs;
+        ClearDirty(VideoCore::DirtyRegs::GSUniforms);
     }
 
     if (sync_fs || invalidate) {
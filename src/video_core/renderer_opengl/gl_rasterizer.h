@@ -6,10 +6,12 @@
 
 #include "core/hw/gpu.h"
 #include "video_core/rasterizer_accelerated.h"
+#include "video_core/renderer_opengl/gl_gpu_timer.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/gl_stream_buffer.h"
 #include "video_core/renderer_opengl/gl_texture_runtime.h"
+#include "video_core/renderer_opengl/gl_vertex_cache.h"
 
 namespace Frontend {
 class EmuWindow;
@@ -42,6 +44,11 @@ public:
     void InvalidateRegion(PAddr addr, u32 size) override;
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
     void ClearAll(bool flush) override;
+    void SuspendCaches(bool flush) override;
+    void ResumeCaches() override;
+    void TickFrame() override;
+    VideoCore::RasterizerCacheStats GetLastFrameCacheStats() const override;
+    VideoCore::RasterizerCacheStats GetTotalCacheStats() const override;
     bool AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) override;
     bool AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) override;
     bool AccelerateFill(const GPU::Regs::MemoryFillConfig& config) override;
@@ -51,6 +58,11 @@ public:
 
     void SyncFixedState() override;
 
+    /// Returns the timer measuring the GPU time of the rasterizer's work
+    [[nodiscard]] GPUTimer& GetGPUTimer() noexcept {
+        return gpu_timer;
+    }
+
 private:
     void NotifyFixedFunctionPicaRegisterChanged(u32 id) override;
 
@@ -90,9 +102,8 @@ private:
     /// Syncs the depth test states to match the PICA register
     void SyncDepthTest();
 
-    /// Syncs and uploads the lighting, fog and proctex LUTs
+    /// Uploads the changed entries of the lighting, fog and proctex LUTs
     void SyncAndUploadLUTs();
-    void SyncAndUploadLUTsLF();
 
     /// Syncs all enabled PICA texture units
     void SyncTextureUnits(const Framebuffer& framebuffer);
@@ -113,11 +124,23 @@ private:
     bool Draw(bool accelerate, bool is_indexed);
 
     /// Internal implementation for AccelerateDrawBatch
-    bool AccelerateDrawBatchInternal(bool is_indexed);
+    bool AccelerateDrawBatchInternal(bool is_indexed, bool mergeable);
+
+    /// Issues the pending run of merged draws
+    void FlushMergedDraw() override;
+
+    /// Offsets of the attribute loader data in the vertex cache
+    using CachedOffsets = std::array<GLintptr, 12>;
+
+    /// Returns the vertex cache offsets of the current draw if all of its vertex data is cached
+    std::optional<CachedOffsets> FindCachedVertexArray(GLuint vs_input_index_min,
+                                                       GLuint vs_input_index_max);
 
-    /// Setup vertex array for AccelerateDrawBatch
+    /// Setup vertex array for AccelerateDrawBatch, each attribute loader gets the space of
+    /// vertex_capacity vertices. With cached_offsets the data is read from the vertex cache.
     void SetupVertexArray(u8* array_ptr, GLintptr buffer_offset, GLuint vs_input_index_min,
-                          GLuint vs_input_index_max);
+                          GLuint vs_input_index_max, u32 vertex_capacity,
+                          const CachedOffsets* cached_offsets = nullptr);
 
     /// Setup vertex shader for AccelerateDrawBatch
     bool SetupVertexShader();
@@ -135,17 +158,21 @@ private:
     OGLVertexArray sw_vao; // VAO for software shader draw
     OGLVertexArray hw_vao; // VAO for hardware shader / accelerate draw
     std::array<bool, 16> hw_vao_enabled_attributes{};
+    bool has_feedback_loop = false; ///< The current draw samples a copy of its framebuffer
 
     StreamBuffer vertex_buffer;
     StreamBuffer uniform_buffer;
     StreamBuffer index_buffer;
-    StreamBuffer texture_buffer;
-    StreamBuffer texture_lf_buffer;
+    StreamBuffer texture_buffer; ///< Staging buffer of changed LUT entries
+    VertexCache vertex_cache;
+    GPUTimer gpu_timer;
     OGLFramebuffer framebuffer;
     GLint uniform_buffer_alignment;
     std::size_t uniform_size_aligned_vs;
+    std::size_t uniform_size_aligned_gs;
     std::size_t uniform_size_aligned_fs;
 
+    OGLBuffer lut_buffer;
     OGLTexture texture_buffer_lut_lf;
     OGLTexture texture_buffer_lut_rg;
     OGLTexture texture_buffer_lut_rgba;
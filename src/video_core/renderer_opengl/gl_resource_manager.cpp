@@ -163,6 +163,23 @@ void OGLBuffer::Release() {
     handle = 0;
 }
 
+void OGLQuery::Create() {
+    if (handle != 0)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceCreation);
+    glGenQueries(1, &handle);
+}
+
+void OGLQuery::Release() {
+    if (handle == 0)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceDeletion);
+    glDeleteQueries(1, &handle);
+    handle = 0;
+}
+
 void OGLSync::Create() {
     if (handle != 0)
         return;
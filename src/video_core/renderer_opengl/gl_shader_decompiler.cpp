@@ -4,6 +4,7 @@
 
 #include <exception>
 #include <map>
+#include <optional>
 #include <set>
 #include <string>
 #include <tuple>
@@ -13,6 +14,7 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "video_core/renderer_opengl/gl_shader_decompiler.h"
+#include "video_core/shader/shader_mul_analysis.h"
 
 namespace OpenGL::ShaderDecompiler {
 
@@ -22,38 +24,11 @@ using nihstro::RegisterType;
 using nihstro::SourceRegister;
 using nihstro::SwizzlePattern;
 
-constexpr u32 PROGRAM_END = Pica::Shader::MAX_PROGRAM_CODE_LENGTH;
-
 class DecompileFail : public std::runtime_error {
 public:
     using std::runtime_error::runtime_error;
 };
 
-/// Describes the behaviour of code path of a given entry point and a return point.
-enum class ExitMethod {
-    Undetermined, ///< Internal value. Only occur when analyzing JMP loop.
-    AlwaysReturn, ///< All code paths reach the return point.
-    Conditional,  ///< Code path reaches the return point or an END instruction conditionally.
-    AlwaysEnd,    ///< All code paths reach a END instruction.
-};
-
-/// A subroutine is a range of code refereced by a CALL, IF or LOOP instruction.
-struct Subroutine {
-    /// Generates a name suitable for GLSL source code.
-    std::string GetName() const {
-        return "sub_" + std::to_string(begin) + "_" + std::to_string(end);
-    }
-
-    u32 begin;              ///< Entry point of the subroutine.
-    u32 end;                ///< Return point of the subroutine.
-    ExitMethod exit_method; ///< Exit method of the subroutine.
-    std::set<u32> labels;   ///< Addresses refereced by JMP instructions.
-
-    bool operator<(const Subroutine& rhs) const {
-        return std::tie(begin, end) < std::tie(rhs.begin, rhs.end);
-    }
-};
-
 /// Analyzes shader code and produces a set of subroutines.
 class ControlFlowAnalyzer {
 public:
@@ -268,10 +243,15 @@ public:
                   const Pica::Shader::ProgramCode& program_code,
                   const Pica::Shader::SwizzleData& swizzle_data, u32 main_offset,
                   const RegGetter& inputreg_getter, const RegGetter& outputreg_getter,
-                  bool sanitize_mul)
+                  bool sanitize_mul, bool is_gs,
+                  Pica::Shader::BoolUniformSpecialization bool_uniforms)
         : subroutines(subroutines), program_code(program_code), swizzle_data(swizzle_data),
           main_offset(main_offset), inputreg_getter(inputreg_getter),
-          outputreg_getter(outputreg_getter), sanitize_mul(sanitize_mul) {
+          outputreg_getter(outputreg_getter), sanitize_mul(sanitize_mul), is_gs(is_gs),
+          bool_uniforms(bool_uniforms) {
+        if (sanitize_mul) {
+            mul_analysis.emplace(program_code, swizzle_data);
+        }
 
         Generate();
     }
@@ -280,6 +260,14 @@ public:
         return shader.MoveResult();
     }
 
+    u32 GetNumMultiplications() const {
+        return num_multiplications;
+    }
+
+    u32 GetNumSanitizedMultiplications() const {
+        return num_sanitized_multiplications;
+    }
+
 private:
     /// Gets the Subroutine object corresponding to the specified address.
     const Subroutine& GetSubroutine(u32 begin, u32 end) const {
@@ -360,8 +348,22 @@ private:
         }
     }
 
+    /// Returns whether the multiplication of an instruction has to emulate PICA 0 * inf = 0
+    bool SanitizeMul(u32 offset) {
+        ++num_multiplications;
+        if (!sanitize_mul || !mul_analysis->NeedsSanitize(offset)) {
+            return false;
+        }
+        ++num_sanitized_multiplications;
+        return true;
+    }
+
     /// Generates code representing a bool uniform
     std::string GetUniformBool(u32 index) const {
+        // Specialized bools become constants so the driver can drop the branches on them
+        if ((bool_uniforms.mask >> index) & 1) {
+            return ((bool_uniforms.values >> index) & 1) ? "true" : "false";
+        }
         return fmt::format("uniforms.b[{}]", index);
     }
 
@@ -462,7 +464,7 @@ private:
             }
 
             case OpCode::Id::MUL: {
-                if (sanitize_mul) {
+                if (SanitizeMul(offset)) {
                     SetDest(swizzle, dest_reg, fmt::format("sanitize_mul({}, {})", src1, src2), 4,
                             4);
                 } else {
@@ -492,14 +494,15 @@ private:
             case OpCode::Id::DPHI: {
                 OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
                 std::string dot;
+                const bool sanitize_dot = SanitizeMul(offset);
                 if (opcode == OpCode::Id::DP3) {
-                    if (sanitize_mul) {
+                    if (sanitize_dot) {
                         dot = fmt::format("dot(vec3(sanitize_mul({}, {})), vec3(1.0))", src1, src2);
                     } else {
                         dot = fmt::format("dot(vec3({}), vec3({}))", src1, src2);
                     }
                 } else {
-                    if (sanitize_mul) {
+                    if (sanitize_dot) {
                         const std::string src1_ =
                             (opcode == OpCode::Id::DPH || opcode == OpCode::Id::DPHI)
                                 ? fmt::format("vec4({}.xyz, 1.0)", src1)
@@ -636,7 +639,7 @@ private:
                         ? "reg_tmp" + std::to_string(instr.mad.dest.Value().GetIndex())
                         : "";
 
-                if (sanitize_mul) {
+                if (SanitizeMul(offset)) {
                     SetDest(swizzle, dest_reg,
                             fmt::format("sanitize_mul({}, {}) + {}", src1, src2, src3), 4, 4);
                 } else {
@@ -783,10 +786,27 @@ private:
                 break;
             }
 
-            case OpCode::Id::EMIT:
-            case OpCode::Id::SETEMIT:
-                LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+            case OpCode::Id::EMIT: {
+                if (!is_gs) {
+                    LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                    break;
+                }
+                shader.AddLine("emit();");
                 break;
+            }
+
+            case OpCode::Id::SETEMIT: {
+                if (!is_gs) {
+                    LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                    break;
+                }
+                if (instr.setemit.vertex_id >= 3) {
+                    throw DecompileFail("Invalid emit vertex id");
+                }
+                shader.AddLine("setemit({}u, {}, {});", instr.setemit.vertex_id.Value(),
+                               instr.setemit.prim_emit != 0, instr.setemit.winding != 0);
+                break;
+            }
 
             default: {
                 LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
@@ -918,6 +938,11 @@ private:
     const RegGetter& inputreg_getter;
     const RegGetter& outputreg_getter;
     const bool sanitize_mul;
+    const bool is_gs;
+    const Pica::Shader::BoolUniformSpecialization bool_uniforms;
+    std::optional<Pica::Shader::AccurateMulAnalysis> mul_analysis;
+    u32 num_multiplications = 0;
+    u32 num_sanitized_multiplications = 0;
 
     ShaderWriter shader;
 };
@@ -935,16 +960,32 @@ bool exec_shader();
 )";
 }
 
-std::optional<ProgramResult> DecompileProgram(const Pica::Shader::ProgramCode& program_code,
-                                              const Pica::Shader::SwizzleData& swizzle_data,
-                                              u32 main_offset, const RegGetter& inputreg_getter,
-                                              const RegGetter& outputreg_getter,
-                                              bool sanitize_mul) {
+std::optional<std::set<Subroutine>> AnalyzeControlFlow(
+    const Pica::Shader::ProgramCode& program_code, u32 main_offset) {
+    try {
+        return ControlFlowAnalyzer(program_code, main_offset).MoveSubroutines();
+    } catch (const DecompileFail& exception) {
+        LOG_INFO(HW_GPU, "Shader control flow analysis failed: {}", exception.what());
+        return std::nullopt;
+    }
+}
+
+std::optional<ProgramResult> DecompileProgram(
+    const Pica::Shader::ProgramCode& program_code, const Pica::Shader::SwizzleData& swizzle_data,
+    u32 main_offset, const RegGetter& inputreg_getter, const RegGetter& outputreg_getter,
+    bool sanitize_mul, bool is_gs, Pica::Shader::BoolUniformSpecialization bool_uniforms) {
 
     try {
         auto subroutines = ControlFlowAnalyzer(program_code, main_offset).MoveSubroutines();
         GLSLGenerator generator(subroutines, program_code, swizzle_data, main_offset,
-                                inputreg_getter, outputreg_getter, sanitize_mul);
+                                inputreg_getter, outputreg_getter, sanitize_mul, is_gs,
+                                bool_uniforms);
+        if (sanitize_mul) {
+            LOG_DEBUG(HW_GPU, "Accurate multiplication skipped for {} of {} multiplications",
+                      generator.GetNumMultiplications() -
+                          generator.GetNumSanitizedMultiplications(),
+                      generator.GetNumMultiplications());
+        }
         return {ProgramResult{generator.MoveShaderCode()}};
     } catch (const DecompileFail& exception) {
         LOG_INFO(HW_GPU, "Shader decompilation failed: {}", exception.what());
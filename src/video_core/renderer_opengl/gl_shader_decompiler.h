@@ -7,9 +7,12 @@
 #include <array>
 #include <functional>
 #include <optional>
+#include <set>
 #include <string>
+#include <tuple>
 #include "common/common_types.h"
 #include "video_core/shader/shader.h"
+#include "video_core/shader/shader_specialization.h"
 
 namespace OpenGL::ShaderDecompiler {
 
@@ -19,11 +22,42 @@ struct ProgramResult {
     std::string code;
 };
 
+constexpr u32 PROGRAM_END = Pica::Shader::MAX_PROGRAM_CODE_LENGTH;
+
+/// Describes the behaviour of code path of a given entry point and a return point.
+enum class ExitMethod {
+    Undetermined, ///< Internal value. Only occur when analyzing JMP loop.
+    AlwaysReturn, ///< All code paths reach the return point.
+    Conditional,  ///< Code path reaches the return point or an END instruction conditionally.
+    AlwaysEnd,    ///< All code paths reach a END instruction.
+};
+
+/// A subroutine is a range of code refereced by a CALL, IF or LOOP instruction.
+struct Subroutine {
+    /// Generates a name suitable for GLSL source code.
+    std::string GetName() const {
+        return "sub_" + std::to_string(begin) + "_" + std::to_string(end);
+    }
+
+    u32 begin;              ///< Entry point of the subroutine.
+    u32 end;                ///< Return point of the subroutine.
+    ExitMethod exit_method; ///< Exit method of the subroutine.
+    std::set<u32> labels;   ///< Addresses refereced by JMP instructions.
+
+    bool operator<(const Subroutine& rhs) const {
+        return std::tie(begin, end) < std::tie(rhs.begin, rhs.end);
+    }
+};
+
+/// Finds the subroutines of the program, returns std::nullopt if it can't be decompiled.
+std::optional<std::set<Subroutine>> AnalyzeControlFlow(
+    const Pica::Shader::ProgramCode& program_code, u32 main_offset);
+
 std::string GetCommonDeclarations();
 
-std::optional<ProgramResult> DecompileProgram(const Pica::Shader::ProgramCode& program_code,
-                                              const Pica::Shader::SwizzleData& swizzle_data,
-                                              u32 main_offset, const RegGetter& inputreg_getter,
-                                              const RegGetter& outputreg_getter, bool sanitize_mul);
+std::optional<ProgramResult> DecompileProgram(
+    const Pica::Shader::ProgramCode& program_code, const Pica::Shader::SwizzleData& swizzle_data,
+    u32 main_offset, const RegGetter& inputreg_getter, const RegGetter& outputreg_getter,
+    bool sanitize_mul, bool is_gs, Pica::Shader::BoolUniformSpecialization bool_uniforms);
 
 } // namespace OpenGL::ShaderDecompiler
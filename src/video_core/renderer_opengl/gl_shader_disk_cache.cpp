@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
+#include <span>
+#include <thread>
 #include <fmt/format.h>
 
 #include "common/assert.h"
@@ -12,6 +14,7 @@
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
+#include "common/thread_worker.h"
 #include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/hle/kernel/process.h"
@@ -33,6 +36,151 @@ enum class PrecompiledEntryKind : u32 {
 
 constexpr u32 NativeVersion = 1;
 
+/// Identifies the chunked layout of the compressed precompiled file
+constexpr u32 PrecompiledContainerMagic = 0x43505343; // "CSPC"
+
+/// Uncompressed size after which a new chunk is started. Chunks are decoded in parallel.
+constexpr std::size_t PrecompiledChunkSize = 1024 * 1024;
+
+/// Index entry of a chunk, the chunks are stored back to back after the index
+struct PrecompiledChunkInfo {
+    u32 compressed_size;
+    u32 decompressed_size;
+};
+
+/// Reads entries from a decompressed region of the precompiled cache
+class PrecompiledReader {
+public:
+    explicit PrecompiledReader(std::span<const u8> data) : data{data} {}
+
+    template <typename T>
+    bool ReadArray(T* object, std::size_t length) {
+        const std::size_t size = length * sizeof(T);
+        if (data.size() - offset < size) {
+            return false;
+        }
+        std::memcpy(object, data.data() + offset, size);
+        offset += size;
+        return true;
+    }
+
+    template <typename T>
+    bool ReadObject(T& object) {
+        return ReadArray(&object, 1);
+    }
+
+    std::size_t Tell() const {
+        return offset;
+    }
+
+    std::size_t Remaining() const {
+        return data.size() - offset;
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t offset = 0;
+};
+
+/// Entries parsed from a region of the precompiled cache
+struct PrecompiledEntries {
+    ShaderDecompiledMap decompiled;
+    ShaderDumpsMap dumps;
+    std::vector<std::size_t> entry_offsets; ///< Start of each entry, relative to the region
+};
+
+static std::optional<ShaderDiskCacheDecompiled> ReadDecompiledEntry(PrecompiledReader& reader) {
+    bool sanitize_mul;
+    if (!reader.ReadObject(sanitize_mul)) {
+        return std::nullopt;
+    }
+
+    u32 code_size{};
+    if (!reader.ReadObject(code_size)) {
+        return std::nullopt;
+    }
+
+    std::string code(code_size, '\0');
+    if (!reader.ReadArray(code.data(), code.size())) {
+        return std::nullopt;
+    }
+
+    ShaderDiskCacheDecompiled entry;
+    entry.result.code = std::move(code);
+    entry.sanitize_mul = sanitize_mul;
+
+    return entry;
+}
+
+/// Entries are only ever appended, so a later entry of a program replaces the earlier ones
+static std::optional<PrecompiledEntries> ReadPrecompiledEntries(std::span<const u8> data) {
+    PrecompiledReader reader{data};
+    PrecompiledEntries entries;
+    while (reader.Remaining() > 0) {
+        entries.entry_offsets.push_back(reader.Tell());
+
+        PrecompiledEntryKind kind{};
+        if (!reader.ReadObject(kind)) {
+            return std::nullopt;
+        }
+
+        switch (kind) {
+        case PrecompiledEntryKind::Decompiled: {
+            u64 unique_identifier{};
+            if (!reader.ReadObject(unique_identifier)) {
+                return std::nullopt;
+            }
+
+            auto entry = ReadDecompiledEntry(reader);
+            if (!entry) {
+                return std::nullopt;
+            }
+            entries.decompiled.insert_or_assign(unique_identifier, std::move(*entry));
+            break;
+        }
+        case PrecompiledEntryKind::Dump: {
+            u64 unique_identifier;
+            if (!reader.ReadObject(unique_identifier)) {
+                return std::nullopt;
+            }
+
+            ShaderDiskCacheDump dump;
+            if (!reader.ReadObject(dump.binary_format)) {
+                return std::nullopt;
+            }
+
+            u32 binary_length{};
+            if (!reader.ReadObject(binary_length)) {
+                return std::nullopt;
+            }
+
+            dump.binary.resize(binary_length);
+            if (!reader.ReadArray(dump.binary.data(), dump.binary.size())) {
+                return std::nullopt;
+            }
+
+            entries.dumps.insert_or_assign(unique_identifier, std::move(dump));
+            break;
+        }
+        default:
+            return std::nullopt;
+        }
+    }
+    return entries;
+}
+
+/// Returns the number of threads worth spawning for the chunks
+static std::size_t NumLoaderThreads(std::size_t num_chunks) {
+    const std::size_t num_cores =
+        Common::GetWorkerThreadCount(std::max(1U, std::thread::hardware_concurrency()));
+    return std::clamp<std::size_t>(num_chunks, 1, num_cores);
+}
+
+/// Whether the cache files are left untouched, new shaders are then only kept for the session
+static bool IsReadOnly() {
+    return Settings::values.shader_cache_read_only.GetValue();
+}
+
 // The hash is based on relevant files. The list of files can be found at src/common/CMakeLists.txt
 // and CMakeModules/GenerateSCMRev.cmake
 ShaderCacheVersionHash GetShaderCacheVersionHash() {
@@ -197,21 +345,15 @@ ShaderDiskCache::LoadPrecompiled(bool compressed) {
 
 std::optional<std::pair<std::unordered_map<u64, ShaderDiskCacheDecompiled>, ShaderDumpsMap>>
 ShaderDiskCache::LoadPrecompiledFile(FileUtil::IOFile& file, bool compressed) {
-    // Read compressed file from disk and decompress to virtual precompiled cache file
     std::vector<u8> precompiled_file(file.GetSize());
     file.ReadBytes(precompiled_file.data(), precompiled_file.size());
     if (compressed) {
-        const std::vector<u8> decompressed =
-            Common::Compression::DecompressDataZSTD(precompiled_file);
-        SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
-    } else {
-        SaveArrayToPrecompiled(precompiled_file.data(), precompiled_file.size());
+        return LoadPrecompiledContainer(precompiled_file);
     }
 
-    decompressed_precompiled_cache_offset = 0;
-
     ShaderCacheVersionHash file_hash{};
-    if (!LoadArrayFromPrecompiled(file_hash.data(), file_hash.size())) {
+    PrecompiledReader reader{precompiled_file};
+    if (!reader.ReadArray(file_hash.data(), file_hash.size())) {
         return std::nullopt;
     }
     if (GetShaderCacheVersionHash() != file_hash) {
@@ -219,85 +361,101 @@ ShaderDiskCache::LoadPrecompiledFile(FileUtil::IOFile& file, bool compressed) {
         return std::nullopt;
     }
 
-    std::unordered_map<u64, ShaderDiskCacheDecompiled> decompiled;
-    ShaderDumpsMap dumps;
-    while (decompressed_precompiled_cache_offset < decompressed_precompiled_cache.size()) {
-        PrecompiledEntryKind kind{};
-        if (!LoadObjectFromPrecompiled(kind)) {
-            return std::nullopt;
-        }
-
-        switch (kind) {
-        case PrecompiledEntryKind::Decompiled: {
-            u64 unique_identifier{};
-            if (!LoadObjectFromPrecompiled(unique_identifier)) {
-                return std::nullopt;
-            }
-
-            auto entry = LoadDecompiledEntry();
-            if (!entry) {
-                return std::nullopt;
-            }
-            decompiled.insert({unique_identifier, std::move(*entry)});
-            break;
-        }
-        case PrecompiledEntryKind::Dump: {
-            u64 unique_identifier;
-            if (!LoadObjectFromPrecompiled(unique_identifier)) {
-                return std::nullopt;
-            }
-
-            ShaderDiskCacheDump dump;
-            if (!LoadObjectFromPrecompiled(dump.binary_format)) {
-                return std::nullopt;
-            }
-
-            u32 binary_length{};
-            if (!LoadObjectFromPrecompiled(binary_length)) {
-                return std::nullopt;
-            }
-
-            dump.binary.resize(binary_length);
-            if (!LoadArrayFromPrecompiled(dump.binary.data(), dump.binary.size())) {
-                return std::nullopt;
-            }
-
-            dumps.insert({unique_identifier, dump});
-            break;
-        }
-        default:
-            return std::nullopt;
-        }
+    auto entries = ReadPrecompiledEntries(std::span{precompiled_file}.subspan(file_hash.size()));
+    if (!entries) {
+        return std::nullopt;
     }
+    for (const std::size_t offset : entries->entry_offsets) {
+        precompiled_entry_offsets.push_back(decompressed_precompiled_cache.size() +
+                                            file_hash.size() + offset);
+    }
+    SaveArrayToPrecompiled(precompiled_file.data(), precompiled_file.size());
 
     LOG_INFO(Render_OpenGL,
              "Found a precompiled disk cache with {} decompiled entries and {} binary entries",
-             decompiled.size(), dumps.size());
-    return {{decompiled, dumps}};
+             entries->decompiled.size(), entries->dumps.size());
+    return {{std::move(entries->decompiled), std::move(entries->dumps)}};
 }
 
-std::optional<ShaderDiskCacheDecompiled> ShaderDiskCache::LoadDecompiledEntry() {
-
-    bool sanitize_mul;
-    if (!LoadObjectFromPrecompiled(sanitize_mul)) {
+std::optional<std::pair<ShaderDecompiledMap, ShaderDumpsMap>>
+ShaderDiskCache::LoadPrecompiledContainer(std::span<const u8> file_data) {
+    PrecompiledReader reader{file_data};
+    u32 magic{};
+    ShaderCacheVersionHash file_hash{};
+    if (!reader.ReadObject(magic) || magic != PrecompiledContainerMagic ||
+        !reader.ReadArray(file_hash.data(), file_hash.size())) {
+        LOG_INFO(Render_OpenGL, "Precompiled cache has an unknown layout");
         return std::nullopt;
     }
-
-    u32 code_size{};
-    if (!LoadObjectFromPrecompiled(code_size)) {
+    if (GetShaderCacheVersionHash() != file_hash) {
+        LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
         return std::nullopt;
     }
 
-    std::string code(code_size, '\0');
-    if (!LoadArrayFromPrecompiled(code.data(), code.size())) {
+    u32 num_chunks{};
+    if (!reader.ReadObject(num_chunks) ||
+        reader.Remaining() / sizeof(PrecompiledChunkInfo) < num_chunks) {
+        return std::nullopt;
+    }
+    std::vector<PrecompiledChunkInfo> index(num_chunks);
+    if (!reader.ReadArray(index.data(), index.size())) {
         return std::nullopt;
     }
 
-    ShaderDiskCacheDecompiled entry;
-    entry.result.code = std::move(code);
-    entry.sanitize_mul = sanitize_mul;
+    std::vector<std::span<const u8>> compressed_chunks;
+    std::size_t chunk_offset = reader.Tell();
+    for (const PrecompiledChunkInfo& info : index) {
+        if (file_data.size() - chunk_offset < info.compressed_size) {
+            return std::nullopt;
+        }
+        compressed_chunks.push_back(file_data.subspan(chunk_offset, info.compressed_size));
+        chunk_offset += info.compressed_size;
+    }
+
+    // Decompress and parse the chunks on all cores, the entries are merged in file order
+    std::vector<std::vector<u8>> chunks(num_chunks);
+    std::vector<std::optional<PrecompiledEntries>> parsed(num_chunks);
+    {
+        Common::ThreadWorker workers(NumLoaderThreads(num_chunks), "GLShaderCacheLoader");
+        for (std::size_t i = 0; i < num_chunks; ++i) {
+            workers.QueueWork([&, i] {
+                chunks[i].resize(index[i].decompressed_size);
+                if (Common::Compression::DecompressDataZSTD(compressed_chunks[i].data(),
+                                                            compressed_chunks[i].size(),
+                                                            chunks[i].data(), chunks[i].size())) {
+                    parsed[i] = ReadPrecompiledEntries(chunks[i]);
+                }
+            });
+        }
+        workers.WaitForRequests();
+    }
 
-    return entry;
+    if (decompressed_precompiled_cache.empty()) {
+        SavePrecompiledHeaderToVirtualPrecompiledCache();
+    }
+    for (std::size_t i = 0; i < num_chunks; ++i) {
+        if (!parsed[i]) {
+            return std::nullopt;
+        }
+        for (const std::size_t offset : parsed[i]->entry_offsets) {
+            precompiled_entry_offsets.push_back(decompressed_precompiled_cache.size() + offset);
+        }
+        SaveArrayToPrecompiled(chunks[i].data(), chunks[i].size());
+    }
+
+    // Merging keeps the existing entries, start from the newest chunk
+    ShaderDecompiledMap decompiled;
+    ShaderDumpsMap dumps;
+    for (auto it = parsed.rbegin(); it != parsed.rend(); ++it) {
+        decompiled.merge((*it)->decompiled);
+        dumps.merge((*it)->dumps);
+    }
+
+    LOG_INFO(Render_OpenGL,
+             "Found a precompiled disk cache with {} decompiled entries and {} binary entries "
+             "in {} chunks",
+             decompiled.size(), dumps.size(), num_chunks);
+    return {{std::move(decompiled), std::move(dumps)}};
 }
 
 void ShaderDiskCache::SaveDecompiledToFile(FileUtil::IOFile& file, u64 unique_identifier,
@@ -319,6 +477,7 @@ void ShaderDiskCache::SaveDecompiledToFile(FileUtil::IOFile& file, u64 unique_id
 bool ShaderDiskCache::SaveDecompiledToCache(u64 unique_identifier,
                                             const ShaderDecompiler::ProgramResult& result,
                                             bool sanitize_mul) {
+    precompiled_entry_offsets.push_back(decompressed_precompiled_cache.size());
     if (!SaveObjectToPrecompiled(static_cast<u32>(PrecompiledEntryKind::Decompiled)) ||
         !SaveObjectToPrecompiled(unique_identifier) || !SaveObjectToPrecompiled(sanitize_mul) ||
         !SaveObjectToPrecompiled(static_cast<u32>(result.code.size())) ||
@@ -330,12 +489,14 @@ bool ShaderDiskCache::SaveDecompiledToCache(u64 unique_identifier,
 }
 
 void ShaderDiskCache::InvalidateAll() {
-    transferable_file.Close();
-    if (!FileUtil::Delete(GetTransferablePath())) {
-        LOG_ERROR(Render_OpenGL, "Failed to invalidate transferable file={}",
-                  GetTransferablePath());
+    if (!IsReadOnly()) {
+        transferable_file.Close();
+        if (!FileUtil::Delete(GetTransferablePath())) {
+            LOG_ERROR(Render_OpenGL, "Failed to invalidate transferable file={}",
+                      GetTransferablePath());
+        }
+        transferable_file = AppendTransferableFile();
     }
-    transferable_file = AppendTransferableFile();
 
     InvalidatePrecompiled();
 }
@@ -343,6 +504,10 @@ void ShaderDiskCache::InvalidateAll() {
 void ShaderDiskCache::InvalidatePrecompiled() {
     // Clear virtual precompiled cache file
     decompressed_precompiled_cache.resize(0);
+    precompiled_entry_offsets.clear();
+    if (IsReadOnly()) {
+        return;
+    }
 
     precompiled_file.Close();
     if (!FileUtil::Delete(GetPrecompiledPath())) {
@@ -361,8 +526,8 @@ void ShaderDiskCache::SaveRaw(const ShaderDiskCacheRaw& entry) {
         return;
     }
 
-    if (transferable_file.WriteObject(TransferableEntryKind::Raw) != 1 ||
-        !entry.Save(transferable_file)) {
+    if (!IsReadOnly() && (transferable_file.WriteObject(TransferableEntryKind::Raw) != 1 ||
+                          !entry.Save(transferable_file))) {
         LOG_ERROR(Render_OpenGL, "Failed to save raw transferable cache entry - removing");
         InvalidateAll();
         return;
@@ -398,6 +563,7 @@ void ShaderDiskCache::SaveDump(u64 unique_identifier, GLuint program) {
     std::vector<u8> binary(binary_length);
     glGetProgramBinary(program, binary_length, nullptr, &binary_format, binary.data());
 
+    precompiled_entry_offsets.push_back(decompressed_precompiled_cache.size());
     if (!SaveObjectToPrecompiled(static_cast<u32>(PrecompiledEntryKind::Dump)) ||
         !SaveObjectToPrecompiled(unique_identifier) ||
         !SaveObjectToPrecompiled(static_cast<u32>(binary_format)) ||
@@ -411,7 +577,7 @@ void ShaderDiskCache::SaveDump(u64 unique_identifier, GLuint program) {
 }
 
 void ShaderDiskCache::SaveDumpToFile(u64 unique_identifier, GLuint program, bool sanitize_mul) {
-    if (!IsUsable())
+    if (!IsUsable() || IsReadOnly())
         return;
 
     GLint binary_length{};
@@ -442,6 +608,9 @@ bool ShaderDiskCache::IsUsable() const {
 }
 
 FileUtil::IOFile ShaderDiskCache::AppendTransferableFile() {
+    if (IsReadOnly()) {
+        return FileUtil::IOFile{GetTransferablePath(), "rb"};
+    }
     if (!EnsureDirectories())
         return {};
 
@@ -465,6 +634,9 @@ FileUtil::IOFile ShaderDiskCache::AppendTransferableFile() {
 }
 
 FileUtil::IOFile ShaderDiskCache::AppendPrecompiledFile(bool write_header) {
+    if (IsReadOnly()) {
+        return FileUtil::IOFile{GetPrecompiledPath(), "rb"};
+    }
     if (!EnsureDirectories())
         return {};
 
@@ -499,9 +671,37 @@ void ShaderDiskCache::SavePrecompiledHeaderToVirtualPrecompiledCache() {
 }
 
 void ShaderDiskCache::SaveVirtualPrecompiledFile() {
+    if (IsReadOnly()) {
+        return;
+    }
     decompressed_precompiled_cache_offset = 0;
-    const std::vector<u8>& compressed = Common::Compression::CompressDataZSTDDefault(
-        decompressed_precompiled_cache.data(), decompressed_precompiled_cache.size());
+
+    // Split the entries after the version hash in chunks that can be decoded independently
+    const std::size_t cache_size = decompressed_precompiled_cache.size();
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    std::size_t chunk_begin = std::min(HASH_LENGTH, cache_size);
+    for (const std::size_t offset : precompiled_entry_offsets) {
+        if (offset - chunk_begin >= PrecompiledChunkSize) {
+            ranges.emplace_back(chunk_begin, offset);
+            chunk_begin = offset;
+        }
+    }
+    if (chunk_begin < cache_size) {
+        ranges.emplace_back(chunk_begin, cache_size);
+    }
+
+    std::vector<std::vector<u8>> chunks(ranges.size());
+    {
+        Common::ThreadWorker workers(NumLoaderThreads(ranges.size()), "GLShaderCacheSaver");
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            workers.QueueWork([&, i] {
+                const auto [begin, end] = ranges[i];
+                chunks[i] = Common::Compression::CompressDataZSTDDefault(
+                    decompressed_precompiled_cache.data() + begin, end - begin);
+            });
+        }
+        workers.WaitForRequests();
+    }
 
     const auto precompiled_path{GetPrecompiledPath()};
 
@@ -511,10 +711,23 @@ void ShaderDiskCache::SaveVirtualPrecompiledFile() {
     }
     precompiled_file = AppendPrecompiledFile(!separable);
 
-    if (precompiled_file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
-        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                  precompiled_path);
-        return;
+    const auto hash{GetShaderCacheVersionHash()};
+    bool written = precompiled_file.WriteObject(PrecompiledContainerMagic) == 1 &&
+                   precompiled_file.WriteArray(hash.data(), hash.size()) == hash.size() &&
+                   precompiled_file.WriteObject(static_cast<u32>(chunks.size())) == 1;
+    for (std::size_t i = 0; i < chunks.size() && written; ++i) {
+        const PrecompiledChunkInfo info{
+            .compressed_size = static_cast<u32>(chunks[i].size()),
+            .decompressed_size = static_cast<u32>(ranges[i].second - ranges[i].first),
+        };
+        written = precompiled_file.WriteObject(info) == 1;
+    }
+    for (std::size_t i = 0; i < chunks.size() && written; ++i) {
+        written = precompiled_file.WriteBytes(chunks[i].data(), chunks[i].size()) ==
+                  chunks[i].size();
+    }
+    if (!written) {
+        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache in path={}", precompiled_path);
     }
 }
 
@@ -8,6 +8,7 @@
 #include <array>
 #include <bitset>
 #include <optional>
+#include <span>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -127,9 +128,9 @@ private:
     std::optional<std::pair<ShaderDecompiledMap, ShaderDumpsMap>> LoadPrecompiledFile(
         FileUtil::IOFile& file, bool compressed);
 
-    /// Loads a decompiled cache entry from m_precompiled_cache_virtual_file. Returns empty on
-    /// failure.
-    std::optional<ShaderDiskCacheDecompiled> LoadDecompiledEntry();
+    /// Decodes the chunks of a compressed precompiled file in parallel. Returns empty on failure.
+    std::optional<std::pair<ShaderDecompiledMap, ShaderDumpsMap>> LoadPrecompiledContainer(
+        std::span<const u8> file_data);
 
     /// Saves a decompiled entry to the passed file. Does not check for collisions.
     void SaveDecompiledToFile(FileUtil::IOFile& file, u64 unique_identifier,
@@ -186,15 +187,6 @@ private:
         return true;
     }
 
-    template <typename T>
-    bool LoadArrayFromPrecompiled(T* data, std::size_t length) {
-        u8* data_view = reinterpret_cast<u8*>(data);
-        std::copy_n(decompressed_precompiled_cache.data() + decompressed_precompiled_cache_offset,
-                    length * sizeof(T), data_view);
-        decompressed_precompiled_cache_offset += length * sizeof(T);
-        return true;
-    }
-
     template <typename T>
     bool SaveObjectToPrecompiled(const T& object) {
         return SaveArrayToPrecompiled(&object, 1);
@@ -205,16 +197,13 @@ private:
         return SaveArrayToPrecompiled(&value, 1);
     }
 
-    template <typename T>
-    bool LoadObjectFromPrecompiled(T& object) {
-        return LoadArrayFromPrecompiled(&object, 1);
-    }
-
     // Stores whole precompiled cache which will be read from or saved to the precompiled cache
     // file
     std::vector<u8> decompressed_precompiled_cache;
     // Stores the current offset of the precompiled cache file for IO purposes
     std::size_t decompressed_precompiled_cache_offset = 0;
+    // Start of each entry in the virtual precompiled cache file, chunks are split on them
+    std::vector<std::size_t> precompiled_entry_offsets;
 
     // Stored transferable shaders
     std::unordered_map<u64, ShaderDiskCacheRaw> transferable;
@@ -212,6 +212,8 @@ void PicaShaderConfigCommon::Init(const Pica::ShaderRegs& regs, Pica::Shader::Sh
     swizzle_hash = setup.GetSwizzleDataHash();
     main_offset = regs.main_offset;
     sanitize_mul = VideoCore::g_hw_shader_accurate_mul;
+    static_bool_mask = 0;
+    static_bool_values = 0;
 
     num_outputs = 0;
     output_map.fill(16);
@@ -244,6 +246,23 @@ void PicaGSConfigCommonRaw::Init(const Pica::Regs& regs) {
     }
 }
 
+void PicaGSConfigRaw::Init(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup) {
+    PicaShaderConfigCommon::Init(regs.gs, setup);
+    PicaGSConfigCommonRaw::Init(regs);
+
+    num_inputs = regs.gs.max_input_attribute_index + 1;
+    input_map.fill(num_inputs);
+
+    for (u32 attr = 0; attr < num_inputs; ++attr) {
+        input_map[regs.gs.GetRegisterForAttribute(attr)] = attr;
+    }
+
+    attributes_per_vertex = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+
+    // The rasterizer semantics map the GS outputs instead of the VS outputs
+    gs_output_attributes = num_outputs;
+}
+
 /// Detects if a TEV stage is configured to be skipped (to avoid generating unnecessary code)
 static bool IsPassThroughTevStage(const TevStageConfig& stage) {
     return (stage.color_op == TevStageConfig::Operation::Replace &&
@@ -1541,6 +1560,288 @@ do {
     return {std::move(out)};
 }
 
+bool IsUberShaderCapable(const PicaFSConfig& config) {
+    const auto& state = config.state;
+    const bool texture0_supported =
+        state.texture0_type == TexturingRegs::TextureConfig::Texture2D ||
+        state.texture0_type == TexturingRegs::TextureConfig::TextureCube ||
+        state.texture0_type == TexturingRegs::TextureConfig::Projection2D ||
+        state.texture0_type == TexturingRegs::TextureConfig::Disabled;
+    return !GLES && texture0_supported && !state.lighting.enable && !state.proctex.enable &&
+           !state.shadow_rendering && state.fog_mode != TexturingRegs::FogMode::Gas;
+}
+
+UberShaderConfig UberShaderConfig::BuildFromConfig(const PicaFSConfig& config) {
+    const auto& state = config.state;
+    UberShaderConfig uber{};
+    for (std::size_t i = 0; i < state.tev_stages.size(); i++) {
+        const auto& stage = state.tev_stages[i];
+        uber.tev_stages[i] = {stage.sources_raw, stage.modifiers_raw, stage.ops_raw,
+                              stage.scales_raw};
+    }
+    uber.fs_config = static_cast<u32>(state.alpha_test_func) |
+                     static_cast<u32>(state.scissor_test_mode) << 3 |
+                     static_cast<u32>(state.texture0_type) << 5 |
+                     static_cast<u32>(state.texture2_use_coord1) << 8 |
+                     static_cast<u32>(state.combiner_buffer_input) << 9 |
+                     static_cast<u32>(state.depthmap_enable) << 17 |
+                     static_cast<u32>(state.fog_mode == TexturingRegs::FogMode::Fog) << 18 |
+                     static_cast<u32>(state.fog_flip) << 19;
+    return uber;
+}
+
+ShaderDecompiler::ProgramResult GenerateUberFragmentShader(bool separable_shader) {
+    std::string out;
+
+    if (separable_shader && !GLES) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+
+    out += GetVertexInterfaceDeclaration(false, separable_shader);
+
+    out += R"(
+#ifndef CITRA_GLES
+in vec4 gl_FragCoord;
+#endif // CITRA_GLES
+
+layout (location = 0) out vec4 color;
+
+uniform sampler2D tex0;
+uniform sampler2D tex1;
+uniform sampler2D tex2;
+uniform samplerCube tex_cube;
+uniform samplerBuffer texture_buffer_lut_lf;
+
+// Raw sources, modifiers, ops and scales of each TEV stage
+uniform uvec4 tev_stages[6];
+// The remaining state of PicaFSConfig, packed by UberShaderConfig::BuildFromConfig
+uniform uint fs_config;
+)";
+
+    out += UniformBlockDef;
+
+    out += R"(
+vec4 rounded_primary_color;
+vec4 tex_color[3];
+vec4 combiner_buffer;
+vec4 last_tex_env_out;
+
+uint Bits(uint value, int offset, int count) {
+    return (value >> uint(offset)) & ((1u << uint(count)) - 1u);
+}
+
+float byteround(float x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec3 byteround(vec3 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec4 byteround(vec4 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+float getLod(vec2 coord) {
+    vec2 d = max(abs(dFdx(coord)), abs(dFdy(coord)));
+    return log2(max(d.x, d.y));
+}
+
+vec4 SampleTexture2D(sampler2D tex, vec2 coord, float lod_bias) {
+    return textureLod(tex, coord, getLod(coord * vec2(textureSize(tex, 0))) + lod_bias);
+}
+
+// Fragment lighting and procedural textures are not supported, so those sources read zero
+vec4 GetSource(uint source, int stage) {
+    switch (source) {
+    case 0u: return rounded_primary_color;
+    case 3u: return tex_color[0];
+    case 4u: return tex_color[1];
+    case 5u: return tex_color[2];
+    case 13u: return combiner_buffer;
+    case 14u: return const_color[stage];
+    case 15u: return last_tex_env_out;
+    default: return vec4(0.0);
+    }
+}
+
+vec3 GetColorModifier(uint modifier, vec4 value) {
+    switch (modifier) {
+    case 0u: return value.rgb;
+    case 1u: return vec3(1.0) - value.rgb;
+    case 2u: return value.aaa;
+    case 3u: return vec3(1.0) - value.aaa;
+    case 4u: return value.rrr;
+    case 5u: return vec3(1.0) - value.rrr;
+    case 8u: return value.ggg;
+    case 9u: return vec3(1.0) - value.ggg;
+    case 12u: return value.bbb;
+    case 13u: return vec3(1.0) - value.bbb;
+    default: return vec3(0.0);
+    }
+}
+
+float GetAlphaModifier(uint modifier, vec4 value) {
+    float result;
+    switch (modifier >> 1u) {
+    case 0u: result = value.a; break;
+    case 1u: result = value.r; break;
+    case 2u: result = value.g; break;
+    default: result = value.b; break;
+    }
+    return (modifier & 1u) != 0u ? 1.0 - result : result;
+}
+
+vec3 CombineColor(uint op, vec3 a, vec3 b, vec3 c) {
+    vec3 result;
+    switch (op) {
+    case 0u: result = a; break;
+    case 1u: result = a * b; break;
+    case 2u: result = a + b; break;
+    case 3u: result = a + b - vec3(0.5); break;
+    case 4u: result = a * c + b * (vec3(1.0) - c); break;
+    case 5u: result = a - b; break;
+    case 6u:
+    case 7u: result = vec3(dot(a - vec3(0.5), b - vec3(0.5)) * 4.0); break;
+    case 8u: result = a * b + c; break;
+    case 9u: result = min(a + b, vec3(1.0)) * c; break;
+    default: result = vec3(0.0); break;
+    }
+    return clamp(result, vec3(0.0), vec3(1.0));
+}
+
+float CombineAlpha(uint op, float a, float b, float c) {
+    float result;
+    switch (op) {
+    case 0u: result = a; break;
+    case 1u: result = a * b; break;
+    case 2u: result = a + b; break;
+    case 3u: result = a + b - 0.5; break;
+    case 4u: result = a * c + b * (1.0 - c); break;
+    case 5u: result = a - b; break;
+    case 8u: result = a * b + c; break;
+    case 9u: result = min(a + b, 1.0) * c; break;
+    default: result = 0.0; break;
+    }
+    return clamp(result, 0.0, 1.0);
+}
+
+float GetMultiplier(uint scale) {
+    return scale < 3u ? float(1u << scale) : 1.0;
+}
+
+void main() {
+    rounded_primary_color = byteround(primary_color);
+
+    uint alpha_test_func = Bits(fs_config, 0, 3);
+    if (alpha_test_func == 0u) {
+        discard;
+    }
+
+    uint scissor_test_mode = Bits(fs_config, 3, 2);
+    if (scissor_test_mode != 0u) {
+        bool inside = gl_FragCoord.x >= float(scissor_x1) && gl_FragCoord.y >= float(scissor_y1) &&
+                      gl_FragCoord.x < float(scissor_x2) && gl_FragCoord.y < float(scissor_y2);
+        // Include mode keeps the pixels inside the scissor box, exclude mode the ones outside
+        if (inside != (scissor_test_mode == 3u)) {
+            discard;
+        }
+    }
+
+    float z_over_w = 2.0 * gl_FragCoord.z - 1.0;
+    float depth = z_over_w * depth_scale + depth_offset;
+    if (Bits(fs_config, 17, 1) == 0u) {
+        depth /= gl_FragCoord.w;
+    }
+
+    switch (Bits(fs_config, 5, 3)) {
+    case 0u: tex_color[0] = SampleTexture2D(tex0, texcoord0, tex_lod_bias[0]); break;
+    case 1u: tex_color[0] = texture(tex_cube, vec3(texcoord0, texcoord0_w)); break;
+    case 3u: tex_color[0] = textureProj(tex0, vec3(texcoord0, texcoord0_w)); break;
+    default: tex_color[0] = vec4(0.0); break;
+    }
+    tex_color[1] = SampleTexture2D(tex1, texcoord1, tex_lod_bias[1]);
+    vec2 texcoord2_source = Bits(fs_config, 8, 1) != 0u ? texcoord1 : texcoord2;
+    tex_color[2] = SampleTexture2D(tex2, texcoord2_source, tex_lod_bias[2]);
+
+    uint combiner_buffer_input = Bits(fs_config, 9, 8);
+    combiner_buffer = vec4(0.0);
+    vec4 next_combiner_buffer = tev_combiner_buffer_color;
+    last_tex_env_out = vec4(0.0);
+    for (int i = 0; i < 6; i++) {
+        uvec4 stage = tev_stages[i];
+        vec3 color_results_1 = GetColorModifier(Bits(stage.y, 0, 4),
+                                                GetSource(Bits(stage.x, 0, 4), i));
+        vec3 color_results_2 = GetColorModifier(Bits(stage.y, 4, 4),
+                                                GetSource(Bits(stage.x, 4, 4), i));
+        vec3 color_results_3 = GetColorModifier(Bits(stage.y, 8, 4),
+                                                GetSource(Bits(stage.x, 8, 4), i));
+        uint color_op = Bits(stage.z, 0, 4);
+        vec3 color_output = byteround(CombineColor(color_op, color_results_1, color_results_2,
+                                                   color_results_3));
+
+        float alpha_output;
+        if (color_op == 7u) {
+            // Dot3_RGBA also places its result to the alpha component
+            alpha_output = color_output[0];
+        } else {
+            float alpha_results_1 = GetAlphaModifier(Bits(stage.y, 12, 3),
+                                                     GetSource(Bits(stage.x, 16, 4), i));
+            float alpha_results_2 = GetAlphaModifier(Bits(stage.y, 16, 3),
+                                                     GetSource(Bits(stage.x, 20, 4), i));
+            float alpha_results_3 = GetAlphaModifier(Bits(stage.y, 20, 3),
+                                                     GetSource(Bits(stage.x, 24, 4), i));
+            alpha_output = byteround(CombineAlpha(Bits(stage.z, 16, 4), alpha_results_1,
+                                                  alpha_results_2, alpha_results_3));
+        }
+
+        last_tex_env_out = vec4(
+            clamp(color_output * GetMultiplier(Bits(stage.w, 0, 2)), vec3(0.0), vec3(1.0)),
+            clamp(alpha_output * GetMultiplier(Bits(stage.w, 16, 2)), 0.0, 1.0));
+
+        combiner_buffer = next_combiner_buffer;
+        if (i < 4) {
+            if (Bits(combiner_buffer_input, i, 1) != 0u) {
+                next_combiner_buffer.rgb = last_tex_env_out.rgb;
+            }
+            if (Bits(combiner_buffer_input, i + 4, 1) != 0u) {
+                next_combiner_buffer.a = last_tex_env_out.a;
+            }
+        }
+    }
+
+    int alpha = int(last_tex_env_out.a * 255.0);
+    bool alpha_test_passed;
+    switch (alpha_test_func) {
+    case 2u: alpha_test_passed = alpha == alphatest_ref; break;
+    case 3u: alpha_test_passed = alpha != alphatest_ref; break;
+    case 4u: alpha_test_passed = alpha < alphatest_ref; break;
+    case 5u: alpha_test_passed = alpha <= alphatest_ref; break;
+    case 6u: alpha_test_passed = alpha > alphatest_ref; break;
+    case 7u: alpha_test_passed = alpha >= alphatest_ref; break;
+    default: alpha_test_passed = true; break;
+    }
+    if (!alpha_test_passed) {
+        discard;
+    }
+
+    if (Bits(fs_config, 18, 1) != 0u) {
+        float fog_index = (Bits(fs_config, 19, 1) != 0u ? 1.0 - depth : depth) * 128.0;
+        float fog_i = clamp(floor(fog_index), 0.0, 127.0);
+        float fog_f = fog_index - fog_i;
+        vec2 fog_lut_entry = texelFetch(texture_buffer_lut_lf, int(fog_i) + fog_lut_offset).rg;
+        float fog_factor = clamp(fog_lut_entry.r + fog_lut_entry.g * fog_f, 0.0, 1.0);
+        last_tex_env_out.rgb = mix(fog_color.rgb, last_tex_env_out.rgb, fog_factor);
+    }
+
+    gl_FragDepth = depth;
+    color = byteround(last_tex_env_out);
+}
+)";
+
+    return {std::move(out)};
+}
+
 ShaderDecompiler::ProgramResult GenerateTrivialVertexShader(bool separable_shader) {
     std::string out;
     if (separable_shader && !GLES) {
@@ -1610,7 +1911,8 @@ std::optional<ShaderDecompiler::ProgramResult> GenerateVertexShader(
 
     auto program_source_opt = ShaderDecompiler::DecompileProgram(
         setup.program_code, setup.swizzle_data, config.state.main_offset, get_input_reg,
-        get_output_reg, config.state.sanitize_mul);
+        get_output_reg, config.state.sanitize_mul, false,
+        {config.state.static_bool_mask, config.state.static_bool_values});
 
     if (!program_source_opt)
         return std::nullopt;
@@ -1734,6 +2036,116 @@ void EmitPrim(Vertex vtx0, Vertex vtx1, Vertex vtx2) {
     return out;
 };
 
+std::optional<ShaderDecompiler::ProgramResult> GenerateGeometryShader(
+    const Pica::Shader::ShaderSetup& setup, const PicaGSConfig& config, bool separable_shader) {
+    std::string out;
+    if (separable_shader && !GLES) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+
+    if (config.state.num_outputs == 0 ||
+        config.state.attributes_per_vertex > config.state.vs_output_attributes ||
+        config.state.num_inputs % config.state.attributes_per_vertex != 0) {
+        return std::nullopt;
+    }
+
+    // Each GS invocation takes the outputs of a fixed number of vertices
+    switch (config.state.num_inputs / config.state.attributes_per_vertex) {
+    case 1:
+        out += "layout(points) in;\n";
+        break;
+    case 2:
+        out += "layout(lines) in;\n";
+        break;
+    case 3:
+        out += "layout(triangles) in;\n";
+        break;
+    case 4:
+        out += "layout(lines_adjacency) in;\n";
+        break;
+    case 6:
+        out += "layout(triangles_adjacency) in;\n";
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    // Keeps the total output components within the minimum GL_MAX_GEOMETRY_TOTAL_OUTPUT_COMPONENTS,
+    // primitives emitted past the first ten are dropped
+    out += "layout(triangle_strip, max_vertices = 30) out;\n\n";
+
+    out += GetGSCommonSource(config.state, separable_shader);
+
+    const auto get_input_reg = [&config](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        const u32 attr = config.state.input_map[reg];
+        if (attr < config.state.num_inputs) {
+            return fmt::format("vs_out_attr{}[{}]", attr % config.state.attributes_per_vertex,
+                               attr / config.state.attributes_per_vertex);
+        }
+        return "vec4(0.0, 0.0, 0.0, 1.0)";
+    };
+
+    const auto get_output_reg = [&config](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        if (config.state.output_map[reg] < config.state.num_outputs) {
+            return fmt::format("output_buffer.attributes[{}]", config.state.output_map[reg]);
+        }
+        return "";
+    };
+
+    auto program_source_opt = ShaderDecompiler::DecompileProgram(
+        setup.program_code, setup.swizzle_data, config.state.main_offset, get_input_reg,
+        get_output_reg, config.state.sanitize_mul, true, {});
+
+    if (!program_source_opt) {
+        return std::nullopt;
+    }
+
+    std::string& program_source = program_source_opt->code;
+
+    out += R"(
+#define uniforms gs_uniforms
+layout (std140) uniform gs_config {
+    pica_uniforms uniforms;
+};
+
+Vertex output_buffer;
+Vertex prim_buffer[3];
+uint vertex_id = 0u;
+bool prim_emit = false;
+bool winding = false;
+
+void setemit(uint vertex_id_, bool prim_emit_, bool winding_) {
+    vertex_id = vertex_id_;
+    prim_emit = prim_emit_;
+    winding = winding_;
+}
+
+void emit() {
+    prim_buffer[vertex_id] = output_buffer;
+
+    if (prim_emit) {
+        if (winding) {
+            EmitPrim(prim_buffer[1], prim_buffer[0], prim_buffer[2]);
+        } else {
+            EmitPrim(prim_buffer[0], prim_buffer[1], prim_buffer[2]);
+        }
+    }
+}
+
+void main() {
+)";
+    for (u32 i = 0; i < config.state.num_outputs; ++i) {
+        out += fmt::format("    output_buffer.attributes[{}] = vec4(0.0, 0.0, 0.0, 1.0);\n", i);
+    }
+    out += "\n    exec_shader();\n}\n\n";
+
+    out += program_source;
+
+    return {{std::move(out)}};
+}
+
 ShaderDecompiler::ProgramResult GenerateFixedGeometryShader(const PicaFixedGSConfig& config,
                                                             bool separable_shader) {
     std::string out;
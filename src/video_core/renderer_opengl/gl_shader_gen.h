@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <array>
 #include <functional>
 #include <optional>
 #include "common/hash.h"
@@ -152,6 +153,9 @@ struct PicaShaderConfigCommon {
     u64 swizzle_hash;
     u32 main_offset;
     bool sanitize_mul;
+    // Bool uniforms folded into constants and their values, see BoolUniformSpecializer
+    u16 static_bool_mask;
+    u16 static_bool_values;
 
     u32 num_outputs;
 
@@ -197,6 +201,26 @@ struct PicaFixedGSConfig : Common::HashableStruct<PicaGSConfigCommonRaw> {
     }
 };
 
+struct PicaGSConfigRaw : PicaShaderConfigCommon, PicaGSConfigCommonRaw {
+    void Init(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup);
+
+    u32 num_inputs;
+    u32 attributes_per_vertex;
+
+    // input_map[input register index] -> input attribute index
+    std::array<u32, 16> input_map;
+};
+
+/**
+ * This struct contains information to identify a GL geometry shader generated from PICA geometry
+ * shader.
+ */
+struct PicaGSConfig : Common::HashableStruct<PicaGSConfigRaw> {
+    explicit PicaGSConfig(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup) {
+        state.Init(regs, setup);
+    }
+};
+
 /**
  * Generates the GLSL vertex shader program source code that accepts vertices from software shader
  * and directly passes them to the fragment shader.
@@ -212,6 +236,14 @@ ShaderDecompiler::ProgramResult GenerateTrivialVertexShader(bool separable_shade
 std::optional<ShaderDecompiler::ProgramResult> GenerateVertexShader(
     const Pica::Shader::ShaderSetup& setup, const PicaVSConfig& config, bool separable_shader);
 
+/**
+ * Generates the GLSL geometry shader program source code for the given GS program, running in the
+ * point mode of the geometry pipeline
+ * @returns String of the shader source code; std::nullopt on failure
+ */
+std::optional<ShaderDecompiler::ProgramResult> GenerateGeometryShader(
+    const Pica::Shader::ShaderSetup& setup, const PicaGSConfig& config, bool separable_shader);
+
 /*
  * Generates the GLSL fixed geometry shader program source code for non-GS PICA pipeline
  * @returns String of the shader source code
@@ -229,6 +261,27 @@ ShaderDecompiler::ProgramResult GenerateFixedGeometryShader(const PicaFixedGSCon
 ShaderDecompiler::ProgramResult GenerateFragmentShader(const PicaFSConfig& config,
                                                        bool separable_shader);
 
+/// Uniform values that configure the uber fragment shader for a PicaFSConfig
+struct UberShaderConfig {
+    std::array<std::array<u32, 4>, 6> tev_stages;
+    u32 fs_config;
+
+    static UberShaderConfig BuildFromConfig(const PicaFSConfig& config);
+
+    bool operator==(const UberShaderConfig&) const = default;
+};
+
+/// Returns true when the uber fragment shader can emulate the provided configuration
+bool IsUberShaderCapable(const PicaFSConfig& config);
+
+/**
+ * Generates a GLSL fragment shader that emulates any configuration accepted by
+ * IsUberShaderCapable, reading the TEV stages, alpha test and fog state from uniforms
+ * @param separable_shader generates shader that can be used for separate shader object
+ * @returns String of the shader source code
+ */
+ShaderDecompiler::ProgramResult GenerateUberFragmentShader(bool separable_shader);
+
 } // namespace OpenGL
 
 namespace std {
@@ -252,4 +305,11 @@ struct hash<OpenGL::PicaFixedGSConfig> {
         return k.Hash();
     }
 };
+
+template <>
+struct hash<OpenGL::PicaGSConfig> {
+    std::size_t operator()(const OpenGL::PicaGSConfig& k) const noexcept {
+        return k.Hash();
+    }
+};
 } // namespace std
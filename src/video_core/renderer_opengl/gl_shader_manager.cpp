@@ -3,15 +3,24 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <boost/variant.hpp>
+#include "common/settings.h"
+#include "common/thread_worker.h"
+#include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "video_core/compile_report.h"
 #include "video_core/renderer_opengl/gl_driver.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/shader/shader_specialization.h"
 #include "video_core/shader/shader_uniforms.h"
 #include "video_core/video_core.h"
 
@@ -105,6 +114,8 @@ static void SetShaderUniformBlockBindings(GLuint shader) {
                                  sizeof(Pica::Shader::UniformData));
     SetShaderUniformBlockBinding(shader, "vs_config", Pica::Shader::UniformBindings::VS,
                                  sizeof(Pica::Shader::VSUniformData));
+    SetShaderUniformBlockBinding(shader, "gs_config", Pica::Shader::UniformBindings::GS,
+                                 sizeof(Pica::Shader::GSUniformData));
 }
 
 static void SetShaderSamplerBinding(GLuint shader, const char* name,
@@ -150,6 +161,17 @@ static void SetShaderSamplerBindings(GLuint shader) {
     cur_state.Apply();
 }
 
+static constexpr VideoCore::CompileEventType GetCompileEventType(GLenum type) {
+    switch (type) {
+    case GL_VERTEX_SHADER:
+        return VideoCore::CompileEventType::GLVertexShader;
+    case GL_GEOMETRY_SHADER:
+        return VideoCore::CompileEventType::GLGeometryShader;
+    default:
+        return VideoCore::CompileEventType::GLFragmentShader;
+    }
+}
+
 /**
  * An object representing a shader program staging. It can be either a shader object or a program
  * object, depending on whether separable program is used.
@@ -165,6 +187,8 @@ public:
     }
 
     void Create(const char* source, GLenum type) {
+        Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                              Core::PerfStats::Subsystem::ShaderCompile};
         if (shader_or_program.which() == 0) {
             boost::get<OGLShader>(shader_or_program).Create(source, type);
         } else {
@@ -211,6 +235,35 @@ private:
     OGLShaderStage program;
 };
 
+/// Fragment shader that emulates most configurations by reading them from uniforms
+class UberFragmentShader {
+public:
+    UberFragmentShader() : program(true) {
+        program.Create(GenerateUberFragmentShader(true).code.c_str(), GL_FRAGMENT_SHADER);
+        tev_stages_location = glGetUniformLocation(program.GetHandle(), "tev_stages");
+        fs_config_location = glGetUniformLocation(program.GetHandle(), "fs_config");
+    }
+
+    GLuint Get(const PicaFSConfig& config) {
+        const UberShaderConfig uber_config = UberShaderConfig::BuildFromConfig(config);
+        if (uber_config != current_config) {
+            const GLuint handle = program.GetHandle();
+            glProgramUniform4uiv(handle, tev_stages_location,
+                                 static_cast<GLsizei>(uber_config.tev_stages.size()),
+                                 uber_config.tev_stages[0].data());
+            glProgramUniform1ui(handle, fs_config_location, uber_config.fs_config);
+            current_config = uber_config;
+        }
+        return program.GetHandle();
+    }
+
+private:
+    OGLShaderStage program;
+    GLint tev_stages_location;
+    GLint fs_config_location;
+    std::optional<UberShaderConfig> current_config;
+};
+
 template <typename KeyConfigType,
           ShaderDecompiler::ProgramResult (*CodeGenerator)(const KeyConfigType&, bool),
           GLenum ShaderType>
@@ -223,12 +276,20 @@ public:
         OGLShaderStage& cached_shader = iter->second;
         std::optional<ShaderDecompiler::ProgramResult> result{};
         if (new_shader) {
+            const VideoCore::ScopedCompileEvent event{GetCompileEventType(ShaderType),
+                                                      config.Hash(), true};
             result = CodeGenerator(config, separable);
             cached_shader.Create(result->code.c_str(), ShaderType);
         }
         return {cached_shader.GetHandle(), std::move(result)};
     }
 
+    /// Returns the handle of an already built shader, 0 when the shader is not cached
+    GLuint Find(const KeyConfigType& config) const {
+        const auto it = shaders.find(config);
+        return it != shaders.end() ? it->second.GetHandle() : 0;
+    }
+
     void Inject(const KeyConfigType& key, OGLProgram&& program) {
         OGLShaderStage stage{separable};
         stage.Inject(std::move(program));
@@ -261,8 +322,11 @@ public:
         std::optional<ShaderDecompiler::ProgramResult> result{};
         auto map_it = shader_map.find(key);
         if (map_it == shader_map.end()) {
+            VideoCore::ScopedCompileEvent event{GetCompileEventType(ShaderType), key.Hash(),
+                                                true};
             auto program_opt = CodeGenerator(setup, key, separable);
             if (!program_opt) {
+                event.Discard();
                 shader_map[key] = nullptr;
                 return {0, std::nullopt};
             }
@@ -274,6 +338,9 @@ public:
                 result.emplace();
                 result->code = program;
                 cached_shader.Create(program.c_str(), ShaderType);
+            } else {
+                // Same program as another config, only the code was generated
+                event.Discard();
             }
             shader_map[key] = &cached_shader;
             return {cached_shader.GetHandle(), std::move(result)};
@@ -309,6 +376,9 @@ private:
 using ProgrammableVertexShaders =
     ShaderDoubleCache<PicaVSConfig, &GenerateVertexShader, GL_VERTEX_SHADER>;
 
+using ProgrammableGeometryShaders =
+    ShaderDoubleCache<PicaGSConfig, &GenerateGeometryShader, GL_GEOMETRY_SHADER>;
+
 using FixedGeometryShaders =
     ShaderCache<PicaFixedGSConfig, &GenerateFixedGeometryShader, GL_GEOMETRY_SHADER>;
 
@@ -318,7 +388,8 @@ class ShaderProgramManager::Impl {
 public:
     explicit Impl(bool separable)
         : separable(separable), programmable_vertex_shaders(separable),
-          trivial_vertex_shader(separable), fixed_geometry_shaders(separable),
+          trivial_vertex_shader(separable), programmable_geometry_shaders(separable),
+          fixed_geometry_shaders(separable),
           fragment_shaders(separable), disk_cache(separable) {
         if (separable) {
             pipeline.Create();
@@ -351,34 +422,118 @@ public:
     static_assert(offsetof(ShaderTuple, fs_hash) == sizeof(std::size_t) * 2,
                   "ShaderTuple layout changed!");
 
+    /// A fragment shader built by the async worker, waiting to be added to the cache
+    struct CompiledShader {
+        PicaFSConfig config;
+        OGLProgram program;
+        ShaderDiskCacheRaw raw;
+        ShaderDecompiler::ProgramResult result;
+    };
+
+    /// Moves the fragment shaders finished by the async worker to the cache
+    void CollectCompiledShaders() {
+        std::vector<CompiledShader> compiled;
+        {
+            std::scoped_lock lock{compiled_mutex};
+            compiled.swap(compiled_shaders);
+        }
+        for (CompiledShader& shader : compiled) {
+            fragment_shaders.Inject(shader.config, std::move(shader.program));
+            disk_cache.SaveRaw(shader.raw);
+            disk_cache.SaveDecompiled(shader.raw.GetUniqueIdentifier(), shader.result, false);
+            pending_shaders.erase(shader.config);
+        }
+    }
+
+    /// Links a program of the precompiled cache on first use, the handle is 0 if there is none
+    OGLProgram LinkPrecompiledProgram(u64 unique_identifier) {
+        const auto it = precompiled_programs.find(unique_identifier);
+        if (it == precompiled_programs.end()) {
+            return {};
+        }
+        const VideoCore::ScopedCompileEvent event{VideoCore::CompileEventType::GLPrecompiledLink,
+                                                  unique_identifier, true};
+        OGLProgram program = GeneratePrecompiledProgram(it->second, supported_formats, separable);
+        precompiled_programs.erase(it);
+        return program;
+    }
+
     bool separable;
     ShaderTuple current;
+    std::optional<PicaVSConfig> current_vs_config; ///< Config of the bound vertex shader
+    std::optional<PicaFSConfig> current_fs_config; ///< Config of the bound fragment shader
     ProgrammableVertexShaders programmable_vertex_shaders;
+    Pica::Shader::BoolUniformSpecializer bool_uniform_specializer;
     TrivialVertexShader trivial_vertex_shader;
+    ProgrammableGeometryShaders programmable_geometry_shaders;
     FixedGeometryShaders fixed_geometry_shaders;
     FragmentShaders fragment_shaders;
     std::unordered_map<u64, OGLProgram> program_cache;
+    /// Binaries of the conventional precompiled cache, most of them are never used by the game
+    std::unordered_map<u64, ShaderDiskCacheDump> precompiled_programs;
+    std::set<GLenum> supported_formats;
     OGLPipeline pipeline;
     ShaderDiskCache disk_cache;
+    std::optional<UberFragmentShader> uber_fragment_shader;
+
+    using ContextScope = std::unique_ptr<Frontend::GraphicsContext::Scoped>;
+    std::unique_ptr<Frontend::GraphicsContext> async_context;
+    std::unordered_set<PicaFSConfig> pending_shaders;
+    std::optional<PicaFSConfig> waiting_config;
+    std::mutex compiled_mutex;
+    std::vector<CompiledShader> compiled_shaders;
+    std::unique_ptr<Common::StatefulThreadWorker<ContextScope>> async_worker;
 };
 
 ShaderProgramManager::ShaderProgramManager(Frontend::EmuWindow& emu_window_, Driver& driver,
                                            bool separable)
-    : impl(std::make_unique<Impl>(separable)), emu_window{emu_window_}, driver{driver} {}
+    : impl(std::make_unique<Impl>(separable)), emu_window{emu_window_}, driver{driver} {
+    // Separate programs are needed to swap in a fragment shader without relinking
+    if (!separable) {
+        return;
+    }
+    if (Settings::values.async_shader_compilation || Settings::values.force_uber_shader) {
+        impl->uber_fragment_shader.emplace();
+    }
+    if (!Settings::values.async_shader_compilation) {
+        return;
+    }
+
+    // On some platforms the shared context has to be created from the GUI thread
+    emu_window.SaveContext();
+    impl->async_context = emu_window.CreateSharedContext();
+    impl->async_context->DoneCurrent();
+    emu_window.RestoreContext();
+
+    impl->async_worker = std::make_unique<Common::StatefulThreadWorker<Impl::ContextScope>>(
+        1, "GLShaderCompiler", [this] {
+            return std::make_unique<Frontend::GraphicsContext::Scoped>(*impl->async_context);
+        });
+}
 
 ShaderProgramManager::~ShaderProgramManager() = default;
 
 bool ShaderProgramManager::UseProgrammableVertexShader(const Pica::Regs& regs,
                                                        Pica::Shader::ShaderSetup& setup) {
     PicaVSConfig config{regs.vs, setup};
+    if (Settings::values.specialize_hw_shaders) {
+        const auto bool_uniforms = impl->bool_uniform_specializer.Get(setup);
+        config.state.static_bool_mask = bool_uniforms.mask;
+        config.state.static_bool_values = bool_uniforms.values;
+    }
+    if (impl->current_vs_config == config) {
+        return true;
+    }
     auto [handle, result] = impl->programmable_vertex_shaders.Get(config, setup);
     if (handle == 0)
         return false;
     impl->current.vs = handle;
     impl->current.vs_hash = config.Hash();
+    impl->current_vs_config = config;
 
-    // Save VS to the disk cache if its a new shader
-    if (result) {
+    // Save VS to the disk cache if its a new shader. The disk cache rebuilds the config from the
+    // registers, so it only holds the generic shaders
+    if (result && config.state.static_bool_mask == 0) {
         auto& disk_cache = impl->disk_cache;
         ProgramCode program_code{setup.program_code.begin(), setup.program_code.end()};
         program_code.insert(program_code.end(), setup.swizzle_data.begin(),
@@ -395,6 +550,19 @@ bool ShaderProgramManager::UseProgrammableVertexShader(const Pica::Regs& regs,
 void ShaderProgramManager::UseTrivialVertexShader() {
     impl->current.vs = impl->trivial_vertex_shader.Get();
     impl->current.vs_hash = 0;
+    impl->current_vs_config.reset();
+}
+
+bool ShaderProgramManager::UseProgrammableGeometryShader(const Pica::Regs& regs,
+                                                         Pica::Shader::ShaderSetup& setup) {
+    PicaGSConfig gs_config{regs, setup};
+    auto [handle, _] = impl->programmable_geometry_shaders.Get(gs_config, setup);
+    if (handle == 0) {
+        return false;
+    }
+    impl->current.gs = handle;
+    impl->current.gs_hash = gs_config.Hash();
+    return true;
 }
 
 void ShaderProgramManager::UseFixedGeometryShader(const Pica::Regs& regs) {
@@ -411,9 +579,55 @@ void ShaderProgramManager::UseTrivialGeometryShader() {
 
 void ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
     PicaFSConfig config = PicaFSConfig::BuildFromRegs(regs);
+    // Games often rewrite registers with the values they already hold
+    if (impl->current_fs_config == config) {
+        return;
+    }
+    impl->current_fs_config = config;
+    const u64 config_hash = config.Hash();
+
+    impl->waiting_config.reset();
+    const bool use_uber_shader = impl->uber_fragment_shader && IsUberShaderCapable(config);
+    if (use_uber_shader && Settings::values.force_uber_shader) {
+        impl->current.fs = impl->uber_fragment_shader->Get(config);
+        impl->current.fs_hash = config_hash;
+        return;
+    }
+
+    if (impl->async_worker && impl->fragment_shaders.Find(config) == 0) {
+        // Draw with the uber shader until the specialized one is compiled
+        impl->current.fs = use_uber_shader ? impl->uber_fragment_shader->Get(config) : 0;
+        impl->current.fs_hash = config_hash;
+        impl->waiting_config = config;
+        if (!impl->pending_shaders.insert(config).second) {
+            return;
+        }
+
+        // The shader is linked on the shared context, its bindings are set once it is collected
+        const u64 unique_identifier = GetUniqueIdentifier(regs, {});
+        ShaderDiskCacheRaw raw{unique_identifier, ProgramType::FS, regs, {}};
+        impl->async_worker->QueueWork(
+            [this, config, raw = std::move(raw)](Impl::ContextScope*) mutable {
+                const VideoCore::ScopedCompileEvent event{
+                    VideoCore::CompileEventType::GLFragmentShader, config.Hash(), false};
+                ShaderDecompiler::ProgramResult result = GenerateFragmentShader(config, true);
+                OGLShader shader;
+                shader.Create(result.code, GL_FRAGMENT_SHADER);
+                OGLProgram program;
+                program.Create(true, {shader.handle});
+                // Make sure the program is complete before the emulation context uses it
+                glFinish();
+
+                std::scoped_lock lock{impl->compiled_mutex};
+                impl->compiled_shaders.push_back(
+                    {config, std::move(program), std::move(raw), std::move(result)});
+            });
+        return;
+    }
+
     auto [handle, result] = impl->fragment_shaders.Get(config);
     impl->current.fs = handle;
-    impl->current.fs_hash = config.Hash();
+    impl->current.fs_hash = config_hash;
     // Save FS to the disk cache if its a new shader
     if (result) {
         auto& disk_cache = impl->disk_cache;
@@ -424,6 +638,22 @@ void ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
     }
 }
 
+bool ShaderProgramManager::IsFragmentShaderReady() {
+    if (!impl->waiting_config) {
+        return true;
+    }
+
+    impl->CollectCompiledShaders();
+    const GLuint handle = impl->fragment_shaders.Find(*impl->waiting_config);
+    if (handle == 0) {
+        // The uber shader may already be bound as a stand-in
+        return impl->current.fs != 0;
+    }
+    impl->current.fs = handle;
+    impl->waiting_config.reset();
+    return true;
+}
+
 void ShaderProgramManager::ApplyTo(OpenGLState& state) {
     if (impl->separable) {
         if (driver.HasBug(DriverBug::ShaderStageChangeFreeze)) {
@@ -442,10 +672,18 @@ void ShaderProgramManager::ApplyTo(OpenGLState& state) {
         const u64 unique_identifier = impl->current.GetConfigHash();
         OGLProgram& cached_program = impl->program_cache[unique_identifier];
         if (cached_program.handle == 0) {
-            cached_program.Create(false, {impl->current.vs, impl->current.gs, impl->current.fs});
-            auto& disk_cache = impl->disk_cache;
-            disk_cache.SaveDumpToFile(unique_identifier, cached_program.handle,
-                                      VideoCore::g_hw_shader_accurate_mul);
+            cached_program = impl->LinkPrecompiledProgram(unique_identifier);
+            if (cached_program.handle == 0) {
+                Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                                      Core::PerfStats::Subsystem::ShaderCompile};
+                const VideoCore::ScopedCompileEvent event{
+                    VideoCore::CompileEventType::GLProgramLink, unique_identifier, true};
+                cached_program.Create(false,
+                                      {impl->current.vs, impl->current.gs, impl->current.fs});
+                // Appended after any rejected binary of the program, which it replaces on load
+                impl->disk_cache.SaveDumpToFile(unique_identifier, cached_program.handle,
+                                                VideoCore::g_hw_shader_accurate_mul);
+            }
 
             SetShaderUniformBlockBindings(cached_program.handle);
             SetShaderSamplerBindings(cached_program.handle);
@@ -471,7 +709,8 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         return;
     }
 
-    std::set<GLenum> supported_formats = GetSupportedFormats();
+    impl->supported_formats = GetSupportedFormats();
+    const std::set<GLenum>& supported_formats = impl->supported_formats;
 
     // Track if precompiled cache was altered during loading to know if we have to serialize the
     // virtual precompiled cache file back to the hard drive
@@ -482,6 +721,37 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
     if (callback) {
         callback(VideoCore::LoadCallbackStage::Decompile, 0, raws.size());
     }
+
+    // Splits [0, count) between a shared context per core and runs func on the ranges
+    const auto RunOnWorkers = [&](std::size_t count, const auto& func) {
+        if (count == 0) {
+            return;
+        }
+        const std::size_t num_cores{
+            Common::GetWorkerThreadCount(std::max(1U, std::thread::hardware_concurrency()))};
+        const std::size_t num_workers{std::clamp<std::size_t>(count, 1, num_cores)};
+        const std::size_t bucket_size{count / num_workers};
+        std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts(num_workers);
+        std::vector<std::thread> threads(num_workers);
+
+        emu_window.SaveContext();
+        for (std::size_t i = 0; i < num_workers; ++i) {
+            const bool is_last_worker = i + 1 == num_workers;
+            const std::size_t start{bucket_size * i};
+            const std::size_t end{is_last_worker ? count : start + bucket_size};
+
+            // On some platforms the shared context has to be created from the GUI thread
+            contexts[i] = emu_window.CreateSharedContext();
+            // Release the context, so it can be immediately used by the spawned thread
+            contexts[i]->DoneCurrent();
+            threads[i] = std::thread(func, contexts[i].get(), start, end);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        emu_window.RestoreContext();
+    };
+
     std::vector<std::size_t> load_raws_index;
     // Loads both decompiled and precompiled shaders from the cache. If either one is missing for
     const auto LoadPrecompiledShader = [&](std::size_t begin, std::size_t end,
@@ -557,41 +827,31 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
+    // Conventional programs are only linked when the game uses them, keep the binaries that were
+    // built with the current multiplication setting
     const auto LoadPrecompiledProgram = [&](const ShaderDecompiledMap& decompiled_map,
-                                            const ShaderDumpsMap& dump_map) {
-        std::size_t i{0};
-        for (const auto& dump : dump_map) {
-            if (stop_loading) {
-                break;
-            }
-            const u64 unique_identifier{dump.first};
+                                            ShaderDumpsMap& dump_map) {
+        for (auto& [unique_identifier, dump] : dump_map) {
             const auto decomp{decompiled_map.find(unique_identifier)};
-
-            // Only load the program if its sanitize_mul setting matches
-            if (decomp->second.sanitize_mul != VideoCore::g_hw_shader_accurate_mul) {
+            if (decomp == decompiled_map.end() ||
+                decomp->second.sanitize_mul != VideoCore::g_hw_shader_accurate_mul) {
                 continue;
             }
-
-            // If the shader program is dumped, attempt to load it
-            OGLProgram shader =
-                GeneratePrecompiledProgram(dump.second, supported_formats, impl->separable);
-            if (shader.handle != 0) {
-                SetShaderUniformBlockBindings(shader.handle);
-                SetShaderSamplerBindings(shader.handle);
-                impl->program_cache.emplace(unique_identifier, std::move(shader));
-            } else {
-                LOG_ERROR(Frontend, "Failed to link Precompiled program!");
-                compilation_failed = true;
-                break;
-            }
-            if (callback) {
-                callback(VideoCore::LoadCallbackStage::Decompile, ++i, dump_map.size());
-            }
+            impl->precompiled_programs.emplace(unique_identifier, std::move(dump));
+        }
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Decompile, dump_map.size(), dump_map.size());
         }
     };
 
     if (impl->separable) {
-        LoadPrecompiledShader(0, raws.size(), raws, decompiled, dumps);
+        // Binaries are loaded on all cores, the caches are only accessed behind the mutex
+        RunOnWorkers(raws.size(), [&, &decompiled = decompiled, &dumps = dumps](
+                                      Frontend::GraphicsContext* context, std::size_t begin,
+                                      std::size_t end) {
+            const auto scope = context->Acquire();
+            LoadPrecompiledShader(begin, end, raws, decompiled, dumps);
+        });
     } else {
         LoadPrecompiledProgram(decompiled, dumps);
     }
@@ -681,27 +941,7 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
-    const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
-    const std::size_t bucket_size{load_raws_size / num_workers};
-    std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts(num_workers);
-    std::vector<std::thread> threads(num_workers);
-
-    emu_window.SaveContext();
-    for (std::size_t i = 0; i < num_workers; ++i) {
-        const bool is_last_worker = i + 1 == num_workers;
-        const std::size_t start{bucket_size * i};
-        const std::size_t end{is_last_worker ? load_raws_size : start + bucket_size};
-
-        // On some platforms the shared context has to be created from the GUI thread
-        contexts[i] = emu_window.CreateSharedContext();
-        // Release the context, so it can be immediately used by the spawned thread
-        contexts[i]->DoneCurrent();
-        threads[i] = std::thread(LoadRawSepareble, contexts[i].get(), start, end);
-    }
-    for (auto& thread : threads) {
-        thread.join();
-    }
-    emu_window.RestoreContext();
+    RunOnWorkers(load_raws_size, LoadRawSepareble);
 
     if (compilation_failed) {
         disk_cache.InvalidateAll();
@@ -44,12 +44,17 @@ public:
 
     void UseTrivialVertexShader();
 
+    bool UseProgrammableGeometryShader(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup);
+
     void UseFixedGeometryShader(const Pica::Regs& regs);
 
     void UseTrivialGeometryShader();
 
     void UseFragmentShader(const Pica::Regs& config);
 
+    /// Returns false while the bound fragment shader is compiled asynchronously
+    bool IsFragmentShaderReady();
+
     void ApplyTo(OpenGLState& state);
 
 private:
@@ -4,8 +4,12 @@
 
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "video_core/renderer_opengl/gl_stream_buffer.h"
 
+MICROPROFILE_DEFINE(OpenGL_StreamBufferWait, "OpenGL", "Stream Buffer Wait", MP_RGB(192, 64, 64));
+
 namespace OpenGL {
 
 StreamBuffer::StreamBuffer(GLenum target, size_t size_)
@@ -30,6 +34,8 @@ StreamBuffer::StreamBuffer(GLenum target, size_t size_)
 }
 
 StreamBuffer::~StreamBuffer() {
+    LOG_DEBUG(Render_OpenGL, "Stream buffer {:#x}: {} waits on the GPU, {} of them on wrap",
+              gl_target, num_stalls, num_wrap_stalls);
     if (buffer_storage) {
         glBindBuffer(gl_target, gl_buffer.handle);
         glUnmapBuffer(gl_target);
@@ -51,8 +57,7 @@ std::tuple<u8*, u64, bool> StreamBuffer::Map(u64 size, u64 alignment) {
 
     // Wait for new slots to end of buffer
     for (u64 i = Slot(free_iterator) + 1; i <= Slot(iterator + size) && i < SYNC_POINTS; i++) {
-        glClientWaitSync(fences[i].handle, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
-        fences[i].Release();
+        WaitSlot(i, false);
     }
 
     // If we allocate a large amount of memory (A), commit a smaller amount, then allocate memory
@@ -78,8 +83,7 @@ std::tuple<u8*, u64, bool> StreamBuffer::Map(u64 size, u64 alignment) {
 
         // Wait for space at the start
         for (u64 i = 0; i <= Slot(iterator + size); i++) {
-            glClientWaitSync(fences[i].handle, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
-            fences[i].Release();
+            WaitSlot(i, true);
         }
         free_iterator = iterator + size;
     }
@@ -107,4 +111,20 @@ void StreamBuffer::Unmap(u64 used_size) {
     iterator += used_size;
 }
 
+void StreamBuffer::WaitSlot(u64 slot, bool wrap) {
+    OGLSync& fence = fences[slot];
+    if (fence.handle == 0) {
+        return;
+    }
+
+    // Only count waits where the GPU is still using the slot
+    if (glClientWaitSync(fence.handle, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        MICROPROFILE_SCOPE(OpenGL_StreamBufferWait);
+        num_stalls++;
+        num_wrap_stalls += wrap ? 1 : 0;
+        glClientWaitSync(fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    }
+    fence.Release();
+}
+
 } // namespace OpenGL
@@ -40,6 +40,9 @@ private:
         return offset / slot_size;
     }
 
+    /// Waits until the GPU is done with the slot, wrap is set when waiting after the ring wrapped
+    void WaitSlot(u64 slot, bool wrap);
+
     GLenum gl_target;
     size_t buffer_size;
     size_t slot_size;
@@ -51,6 +54,9 @@ private:
     u64 used_iterator = 0;
     u64 free_iterator = 0;
 
+    u64 num_stalls = 0;      ///< Slot waits that blocked on the GPU
+    u64 num_wrap_stalls = 0; ///< Subset of num_stalls caused by the ring wrapping
+
     OGLBuffer gl_buffer;
     std::array<OGLSync, SYNC_POINTS> fences{};
 };
@@ -2,8 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include "common/alignment.h"
+#include "common/literals.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
+#include "video_core/host_shaders/texture_codec_comp.h"
 #include "video_core/rasterizer_cache/utils.h"
 #include "video_core/regs.h"
 #include "video_core/renderer_opengl/gl_driver.h"
@@ -15,11 +19,16 @@
 
 namespace OpenGL {
 
+using namespace Common::Literals;
 using VideoCore::StagingData;
 using VideoCore::TextureType;
 
 constexpr FormatTuple DEFAULT_TUPLE = {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE};
 
+/// Filtered textures kept around for re-uploads of unchanged guest data
+constexpr u64 MAX_FILTER_CACHE_MEMORY = 64_MiB;
+constexpr u32 UPLOAD_BUFFER_SIZE = 32_MiB;
+
 static constexpr std::array DEPTH_TUPLES = {
     FormatTuple{GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT},              // D16
     FormatTuple{}, FormatTuple{GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT}, // D24
@@ -56,6 +65,26 @@ static constexpr std::array CUSTOM_TUPLES = {
     FormatTuple{GL_COMPRESSED_RGBA_ASTC_8x6, GL_COMPRESSED_RGBA_ASTC_8x6, GL_UNSIGNED_BYTE},
 };
 
+/// Returns the pixel pointer passed to GL for the staging data. Staging without a mapping
+/// lives in the pixel buffer bound by the caller and is addressed by its offset.
+[[nodiscard]] static void* PixelData(const StagingData& staging, u32 buffer_offset) {
+    if (staging.mapped.empty()) {
+        return reinterpret_cast<void*>(static_cast<uintptr_t>(staging.buffer_offset) +
+                                       buffer_offset);
+    }
+    return staging.mapped.data() + buffer_offset;
+}
+
+/// Estimates the memory of a texture, drivers do not report the size of their allocations
+[[nodiscard]] static u64 TextureMemory(const HostTextureTag& tag) {
+    const u64 layers = tag.type == TextureType::CubeMap ? 6 : 1;
+    u64 texels = 0;
+    for (u32 level = 0; level < tag.levels; level++) {
+        texels += (tag.width >> level) * (tag.height >> level);
+    }
+    return texels * layers * 4;
+}
+
 [[nodiscard]] GLbitfield MakeBufferMask(VideoCore::SurfaceType type) {
     switch (type) {
     case VideoCore::SurfaceType::Color:
@@ -88,6 +117,18 @@ TextureRuntime::TextureRuntime(Driver& driver)
 
     Register(VideoCore::PixelFormat::RGBA8, std::make_unique<D24S8toRGBA8>(!driver.IsOpenGLES()));
     Register(VideoCore::PixelFormat::RGB5A1, std::make_unique<RGBA4toRGB5A1>());
+
+    if (driver.HasComputeShaders()) {
+        texture_codec.Create(HostShaders::TEXTURE_CODEC_COMP);
+        codec_buffer.Create();
+    }
+
+    // Without persistent mapping the ring has to stay bound while it is mapped,
+    // which the rasterizer cache does not guarantee between filling and uploading
+    if (GLAD_GL_ARB_buffer_storage) {
+        upload_buffer.emplace(GL_PIXEL_UNPACK_BUFFER, UPLOAD_BUFFER_SIZE);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
 }
 
 TextureRuntime::~TextureRuntime() = default;
@@ -95,9 +136,76 @@ TextureRuntime::~TextureRuntime() = default;
 void TextureRuntime::Clear() {
     framebuffer_cache.clear();
     texture_recycler.clear();
+    recycled_memory = 0;
+    filter_cache.clear();
+    filter_cache_memory = 0;
+}
+
+bool TextureRuntime::CopyFilterResult(u64 key, Surface& surface, VideoCore::Rect2D rect,
+                                      u32 level) {
+    const auto it = filter_cache.find(key);
+    if (it == filter_cache.end()) {
+        return false;
+    }
+    FilterResult& result = it->second;
+    if (result.alloc.width != rect.GetWidth() || result.alloc.height != rect.GetHeight() ||
+        !(result.alloc.tuple == surface.Tuple())) {
+        return false;
+    }
+
+    result.last_used = ++filter_cache_tick;
+    glCopyImageSubData(result.alloc.texture.handle, GL_TEXTURE_2D, 0, 0, 0, 0, surface.Handle(),
+                       GL_TEXTURE_2D, level, rect.left, rect.bottom, 0, rect.GetWidth(),
+                       rect.GetHeight(), 1);
+    return true;
+}
+
+void TextureRuntime::CacheFilterResult(u64 key, const Surface& surface, VideoCore::Rect2D rect,
+                                       u32 level) {
+    const HostTextureTag tag = {
+        .tuple = surface.Tuple(),
+        .type = VideoCore::TextureType::Texture2D,
+        .width = rect.GetWidth(),
+        .height = rect.GetHeight(),
+        .levels = 1,
+    };
+    const u64 memory = TextureMemory(tag);
+    if (memory > MAX_FILTER_CACHE_MEMORY / 4) {
+        return;
+    }
+
+    // Drop the least recently used results until the new one fits
+    while (filter_cache_memory + memory > MAX_FILTER_CACHE_MEMORY) {
+        const auto oldest = std::ranges::min_element(
+            filter_cache, {}, [](const auto& pair) { return pair.second.last_used; });
+        filter_cache_memory -= oldest->second.memory;
+        filter_cache.erase(oldest);
+    }
+    if (const auto it = filter_cache.find(key); it != filter_cache.end()) {
+        filter_cache_memory -= it->second.memory;
+        filter_cache.erase(it);
+    }
+
+    Allocation alloc = Allocate(tag.width, tag.height, 1, tag.tuple, tag.type);
+    glCopyImageSubData(surface.Handle(), GL_TEXTURE_2D, level, rect.left, rect.bottom, 0,
+                       alloc.texture.handle, GL_TEXTURE_2D, 0, 0, 0, 0, rect.GetWidth(),
+                       rect.GetHeight(), 1);
+    filter_cache_memory += memory;
+    filter_cache.emplace(key, FilterResult{std::move(alloc), memory, ++filter_cache_tick});
 }
 
 StagingData TextureRuntime::FindStaging(u32 size, bool upload) {
+    // Uploads are written straight to the fenced ring, so the driver does not have to copy
+    // them out of client memory before glTexSubImage2D returns. Large uploads would stall
+    // on the ring wrapping and fall back to the host buffer
+    if (upload && upload_buffer && size <= UPLOAD_BUFFER_SIZE / 4) {
+        const auto [data, offset, invalidate] = upload_buffer->Map(size, 16);
+        return StagingData{
+            .size = size,
+            .mapped = std::span{data, size},
+            .buffer_offset = offset,
+        };
+    }
     if (size > staging_buffer.size()) {
         staging_buffer.resize(size);
     }
@@ -108,6 +216,18 @@ StagingData TextureRuntime::FindStaging(u32 size, bool upload) {
     };
 }
 
+StagingData TextureRuntime::CommitUpload(const StagingData& staging) {
+    if (staging.mapped.empty() || staging.mapped.data() == staging_buffer.data()) {
+        return staging;
+    }
+    upload_buffer->Unmap(staging.size);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload_buffer->Handle());
+    return StagingData{
+        .size = staging.size,
+        .buffer_offset = staging.buffer_offset,
+    };
+}
+
 const FormatTuple& TextureRuntime::GetFormatTuple(VideoCore::PixelFormat pixel_format) {
     const auto type = GetFormatType(pixel_format);
     const std::size_t format_index = static_cast<std::size_t>(pixel_format);
@@ -131,6 +251,7 @@ const FormatTuple& TextureRuntime::GetFormatTuple(VideoCore::CustomPixelFormat p
 }
 
 void TextureRuntime::Recycle(const HostTextureTag tag, Allocation&& alloc) {
+    recycled_memory += TextureMemory(tag);
     texture_recycler.emplace(tag, std::move(alloc));
 }
 
@@ -150,6 +271,7 @@ Allocation TextureRuntime::Allocate(u32 width, u32 height, u32 levels, const For
     if (auto it = texture_recycler.find(key); it != texture_recycler.end()) {
         Allocation alloc = std::move(it->second);
         texture_recycler.erase(it);
+        recycled_memory -= TextureMemory(key);
         return alloc;
     }
 
@@ -307,6 +429,93 @@ bool TextureRuntime::NeedsConvertion(VideoCore::PixelFormat format) const {
            (format == VideoCore::PixelFormat::RGB8 || format == VideoCore::PixelFormat::RGBA8);
 }
 
+bool TextureRuntime::SupportsGpuCodec(VideoCore::PixelFormat format, bool encode) const {
+    // Depth formats stay on the CPU, texture formats are never written back by the guest GPU
+    const VideoCore::SurfaceType type = GetFormatType(format);
+    return driver.HasComputeShaders() &&
+           (type == VideoCore::SurfaceType::Color ||
+            (type == VideoCore::SurfaceType::Texture && !encode));
+}
+
+bool TextureRuntime::ReinterpretTiled(Surface& source, Surface& dest, VideoCore::Rect2D src_rect,
+                                      VideoCore::Rect2D dst_rect) {
+    if (!SupportsGpuCodec(source.pixel_format, true) ||
+        !SupportsGpuCodec(dest.pixel_format, false)) {
+        return false;
+    }
+
+    // The tiled bytes are placed at the start of the codec buffer, the linear texels after them
+    const u32 width = src_rect.GetWidth();
+    const u32 height = src_rect.GetHeight();
+    const u32 linear_offset = Common::AlignUp(source.BytesInPixels(width * height), 16);
+    const u32 linear_size = width * height * 4;
+    const GLuint buffer = GetCodecBuffer(linear_offset + linear_size);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    source.Download(
+        {
+            .buffer_offset = linear_offset,
+            .buffer_size = linear_size,
+            .texture_rect = src_rect,
+            .texture_level = 0,
+        },
+        StagingData{.size = linear_size});
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    RunTextureCodec(VideoCore::MakeTextureCodecParams(source.pixel_format, width, height, 0,
+                                                      linear_offset,
+                                                      NeedsConvertion(source.pixel_format), true));
+
+    // The decode pass reads what the encode pass wrote
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    RunTextureCodec(VideoCore::MakeTextureCodecParams(dest.pixel_format, width, height, 0,
+                                                      linear_offset,
+                                                      NeedsConvertion(dest.pixel_format), false));
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    dest.Upload(
+        {
+            .buffer_offset = linear_offset,
+            .buffer_size = linear_size,
+            .texture_rect = dst_rect,
+            .texture_level = 0,
+        },
+        StagingData{.size = linear_size});
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return true;
+}
+
+GLuint TextureRuntime::GetCodecBuffer(u32 size) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, codec_buffer.handle);
+    if (size > codec_buffer_size) {
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_COPY);
+        codec_buffer_size = size;
+    }
+    return codec_buffer.handle;
+}
+
+void TextureRuntime::RunTextureCodec(const VideoCore::TextureCodecParams& params) {
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    SCOPE_EXIT({ prev_state.Apply(); });
+
+    OpenGLState state;
+    state.draw.shader_program = texture_codec.handle;
+    state.Apply();
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, codec_buffer.handle);
+    glUniform1ui(0, params.tiled_offset);
+    glUniform1ui(1, params.linear_offset);
+    glUniform1ui(2, params.width);
+    glUniform1ui(3, params.height);
+    glUniform1ui(4, params.format);
+    glUniform1ui(5, params.flags);
+    glUniform1ui(6, params.count);
+    glDispatchCompute((params.count + 63) / 64, 1, 1);
+
+    // Decoded texels are read by a pixel transfer, encoded ones by a buffer mapping
+    const bool encode = params.flags & VideoCore::TextureCodecParams::Encode;
+    glMemoryBarrier(encode ? GL_BUFFER_UPDATE_BARRIER_BIT : GL_PIXEL_BUFFER_BARRIER_BIT);
+}
+
 void TextureRuntime::BindFramebuffer(GLenum target, GLint level, GLenum textarget,
                                      VideoCore::SurfaceType type, GLuint handle) const {
     const GLint framebuffer = target == GL_DRAW_FRAMEBUFFER ? draw_fbo.handle : read_fbo.handle;
@@ -381,19 +590,24 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload, const StagingDa
         // Wait for the buffer if a decode is pending, this isn't very optimal
         // but this kind of threading is very hard in gl
         staging.Wait();
+        const StagingData source = runtime->CommitUpload(staging);
+        const bool bound_ring = source.mapped.empty() && !staging.mapped.empty();
 
         const auto& tuple = alloc.tuple;
         if (is_custom && custom_format != VideoCore::CustomPixelFormat::RGBA8) {
             glCompressedTexSubImage2D(GL_TEXTURE_2D, upload.texture_level, rect.left, rect.bottom,
                                       rect.GetWidth(), rect.GetHeight(), tuple.format, staging.size,
-                                      staging.mapped.data());
+                                      PixelData(source, upload.buffer_offset));
         } else {
             glTexSubImage2D(GL_TEXTURE_2D, upload.texture_level, rect.left, rect.bottom,
                             rect.GetWidth(), rect.GetHeight(), tuple.format, tuple.type,
-                            staging.mapped.data());
+                            PixelData(source, upload.buffer_offset));
         }
 
         glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        if (bound_ring) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
 
         // Restore old texture
         glBindTexture(GL_TEXTURE_2D, OpenGLState::GetCurState().texture_units[0].texture_2d);
@@ -416,7 +630,7 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download, const Stagi
 
         const auto& tuple = runtime->GetFormatTuple(pixel_format);
         glReadPixels(rect.left, rect.bottom, rect.GetWidth(), rect.GetHeight(), tuple.format,
-                     tuple.type, staging.mapped.data());
+                     tuple.type, PixelData(staging, download.buffer_offset));
 
         glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
@@ -425,6 +639,54 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download, const Stagi
     }
 }
 
+void Surface::UploadTiled(const VideoCore::BufferTextureCopy& upload, const StagingData& staging) {
+    const VideoCore::Rect2D rect = upload.texture_rect;
+    const auto params = VideoCore::MakeTextureCodecParams(
+        pixel_format, rect.GetWidth(), rect.GetHeight(), 0, upload.buffer_offset,
+        runtime->NeedsConvertion(pixel_format), false);
+
+    // Converted texels are always 4 bytes, which can be more than the internal size
+    const u32 linear_size = rect.GetWidth() * rect.GetHeight() * 4;
+    const GLuint buffer = runtime->GetCodecBuffer(upload.buffer_offset + linear_size);
+    const StagingData source = runtime->CommitUpload(staging);
+    if (source.mapped.empty()) {
+        glCopyBufferSubData(GL_PIXEL_UNPACK_BUFFER, GL_SHADER_STORAGE_BUFFER, source.buffer_offset,
+                            0, upload.buffer_offset);
+    } else {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, upload.buffer_offset, source.mapped.data());
+    }
+    runtime->RunTextureCodec(params);
+
+    // Upload from the codec buffer, offsets are relative to its start
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    Upload(upload, StagingData{.size = upload.buffer_size});
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void Surface::DownloadTiled(const VideoCore::BufferTextureCopy& download,
+                            const StagingData& staging) {
+    const VideoCore::Rect2D rect = download.texture_rect;
+    const auto params = VideoCore::MakeTextureCodecParams(
+        pixel_format, rect.GetWidth(), rect.GetHeight(), 0, download.buffer_offset,
+        runtime->NeedsConvertion(pixel_format), true);
+
+    const u32 linear_size = rect.GetWidth() * rect.GetHeight() * 4;
+    const GLuint buffer = runtime->GetCodecBuffer(download.buffer_offset + linear_size);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    Download(download, StagingData{.size = download.buffer_size});
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    runtime->RunTextureCodec(params);
+
+    // The tiled data is placed at the start of the codec buffer
+    const u32 tiled_size = BytesInPixels(rect.GetWidth() * rect.GetHeight());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    const void* tiled_data =
+        glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, tiled_size, GL_MAP_READ_BIT);
+    std::memcpy(staging.mapped.data(), tiled_data, tiled_size);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+}
+
 bool Surface::Swap(u32 width, u32 height, VideoCore::CustomPixelFormat format) {
     if (!driver->IsCustomFormatSupported(format)) {
         return false;
@@ -461,6 +723,20 @@ void Surface::ScaledUpload(const VideoCore::BufferTextureCopy& upload, const Sta
     const auto scaled_rect = upload.texture_rect * res_scale;
     const auto unscaled_rect = VideoCore::Rect2D{0, rect_height, rect_width, 0};
 
+    // Unchanged textures are often uploaded again, skip filtering them every time
+    const auto& filterer = runtime->GetFilterer();
+    const bool is_filtered = !filterer.IsNull() && (type == VideoCore::SurfaceType::Color ||
+                                                    type == VideoCore::SurfaceType::Texture);
+    u64 filter_key = 0;
+    if (is_filtered && upload.source_hash != 0) {
+        const u64 params = static_cast<u64>(pixel_format) | u64{res_scale} << 8 |
+                           u64{rect_width} << 16 | u64{rect_height} << 32;
+        filter_key = Common::HashCombine(upload.source_hash, params);
+        if (runtime->CopyFilterResult(filter_key, *this, scaled_rect, upload.texture_level)) {
+            return;
+        }
+    }
+
     SurfaceParams unscaled_params = *this;
     unscaled_params.width = rect_width;
     unscaled_params.stride = rect_width;
@@ -475,9 +751,12 @@ void Surface::ScaledUpload(const VideoCore::BufferTextureCopy& upload, const Sta
     };
     unscaled_surface.Upload(unscaled_upload, staging);
 
-    const auto& filterer = runtime->GetFilterer();
-    if (!filterer.Filter(unscaled_surface.alloc.texture, unscaled_rect, alloc.texture, scaled_rect,
-                         type)) {
+    if (filterer.Filter(unscaled_surface.alloc.texture, unscaled_rect, alloc.texture, scaled_rect,
+                        type)) {
+        if (filter_key != 0) {
+            runtime->CacheFilterResult(filter_key, *this, scaled_rect, upload.texture_level);
+        }
+    } else {
         const VideoCore::TextureBlit blit = {
             .src_level = 0,
             .dst_level = upload.texture_level,
@@ -522,10 +801,10 @@ void Surface::ScaledDownload(const VideoCore::BufferTextureCopy& download,
         runtime->BindFramebuffer(GL_READ_FRAMEBUFFER, download.texture_level, GL_TEXTURE_2D, type,
                                  unscaled_surface.Handle());
         glReadPixels(0, 0, rect_width, rect_height, tuple.format, tuple.type,
-                     staging.mapped.data());
+                     PixelData(staging, download.buffer_offset));
     } else {
         glGetTexImage(GL_TEXTURE_2D, download.texture_level, tuple.format, tuple.type,
-                      staging.mapped.data());
+                      PixelData(staging, download.buffer_offset));
     }
 }
 
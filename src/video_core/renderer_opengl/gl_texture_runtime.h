@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <optional>
 #include <set>
 #include <span>
 #include "video_core/rasterizer_cache/framebuffer_base.h"
@@ -15,7 +16,8 @@
 
 namespace VideoCore {
 enum class CustomPixelFormat : u32;
-}
+struct TextureCodecParams;
+} // namespace VideoCore
 
 namespace OpenGL {
 
@@ -90,6 +92,10 @@ public:
     /// Maps an internal staging buffer of the provided size of pixel uploads/downloads
     VideoCore::StagingData FindStaging(u32 size, bool upload);
 
+    /// Hands a staging buffer filled for an upload to the GPU, returning the staging to source it
+    /// from. Uploads placed in the upload ring are relative to the unpack buffer it binds
+    VideoCore::StagingData CommitUpload(const VideoCore::StagingData& staging);
+
     /// Returns the OpenGL format tuple associated with the provided pixel format
     const FormatTuple& GetFormatTuple(VideoCore::PixelFormat pixel_format);
     const FormatTuple& GetFormatTuple(VideoCore::CustomPixelFormat pixel_format);
@@ -103,6 +109,17 @@ public:
     /// Takes back ownership of the allocation for recycling
     void Recycle(const HostTextureTag tag, Allocation&& alloc);
 
+    /// Returns the memory the rasterizer cache may spend on surfaces, zero when unknown
+    u64 GetSurfaceMemoryBudget() const {
+        return 0;
+    }
+
+    /// Returns the approximate memory held by allocations waiting to be recycled
+    /// and by cached filter results
+    u64 GetRecycledMemory() const noexcept {
+        return recycled_memory + filter_cache_memory;
+    }
+
     /// Allocates an OpenGL texture with the specified dimentions and format
     Allocation Allocate(u32 width, u32 height, u32 levels, const FormatTuple& tuple,
                         VideoCore::TextureType type);
@@ -126,11 +143,30 @@ public:
     /// Returns true if the provided pixel format needs convertion
     [[nodiscard]] bool NeedsConvertion(VideoCore::PixelFormat format) const;
 
+    /// Returns true if the texture codec shader can unswizzle, or swizzle when encoding, the format
+    [[nodiscard]] bool SupportsGpuCodec(VideoCore::PixelFormat format, bool encode) const;
+
+    /// Returns true if scaled uploads are filtered, which reuses results by the source data hash
+    [[nodiscard]] bool IsUploadFiltered() const {
+        return !filterer.IsNull();
+    }
+
+    /// Encodes the source rectangle to tiled guest bytes and decodes them into the dest rectangle
+    /// with the texture codec, the rectangles are unscaled and cover whole rows of tiles
+    bool ReinterpretTiled(Surface& source, Surface& dest, VideoCore::Rect2D src_rect,
+                          VideoCore::Rect2D dst_rect);
+
 private:
     /// Returns the framebuffer used for texture downloads
     void BindFramebuffer(GLenum target, GLint level, GLenum textarget, VideoCore::SurfaceType type,
                          GLuint handle) const;
 
+    /// Returns the buffer used by the texture codec, growing it to hold at least size bytes
+    GLuint GetCodecBuffer(u32 size);
+
+    /// Runs the texture codec shader on the codec buffer
+    void RunTextureCodec(const VideoCore::TextureCodecParams& params);
+
     /// Returns the OpenGL driver class
     const Driver& GetDriver() const {
         return driver;
@@ -141,14 +177,34 @@ private:
         return filterer;
     }
 
+    /// Copies a cached filter result to the rectangle of the surface, returns false on a miss
+    bool CopyFilterResult(u64 key, Surface& surface, VideoCore::Rect2D rect, u32 level);
+
+    /// Keeps a copy of the filtered rectangle of the surface for later uploads of the same data
+    void CacheFilterResult(u64 key, const Surface& surface, VideoCore::Rect2D rect, u32 level);
+
 private:
+    struct FilterResult {
+        Allocation alloc;
+        u64 memory;
+        u64 last_used;
+    };
+
     Driver& driver;
     TextureFilterer filterer;
+    std::unordered_map<u64, FilterResult, Common::IdentityHash<u64>> filter_cache;
+    u64 filter_cache_memory{};
+    u64 filter_cache_tick{};
     std::array<ReinterpreterList, VideoCore::PIXEL_FORMAT_COUNT> reinterpreters;
     std::unordered_multimap<HostTextureTag, Allocation> texture_recycler;
+    u64 recycled_memory{};
     std::unordered_map<u64, OGLFramebuffer, Common::IdentityHash<u64>> framebuffer_cache;
     std::vector<u8> staging_buffer;
+    std::optional<StreamBuffer> upload_buffer;
     OGLFramebuffer read_fbo, draw_fbo;
+    OGLProgram texture_codec;
+    OGLBuffer codec_buffer;
+    u32 codec_buffer_size{};
 };
 
 class Surface : public VideoCore::SurfaceBase {
@@ -167,6 +223,11 @@ public:
         return alloc.texture.handle;
     }
 
+    /// Returns the format tuple of the surface image
+    const FormatTuple& Tuple() const noexcept {
+        return alloc.tuple;
+    }
+
     /// Uploads pixel data in staging to a rectangle region of the surface texture
     void Upload(const VideoCore::BufferTextureCopy& upload, const VideoCore::StagingData& staging);
 
@@ -174,6 +235,14 @@ public:
     void Download(const VideoCore::BufferTextureCopy& download,
                   const VideoCore::StagingData& staging);
 
+    /// Decodes the tiled data at the start of staging on the GPU and uploads the result
+    void UploadTiled(const VideoCore::BufferTextureCopy& upload,
+                     const VideoCore::StagingData& staging);
+
+    /// Downloads pixel data to staging and swizzles it to the start of staging on the GPU
+    void DownloadTiled(const VideoCore::BufferTextureCopy& download,
+                       const VideoCore::StagingData& staging);
+
     /// Swaps the internal allocation to match the provided dimentions and format
     bool Swap(u32 width, u32 height, VideoCore::CustomPixelFormat format);
 
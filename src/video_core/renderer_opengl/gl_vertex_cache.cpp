@@ -0,0 +1,68 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/alignment.h"
+#include "common/hash.h"
+#include "video_core/renderer_opengl/gl_vertex_cache.h"
+
+namespace OpenGL {
+
+VertexCache::VertexCache(std::size_t size) : buffer_size{size} {
+    buffer.Create();
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.handle);
+    glBufferData(GL_COPY_WRITE_BUFFER, buffer_size, nullptr, GL_STATIC_DRAW);
+}
+
+VertexCache::~VertexCache() = default;
+
+std::optional<GLintptr> VertexCache::Find(PAddr addr, std::span<const u8> data) {
+    // Large ranges would evict everything else
+    if (data.empty() || data.size() > buffer_size / 4) {
+        return std::nullopt;
+    }
+
+    const u64 key = (static_cast<u64>(addr) << 32) | data.size();
+    const u64 hash = Common::ComputeHash64(data.data(), data.size());
+    if (entries.size() >= MaxEntries && !entries.contains(key)) {
+        // Forget the ranges that were only seen once before dropping the uploaded ones
+        std::erase_if(entries, [](const auto& item) { return item.second.offset == NotUploaded; });
+        if (entries.size() >= MaxEntries) {
+            Clear();
+        }
+    }
+    auto [it, new_entry] = entries.try_emplace(key, Entry{hash, NotUploaded});
+    Entry& entry = it->second;
+    if (new_entry || entry.hash != hash) {
+        entry = Entry{hash, NotUploaded};
+        return std::nullopt;
+    }
+    if (entry.offset != NotUploaded) {
+        num_hits++;
+        return entry.offset;
+    }
+
+    // Seen twice with the same contents, keep it on the GPU
+    const std::size_t aligned_size = Common::AlignUp(data.size(), 4);
+    if (used_size + aligned_size > buffer_size) {
+        Clear();
+        it = entries.try_emplace(key, Entry{hash, NotUploaded}).first;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.handle);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(used_size),
+                    static_cast<GLsizeiptr>(data.size()), data.data());
+    it->second.offset = static_cast<GLintptr>(used_size);
+    used_size += aligned_size;
+    uploaded_bytes += data.size();
+    return it->second.offset;
+}
+
+void VertexCache::Clear() {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.handle);
+    glBufferData(GL_COPY_WRITE_BUFFER, buffer_size, nullptr, GL_STATIC_DRAW);
+    entries.clear();
+    used_size = 0;
+    generation++;
+}
+
+} // namespace OpenGL
@@ -0,0 +1,72 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+/**
+ * Keeps vertex data that is drawn repeatedly in a GPU buffer, so static geometry isn't streamed
+ * on every draw. Ranges are keyed by their guest address and size and validated with a hash of
+ * their contents. A range is uploaded the second time it is seen with the same contents, data
+ * that changes every draw never enters the cache.
+ */
+class VertexCache {
+public:
+    explicit VertexCache(std::size_t size);
+    ~VertexCache();
+
+    [[nodiscard]] GLuint Handle() const noexcept {
+        return buffer.handle;
+    }
+
+    /**
+     * Returns the offset of the cached copy of the range, std::nullopt if it is not cached.
+     * Offsets returned before the generation changes are no longer valid.
+     */
+    std::optional<GLintptr> Find(PAddr addr, std::span<const u8> data);
+
+    /// Incremented whenever the cached ranges are dropped
+    [[nodiscard]] u64 Generation() const noexcept {
+        return generation;
+    }
+
+    [[nodiscard]] u64 NumHits() const noexcept {
+        return num_hits;
+    }
+
+    [[nodiscard]] u64 UploadedBytes() const noexcept {
+        return uploaded_bytes;
+    }
+
+private:
+    /// Drops all ranges, the previous storage is kept alive by the driver while in use
+    void Clear();
+
+    static constexpr GLintptr NotUploaded = -1;
+
+    /// Ranges that are tracked at most, most of them are seen only once
+    static constexpr std::size_t MaxEntries = 0x4000;
+
+    struct Entry {
+        u64 hash;
+        GLintptr offset;
+    };
+
+    OGLBuffer buffer;
+    std::size_t buffer_size;
+    std::size_t used_size = 0;
+    std::unordered_map<u64, Entry> entries;
+    u64 generation = 0;
+    u64 num_hits = 0;
+    u64 uploaded_bytes = 0;
+};
+
+} // namespace OpenGL
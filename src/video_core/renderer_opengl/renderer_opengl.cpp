@@ -14,6 +14,7 @@
 #include "core/hw/lcd.h"
 #include "core/memory.h"
 #include "core/tracer/recorder.h"
+#include "video_core/compile_report.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/gl_shader_util.h"
@@ -57,8 +58,10 @@ public:
     std::queue<Frontend::Frame*> free_queue{};
     std::deque<Frontend::Frame*> present_queue{};
     Frontend::Frame* previous_frame = nullptr;
+    std::shared_ptr<VideoCore::FramePacer> frame_pacer;
 
-    OGLTextureMailbox() {
+    explicit OGLTextureMailbox(std::shared_ptr<VideoCore::FramePacer> frame_pacer_ = nullptr)
+        : frame_pacer{std::move(frame_pacer_)} {
         for (auto& frame : swap_chain) {
             free_queue.push(&frame);
         }
@@ -133,6 +136,9 @@ public:
     }
 
     void ReleaseRenderFrame(Frontend::Frame* frame) override {
+        if (frame_pacer) {
+            frame->queued_time = frame_pacer->FrameQueued();
+        }
         std::unique_lock<std::mutex> lock(swap_chain_lock);
         present_queue.push_front(frame);
         present_cv.notify_one();
@@ -155,6 +161,12 @@ public:
         }
         present_queue.clear();
         previous_frame = frame;
+
+        // The frontend swaps right after taking the frame, so this is as close to the actual
+        // present as the mailbox gets
+        if (frame_pacer) {
+            frame_pacer->FramePresented(frame->queued_time);
+        }
     }
 
     Frontend::Frame* TryGetPresentFrame(int timeout_ms) override {
@@ -288,7 +300,8 @@ RendererOpenGL::RendererOpenGL(Core::System& system_, Frontend::EmuWindow& windo
 
     InitOpenGLObjects();
 
-    window.mailbox = std::make_unique<OGLTextureMailbox>();
+    frame_pacer = std::make_shared<VideoCore::FramePacer>();
+    window.mailbox = std::make_unique<OGLTextureMailbox>(frame_pacer);
     if (secondary_window) {
         secondary_window->mailbox = std::make_unique<OGLTextureMailbox>();
     }
@@ -297,11 +310,50 @@ RendererOpenGL::RendererOpenGL(Core::System& system_, Frontend::EmuWindow& windo
 
 RendererOpenGL::~RendererOpenGL() = default;
 
+void RendererOpenGL::UpdateDynamicResolution() {
+    // Timer queries are optional on GLES, leave the scale alone there
+    if (!Settings::values.dynamic_resolution.GetValue() || driver.IsOpenGLES()) {
+        if (frame_query_active) {
+            glEndQuery(GL_TIME_ELAPSED);
+            frame_query_active = false;
+        }
+        VideoCore::g_dynamic_resolution_scale = 0;
+        return;
+    }
+
+    if (frame_query_active) {
+        glEndQuery(GL_TIME_ELAPSED);
+        frame_query_index = (frame_query_index + 1) % frame_queries.size();
+    }
+
+    // The next query is the oldest one, its result is usually available by now. A query that
+    // isn't ready is restarted and the frame is left out of the measurements.
+    OGLQuery& query = frame_queries[frame_query_index];
+    if (query.handle == 0) {
+        query.Create();
+    } else {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(query.handle, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query.handle, GL_QUERY_RESULT, &elapsed);
+            const u16 min_scale = Settings::values.dynamic_resolution_min.GetValue();
+            const u16 max_scale = VideoCore::GetResolutionScaleFactor();
+            VideoCore::g_dynamic_resolution_scale =
+                dynamic_resolution.Update(std::chrono::nanoseconds{elapsed}, min_scale, max_scale);
+        }
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query.handle);
+    frame_query_active = true;
+}
+
 void RendererOpenGL::SwapBuffers() {
     // Maintain the rasterizer's state as a priority
     OpenGLState prev_state = OpenGLState::GetCurState();
     state.Apply();
 
+    UpdateDynamicResolution();
     PrepareRendertarget();
     RenderScreenshot();
 
@@ -325,11 +377,22 @@ void RendererOpenGL::SwapBuffers() {
     }
 
     m_current_frame++;
+    rasterizer.TickFrame();
+    VideoCore::g_compile_report.TickFrame();
+    if (const auto gpu_time = rasterizer.GetGPUTimer().EndFrame()) {
+        system.perf_stats->RecordGpuTime(*gpu_time);
+    }
     system.perf_stats->EndSystemFrame();
 
     render_window.PollEvents();
 
-    system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    {
+        Core::PerfStats::SubsystemTimer timer{system.perf_stats.get(),
+                                              Core::PerfStats::Subsystem::FrameLimiter};
+        system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    }
+    frame_pacer->Pace(Settings::values.low_latency_pacing.GetValue());
+    system.perf_stats->RecordPresentLatency(frame_pacer->GetPresentLatency());
     system.perf_stats->BeginSystemFrame();
 
     prev_state.Apply();
@@ -1054,7 +1117,7 @@ void RendererOpenGL::DrawBottomScreen(const Layout::FramebufferLayout& layout,
 
 void RendererOpenGL::TryPresent(int timeout_ms, bool is_secondary) {
     const auto& window = is_secondary ? *secondary_window : render_window;
-    const auto& layout = window.GetFramebufferLayout();
+    const auto layout = window.GetFramebufferLayout();
     auto frame = window.mailbox->TryGetPresentFrame(timeout_ms);
     if (!frame) {
         LOG_DEBUG(Render_OpenGL, "TryGetPresentFrame returned no frame to present");
@@ -5,7 +5,10 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include "core/hw/gpu.h"
+#include "video_core/dynamic_resolution.h"
+#include "video_core/frame_pacer.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_opengl/frame_dumper_opengl.h"
 #include "video_core/renderer_opengl/gl_driver.h"
@@ -34,6 +37,9 @@ struct Frame {
     OpenGL::OGLFramebuffer present{}; /// FBO created on the present thread
     OpenGL::OGLSync render_fence{};   /// Fence created on the render thread
     OpenGL::OGLSync present_fence{};  /// Fence created on the presentation thread
+
+    /// Point when the render thread released the frame for presentation
+    VideoCore::FramePacer::Clock::time_point queued_time{};
 };
 } // namespace Frontend
 
@@ -87,6 +93,7 @@ private:
     void ReloadShader();
     void PrepareRendertarget();
     void RenderScreenshot();
+    void UpdateDynamicResolution();
     void RenderToMailbox(const Layout::FramebufferLayout& layout,
                          std::unique_ptr<Frontend::TextureMailbox>& mailbox, bool flipped);
     void ConfigureFramebufferTexture(TextureInfo& texture,
@@ -138,6 +145,14 @@ private:
     Driver driver;
     OpenGLState state;
     RasterizerOpenGL rasterizer;
+    /// Shared with the main window mailbox, which may outlive the renderer
+    std::shared_ptr<VideoCore::FramePacer> frame_pacer;
+
+    /// GPU time of the last frames, read back a few frames later to avoid stalling
+    std::array<OGLQuery, 3> frame_queries;
+    std::size_t frame_query_index = 0;
+    bool frame_query_active = false;
+    VideoCore::DynamicResolution dynamic_resolution;
 
     // OpenGL object IDs
     OGLVertexArray vertex_array;
@@ -14,6 +14,7 @@
 #include "core/hw/hw.h"
 #include "core/hw/lcd.h"
 #include "core/tracer/recorder.h"
+#include "video_core/compile_report.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/renderer_vulkan/renderer_vulkan.h"
 #include "video_core/renderer_vulkan/vk_platform.h"
@@ -118,7 +119,8 @@ RendererVulkan::RendererVulkan(Core::System& system_, Frontend::EmuWindow& windo
     CompileShaders();
     BuildLayouts();
     BuildPipelines();
-    mailbox = std::make_unique<PresentMailbox>(instance, swapchain, scheduler, renderpass_cache);
+    mailbox = std::make_unique<PresentMailbox>(instance, swapchain, scheduler, renderpass_cache,
+                                               frame_pacer);
 }
 
 RendererVulkan::~RendererVulkan() {
@@ -218,6 +220,7 @@ void RendererVulkan::RenderToMailbox(const Layout::FramebufferLayout& layout,
     DrawScreens(frame, layout, flipped);
 
     scheduler.Flush(frame->render_ready);
+    frame->queued_time = frame_pacer.FrameQueued();
     scheduler.Record([&mailbox, frame](vk::CommandBuffer) { mailbox->Present(frame); });
     scheduler.DispatchWork();
 }
@@ -968,11 +971,19 @@ void RendererVulkan::SwapBuffers() {
     RenderToMailbox(layout, mailbox, false);
 
     m_current_frame++;
+    rasterizer.TickFrame();
+    VideoCore::g_compile_report.TickFrame();
 
     system.perf_stats->EndSystemFrame();
     render_window.PollEvents();
 
-    system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    {
+        Core::PerfStats::SubsystemTimer timer{system.perf_stats.get(),
+                                              Core::PerfStats::Subsystem::FrameLimiter};
+        system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    }
+    frame_pacer.Pace(Settings::values.low_latency_pacing.GetValue());
+    system.perf_stats->RecordPresentLatency(frame_pacer.GetPresentLatency());
     system.perf_stats->BeginSystemFrame();
 
     if (Pica::g_debug_context && Pica::g_debug_context->recorder) {
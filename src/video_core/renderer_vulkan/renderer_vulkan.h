@@ -11,6 +11,7 @@
 #include "common/common_types.h"
 #include "common/math_util.h"
 #include "core/hw/gpu.h"
+#include "video_core/frame_pacer.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_vulkan/vk_descriptor_manager.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -138,6 +139,7 @@ private:
     Swapchain swapchain;
     StreamBuffer vertex_buffer;
     RasterizerVulkan rasterizer;
+    VideoCore::FramePacer frame_pacer;
     std::unique_ptr<PresentMailbox> mailbox;
 
     /// Present pipelines (Normal, Anaglyph, Interlaced)
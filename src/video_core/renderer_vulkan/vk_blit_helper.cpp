@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "common/vector_math.h"
+#include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_vulkan/vk_blit_helper.h"
 #include "video_core/renderer_vulkan/vk_descriptor_manager.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -12,6 +13,7 @@
 #include "video_core/renderer_vulkan/vk_texture_runtime.h"
 
 #include "video_core/host_shaders/full_screen_triangle_vert_spv.h"
+#include "video_core/host_shaders/texture_codec_comp_spv.h"
 #include "video_core/host_shaders/vulkan_blit_depth_stencil_frag_spv.h"
 #include "video_core/host_shaders/vulkan_d32s8_to_r32_comp_spv.h"
 
@@ -60,6 +62,28 @@ inline constexpr vk::PushConstantRange COMPUTE_PUSH_CONSTANT_RANGE{
     .size = sizeof(Common::Vec2i),
 };
 
+constexpr vk::DescriptorSetLayoutBinding CODEC_DESCRIPTOR_SET_BINDING =
+    TEXTURE_DESC_LAYOUT<0, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute>;
+constexpr vk::DescriptorSetLayoutCreateInfo CODEC_DESCRIPTOR_SET_LAYOUT_CREATE_INFO{
+    .bindingCount = 1,
+    .pBindings = &CODEC_DESCRIPTOR_SET_BINDING,
+};
+constexpr std::array CODEC_UPDATE_TEMPLATES = {
+    vk::DescriptorUpdateTemplateEntry{
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .offset = 0,
+        .stride = sizeof(vk::DescriptorBufferInfo),
+    },
+};
+inline constexpr vk::PushConstantRange CODEC_PUSH_CONSTANT_RANGE{
+    .stageFlags = vk::ShaderStageFlagBits::eCompute,
+    .offset = 0,
+    .size = sizeof(VideoCore::TextureCodecParams),
+};
+
 constexpr std::array TWO_TEXTURES_DESCRIPTOR_SET_LAYOUT_BINDINGS{
     TEXTURE_DESC_LAYOUT<0, vk::DescriptorType::eCombinedImageSampler,
                         vk::ShaderStageFlagBits::eFragment>,
@@ -234,18 +258,29 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_,
           device.createDescriptorSetLayout(COMPUTE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO)},
       two_textures_descriptor_layout{
           device.createDescriptorSetLayout(TWO_TEXTURES_DESCRIPTOR_SET_LAYOUT_CREATE_INFO)},
+      codec_descriptor_layout{
+          device.createDescriptorSetLayout(CODEC_DESCRIPTOR_SET_LAYOUT_CREATE_INFO)},
       compute_update_template{device.createDescriptorUpdateTemplate(
           DescriptorUpdateTemplateCreateInfo(COMPUTE_UPDATE_TEMPLATES, compute_descriptor_layout))},
       two_textures_update_template{
           device.createDescriptorUpdateTemplate(DescriptorUpdateTemplateCreateInfo(
               TWO_TEXTURES_UPDATE_TEMPLATES, two_textures_descriptor_layout))},
+      codec_update_template{device.createDescriptorUpdateTemplate(
+          DescriptorUpdateTemplateCreateInfo(CODEC_UPDATE_TEMPLATES, codec_descriptor_layout))},
       compute_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&compute_descriptor_layout, true))},
       two_textures_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&two_textures_descriptor_layout))},
+      codec_pipeline_layout{device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+          .setLayoutCount = 1,
+          .pSetLayouts = &codec_descriptor_layout,
+          .pushConstantRangeCount = 1,
+          .pPushConstantRanges = &CODEC_PUSH_CONSTANT_RANGE,
+      })},
       full_screen_vert{CompileSPV(FULL_SCREEN_TRIANGLE_VERT_SPV, device)},
       copy_d24s8_to_r32_comp{CompileSPV(VULKAN_D32S8_TO_R32_COMP_SPV, device)},
       blit_depth_stencil_frag{CompileSPV(VULKAN_BLIT_DEPTH_STENCIL_FRAG_SPV, device)},
+      texture_codec_comp{CompileSPV(TEXTURE_CODEC_COMP_SPV, device)},
       depth_blit_pipeline{MakeDepthStencilBlitPipeline()},
       linear_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eLinear>)},
       nearest_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eNearest>)} {
@@ -255,14 +290,19 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_,
 BlitHelper::~BlitHelper() {
     device.destroyPipelineLayout(compute_pipeline_layout);
     device.destroyPipelineLayout(two_textures_pipeline_layout);
+    device.destroyPipelineLayout(codec_pipeline_layout);
     device.destroyDescriptorUpdateTemplate(compute_update_template);
     device.destroyDescriptorUpdateTemplate(two_textures_update_template);
+    device.destroyDescriptorUpdateTemplate(codec_update_template);
     device.destroyDescriptorSetLayout(compute_descriptor_layout);
     device.destroyDescriptorSetLayout(two_textures_descriptor_layout);
+    device.destroyDescriptorSetLayout(codec_descriptor_layout);
     device.destroyShaderModule(full_screen_vert);
     device.destroyShaderModule(copy_d24s8_to_r32_comp);
     device.destroyShaderModule(blit_depth_stencil_frag);
+    device.destroyShaderModule(texture_codec_comp);
     device.destroyPipeline(copy_d24s8_to_r32_pipeline);
+    device.destroyPipeline(texture_codec_pipeline);
     device.destroyPipeline(depth_blit_pipeline);
     device.destroySampler(linear_sampler);
     device.destroySampler(nearest_sampler);
@@ -340,7 +380,7 @@ bool BlitHelper::BlitDepthStencil(Surface& source, Surface& dest,
         BindBlitState(cmdbuf, layout, blit);
         cmdbuf.draw(3, 1, 0, 0);
     });
-    scheduler.MakeDirty(StateFlags::Pipeline);
+    scheduler.MakeDirty(StateFlags::Pipeline | StateFlags::DescriptorSets);
     return true;
 }
 
@@ -460,6 +500,50 @@ void BlitHelper::BlitD24S8ToR32(Surface& source, Surface& dest,
     });
 }
 
+void BlitHelper::RunTextureCodec(vk::Buffer buffer, const VideoCore::TextureCodecParams& params) {
+    const vk::DescriptorBufferInfo buffer_info = {
+        .buffer = buffer,
+        .offset = 0,
+        .range = VK_WHOLE_SIZE,
+    };
+
+    vk::DescriptorSet set = desc_manager.AllocateSet(codec_descriptor_layout);
+    device.updateDescriptorSetWithTemplate(set, codec_update_template, buffer_info);
+
+    renderpass_cache.EndRendering();
+    scheduler.Record([this, set, params](vk::CommandBuffer cmdbuf) {
+        // Decoding reads what the host wrote and feeds the buffer to image copy, encoding reads
+        // the texels copied from the image and is read back by the host
+        const bool encode = params.flags & VideoCore::TextureCodecParams::Encode;
+        const vk::MemoryBarrier pre_barrier = {
+            .srcAccessMask =
+                encode ? vk::AccessFlagBits::eTransferWrite : vk::AccessFlagBits::eHostWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+        };
+        const vk::MemoryBarrier post_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask =
+                encode ? vk::AccessFlagBits::eHostRead : vk::AccessFlagBits::eTransferRead,
+        };
+        cmdbuf.pipelineBarrier(encode ? vk::PipelineStageFlagBits::eTransfer
+                                      : vk::PipelineStageFlagBits::eHost,
+                               vk::PipelineStageFlagBits::eComputeShader,
+                               vk::DependencyFlagBits::eByRegion, pre_barrier, {}, {});
+
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, codec_pipeline_layout, 0, set,
+                                  {});
+        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, texture_codec_pipeline);
+        cmdbuf.pushConstants(codec_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+                             sizeof(params), &params);
+        cmdbuf.dispatch((params.count + 63) / 64, 1, 1);
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                               encode ? vk::PipelineStageFlagBits::eHost
+                                      : vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, post_barrier, {}, {});
+    });
+}
+
 void BlitHelper::MakeComputePipelines() {
     const vk::ComputePipelineCreateInfo compute_info = {
         .stage = MakeStages(copy_d24s8_to_r32_comp),
@@ -473,6 +557,19 @@ void BlitHelper::MakeComputePipelines() {
         LOG_CRITICAL(Render_Vulkan, "D24S8->R32 compute pipeline creation failed!");
         UNREACHABLE();
     }
+
+    const vk::ComputePipelineCreateInfo codec_info = {
+        .stage = MakeStages(texture_codec_comp),
+        .layout = codec_pipeline_layout,
+    };
+
+    if (const auto result = device.createComputePipeline({}, codec_info);
+        result.result == vk::Result::eSuccess) {
+        texture_codec_pipeline = result.value;
+    } else {
+        LOG_CRITICAL(Render_Vulkan, "Texture codec compute pipeline creation failed!");
+        UNREACHABLE();
+    }
 }
 
 vk::Pipeline BlitHelper::MakeDepthStencilBlitPipeline() {
@@ -500,7 +597,8 @@ vk::Pipeline BlitHelper::MakeDepthStencilBlitPipeline() {
 
     if (!instance.IsDynamicRenderingSupported()) {
         depth_stencil_info.renderPass =
-            renderpass_cache.GetRenderpass(VideoCore::PixelFormat::Invalid, depth_stencil, false);
+            renderpass_cache.GetRenderpass(VideoCore::PixelFormat::Invalid, depth_stencil, false,
+                                           false);
     }
 
     vk::StructureChain depth_blit_chain = {
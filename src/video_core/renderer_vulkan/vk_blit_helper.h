@@ -9,7 +9,8 @@
 
 namespace VideoCore {
 struct TextureBlit;
-}
+struct TextureCodecParams;
+} // namespace VideoCore
 
 namespace Vulkan {
 
@@ -32,6 +33,9 @@ public:
     void BlitD24S8ToR32(Surface& depth_surface, Surface& r32_surface,
                         const VideoCore::TextureBlit& blit);
 
+    /// Runs the texture codec shader on tiled and linear data stored in the provided buffer
+    void RunTextureCodec(vk::Buffer buffer, const VideoCore::TextureCodecParams& params);
+
 private:
     /// Creates compute pipelines used for blit
     void MakeComputePipelines();
@@ -50,16 +54,21 @@ private:
 
     vk::DescriptorSetLayout compute_descriptor_layout;
     vk::DescriptorSetLayout two_textures_descriptor_layout;
+    vk::DescriptorSetLayout codec_descriptor_layout;
     vk::DescriptorUpdateTemplate compute_update_template;
     vk::DescriptorUpdateTemplate two_textures_update_template;
+    vk::DescriptorUpdateTemplate codec_update_template;
     vk::PipelineLayout compute_pipeline_layout;
     vk::PipelineLayout two_textures_pipeline_layout;
+    vk::PipelineLayout codec_pipeline_layout;
 
     vk::ShaderModule full_screen_vert;
     vk::ShaderModule copy_d24s8_to_r32_comp;
     vk::ShaderModule blit_depth_stencil_frag;
+    vk::ShaderModule texture_codec_comp;
 
     vk::Pipeline copy_d24s8_to_r32_pipeline;
+    vk::Pipeline texture_codec_pipeline;
     vk::Pipeline depth_blit_pipeline;
     vk::Sampler linear_sampler;
     vk::Sampler nearest_sampler;
@@ -64,6 +64,9 @@ constexpr static std::array RASTERIZER_SETS = {
     },
 };
 
+/// The texture set changes the most between draws, it is pushed when the device allows it
+constexpr u32 PUSH_DESCRIPTOR_SET = 1;
+
 constexpr vk::ShaderStageFlags ToVkStageFlags(vk::DescriptorType type) {
     vk::ShaderStageFlags flags;
     switch (type) {
@@ -87,8 +90,9 @@ constexpr vk::ShaderStageFlags ToVkStageFlags(vk::DescriptorType type) {
 }
 
 DescriptorManager::DescriptorManager(const Instance& instance, Scheduler& scheduler)
-    : instance{instance}, scheduler{scheduler}, pool_provider{instance,
-                                                              scheduler.GetMasterSemaphore()} {
+    : instance{instance}, scheduler{scheduler},
+      pool_provider{instance, scheduler.GetMasterSemaphore()},
+      use_push_descriptors{instance.IsPushDescriptorsSupported()} {
     BuildLayouts();
     descriptor_set_dirty.set();
     current_pool = pool_provider.Commit();
@@ -117,6 +121,9 @@ void DescriptorManager::BindDescriptorSets() {
 
     // Update any dirty descriptor sets
     for (u32 i = 0; i < MAX_DESCRIPTOR_SETS; i++) {
+        if (use_push_descriptors && i == PUSH_DESCRIPTOR_SET) {
+            continue;
+        }
         if (descriptor_set_dirty[i]) {
             std::vector<vk::DescriptorSet>& cache = set_cache[i];
             if (cache.empty()) {
@@ -133,16 +140,41 @@ void DescriptorManager::BindDescriptorSets() {
         }
     }
 
-    scheduler.Record(
-        [this, offsets = dynamic_offsets, bound_sets = descriptor_sets](vk::CommandBuffer cmdbuf) {
+    if (!use_push_descriptors) {
+        scheduler.Record([this, offsets = dynamic_offsets,
+                          bound_sets = descriptor_sets](vk::CommandBuffer cmdbuf) {
             cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0,
                                       bound_sets, offsets);
         });
+        return;
+    }
+
+    scheduler.Record([this, offsets = dynamic_offsets,
+                      bound_sets = descriptor_sets](vk::CommandBuffer cmdbuf) {
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0,
+                                  bound_sets[0], offsets);
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 2,
+                                  bound_sets[2], {});
+    });
+
+    // Pushed descriptors are lost with the command buffer or when another layout is bound
+    if (descriptor_set_dirty[PUSH_DESCRIPTOR_SET] ||
+        scheduler.IsStateDirty(StateFlags::DescriptorSets)) {
+        scheduler.Record(
+            [this, data = update_data[PUSH_DESCRIPTOR_SET]](vk::CommandBuffer cmdbuf) {
+                cmdbuf.pushDescriptorSetWithTemplateKHR(update_templates[PUSH_DESCRIPTOR_SET],
+                                                        pipeline_layout, PUSH_DESCRIPTOR_SET,
+                                                        &data[0]);
+            });
+        descriptor_set_dirty[PUSH_DESCRIPTOR_SET] = false;
+        scheduler.MarkStateNonDirty(StateFlags::DescriptorSets);
+    }
 }
 
 void DescriptorManager::BuildLayouts() {
     std::array<vk::DescriptorSetLayoutBinding, MAX_DESCRIPTORS> set_bindings;
-    std::array<vk::DescriptorUpdateTemplateEntry, MAX_DESCRIPTORS> update_entries;
+    std::array<std::array<vk::DescriptorUpdateTemplateEntry, MAX_DESCRIPTORS>, MAX_DESCRIPTOR_SETS>
+        update_entries;
 
     const vk::Device device = instance.GetDevice();
     for (u32 i = 0; i < MAX_DESCRIPTOR_SETS; i++) {
@@ -156,7 +188,7 @@ void DescriptorManager::BuildLayouts() {
                 .stageFlags = ToVkStageFlags(type),
             };
 
-            update_entries[j] = vk::DescriptorUpdateTemplateEntry{
+            update_entries[i][j] = vk::DescriptorUpdateTemplateEntry{
                 .dstBinding = j,
                 .dstArrayElement = 0,
                 .descriptorCount = 1,
@@ -166,19 +198,14 @@ void DescriptorManager::BuildLayouts() {
             };
         }
 
+        const bool is_push_set = use_push_descriptors && i == PUSH_DESCRIPTOR_SET;
         const vk::DescriptorSetLayoutCreateInfo layout_info = {
+            .flags = is_push_set ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR
+                                 : vk::DescriptorSetLayoutCreateFlags{},
             .bindingCount = set.binding_count,
             .pBindings = set_bindings.data(),
         };
         descriptor_set_layouts[i] = device.createDescriptorSetLayout(layout_info);
-
-        const vk::DescriptorUpdateTemplateCreateInfo template_info = {
-            .descriptorUpdateEntryCount = set.binding_count,
-            .pDescriptorUpdateEntries = update_entries.data(),
-            .templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet,
-            .descriptorSetLayout = descriptor_set_layouts[i],
-        };
-        update_templates[i] = device.createDescriptorUpdateTemplate(template_info);
     }
 
     const vk::PipelineLayoutCreateInfo layout_info = {
@@ -188,6 +215,22 @@ void DescriptorManager::BuildLayouts() {
         .pPushConstantRanges = nullptr,
     };
     pipeline_layout = device.createPipelineLayout(layout_info);
+
+    // Push descriptor templates reference the pipeline layout, so they are created last
+    for (u32 i = 0; i < MAX_DESCRIPTOR_SETS; i++) {
+        const bool is_push_set = use_push_descriptors && i == PUSH_DESCRIPTOR_SET;
+        const vk::DescriptorUpdateTemplateCreateInfo template_info = {
+            .descriptorUpdateEntryCount = RASTERIZER_SETS[i].binding_count,
+            .pDescriptorUpdateEntries = update_entries[i].data(),
+            .templateType = is_push_set ? vk::DescriptorUpdateTemplateType::ePushDescriptorsKHR
+                                        : vk::DescriptorUpdateTemplateType::eDescriptorSet,
+            .descriptorSetLayout = descriptor_set_layouts[i],
+            .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+            .pipelineLayout = pipeline_layout,
+            .set = i,
+        };
+        update_templates[i] = device.createDescriptorUpdateTemplate(template_info);
+    }
 }
 
 std::vector<vk::DescriptorSet> DescriptorManager::AllocateSets(vk::DescriptorSetLayout layout,
@@ -65,6 +65,7 @@ private:
     const Instance& instance;
     Scheduler& scheduler;
     DescriptorPool pool_provider;
+    bool use_push_descriptors;
     vk::PipelineLayout pipeline_layout;
     vk::DescriptorPool current_pool;
     std::array<u32, 2> dynamic_offsets{};
@@ -613,10 +613,12 @@ bool Instance::CreateDevice() {
         vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR,
         vk::PhysicalDeviceCustomBorderColorFeaturesEXT, vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT,
-        vk::PhysicalDeviceDynamicRenderingFeaturesKHR>();
+        vk::PhysicalDeviceDynamicRenderingFeaturesKHR,
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
     const vk::StructureChain properties_chain =
         physical_device.getProperties2<vk::PhysicalDeviceProperties2,
-                                       vk::PhysicalDevicePortabilitySubsetPropertiesKHR>();
+                                       vk::PhysicalDevicePortabilitySubsetPropertiesKHR,
+                                       vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
 
     // Not having geometry shaders will cause issues with accelerated rendering.
     features = feature_chain.get().features;
@@ -659,6 +661,8 @@ bool Instance::CreateDevice() {
     image_format_list = AddExtension(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME);
     pipeline_creation_feedback = AddExtension(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
     shader_stencil_export = AddExtension(VK_EXT_SHADER_STENCIL_EXPORT_EXTENSION_NAME);
+    memory_budget = AddExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    push_descriptors = AddExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
     bool has_portability_subset = AddExtension(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME);
     bool has_dynamic_rendering = AddExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
     bool has_extended_dynamic_state =
@@ -673,6 +677,9 @@ bool Instance::CreateDevice() {
     bool has_index_type_uint8 = AddExtension(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME);
     bool has_pipeline_creation_cache_control =
         AddExtension(VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME);
+    bool has_graphics_pipeline_library =
+        AddExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        AddExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
 
     // Search queue families for graphics and present queues
     auto family_properties = physical_device.getQueueFamilyProperties();
@@ -758,6 +765,7 @@ bool Instance::CreateDevice() {
         vk::PhysicalDeviceCustomBorderColorFeaturesEXT{},
         vk::PhysicalDeviceIndexTypeUint8FeaturesEXT{},
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT{},
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT{},
     };
 
 #define PROP_GET(structName, prop, property) property = properties_chain.get<structName>().prop;
@@ -838,6 +846,15 @@ bool Instance::CreateDevice() {
         device_chain.unlink<vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT>();
     }
 
+    if (has_graphics_pipeline_library) {
+        FEAT_SET(vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, graphicsPipelineLibrary,
+                 graphics_pipeline_library)
+        PROP_GET(vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+                 graphicsPipelineLibraryFastLinking, graphics_pipeline_library_fast_linking)
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+    }
+
 #undef PROP_GET
 #undef FEAT_SET
 
@@ -864,6 +881,7 @@ void Instance::CreateAllocator() {
     };
 
     const VmaAllocatorCreateInfo allocator_info = {
+        .flags = memory_budget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
         .physicalDevice = physical_device,
         .device = device,
         .pVulkanFunctions = &functions,
@@ -875,6 +893,25 @@ void Instance::CreateAllocator() {
         LOG_CRITICAL(Render_Vulkan, "Failed to initialize VMA with error {}", result);
         UNREACHABLE();
     }
+
+    // Pick the largest heap with a memory type that is both device local and host visible
+    constexpr vk::MemoryPropertyFlags host_visible_device_local =
+        vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible;
+    const vk::PhysicalDeviceMemoryProperties memory_properties =
+        physical_device.getMemoryProperties();
+    vk::DeviceSize heap_size = 0;
+    for (u32 i = 0; i < memory_properties.memoryTypeCount; i++) {
+        const vk::MemoryType& type = memory_properties.memoryTypes[i];
+        const vk::DeviceSize size = memory_properties.memoryHeaps[type.heapIndex].size;
+        if ((type.propertyFlags & host_visible_device_local) == host_visible_device_local &&
+            size > heap_size) {
+            host_visible_device_local_heap = type.heapIndex;
+            heap_size = size;
+        }
+    }
+    if (host_visible_device_local_heap) {
+        LOG_INFO(Render_Vulkan, "Host visible device local heap: {} MiB", heap_size >> 20);
+    }
 }
 
 void Instance::CollectTelemetryParameters() {
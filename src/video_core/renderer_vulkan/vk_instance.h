@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <optional>
 #include <span>
 #include <vector>
 #include "video_core/rasterizer_cache/pixel_format.h"
@@ -194,6 +195,22 @@ public:
         return shader_stencil_export;
     }
 
+    /// Returns true when VK_EXT_memory_budget is supported
+    bool IsMemoryBudgetSupported() const {
+        return memory_budget;
+    }
+
+    /// Returns the index of the device local heap the host can map, the BAR window on discrete
+    /// GPUs or all of the video memory with resizable BAR
+    std::optional<u32> GetHostVisibleDeviceLocalHeap() const {
+        return host_visible_device_local_heap;
+    }
+
+    /// Returns true when pipelines can be fast linked from VK_EXT_graphics_pipeline_library parts
+    bool IsGraphicsPipelineLibrarySupported() const {
+        return graphics_pipeline_library && graphics_pipeline_library_fast_linking;
+    }
+
     /// Returns true if VK_EXT_debug_utils is supported
     bool IsExtDebugUtilsSupported() const {
         return debug_messenger_supported;
@@ -340,6 +357,10 @@ private:
     bool pipeline_creation_cache_control{};
     bool pipeline_creation_feedback{};
     bool shader_stencil_export{};
+    bool memory_budget{};
+    std::optional<u32> host_visible_device_local_heap;
+    bool graphics_pipeline_library{};
+    bool graphics_pipeline_library_fast_linking{};
     bool enable_validation{};
     bool dump_command_buffers{};
     bool debug_messenger_supported{};
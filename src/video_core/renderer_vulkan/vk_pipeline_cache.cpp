@@ -2,12 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <span>
 #include <boost/container/static_vector.hpp>
 #include "common/common_paths.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/scm_rev.h"
 #include "common/settings.h"
+#include "core/core.h"
+#include "core/loader/loader.h"
+#include "video_core/compile_report.h"
 #include "video_core/renderer_vulkan/pica_to_vk.h"
 #include "video_core/renderer_vulkan/vk_descriptor_manager.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -22,6 +30,41 @@ MICROPROFILE_DEFINE(Vulkan_Bind, "Vulkan", "Pipeline Bind", MP_RGB(192, 32, 32))
 
 namespace Vulkan {
 
+/// Identifies the pipeline list format, bump when its layout changes
+constexpr u32 PIPELINE_LIST_VERSION = 2;
+
+struct PipelineListHeader {
+    u32 version;
+    u32 vs_config_size;
+    u32 fs_config_size;
+    u32 gs_config_size;
+    u32 pipeline_info_size;
+    u64 shader_cache_version;
+
+    auto operator<=>(const PipelineListHeader&) const noexcept = default;
+};
+
+PipelineListHeader MakePipelineListHeader() {
+    return PipelineListHeader{
+        .version = PIPELINE_LIST_VERSION,
+        .vs_config_size = sizeof(PicaVSConfig),
+        .fs_config_size = sizeof(PicaFSConfig),
+        .gs_config_size = sizeof(PicaFixedGSConfig),
+        .pipeline_info_size = sizeof(PipelineInfo),
+        .shader_cache_version = Common::ComputeHash64(
+            Common::g_shader_cache_version, std::strlen(Common::g_shader_cache_version)),
+    };
+}
+
+u64 PipelineHash(const Instance& instance, const PipelineInfo& info,
+                 const std::array<u64, MAX_SHADER_STAGES>& shader_hashes) {
+    u64 shader_hash = 0;
+    for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
+        shader_hash = Common::HashCombine(shader_hash, shader_hashes[i]);
+    }
+    return Common::HashCombine(shader_hash, info.Hash(instance));
+}
+
 u32 AttribBytes(Pica::PipelineRegs::VertexAttributeFormat format, u32 size) {
     switch (format) {
     case Pica::PipelineRegs::VertexAttributeFormat::FLOAT:
@@ -62,6 +105,27 @@ vk::ShaderStageFlagBits MakeShaderStage(std::size_t index) {
     return vk::ShaderStageFlagBits::eVertex;
 }
 
+/// SPIR-V vertex programs are stored as raw words, GLSL ones can never start with the magic
+constexpr u32 SPIRV_MAGIC = 0x07230203;
+
+bool IsSpirvProgram(std::string_view program) {
+    u32 magic{};
+    if (program.size() < sizeof(magic) || program.size() % sizeof(u32) != 0) {
+        return false;
+    }
+    std::memcpy(&magic, program.data(), sizeof(magic));
+    return magic == SPIRV_MAGIC;
+}
+
+std::vector<u32> CompileVertexProgram(std::string_view program) {
+    if (!IsSpirvProgram(program)) {
+        return CompileGLSL(program, vk::ShaderStageFlagBits::eVertex, ShaderOptimization::High);
+    }
+    std::vector<u32> code(program.size() / sizeof(u32));
+    std::memcpy(code.data(), program.data(), program.size());
+    return code;
+}
+
 u64 PipelineInfo::Hash(const Instance& instance) const {
     u64 info_hash = 0;
     const auto AppendHash = [&info_hash](const auto& data) {
@@ -98,39 +162,88 @@ PipelineCache::Shader::Shader(const Instance& instance) : device{instance.GetDev
 PipelineCache::Shader::Shader(const Instance& instance, vk::ShaderStageFlagBits stage,
                               std::string code)
     : Shader{instance} {
-    module = Compile(code, stage, instance.GetDevice(), ShaderOptimization::High);
+    SetCode(CompileGLSL(code, stage, ShaderOptimization::High));
     MarkDone();
 }
 
+void PipelineCache::Shader::SetCode(std::vector<u32> code) {
+    spirv = std::move(code);
+    if (!spirv.empty()) {
+        module = CompileSPV(spirv, device);
+    }
+}
+
 PipelineCache::Shader::~Shader() {
     if (module && device) {
         device.destroyShaderModule(module);
     }
 }
 
+PipelineCache::PipelineLibrary::PipelineLibrary(const Instance& instance)
+    : device{instance.GetDevice()} {}
+
+PipelineCache::PipelineLibrary::~PipelineLibrary() {
+    if (pipeline) {
+        device.destroyPipeline(pipeline);
+    }
+}
+
 PipelineCache::GraphicsPipeline::GraphicsPipeline(
     const Instance& instance_, RenderpassCache& renderpass_cache_, const PipelineInfo& info_,
-    vk::PipelineCache pipeline_cache_, vk::PipelineLayout layout_, std::array<Shader*, 3> stages_,
-    Common::ThreadWorker* worker_)
+    u64 hash_, vk::PipelineCache pipeline_cache_, vk::PipelineLayout layout_,
+    std::array<Shader*, 3> stages_, PipelineLibraries libraries_, Common::ThreadWorker* worker_)
     : instance{instance_}, renderpass_cache{renderpass_cache_}, worker{worker_},
-      pipeline_layout{layout_}, pipeline_cache{pipeline_cache_}, info{info_}, stages{stages_} {
+      pipeline_layout{layout_}, pipeline_cache{pipeline_cache_}, info{info_}, hash{hash_},
+      stages{stages_}, libraries{libraries_} {
+    using VideoCore::CompileEventType;
+    using VideoCore::ScopedCompileEvent;
+
+    // Linking ready libraries is fast enough to do right away
+    if (libraries[0]) {
+        const bool libraries_done = std::ranges::all_of(
+            libraries, [](const PipelineLibrary* library) { return library->IsDone(); });
+        if (libraries_done || !worker) {
+            const ScopedCompileEvent event{CompileEventType::VKPipelineLink, hash, true};
+            Link(false);
+        } else {
+            worker->QueueWork([this] {
+                const ScopedCompileEvent event{CompileEventType::VKPipelineLink, hash, false};
+                Link(false);
+            });
+        }
+        return;
+    }
 
     // Ask the driver if it can give us the pipeline quickly
-    if (ShouldTryCompile() && Build(true)) {
-        return;
+    if (ShouldTryCompile()) {
+        ScopedCompileEvent event{CompileEventType::VKPipelineBuild, hash, true};
+        if (Build(true)) {
+            return;
+        }
+        event.Discard();
     }
 
     // Fallback to (a)synchronous compilation
     if (worker) {
-        worker->QueueWork([this] { Build(); });
+        worker->QueueWork([this] {
+            const ScopedCompileEvent event{CompileEventType::VKPipelineBuild, hash, false};
+            Build();
+        });
     } else {
+        Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                              Core::PerfStats::Subsystem::ShaderCompile};
+        const ScopedCompileEvent event{CompileEventType::VKPipelineBuild, hash, true};
         Build();
     }
 }
 
 PipelineCache::GraphicsPipeline::~GraphicsPipeline() {
+    const vk::Device device = instance.GetDevice();
     if (pipeline) {
-        instance.GetDevice().destroyPipeline(pipeline);
+        device.destroyPipeline(pipeline);
+    }
+    if (fast_pipeline) {
+        device.destroyPipeline(fast_pipeline);
     }
 }
 
@@ -149,11 +262,38 @@ bool PipelineCache::GraphicsPipeline::ShouldTryCompile() {
     return true;
 }
 
-bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
-    MICROPROFILE_SCOPE(Vulkan_Pipeline);
-    const vk::Device device = instance.GetDevice();
+/**
+ * Fixed function state of a pipeline, shared by monolithic pipelines and pipeline libraries.
+ * The create infos point into the object, so it can be neither copied nor moved.
+ */
+struct PipelineState {
+    explicit PipelineState(const Instance& instance, RenderpassCache& renderpass_cache,
+                           const PipelineInfo& info);
+
+    PipelineState(const PipelineState&) = delete;
+    PipelineState& operator=(const PipelineState&) = delete;
 
     std::array<vk::VertexInputBindingDescription, MAX_VERTEX_BINDINGS> bindings;
+    std::array<vk::VertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> attributes;
+    vk::PipelineVertexInputStateCreateInfo vertex_input_info;
+    vk::PipelineInputAssemblyStateCreateInfo input_assembly;
+    vk::PipelineRasterizationStateCreateInfo raster_state;
+    vk::PipelineMultisampleStateCreateInfo multisampling;
+    vk::PipelineColorBlendAttachmentState colorblend_attachment;
+    vk::PipelineColorBlendStateCreateInfo color_blending;
+    vk::Viewport viewport;
+    vk::Rect2D scissor;
+    vk::PipelineViewportStateCreateInfo viewport_info;
+    boost::container::static_vector<vk::DynamicState, 20> dynamic_states;
+    vk::PipelineDynamicStateCreateInfo dynamic_info;
+    vk::PipelineDepthStencilStateCreateInfo depth_info;
+    vk::Format color_format;
+    vk::PipelineRenderingCreateInfoKHR rendering_info;
+    vk::RenderPass renderpass;
+};
+
+PipelineState::PipelineState(const Instance& instance, RenderpassCache& renderpass_cache,
+                             const PipelineInfo& info) {
     for (u32 i = 0; i < info.vertex_layout.binding_count; i++) {
         const auto& binding = info.vertex_layout.bindings[i];
         bindings[i] = vk::VertexInputBindingDescription{
@@ -164,7 +304,6 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         };
     }
 
-    std::array<vk::VertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> attributes;
     for (u32 i = 0; i < info.vertex_layout.attribute_count; i++) {
         const auto& attr = info.vertex_layout.attributes[i];
         const FormatTraits& traits = instance.GetTraits(attr.type, attr.size);
@@ -183,19 +322,19 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         }
     }
 
-    const vk::PipelineVertexInputStateCreateInfo vertex_input_info = {
+    vertex_input_info = vk::PipelineVertexInputStateCreateInfo{
         .vertexBindingDescriptionCount = info.vertex_layout.binding_count,
         .pVertexBindingDescriptions = bindings.data(),
         .vertexAttributeDescriptionCount = info.vertex_layout.attribute_count,
         .pVertexAttributeDescriptions = attributes.data(),
     };
 
-    const vk::PipelineInputAssemblyStateCreateInfo input_assembly = {
+    input_assembly = vk::PipelineInputAssemblyStateCreateInfo{
         .topology = PicaToVK::PrimitiveTopology(info.rasterization.topology),
         .primitiveRestartEnable = false,
     };
 
-    const vk::PipelineRasterizationStateCreateInfo raster_state = {
+    raster_state = vk::PipelineRasterizationStateCreateInfo{
         .depthClampEnable = false,
         .rasterizerDiscardEnable = false,
         .cullMode = PicaToVK::CullMode(info.rasterization.cull_mode),
@@ -204,12 +343,12 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         .lineWidth = 1.0f,
     };
 
-    const vk::PipelineMultisampleStateCreateInfo multisampling = {
+    multisampling = vk::PipelineMultisampleStateCreateInfo{
         .rasterizationSamples = vk::SampleCountFlagBits::e1,
         .sampleShadingEnable = false,
     };
 
-    const vk::PipelineColorBlendAttachmentState colorblend_attachment = {
+    colorblend_attachment = vk::PipelineColorBlendAttachmentState{
         .blendEnable = info.blending.blend_enable,
         .srcColorBlendFactor = PicaToVK::BlendFunc(info.blending.src_color_blend_factor),
         .dstColorBlendFactor = PicaToVK::BlendFunc(info.blending.dst_color_blend_factor),
@@ -220,7 +359,7 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         .colorWriteMask = static_cast<vk::ColorComponentFlags>(info.blending.color_write_mask),
     };
 
-    const vk::PipelineColorBlendStateCreateInfo color_blending = {
+    color_blending = vk::PipelineColorBlendStateCreateInfo{
         .logicOpEnable = !info.blending.blend_enable && !instance.NeedsLogicOpEmulation(),
         .logicOp = PicaToVK::LogicOp(info.blending.logic_op),
         .attachmentCount = 1,
@@ -228,7 +367,7 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         .blendConstants = std::array{1.0f, 1.0f, 1.0f, 1.0f},
     };
 
-    const vk::Viewport viewport = {
+    viewport = vk::Viewport{
         .x = 0.0f,
         .y = 0.0f,
         .width = 1.0f,
@@ -237,19 +376,19 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         .maxDepth = 1.0f,
     };
 
-    const vk::Rect2D scissor = {
+    scissor = vk::Rect2D{
         .offset = {0, 0},
         .extent = {1, 1},
     };
 
-    const vk::PipelineViewportStateCreateInfo viewport_info = {
+    viewport_info = vk::PipelineViewportStateCreateInfo{
         .viewportCount = 1,
         .pViewports = &viewport,
         .scissorCount = 1,
         .pScissors = &scissor,
     };
 
-    boost::container::static_vector<vk::DynamicState, 20> dynamic_states = {
+    dynamic_states = {
         vk::DynamicState::eViewport,           vk::DynamicState::eScissor,
         vk::DynamicState::eStencilCompareMask, vk::DynamicState::eStencilWriteMask,
         vk::DynamicState::eStencilReference,   vk::DynamicState::eBlendConstants,
@@ -280,7 +419,7 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         dynamic_states.push_back(vk::DynamicState::eColorWriteMaskEXT);
     }
 
-    const vk::PipelineDynamicStateCreateInfo dynamic_info = {
+    dynamic_info = vk::PipelineDynamicStateCreateInfo{
         .dynamicStateCount = static_cast<u32>(dynamic_states.size()),
         .pDynamicStates = dynamic_states.data(),
     };
@@ -292,7 +431,7 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         .compareOp = PicaToVK::CompareFunc(info.depth_stencil.stencil_compare_op),
     };
 
-    const vk::PipelineDepthStencilStateCreateInfo depth_info = {
+    depth_info = vk::PipelineDepthStencilStateCreateInfo{
         .depthTestEnable = static_cast<u32>(info.depth_stencil.depth_test_enable.Value()),
         .depthWriteEnable = static_cast<u32>(info.depth_stencil.depth_write_enable.Value()),
         .depthCompareOp = PicaToVK::CompareFunc(info.depth_stencil.depth_compare_op),
@@ -302,6 +441,29 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         .back = stencil_op_state,
     };
 
+    const auto [color, depth] = info.attachments;
+    const auto& color_traits = instance.GetTraits(color);
+    const auto& depth_traits = instance.GetTraits(depth);
+    color_format = color_traits.native;
+    rendering_info = vk::PipelineRenderingCreateInfoKHR{
+        .colorAttachmentCount = color != VideoCore::PixelFormat::Invalid ? 1u : 0u,
+        .pColorAttachmentFormats = &color_format,
+        .depthAttachmentFormat = depth_traits.native,
+        .stencilAttachmentFormat = depth_traits.aspect & vk::ImageAspectFlagBits::eStencil
+                                       ? depth_traits.native
+                                       : vk::Format::eUndefined,
+    };
+
+    if (!instance.IsDynamicRenderingSupported()) {
+        renderpass = renderpass_cache.GetRenderpass(color, depth, false, false);
+    }
+}
+
+bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+    const vk::Device device = instance.GetDevice();
+    const PipelineState state{instance, renderpass_cache, info};
+
     u32 shader_count = 0;
     std::array<vk::PipelineShaderStageCreateInfo, MAX_SHADER_STAGES> shader_stages;
     for (std::size_t i = 0; i < stages.size(); i++) {
@@ -333,31 +495,22 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
     vk::GraphicsPipelineCreateInfo pipeline_info = {
         .stageCount = shader_count,
         .pStages = shader_stages.data(),
-        .pVertexInputState = &vertex_input_info,
-        .pInputAssemblyState = &input_assembly,
-        .pViewportState = &viewport_info,
-        .pRasterizationState = &raster_state,
-        .pMultisampleState = &multisampling,
-        .pDepthStencilState = &depth_info,
-        .pColorBlendState = &color_blending,
-        .pDynamicState = &dynamic_info,
+        .pVertexInputState = &state.vertex_input_info,
+        .pInputAssemblyState = &state.input_assembly,
+        .pViewportState = &state.viewport_info,
+        .pRasterizationState = &state.raster_state,
+        .pMultisampleState = &state.multisampling,
+        .pDepthStencilState = &state.depth_info,
+        .pColorBlendState = &state.color_blending,
+        .pDynamicState = &state.dynamic_info,
         .layout = pipeline_layout,
+        .renderPass = state.renderpass,
     };
 
-    if (!instance.IsDynamicRenderingSupported()) {
-        pipeline_info.renderPass = renderpass_cache.GetRenderpass(
-            info.attachments.color_format, info.attachments.depth_format, false);
-    }
-
     if (fail_on_compile_required) {
         pipeline_info.flags |= vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequiredEXT;
     }
 
-    const auto [color, depth] = info.attachments;
-    const auto& color_traits = instance.GetTraits(color);
-    const auto& depth_traits = instance.GetTraits(depth);
-    const u32 color_attachment_count = color != VideoCore::PixelFormat::Invalid ? 1u : 0u;
-
     vk::StructureChain pipeline_chain = {
         pipeline_info,
         vk::PipelineCreationFeedbackCreateInfoEXT{
@@ -365,14 +518,7 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
             .pipelineStageCreationFeedbackCount = shader_count,
             .pPipelineStageCreationFeedbacks = creation_stage_feedback.data(),
         },
-        vk::PipelineRenderingCreateInfoKHR{
-            .colorAttachmentCount = color_attachment_count,
-            .pColorAttachmentFormats = &color_traits.native,
-            .depthAttachmentFormat = depth_traits.native,
-            .stencilAttachmentFormat = depth_traits.aspect & vk::ImageAspectFlagBits::eStencil
-                                           ? depth_traits.native
-                                           : vk::Format::eUndefined,
-        },
+        state.rendering_info,
     };
 
     if (!instance.IsPipelineCreationFeedbackSupported()) {
@@ -393,26 +539,229 @@ bool PipelineCache::GraphicsPipeline::Build(bool fail_on_compile_required) {
         UNREACHABLE();
     }
 
+    is_optimized.store(true, std::memory_order_release);
     MarkDone();
     return true;
 }
 
+void PipelineCache::GraphicsPipeline::Link(bool optimize) {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+
+    std::array<vk::Pipeline, NUM_LIBRARY_PARTS> library_handles;
+    for (u32 i = 0; i < NUM_LIBRARY_PARTS; i++) {
+        libraries[i]->WaitDone();
+        library_handles[i] = libraries[i]->pipeline;
+    }
+
+    const vk::PipelineLibraryCreateInfoKHR library_info = {
+        .libraryCount = NUM_LIBRARY_PARTS,
+        .pLibraries = library_handles.data(),
+    };
+
+    const vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .pNext = &library_info,
+        .flags = optimize ? vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT
+                          : vk::PipelineCreateFlags{},
+        .layout = pipeline_layout,
+    };
+
+    const vk::ResultValue result =
+        instance.GetDevice().createGraphicsPipeline(pipeline_cache, pipeline_info);
+    if (result.result != vk::Result::eSuccess) {
+        LOG_CRITICAL(Render_Vulkan, "Graphics pipeline linking failed!");
+        UNREACHABLE();
+    }
+
+    if (optimize) {
+        pipeline = result.value;
+        is_optimized.store(true, std::memory_order_release);
+        return;
+    }
+
+    // Draw with the fast linked pipeline until the optimized one replaces it
+    fast_pipeline = result.value;
+    MarkDone();
+    if (worker) {
+        worker->QueueWork([this] {
+            const VideoCore::ScopedCompileEvent event{VideoCore::CompileEventType::VKPipelineLink,
+                                                      hash, false};
+            Link(true);
+        });
+    }
+}
+
+void PipelineCache::BuildLibrary(LibraryPart part, const PipelineInfo& info,
+                                 const std::array<Shader*, MAX_SHADER_STAGES>& stages,
+                                 PipelineLibrary& library) {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+    const PipelineState state{instance, renderpass_cache, info};
+
+    u32 shader_count = 0;
+    std::array<vk::PipelineShaderStageCreateInfo, MAX_SHADER_STAGES> shader_stages;
+    const auto AddStage = [&](u32 index) {
+        if (Shader* shader = stages[index]; shader) {
+            shader->WaitDone();
+            shader_stages[shader_count++] = vk::PipelineShaderStageCreateInfo{
+                .stage = MakeShaderStage(index),
+                .module = shader->Handle(),
+                .pName = "main",
+            };
+        }
+    };
+
+    vk::GraphicsPipelineLibraryCreateInfoEXT library_info{};
+    vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .flags = vk::PipelineCreateFlagBits::eLibraryKHR |
+                 vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT,
+        .pDynamicState = &state.dynamic_info,
+        .layout = desc_manager.GetPipelineLayout(),
+        .renderPass = state.renderpass,
+    };
+
+    switch (part) {
+    case LibraryPart::VertexInput:
+        library_info.flags = vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface;
+        pipeline_info.pVertexInputState = &state.vertex_input_info;
+        pipeline_info.pInputAssemblyState = &state.input_assembly;
+        break;
+    case LibraryPart::PreRasterization:
+        library_info.flags = vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders;
+        AddStage(ProgramType::VS);
+        AddStage(ProgramType::GS);
+        pipeline_info.pViewportState = &state.viewport_info;
+        pipeline_info.pRasterizationState = &state.raster_state;
+        break;
+    case LibraryPart::FragmentShader:
+        library_info.flags = vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader;
+        AddStage(ProgramType::FS);
+        pipeline_info.pMultisampleState = &state.multisampling;
+        pipeline_info.pDepthStencilState = &state.depth_info;
+        break;
+    case LibraryPart::FragmentOutput:
+        library_info.flags = vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface;
+        pipeline_info.pMultisampleState = &state.multisampling;
+        pipeline_info.pColorBlendState = &state.color_blending;
+        break;
+    }
+    pipeline_info.stageCount = shader_count;
+    pipeline_info.pStages = shader_stages.data();
+
+    vk::StructureChain pipeline_chain = {pipeline_info, library_info, state.rendering_info};
+    if (!instance.IsDynamicRenderingSupported()) {
+        pipeline_chain.unlink<vk::PipelineRenderingCreateInfoKHR>();
+    }
+
+    const vk::ResultValue result =
+        instance.GetDevice().createGraphicsPipeline(pipeline_cache, pipeline_chain.get());
+    if (result.result != vk::Result::eSuccess) {
+        LOG_CRITICAL(Render_Vulkan, "Graphics pipeline library creation failed!");
+        UNREACHABLE();
+    }
+
+    library.pipeline = result.value;
+    library.MarkDone();
+}
+
+auto PipelineCache::GetPipelineLibraries(const PipelineInfo& info,
+                                         const std::array<Shader*, MAX_SHADER_STAGES>& stages)
+    -> PipelineLibraries {
+    const auto ShaderKey = [&stages](u32 index) {
+        return static_cast<u64>(reinterpret_cast<uintptr_t>(stages[index]));
+    };
+
+    // Each part is keyed by the state it bakes, which excludes what is set dynamically
+    const bool has_dynamic_rendering = instance.IsDynamicRenderingSupported();
+    const u64 renderpass_key =
+        has_dynamic_rendering ? 0 : Common::ComputeStructHash64(info.attachments);
+    const u64 rasterization_key =
+        instance.IsExtendedDynamicStateSupported() ? 0 : info.rasterization.value;
+    const u64 depth_stencil_key =
+        instance.IsExtendedDynamicStateSupported() ? 0 : info.depth_stencil.value;
+
+    std::array<u64, NUM_LIBRARY_PARTS> keys;
+    keys[LibraryPart::VertexInput] =
+        Common::HashCombine(Common::ComputeStructHash64(info.vertex_layout), rasterization_key);
+    keys[LibraryPart::PreRasterization] =
+        Common::HashCombine(Common::HashCombine(ShaderKey(ProgramType::VS),
+                                                ShaderKey(ProgramType::GS)),
+                            Common::HashCombine(rasterization_key, renderpass_key));
+    keys[LibraryPart::FragmentShader] =
+        Common::HashCombine(Common::HashCombine(ShaderKey(ProgramType::FS), depth_stencil_key),
+                            renderpass_key);
+    // The output interface bakes the same blending state that the pipeline hash covers
+    PipelineInfo output_info{};
+    output_info.attachments = info.attachments;
+    output_info.blending = info.blending;
+    keys[LibraryPart::FragmentOutput] = output_info.Hash(instance);
+
+    PipelineLibraries libraries{};
+    for (u32 part = 0; part < NUM_LIBRARY_PARTS; part++) {
+        const u64 key = Common::HashCombine(keys[part], part);
+        auto [it, new_library] = pipeline_libraries.try_emplace(key);
+        if (new_library) {
+            it->second = std::make_unique<PipelineLibrary>(instance);
+            PipelineLibrary* const library = it->second.get();
+            const auto library_part = static_cast<LibraryPart>(part);
+
+            // The interface parts contain no shaders and are cheap to create
+            if (library_part == LibraryPart::VertexInput ||
+                library_part == LibraryPart::FragmentOutput) {
+                BuildLibrary(library_part, info, stages, *library);
+            } else {
+                workers.QueueWork([this, library_part, info, stages, library] {
+                    BuildLibrary(library_part, info, stages, *library);
+                });
+            }
+        }
+        libraries[part] = it->second.get();
+    }
+    return libraries;
+}
+
+std::unique_ptr<PipelineCache::GraphicsPipeline> PipelineCache::MakePipeline(
+    const PipelineInfo& info, u64 pipeline_hash,
+    const std::array<Shader*, MAX_SHADER_STAGES>& stages) {
+    const PipelineLibraries libraries = instance.IsGraphicsPipelineLibrarySupported()
+                                            ? GetPipelineLibraries(info, stages)
+                                            : PipelineLibraries{};
+    return std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info, pipeline_hash,
+                                              pipeline_cache, desc_manager.GetPipelineLayout(),
+                                              stages, libraries, &workers);
+}
+
 PipelineCache::PipelineCache(const Instance& instance, Scheduler& scheduler,
                              RenderpassCache& renderpass_cache, DescriptorManager& desc_manager)
     : instance{instance}, scheduler{scheduler}, renderpass_cache{renderpass_cache},
-      desc_manager{desc_manager}, workers{std::max(std::thread::hardware_concurrency(), 2U) - 1,
-                                          "Pipeline builder"},
+      desc_manager{desc_manager},
+      workers{Common::GetWorkerThreadCount(std::max(std::thread::hardware_concurrency(), 2U) - 1),
+              "Pipeline builder"},
       trivial_vertex_shader{instance, vk::ShaderStageFlagBits::eVertex,
                             GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported())} {
 }
 
 PipelineCache::~PipelineCache() {
+    // Finish the queued work before the shaders it references are destroyed. It can not be
+    // dropped, a running pipeline build may be waiting on a queued shader or library.
+    workers.WaitForRequests();
+
     vk::Device device = instance.GetDevice();
 
+    LOG_DEBUG(Render_Vulkan, "Created {} pipelines, {} would be needed without dynamic state",
+              graphics_pipelines.size(), baked_state_hashes.size());
+    LOG_DEBUG(Render_Vulkan,
+              "Built {} GLSL vertex shaders in {} us, {} SPIR-V vertex shaders in {} us",
+              glsl_vs_stats.count.load(), glsl_vs_stats.time_us.load(),
+              spirv_vs_stats.count.load(), spirv_vs_stats.time_us.load());
+
     SaveDiskCache();
     device.destroyPipelineCache(pipeline_cache);
 }
 
+void PipelineCache::ShaderGenStats::Add(std::chrono::steady_clock::duration elapsed) {
+    count++;
+    time_us += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
 void PipelineCache::LoadDiskCache() {
     if (!Settings::values.use_disk_shader_cache || !EnsureDirectories()) {
         return;
@@ -449,10 +798,14 @@ void PipelineCache::LoadDiskCache() {
 }
 
 void PipelineCache::SaveDiskCache() {
-    if (!Settings::values.use_disk_shader_cache || !EnsureDirectories()) {
+    // Read only caches may be shared by several instances, pipelines built since stay in memory
+    if (!Settings::values.use_disk_shader_cache || Settings::values.shader_cache_read_only ||
+        !EnsureDirectories()) {
         return;
     }
 
+    SavePipelineList();
+
     const std::string cache_file_path = fmt::format("{}{:x}{:x}.bin", GetPipelineCacheDir(),
                                                     instance.GetVendorID(), instance.GetDeviceID());
     FileUtil::IOFile cache_file{cache_file_path, "wb"};
@@ -471,25 +824,211 @@ void PipelineCache::SaveDiskCache() {
     cache_file.Close();
 }
 
-bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
-    MICROPROFILE_SCOPE(Vulkan_Bind);
+void PipelineCache::WarmUpPipelines(const std::atomic_bool& stop_loading,
+                                    const VideoCore::DiskResourceLoadCallback& callback) {
+    const std::string list_path = GetPipelineListPath();
+    if (!Settings::values.use_disk_shader_cache || list_path.empty()) {
+        return;
+    }
 
-    u64 shader_hash = 0;
-    for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
-        shader_hash = Common::HashCombine(shader_hash, shader_hashes[i]);
+    FileUtil::IOFile file{list_path, "rb"};
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    const auto Read = [&file](auto& object) {
+        return file.ReadBytes(&object, sizeof(object)) == sizeof(object);
+    };
+    const auto ReadCode = [&file, &Read](std::vector<u32>& code) {
+        u32 code_size{};
+        if (!Read(code_size)) {
+            return false;
+        }
+        code.resize(code_size);
+        return file.ReadArray(code.data(), code_size) == code_size;
+    };
+
+    PipelineListHeader header{};
+    if (!Read(header) || header != MakePipelineListHeader()) {
+        LOG_INFO(Render_Vulkan, "Pipeline list is from another version of the emulator - ignoring");
+        return;
+    }
+
+    // Shaders are queued before the pipelines, so no pipeline waits on a shader left in the queue.
+    // Those stored as SPIR-V skip generation and the GLSL compiler, only the driver sees them.
+    std::array<std::unordered_map<u64, Shader*>, MAX_SHADER_STAGES> shaders;
+    u32 count{};
+
+    if (!Read(count)) {
+        return;
+    }
+    for (u32 i = 0; i < count; i++) {
+        std::array<u8, sizeof(PicaVSConfig)> config_data;
+        u32 program_size{};
+        if (!Read(config_data) || !Read(program_size)) {
+            return;
+        }
+        std::string program(program_size, '\0');
+        if (file.ReadBytes(program.data(), program_size) != program_size) {
+            return;
+        }
+
+        const auto config = std::bit_cast<PicaVSConfig>(config_data);
+        auto [iter, new_program] = programmable_vertex_cache.try_emplace(program, instance);
+        auto& shader = iter->second;
+        if (new_program) {
+            shader.program = std::move(program);
+            workers.QueueWork([&shader] {
+                shader.SetCode(CompileVertexProgram(shader.program));
+                shader.MarkDone();
+            });
+        }
+        programmable_vertex_map.try_emplace(config, &shader);
+        shaders[ProgramType::VS].emplace(config.Hash(), &shader);
+    }
+
+    if (!Read(count)) {
+        return;
+    }
+    const bool emit_spirv = Settings::values.spirv_shader_gen.GetValue();
+    for (u32 i = 0; i < count; i++) {
+        std::array<u8, sizeof(PicaFSConfig)> config_data;
+        std::vector<u32> code;
+        if (!Read(config_data) || !ReadCode(code)) {
+            return;
+        }
+
+        const auto config = std::bit_cast<PicaFSConfig>(config_data);
+        auto [it, new_shader] = fragment_shaders.try_emplace(config, instance);
+        auto& shader = it->second;
+        if (new_shader) {
+            workers.QueueWork([config, code = std::move(code), emit_spirv, &shader]() mutable {
+                if (code.empty()) {
+                    code = emit_spirv ? GenerateFragmentShaderSPV(config)
+                                      : CompileGLSL(GenerateFragmentShader(config),
+                                                    vk::ShaderStageFlagBits::eFragment,
+                                                    ShaderOptimization::Debug);
+                }
+                shader.SetCode(std::move(code));
+                shader.MarkDone();
+            });
+        }
+        shaders[ProgramType::FS].emplace(config.Hash(), &shader);
     }
 
-    const u64 info_hash = info.Hash(instance);
-    const u64 pipeline_hash = Common::HashCombine(shader_hash, info_hash);
+    if (!Read(count)) {
+        return;
+    }
+    for (u32 i = 0; i < count; i++) {
+        std::array<u8, sizeof(PicaFixedGSConfig)> config_data;
+        std::vector<u32> code;
+        if (!Read(config_data) || !ReadCode(code)) {
+            return;
+        }
+        if (!instance.UseGeometryShaders()) {
+            continue;
+        }
+
+        const auto config = std::bit_cast<PicaFixedGSConfig>(config_data);
+        auto [it, new_shader] = fixed_geometry_shaders.try_emplace(config, instance);
+        auto& shader = it->second;
+        if (new_shader) {
+            workers.QueueWork([config, code = std::move(code), &shader]() mutable {
+                if (code.empty()) {
+                    code = CompileGLSL(GenerateFixedGeometryShader(config),
+                                       vk::ShaderStageFlagBits::eGeometry,
+                                       ShaderOptimization::High);
+                }
+                shader.SetCode(std::move(code));
+                shader.MarkDone();
+            });
+        }
+        shaders[ProgramType::GS].emplace(config.Hash(), &shader);
+    }
+
+    if (!Read(count)) {
+        return;
+    }
+    std::vector<GraphicsPipeline*> pipelines;
+    for (u32 i = 0; i < count; i++) {
+        PipelineKey key;
+        if (!Read(key.info) || !Read(key.shader_hashes)) {
+            break;
+        }
+
+        // A hash of zero selects the trivial vertex shader, or no geometry shader
+        std::array<Shader*, MAX_SHADER_STAGES> stages{};
+        stages[ProgramType::VS] = &trivial_vertex_shader;
+        bool has_shaders = true;
+        for (u32 stage = 0; stage < MAX_SHADER_STAGES; stage++) {
+            if (key.shader_hashes[stage] == 0) {
+                continue;
+            }
+            const auto it = shaders[stage].find(key.shader_hashes[stage]);
+            if (it == shaders[stage].end()) {
+                has_shaders = false;
+                break;
+            }
+            stages[stage] = it->second;
+        }
+        if (!has_shaders) {
+            continue;
+        }
+
+        const u64 pipeline_hash = PipelineHash(instance, key.info, key.shader_hashes);
+        auto [it, new_pipeline] = graphics_pipelines.try_emplace(pipeline_hash);
+        if (!new_pipeline) {
+            continue;
+        }
+        it->second = MakePipeline(key.info, pipeline_hash, stages);
+        pipelines.push_back(it->second.get());
+        pipeline_keys.push_back(key);
+    }
+
+    LOG_INFO(Render_Vulkan, "Building {} pipelines from the pipeline list", pipelines.size());
+
+    // The remaining pipelines are waited on when first bound
+    if (Settings::values.async_pipeline_warmup) {
+        return;
+    }
+    for (std::size_t i = 0; i < pipelines.size() && !stop_loading; i++) {
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Build, i, pipelines.size());
+        }
+        pipelines[i]->WaitDone();
+    }
+}
+
+/// Returns true when state that extended dynamic state can set differs between the infos
+static bool IsDynamicStateChanged(const PipelineInfo& lhs, const PipelineInfo& rhs) {
+    return lhs.rasterization.value != rhs.rasterization.value ||
+           lhs.depth_stencil.value != rhs.depth_stencil.value ||
+           lhs.blending.value != rhs.blending.value ||
+           lhs.blending.blend_enable != rhs.blending.blend_enable ||
+           lhs.blending.color_write_mask != rhs.blending.color_write_mask ||
+           lhs.blending.logic_op != rhs.blending.logic_op;
+}
+
+bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
+    MICROPROFILE_SCOPE(Vulkan_Bind);
+
+    const u64 pipeline_hash = PipelineHash(instance, info, shader_hashes);
 
     auto [it, new_pipeline] = graphics_pipelines.try_emplace(pipeline_hash);
     if (new_pipeline) {
-        it->second = std::make_unique<GraphicsPipeline>(
-            instance, renderpass_cache, info, pipeline_cache, desc_manager.GetPipelineLayout(),
-            current_shaders, &workers);
+        it->second = MakePipeline(info, pipeline_hash, current_shaders);
+        pipeline_keys.push_back({info, shader_hashes});
     }
 
     GraphicsPipeline* const pipeline{it->second.get()};
+    if (pipeline != current_pipeline || IsDynamicStateChanged(current_info, info)) {
+        // Count the pipelines that would be needed if no state was set dynamically
+        const u64 state_hash = Common::HashCombine(
+            Common::HashCombine(info.rasterization.value, info.depth_stencil.value),
+            Common::ComputeStructHash64(info.blending));
+        baked_state_hashes.insert(Common::HashCombine(pipeline_hash, state_hash));
+    }
+
     if (!wait_built && !pipeline->IsDone()) {
         return false;
     }
@@ -500,7 +1039,13 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     const bool pipeline_dirty = (current_pipeline != pipeline) || is_dirty;
     if (pipeline_dirty) {
         if (!pipeline->IsDone()) {
-            scheduler.Record([pipeline](vk::CommandBuffer) { pipeline->WaitDone(); });
+            scheduler.Record([pipeline, pipeline_hash](vk::CommandBuffer) {
+                Core::PerfStats::SubsystemTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                                      Core::PerfStats::Subsystem::ShaderCompile};
+                const VideoCore::ScopedCompileEvent event{
+                    VideoCore::CompileEventType::VKPipelineWait, pipeline_hash, true};
+                pipeline->WaitDone();
+            });
         }
 
         scheduler.Record([pipeline](vk::CommandBuffer cmdbuf) {
@@ -536,9 +1081,31 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::Regs& regs,
         }
     }
 
+    if (Settings::values.specialize_hw_shaders) {
+        const auto bool_uniforms = bool_uniform_specializer.Get(setup);
+        config.state.static_bool_mask = bool_uniforms.mask;
+        config.state.static_bool_values = bool_uniforms.values;
+    }
+
+    if (current_vs_config == config) {
+        return true;
+    }
+
     auto [it, new_config] = programmable_vertex_map.try_emplace(config);
     if (new_config) {
-        auto code = GenerateVertexShader(setup, config);
+        const auto start = std::chrono::steady_clock::now();
+        std::optional<std::string> code;
+        if (Settings::values.spirv_shader_gen.GetValue()) {
+            // Skips the GLSL frontend of glslang, fall back to it for programs that can't be
+            // emitted directly
+            if (const auto spirv = GenerateVertexShaderSPV(setup, config)) {
+                code.emplace(reinterpret_cast<const char*>(spirv->data()),
+                             spirv->size() * sizeof(u32));
+            }
+        }
+        if (!code) {
+            code = GenerateVertexShader(setup, config);
+        }
         if (!code) {
             LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable vertex shader");
             programmable_vertex_map[config] = nullptr;
@@ -551,11 +1118,23 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::Regs& regs,
 
         if (new_program) {
             shader.program = std::move(program);
-            const vk::Device device = instance.GetDevice();
-
-            workers.QueueWork([device, &shader] {
-                shader.module = Compile(shader.program, vk::ShaderStageFlagBits::eVertex, device,
-                                        ShaderOptimization::High);
+            ShaderGenStats& stats =
+                IsSpirvProgram(shader.program) ? spirv_vs_stats : glsl_vs_stats;
+            const auto generate_time = std::chrono::steady_clock::now() - start;
+
+            workers.QueueWork([&shader, &stats, generate_time, hash = config.Hash()] {
+                const auto compile_start = std::chrono::steady_clock::now();
+                shader.SetCode(CompileVertexProgram(shader.program));
+                const auto compile_time = std::chrono::steady_clock::now() - compile_start;
+                stats.Add(generate_time + compile_time);
+                VideoCore::g_compile_report.Record({
+                    .type = VideoCore::CompileEventType::VKVertexShader,
+                    .config_hash = hash,
+                    .frame = VideoCore::g_compile_report.GetFrame(),
+                    .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        generate_time + compile_time),
+                    .blocked = false,
+                });
                 shader.MarkDone();
             });
         }
@@ -571,6 +1150,7 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::Regs& regs,
 
     current_shaders[ProgramType::VS] = shader;
     shader_hashes[ProgramType::VS] = config.Hash();
+    current_vs_config = config;
 
     return true;
 }
@@ -578,6 +1158,7 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::Regs& regs,
 void PipelineCache::UseTrivialVertexShader() {
     current_shaders[ProgramType::VS] = &trivial_vertex_shader;
     shader_hashes[ProgramType::VS] = 0;
+    current_vs_config.reset();
 }
 
 bool PipelineCache::UseFixedGeometryShader(const Pica::Regs& regs) {
@@ -591,11 +1172,12 @@ bool PipelineCache::UseFixedGeometryShader(const Pica::Regs& regs) {
     auto& shader = it->second;
 
     if (new_shader) {
-        const vk::Device device = instance.GetDevice();
-        workers.QueueWork([gs_config, device, &shader]() {
+        workers.QueueWork([gs_config, &shader]() {
+            const VideoCore::ScopedCompileEvent event{
+                VideoCore::CompileEventType::VKGeometryShader, gs_config.Hash(), false};
             const std::string code = GenerateFixedGeometryShader(gs_config);
-            shader.module =
-                Compile(code, vk::ShaderStageFlagBits::eGeometry, device, ShaderOptimization::High);
+            shader.SetCode(
+                CompileGLSL(code, vk::ShaderStageFlagBits::eGeometry, ShaderOptimization::High));
             shader.MarkDone();
         });
     }
@@ -613,26 +1195,33 @@ void PipelineCache::UseTrivialGeometryShader() {
 
 void PipelineCache::UseFragmentShader(const Pica::Regs& regs) {
     const PicaFSConfig config{regs, instance};
+    // Games often rewrite registers with the values they already hold
+    if (current_fs_config == config) {
+        return;
+    }
+    current_fs_config = config;
 
     auto [it, new_shader] = fragment_shaders.try_emplace(config, instance);
     auto& shader = it->second;
 
     if (new_shader) {
         const bool emit_spirv = Settings::values.spirv_shader_gen.GetValue();
-        const vk::Device device = instance.GetDevice();
 
         // When using SPIR-V emit the fragment shader on the main thread
         // since it's quite fast. This also heavily reduces flicker when
         // using asychronous shader compilation
         if (emit_spirv) {
-            const std::vector code = GenerateFragmentShaderSPV(config);
-            shader.module = CompileSPV(code, device);
+            const VideoCore::ScopedCompileEvent event{
+                VideoCore::CompileEventType::VKFragmentShader, config.Hash(), true};
+            shader.SetCode(GenerateFragmentShaderSPV(config));
             shader.MarkDone();
         } else {
-            workers.QueueWork([config, device, &shader]() {
+            workers.QueueWork([config, &shader]() {
+                const VideoCore::ScopedCompileEvent event{
+                    VideoCore::CompileEventType::VKFragmentShader, config.Hash(), false};
                 const std::string code = GenerateFragmentShader(config);
-                shader.module = Compile(code, vk::ShaderStageFlagBits::eFragment, device,
-                                        ShaderOptimization::Debug);
+                shader.SetCode(CompileGLSL(code, vk::ShaderStageFlagBits::eFragment,
+                                           ShaderOptimization::Debug));
                 shader.MarkDone();
             });
         }
@@ -873,4 +1462,87 @@ std::string PipelineCache::GetPipelineCacheDir() const {
     return FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir) + "vulkan" + DIR_SEP;
 }
 
+std::string PipelineCache::GetPipelineListPath() const {
+    u64 program_id{};
+    if (Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id) !=
+            Loader::ResultStatus::Success ||
+        program_id == 0) {
+        return {};
+    }
+    return fmt::format("{}{:016X}.pipelines", GetPipelineCacheDir(), program_id);
+}
+
+void PipelineCache::SavePipelineList() {
+    const std::string list_path = GetPipelineListPath();
+    if (list_path.empty() || pipeline_keys.empty()) {
+        return;
+    }
+
+    FileUtil::IOFile file{list_path, "wb"};
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "Unable to open pipeline list for writing");
+        return;
+    }
+
+    const auto Write = [&file](const auto& object) {
+        return file.WriteBytes(&object, sizeof(object)) == sizeof(object);
+    };
+
+    // The SPIR-V of shaders still being compiled is left out, they are rebuilt from their config
+    const auto GetCode = [](Shader& shader) -> std::span<const u32> {
+        if (!shader.IsDone()) {
+            return {};
+        }
+        shader.WaitDone();
+        return shader.spirv;
+    };
+    const auto WriteCode = [&file, &Write](std::span<const u32> code) {
+        const u32 code_size = static_cast<u32>(code.size());
+        return Write(code_size) && file.WriteArray(code.data(), code_size) == code_size;
+    };
+
+    bool success = Write(MakePipelineListHeader());
+
+    // Configs without a program failed to decompile and are not stored
+    u32 count = static_cast<u32>(std::ranges::count_if(
+        programmable_vertex_map, [](const auto& pair) { return pair.second != nullptr; }));
+    success &= Write(count);
+    for (const auto& [config, shader] : programmable_vertex_map) {
+        if (!shader) {
+            continue;
+        }
+        // Vertex programs are stored as SPIR-V once compiled, GLSL ones are compiled again
+        const std::span<const u32> code = GetCode(*shader);
+        const std::string_view program =
+            code.empty() ? std::string_view{shader->program}
+                         : std::string_view{reinterpret_cast<const char*>(code.data()),
+                                            code.size_bytes()};
+        const u32 program_size = static_cast<u32>(program.size());
+        success &= Write(config) && Write(program_size) &&
+                   file.WriteBytes(program.data(), program_size) == program_size;
+    }
+
+    count = static_cast<u32>(fragment_shaders.size());
+    success &= Write(count);
+    for (auto& [config, shader] : fragment_shaders) {
+        success &= Write(config) && WriteCode(GetCode(shader));
+    }
+
+    count = static_cast<u32>(fixed_geometry_shaders.size());
+    success &= Write(count);
+    for (auto& [config, shader] : fixed_geometry_shaders) {
+        success &= Write(config) && WriteCode(GetCode(shader));
+    }
+
+    count = static_cast<u32>(pipeline_keys.size());
+    success &= Write(count);
+    for (const PipelineKey& key : pipeline_keys) {
+        success &= Write(key.info) && Write(key.shader_hashes);
+    }
+
+    if (!success) {
+        LOG_WARNING(Render_Vulkan, "Error during pipeline list write");
+    }
+}
+
 } // namespace Vulkan
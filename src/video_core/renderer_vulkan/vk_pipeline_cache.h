@@ -5,13 +5,19 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <unordered_set>
 #include "common/async_handle.h"
 #include "common/bit_field.h"
 #include "common/hash.h"
 #include "common/thread_worker.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
+#include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_vulkan/vk_common.h"
 #include "video_core/renderer_vulkan/vk_shader_gen.h"
+#include "video_core/shader/shader_specialization.h"
 
 namespace Pica {
 struct Regs;
@@ -141,23 +147,49 @@ class PipelineCache {
             return module;
         }
 
+        /// Creates the module from SPIR-V, which is kept for the pipeline list. Empty code
+        /// leaves the module null.
+        void SetCode(std::vector<u32> code);
+
         vk::ShaderModule module;
         vk::Device device;
         std::string program;
+        std::vector<u32> spirv;
+    };
+
+    /// Parts of a pipeline that can be built separately with VK_EXT_graphics_pipeline_library
+    enum LibraryPart : u32 {
+        VertexInput = 0,
+        PreRasterization = 1,
+        FragmentShader = 2,
+        FragmentOutput = 3,
     };
+    static constexpr u32 NUM_LIBRARY_PARTS = 4;
+
+    struct PipelineLibrary : public Common::AsyncHandle {
+        PipelineLibrary(const Instance& instance);
+        ~PipelineLibrary();
+
+        vk::Pipeline pipeline;
+        vk::Device device;
+    };
+    using PipelineLibraries = std::array<PipelineLibrary*, NUM_LIBRARY_PARTS>;
 
     class GraphicsPipeline : public Common::AsyncHandle {
     public:
         GraphicsPipeline(const Instance& instance, RenderpassCache& renderpass_cache,
-                         const PipelineInfo& info, vk::PipelineCache pipeline_cache,
+                         const PipelineInfo& info, u64 hash, vk::PipelineCache pipeline_cache,
                          vk::PipelineLayout layout, std::array<Shader*, 3> stages,
-                         Common::ThreadWorker* worker);
+                         PipelineLibraries libraries, Common::ThreadWorker* worker);
         ~GraphicsPipeline();
 
         bool Build(bool fail_on_compile_required = false);
 
+        /// Links the pipeline libraries, optimized linking replaces the fast linked pipeline
+        void Link(bool optimize);
+
         [[nodiscard]] vk::Pipeline Handle() const noexcept {
-            return pipeline;
+            return is_optimized.load(std::memory_order_acquire) ? pipeline : fast_pipeline;
         }
 
     private:
@@ -169,11 +201,16 @@ class PipelineCache {
         Common::ThreadWorker* worker;
 
         vk::Pipeline pipeline;
+        vk::Pipeline fast_pipeline;
+        std::atomic_bool is_optimized{};
         vk::PipelineLayout pipeline_layout;
         vk::PipelineCache pipeline_cache;
 
         PipelineInfo info;
+        /// Hash the pipeline is cached under, identifies it in the compile report
+        u64 hash;
         std::array<Shader*, 3> stages;
+        PipelineLibraries libraries;
     };
 
 public:
@@ -187,6 +224,10 @@ public:
     /// Stores the generated pipeline cache to disk
     void SaveDiskCache();
 
+    /// Builds the pipelines the running title used in previous sessions
+    void WarmUpPipelines(const std::atomic_bool& stop_loading,
+                         const VideoCore::DiskResourceLoadCallback& callback);
+
     /// Binds a pipeline using the provided information
     bool BindPipeline(const PipelineInfo& info, bool wait_built = false);
 
@@ -237,6 +278,26 @@ private:
     /// Returns the pipeline cache storage dir
     std::string GetPipelineCacheDir() const;
 
+    /// Creates a pipeline, linked from pipeline libraries when they are supported
+    std::unique_ptr<GraphicsPipeline> MakePipeline(
+        const PipelineInfo& info, u64 pipeline_hash,
+        const std::array<Shader*, MAX_SHADER_STAGES>& stages);
+
+    /// Returns the pipeline libraries of the provided state, queueing the missing ones
+    PipelineLibraries GetPipelineLibraries(const PipelineInfo& info,
+                                           const std::array<Shader*, MAX_SHADER_STAGES>& stages);
+
+    /// Builds the pipeline library of a single part of the provided state
+    void BuildLibrary(LibraryPart part, const PipelineInfo& info,
+                      const std::array<Shader*, MAX_SHADER_STAGES>& stages,
+                      PipelineLibrary& library);
+
+    /// Returns the path of the pipeline list of the running title, empty when it has no title id
+    std::string GetPipelineListPath() const;
+
+    /// Stores the shader configs and pipelines used by the running title
+    void SavePipelineList();
+
 private:
     const Instance& instance;
     Scheduler& scheduler;
@@ -247,21 +308,44 @@ private:
     Common::ThreadWorker workers;
     PipelineInfo current_info{};
     GraphicsPipeline* current_pipeline{};
+    std::unordered_map<u64, std::unique_ptr<PipelineLibrary>, Common::IdentityHash<u64>>
+        pipeline_libraries;
     std::unordered_map<u64, std::unique_ptr<GraphicsPipeline>, Common::IdentityHash<u64>>
         graphics_pipelines;
 
+    /// Pipelines created this session, stored for the next boot
+    struct PipelineKey {
+        PipelineInfo info;
+        std::array<u64, MAX_SHADER_STAGES> shader_hashes;
+    };
+    std::vector<PipelineKey> pipeline_keys;
+    std::unordered_set<u64, Common::IdentityHash<u64>> baked_state_hashes;
+
     enum ProgramType : u32 {
         VS = 0,
         GS = 2,
         FS = 1,
     };
 
+    /// Time spent generating and compiling programmable vertex shaders
+    struct ShaderGenStats {
+        void Add(std::chrono::steady_clock::duration elapsed);
+
+        std::atomic<u64> count{};
+        std::atomic<u64> time_us{};
+    };
+
     std::array<u64, MAX_SHADER_STAGES> shader_hashes;
     std::array<Shader*, MAX_SHADER_STAGES> current_shaders;
     std::unordered_map<PicaVSConfig, Shader*> programmable_vertex_map;
+    std::optional<PicaVSConfig> current_vs_config; ///< Config of the bound vertex shader
     std::unordered_map<std::string, Shader> programmable_vertex_cache;
+    Pica::Shader::BoolUniformSpecializer bool_uniform_specializer;
+    ShaderGenStats glsl_vs_stats;
+    ShaderGenStats spirv_vs_stats;
     std::unordered_map<PicaFixedGSConfig, Shader> fixed_geometry_shaders;
     std::unordered_map<PicaFSConfig, Shader> fragment_shaders;
+    std::optional<PicaFSConfig> current_fs_config; ///< Config of the bound fragment shader
     Shader trivial_vertex_shader;
 };
 
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
@@ -134,6 +135,7 @@ RasterizerVulkan::~RasterizerVulkan() {
 void RasterizerVulkan::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     pipeline_cache.LoadDiskCache();
+    pipeline_cache.WarmUpPipelines(stop_loading, callback);
 }
 
 void RasterizerVulkan::SyncFixedState() {
@@ -317,8 +319,20 @@ void RasterizerVulkan::SetupFixedAttribs() {
 
 bool RasterizerVulkan::SetupVertexShader() {
     MICROPROFILE_SCOPE(Vulkan_VS);
-    return pipeline_cache.UseProgrammableVertexShader(regs, Pica::g_state.vs,
-                                                      pipeline_info.vertex_layout);
+    // The attribute types of the vertex layout are part of the shader config
+    if (std::memcmp(&vs_vertex_layout, &pipeline_info.vertex_layout, sizeof(VertexLayout)) != 0) {
+        vs_vertex_layout = pipeline_info.vertex_layout;
+        MarkDirty(VideoCore::DirtyRegs::VertexShader);
+    }
+    if (!IsVertexShaderDirty()) {
+        return true;
+    }
+    if (!pipeline_cache.UseProgrammableVertexShader(regs, Pica::g_state.vs,
+                                                    pipeline_info.vertex_layout)) {
+        return false;
+    }
+    ClearDirty(VideoCore::DirtyRegs::VertexShader);
+    return true;
 }
 
 bool RasterizerVulkan::SetupGeometryShader() {
@@ -329,17 +343,20 @@ bool RasterizerVulkan::SetupGeometryShader() {
         return false;
     }
 
-    return pipeline_cache.UseFixedGeometryShader(regs);
+    if (!IsDirty(VideoCore::DirtyRegs::GeometryShader)) {
+        return true;
+    }
+    if (!pipeline_cache.UseFixedGeometryShader(regs)) {
+        return false;
+    }
+    ClearDirty(VideoCore::DirtyRegs::GeometryShader);
+    return true;
 }
 
 bool RasterizerVulkan::AccelerateDrawBatch(bool is_indexed) {
+    // Programmable geometry shaders are not translated for Vulkan yet
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        if (regs.pipeline.gs_config.mode != Pica::PipelineRegs::GSMode::Point) {
-            return false;
-        }
-        if (regs.pipeline.triangle_topology != Pica::PipelineRegs::TriangleTopology::Shader) {
-            return false;
-        }
+        return false;
     }
 
     pipeline_info.rasterization.topology.Assign(regs.pipeline.triangle_topology);
@@ -436,6 +453,9 @@ void RasterizerVulkan::DrawTriangles() {
 
     pipeline_cache.UseTrivialVertexShader();
     pipeline_cache.UseTrivialGeometryShader();
+    // The next accelerated draw has to bind its shaders again
+    MarkDirty(VideoCore::DirtyRegs::VertexShader);
+    MarkDirty(VideoCore::DirtyRegs::GeometryShader);
 
     Draw(false, false);
 }
@@ -498,8 +518,10 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
     }
 
     // Sync the LUTs within the texture buffer
-    SyncAndUploadLUTs();
-    SyncAndUploadLUTsLF();
+    if (SyncLUTData()) {
+        SyncAndUploadLUTs();
+        SyncAndUploadLUTsLF();
+    }
 
     // Sync the uniform data
     UploadUniforms(accelerate);
@@ -747,6 +769,35 @@ void RasterizerVulkan::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
 
+void RasterizerVulkan::SuspendCaches(bool flush) {
+    res_cache.Suspend(flush);
+}
+
+void RasterizerVulkan::ResumeCaches() {
+    res_cache.Resume();
+}
+
+void RasterizerVulkan::TickFrame() {
+    res_cache.TickFrame();
+
+    const u64 elided_clears = renderpass_cache.GetElidedClears();
+    last_frame_elided_clears.store(elided_clears - frame_start_elided_clears,
+                                   std::memory_order_relaxed);
+    frame_start_elided_clears = elided_clears;
+}
+
+VideoCore::RasterizerCacheStats RasterizerVulkan::GetLastFrameCacheStats() const {
+    VideoCore::RasterizerCacheStats stats = res_cache.GetLastFrameStats();
+    stats.elided_clears = last_frame_elided_clears.load(std::memory_order_relaxed);
+    return stats;
+}
+
+VideoCore::RasterizerCacheStats RasterizerVulkan::GetTotalCacheStats() const {
+    VideoCore::RasterizerCacheStats stats = res_cache.GetTotalStats();
+    stats.elided_clears = renderpass_cache.GetElidedClears();
+    return stats;
+}
+
 bool RasterizerVulkan::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
     return res_cache.AccelerateDisplayTransfer(config);
 }
@@ -937,170 +988,90 @@ void RasterizerVulkan::SyncAndUploadLUTsLF() {
         sizeof(Common::Vec2f) * 256 * Pica::LightingRegs::NumLightingSampler +
         sizeof(Common::Vec2f) * 128; // fog
 
-    if (!uniform_block_data.lighting_lut_dirty_any && !uniform_block_data.fog_lut_dirty) {
+    const auto& lighting_dirty = uniform_block_data.lighting_lut_dirty;
+    if (std::all_of(lighting_dirty.begin(), lighting_dirty.end(),
+                    [](const LUTRange& range) { return range.Empty(); }) &&
+        uniform_block_data.fog_lut_dirty.Empty()) {
         return;
     }
 
     std::size_t bytes_used = 0;
     auto [buffer, offset, invalidate] = texture_lf_buffer.Map(max_size, sizeof(Common::Vec4f));
 
-    // Sync the lighting luts
-    if (uniform_block_data.lighting_lut_dirty_any || invalidate) {
-        for (unsigned index = 0; index < uniform_block_data.lighting_lut_dirty.size(); index++) {
-            if (uniform_block_data.lighting_lut_dirty[index] || invalidate) {
-                std::array<Common::Vec2f, 256> new_data;
-                const auto& source_lut = Pica::g_state.lighting.luts[index];
-                std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
-                               [](const auto& entry) {
-                                   return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                               });
-
-                if (new_data != lighting_lut_data[index] || invalidate) {
-                    lighting_lut_data[index] = new_data;
-                    std::memcpy(buffer + bytes_used, new_data.data(),
-                                new_data.size() * sizeof(Common::Vec2f));
-                    uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
-                        static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-                    uniform_block_data.dirty = true;
-                    bytes_used += new_data.size() * sizeof(Common::Vec2f);
-                }
-                uniform_block_data.lighting_lut_dirty[index] = false;
-            }
+    // The LUTs are streamed, so a changed LUT is uploaded whole to its new offset
+    const auto upload_lut = [&, buffer = buffer, offset = offset,
+                             invalidate = invalidate](LUTRange& range, const auto& lut_data,
+                                                      int& lut_offset) {
+        if (range.Empty() && !invalidate) {
+            return;
         }
-        uniform_block_data.lighting_lut_dirty_any = false;
+        std::memcpy(buffer + bytes_used, lut_data.data(), sizeof(lut_data));
+        lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        uniform_block_data.dirty = true;
+        bytes_used += sizeof(lut_data);
+        range.Clear();
+    };
+
+    // Sync the lighting luts
+    for (unsigned index = 0; index < lighting_lut_data.size(); index++) {
+        upload_lut(uniform_block_data.lighting_lut_dirty[index], lighting_lut_data[index],
+                   uniform_block_data.data.lighting_lut_offset[index / 4][index % 4]);
     }
 
     // Sync the fog lut
-    if (uniform_block_data.fog_lut_dirty || invalidate) {
-        std::array<Common::Vec2f, 128> new_data;
-
-        std::transform(Pica::g_state.fog.lut.begin(), Pica::g_state.fog.lut.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != fog_lut_data || invalidate) {
-            fog_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec2f));
-            uniform_block_data.data.fog_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec2f);
-        }
-        uniform_block_data.fog_lut_dirty = false;
-    }
+    upload_lut(uniform_block_data.fog_lut_dirty, fog_lut_data,
+               uniform_block_data.data.fog_lut_offset);
 
     texture_lf_buffer.Commit(static_cast<u32>(bytes_used));
 }
 
 void RasterizerVulkan::SyncAndUploadLUTs() {
-    const auto& proctex = Pica::g_state.proctex;
     constexpr std::size_t max_size =
         sizeof(Common::Vec2f) * 128 * 3 + // proctex: noise + color + alpha
         sizeof(Common::Vec4f) * 256 +     // proctex
         sizeof(Common::Vec4f) * 256;      // proctex diff
 
-    if (!uniform_block_data.proctex_noise_lut_dirty &&
-        !uniform_block_data.proctex_color_map_dirty &&
-        !uniform_block_data.proctex_alpha_map_dirty && !uniform_block_data.proctex_lut_dirty &&
-        !uniform_block_data.proctex_diff_lut_dirty) {
+    if (uniform_block_data.proctex_noise_lut_dirty.Empty() &&
+        uniform_block_data.proctex_color_map_dirty.Empty() &&
+        uniform_block_data.proctex_alpha_map_dirty.Empty() &&
+        uniform_block_data.proctex_lut_dirty.Empty() &&
+        uniform_block_data.proctex_diff_lut_dirty.Empty()) {
         return;
     }
 
     std::size_t bytes_used = 0;
     auto [buffer, offset, invalidate] = texture_buffer.Map(max_size, sizeof(Common::Vec4f));
 
-    // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
-    auto SyncProcTexValueLUT =
-        [this, buffer = buffer, offset = offset, invalidate = invalidate,
-         &bytes_used](const std::array<Pica::State::ProcTex::ValueEntry, 128>& lut,
-                      std::array<Common::Vec2f, 128>& lut_data, int& lut_offset) {
-            std::array<Common::Vec2f, 128> new_data;
-            std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
-                return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-            });
-
-            if (new_data != lut_data || invalidate) {
-                lut_data = new_data;
-                std::memcpy(buffer + bytes_used, new_data.data(),
-                            new_data.size() * sizeof(Common::Vec2f));
-                lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-                uniform_block_data.dirty = true;
-                bytes_used += new_data.size() * sizeof(Common::Vec2f);
-            }
-        };
-
-    // Sync the proctex noise lut
-    if (uniform_block_data.proctex_noise_lut_dirty || invalidate) {
-        SyncProcTexValueLUT(proctex.noise_table, proctex_noise_lut_data,
-                            uniform_block_data.data.proctex_noise_lut_offset);
-        uniform_block_data.proctex_noise_lut_dirty = false;
-    }
-
-    // Sync the proctex color map
-    if (uniform_block_data.proctex_color_map_dirty || invalidate) {
-        SyncProcTexValueLUT(proctex.color_map_table, proctex_color_map_data,
-                            uniform_block_data.data.proctex_color_map_offset);
-        uniform_block_data.proctex_color_map_dirty = false;
-    }
-
-    // Sync the proctex alpha map
-    if (uniform_block_data.proctex_alpha_map_dirty || invalidate) {
-        SyncProcTexValueLUT(proctex.alpha_map_table, proctex_alpha_map_data,
-                            uniform_block_data.data.proctex_alpha_map_offset);
-        uniform_block_data.proctex_alpha_map_dirty = false;
-    }
-
-    // Sync the proctex lut
-    if (uniform_block_data.proctex_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_table.begin(), proctex.color_table.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_lut_data || invalidate) {
-            proctex_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            uniform_block_data.data.proctex_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
+    // The LUTs are streamed, so a changed LUT is uploaded whole to its new offset
+    const auto upload_lut = [&, buffer = buffer, offset = offset,
+                             invalidate = invalidate](LUTRange& range, const auto& lut_data,
+                                                      int& lut_offset) {
+        if (range.Empty() && !invalidate) {
+            return;
         }
-        uniform_block_data.proctex_lut_dirty = false;
-    }
+        std::memcpy(buffer + bytes_used, lut_data.data(), sizeof(lut_data));
+        lut_offset = static_cast<int>((offset + bytes_used) / sizeof(lut_data[0]));
+        uniform_block_data.dirty = true;
+        bytes_used += sizeof(lut_data);
+        range.Clear();
+    };
 
-    // Sync the proctex difference lut
-    if (uniform_block_data.proctex_diff_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_diff_table.begin(), proctex.color_diff_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_diff_lut_data || invalidate) {
-            proctex_diff_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            uniform_block_data.data.proctex_diff_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
-        }
-        uniform_block_data.proctex_diff_lut_dirty = false;
-    }
+    upload_lut(uniform_block_data.proctex_noise_lut_dirty, proctex_noise_lut_data,
+               uniform_block_data.data.proctex_noise_lut_offset);
+    upload_lut(uniform_block_data.proctex_color_map_dirty, proctex_color_map_data,
+               uniform_block_data.data.proctex_color_map_offset);
+    upload_lut(uniform_block_data.proctex_alpha_map_dirty, proctex_alpha_map_data,
+               uniform_block_data.data.proctex_alpha_map_offset);
+    upload_lut(uniform_block_data.proctex_lut_dirty, proctex_lut_data,
+               uniform_block_data.data.proctex_lut_offset);
+    upload_lut(uniform_block_data.proctex_diff_lut_dirty, proctex_diff_lut_data,
+               uniform_block_data.data.proctex_diff_lut_offset);
 
     texture_buffer.Commit(static_cast<u32>(bytes_used));
 }
 
 void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
-    const bool sync_vs = accelerate_draw;
+    const bool sync_vs = accelerate_draw && IsDirty(VideoCore::DirtyRegs::VSUniforms);
     const bool sync_fs = uniform_block_data.dirty;
 
     if (!sync_vs && !sync_fs) {
@@ -1110,15 +1081,20 @@ void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
     const u64 uniform_size = uniform_size_aligned_vs + uniform_size_aligned_fs;
     auto [uniforms, offset, invalidate] =
         uniform_buffer.Map(uniform_size, uniform_buffer_alignment);
+    if (invalidate) {
+        // The VS uniforms bound by an earlier draw may have been overwritten
+        MarkDirty(VideoCore::DirtyRegs::VSUniforms);
+    }
 
     u32 used_bytes = 0;
-    if (sync_vs) {
+    if (accelerate_draw && IsDirty(VideoCore::DirtyRegs::VSUniforms)) {
         Pica::Shader::VSUniformData vs_uniforms;
         vs_uniforms.uniforms.SetFromRegs(regs.vs, Pica::g_state.vs);
         std::memcpy(uniforms, &vs_uniforms, sizeof(vs_uniforms));
 
         pipeline_cache.SetBufferOffset(0, offset);
         used_bytes += static_cast<u32>(uniform_size_aligned_vs);
+        ClearDirty(VideoCore::DirtyRegs::VSUniforms);
     }
 
     if (sync_fs || invalidate) {
@@ -48,6 +48,11 @@ public:
     void InvalidateRegion(PAddr addr, u32 size) override;
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
     void ClearAll(bool flush) override;
+    void SuspendCaches(bool flush) override;
+    void ResumeCaches() override;
+    void TickFrame() override;
+    VideoCore::RasterizerCacheStats GetLastFrameCacheStats() const override;
+    VideoCore::RasterizerCacheStats GetTotalCacheStats() const override;
     bool AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) override;
     bool AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) override;
     bool AccelerateFill(const GPU::Regs::MemoryFillConfig& config) override;
@@ -147,6 +152,7 @@ private:
     PipelineCache pipeline_cache;
 
     VertexLayout software_layout;
+    VertexLayout vs_vertex_layout{}; ///< Layout the bound programmable vertex shader was built for
     std::array<u32, 16> binding_offsets{};
     std::array<bool, 16> enable_attributes{};
     std::array<vk::Buffer, 16> vertex_buffers;
@@ -163,6 +169,8 @@ private:
     u64 uniform_size_aligned_vs;
     u64 uniform_size_aligned_fs;
     bool async_shaders{false};
+    u64 frame_start_elided_clears{};
+    std::atomic<u64> last_frame_elided_clears{};
 };
 
 } // namespace Vulkan
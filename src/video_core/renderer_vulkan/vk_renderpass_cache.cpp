@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <limits>
 #include "common/assert.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -22,12 +23,12 @@ RenderpassCache::~RenderpassCache() {
     vk::Device device = instance.GetDevice();
     for (u32 color = 0; color <= MAX_COLOR_FORMATS; color++) {
         for (u32 depth = 0; depth <= MAX_DEPTH_FORMATS; depth++) {
-            if (vk::RenderPass load_pass = cached_renderpasses[color][depth][0]; load_pass) {
-                device.destroyRenderPass(load_pass);
-            }
-
-            if (vk::RenderPass clear_pass = cached_renderpasses[color][depth][1]; clear_pass) {
-                device.destroyRenderPass(clear_pass);
+            for (const auto& renderpasses : cached_renderpasses[color][depth]) {
+                for (const vk::RenderPass renderpass : renderpasses) {
+                    if (renderpass) {
+                        device.destroyRenderPass(renderpass);
+                    }
+                }
             }
         }
     }
@@ -43,6 +44,17 @@ void RenderpassCache::ClearFramebuffers() {
     framebuffers.clear();
 }
 
+void RenderpassCache::RemoveFramebuffers(vk::ImageView image_view) {
+    std::erase_if(framebuffers, [&](const auto& entry) {
+        const auto& [info, framebuffer] = entry;
+        if (info.color != image_view && info.depth != image_view) {
+            return false;
+        }
+        instance.GetDevice().destroyFramebuffer(framebuffer);
+        return true;
+    });
+}
+
 void RenderpassCache::BeginRendering(Surface* const color, Surface* const depth_stencil,
                                      vk::Rect2D render_area, bool do_clear, vk::ClearValue clear) {
     return BeginRendering(Framebuffer{color, depth_stencil, render_area}, do_clear, clear);
@@ -55,27 +67,53 @@ void RenderpassCache::BeginRendering(const Framebuffer& framebuffer, bool do_cle
             .aspect = vk::ImageAspectFlagBits::eColor,
             .image = framebuffer.Image(SurfaceType::Color),
             .image_view = framebuffer.ImageView(SurfaceType::Color),
+            .clear = clear,
+            .do_clear = do_clear,
         },
         .depth{
             .aspect = vk::ImageAspectFlagBits::eDepth,
             .image = framebuffer.Image(SurfaceType::DepthStencil),
             .image_view = framebuffer.ImageView(SurfaceType::DepthStencil),
+            .clear = clear,
+            .do_clear = do_clear,
         },
         .render_area = framebuffer.RenderArea(),
-        .clear = clear,
-        .do_clear = do_clear,
     };
 
     if (framebuffer.HasStencil()) {
         new_info.depth.aspect |= vk::ImageAspectFlagBits::eStencil;
     }
 
-    // If the provided rendering context is active we are done
-    if (info == new_info && rendering) {
+    // If the provided rendering context is active we are done. Clears are only deferred outside
+    // of a rendering scope, so there are none to fold then.
+    if (info == new_info && rendering && !do_clear && pending_uploads.empty()) {
         cmd_count++;
         return;
     }
 
+    // Deferred clears of the attachments that cover the render area become their load operation,
+    // the others are recorded by EndRendering
+    const auto fold_clear = [this, &new_info](RenderTarget& target) {
+        if (!target || target.do_clear) {
+            return;
+        }
+        const auto it = std::find_if(pending_clears.begin(), pending_clears.end(),
+                                     [&](const PendingClear& pending) {
+                                         return pending.image == target.image &&
+                                                pending.aspect == target.aspect &&
+                                                pending.rect == new_info.render_area;
+                                     });
+        if (it == pending_clears.end()) {
+            return;
+        }
+        target.clear = it->value;
+        target.do_clear = true;
+        pending_clears.erase(it);
+        elided_clears++;
+    };
+    fold_clear(new_info.color);
+    fold_clear(new_info.depth);
+
     EndRendering();
     info = new_info;
     rendering = true;
@@ -94,24 +132,24 @@ void RenderpassCache::DynamicRendering(const Framebuffer& framebuffer) {
         u32 cursor = 0;
         std::array<vk::RenderingAttachmentInfoKHR, 2> infos{};
 
-        const auto Prepare = [&](vk::ImageView image_view) {
-            if (!image_view) {
+        const auto Prepare = [&](const RenderTarget& target) {
+            if (!target.image_view) {
                 cursor++;
                 return;
             }
 
             infos[cursor++] = vk::RenderingAttachmentInfoKHR{
-                .imageView = image_view,
+                .imageView = target.image_view,
                 .imageLayout = vk::ImageLayout::eGeneral,
                 .loadOp =
-                    info.do_clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad,
+                    target.do_clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad,
                 .storeOp = vk::AttachmentStoreOp::eStore,
-                .clearValue = info.clear,
+                .clearValue = target.clear,
             };
         };
 
-        Prepare(info.color.image_view);
-        Prepare(info.depth.image_view);
+        Prepare(info.color);
+        Prepare(info.depth);
 
         const u32 color_attachment_count = info.color ? 1u : 0u;
         const vk::RenderingAttachmentInfoKHR* depth_info = info.depth ? &infos[1] : nullptr;
@@ -132,7 +170,8 @@ void RenderpassCache::DynamicRendering(const Framebuffer& framebuffer) {
 void RenderpassCache::EnterRenderpass(const Framebuffer& framebuffer) {
     const PixelFormat color_format = framebuffer.Format(SurfaceType::Color);
     const PixelFormat depth_format = framebuffer.Format(SurfaceType::DepthStencil);
-    const vk::RenderPass renderpass = GetRenderpass(color_format, depth_format, info.do_clear);
+    const vk::RenderPass renderpass =
+        GetRenderpass(color_format, depth_format, info.color.do_clear, info.depth.do_clear);
 
     const FramebufferInfo framebuffer_info = {
         .color = info.color.image_view,
@@ -146,14 +185,24 @@ void RenderpassCache::EnterRenderpass(const Framebuffer& framebuffer) {
         it->second = CreateFramebuffer(framebuffer_info, renderpass);
     }
 
-    scheduler.Record([render_area = info.render_area, clear = info.clear, renderpass,
+    // Clear values are indexed by attachment, the depth attachment comes first without color
+    u32 num_clear_values = 0;
+    std::array<vk::ClearValue, 2> clear_values{};
+    if (info.color) {
+        clear_values[num_clear_values++] = info.color.clear;
+    }
+    if (info.depth) {
+        clear_values[num_clear_values++] = info.depth.clear;
+    }
+
+    scheduler.Record([render_area = info.render_area, clear_values, num_clear_values, renderpass,
                       framebuffer = it->second](vk::CommandBuffer cmdbuf) {
         const vk::RenderPassBeginInfo renderpass_begin_info = {
             .renderPass = renderpass,
             .framebuffer = framebuffer,
             .renderArea = render_area,
-            .clearValueCount = 1,
-            .pClearValues = &clear,
+            .clearValueCount = num_clear_values,
+            .pClearValues = clear_values.data(),
         };
 
         cmdbuf.beginRenderPass(renderpass_begin_info, vk::SubpassContents::eInline);
@@ -161,7 +210,9 @@ void RenderpassCache::EnterRenderpass(const Framebuffer& framebuffer) {
 }
 
 void RenderpassCache::EndRendering() {
+    FlushClears();
     if (!rendering) {
+        FlushUploads();
         return;
     }
 
@@ -225,6 +276,7 @@ void RenderpassCache::EndRendering() {
             cmdbuf.pipelineBarrier(src_stage, dst_stage, vk::DependencyFlagBits::eByRegion, 0,
                                    nullptr, 0, nullptr, num_barriers, barriers.data());
         });
+    FlushUploads();
 
     // The Mali guide recommends flushing at the end of each major renderpass
     // Testing has shown this has a significant effect on rendering performance
@@ -234,16 +286,251 @@ void RenderpassCache::EndRendering() {
     }
 }
 
+bool RenderpassCache::ClearAttachment(vk::Image image, vk::ImageAspectFlags aspect,
+                                      vk::Rect2D rect, vk::ClearValue clear) {
+    const RenderTarget& target = image == info.color.image ? info.color : info.depth;
+    if (!rendering || !image || target.image != image || target.aspect != aspect) {
+        return false;
+    }
+
+    // A deferred upload to the image is recorded after the scope and would land on the clear
+    const auto is_target = [image](const PendingUpload& upload) { return upload.image == image; };
+    if (std::ranges::any_of(pending_uploads, is_target)) {
+        return false;
+    }
+
+    // Clears must stay within the render area of the scope
+    const vk::Rect2D& area = info.render_area;
+    if (rect.offset.x < area.offset.x || rect.offset.y < area.offset.y ||
+        rect.offset.x + rect.extent.width > area.offset.x + area.extent.width ||
+        rect.offset.y + rect.extent.height > area.offset.y + area.extent.height) {
+        return false;
+    }
+
+    scheduler.Record([aspect, rect, clear](vk::CommandBuffer cmdbuf) {
+        const vk::ClearAttachment attachment = {
+            .aspectMask = aspect,
+            .colorAttachment = 0,
+            .clearValue = clear,
+        };
+        const vk::ClearRect clear_rect = {
+            .rect = rect,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        };
+        cmdbuf.clearAttachments(attachment, clear_rect);
+    });
+
+    cmd_count++;
+    return true;
+}
+
+void RenderpassCache::DeferClear(const PendingClear& clear) {
+    ASSERT(!rendering);
+    // A clear replaces all previous contents, including a pending clear. Pending uploads to the
+    // image are recorded first since clears are recorded before uploads.
+    if (std::ranges::any_of(pending_uploads, [&clear](const PendingUpload& upload) {
+            return upload.image == clear.image;
+        })) {
+        FlushUploads();
+    }
+    DropClear(clear.image);
+    pending_clears.push_back(clear);
+}
+
+static bool Overlaps(const vk::BufferImageCopy& lhs, const vk::BufferImageCopy& rhs) {
+    const auto overlaps = [](s32 lhs_offset, u32 lhs_extent, s32 rhs_offset, u32 rhs_extent) {
+        return lhs_offset < rhs_offset + static_cast<s32>(rhs_extent) &&
+               rhs_offset < lhs_offset + static_cast<s32>(lhs_extent);
+    };
+    return lhs.imageSubresource.mipLevel == rhs.imageSubresource.mipLevel &&
+           overlaps(lhs.imageOffset.x, lhs.imageExtent.width, rhs.imageOffset.x,
+                    rhs.imageExtent.width) &&
+           overlaps(lhs.imageOffset.y, lhs.imageExtent.height, rhs.imageOffset.y,
+                    rhs.imageExtent.height);
+}
+
+void RenderpassCache::DeferUpload(const PendingUpload& upload) {
+    // Clears are recorded before the uploads and copies within a command must not overlap, so
+    // either is recorded first. A pending clear means there is no active rendering scope.
+    const bool must_flush =
+        std::ranges::any_of(pending_clears,
+                            [&upload](const PendingClear& clear) {
+                                return clear.image == upload.image;
+                            }) ||
+        std::ranges::any_of(pending_uploads, [&upload](const PendingUpload& pending) {
+            return pending.image == upload.image && Overlaps(pending.copies[0], upload.copies[0]);
+        });
+    if (must_flush) {
+        EndRendering();
+    }
+    pending_uploads.push_back(upload);
+}
+
+void RenderpassCache::DropUploads(vk::Image image) {
+    std::erase_if(pending_uploads, [image](const PendingUpload& upload) {
+        if (upload.image != image) {
+            return false;
+        }
+        // The staging memory may still be written by the decoder
+        upload.staging.Wait();
+        return true;
+    });
+}
+
+void RenderpassCache::FlushUploads() {
+    if (pending_uploads.empty()) {
+        return;
+    }
+
+    scheduler.Record([uploads = std::move(pending_uploads)](vk::CommandBuffer cmdbuf) {
+        vk::PipelineStageFlags pipeline_flags{};
+        std::vector<vk::ImageMemoryBarrier> pre_barriers;
+        std::vector<vk::ImageMemoryBarrier> post_barriers;
+        for (const PendingUpload& upload : uploads) {
+            pipeline_flags |= upload.pipeline_flags;
+            if (std::ranges::any_of(pre_barriers, [&upload](const vk::ImageMemoryBarrier& barrier) {
+                    return barrier.image == upload.image;
+                })) {
+                continue;
+            }
+
+            const vk::ImageSubresourceRange range = {
+                .aspectMask = upload.aspect,
+                .baseMipLevel = 0,
+                .levelCount = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            };
+            pre_barriers.push_back(vk::ImageMemoryBarrier{
+                .srcAccessMask = upload.access,
+                .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .oldLayout = vk::ImageLayout::eGeneral,
+                .newLayout = vk::ImageLayout::eTransferDstOptimal,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = upload.image,
+                .subresourceRange = range,
+            });
+            post_barriers.push_back(vk::ImageMemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = upload.access,
+                .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = upload.image,
+                .subresourceRange = range,
+            });
+        }
+
+        cmdbuf.pipelineBarrier(pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, pre_barriers);
+
+        // The regions of all uploads from the same buffer to an image go in a single copy
+        std::vector<bool> recorded(uploads.size());
+        std::vector<vk::BufferImageCopy> regions;
+        for (std::size_t i = 0; i < uploads.size(); i++) {
+            if (recorded[i]) {
+                continue;
+            }
+            const PendingUpload& first = uploads[i];
+            regions.clear();
+            for (std::size_t j = i; j < uploads.size(); j++) {
+                const PendingUpload& upload = uploads[j];
+                if (upload.image != first.image || upload.buffer != first.buffer) {
+                    continue;
+                }
+                regions.insert(regions.end(), upload.copies.begin(),
+                               upload.copies.begin() + upload.num_copies);
+                recorded[j] = true;
+            }
+            cmdbuf.copyBufferToImage(first.buffer, first.image,
+                                     vk::ImageLayout::eTransferDstOptimal, regions);
+        }
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, pipeline_flags,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, post_barriers);
+
+        // Wait for the pending decodes to finish. Normally this isn't needed until we actually
+        // submit the command buffer but it's safer to do it now to prevent the stream buffer
+        // from reclaiming our space before we are done with it.
+        for (const PendingUpload& upload : uploads) {
+            upload.staging.Wait();
+        }
+    });
+    pending_uploads.clear();
+}
+
+void RenderpassCache::DropClear(vk::Image image) {
+    elided_clears += std::erase_if(pending_clears, [image](const PendingClear& pending) {
+        return pending.image == image;
+    });
+}
+
+void RenderpassCache::FlushClears() {
+    for (const PendingClear& clear : pending_clears) {
+        scheduler.Record([clear](vk::CommandBuffer cmdbuf) {
+            const vk::ImageSubresourceRange range = {
+                .aspectMask = clear.aspect,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            };
+
+            const vk::ImageMemoryBarrier pre_barrier = {
+                .srcAccessMask = clear.access,
+                .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .oldLayout = vk::ImageLayout::eGeneral,
+                .newLayout = vk::ImageLayout::eTransferDstOptimal,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = clear.image,
+                .subresourceRange = range,
+            };
+
+            const vk::ImageMemoryBarrier post_barrier = {
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = clear.access,
+                .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = clear.image,
+                .subresourceRange = range,
+            };
+
+            cmdbuf.pipelineBarrier(clear.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
+                                   vk::DependencyFlagBits::eByRegion, {}, {}, pre_barrier);
+
+            if (clear.aspect & vk::ImageAspectFlagBits::eColor) {
+                cmdbuf.clearColorImage(clear.image, vk::ImageLayout::eTransferDstOptimal,
+                                       clear.value.color, range);
+            } else {
+                cmdbuf.clearDepthStencilImage(clear.image, vk::ImageLayout::eTransferDstOptimal,
+                                              clear.value.depthStencil, range);
+            }
+
+            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, clear.pipeline_flags,
+                                   vk::DependencyFlagBits::eByRegion, {}, {}, post_barrier);
+        });
+    }
+    pending_clears.clear();
+}
+
 void RenderpassCache::CreatePresentRenderpass(vk::Format format) {
     if (!present_renderpass) {
         present_renderpass =
             CreateRenderPass(format, vk::Format::eUndefined, vk::AttachmentLoadOp::eClear,
-                             vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferSrcOptimal);
+                             vk::AttachmentLoadOp::eDontCare, vk::ImageLayout::eUndefined,
+                             vk::ImageLayout::eTransferSrcOptimal);
     }
 }
 
 vk::RenderPass RenderpassCache::GetRenderpass(VideoCore::PixelFormat color,
-                                              VideoCore::PixelFormat depth, bool is_clear) {
+                                              VideoCore::PixelFormat depth, bool clear_color,
+                                              bool clear_depth) {
     std::scoped_lock lock{cache_mutex};
 
     const u32 color_index =
@@ -256,21 +543,25 @@ vk::RenderPass RenderpassCache::GetRenderpass(VideoCore::PixelFormat color,
                    (color_index != MAX_COLOR_FORMATS || depth_index != MAX_DEPTH_FORMATS),
                "Invalid color index {} and/or depth_index {}", color_index, depth_index);
 
-    vk::RenderPass& renderpass = cached_renderpasses[color_index][depth_index][is_clear];
+    vk::RenderPass& renderpass =
+        cached_renderpasses[color_index][depth_index][clear_color][clear_depth];
     if (!renderpass) {
         const vk::Format color_format = instance.GetTraits(color).native;
         const vk::Format depth_format = instance.GetTraits(depth).native;
-        const vk::AttachmentLoadOp load_op =
-            is_clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad;
-        renderpass = CreateRenderPass(color_format, depth_format, load_op,
-                                      vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
+        const auto load_op = [](bool clear) {
+            return clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad;
+        };
+        renderpass = CreateRenderPass(color_format, depth_format, load_op(clear_color),
+                                      load_op(clear_depth), vk::ImageLayout::eGeneral,
+                                      vk::ImageLayout::eGeneral);
     }
 
     return renderpass;
 }
 
 vk::RenderPass RenderpassCache::CreateRenderPass(vk::Format color, vk::Format depth,
-                                                 vk::AttachmentLoadOp load_op,
+                                                 vk::AttachmentLoadOp color_load_op,
+                                                 vk::AttachmentLoadOp depth_load_op,
                                                  vk::ImageLayout initial_layout,
                                                  vk::ImageLayout final_layout) const {
     u32 attachment_count = 0;
@@ -284,7 +575,7 @@ vk::RenderPass RenderpassCache::CreateRenderPass(vk::Format color, vk::Format de
     if (color != vk::Format::eUndefined) {
         attachments[attachment_count] = vk::AttachmentDescription{
             .format = color,
-            .loadOp = load_op,
+            .loadOp = color_load_op,
             .storeOp = vk::AttachmentStoreOp::eStore,
             .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
             .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
@@ -303,9 +594,9 @@ vk::RenderPass RenderpassCache::CreateRenderPass(vk::Format color, vk::Format de
     if (depth != vk::Format::eUndefined) {
         attachments[attachment_count] = vk::AttachmentDescription{
             .format = depth,
-            .loadOp = load_op,
+            .loadOp = depth_load_op,
             .storeOp = vk::AttachmentStoreOp::eStore,
-            .stencilLoadOp = load_op,
+            .stencilLoadOp = depth_load_op,
             .stencilStoreOp = vk::AttachmentStoreOp::eStore,
             .initialLayout = vk::ImageLayout::eGeneral,
             .finalLayout = vk::ImageLayout::eGeneral,
@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <compare>
-#include <cstring>
 #include <mutex>
 #include <variant>
+#include <vector>
 #include "common/hash.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
+#include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_vulkan/vk_common.h"
 
 namespace Vulkan {
@@ -42,6 +45,28 @@ namespace Vulkan {
 
 class Framebuffer;
 
+/// A clear of all layers of level 0 of an image within rect, that has not been recorded yet
+struct PendingClear {
+    vk::Image image;
+    vk::ImageAspectFlags aspect;
+    vk::PipelineStageFlags pipeline_flags;
+    vk::AccessFlags access;
+    vk::Rect2D rect;
+    vk::ClearValue value;
+};
+
+/// A copy from a staging buffer to an image that has not been recorded yet
+struct PendingUpload {
+    vk::Buffer buffer;
+    vk::Image image;
+    vk::ImageAspectFlags aspect;
+    vk::PipelineStageFlags pipeline_flags;
+    vk::AccessFlags access;
+    u32 num_copies;
+    std::array<vk::BufferImageCopy, 2> copies;
+    VideoCore::StagingData staging;
+};
+
 class RenderpassCache {
     static constexpr std::size_t MAX_COLOR_FORMATS = 5;
     static constexpr std::size_t MAX_DEPTH_FORMATS = 4;
@@ -53,21 +78,58 @@ public:
     /// Destroys cached framebuffers
     void ClearFramebuffers();
 
+    /// Destroys cached framebuffers that reference the provided image view
+    void RemoveFramebuffers(vk::ImageView image_view);
+
     /// Begins a new renderpass only when no other renderpass is currently active
     void BeginRendering(const Framebuffer& framebuffer, bool do_clear = false,
                         vk::ClearValue clear = {});
     void BeginRendering(Surface* const color, Surface* const depth_stencil, vk::Rect2D render_area,
                         bool do_clear = false, vk::ClearValue clear = {});
 
-    /// Exits from any currently active renderpass instance
+    /// Exits from any currently active renderpass instance and records the deferred transfers
     void EndRendering();
 
+    /**
+     * Defers a copy to an image until the next rendering scope begins or EndRendering is called.
+     * The copies collected until then are recorded together, with one set of barriers and one
+     * copy command per image, and the active rendering scope stays open in the meantime.
+     */
+    void DeferUpload(const PendingUpload& upload);
+
+    /// Forgets the deferred uploads of image, for images that are about to be destroyed
+    void DropUploads(vk::Image image);
+
+    /**
+     * Defers a clear of the whole image to the next rendering scope. If that scope renders to the
+     * image with the clear rect as its render area the clear becomes the load operation of the
+     * attachment, otherwise it is recorded before the scope begins. Must be called outside of a
+     * rendering scope.
+     */
+    void DeferClear(const PendingClear& clear);
+
+    /// Forgets the deferred clear of image, for images about to be overwritten or destroyed
+    void DropClear(vk::Image image);
+
+    /// Returns the number of deferred clears that were folded into a load operation or dropped
+    [[nodiscard]] u64 GetElidedClears() const noexcept {
+        return elided_clears.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Clears the aspects of a rectangle of image inside the active rendering scope, which stays
+     * open. Returns false if image is not bound with those aspects or rect is not inside the
+     * render area.
+     */
+    bool ClearAttachment(vk::Image image, vk::ImageAspectFlags aspect, vk::Rect2D rect,
+                         vk::ClearValue clear);
+
     /// Creates the renderpass used when rendering to the swapchain
     void CreatePresentRenderpass(vk::Format format);
 
     /// Returns the renderpass associated with the color-depth format pair
     vk::RenderPass GetRenderpass(VideoCore::PixelFormat color, VideoCore::PixelFormat depth,
-                                 bool is_clear);
+                                 bool clear_color, bool clear_depth);
 
     /// Returns the swapchain clear renderpass
     [[nodiscard]] vk::RenderPass GetPresentRenderpass() const {
@@ -83,9 +145,17 @@ private:
 
     /// Creates a renderpass configured appropriately and stores it in cached_renderpasses
     vk::RenderPass CreateRenderPass(vk::Format color, vk::Format depth,
-                                    vk::AttachmentLoadOp load_op, vk::ImageLayout initial_layout,
+                                    vk::AttachmentLoadOp color_load_op,
+                                    vk::AttachmentLoadOp depth_load_op,
+                                    vk::ImageLayout initial_layout,
                                     vk::ImageLayout final_layout) const;
 
+    /// Records the deferred clears outside of a rendering scope
+    void FlushClears();
+
+    /// Records the deferred uploads outside of a rendering scope
+    void FlushUploads();
+
     /// Creates a new Vulkan framebuffer object
     vk::Framebuffer CreateFramebuffer(const FramebufferInfo& info, vk::RenderPass renderpass);
 
@@ -94,6 +164,8 @@ private:
         vk::ImageAspectFlags aspect;
         vk::Image image;
         vk::ImageView image_view;
+        vk::ClearValue clear;
+        bool do_clear;
 
         operator bool() const noexcept {
             return image;
@@ -108,22 +180,22 @@ private:
         RenderTarget color;
         RenderTarget depth;
         vk::Rect2D render_area;
-        vk::ClearValue clear;
-        bool do_clear;
 
         [[nodiscard]] bool operator==(const RenderingInfo& other) const {
             return color == other.color && depth == other.depth &&
-                   render_area == other.render_area && do_clear == other.do_clear &&
-                   std::memcmp(&clear, &other.clear, sizeof(vk::ClearValue)) == 0;
+                   render_area == other.render_area;
         }
     };
 
     const Instance& instance;
     Scheduler& scheduler;
     vk::RenderPass present_renderpass{};
-    vk::RenderPass cached_renderpasses[MAX_COLOR_FORMATS + 1][MAX_DEPTH_FORMATS + 1][2];
+    vk::RenderPass cached_renderpasses[MAX_COLOR_FORMATS + 1][MAX_DEPTH_FORMATS + 1][2][2];
     std::unordered_map<FramebufferInfo, vk::Framebuffer> framebuffers;
     RenderingInfo info{};
+    std::vector<PendingClear> pending_clears;
+    std::vector<PendingUpload> pending_uploads;
+    std::atomic<u64> elided_clears{};
     bool rendering = false;
     bool dynamic_rendering = false;
     u32 cmd_count{};
@@ -128,12 +128,13 @@ void DescriptorPool::Allocate(std::size_t begin, std::size_t end) {
     vk::DescriptorPool& pool = pools.emplace_back();
 
     // Choose a sane pool size good for most games
-    static constexpr std::array<vk::DescriptorPoolSize, 5> pool_sizes = {{
+    static constexpr std::array<vk::DescriptorPoolSize, 6> pool_sizes = {{
         {vk::DescriptorType::eUniformBufferDynamic, 32},
         {vk::DescriptorType::eUniformTexelBuffer, 32},
         {vk::DescriptorType::eCombinedImageSampler, 8192},
         {vk::DescriptorType::eSampledImage, 1024},
         {vk::DescriptorType::eStorageImage, 1024},
+        {vk::DescriptorType::eStorageBuffer, 256},
     }};
 
     const vk::DescriptorPoolCreateInfo descriptor_pool_info = {
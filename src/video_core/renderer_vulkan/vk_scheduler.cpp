@@ -11,6 +11,7 @@
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 
 MICROPROFILE_DEFINE(Vulkan_WaitForWorker, "Vulkan", "Wait for worker", MP_RGB(255, 192, 192));
+MICROPROFILE_DEFINE(Vulkan_WaitForGpu, "Vulkan", "Wait for GPU", MP_RGB(255, 128, 128));
 MICROPROFILE_DEFINE(Vulkan_Submit, "Vulkan", "Submit Exectution", MP_RGB(255, 192, 255));
 
 namespace Vulkan {
@@ -24,6 +25,7 @@ void Scheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf) {
         command = next;
     }
     submit = false;
+    recorded_counts = 0;
     command_offset = 0;
     first = nullptr;
     last = nullptr;
@@ -40,7 +42,18 @@ Scheduler::Scheduler(const Instance& instance, RenderpassCache& renderpass_cache
     }
 }
 
-Scheduler::~Scheduler() = default;
+Scheduler::~Scheduler() {
+    using std::chrono::duration_cast, std::chrono::milliseconds;
+    LOG_DEBUG(Render_Vulkan,
+              "Blocked on the worker {} times for {} ms, on the GPU {} times for {} ms",
+              worker_waits.count, duration_cast<milliseconds>(worker_waits.time).count(),
+              gpu_waits.count, duration_cast<milliseconds>(gpu_waits.time).count());
+}
+
+void Scheduler::WaitStats::Add(std::chrono::steady_clock::time_point start) {
+    count++;
+    time += std::chrono::steady_clock::now() - start;
+}
 
 void Scheduler::Flush(vk::Semaphore signal, vk::Semaphore wait) {
     // When flushing, we only send data to the worker thread; no waiting is necessary.
@@ -61,6 +74,7 @@ void Scheduler::WaitWorker() {
 
     MICROPROFILE_SCOPE(Vulkan_WaitForWorker);
     DispatchWork();
+    const auto start = std::chrono::steady_clock::now();
 
     // Ensure the queue is drained.
     {
@@ -71,6 +85,7 @@ void Scheduler::WaitWorker() {
     // Now wait for execution to finish.
     // This needs to be done in the same order as WorkerThread.
     std::scoped_lock el{execution_mutex};
+    worker_waits.Add(start);
 }
 
 void Scheduler::Wait(u64 tick) {
@@ -78,7 +93,14 @@ void Scheduler::Wait(u64 tick) {
         // Make sure we are not waiting for the current tick without signalling
         Flush();
     }
+    if (master_semaphore.IsFree(tick)) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(Vulkan_WaitForGpu);
+    const auto start = std::chrono::steady_clock::now();
     master_semaphore.Wait(tick);
+    gpu_waits.Add(start);
 }
 
 void Scheduler::DispatchWork() {
@@ -97,6 +119,7 @@ void Scheduler::DispatchWork() {
 
 void Scheduler::WorkerThread(std::stop_token stop_token) {
     Common::SetCurrentThreadName("VulkanWorker");
+    Common::SetCurrentThreadRole(Common::ThreadRole::Render);
 
     const auto TryPopQueue{[this](auto& work) -> bool {
         if (work_queue.empty()) {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <memory>
@@ -198,6 +199,14 @@ private:
     void AcquireNewChunk();
 
 private:
+    /// Time the emulation thread spent blocked on a sync point
+    struct WaitStats {
+        void Add(std::chrono::steady_clock::time_point start);
+
+        u64 count = 0;
+        std::chrono::steady_clock::duration time{};
+    };
+
     const Instance& instance;
     RenderpassCache& renderpass_cache;
     MasterSemaphore master_semaphore;
@@ -213,6 +222,8 @@ private:
     std::condition_variable_any event_cv;
     std::jthread worker_thread;
     bool use_worker_thread;
+    WaitStats worker_waits;
+    WaitStats gpu_waits;
 };
 
 } // namespace Vulkan
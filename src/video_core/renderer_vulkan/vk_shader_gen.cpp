@@ -207,6 +207,8 @@ void PicaShaderConfigCommon::Init(const Pica::RasterizerRegs& rasterizer,
     swizzle_hash = setup.GetSwizzleDataHash();
     main_offset = regs.main_offset;
     sanitize_mul = VideoCore::g_hw_shader_accurate_mul;
+    static_bool_mask = 0;
+    static_bool_values = 0;
 
     num_outputs = 0;
     load_flags.fill(AttribLoadFlags::Float);
@@ -1644,7 +1646,8 @@ std::optional<std::string> GenerateVertexShader(const Pica::Shader::ShaderSetup&
 
     auto program_source_opt = OpenGL::ShaderDecompiler::DecompileProgram(
         setup.program_code, setup.swizzle_data, config.state.main_offset, get_input_reg,
-        get_output_reg, config.state.sanitize_mul);
+        get_output_reg, config.state.sanitize_mul, false,
+        {config.state.static_bool_mask, config.state.static_bool_values});
 
     if (!program_source_opt) {
         return std::nullopt;
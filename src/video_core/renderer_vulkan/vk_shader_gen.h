@@ -163,6 +163,9 @@ struct PicaShaderConfigCommon {
     u64 swizzle_hash;
     u32 main_offset;
     bool sanitize_mul;
+    // Bool uniforms folded into constants and their values, see BoolUniformSpecializer
+    u16 static_bool_mask;
+    u16 static_bool_values;
 
     u32 num_outputs;
     // Load operations to apply to the input vertex data
@@ -13,9 +13,29 @@ using TevStageConfig = TexturingRegs::TevStageConfig;
 
 namespace Vulkan {
 
-FragmentModule::FragmentModule(const PicaFSConfig& config)
-    : Sirit::Module{0x00010300}, config{config} {
+SpirvModule::SpirvModule() : Sirit::Module{0x00010300} {
     DefineArithmeticTypes();
+}
+
+SpirvModule::~SpirvModule() = default;
+
+void SpirvModule::DefineArithmeticTypes() {
+    void_id = Name(TypeVoid(), "void_id");
+    bool_id = Name(TypeBool(), "bool_id");
+    f32_id = Name(TypeFloat(32), "f32_id");
+    i32_id = Name(TypeSInt(32), "i32_id");
+    u32_id = Name(TypeUInt(32), "u32_id");
+
+    for (u32 size = 2; size <= 4; size++) {
+        const u32 i = size - 2;
+        vec_ids.ids[i] = Name(TypeVector(f32_id, size), fmt::format("vec{}_id", size));
+        ivec_ids.ids[i] = Name(TypeVector(i32_id, size), fmt::format("ivec{}_id", size));
+        uvec_ids.ids[i] = Name(TypeVector(u32_id, size), fmt::format("uvec{}_id", size));
+        bvec_ids.ids[i] = Name(TypeVector(bool_id, size), fmt::format("bvec{}_id", size));
+    }
+}
+
+FragmentModule::FragmentModule(const PicaFSConfig& config) : config{config} {
     DefineUniformStructs();
     DefineInterface();
     if (config.state.proctex.enable) {
@@ -1397,22 +1417,6 @@ Id FragmentModule::AppendAlphaCombiner(TevStageConfig::Operation operation) {
     return OpFClamp(f32_id, color, ConstF32(0.f), ConstF32(1.f));
 }
 
-void FragmentModule::DefineArithmeticTypes() {
-    void_id = Name(TypeVoid(), "void_id");
-    bool_id = Name(TypeBool(), "bool_id");
-    f32_id = Name(TypeFloat(32), "f32_id");
-    i32_id = Name(TypeSInt(32), "i32_id");
-    u32_id = Name(TypeUInt(32), "u32_id");
-
-    for (u32 size = 2; size <= 4; size++) {
-        const u32 i = size - 2;
-        vec_ids.ids[i] = Name(TypeVector(f32_id, size), fmt::format("vec{}_id", size));
-        ivec_ids.ids[i] = Name(TypeVector(i32_id, size), fmt::format("ivec{}_id", size));
-        uvec_ids.ids[i] = Name(TypeVector(u32_id, size), fmt::format("uvec{}_id", size));
-        bvec_ids.ids[i] = Name(TypeVector(bool_id, size), fmt::format("bvec{}_id", size));
-    }
-}
-
 void FragmentModule::DefineEntryPoint() {
     AddCapability(spv::Capability::Shader);
     AddCapability(spv::Capability::SampledBuffer);
@@ -1505,4 +1509,999 @@ std::vector<u32> GenerateFragmentShaderSPV(const PicaFSConfig& config) {
     return module.Assemble();
 }
 
+namespace {
+
+using OpenGL::ShaderDecompiler::ExitMethod;
+using OpenGL::ShaderDecompiler::PROGRAM_END;
+using nihstro::OpCode;
+using nihstro::SwizzlePattern;
+using nihstro::RegisterType;
+using VSOutputAttributes = RasterizerRegs::VSOutputAttributes;
+
+class DecompileFail : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// An adaptor for getting the swizzle components from nihstro interfaces
+template <SwizzlePattern::Selector (SwizzlePattern::*getter)(int) const>
+std::array<u32, 4> GetSelector(const SwizzlePattern& pattern) {
+    std::array<u32, 4> selector;
+    for (int i = 0; i < 4; ++i) {
+        selector[i] = static_cast<u32>((pattern.*getter)(i));
+    }
+    return selector;
+}
+
+constexpr auto GetSelectorSrc1 = GetSelector<&SwizzlePattern::GetSelectorSrc1>;
+constexpr auto GetSelectorSrc2 = GetSelector<&SwizzlePattern::GetSelectorSrc2>;
+constexpr auto GetSelectorSrc3 = GetSelector<&SwizzlePattern::GetSelectorSrc3>;
+
+} // Anonymous namespace
+
+VertexModule::VertexModule(const Pica::Shader::ShaderSetup& setup, const PicaVSConfig& config)
+    : setup{setup}, config{config} {
+    DefineInterface();
+}
+
+VertexModule::~VertexModule() = default;
+
+bool VertexModule::Generate() {
+    auto analyzed = OpenGL::ShaderDecompiler::AnalyzeControlFlow(setup.program_code,
+                                                                 config.state.main_offset);
+    if (!analyzed) {
+        return false;
+    }
+    subroutines = std::move(*analyzed);
+    if (config.state.sanitize_mul) {
+        mul_analysis.emplace(setup.program_code, setup.swizzle_data);
+    }
+
+    try {
+        for (const Subroutine& subroutine : subroutines) {
+            AnalyzeSubroutine(subroutine);
+        }
+        DefineSubroutine(GetSubroutine(config.state.main_offset, PROGRAM_END));
+        DefineMain();
+    } catch (const DecompileFail& exception) {
+        LOG_INFO(HW_GPU, "Shader decompilation failed: {}", exception.what());
+        return false;
+    }
+    if (mul_analysis) {
+        LOG_DEBUG(HW_GPU, "Accurate multiplication skipped for {} of {} multiplications",
+                  num_multiplications - num_sanitized_multiplications, num_multiplications);
+    }
+    return true;
+}
+
+const VertexModule::Subroutine& VertexModule::GetSubroutine(u32 begin, u32 end) const {
+    const auto iter = subroutines.find(Subroutine{begin, end});
+    ASSERT(iter != subroutines.end());
+    return *iter;
+}
+
+u32 VertexModule::ScanInstr(u32 offset, std::set<const Subroutine*>& callees) const {
+    // Mirrors the offsets returned by CompileInstr
+    const Instruction instr = {setup.program_code[offset]};
+    switch (instr.opcode.Value()) {
+    case OpCode::Id::END:
+        return PROGRAM_END;
+    case OpCode::Id::CALL:
+    case OpCode::Id::CALLC:
+    case OpCode::Id::CALLU: {
+        const Subroutine& call_sub =
+            GetSubroutine(instr.flow_control.dest_offset,
+                          instr.flow_control.dest_offset + instr.flow_control.num_instructions);
+        callees.insert(&call_sub);
+        if (instr.opcode.Value() == OpCode::Id::CALL &&
+            call_sub.exit_method == ExitMethod::AlwaysEnd) {
+            return PROGRAM_END;
+        }
+        return offset + 1;
+    }
+    case OpCode::Id::IFC:
+    case OpCode::Id::IFU: {
+        const u32 else_offset = instr.flow_control.dest_offset;
+        const u32 endif_offset = else_offset + instr.flow_control.num_instructions;
+        const Subroutine& if_sub = GetSubroutine(offset + 1, else_offset);
+        callees.insert(&if_sub);
+        if (instr.flow_control.num_instructions == 0) {
+            return else_offset;
+        }
+        const Subroutine& else_sub = GetSubroutine(else_offset, endif_offset);
+        callees.insert(&else_sub);
+        if (if_sub.exit_method == ExitMethod::AlwaysEnd &&
+            else_sub.exit_method == ExitMethod::AlwaysEnd) {
+            return PROGRAM_END;
+        }
+        return endif_offset;
+    }
+    case OpCode::Id::LOOP: {
+        const Subroutine& loop_sub = GetSubroutine(offset + 1, instr.flow_control.dest_offset + 1);
+        callees.insert(&loop_sub);
+        if (loop_sub.exit_method == ExitMethod::AlwaysEnd) {
+            return PROGRAM_END;
+        }
+        return instr.flow_control.dest_offset + 1;
+    }
+    default:
+        return offset + 1;
+    }
+}
+
+void VertexModule::AnalyzeSubroutine(const Subroutine& subroutine) {
+    SubroutineInfo& info = infos[&subroutine];
+    const auto scan_range = [&](u32 begin, u32 end) {
+        u32 program_counter = begin;
+        while (program_counter < (begin > end ? PROGRAM_END : end)) {
+            program_counter = ScanInstr(program_counter, info.callees);
+        }
+        return program_counter;
+    };
+
+    if (subroutine.labels.empty()) {
+        scan_range(subroutine.begin, subroutine.end);
+        return;
+    }
+
+    // The jump table needs every case up front, including the ones that are
+    // only discovered when an IF or LOOP block straddles a label
+    info.labels = subroutine.labels;
+    info.labels.insert(subroutine.begin);
+    for (auto it = info.labels.begin(); it != info.labels.end(); ++it) {
+        const auto next_it = info.labels.upper_bound(*it);
+        const u32 next_label = next_it == info.labels.end() ? subroutine.end : *next_it;
+        const u32 compile_end = scan_range(*it, next_label);
+        if (compile_end > next_label && compile_end != PROGRAM_END) {
+            info.labels.insert(compile_end);
+        }
+    }
+}
+
+void VertexModule::DefineSubroutine(const Subroutine& subroutine) {
+    SubroutineInfo& info = infos.at(&subroutine);
+    if (info.function) {
+        return;
+    }
+    // SPIR-V ids can't be referenced before they are emitted, so define the callees first.
+    // The control flow analysis rejects recursive programs.
+    for (const Subroutine* callee : info.callees) {
+        DefineSubroutine(*callee);
+    }
+
+    const Id function{OpFunction(bool_id, spv::FunctionControlMask::MaskNone,
+                                 TypeFunction(bool_id))};
+    Name(function, subroutine.GetName());
+    BeginBlock(OpLabel());
+
+    if (info.labels.empty()) {
+        const u32 compile_end = CompileRange(subroutine.begin, subroutine.end);
+        if (compile_end != PROGRAM_END) {
+            Return(false_id);
+        } else if (!block_terminated) {
+            OpUnreachable();
+        }
+    } else {
+        jmp_to = DefineVar(u32_id, spv::StorageClass::Private);
+        OpStore(jmp_to, ConstU32(subroutine.begin));
+
+        const Id loop_header{OpLabel()};
+        const Id loop_body{OpLabel()};
+        const Id loop_continue{OpLabel()};
+        const Id loop_merge{OpLabel()};
+        const Id default_label{OpLabel()};
+        switch_merge_label = OpLabel();
+
+        std::vector<Sirit::Literal> literals;
+        std::vector<Id> case_labels;
+        for (const u32 label : info.labels) {
+            literals.emplace_back(label);
+            case_labels.push_back(OpLabel());
+        }
+
+        Branch(loop_header);
+        BeginBlock(loop_header);
+        OpLoopMerge(loop_merge, loop_continue, spv::LoopControlMask::MaskNone);
+        OpBranch(loop_body);
+
+        BeginBlock(loop_body);
+        OpSelectionMerge(switch_merge_label, spv::SelectionControlMask::MaskNone);
+        OpSwitch(OpLoad(u32_id, jmp_to), default_label, literals, case_labels);
+
+        std::size_t case_index = 0;
+        for (auto it = info.labels.begin(); it != info.labels.end(); ++it, ++case_index) {
+            BeginBlock(case_labels[case_index]);
+
+            const auto next_it = info.labels.upper_bound(*it);
+            const u32 next_label = next_it == info.labels.end() ? subroutine.end : *next_it;
+            const u32 compile_end = CompileRange(*it, next_label);
+            if (compile_end == PROGRAM_END) {
+                if (!block_terminated) {
+                    OpUnreachable();
+                    block_terminated = true;
+                }
+            } else if (next_it == info.labels.end() && compile_end <= next_label) {
+                if (!block_terminated) {
+                    Return(false_id);
+                }
+            } else if (!block_terminated) {
+                // Cases don't fall through, jump to the next one instead
+                OpStore(jmp_to, ConstU32(std::max(compile_end, next_label)));
+                Branch(switch_merge_label);
+            }
+        }
+
+        BeginBlock(default_label);
+        Return(false_id);
+
+        BeginBlock(switch_merge_label);
+        Branch(loop_continue);
+        BeginBlock(loop_continue);
+        Branch(loop_header);
+
+        BeginBlock(loop_merge);
+        OpUnreachable();
+    }
+
+    OpFunctionEnd();
+    info.function = function;
+}
+
+void VertexModule::DefineMain() {
+    const Id main_func{OpFunction(void_id, spv::FunctionControlMask::MaskNone,
+                                  TypeFunction(void_id))};
+    BeginBlock(OpLabel());
+
+    for (const Id reg : reg_tmp) {
+        OpStore(reg, ConstF32(0.f, 0.f, 0.f, 1.f));
+    }
+    for (const Id attr : vs_out_attr) {
+        OpStore(attr, ConstF32(0.f, 0.f, 0.f, 1.f));
+    }
+    OpStore(conditional_code, ConstantComposite(bvec_ids.Get(2), false_id, false_id));
+    OpStore(address_registers, ConstS32(0, 0, 0));
+
+    // Convert the attributes that were read by the program to float
+    for (u32 i = 0; i < static_cast<u32>(vs_in_reg.size()); ++i) {
+        if (!vs_in_reg[i].value) {
+            continue;
+        }
+        const AttribLoadFlags flags = config.state.load_flags[i];
+        Id value;
+        if (True(flags & AttribLoadFlags::Sint)) {
+            const Id input{DefineInput(ivec_ids.Get(4), i)};
+            interfaces.push_back(input);
+            value = OpConvertSToF(vec_ids.Get(4), OpLoad(ivec_ids.Get(4), input));
+        } else if (True(flags & AttribLoadFlags::Uint)) {
+            const Id input{DefineInput(uvec_ids.Get(4), i)};
+            interfaces.push_back(input);
+            value = OpConvertUToF(vec_ids.Get(4), OpLoad(uvec_ids.Get(4), input));
+        } else {
+            const Id input{DefineInput(vec_ids.Get(4), i)};
+            interfaces.push_back(input);
+            value = OpLoad(vec_ids.Get(4), input);
+        }
+        if (True(flags & AttribLoadFlags::ZeroW)) {
+            value = OpCompositeInsert(vec_ids.Get(4), ConstF32(0.f), value, 3);
+        }
+        OpStore(vs_in_reg[i], value);
+    }
+
+    const Subroutine& program_main = GetSubroutine(config.state.main_offset, PROGRAM_END);
+    OpFunctionCall(bool_id, *infos.at(&program_main).function);
+
+    if (!config.state.use_geometry_shader) {
+        WriteVertexOutputs();
+    }
+
+    OpReturn();
+    OpFunctionEnd();
+
+    AddCapability(spv::Capability::Shader);
+    if (config.use_clip_planes && !config.state.use_geometry_shader) {
+        AddCapability(spv::Capability::ClipDistance);
+    }
+    SetMemoryModel(spv::AddressingModel::Logical, spv::MemoryModel::GLSL450);
+    AddEntryPoint(spv::ExecutionModel::Vertex, main_func, "main", interfaces);
+}
+
+void VertexModule::WriteVertexOutputs() {
+    std::vector<Id> attributes;
+    for (u32 i = 0; i < config.state.gs_output_attributes && i < vs_out_attr.size(); ++i) {
+        attributes.push_back(OpLoad(vec_ids.Get(4), vs_out_attr[i]));
+    }
+    const auto semantic = [&](VSOutputAttributes::Semantic slot_semantic) -> Id {
+        const u32 slot = static_cast<u32>(slot_semantic);
+        const u32 attrib = config.state.semantic_maps[slot].attribute_index;
+        const u32 comp = config.state.semantic_maps[slot].component_index;
+        if (attrib < attributes.size()) {
+            return OpCompositeExtract(f32_id, attributes[attrib], comp);
+        }
+        return ConstF32(0.f);
+    };
+
+    const Id pos_z{semantic(VSOutputAttributes::POSITION_Z)};
+    const Id pos_w{semantic(VSOutputAttributes::POSITION_W)};
+    const Id vtx_pos{OpCompositeConstruct(vec_ids.Get(4), semantic(VSOutputAttributes::POSITION_X),
+                                          semantic(VSOutputAttributes::POSITION_Y), pos_z, pos_w)};
+    const Id depth{OpFMul(f32_id, OpFAdd(f32_id, pos_z, pos_w), ConstF32(0.5f))};
+    OpStore(gl_position_id, OpCompositeInsert(vec_ids.Get(4), depth, vtx_pos, 2));
+
+    if (config.use_clip_planes) {
+        // Fixed PICA clipping plane z <= 0
+        const Id clip_ptr{TypePointer(spv::StorageClass::Output, f32_id)};
+        OpStore(OpAccessChain(clip_ptr, gl_clip_distance_id, ConstS32(0)),
+                OpFNegate(f32_id, pos_z));
+
+        const Id uniform_u32_ptr{TypePointer(spv::StorageClass::Uniform, u32_id)};
+        const Id uniform_vec4_ptr{TypePointer(spv::StorageClass::Uniform, vec_ids.Get(4))};
+        const Id enable_clip1{OpINotEqual(
+            bool_id, OpLoad(u32_id, OpAccessChain(uniform_u32_ptr, shader_data_id, ConstS32(0))),
+            ConstU32(0u))};
+        const Id clip_coef{OpLoad(vec_ids.Get(4),
+                                  OpAccessChain(uniform_vec4_ptr, shader_data_id, ConstS32(1)))};
+        OpStore(OpAccessChain(clip_ptr, gl_clip_distance_id, ConstS32(1)),
+                OpSelect(f32_id, enable_clip1, OpDot(f32_id, clip_coef, vtx_pos), ConstF32(0.f)));
+    }
+
+    OpStore(normquat_id, OpCompositeConstruct(vec_ids.Get(4),
+                                              semantic(VSOutputAttributes::QUATERNION_X),
+                                              semantic(VSOutputAttributes::QUATERNION_Y),
+                                              semantic(VSOutputAttributes::QUATERNION_Z),
+                                              semantic(VSOutputAttributes::QUATERNION_W)));
+
+    const Id vtx_color{OpCompositeConstruct(vec_ids.Get(4), semantic(VSOutputAttributes::COLOR_R),
+                                            semantic(VSOutputAttributes::COLOR_G),
+                                            semantic(VSOutputAttributes::COLOR_B),
+                                            semantic(VSOutputAttributes::COLOR_A))};
+    OpStore(primary_color_id, OpFMin(vec_ids.Get(4), OpFAbs(vec_ids.Get(4), vtx_color),
+                                     ConstF32(1.f, 1.f, 1.f, 1.f)));
+
+    OpStore(texcoord0_id, OpCompositeConstruct(vec_ids.Get(2),
+                                               semantic(VSOutputAttributes::TEXCOORD0_U),
+                                               semantic(VSOutputAttributes::TEXCOORD0_V)));
+    OpStore(texcoord1_id, OpCompositeConstruct(vec_ids.Get(2),
+                                               semantic(VSOutputAttributes::TEXCOORD1_U),
+                                               semantic(VSOutputAttributes::TEXCOORD1_V)));
+    OpStore(texcoord0_w_id, semantic(VSOutputAttributes::TEXCOORD0_W));
+    OpStore(view_id, OpCompositeConstruct(vec_ids.Get(3), semantic(VSOutputAttributes::VIEW_X),
+                                          semantic(VSOutputAttributes::VIEW_Y),
+                                          semantic(VSOutputAttributes::VIEW_Z)));
+    OpStore(texcoord2_id, OpCompositeConstruct(vec_ids.Get(2),
+                                               semantic(VSOutputAttributes::TEXCOORD2_U),
+                                               semantic(VSOutputAttributes::TEXCOORD2_V)));
+}
+
+u32 VertexModule::CompileRange(u32 begin, u32 end) {
+    u32 program_counter;
+    for (program_counter = begin; program_counter < (begin > end ? PROGRAM_END : end);) {
+        program_counter = CompileInstr(program_counter);
+    }
+    return program_counter;
+}
+
+void VertexModule::CallSubroutine(const Subroutine& subroutine) {
+    const Id function{*infos.at(&subroutine).function};
+    const Id program_ended{OpFunctionCall(bool_id, function)};
+    switch (subroutine.exit_method) {
+    case ExitMethod::AlwaysEnd:
+        Return(true_id);
+        break;
+    case ExitMethod::Conditional:
+        If(program_ended, [&] { Return(true_id); });
+        break;
+    default:
+        break;
+    }
+}
+
+Id VertexModule::EvaluateCondition(Instruction::FlowControlType flow_control) {
+    using Op = Instruction::FlowControlType::Op;
+
+    const Id code{OpLoad(bvec_ids.Get(2), conditional_code)};
+    const Id code_x{OpCompositeExtract(bool_id, code, 0)};
+    const Id code_y{OpCompositeExtract(bool_id, code, 1)};
+    const Id result_x{flow_control.refx.Value() ? code_x : OpLogicalNot(bool_id, code_x)};
+    const Id result_y{flow_control.refy.Value() ? code_y : OpLogicalNot(bool_id, code_y)};
+
+    switch (flow_control.op) {
+    case Op::JustX:
+        return result_x;
+    case Op::JustY:
+        return result_y;
+    case Op::Or:
+        return OpLogicalOr(bool_id, result_x, result_y);
+    case Op::And:
+        return OpLogicalAnd(bool_id, result_x, result_y);
+    default:
+        UNREACHABLE();
+        return false_id;
+    }
+}
+
+Id VertexModule::GetUniformBool(u32 index) {
+    if ((config.state.static_bool_mask >> index) & 1) {
+        return ((config.state.static_bool_values >> index) & 1) ? true_id : false_id;
+    }
+    const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, u32_id)};
+    const Id value{
+        OpLoad(u32_id, OpAccessChain(uniform_ptr, vs_uniforms_id, ConstS32(0), ConstU32(index)))};
+    return OpINotEqual(bool_id, value, ConstU32(0u));
+}
+
+Id VertexModule::GetInputRegister(u32 index) {
+    if (!vs_in_reg[index].value) {
+        vs_in_reg[index] = DefineVar(vec_ids.Get(4), spv::StorageClass::Private);
+        Name(vs_in_reg[index], fmt::format("vs_in_reg{}", index));
+    }
+    return vs_in_reg[index];
+}
+
+Id VertexModule::GetSourceRegister(const SourceRegister& source_reg, u32 address_register_index,
+                                   const std::array<u32, 4>& selector, bool negate) {
+    const u32 index = static_cast<u32>(source_reg.GetIndex());
+
+    Id value;
+    switch (source_reg.GetRegisterType()) {
+    case RegisterType::Input:
+        value = OpLoad(vec_ids.Get(4), GetInputRegister(index));
+        break;
+    case RegisterType::Temporary:
+        value = OpLoad(vec_ids.Get(4), reg_tmp[index]);
+        break;
+    case RegisterType::FloatUniform: {
+        const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, vec_ids.Get(4))};
+        if (address_register_index == 0) {
+            value = OpLoad(vec_ids.Get(4), OpAccessChain(uniform_ptr, vs_uniforms_id, ConstS32(2),
+                                                         ConstU32(index)));
+            break;
+        }
+        // TODO: Verify hardware behavior of out-of-bounds register number.
+        const Id offset{OpCompositeExtract(i32_id, OpLoad(ivec_ids.Get(3), address_registers),
+                                           address_register_index - 1)};
+        const Id uniform_index{OpBitcast(u32_id, OpIAdd(i32_id, ConstS32(index), offset))};
+        const Id in_bounds{OpULessThan(bool_id, uniform_index, ConstU32(96u))};
+        const Id safe_index{OpSelect(u32_id, in_bounds, uniform_index, ConstU32(0u))};
+        const Id uniform{OpLoad(vec_ids.Get(4), OpAccessChain(uniform_ptr, vs_uniforms_id,
+                                                              ConstS32(2), safe_index))};
+        value = OpSelect(vec_ids.Get(4), in_bounds, uniform, ConstF32(0.f, 0.f, 0.f, 0.f));
+        break;
+    }
+    default:
+        UNREACHABLE();
+        return ConstF32(0.f, 0.f, 0.f, 0.f);
+    }
+
+    value = OpVectorShuffle(vec_ids.Get(4), value, value, selector[0], selector[1], selector[2],
+                            selector[3]);
+    return negate ? OpFNegate(vec_ids.Get(4), value) : value;
+}
+
+std::optional<Id> VertexModule::GetDestRegister(const DestRegister& dest_reg) const {
+    const u32 index = static_cast<u32>(dest_reg.GetIndex());
+
+    switch (dest_reg.GetRegisterType()) {
+    case RegisterType::Output: {
+        const u32 attribute = config.state.output_map[index];
+        if (attribute < vs_out_attr.size()) {
+            return vs_out_attr[attribute];
+        }
+        return std::nullopt;
+    }
+    case RegisterType::Temporary:
+        return reg_tmp[index];
+    default:
+        UNREACHABLE();
+        return std::nullopt;
+    }
+}
+
+void VertexModule::SetDest(const SwizzlePattern& swizzle, std::optional<Id> reg, Id value,
+                           u32 value_num_components) {
+    std::array<u32, 4> components;
+    bool any_enabled = false;
+    bool all_enabled = true;
+    for (u32 i = 0; i < 4; ++i) {
+        const bool enabled = swizzle.DestComponentEnabled(static_cast<int>(i));
+        components[i] = enabled ? 4 + i : i;
+        any_enabled |= enabled;
+        all_enabled &= enabled;
+    }
+    if (!reg || !any_enabled) {
+        return;
+    }
+
+    if (value_num_components == 1) {
+        value = OpCompositeConstruct(vec_ids.Get(4), value, value, value, value);
+    }
+    if (!all_enabled) {
+        const Id old_value{OpLoad(vec_ids.Get(4), *reg)};
+        value = OpVectorShuffle(vec_ids.Get(4), old_value, value, components[0], components[1],
+                                components[2], components[3]);
+    }
+    OpStore(*reg, value);
+}
+
+Id VertexModule::SanitizeMul(Id lhs, Id rhs) {
+    const Id product{OpFMul(vec_ids.Get(4), lhs, rhs)};
+    const Id product_nan{OpIsNan(bvec_ids.Get(4), product)};
+    const Id zero{ConstF32(0.f, 0.f, 0.f, 0.f)};
+#ifdef ANDROID
+    // Use a cheaper sanitize_mul on Android, as mobile GPUs struggle here
+    return OpSelect(vec_ids.Get(4), product_nan, zero, product);
+#else
+    // Keep the NaN if it came from one of the operands
+    const Id operand_nan{OpLogicalOr(bvec_ids.Get(4), OpIsNan(bvec_ids.Get(4), lhs),
+                                     OpIsNan(bvec_ids.Get(4), rhs))};
+    const Id zero_times_inf{
+        OpLogicalAnd(bvec_ids.Get(4), product_nan, OpLogicalNot(bvec_ids.Get(4), operand_nan))};
+    return OpSelect(vec_ids.Get(4), zero_times_inf, zero, product);
+#endif
+}
+
+u32 VertexModule::CompileInstr(u32 offset) {
+    const Instruction instr = {setup.program_code[offset]};
+
+    const std::size_t swizzle_offset =
+        instr.opcode.Value().GetInfo().type == OpCode::Type::MultiplyAdd
+            ? instr.mad.operand_desc_id
+            : instr.common.operand_desc_id;
+    const SwizzlePattern swizzle = {setup.swizzle_data[swizzle_offset]};
+    const bool sanitize_mul = config.state.sanitize_mul;
+    const Id vec4_id{vec_ids.Get(4)};
+    // Whether the product of the instruction, if any, may compute 0 * inf
+    const auto sanitize_product = [&] {
+        ++num_multiplications;
+        if (!sanitize_mul || !mul_analysis->NeedsSanitize(offset)) {
+            return false;
+        }
+        ++num_sanitized_multiplications;
+        return true;
+    };
+
+    switch (instr.opcode.Value().GetInfo().type) {
+    case OpCode::Type::Arithmetic: {
+        const bool is_inverted =
+            (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+
+        const Id src1{GetSourceRegister(instr.common.GetSrc1(is_inverted),
+                                        !is_inverted * instr.common.address_register_index,
+                                        GetSelectorSrc1(swizzle), swizzle.negate_src1)};
+        const Id src2{GetSourceRegister(instr.common.GetSrc2(is_inverted),
+                                        is_inverted * instr.common.address_register_index,
+                                        GetSelectorSrc2(swizzle), swizzle.negate_src2)};
+        const std::optional<Id> dest_reg{GetDestRegister(instr.common.dest.Value())};
+
+        switch (instr.opcode.Value().EffectiveOpCode()) {
+        case OpCode::Id::ADD:
+            SetDest(swizzle, dest_reg, OpFAdd(vec4_id, src1, src2), 4);
+            break;
+
+        case OpCode::Id::MUL:
+            SetDest(swizzle, dest_reg,
+                    sanitize_product() ? SanitizeMul(src1, src2) : OpFMul(vec4_id, src1, src2),
+                    4);
+            break;
+
+        case OpCode::Id::FLR:
+            SetDest(swizzle, dest_reg, OpFloor(vec4_id, src1), 4);
+            break;
+
+        case OpCode::Id::MAX:
+            SetDest(swizzle, dest_reg, OpFMax(vec4_id, src1, src2), 4);
+            break;
+
+        case OpCode::Id::MIN:
+            SetDest(swizzle, dest_reg, OpFMin(vec4_id, src1, src2), 4);
+            break;
+
+        case OpCode::Id::DP3: {
+            Id dot;
+            if (sanitize_product()) {
+                const Id product{SanitizeMul(src1, src2)};
+                dot = OpDot(f32_id, OpVectorShuffle(vec_ids.Get(3), product, product, 0, 1, 2),
+                            ConstF32(1.f, 1.f, 1.f));
+            } else {
+                dot = OpDot(f32_id, OpVectorShuffle(vec_ids.Get(3), src1, src1, 0, 1, 2),
+                            OpVectorShuffle(vec_ids.Get(3), src2, src2, 0, 1, 2));
+            }
+            SetDest(swizzle, dest_reg, dot, 1);
+            break;
+        }
+
+        case OpCode::Id::DP4:
+        case OpCode::Id::DPH:
+        case OpCode::Id::DPHI: {
+            const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+            const Id lhs{opcode == OpCode::Id::DP4
+                             ? src1
+                             : OpCompositeInsert(vec4_id, ConstF32(1.f), src1, 3)};
+            const Id dot{sanitize_product()
+                             ? OpDot(f32_id, SanitizeMul(lhs, src2), ConstF32(1.f, 1.f, 1.f, 1.f))
+                             : OpDot(f32_id, lhs, src2)};
+            SetDest(swizzle, dest_reg, dot, 1);
+            break;
+        }
+
+        case OpCode::Id::RCP:
+        case OpCode::Id::RSQ: {
+            const bool is_rcp = instr.opcode.Value().EffectiveOpCode() == OpCode::Id::RCP;
+            const Id src1_x{OpCompositeExtract(f32_id, src1, 0)};
+            const auto write = [&] {
+                const Id result{is_rcp ? OpFDiv(f32_id, ConstF32(1.f), src1_x)
+                                       : OpInverseSqrt(f32_id, src1_x)};
+                SetDest(swizzle, dest_reg, result, 1);
+            };
+            if (sanitize_mul) {
+                write();
+                break;
+            }
+            // When accurate multiplication is OFF, NaN are not really handled. This is a
+            // workaround to cheaply avoid NaN. Fixes graphical issues in Ocarina of Time.
+            const Id is_valid{is_rcp ? OpFUnordNotEqual(bool_id, src1_x, ConstF32(0.f))
+                                     : OpFOrdGreaterThan(bool_id, src1_x, ConstF32(0.f))};
+            If(is_valid, write);
+            break;
+        }
+
+        case OpCode::Id::MOVA: {
+            std::array<u32, 3> components{0, 1, 2};
+            bool any_enabled = false;
+            for (u32 i = 0; i < 2; ++i) {
+                if (swizzle.DestComponentEnabled(static_cast<int>(i))) {
+                    components[i] = 3 + i;
+                    any_enabled = true;
+                }
+            }
+            if (!any_enabled) {
+                break;
+            }
+            const Id value{OpConvertFToS(ivec_ids.Get(2),
+                                         OpVectorShuffle(vec_ids.Get(2), src1, src1, 0, 1))};
+            const Id old_value{OpLoad(ivec_ids.Get(3), address_registers)};
+            OpStore(address_registers, OpVectorShuffle(ivec_ids.Get(3), old_value, value,
+                                                       components[0], components[1],
+                                                       components[2]));
+            break;
+        }
+
+        case OpCode::Id::MOV:
+            SetDest(swizzle, dest_reg, src1, 4);
+            break;
+
+        case OpCode::Id::SGE:
+        case OpCode::Id::SGEI:
+            SetDest(swizzle, dest_reg,
+                    OpSelect(vec4_id, OpFOrdGreaterThanEqual(bvec_ids.Get(4), src1, src2),
+                             ConstF32(1.f, 1.f, 1.f, 1.f), ConstF32(0.f, 0.f, 0.f, 0.f)),
+                    4);
+            break;
+
+        case OpCode::Id::SLT:
+        case OpCode::Id::SLTI:
+            SetDest(swizzle, dest_reg,
+                    OpSelect(vec4_id, OpFOrdLessThan(bvec_ids.Get(4), src1, src2),
+                             ConstF32(1.f, 1.f, 1.f, 1.f), ConstF32(0.f, 0.f, 0.f, 0.f)),
+                    4);
+            break;
+
+        case OpCode::Id::CMP: {
+            using CompareOp = Instruction::Common::CompareOpType::Op;
+            const auto compare = [&](CompareOp op, u32 component) -> std::optional<Id> {
+                const Id lhs{OpCompositeExtract(f32_id, src1, component)};
+                const Id rhs{OpCompositeExtract(f32_id, src2, component)};
+                switch (op) {
+                case CompareOp::Equal:
+                    return OpFOrdEqual(bool_id, lhs, rhs);
+                case CompareOp::NotEqual:
+                    return OpFUnordNotEqual(bool_id, lhs, rhs);
+                case CompareOp::LessThan:
+                    return OpFOrdLessThan(bool_id, lhs, rhs);
+                case CompareOp::LessEqual:
+                    return OpFOrdLessThanEqual(bool_id, lhs, rhs);
+                case CompareOp::GreaterThan:
+                    return OpFOrdGreaterThan(bool_id, lhs, rhs);
+                case CompareOp::GreaterEqual:
+                    return OpFOrdGreaterThanEqual(bool_id, lhs, rhs);
+                default:
+                    LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", op);
+                    return std::nullopt;
+                }
+            };
+
+            const std::optional<Id> result_x{compare(instr.common.compare_op.x.Value(), 0)};
+            const std::optional<Id> result_y{compare(instr.common.compare_op.y.Value(), 1)};
+            if (result_x && result_y) {
+                OpStore(conditional_code,
+                        OpCompositeConstruct(bvec_ids.Get(2), *result_x, *result_y));
+            }
+            break;
+        }
+
+        case OpCode::Id::EX2:
+            SetDest(swizzle, dest_reg, OpExp2(f32_id, OpCompositeExtract(f32_id, src1, 0)), 1);
+            break;
+
+        case OpCode::Id::LG2:
+            SetDest(swizzle, dest_reg, OpLog2(f32_id, OpCompositeExtract(f32_id, src1, 0)), 1);
+            break;
+
+        default:
+            LOG_ERROR(HW_GPU, "Unhandled arithmetic instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)instr.opcode.Value().EffectiveOpCode(),
+                      instr.opcode.Value().GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+        break;
+    }
+
+    case OpCode::Type::MultiplyAdd: {
+        if ((instr.opcode.Value().EffectiveOpCode() != OpCode::Id::MAD) &&
+            (instr.opcode.Value().EffectiveOpCode() != OpCode::Id::MADI)) {
+            LOG_ERROR(HW_GPU, "Unhandled multiply-add instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)instr.opcode.Value().EffectiveOpCode(),
+                      instr.opcode.Value().GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+        const bool is_inverted = (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI);
+
+        const Id src1{GetSourceRegister(instr.mad.GetSrc1(is_inverted), 0,
+                                        GetSelectorSrc1(swizzle), swizzle.negate_src1)};
+        const Id src2{GetSourceRegister(instr.mad.GetSrc2(is_inverted),
+                                        !is_inverted * instr.mad.address_register_index,
+                                        GetSelectorSrc2(swizzle), swizzle.negate_src2)};
+        const Id src3{GetSourceRegister(instr.mad.GetSrc3(is_inverted),
+                                        is_inverted * instr.mad.address_register_index,
+                                        GetSelectorSrc3(swizzle), swizzle.negate_src3)};
+
+        std::optional<Id> dest_reg;
+        if (instr.mad.dest.Value() < 0x20) {
+            dest_reg = GetDestRegister(instr.mad.dest.Value());
+        }
+
+        const Id product{sanitize_product() ? SanitizeMul(src1, src2)
+                                            : OpFMul(vec4_id, src1, src2)};
+        SetDest(swizzle, dest_reg, OpFAdd(vec4_id, product, src3), 4);
+        break;
+    }
+
+    default: {
+        switch (instr.opcode.Value()) {
+        case OpCode::Id::END:
+            Return(true_id);
+            return PROGRAM_END;
+
+        case OpCode::Id::JMPC:
+        case OpCode::Id::JMPU: {
+            Id condition;
+            if (instr.opcode.Value() == OpCode::Id::JMPC) {
+                condition = EvaluateCondition(instr.flow_control);
+            } else {
+                const bool invert_test = instr.flow_control.num_instructions & 1;
+                condition = GetUniformBool(instr.flow_control.bool_uniform_id);
+                if (invert_test) {
+                    condition = OpLogicalNot(bool_id, condition);
+                }
+            }
+
+            // Jumps only appear inside the jump table of their subroutine
+            If(condition, [&] {
+                OpStore(jmp_to, ConstU32(instr.flow_control.dest_offset.Value()));
+                Branch(switch_merge_label);
+            });
+            break;
+        }
+
+        case OpCode::Id::CALL:
+        case OpCode::Id::CALLC:
+        case OpCode::Id::CALLU: {
+            const Subroutine& call_sub =
+                GetSubroutine(instr.flow_control.dest_offset,
+                              instr.flow_control.dest_offset + instr.flow_control.num_instructions);
+            if (instr.opcode.Value() == OpCode::Id::CALL) {
+                CallSubroutine(call_sub);
+                if (call_sub.exit_method == ExitMethod::AlwaysEnd) {
+                    return PROGRAM_END;
+                }
+                break;
+            }
+
+            const Id condition{instr.opcode.Value() == OpCode::Id::CALLC
+                                   ? EvaluateCondition(instr.flow_control)
+                                   : GetUniformBool(instr.flow_control.bool_uniform_id)};
+            If(condition, [&] { CallSubroutine(call_sub); });
+            break;
+        }
+
+        case OpCode::Id::NOP:
+            break;
+
+        case OpCode::Id::IFC:
+        case OpCode::Id::IFU: {
+            const Id condition{instr.opcode.Value() == OpCode::Id::IFC
+                                   ? EvaluateCondition(instr.flow_control)
+                                   : GetUniformBool(instr.flow_control.bool_uniform_id)};
+
+            const u32 if_offset = offset + 1;
+            const u32 else_offset = instr.flow_control.dest_offset;
+            const u32 endif_offset =
+                instr.flow_control.dest_offset + instr.flow_control.num_instructions;
+            const Subroutine& if_sub = GetSubroutine(if_offset, else_offset);
+
+            if (instr.flow_control.num_instructions == 0) {
+                If(condition, [&] { CallSubroutine(if_sub); });
+                return else_offset;
+            }
+
+            const Subroutine& else_sub = GetSubroutine(else_offset, endif_offset);
+            const Id then_label{OpLabel()};
+            const Id else_label{OpLabel()};
+            const Id merge_label{OpLabel()};
+            OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+            OpBranchConditional(condition, then_label, else_label);
+            BeginBlock(then_label);
+            CallSubroutine(if_sub);
+            Branch(merge_label);
+            BeginBlock(else_label);
+            CallSubroutine(else_sub);
+            Branch(merge_label);
+            BeginBlock(merge_label);
+
+            if (if_sub.exit_method == ExitMethod::AlwaysEnd &&
+                else_sub.exit_method == ExitMethod::AlwaysEnd) {
+                return PROGRAM_END;
+            }
+            return endif_offset;
+        }
+
+        case OpCode::Id::LOOP: {
+            const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, uvec_ids.Get(4))};
+            const Id int_uniform{OpLoad(
+                uvec_ids.Get(4),
+                OpAccessChain(uniform_ptr, vs_uniforms_id, ConstS32(1),
+                              ConstU32(instr.flow_control.int_uniform_id.Value())))};
+            const Id loop_count{OpCompositeExtract(u32_id, int_uniform, 0)};
+            const Id loop_start{OpBitcast(i32_id, OpCompositeExtract(u32_id, int_uniform, 1))};
+            const Id loop_step{OpBitcast(i32_id, OpCompositeExtract(u32_id, int_uniform, 2))};
+
+            const Id address_ptr{TypePointer(spv::StorageClass::Private, i32_id)};
+            const Id loop_address{OpAccessChain(address_ptr, address_registers, ConstS32(2))};
+            OpStore(loop_address, loop_start);
+
+            const Id loop_var{DefineVar(u32_id, spv::StorageClass::Private)};
+            Name(loop_var, fmt::format("loop{}", offset));
+            OpStore(loop_var, ConstU32(0u));
+
+            const Id header_label{OpLabel()};
+            const Id body_label{OpLabel()};
+            const Id continue_label{OpLabel()};
+            const Id merge_label{OpLabel()};
+            Branch(header_label);
+
+            BeginBlock(header_label);
+            const Id keep_looping{
+                OpULessThanEqual(bool_id, OpLoad(u32_id, loop_var), loop_count)};
+            OpLoopMerge(merge_label, continue_label, spv::LoopControlMask::MaskNone);
+            OpBranchConditional(keep_looping, body_label, merge_label);
+
+            BeginBlock(body_label);
+            const Subroutine& loop_sub =
+                GetSubroutine(offset + 1, instr.flow_control.dest_offset + 1);
+            CallSubroutine(loop_sub);
+            Branch(continue_label);
+
+            BeginBlock(continue_label);
+            OpStore(loop_address, OpIAdd(i32_id, OpLoad(i32_id, loop_address), loop_step));
+            OpStore(loop_var, OpIAdd(u32_id, OpLoad(u32_id, loop_var), ConstU32(1u)));
+            Branch(header_label);
+
+            BeginBlock(merge_label);
+            if (loop_sub.exit_method == ExitMethod::AlwaysEnd) {
+                return PROGRAM_END;
+            }
+            return instr.flow_control.dest_offset + 1;
+        }
+
+        case OpCode::Id::EMIT:
+        case OpCode::Id::SETEMIT:
+            LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+            break;
+
+        default:
+            LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)instr.opcode.Value().EffectiveOpCode(),
+                      instr.opcode.Value().GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+        break;
+    }
+    }
+    return offset + 1;
+}
+
+void VertexModule::DefineInterface() {
+    true_id = ConstantTrue(bool_id);
+    false_id = ConstantFalse(bool_id);
+
+    // PICA uniforms, with the bools padded to 16 bytes as in PicaUniformsData
+    const Id bool_array_id{TypeArray(u32_id, ConstU32(16u))};
+    const Id int_array_id{TypeArray(uvec_ids.Get(4), ConstU32(4u))};
+    const Id float_array_id{TypeArray(vec_ids.Get(4), ConstU32(96u))};
+    Decorate(bool_array_id, spv::Decoration::ArrayStride, 16u);
+    Decorate(int_array_id, spv::Decoration::ArrayStride, 16u);
+    Decorate(float_array_id, spv::Decoration::ArrayStride, 16u);
+
+    const Id vs_uniforms_struct_id{TypeStruct(bool_array_id, int_array_id, float_array_id)};
+    MemberDecorate(vs_uniforms_struct_id, 0, spv::Decoration::Offset, 0u);
+    MemberDecorate(vs_uniforms_struct_id, 1, spv::Decoration::Offset, 256u);
+    MemberDecorate(vs_uniforms_struct_id, 2, spv::Decoration::Offset, 320u);
+    Decorate(vs_uniforms_struct_id, spv::Decoration::Block);
+    vs_uniforms_id = AddGlobalVariable(
+        TypePointer(spv::StorageClass::Uniform, vs_uniforms_struct_id), spv::StorageClass::Uniform);
+    Decorate(vs_uniforms_id, spv::Decoration::DescriptorSet, 0);
+    Decorate(vs_uniforms_id, spv::Decoration::Binding, 0);
+
+    // Registers of the PICA shader unit
+    conditional_code = DefineVar(bvec_ids.Get(2), spv::StorageClass::Private);
+    address_registers = DefineVar(ivec_ids.Get(3), spv::StorageClass::Private);
+    for (u32 i = 0; i < static_cast<u32>(reg_tmp.size()); ++i) {
+        reg_tmp[i] = DefineVar(vec_ids.Get(4), spv::StorageClass::Private);
+        Name(reg_tmp[i], fmt::format("reg_tmp{}", i));
+    }
+
+    if (config.state.use_geometry_shader) {
+        // The geometry shader maps the attributes to the fragment shader inputs
+        for (u32 i = 0; i < config.state.num_outputs; ++i) {
+            vs_out_attr.push_back(DefineOutput(vec_ids.Get(4), i));
+            interfaces.push_back(vs_out_attr.back());
+        }
+        return;
+    }
+
+    for (u32 i = 0; i < config.state.num_outputs; ++i) {
+        vs_out_attr.push_back(DefineVar(vec_ids.Get(4), spv::StorageClass::Private));
+        Name(vs_out_attr.back(), fmt::format("vs_out_attr{}", i));
+    }
+
+    primary_color_id = DefineOutput(vec_ids.Get(4), ATTRIBUTE_COLOR);
+    texcoord0_id = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD0);
+    texcoord1_id = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD1);
+    texcoord2_id = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD2);
+    texcoord0_w_id = DefineOutput(f32_id, ATTRIBUTE_TEXCOORD0_W);
+    normquat_id = DefineOutput(vec_ids.Get(4), ATTRIBUTE_NORMQUAT);
+    view_id = DefineOutput(vec_ids.Get(3), ATTRIBUTE_VIEW);
+    gl_position_id = DefineVar(vec_ids.Get(4), spv::StorageClass::Output);
+    Decorate(gl_position_id, spv::Decoration::BuiltIn, spv::BuiltIn::Position);
+    interfaces.insert(interfaces.end(), {primary_color_id, texcoord0_id, texcoord1_id,
+                                         texcoord2_id, texcoord0_w_id, normquat_id, view_id,
+                                         gl_position_id});
+
+    if (config.use_clip_planes) {
+        gl_clip_distance_id =
+            DefineVar(TypeArray(f32_id, ConstU32(2u)), spv::StorageClass::Output);
+        Decorate(gl_clip_distance_id, spv::Decoration::BuiltIn, spv::BuiltIn::ClipDistance);
+        interfaces.push_back(gl_clip_distance_id);
+
+        // Only the members of shader_data used for clipping
+        const Id shader_data_struct_id{TypeStruct(u32_id, vec_ids.Get(4))};
+        MemberDecorate(shader_data_struct_id, 0, spv::Decoration::Offset, 72u);
+        MemberDecorate(shader_data_struct_id, 1, spv::Decoration::Offset, 1264u);
+        Decorate(shader_data_struct_id, spv::Decoration::Block);
+        shader_data_id =
+            AddGlobalVariable(TypePointer(spv::StorageClass::Uniform, shader_data_struct_id),
+                              spv::StorageClass::Uniform);
+        Decorate(shader_data_id, spv::Decoration::DescriptorSet, 0);
+        Decorate(shader_data_id, spv::Decoration::Binding, 1);
+    }
+}
+
+std::optional<std::vector<u32>> GenerateVertexShaderSPV(const Pica::Shader::ShaderSetup& setup,
+                                                        const PicaVSConfig& config) {
+    VertexModule module{setup, config};
+    if (!module.Generate()) {
+        return std::nullopt;
+    }
+    return module.Assemble();
+}
+
 } // namespace Vulkan
@@ -5,8 +5,15 @@
 #pragma once
 
 #include <array>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+#include <nihstro/shader_bytecode.h>
 #include <sirit/sirit.h>
+#include "video_core/renderer_opengl/gl_shader_decompiler.h"
 #include "video_core/renderer_vulkan/vk_shader_gen.h"
+#include "video_core/shader/shader_mul_analysis.h"
 
 namespace Vulkan {
 
@@ -21,7 +28,93 @@ struct VectorIds {
     std::array<Id, 3> ids;
 };
 
-class FragmentModule : public Sirit::Module {
+/// Arithmetic types and helpers shared by the SPIR-V shader generators
+class SpirvModule : public Sirit::Module {
+public:
+    SpirvModule();
+    ~SpirvModule();
+
+protected:
+    /// Defines a input variable
+    [[nodiscard]] Id DefineInput(Id type, u32 location) {
+        const Id input_id{DefineVar(type, spv::StorageClass::Input)};
+        Decorate(input_id, spv::Decoration::Location, location);
+        return input_id;
+    }
+
+    /// Defines a input variable
+    [[nodiscard]] Id DefineOutput(Id type, u32 location) {
+        const Id output_id{DefineVar(type, spv::StorageClass::Output)};
+        Decorate(output_id, spv::Decoration::Location, location);
+        return output_id;
+    }
+
+    template <bool global = true>
+    [[nodiscard]] Id DefineVar(Id type, spv::StorageClass storage_class) {
+        const Id pointer_type_id{TypePointer(storage_class, type)};
+        return global ? AddGlobalVariable(pointer_type_id, storage_class)
+                      : AddLocalVariable(pointer_type_id, storage_class);
+    }
+
+    /// Returns the id of a signed integer constant of value
+    [[nodiscard]] Id ConstU32(u32 value) {
+        return Constant(u32_id, value);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] Id ConstU32(Args&&... values) {
+        constexpr u32 size = static_cast<u32>(sizeof...(values));
+        static_assert(size >= 2);
+        const std::array constituents{Constant(u32_id, values)...};
+        const Id type = size <= 4 ? uvec_ids.Get(size) : TypeArray(u32_id, ConstU32(size));
+        return ConstantComposite(type, constituents);
+    }
+
+    /// Returns the id of a signed integer constant of value
+    [[nodiscard]] Id ConstS32(s32 value) {
+        return Constant(i32_id, value);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] Id ConstS32(Args&&... values) {
+        constexpr u32 size = static_cast<u32>(sizeof...(values));
+        static_assert(size >= 2);
+        const std::array constituents{Constant(i32_id, values)...};
+        const Id type = size <= 4 ? ivec_ids.Get(size) : TypeArray(i32_id, ConstU32(size));
+        return ConstantComposite(type, constituents);
+    }
+
+    /// Returns the id of a float constant of value
+    [[nodiscard]] Id ConstF32(f32 value) {
+        return Constant(f32_id, value);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] Id ConstF32(Args... values) {
+        constexpr u32 size = static_cast<u32>(sizeof...(values));
+        static_assert(size >= 2);
+        const std::array constituents{Constant(f32_id, values)...};
+        const Id type = size <= 4 ? vec_ids.Get(size) : TypeArray(f32_id, ConstU32(size));
+        return ConstantComposite(type, constituents);
+    }
+
+private:
+    void DefineArithmeticTypes();
+
+protected:
+    Id void_id{};
+    Id bool_id{};
+    Id f32_id{};
+    Id i32_id{};
+    Id u32_id{};
+
+    VectorIds vec_ids{};
+    VectorIds ivec_ids{};
+    VectorIds uvec_ids{};
+    VectorIds bvec_ids{};
+};
+
+class FragmentModule : public SpirvModule {
     static constexpr u32 NUM_TEV_STAGES = 6;
     static constexpr u32 NUM_LIGHTS = 8;
     static constexpr u32 NUM_LIGHTING_SAMPLERS = 24;
@@ -130,20 +223,6 @@ private:
         return OpCompositeConstruct(pad_type_id, vector, ConstF32(args...));
     }
 
-    /// Defines a input variable
-    [[nodiscard]] Id DefineInput(Id type, u32 location) {
-        const Id input_id{DefineVar(type, spv::StorageClass::Input)};
-        Decorate(input_id, spv::Decoration::Location, location);
-        return input_id;
-    }
-
-    /// Defines a input variable
-    [[nodiscard]] Id DefineOutput(Id type, u32 location) {
-        const Id output_id{DefineVar(type, spv::StorageClass::Output)};
-        Decorate(output_id, spv::Decoration::Location, location);
-        return output_id;
-    }
-
     /// Defines a uniform constant variable
     [[nodiscard]] Id DefineUniformConst(Id type, u32 set, u32 binding, bool readonly = false) {
         const Id uniform_id{DefineVar(type, spv::StorageClass::UniformConstant)};
@@ -155,56 +234,6 @@ private:
         return uniform_id;
     }
 
-    template <bool global = true>
-    [[nodiscard]] Id DefineVar(Id type, spv::StorageClass storage_class) {
-        const Id pointer_type_id{TypePointer(storage_class, type)};
-        return global ? AddGlobalVariable(pointer_type_id, storage_class)
-                      : AddLocalVariable(pointer_type_id, storage_class);
-    }
-
-    /// Returns the id of a signed integer constant of value
-    [[nodiscard]] Id ConstU32(u32 value) {
-        return Constant(u32_id, value);
-    }
-
-    template <typename... Args>
-    [[nodiscard]] Id ConstU32(Args&&... values) {
-        constexpr u32 size = static_cast<u32>(sizeof...(values));
-        static_assert(size >= 2);
-        const std::array constituents{Constant(u32_id, values)...};
-        const Id type = size <= 4 ? uvec_ids.Get(size) : TypeArray(u32_id, ConstU32(size));
-        return ConstantComposite(type, constituents);
-    }
-
-    /// Returns the id of a signed integer constant of value
-    [[nodiscard]] Id ConstS32(s32 value) {
-        return Constant(i32_id, value);
-    }
-
-    template <typename... Args>
-    [[nodiscard]] Id ConstS32(Args&&... values) {
-        constexpr u32 size = static_cast<u32>(sizeof...(values));
-        static_assert(size >= 2);
-        const std::array constituents{Constant(i32_id, values)...};
-        const Id type = size <= 4 ? ivec_ids.Get(size) : TypeArray(i32_id, ConstU32(size));
-        return ConstantComposite(type, constituents);
-    }
-
-    /// Returns the id of a float constant of value
-    [[nodiscard]] Id ConstF32(f32 value) {
-        return Constant(f32_id, value);
-    }
-
-    template <typename... Args>
-    [[nodiscard]] Id ConstF32(Args... values) {
-        constexpr u32 size = static_cast<u32>(sizeof...(values));
-        static_assert(size >= 2);
-        const std::array constituents{Constant(f32_id, values)...};
-        const Id type = size <= 4 ? vec_ids.Get(size) : TypeArray(f32_id, ConstU32(size));
-        return ConstantComposite(type, constituents);
-    }
-
-    void DefineArithmeticTypes();
     void DefineEntryPoint();
     void DefineUniformStructs();
     void DefineInterface();
@@ -212,16 +241,6 @@ private:
 
 private:
     PicaFSConfig config;
-    Id void_id{};
-    Id bool_id{};
-    Id f32_id{};
-    Id i32_id{};
-    Id u32_id{};
-
-    VectorIds vec_ids{};
-    VectorIds ivec_ids{};
-    VectorIds uvec_ids{};
-    VectorIds bvec_ids{};
 
     Id image2d_id{};
     Id image_cube_id{};
@@ -281,6 +300,149 @@ private:
     Id lut_offsets{};
 };
 
+class VertexModule : public SpirvModule {
+    using Subroutine = OpenGL::ShaderDecompiler::Subroutine;
+    using Instruction = nihstro::Instruction;
+    using SourceRegister = nihstro::SourceRegister;
+    using DestRegister = nihstro::DestRegister;
+    using SwizzlePattern = nihstro::SwizzlePattern;
+
+public:
+    VertexModule(const Pica::Shader::ShaderSetup& setup, const PicaVSConfig& config);
+    ~VertexModule();
+
+    /// Emits SPIR-V bytecode for the PICA vertex program, returns false if it can't be decompiled
+    [[nodiscard]] bool Generate();
+
+private:
+    /// Control flow of a subroutine that has to be known before its function is emitted
+    struct SubroutineInfo {
+        std::set<u32> labels;                ///< Jump table cases, including IF/LOOP exits
+        std::set<const Subroutine*> callees; ///< Subroutines called from this one
+        std::optional<Id> function;          ///< Function id once it has been emitted
+    };
+
+    /// Gets the Subroutine object corresponding to the specified address
+    [[nodiscard]] const Subroutine& GetSubroutine(u32 begin, u32 end) const;
+
+    /// Collects the callees of the instruction, returns the offset of the next one to compile
+    u32 ScanInstr(u32 offset, std::set<const Subroutine*>& callees) const;
+
+    /// Finds the jump table cases and callees of the subroutine
+    void AnalyzeSubroutine(const Subroutine& subroutine);
+
+    /// Emits the function of the subroutine after the ones of its callees
+    void DefineSubroutine(const Subroutine& subroutine);
+
+    /// Emits the entry point that loads the attributes, runs the program and writes the outputs
+    void DefineMain();
+
+    /// Writes the PICA output attributes to the fragment shader inputs
+    void WriteVertexOutputs();
+
+    /// Compiles a range of instructions, returns the offset of the next one or PROGRAM_END
+    u32 CompileRange(u32 begin, u32 end);
+
+    /// Compiles a single instruction, returns the offset of the next one to execute
+    u32 CompileInstr(u32 offset);
+
+    /// Calls the subroutine and returns from the caller if the program ended in it
+    void CallSubroutine(const Subroutine& subroutine);
+
+    /// Evaluates the condition of a flow control instruction
+    [[nodiscard]] Id EvaluateCondition(Instruction::FlowControlType flow_control);
+
+    /// Loads the bool uniform with the provided index
+    [[nodiscard]] Id GetUniformBool(u32 index);
+
+    /// Loads a source register with the swizzle and negation applied
+    [[nodiscard]] Id GetSourceRegister(const SourceRegister& source_reg,
+                                       u32 address_register_index,
+                                       const std::array<u32, 4>& selector, bool negate);
+
+    /// Returns the variable of a destination register, std::nullopt if the write is discarded
+    [[nodiscard]] std::optional<Id> GetDestRegister(const DestRegister& dest_reg) const;
+
+    /// Stores the enabled components of value to a vec4 register
+    void SetDest(const SwizzlePattern& swizzle, std::optional<Id> reg, Id value,
+                 u32 value_num_components);
+
+    /// Multiplies the operands, replacing NaN results of 0 * inf with zero
+    [[nodiscard]] Id SanitizeMul(Id lhs, Id rhs);
+
+    /// Returns the private copy of the input register, defining it on first use
+    [[nodiscard]] Id GetInputRegister(u32 index);
+
+    /// Emits a selection that runs then_func when the condition is true
+    template <typename Func>
+    void If(Id condition, Func&& then_func) {
+        const Id then_label{OpLabel()};
+        const Id merge_label{OpLabel()};
+        OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+        OpBranchConditional(condition, then_label, merge_label);
+        BeginBlock(then_label);
+        then_func();
+        Branch(merge_label);
+        BeginBlock(merge_label);
+    }
+
+    void BeginBlock(Id label) {
+        AddLabel(label);
+        block_terminated = false;
+    }
+
+    /// Branches to the label unless the current block already returned
+    void Branch(Id label) {
+        if (!block_terminated) {
+            OpBranch(label);
+            block_terminated = true;
+        }
+    }
+
+    void Return(Id value) {
+        OpReturnValue(value);
+        block_terminated = true;
+    }
+
+    void DefineInterface();
+
+private:
+    const Pica::Shader::ShaderSetup& setup;
+    PicaVSConfig config;
+    std::optional<Pica::Shader::AccurateMulAnalysis> mul_analysis;
+    u32 num_multiplications{};
+    u32 num_sanitized_multiplications{};
+    std::set<Subroutine> subroutines;
+    std::map<const Subroutine*, SubroutineInfo> infos;
+    std::vector<Id> interfaces;
+    bool block_terminated{};
+
+    Id true_id{};
+    Id false_id{};
+    Id vs_uniforms_id{};
+    Id shader_data_id{};
+
+    Id conditional_code{};
+    Id address_registers{};
+    std::array<Id, 16> reg_tmp{};
+    std::array<Id, 16> vs_in_reg{};
+    std::vector<Id> vs_out_attr;
+
+    /// Jump target and jump table exit of the subroutine being emitted
+    Id jmp_to{};
+    Id switch_merge_label{};
+
+    Id primary_color_id{};
+    Id texcoord0_id{};
+    Id texcoord1_id{};
+    Id texcoord2_id{};
+    Id texcoord0_w_id{};
+    Id normquat_id{};
+    Id view_id{};
+    Id gl_position_id{};
+    Id gl_clip_distance_id{};
+};
+
 /**
  * Generates the SPIR-V fragment shader program source code for the current Pica state
  * @param config ShaderCacheKey object generated for the current Pica state, used for the shader
@@ -290,4 +452,11 @@ private:
  */
 std::vector<u32> GenerateFragmentShaderSPV(const PicaFSConfig& config);
 
+/**
+ * Generates the SPIR-V vertex shader program for the given VS program, without going through GLSL
+ * @returns SPIR-V words of the shader; std::nullopt on failure
+ */
+std::optional<std::vector<u32>> GenerateVertexShaderSPV(const Pica::Shader::ShaderSetup& setup,
+                                                        const PicaVSConfig& config);
+
 } // namespace Vulkan
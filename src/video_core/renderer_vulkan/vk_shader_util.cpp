@@ -158,10 +158,10 @@ bool InitializeCompiler() {
     return true;
 }
 
-vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
-                         ShaderOptimization level) {
+std::vector<u32> CompileGLSL(std::string_view code, vk::ShaderStageFlagBits stage,
+                             ShaderOptimization level) {
     if (!InitializeCompiler()) {
-        return VK_NULL_HANDLE;
+        return {};
     }
 
     EProfile profile = ECoreProfile;
@@ -184,7 +184,7 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
         LOG_CRITICAL(Render_Vulkan, "Shader Info Log:\n{}\n{}", shader->getInfoLog(),
                      shader->getInfoDebugLog());
         fmt::print("{}", code);
-        return VK_NULL_HANDLE;
+        return {};
     }
 
     // Even though there's only a single shader, we still need to link it to generate SPV
@@ -193,7 +193,7 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
     if (!program->link(messages)) {
         LOG_CRITICAL(Render_Vulkan, "Program Info Log:\n{}\n{}", program->getInfoLog(),
                      program->getInfoDebugLog());
-        return VK_NULL_HANDLE;
+        return {};
     }
 
     glslang::TIntermediate* intermediate = program->getIntermediate(lang);
@@ -223,7 +223,16 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
         LOG_INFO(Render_Vulkan, "SPIR-V conversion messages: {}", spv_messages);
     }
 
-    return CompileSPV(out_code, device);
+    return out_code;
+}
+
+vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
+                         ShaderOptimization level) {
+    const std::vector<u32> spirv = CompileGLSL(code, stage, level);
+    if (spirv.empty()) {
+        return VK_NULL_HANDLE;
+    }
+    return CompileSPV(spirv, device);
 }
 
 vk::ShaderModule CompileSPV(std::span<const u32> code, vk::Device device) {
@@ -5,12 +5,17 @@
 #pragma once
 
 #include <span>
+#include <vector>
 #include "video_core/renderer_vulkan/vk_common.h"
 
 namespace Vulkan {
 
 enum class ShaderOptimization { High = 0, Debug = 1 };
 
+/// Compiles GLSL to SPIR-V, returns an empty vector on failure
+std::vector<u32> CompileGLSL(std::string_view code, vk::ShaderStageFlagBits stage,
+                             ShaderOptimization level);
+
 vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
                          ShaderOptimization level);
 
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include "common/alignment.h"
 #include "common/assert.h"
@@ -23,9 +24,22 @@ VmaAllocationCreateFlags MakeVMAFlags(BufferType type) {
     case BufferType::Download:
         return VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
     case BufferType::Stream:
-        return VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-               VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT;
+        return VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+    }
+}
+
+/// Whether a stream buffer of the given size fits in the host visible device local heap. Without
+/// resizable BAR the heap is a 256 MiB window that the driver uses as well, so half of its budget
+/// is left to others.
+bool FitsDeviceLocalBudget(const Instance& instance, u64 size) {
+    const std::optional<u32> heap = instance.GetHostVisibleDeviceLocalHeap();
+    if (!heap) {
+        return false;
     }
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(instance.GetAllocator(), budgets.data());
+    const VmaBudget& budget = budgets[*heap];
+    return budget.usage + size <= budget.budget / 2;
 }
 
 constexpr u64 WATCHES_INITIAL_RESERVE = 0x4000;
@@ -95,27 +109,44 @@ void StreamBuffer::CreateBuffers(u64 prefered_size) {
         .usage = usage,
     };
 
-    const VmaAllocationCreateInfo alloc_create_info = {
+    // Vertex, index and uniform data is read by every draw, on discrete GPUs it is placed in
+    // video memory the host can write to so that it is not read across the bus. Staging buffers
+    // are only read once by copies and stay in host memory.
+    VmaAllocationCreateInfo alloc_create_info = {
         .flags = MakeVMAFlags(type) | VMA_ALLOCATION_CREATE_MAPPED_BIT,
         .usage = VMA_MEMORY_USAGE_AUTO,
+        .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
     };
+    const bool device_local =
+        type == BufferType::Stream && FitsDeviceLocalBudget(instance, prefered_size);
+    if (device_local) {
+        alloc_create_info.requiredFlags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    } else if (type == BufferType::Stream) {
+        // VMA would otherwise still prefer the heap for buffers the device reads
+        alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+    }
 
     VkBuffer unsafe_buffer{};
     VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(buffer_info);
     VmaAllocationInfo alloc_info{};
-    vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info, &alloc_create_info,
-                    &unsafe_buffer, &allocation, &alloc_info);
+    VkResult result = vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info,
+                                      &alloc_create_info, &unsafe_buffer, &allocation, &alloc_info);
+    if (result != VK_SUCCESS && device_local) {
+        // The heap may be short on space despite the budget, fall back to host memory
+        alloc_create_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+        result = vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info, &alloc_create_info,
+                                 &unsafe_buffer, &allocation, &alloc_info);
+    }
+    ASSERT_MSG(result == VK_SUCCESS, "Failed to allocate stream buffer of {} bytes: {}",
+               prefered_size, result);
     buffer = vk::Buffer{unsafe_buffer};
 
     VkMemoryPropertyFlags memory_flags{};
     vmaGetAllocationMemoryProperties(instance.GetAllocator(), allocation, &memory_flags);
-    if (type == BufferType::Stream) {
-        ASSERT_MSG(memory_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                   "Stream buffer must be host visible!");
-        if (!(memory_flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
-            LOG_WARNING(Render_Vulkan,
-                        "Unable to use device local memory for stream buffer. It will be slower!");
-        }
+    if (type == BufferType::Stream && !(memory_flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        LOG_WARNING(Render_Vulkan, "Stream buffer of {} KiB is in host memory, it will be slower",
+                    prefered_size >> 10);
     }
 
     mapped = reinterpret_cast<u8*>(alloc_info.pMappedData);
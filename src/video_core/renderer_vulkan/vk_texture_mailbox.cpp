@@ -19,9 +19,11 @@ MICROPROFILE_DEFINE(Vulkan_PresentFrame, "Vulkan", "Present Frame", MP_RGB(64, 6
 namespace Vulkan {
 
 PresentMailbox::PresentMailbox(const Instance& instance_, Swapchain& swapchain_,
-                               Scheduler& scheduler_, RenderpassCache& renderpass_cache_)
+                               Scheduler& scheduler_, RenderpassCache& renderpass_cache_,
+                               VideoCore::FramePacer& frame_pacer_)
     : instance{instance_}, swapchain{swapchain_}, scheduler{scheduler_},
-      renderpass_cache{renderpass_cache_}, graphics_queue{instance.GetGraphicsQueue()},
+      renderpass_cache{renderpass_cache_}, frame_pacer{frame_pacer_},
+      graphics_queue{instance.GetGraphicsQueue()},
       vsync_enabled{Settings::values.use_vsync_new.GetValue()} {
 
     const vk::Device device = instance.GetDevice();
@@ -169,6 +171,7 @@ Frame* PresentMailbox::GetRenderFrame() {
 void PresentMailbox::UpdateSurface(vk::SurfaceKHR surface) {
     std::scoped_lock lock{swapchain_mutex};
     swapchain.Create(surface);
+    image_acquired = false;
     swapchain_cv.notify_one();
 }
 
@@ -178,13 +181,24 @@ void PresentMailbox::Present(Frame* frame) {
 
 void PresentMailbox::PresentThread(std::stop_token token) {
     Common::SetCurrentThreadName("VulkanPresent");
+    Common::SetCurrentThreadRole(Common::ThreadRole::Render);
     do {
         Frame* frame = present_queue.PopWait(token);
         if (token.stop_requested()) {
             continue;
         }
         CopyToSwapchain(frame);
-        free_queue.Push(frame);
+        frame_pacer.FramePresented(frame->queued_time);
+
+        // Hold on to the last presented frame, its fence tells when the swapchain is unused
+        if (previous_frame) {
+            free_queue.Push(previous_frame);
+        }
+        previous_frame = frame;
+
+        // Acquire the next image ahead of time, so a frame is copied as soon as it arrives
+        std::scoped_lock lock{swapchain_mutex};
+        image_acquired = !swapchain.NeedsRecreation() && swapchain.AcquireNextImage();
     } while (!token.stop_requested());
 }
 
@@ -206,12 +220,14 @@ void PresentMailbox::CopyToSwapchain(Frame* frame) {
         RecreateSwapchain();
     }
 
-    while (!swapchain.AcquireNextImage()) {
+    if (!image_acquired.exchange(false)) {
+        while (!swapchain.AcquireNextImage()) {
 #if ANDROID
-        swapchain_cv.wait(lock, [this]() { return !swapchain.NeedsRecreation(); });
+            swapchain_cv.wait(lock, [this]() { return !swapchain.NeedsRecreation(); });
 #else
-        RecreateSwapchain();
+            RecreateSwapchain();
 #endif
+        }
     }
 
     const vk::Image swapchain_image = swapchain.Image();
@@ -339,8 +355,17 @@ void PresentMailbox::CopyToSwapchain(Frame* frame) {
 }
 
 void PresentMailbox::RecreateSwapchain() {
-    std::scoped_lock lock{scheduler.QueueMutex()};
-    graphics_queue.waitIdle();
+    // Copies into the swapchain are submitted in order, so once the last one is done the
+    // swapchain is unused. Waiting on its fence instead of idling the queue lets the render
+    // thread keep submitting while the swapchain is recreated.
+    if (previous_frame) {
+        const vk::Device device = instance.GetDevice();
+        std::scoped_lock lock{previous_frame->fence_mutex};
+        while (device.waitForFences(previous_frame->present_done, false,
+                                    std::numeric_limits<u64>::max()) != vk::Result::eSuccess) {
+        }
+    }
+    image_acquired = false;
     swapchain.Create();
 }
 
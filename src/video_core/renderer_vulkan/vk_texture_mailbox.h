@@ -7,6 +7,7 @@
 #include <mutex>
 #include <queue>
 #include "common/polyfill_thread.h"
+#include "video_core/frame_pacer.h"
 #include "video_core/renderer_vulkan/vk_common.h"
 
 VK_DEFINE_HANDLE(VmaAllocation)
@@ -30,6 +31,7 @@ struct Frame {
     vk::Fence present_done{};
     std::mutex fence_mutex{};
     vk::CommandBuffer cmdbuf{};
+    VideoCore::FramePacer::Clock::time_point queued_time{};
 };
 
 class PresentMailbox final {
@@ -37,7 +39,7 @@ class PresentMailbox final {
 
 public:
     PresentMailbox(const Instance& instance, Swapchain& swapchain, Scheduler& scheduler,
-                   RenderpassCache& renderpass_cache);
+                   RenderpassCache& renderpass_cache, VideoCore::FramePacer& frame_pacer);
     ~PresentMailbox();
 
     Frame* GetRenderFrame();
@@ -80,6 +82,7 @@ private:
     Swapchain& swapchain;
     Scheduler& scheduler;
     RenderpassCache& renderpass_cache;
+    VideoCore::FramePacer& frame_pacer;
     vk::CommandPool command_pool;
     vk::Queue graphics_queue;
     std::array<Frame, SWAP_CHAIN_SIZE> swap_chain{};
@@ -88,6 +91,8 @@ private:
     std::jthread present_thread;
     std::mutex swapchain_mutex;
     std::condition_variable swapchain_cv;
+    Frame* previous_frame{};
+    std::atomic_bool image_acquired{};
     bool vsync_enabled{};
 };
 
@@ -36,6 +36,12 @@ struct RecordParams {
     vk::Image dst_image;
 };
 
+u64 AllocationSize(VmaAllocator allocator, const Allocation& alloc) {
+    VmaAllocationInfo info;
+    vmaGetAllocationInfo(allocator, alloc.allocation, &info);
+    return info.size;
+}
+
 vk::Filter MakeFilter(VideoCore::PixelFormat pixel_format) {
     switch (pixel_format) {
     case VideoCore::PixelFormat::D16:
@@ -115,9 +121,12 @@ TextureRuntime::TextureRuntime(const Instance& instance, Scheduler& scheduler,
                                RenderpassCache& renderpass_cache, DescriptorManager& desc_manager)
     : instance{instance}, scheduler{scheduler}, renderpass_cache{renderpass_cache},
       blit_helper{instance, scheduler, desc_manager, renderpass_cache},
-      upload_buffer{instance, scheduler, vk::BufferUsageFlagBits::eTransferSrc, UPLOAD_BUFFER_SIZE,
-                    BufferType::Upload},
-      download_buffer{instance, scheduler, vk::BufferUsageFlagBits::eTransferDst,
+      upload_buffer{instance, scheduler,
+                    vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eStorageBuffer,
+                    UPLOAD_BUFFER_SIZE, BufferType::Upload},
+      download_buffer{instance, scheduler,
+                      vk::BufferUsageFlagBits::eTransferDst |
+                          vk::BufferUsageFlagBits::eStorageBuffer,
                       DOWNLOAD_BUFFER_SIZE, BufferType::Download} {
 
     auto Register = [this](VideoCore::PixelFormat dest,
@@ -131,6 +140,7 @@ TextureRuntime::TextureRuntime(const Instance& instance, Scheduler& scheduler,
 }
 
 TextureRuntime::~TextureRuntime() {
+    LOG_DEBUG(Render_Vulkan, "Placed {} images in recycled memory", num_aliased_allocations);
     Clear();
 }
 
@@ -159,6 +169,25 @@ void TextureRuntime::Clear() {
     }
 
     texture_recycler.clear();
+    recycled_memory = 0;
+}
+
+u64 TextureRuntime::GetSurfaceMemoryBudget() const {
+    // Without VK_EXT_memory_budget VMA estimates the budget from the heap sizes
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+    vmaGetHeapBudgets(instance.GetAllocator(), budgets.data());
+
+    const vk::PhysicalDeviceMemoryProperties properties =
+        instance.GetPhysicalDevice().getMemoryProperties();
+    u64 budget = 0;
+    for (u32 i = 0; i < properties.memoryHeapCount; i++) {
+        if (properties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            budget = std::max<u64>(budget, budgets[i].budget);
+        }
+    }
+
+    // Leave room for the staging buffers, the swapchain and the driver
+    return budget / 4 * 3;
 }
 
 Allocation TextureRuntime::Allocate(u32 width, u32 height, u32 levels,
@@ -187,6 +216,7 @@ Allocation TextureRuntime::Allocate(u32 width, u32 height, u32 levels, bool is_m
     if (auto it = texture_recycler.find(key); it != texture_recycler.end()) {
         Allocation alloc = std::move(it->second);
         texture_recycler.erase(it);
+        recycled_memory -= AllocationSize(instance.GetAllocator(), alloc);
         return alloc;
     }
 
@@ -223,7 +253,7 @@ Allocation TextureRuntime::Allocate(u32 width, u32 height, u32 levels, bool is_m
     };
 
     const VmaAllocationCreateInfo alloc_info = {
-        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT,
+        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT | VMA_ALLOCATION_CREATE_CAN_ALIAS_BIT,
         .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
         .requiredFlags = 0,
         .preferredFlags = 0,
@@ -231,17 +261,27 @@ Allocation TextureRuntime::Allocate(u32 width, u32 height, u32 levels, bool is_m
         .pUserData = nullptr,
     };
 
-    VkImage unsafe_image{};
-    VkImageCreateInfo unsafe_image_info = static_cast<VkImageCreateInfo>(image_info);
-    VmaAllocation allocation{};
+    vk::Device device = instance.GetDevice();
+    VmaAllocator allocator = instance.GetAllocator();
+    const vk::Image image = device.createImage(image_info);
 
-    VkResult result = vmaCreateImage(instance.GetAllocator(), &unsafe_image_info, &alloc_info,
-                                     &unsafe_image, &allocation, nullptr);
+    // Surfaces of slightly different sizes never match by tag, so try to place the image in the
+    // memory of a recycled one before allocating more
+    VmaAllocation allocation{};
+    VkResult result = VK_SUCCESS;
+    if (auto aliased = TakeAliasable(device.getImageMemoryRequirements(image))) {
+        allocation = aliased->allocation;
+        num_aliased_allocations++;
+    } else {
+        result = vmaAllocateMemoryForImage(allocator, image, &alloc_info, &allocation, nullptr);
+    }
+    if (result == VK_SUCCESS) {
+        result = vmaBindImageMemory(allocator, allocation, image);
+    }
     if (result != VK_SUCCESS) [[unlikely]] {
         LOG_CRITICAL(Render_Vulkan, "Failed allocating texture with error {}", result);
         UNREACHABLE();
     }
-    const vk::Image image{unsafe_image};
 
     const vk::ImageViewCreateInfo view_info = {
         .image = image,
@@ -257,7 +297,6 @@ Allocation TextureRuntime::Allocate(u32 width, u32 height, u32 levels, bool is_m
         },
     };
 
-    vk::Device device = instance.GetDevice();
     vk::UniqueImageView image_view = device.createImageViewUnique(view_info);
 
     renderpass_cache.EndRendering();
@@ -298,12 +337,89 @@ Allocation TextureRuntime::Allocate(u32 width, u32 height, u32 levels, bool is_m
 }
 
 void TextureRuntime::Recycle(const HostTextureTag tag, Allocation&& alloc) {
+    // The contents of the image are no longer needed
+    renderpass_cache.DropClear(alloc.image);
+    renderpass_cache.DropUploads(alloc.image);
+    recycled_memory += AllocationSize(instance.GetAllocator(), alloc);
+    alloc.recycle_tick = scheduler.CurrentTick();
     texture_recycler.emplace(tag, std::move(alloc));
 }
 
+std::optional<Allocation> TextureRuntime::TakeAliasable(const vk::MemoryRequirements& reqs) {
+    VmaAllocator allocator = instance.GetAllocator();
+    auto best = texture_recycler.end();
+    u64 best_size = 0;
+    for (auto it = texture_recycler.begin(); it != texture_recycler.end(); ++it) {
+        const Allocation& alloc = it->second;
+        if (!scheduler.IsFree(alloc.recycle_tick)) {
+            continue;
+        }
+        VmaAllocationInfo info;
+        vmaGetAllocationInfo(allocator, alloc.allocation, &info);
+        // Don't let small images pin down much larger blocks
+        const bool fits = info.size >= reqs.size && info.size <= reqs.size * 2 &&
+                          (reqs.memoryTypeBits & (1U << info.memoryType)) != 0 &&
+                          info.offset % reqs.alignment == 0;
+        if (fits && (best == texture_recycler.end() || info.size < best_size)) {
+            best = it;
+            best_size = info.size;
+        }
+    }
+    if (best == texture_recycler.end()) {
+        return std::nullopt;
+    }
+
+    Allocation alloc = std::move(best->second);
+    texture_recycler.erase(best);
+    recycled_memory -= best_size;
+
+    // The old views must go before the image they reference, along with any framebuffer
+    // that was built from them
+    renderpass_cache.RemoveFramebuffers(alloc.image_view.get());
+    alloc.image_view.reset();
+    alloc.depth_view.reset();
+    alloc.stencil_view.reset();
+    alloc.storage_view.reset();
+    instance.GetDevice().destroyImage(alloc.image);
+    return alloc;
+}
+
 bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClear& clear) {
+    const vk::Rect2D rect = {
+        .offset{
+            .x = static_cast<s32>(clear.texture_rect.left),
+            .y = static_cast<s32>(clear.texture_rect.bottom),
+        },
+        .extent{
+            .width = clear.texture_rect.GetWidth(),
+            .height = clear.texture_rect.GetHeight(),
+        },
+    };
+
+    // Clearing a bound render target inside the active pass saves ending and restarting it
+    if (clear.texture_level == 0 &&
+        renderpass_cache.ClearAttachment(surface.alloc.image, surface.alloc.aspect, rect,
+                                         MakeClearValue(clear.value))) {
+        return true;
+    }
+
     renderpass_cache.EndRendering();
 
+    // Render targets are usually cleared right before they are drawn to, the clear is deferred
+    // so that it can become the load operation of the next rendering scope
+    if (clear.texture_level == 0 && surface.texture_type == VideoCore::TextureType::Texture2D &&
+        clear.texture_rect == surface.GetScaledRect()) {
+        renderpass_cache.DeferClear({
+            .image = surface.alloc.image,
+            .aspect = surface.alloc.aspect,
+            .pipeline_flags = surface.PipelineStageFlags(),
+            .access = surface.AccessFlags(),
+            .rect = rect,
+            .value = MakeClearValue(clear.value),
+        });
+        return true;
+    }
+
     const RecordParams params = {
         .aspect = surface.alloc.aspect,
         .pipeline_flags = surface.PipelineStageFlags(),
@@ -767,6 +883,20 @@ bool TextureRuntime::NeedsConvertion(VideoCore::PixelFormat format) const {
            traits.aspect != (vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil);
 }
 
+bool TextureRuntime::SupportsGpuCodec(VideoCore::PixelFormat format, bool encode) const {
+    // Depth formats stay on the CPU, texture formats are never written back by the guest GPU
+    const VideoCore::SurfaceType type = GetFormatType(format);
+    return type == VideoCore::SurfaceType::Color ||
+           (type == VideoCore::SurfaceType::Texture && !encode);
+}
+
+bool TextureRuntime::ReinterpretTiled(Surface& source, Surface& dest, VideoCore::Rect2D src_rect,
+                                      VideoCore::Rect2D dst_rect) {
+    // Uploads and downloads use separate stream buffers, chaining the codec passes would need
+    // a buffer copy between them. Leave these to the guest memory path for now.
+    return false;
+}
+
 Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceParams& params)
     : VideoCore::SurfaceBase{params}, runtime{&runtime_}, instance{&runtime_.GetInstance()},
       scheduler{&runtime_.GetScheduler()} {
@@ -820,99 +950,56 @@ Surface::~Surface() {
 }
 
 void Surface::Upload(const VideoCore::BufferTextureCopy& upload, const StagingData& staging) {
-    runtime->renderpass_cache.EndRendering();
+    // An upload of the whole image replaces a deferred clear instead of following it
+    if (upload.texture_level == 0 && texture_type == VideoCore::TextureType::Texture2D &&
+        upload.texture_rect == GetRect()) {
+        runtime->renderpass_cache.DropClear(alloc.image);
+    }
 
     const bool is_scaled = res_scale != 1;
     if (is_scaled) {
         ScaledUpload(upload, staging);
-    } else {
-        const RecordParams params = {
-            .aspect = alloc.aspect,
-            .pipeline_flags = PipelineStageFlags(),
-            .src_access = AccessFlags(),
-            .src_image = alloc.image,
-        };
-
-        scheduler->Record([buffer = runtime->upload_buffer.Handle(), format = alloc.format, params,
-                           staging, upload](vk::CommandBuffer cmdbuf) {
-            u32 num_copies = 1;
-            std::array<vk::BufferImageCopy, 2> buffer_image_copies;
-
-            const VideoCore::Rect2D rect = upload.texture_rect;
-            buffer_image_copies[0] = vk::BufferImageCopy{
-                .bufferOffset = staging.buffer_offset + upload.buffer_offset,
-                .bufferRowLength = rect.GetWidth(),
-                .bufferImageHeight = rect.GetHeight(),
-                .imageSubresource{
-                    .aspectMask = params.aspect,
-                    .mipLevel = upload.texture_level,
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                },
-                .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
-                .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1},
-            };
-
-            if (params.aspect & vk::ImageAspectFlagBits::eStencil) {
-                buffer_image_copies[0].imageSubresource.aspectMask =
-                    vk::ImageAspectFlagBits::eDepth;
-                vk::BufferImageCopy& stencil_copy = buffer_image_copies[1];
-                stencil_copy = buffer_image_copies[0];
-                stencil_copy.bufferOffset += UnpackDepthStencil(staging, format);
-                stencil_copy.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eStencil;
-                num_copies++;
-            }
-
-            const vk::ImageMemoryBarrier read_barrier = {
-                .srcAccessMask = params.src_access,
-                .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
-                .oldLayout = vk::ImageLayout::eGeneral,
-                .newLayout = vk::ImageLayout::eTransferDstOptimal,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = params.src_image,
-                .subresourceRange{
-                    .aspectMask = params.aspect,
-                    .baseMipLevel = upload.texture_level,
-                    .levelCount = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
-            };
-            const vk::ImageMemoryBarrier write_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
-                .dstAccessMask = params.src_access,
-                .oldLayout = vk::ImageLayout::eTransferDstOptimal,
-                .newLayout = vk::ImageLayout::eGeneral,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = params.src_image,
-                .subresourceRange{
-                    .aspectMask = params.aspect,
-                    .baseMipLevel = upload.texture_level,
-                    .levelCount = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
-            };
-
-            cmdbuf.pipelineBarrier(params.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
-                                   vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
-
-            cmdbuf.copyBufferToImage(buffer, params.src_image, vk::ImageLayout::eTransferDstOptimal,
-                                     num_copies, buffer_image_copies.data());
-
-            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, params.pipeline_flags,
-                                   vk::DependencyFlagBits::eByRegion, {}, {}, write_barrier);
+        return;
+    }
 
-            // Wait for a decode to finish if one is pending. Normally this isn't
-            // needed until we actually submit the command buffer but it's safer to do it now
-            // to prevent the stream buffer from reclaiming our space before we are done with it.
-            staging.Wait();
-        });
+    // The copy is recorded together with the other uploads of the draw
+    const VideoCore::Rect2D rect = upload.texture_rect;
+    PendingUpload pending = {
+        .buffer = runtime->upload_buffer.Handle(),
+        .image = alloc.image,
+        .aspect = alloc.aspect,
+        .pipeline_flags = PipelineStageFlags(),
+        .access = AccessFlags(),
+        .num_copies = 1,
+        .staging = staging,
+    };
+    pending.copies[0] = vk::BufferImageCopy{
+        .bufferOffset = staging.buffer_offset + upload.buffer_offset,
+        .bufferRowLength = rect.GetWidth(),
+        .bufferImageHeight = rect.GetHeight(),
+        .imageSubresource{
+            .aspectMask = alloc.aspect,
+            .mipLevel = upload.texture_level,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
+        .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1},
+    };
 
-        runtime->upload_buffer.Commit(staging.size);
+    if (alloc.aspect & vk::ImageAspectFlagBits::eStencil) {
+        pending.copies[0].imageSubresource.aspectMask = vk::ImageAspectFlagBits::eDepth;
+        vk::BufferImageCopy& stencil_copy = pending.copies[1];
+        stencil_copy = pending.copies[0];
+        // The data is split into its depth and stencil parts right away, so it has to be ready
+        staging.Wait();
+        stencil_copy.bufferOffset += UnpackDepthStencil(staging, alloc.format);
+        stencil_copy.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eStencil;
+        pending.num_copies++;
     }
+
+    runtime->renderpass_cache.DeferUpload(pending);
+    runtime->upload_buffer.Commit(staging.size);
 }
 
 void Surface::Download(const VideoCore::BufferTextureCopy& download, const StagingData& staging) {
@@ -1004,6 +1091,29 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download, const Stagi
     }
 }
 
+void Surface::UploadTiled(const VideoCore::BufferTextureCopy& upload, const StagingData& staging) {
+    const VideoCore::Rect2D rect = upload.texture_rect;
+    const u32 tiled_offset = static_cast<u32>(staging.buffer_offset);
+    const auto params = VideoCore::MakeTextureCodecParams(
+        pixel_format, rect.GetWidth(), rect.GetHeight(), tiled_offset,
+        tiled_offset + upload.buffer_offset, runtime->NeedsConvertion(pixel_format), false);
+
+    runtime->blit_helper.RunTextureCodec(runtime->upload_buffer.Handle(), params);
+    Upload(upload, staging);
+}
+
+void Surface::DownloadTiled(const VideoCore::BufferTextureCopy& download,
+                            const StagingData& staging) {
+    Download(download, staging);
+
+    const VideoCore::Rect2D rect = download.texture_rect;
+    const u32 tiled_offset = static_cast<u32>(staging.buffer_offset);
+    const auto params = VideoCore::MakeTextureCodecParams(
+        pixel_format, rect.GetWidth(), rect.GetHeight(), tiled_offset,
+        tiled_offset + download.buffer_offset, runtime->NeedsConvertion(pixel_format), true);
+    runtime->blit_helper.RunTextureCodec(runtime->download_buffer.Handle(), params);
+}
+
 bool Surface::Swap(u32 width, u32 height, VideoCore::CustomPixelFormat format) {
     const FormatTraits& traits = instance->GetTraits(format);
     if (!traits.transfer_support) {
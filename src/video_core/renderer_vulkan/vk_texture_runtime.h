@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <optional>
 #include <set>
 #include <span>
 #include "video_core/rasterizer_cache/framebuffer_base.h"
@@ -37,6 +38,7 @@ struct Allocation {
     u32 width;
     u32 height;
     u32 levels;
+    u64 recycle_tick{};
 
     bool Matches(u32 width_, u32 height_, u32 levels_, vk::Format format_) const noexcept {
         return std::tie(width, height, levels, format) ==
@@ -99,6 +101,14 @@ public:
     /// Takes back ownership of the allocation for recycling
     void Recycle(const HostTextureTag tag, Allocation&& alloc);
 
+    /// Returns the device memory the rasterizer cache may spend on surfaces
+    [[nodiscard]] u64 GetSurfaceMemoryBudget() const;
+
+    /// Returns the memory held by allocations waiting to be recycled
+    [[nodiscard]] u64 GetRecycledMemory() const noexcept {
+        return recycled_memory;
+    }
+
     /// Maps an internal staging buffer of the provided size for pixel uploads/downloads
     [[nodiscard]] VideoCore::StagingData FindStaging(u32 size, bool upload);
 
@@ -130,12 +140,27 @@ public:
     /// Returns true if the provided pixel format needs convertion
     [[nodiscard]] bool NeedsConvertion(VideoCore::PixelFormat format) const;
 
+    /// Returns true if the texture codec shader can unswizzle, or swizzle when encoding, the format
+    [[nodiscard]] bool SupportsGpuCodec(VideoCore::PixelFormat format, bool encode) const;
+
+    /// Returns true if scaled uploads are filtered, this backend doesn't filter them
+    [[nodiscard]] bool IsUploadFiltered() const {
+        return false;
+    }
+
+    /// Reinterprets the source rectangle as the dest format with the texture codec
+    bool ReinterpretTiled(Surface& source, Surface& dest, VideoCore::Rect2D src_rect,
+                          VideoCore::Rect2D dst_rect);
+
     /// Returns a reference to the renderpass cache
     [[nodiscard]] RenderpassCache& GetRenderpassCache() {
         return renderpass_cache;
     }
 
 private:
+    /// Takes a recycled allocation the GPU is done with whose memory can back the image
+    [[nodiscard]] std::optional<Allocation> TakeAliasable(const vk::MemoryRequirements& reqs);
+
     /// Clears a partial texture rect using a clear rectangle
     void ClearTextureWithRenderpass(Surface& surface, const VideoCore::TextureClear& clear);
 
@@ -158,6 +183,8 @@ private:
     StreamBuffer download_buffer;
     std::array<ReinterpreterList, VideoCore::PIXEL_FORMAT_COUNT> reinterpreters;
     std::unordered_multimap<HostTextureTag, Allocation> texture_recycler;
+    u64 recycled_memory{};
+    u64 num_aliased_allocations{};
 };
 
 class Surface : public VideoCore::SurfaceBase {
@@ -202,6 +229,14 @@ public:
     void Download(const VideoCore::BufferTextureCopy& download,
                   const VideoCore::StagingData& staging);
 
+    /// Decodes the tiled data at the start of staging on the GPU and uploads the result
+    void UploadTiled(const VideoCore::BufferTextureCopy& upload,
+                     const VideoCore::StagingData& staging);
+
+    /// Downloads pixel data to staging and swizzles it to the start of staging on the GPU
+    void DownloadTiled(const VideoCore::BufferTextureCopy& download,
+                       const VideoCore::StagingData& staging);
+
     /// Swaps the internal allocation to match the provided dimentions and format
     bool Swap(u32 width, u32 height, VideoCore::CustomPixelFormat format);
 
@@ -149,6 +149,14 @@ ShaderEngine* GetEngine() {
         }
         return jit_engine.get();
     }
+#else
+    if (VideoCore::g_shader_jit_enabled) {
+        static bool logged = false;
+        if (!logged) {
+            LOG_INFO(HW_GPU, "No shader JIT for this host, falling back to the interpreter");
+            logged = true;
+        }
+    }
 #endif // CITRA_ARCH(x86_64)
 
     return &interpreter_engine;
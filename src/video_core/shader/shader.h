@@ -278,6 +278,8 @@ struct ShaderSetup {
         unsigned int entry_point;
         /// Used by the JIT, points to a compiled shader object.
         const void* cached_shader = nullptr;
+        /// Used by the interpreter, points to the decoded instructions of the program.
+        const void* decoded_program = nullptr;
     } engine_data;
 
     void MarkProgramCodeDirty() {
@@ -323,6 +325,14 @@ private:
     }
 };
 
+/// Counters of the programs compiled by a shader engine
+struct ShaderEngineStats {
+    u64 programs_compiled{};
+    u64 programs_evicted{};
+    /// Memory held by the compiled programs
+    u64 cache_bytes{};
+};
+
 class ShaderEngine {
 public:
     virtual ~ShaderEngine() = default;
@@ -340,6 +350,12 @@ public:
      * @param state Shader unit state, must be setup with input data before each shader invocation.
      */
     virtual void Run(const ShaderSetup& setup, UnitState& state) const = 0;
+
+    /// Returns the counters of the engine since it was created, zero for engines that do not
+    /// compile programs
+    virtual ShaderEngineStats GetStats() const {
+        return {};
+    }
 };
 
 // TODO(yuriks): Remove and make it non-global state somewhere
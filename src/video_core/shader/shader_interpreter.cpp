@@ -5,12 +5,15 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <memory>
 #include <numeric>
+#include <vector>
 #include <boost/container/static_vector.hpp>
 #include <boost/range/algorithm/fill.hpp>
 #include <nihstro/shader_bytecode.h>
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/literals.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/vector_math.h"
@@ -19,6 +22,7 @@
 #include "video_core/shader/shader.h"
 #include "video_core/shader/shader_interpreter.h"
 
+using nihstro::DestRegister;
 using nihstro::Instruction;
 using nihstro::OpCode;
 using nihstro::RegisterType;
@@ -36,9 +40,103 @@ struct CallStackElement {
     u32 loop_address;   // The address where we'll return to after each loop iteration
 };
 
+enum class DestRegisterKind : u8 {
+    Output,
+    Temporary,
+    Invalid,
+};
+
+/// Instruction with the operand fields extracted from the program code and the swizzle data, so
+/// that running a shader only has to dispatch on them
+struct DecodedInstruction {
+    Instruction instr;
+    OpCode::Id opcode;
+    OpCode::Type type;
+
+    std::array<SourceRegister, 3> src;
+    /// Source the address register offset is added to
+    u8 relative_src;
+    u8 address_register_index;
+    std::array<std::array<u8, 4>, 3> selectors;
+    std::array<bool, 3> negate;
+
+    DestRegisterKind dest_kind;
+    u8 dest_index;
+    std::array<bool, 4> dest_enabled;
+
+    u32 operand_desc_id;
+};
+
+struct DecodedProgram {
+    std::array<DecodedInstruction, MAX_PROGRAM_CODE_LENGTH> code;
+};
+
+static DecodedInstruction DecodeInstruction(u32 hex, const SwizzleData& swizzle_data) {
+    DecodedInstruction op{};
+    op.instr = {hex};
+    op.opcode = op.instr.opcode.Value().EffectiveOpCode();
+    op.type = op.instr.opcode.Value().GetInfo().type;
+
+    const auto decode_dest = [&op](DestRegister dest) {
+        op.dest_kind = dest < 0x10   ? DestRegisterKind::Output
+                       : dest < 0x20 ? DestRegisterKind::Temporary
+                                     : DestRegisterKind::Invalid;
+        op.dest_index = static_cast<u8>(dest.GetIndex());
+    };
+
+    if (op.type == OpCode::Type::Arithmetic) {
+        const bool is_inverted =
+            (0 != (op.instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+        op.src[0] = op.instr.common.GetSrc1(is_inverted);
+        op.src[1] = op.instr.common.GetSrc2(is_inverted);
+        op.relative_src = is_inverted ? 1 : 0;
+        op.address_register_index = static_cast<u8>(op.instr.common.address_register_index);
+        op.operand_desc_id = op.instr.common.operand_desc_id;
+        decode_dest(op.instr.common.dest.Value());
+    } else if (op.type == OpCode::Type::MultiplyAdd) {
+        const bool is_inverted = (op.opcode == OpCode::Id::MADI);
+        op.src[0] = op.instr.mad.GetSrc1(is_inverted);
+        op.src[1] = op.instr.mad.GetSrc2(is_inverted);
+        op.src[2] = op.instr.mad.GetSrc3(is_inverted);
+        op.relative_src = is_inverted ? 2 : 1;
+        op.address_register_index = static_cast<u8>(op.instr.mad.address_register_index);
+        op.operand_desc_id = op.instr.mad.operand_desc_id;
+        decode_dest(op.instr.mad.dest.Value());
+    } else {
+        return op;
+    }
+
+    const SwizzlePattern swizzle = {swizzle_data[op.operand_desc_id]};
+    op.selectors[0] = {static_cast<u8>(swizzle.src1_selector_0.Value()),
+                       static_cast<u8>(swizzle.src1_selector_1.Value()),
+                       static_cast<u8>(swizzle.src1_selector_2.Value()),
+                       static_cast<u8>(swizzle.src1_selector_3.Value())};
+    op.selectors[1] = {static_cast<u8>(swizzle.src2_selector_0.Value()),
+                       static_cast<u8>(swizzle.src2_selector_1.Value()),
+                       static_cast<u8>(swizzle.src2_selector_2.Value()),
+                       static_cast<u8>(swizzle.src2_selector_3.Value())};
+    op.selectors[2] = {static_cast<u8>(swizzle.src3_selector_0.Value()),
+                       static_cast<u8>(swizzle.src3_selector_1.Value()),
+                       static_cast<u8>(swizzle.src3_selector_2.Value()),
+                       static_cast<u8>(swizzle.src3_selector_3.Value())};
+    op.negate = {swizzle.negate_src1 != 0, swizzle.negate_src2 != 0, swizzle.negate_src3 != 0};
+    for (int i = 0; i < 4; ++i) {
+        op.dest_enabled[i] = swizzle.DestComponentEnabled(i);
+    }
+    return op;
+}
+
+static std::unique_ptr<DecodedProgram> DecodeProgram(const ShaderSetup& setup) {
+    auto program = std::make_unique<DecodedProgram>();
+    for (std::size_t i = 0; i < setup.program_code.size(); ++i) {
+        program->code[i] = DecodeInstruction(setup.program_code[i], setup.swizzle_data);
+    }
+    return program;
+}
+
 template <bool Debug>
-static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData<Debug>& debug_data,
-                           unsigned offset) {
+static void RunInterpreter(const ShaderSetup& setup, const DecodedProgram& program,
+                           UnitState& state, DebugData<Debug>& debug_data, unsigned offset) {
     // TODO: Is there a maximal size for this?
     boost::container::static_vector<CallStackElement, 16> call_stack;
     u32 program_counter = offset;
@@ -77,8 +175,6 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
     };
 
     const auto& uniforms = setup.uniforms;
-    const auto& swizzle_data = setup.swizzle_data;
-    const auto& program_code = setup.program_code;
 
     // Placeholder for invalid inputs
     static float24 dummy_vec4_float24[4];
@@ -103,8 +199,8 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
             }
         }
 
-        const Instruction instr = {program_code[program_counter]};
-        const SwizzlePattern swizzle = {swizzle_data[instr.common.operand_desc_id]};
+        const DecodedInstruction& op = program.code[program_counter];
+        const Instruction instr = op.instr;
 
         Record<DebugDataRecord::CUR_INSTR>(debug_data, iteration, program_counter);
         if (iteration > 0)
@@ -128,66 +224,48 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
             }
         };
 
-        switch (instr.opcode.Value().GetInfo().type) {
-        case OpCode::Type::Arithmetic: {
-            const bool is_inverted =
-                (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
-
-            const int address_offset =
-                (instr.common.address_register_index == 0)
-                    ? 0
-                    : state.address_registers[instr.common.address_register_index - 1];
-
-            const float24* src1_ = LookupSourceRegister(instr.common.GetSrc1(is_inverted) +
-                                                        (is_inverted ? 0 : address_offset));
-            const float24* src2_ = LookupSourceRegister(instr.common.GetSrc2(is_inverted) +
-                                                        (is_inverted ? address_offset : 0));
-
-            const bool negate_src1 = ((bool)swizzle.negate_src1 != false);
-            const bool negate_src2 = ((bool)swizzle.negate_src2 != false);
-
-            float24 src1[4] = {
-                src1_[(int)swizzle.src1_selector_0.Value()],
-                src1_[(int)swizzle.src1_selector_1.Value()],
-                src1_[(int)swizzle.src1_selector_2.Value()],
-                src1_[(int)swizzle.src1_selector_3.Value()],
-            };
-            if (negate_src1) {
-                src1[0] = -src1[0];
-                src1[1] = -src1[1];
-                src1[2] = -src1[2];
-                src1[3] = -src1[3];
+        auto LoadSource = [&](std::size_t i, int address_offset, float24 (&src)[4]) {
+            const float24* src_ =
+                LookupSourceRegister(op.src[i] + (op.relative_src == i ? address_offset : 0));
+            for (std::size_t comp = 0; comp < 4; ++comp) {
+                const float24 value = src_[op.selectors[i][comp]];
+                src[comp] = op.negate[i] ? -value : value;
             }
-            float24 src2[4] = {
-                src2_[(int)swizzle.src2_selector_0.Value()],
-                src2_[(int)swizzle.src2_selector_1.Value()],
-                src2_[(int)swizzle.src2_selector_2.Value()],
-                src2_[(int)swizzle.src2_selector_3.Value()],
-            };
-            if (negate_src2) {
-                src2[0] = -src2[0];
-                src2[1] = -src2[1];
-                src2[2] = -src2[2];
-                src2[3] = -src2[3];
+        };
+
+        auto GetDest = [&]() -> float24* {
+            switch (op.dest_kind) {
+            case DestRegisterKind::Output:
+                return &state.registers.output[op.dest_index][0];
+            case DestRegisterKind::Temporary:
+                return &state.registers.temporary[op.dest_index][0];
+            default:
+                return dummy_vec4_float24;
             }
+        };
+
+        switch (op.type) {
+        case OpCode::Type::Arithmetic: {
+            const int address_offset = (op.address_register_index == 0)
+                                           ? 0
+                                           : state.address_registers[op.address_register_index - 1];
 
-            float24* dest =
-                (instr.common.dest.Value() < 0x10)
-                    ? &state.registers.output[instr.common.dest.Value().GetIndex()][0]
-                : (instr.common.dest.Value() < 0x20)
-                    ? &state.registers.temporary[instr.common.dest.Value().GetIndex()][0]
-                    : dummy_vec4_float24;
+            float24 src1[4];
+            float24 src2[4];
+            LoadSource(0, address_offset, src1);
+            LoadSource(1, address_offset, src2);
+            float24* dest = GetDest();
 
             debug_data.max_opdesc_id =
-                std::max<u32>(debug_data.max_opdesc_id, 1 + instr.common.operand_desc_id);
+                std::max<u32>(debug_data.max_opdesc_id, 1 + op.operand_desc_id);
 
-            switch (instr.opcode.Value().EffectiveOpCode()) {
+            switch (op.opcode) {
             case OpCode::Id::ADD: {
                 Record<DebugDataRecord::SRC1>(debug_data, iteration, src1);
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = src1[i] + src2[i];
@@ -201,7 +279,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = src1[i] * src2[i];
@@ -214,7 +292,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC1>(debug_data, iteration, src1);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = float24::FromFloat32(std::floor(src1[i].ToFloat32()));
@@ -227,7 +305,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     // NOTE: Exact form required to match NaN semantics to hardware:
@@ -243,7 +321,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     // NOTE: Exact form required to match NaN semantics to hardware:
@@ -262,7 +340,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
 
-                OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+                OpCode::Id opcode = op.opcode;
                 if (opcode == OpCode::Id::DPH || opcode == OpCode::Id::DPHI)
                     src1[3] = float24::FromFloat32(1.0f);
 
@@ -271,7 +349,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                                                  float24::FromFloat32(0.f));
 
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = dot;
@@ -286,7 +364,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 float24 rcp_res = float24::FromFloat32(1.0f / src1[0].ToFloat32());
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = rcp_res;
@@ -301,7 +379,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 float24 rsq_res = float24::FromFloat32(1.0f / std::sqrt(src1[0].ToFloat32()));
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = rsq_res;
@@ -313,7 +391,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
             case OpCode::Id::MOVA: {
                 Record<DebugDataRecord::SRC1>(debug_data, iteration, src1);
                 for (int i = 0; i < 2; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     // TODO: Figure out how the rounding is done on hardware
@@ -328,7 +406,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC1>(debug_data, iteration, src1);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = src1[i];
@@ -343,7 +421,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = (src1[i] >= src2[i]) ? float24::FromFloat32(1.0f)
@@ -358,7 +436,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = (src1[i] < src2[i]) ? float24::FromFloat32(1.0f)
@@ -416,7 +494,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 // EX2 only takes first component exp2 and writes it to all dest components
                 float24 ex2_res = float24::FromFloat32(std::exp2(src1[0].ToFloat32()));
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = ex2_res;
@@ -433,7 +511,7 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
                 // LG2 only takes the first component log2 and writes it to all dest components
                 float24 lg2_res = float24::FromFloat32(std::log2(src1[0].ToFloat32()));
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = lg2_res;
@@ -455,78 +533,26 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
         }
 
         case OpCode::Type::MultiplyAdd: {
-            if ((instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MAD) ||
-                (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI)) {
-                const SwizzlePattern& swizzle = *reinterpret_cast<const SwizzlePattern*>(
-                    &swizzle_data[instr.mad.operand_desc_id]);
-
-                bool is_inverted = (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI);
-
+            if ((op.opcode == OpCode::Id::MAD) || (op.opcode == OpCode::Id::MADI)) {
                 const int address_offset =
-                    (instr.mad.address_register_index == 0)
+                    (op.address_register_index == 0)
                         ? 0
-                        : state.address_registers[instr.mad.address_register_index - 1];
-
-                const float24* src1_ = LookupSourceRegister(instr.mad.GetSrc1(is_inverted));
-                const float24* src2_ = LookupSourceRegister(instr.mad.GetSrc2(is_inverted) +
-                                                            (!is_inverted * address_offset));
-                const float24* src3_ = LookupSourceRegister(instr.mad.GetSrc3(is_inverted) +
-                                                            (is_inverted * address_offset));
-
-                const bool negate_src1 = ((bool)swizzle.negate_src1 != false);
-                const bool negate_src2 = ((bool)swizzle.negate_src2 != false);
-                const bool negate_src3 = ((bool)swizzle.negate_src3 != false);
-
-                float24 src1[4] = {
-                    src1_[(int)swizzle.src1_selector_0.Value()],
-                    src1_[(int)swizzle.src1_selector_1.Value()],
-                    src1_[(int)swizzle.src1_selector_2.Value()],
-                    src1_[(int)swizzle.src1_selector_3.Value()],
-                };
-                if (negate_src1) {
-                    src1[0] = -src1[0];
-                    src1[1] = -src1[1];
-                    src1[2] = -src1[2];
-                    src1[3] = -src1[3];
-                }
-                float24 src2[4] = {
-                    src2_[(int)swizzle.src2_selector_0.Value()],
-                    src2_[(int)swizzle.src2_selector_1.Value()],
-                    src2_[(int)swizzle.src2_selector_2.Value()],
-                    src2_[(int)swizzle.src2_selector_3.Value()],
-                };
-                if (negate_src2) {
-                    src2[0] = -src2[0];
-                    src2[1] = -src2[1];
-                    src2[2] = -src2[2];
-                    src2[3] = -src2[3];
-                }
-                float24 src3[4] = {
-                    src3_[(int)swizzle.src3_selector_0.Value()],
-                    src3_[(int)swizzle.src3_selector_1.Value()],
-                    src3_[(int)swizzle.src3_selector_2.Value()],
-                    src3_[(int)swizzle.src3_selector_3.Value()],
-                };
-                if (negate_src3) {
-                    src3[0] = -src3[0];
-                    src3[1] = -src3[1];
-                    src3[2] = -src3[2];
-                    src3[3] = -src3[3];
-                }
+                        : state.address_registers[op.address_register_index - 1];
 
-                float24* dest =
-                    (instr.mad.dest.Value() < 0x10)
-                        ? &state.registers.output[instr.mad.dest.Value().GetIndex()][0]
-                    : (instr.mad.dest.Value() < 0x20)
-                        ? &state.registers.temporary[instr.mad.dest.Value().GetIndex()][0]
-                        : dummy_vec4_float24;
+                float24 src1[4];
+                float24 src2[4];
+                float24 src3[4];
+                LoadSource(0, address_offset, src1);
+                LoadSource(1, address_offset, src2);
+                LoadSource(2, address_offset, src3);
+                float24* dest = GetDest();
 
                 Record<DebugDataRecord::SRC1>(debug_data, iteration, src1);
                 Record<DebugDataRecord::SRC2>(debug_data, iteration, src2);
                 Record<DebugDataRecord::SRC3>(debug_data, iteration, src3);
                 Record<DebugDataRecord::DEST_IN>(debug_data, iteration, dest);
                 for (int i = 0; i < 4; ++i) {
-                    if (!swizzle.DestComponentEnabled(i))
+                    if (!op.dest_enabled[i])
                         continue;
 
                     dest[i] = src1[i] * src2[i] + src3[i];
@@ -666,9 +692,65 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
     }
 }
 
+using namespace Common::Literals;
+
+/// Memory of the decoded programs, every program holds MAX_PROGRAM_CODE_LENGTH instructions
+constexpr u64 CacheBudget = 16_MiB;
+
+InterpreterEngine::InterpreterEngine() = default;
+InterpreterEngine::~InterpreterEngine() = default;
+
 void InterpreterEngine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     ASSERT(entry_point < MAX_PROGRAM_CODE_LENGTH);
     setup.engine_data.entry_point = entry_point;
+
+    const u64 cache_key = setup.GetProgramCodeHash() ^ setup.GetSwizzleDataHash();
+    CachedProgram& cached = cache[cache_key];
+    cached.last_used = ++use_tick;
+    if (!cached.program) {
+        cached.program = DecodeProgram(setup);
+        programs_decoded++;
+    }
+    setup.engine_data.decoded_program = cached.program.get();
+
+    if (cache.size() * sizeof(DecodedProgram) > CacheBudget) {
+        EvictPrograms();
+    }
+}
+
+void InterpreterEngine::EvictPrograms() {
+    // The two programs set up last may be run by the vertex and geometry shader units right
+    // after this, they are not evicted
+    std::vector<decltype(cache)::iterator> candidates;
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->second.last_used + 1 < use_tick) {
+            candidates.push_back(it);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->second.last_used < rhs->second.last_used;
+    });
+
+    // Evict down to a fraction of the budget, so this does not run again on the next batch
+    const u64 target = CacheBudget / 4 * 3;
+    u64 num_evicted = 0;
+    for (const auto it : candidates) {
+        if (cache.size() * sizeof(DecodedProgram) <= target) {
+            break;
+        }
+        cache.erase(it);
+        num_evicted++;
+    }
+    programs_evicted += num_evicted;
+    LOG_DEBUG(HW_GPU, "Evicted {} decoded shader programs, {} cached", num_evicted, cache.size());
+}
+
+ShaderEngineStats InterpreterEngine::GetStats() const {
+    return {
+        .programs_compiled = programs_decoded,
+        .programs_evicted = programs_evicted,
+        .cache_bytes = cache.size() * sizeof(DecodedProgram),
+    };
 }
 
 MICROPROFILE_DECLARE(GPU_Shader);
@@ -678,7 +760,14 @@ void InterpreterEngine::Run(const ShaderSetup& setup, UnitState& state) const {
     MICROPROFILE_SCOPE(GPU_Shader);
 
     DebugData<false> dummy_debug_data;
-    RunInterpreter(setup, state, dummy_debug_data, setup.engine_data.entry_point);
+    const auto* program = static_cast<const DecodedProgram*>(setup.engine_data.decoded_program);
+    if (program == nullptr) {
+        // Not set up through SetupBatch, decode the program for this run only
+        RunInterpreter(setup, *DecodeProgram(setup), state, dummy_debug_data,
+                       setup.engine_data.entry_point);
+        return;
+    }
+    RunInterpreter(setup, *program, state, dummy_debug_data, setup.engine_data.entry_point);
 }
 
 DebugData<true> InterpreterEngine::ProduceDebugInfo(const ShaderSetup& setup,
@@ -690,7 +779,8 @@ DebugData<true> InterpreterEngine::ProduceDebugInfo(const ShaderSetup& setup,
     // Setup input register table
     boost::fill(state.registers.input, Common::Vec4<float24>::AssignToAll(float24::Zero()));
     state.LoadInput(config, input);
-    RunInterpreter(setup, state, debug_data, setup.engine_data.entry_point);
+    RunInterpreter(setup, *DecodeProgram(setup), state, debug_data,
+                   setup.engine_data.entry_point);
     return debug_data;
 }
 
@@ -4,15 +4,24 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+#include "common/common_types.h"
 #include "video_core/shader/debug_data.h"
 #include "video_core/shader/shader.h"
 
 namespace Pica::Shader {
 
+struct DecodedProgram;
+
 class InterpreterEngine final : public ShaderEngine {
 public:
+    InterpreterEngine();
+    ~InterpreterEngine() override;
+
     void SetupBatch(ShaderSetup& setup, unsigned int entry_point) override;
     void Run(const ShaderSetup& setup, UnitState& state) const override;
+    ShaderEngineStats GetStats() const override;
 
     /**
      * Produce debug information based on the given shader and input vertex
@@ -23,6 +32,23 @@ public:
      */
     DebugData<true> ProduceDebugInfo(const ShaderSetup& setup, const AttributeBuffer& input,
                                      const ShaderRegs& config) const;
+
+private:
+    struct CachedProgram {
+        std::unique_ptr<DecodedProgram> program;
+        /// Value of use_tick when the program was last set up
+        u64 last_used = 0;
+    };
+
+    /// Evicts the least recently used programs when over the cache budget
+    void EvictPrograms();
+
+    /// Programs decoded by SetupBatch, keyed by the program code and swizzle data hashes
+    std::unordered_map<u64, CachedProgram> cache;
+    u64 use_tick = 0;
+
+    u64 programs_decoded = 0;
+    u64 programs_evicted = 0;
 };
 
 } // namespace Pica::Shader
@@ -5,6 +5,10 @@
 #include "common/arch.h"
 #if CITRA_ARCH(x86_64)
 
+#include <algorithm>
+#include "common/hash.h"
+#include "common/literals.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "video_core/shader/shader.h"
 #include "video_core/shader/shader_jit_x64.h"
@@ -12,7 +16,16 @@
 
 namespace Pica::Shader {
 
-JitX64Engine::JitX64Engine() = default;
+using namespace Common::Literals;
+
+/// Programs with more bool uniform combinations than this only use the generic shader
+constexpr u32 MaxVariantsPerProgram = 8;
+/// Code memory of the cached programs, every shader allocates MAX_SHADER_SIZE
+constexpr u64 CacheBudget = 64_MiB;
+/// Evicted shaders kept to compile new programs into
+constexpr std::size_t MaxFreeShaders = 8;
+
+JitX64Engine::JitX64Engine() : variant_worker{1, "ShaderJIT"} {}
 JitX64Engine::~JitX64Engine() = default;
 
 void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
@@ -23,15 +36,135 @@ void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     u64 swizzle_hash = setup.GetSwizzleDataHash();
 
     u64 cache_key = code_hash ^ swizzle_hash;
-    auto iter = cache.find(cache_key);
-    if (iter != cache.end()) {
-        setup.engine_data.cached_shader = iter->second.get();
-    } else {
-        auto shader = std::make_unique<JitShader>();
-        shader->Compile(&setup.program_code, &setup.swizzle_data);
-        setup.engine_data.cached_shader = shader.get();
-        cache.emplace_hint(iter, cache_key, std::move(shader));
+    Program& program = cache[cache_key];
+    program.last_used = ++use_tick;
+    if (!program.generic) {
+        program.generic = AcquireShader();
+        program.generic->Compile(&setup.program_code, &setup.swizzle_data);
+        programs_compiled++;
+    }
+
+    const JitShader* variant = GetVariant(setup, cache_key, program);
+    setup.engine_data.cached_shader = variant ? variant : program.generic.get();
+
+    if (num_used_shaders * MAX_SHADER_SIZE > CacheBudget) {
+        EvictPrograms();
+    }
+}
+
+const JitShader* JitX64Engine::GetVariant(const ShaderSetup& setup, u64 program_key,
+                                          Program& program) {
+    const u16 used_bool_uniforms = program.generic->GetUsedBoolUniforms();
+    if (used_bool_uniforms == 0) {
+        return nullptr;
+    }
+
+    u16 bool_uniforms = 0;
+    for (std::size_t i = 0; i < setup.uniforms.b.size(); ++i) {
+        bool_uniforms |= static_cast<u16>(setup.uniforms.b[i]) << i;
     }
+    bool_uniforms &= used_bool_uniforms;
+    const u64 variant_key = Common::HashCombine(program_key, bool_uniforms);
+
+    std::scoped_lock lock{mutex};
+    const auto [iter, inserted] = variants.try_emplace(variant_key);
+    if (!inserted) {
+        return iter->second.get();
+    }
+    if (program.variant_keys.size() >= MaxVariantsPerProgram) {
+        variants.erase(iter);
+        return nullptr;
+    }
+    program.variant_keys.push_back(variant_key);
+
+    // The setup may change before the worker gets to it
+    auto program_code = std::make_shared<ProgramCode>(setup.program_code);
+    auto swizzle_data = std::make_shared<SwizzleData>(setup.swizzle_data);
+    variant_worker.QueueWork([this, variant_key, bool_uniforms, program_code, swizzle_data] {
+        auto shader = AcquireShader();
+        shader->Compile(program_code.get(), swizzle_data.get(), bool_uniforms);
+        programs_compiled++;
+        std::scoped_lock lock{mutex};
+        // The program may have been evicted meanwhile
+        const auto iter = variants.find(variant_key);
+        if (iter == variants.end() || iter->second) {
+            ReleaseShader(std::move(shader));
+            return;
+        }
+        iter->second = std::move(shader);
+    });
+    return nullptr;
+}
+
+std::unique_ptr<JitShader> JitX64Engine::AcquireShader() {
+    num_used_shaders++;
+    {
+        std::scoped_lock lock{mutex};
+        if (!free_shaders.empty()) {
+            auto shader = std::move(free_shaders.back());
+            free_shaders.pop_back();
+            return shader;
+        }
+    }
+    num_shaders++;
+    return std::make_unique<JitShader>();
+}
+
+void JitX64Engine::ReleaseShader(std::unique_ptr<JitShader> shader) {
+    num_used_shaders--;
+    if (free_shaders.size() < MaxFreeShaders) {
+        free_shaders.push_back(std::move(shader));
+        return;
+    }
+    num_shaders--;
+}
+
+void JitX64Engine::EvictPrograms() {
+    // The two programs set up last may be run by the vertex and geometry shader units right
+    // after this, they are not evicted
+    std::vector<decltype(cache)::iterator> candidates;
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->second.last_used + 1 < use_tick) {
+            candidates.push_back(it);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->second.last_used < rhs->second.last_used;
+    });
+
+    // Evict down to a fraction of the budget, so this does not run again on the next batch
+    const u64 target = CacheBudget / 4 * 3;
+    u64 num_evicted = 0;
+    std::scoped_lock lock{mutex};
+    for (const auto it : candidates) {
+        if (num_used_shaders * MAX_SHADER_SIZE <= target) {
+            break;
+        }
+        for (const u64 variant_key : it->second.variant_keys) {
+            const auto variant = variants.find(variant_key);
+            if (variant == variants.end()) {
+                continue;
+            }
+            if (variant->second) {
+                ReleaseShader(std::move(variant->second));
+            }
+            variants.erase(variant);
+        }
+        ReleaseShader(std::move(it->second.generic));
+        cache.erase(it);
+        num_evicted++;
+    }
+    programs_evicted += num_evicted;
+    LOG_DEBUG(HW_GPU, "Evicted {} shader programs, {} of {} shaders in use", num_evicted,
+              num_used_shaders.load(), num_shaders.load());
+}
+
+ShaderEngineStats JitX64Engine::GetStats() const {
+    return {
+        .programs_compiled = programs_compiled.load(),
+        .programs_evicted = programs_evicted.load(),
+        .cache_bytes = num_shaders.load() * MAX_SHADER_SIZE,
+    };
 }
 
 MICROPROFILE_DECLARE(GPU_Shader);
@@ -7,9 +7,13 @@
 #include "common/arch.h"
 #if CITRA_ARCH(x86_64)
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include "common/common_types.h"
+#include "common/thread_worker.h"
 #include "video_core/shader/shader.h"
 
 namespace Pica::Shader {
@@ -23,9 +27,48 @@ public:
 
     void SetupBatch(ShaderSetup& setup, unsigned int entry_point) override;
     void Run(const ShaderSetup& setup, UnitState& state) const override;
+    ShaderEngineStats GetStats() const override;
 
 private:
-    std::unordered_map<u64, std::unique_ptr<JitShader>> cache;
+    struct Program {
+        /// Compiled on first use and run until a variant for the bool uniforms is ready
+        std::unique_ptr<JitShader> generic;
+        /// Keys of the variants requested for the program
+        std::vector<u64> variant_keys;
+        /// Value of use_tick when the program was last set up
+        u64 last_used = 0;
+    };
+
+    /// Returns the variant of the program for the current bool uniforms if it is compiled,
+    /// otherwise queues its compilation and returns null.
+    const JitShader* GetVariant(const ShaderSetup& setup, u64 program_key, Program& program);
+
+    /// Returns a shader to compile into, reusing the code buffer of an evicted one if possible
+    std::unique_ptr<JitShader> AcquireShader();
+
+    /// Keeps the code buffer of a shader that is no longer used for later compilations, must be
+    /// called with the mutex held
+    void ReleaseShader(std::unique_ptr<JitShader> shader);
+
+    /// Evicts the least recently used programs and their variants when over the cache budget
+    void EvictPrograms();
+
+    std::unordered_map<u64, Program> cache;
+    u64 use_tick = 0;
+
+    /// Shaders allocated, including the released ones
+    std::atomic<u64> num_shaders = 0;
+    /// Shaders holding a program or being compiled, excluding the released ones
+    std::atomic<u64> num_used_shaders = 0;
+    std::atomic<u64> programs_compiled = 0;
+    std::atomic<u64> programs_evicted = 0;
+
+    /// Guards the variants and the released shaders, both are used by the worker
+    std::mutex mutex;
+    /// Variants specialized for the bool uniforms, null while they are being compiled
+    std::unordered_map<u64, std::unique_ptr<JitShader>> variants;
+    std::vector<std::unique_ptr<JitShader>> free_shaders;
+    Common::ThreadWorker variant_worker;
 };
 
 } // namespace Pica::Shader
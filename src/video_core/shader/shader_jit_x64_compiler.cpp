@@ -362,6 +362,15 @@ void JitShader::Compile_UniformCondition(Instruction instr) {
     cmp(byte[UNIFORMS + offset], 0);
 }
 
+std::optional<bool> JitShader::GetStaticUniformCondition(Instruction instr) {
+    const u16 bit = static_cast<u16>(1U << instr.flow_control.bool_uniform_id);
+    used_bool_uniforms |= bit;
+    if (!static_bool_uniforms) {
+        return std::nullopt;
+    }
+    return (*static_bool_uniforms & bit) != 0;
+}
+
 std::bitset<32> JitShader::PersistentCallerSavedRegs() {
     return persistent_regs & ABI_ALL_CALLER_SAVED;
 }
@@ -629,6 +638,12 @@ void JitShader::Compile_CALLC(Instruction instr) {
 }
 
 void JitShader::Compile_CALLU(Instruction instr) {
+    if (const auto condition = GetStaticUniformCondition(instr)) {
+        if (*condition) {
+            Compile_CALL(instr);
+        }
+        return;
+    }
     Compile_UniformCondition(instr);
     Label b;
     jz(b);
@@ -703,11 +718,20 @@ void JitShader::Compile_IF(Instruction instr) {
 
     // Evaluate the "IF" condition
     if (instr.opcode.Value() == OpCode::Id::IFU) {
-        Compile_UniformCondition(instr);
+        // The blocks of a known condition are still compiled, since other instructions may jump
+        // into them, but the one that is not taken is jumped over
+        if (const auto condition = GetStaticUniformCondition(instr)) {
+            if (!*condition) {
+                jmp(l_else, T_NEAR);
+            }
+        } else {
+            Compile_UniformCondition(instr);
+            jz(l_else, T_NEAR);
+        }
     } else if (instr.opcode.Value() == OpCode::Id::IFC) {
         Compile_EvaluateCondition(instr);
+        jz(l_else, T_NEAR);
     }
-    jz(l_else, T_NEAR);
 
     // Compile the code that corresponds to the condition evaluating as true
     Compile_Block(instr.flow_control.dest_offset);
@@ -771,17 +795,24 @@ void JitShader::Compile_LOOP(Instruction instr) {
 }
 
 void JitShader::Compile_JMP(Instruction instr) {
-    if (instr.opcode.Value() == OpCode::Id::JMPC)
-        Compile_EvaluateCondition(instr);
-    else if (instr.opcode.Value() == OpCode::Id::JMPU)
-        Compile_UniformCondition(instr);
-    else
-        UNREACHABLE();
-
     bool inverted_condition =
         (instr.opcode.Value() == OpCode::Id::JMPU) && (instr.flow_control.num_instructions & 1);
 
     Label& b = instruction_labels[instr.flow_control.dest_offset];
+    if (instr.opcode.Value() == OpCode::Id::JMPC) {
+        Compile_EvaluateCondition(instr);
+    } else if (instr.opcode.Value() == OpCode::Id::JMPU) {
+        if (const auto condition = GetStaticUniformCondition(instr)) {
+            if (*condition != inverted_condition) {
+                jmp(b, T_NEAR);
+            }
+            return;
+        }
+        Compile_UniformCondition(instr);
+    } else {
+        UNREACHABLE();
+    }
+
     if (inverted_condition) {
         jz(b, T_NEAR);
     } else {
@@ -897,9 +928,15 @@ void JitShader::FindReturnOffsets() {
 }
 
 void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code_,
-                        const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data_) {
+                        const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data_,
+                        std::optional<u16> bool_uniforms) {
     program_code = program_code_;
     swizzle_data = swizzle_data_;
+    static_bool_uniforms = bool_uniforms;
+
+    // Drop the previously compiled program, if any
+    setSize(prelude_size);
+    used_bool_uniforms = 0;
 
     // Reset flow control state
     program = (CompiledShader*)getCurr();
@@ -961,6 +998,7 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
 
 JitShader::JitShader() : Xbyak::CodeGenerator(MAX_SHADER_SIZE) {
     CompilePrelude();
+    prelude_size = getSize();
 }
 
 void JitShader::CompilePrelude() {
@@ -40,8 +40,19 @@ public:
         program(&setup.uniforms, &state, instruction_labels[offset].getAddress());
     }
 
+    /**
+     * Compiles the program. If `bool_uniforms` is given, the shader is specialized for these bool
+     * uniform values (bit N being uniform N), and must only be run while they are set.
+     * Compiling again reuses the code buffer, replacing the previous program.
+     */
     void Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code,
-                 const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data);
+                 const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data,
+                 std::optional<u16> bool_uniforms = std::nullopt);
+
+    /// Returns the mask of the bool uniforms the program tests, valid after compilation
+    u16 GetUsedBoolUniforms() const {
+        return used_bool_uniforms;
+    }
 
     void Compile_ADD(Instruction instr);
     void Compile_DP3(Instruction instr);
@@ -90,6 +101,12 @@ private:
     void Compile_EvaluateCondition(Instruction instr);
     void Compile_UniformCondition(Instruction instr);
 
+    /**
+     * Returns the value of the bool uniform tested by the instruction when the shader is
+     * specialized, in which case no code is needed to test it.
+     */
+    std::optional<bool> GetStaticUniformCondition(Instruction instr);
+
     /**
      * Emits the code to conditionally return from a subroutine envoked by the `CALL` instruction.
      */
@@ -133,11 +150,18 @@ private:
     unsigned program_counter = 0; ///< Offset of the next instruction to decode
     u8 loop_depth = 0;            ///< Depth of the (nested) loops currently compiled
 
+    /// Bool uniform values the shader is specialized for
+    std::optional<u16> static_bool_uniforms;
+    /// Mask of the bool uniforms tested by the program
+    u16 used_bool_uniforms = 0;
+
     using CompiledShader = void(const void* setup, void* state, const u8* start_addr);
     CompiledShader* program = nullptr;
 
     Xbyak::Label log2_subroutine;
     Xbyak::Label exp2_subroutine;
+    /// Size of the prelude subroutines, programs are compiled after them
+    std::size_t prelude_size = 0;
 };
 
 } // namespace Pica::Shader
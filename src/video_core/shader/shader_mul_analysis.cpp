@@ -0,0 +1,190 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <nihstro/shader_bytecode.h>
+#include "video_core/shader/shader_mul_analysis.h"
+
+using nihstro::Instruction;
+using nihstro::OpCode;
+using nihstro::SwizzlePattern;
+
+namespace Pica::Shader {
+
+namespace {
+
+struct Operand {
+    RegisterType type;
+    u32 index;
+    /// Whether the address register offsets the uniform read
+    bool relative;
+    /// Register component read by each lane
+    std::array<u32, 4> components;
+};
+
+template <SwizzlePattern::Selector (SwizzlePattern::*getter)(int) const>
+Operand MakeOperand(const SourceRegister& source_reg, u32 address_register_index,
+                    const SwizzlePattern& swizzle) {
+    Operand operand{
+        .type = source_reg.GetRegisterType(),
+        .index = static_cast<u32>(source_reg.GetIndex()),
+        .relative = false,
+        .components = {},
+    };
+    operand.relative = operand.type == RegisterType::FloatUniform && address_register_index != 0;
+    for (int lane = 0; lane < 4; ++lane) {
+        operand.components[lane] = static_cast<u32>((swizzle.*getter)(lane));
+    }
+    return operand;
+}
+
+/// The two sources multiplied or compared by an instruction, following the decompilers
+struct Operands {
+    Operand src1;
+    Operand src2;
+};
+
+Operands GetOperands(Instruction instr, const SwizzlePattern& swizzle) {
+    if (instr.opcode.Value().GetInfo().type == OpCode::Type::MultiplyAdd) {
+        const bool is_inverted = instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI;
+        return {
+            MakeOperand<&SwizzlePattern::GetSelectorSrc1>(instr.mad.GetSrc1(is_inverted), 0,
+                                                          swizzle),
+            MakeOperand<&SwizzlePattern::GetSelectorSrc2>(
+                instr.mad.GetSrc2(is_inverted), !is_inverted * instr.mad.address_register_index,
+                swizzle),
+        };
+    }
+    const bool is_inverted =
+        (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+    return {
+        MakeOperand<&SwizzlePattern::GetSelectorSrc1>(
+            instr.common.GetSrc1(is_inverted), !is_inverted * instr.common.address_register_index,
+            swizzle),
+        MakeOperand<&SwizzlePattern::GetSelectorSrc2>(
+            instr.common.GetSrc2(is_inverted), is_inverted * instr.common.address_register_index,
+            swizzle),
+    };
+}
+
+bool IsFinite(const Operand& operand, int lane, u64 finite_temporaries) {
+    return operand.type == RegisterType::Temporary &&
+           ((finite_temporaries >> (operand.index * 4 + operand.components[lane])) & 1) != 0;
+}
+
+bool IsSameValue(const Operand& lhs, const Operand& rhs, int lane) {
+    return lhs.type == rhs.type && lhs.index == rhs.index && !lhs.relative && !rhs.relative &&
+           lhs.components[lane] == rhs.components[lane];
+}
+
+/// Returns whether the instruction writes a finite value to a lane, given the finite temporaries
+bool WritesFinite(OpCode::Id opcode, const Operands& operands, int lane, u64 finite_temporaries) {
+    switch (opcode) {
+    case OpCode::Id::SGE:
+    case OpCode::Id::SGEI:
+    case OpCode::Id::SLT:
+    case OpCode::Id::SLTI:
+        return true;
+    case OpCode::Id::MOV:
+    case OpCode::Id::FLR:
+        return IsFinite(operands.src1, lane, finite_temporaries);
+    case OpCode::Id::MIN:
+    case OpCode::Id::MAX:
+        return IsFinite(operands.src1, lane, finite_temporaries) &&
+               IsFinite(operands.src2, lane, finite_temporaries);
+    default:
+        // Additions and products of finite values may still overflow
+        return false;
+    }
+}
+
+} // Anonymous namespace
+
+AccurateMulAnalysis::AccurateMulAnalysis(const ProgramCode& program_code,
+                                         const SwizzleData& swizzle_data) {
+    const auto get_swizzle = [&](Instruction instr) -> SwizzlePattern {
+        const bool is_mad = instr.opcode.Value().GetInfo().type == OpCode::Type::MultiplyAdd;
+        return {swizzle_data[is_mad ? instr.mad.operand_desc_id : instr.common.operand_desc_id]};
+    };
+
+    // Temporaries start as (0, 0, 0, 1). The set of finite components only shrinks, every pass
+    // drops the components that instructions may write a non finite value to.
+    u64 finite_temporaries = ~u64{0};
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const u32 word : program_code) {
+            const Instruction instr = {word};
+            const OpCode::Type type = instr.opcode.Value().GetInfo().type;
+            const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+            if (type != OpCode::Type::Arithmetic && type != OpCode::Type::MultiplyAdd) {
+                continue;
+            }
+            if (opcode == OpCode::Id::MOVA || opcode == OpCode::Id::CMP) {
+                continue;
+            }
+            const DestRegister dest = type == OpCode::Type::MultiplyAdd ? instr.mad.dest.Value()
+                                                                        : instr.common.dest.Value();
+            if (dest.GetRegisterType() != RegisterType::Temporary) {
+                continue;
+            }
+            const SwizzlePattern swizzle = get_swizzle(instr);
+            const Operands operands = GetOperands(instr, swizzle);
+            for (int lane = 0; lane < 4; ++lane) {
+                const u64 bit = u64{1} << (dest.GetIndex() * 4 + lane);
+                if (!swizzle.DestComponentEnabled(lane) || !(finite_temporaries & bit)) {
+                    continue;
+                }
+                if (!WritesFinite(opcode, operands, lane, finite_temporaries)) {
+                    finite_temporaries &= ~bit;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    for (u32 offset = 0; offset < MAX_PROGRAM_CODE_LENGTH; ++offset) {
+        const Instruction instr = {program_code[offset]};
+        const SwizzlePattern swizzle = get_swizzle(instr);
+
+        // Lanes of the product the result depends on
+        u32 lanes = 0;
+        switch (instr.opcode.Value().EffectiveOpCode()) {
+        case OpCode::Id::MUL:
+        case OpCode::Id::MAD:
+        case OpCode::Id::MADI:
+            for (int lane = 0; lane < 4; ++lane) {
+                lanes |= swizzle.DestComponentEnabled(lane) ? 1U << lane : 0U;
+            }
+            break;
+        // DPH multiplies the w lane by 1
+        case OpCode::Id::DP3:
+        case OpCode::Id::DPH:
+        case OpCode::Id::DPHI:
+            lanes = 0x7;
+            break;
+        case OpCode::Id::DP4:
+            lanes = 0xF;
+            break;
+        default:
+            continue;
+        }
+
+        const Operands operands = GetOperands(instr, swizzle);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (!((lanes >> lane) & 1)) {
+                continue;
+            }
+            const bool safe = IsSameValue(operands.src1, operands.src2, lane) ||
+                              (IsFinite(operands.src1, lane, finite_temporaries) &&
+                               IsFinite(operands.src2, lane, finite_temporaries));
+            if (!safe) {
+                needs_sanitize[offset] = true;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace Pica::Shader
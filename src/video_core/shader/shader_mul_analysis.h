@@ -0,0 +1,36 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <bitset>
+#include "common/common_types.h"
+#include "video_core/shader/shader.h"
+
+namespace Pica::Shader {
+
+/**
+ * Finds the multiplications of a program that can never compute 0 * inf, so that host shaders
+ * can emit a plain multiplication for them instead of emulating the PICA result of 0. That is
+ * the case when both factors are the same value, or are both known to be finite.
+ *
+ * The finite components of the temporary registers are found over the whole program regardless
+ * of the control flow: a component is finite if every instruction writing it produces a finite
+ * value from finite sources, like the 0 or 1 of SGE and SLT. Inputs and uniforms may be anything.
+ */
+class AccurateMulAnalysis {
+public:
+    explicit AccurateMulAnalysis(const ProgramCode& program_code,
+                                 const SwizzleData& swizzle_data);
+
+    /// Returns whether the multiplication of the instruction at the offset may compute 0 * inf
+    bool NeedsSanitize(u32 offset) const {
+        return needs_sanitize[offset];
+    }
+
+private:
+    std::bitset<MAX_PROGRAM_CODE_LENGTH> needs_sanitize;
+};
+
+} // namespace Pica::Shader
@@ -0,0 +1,60 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <nihstro/shader_bytecode.h>
+#include "video_core/shader/shader_specialization.h"
+
+using nihstro::Instruction;
+using nihstro::OpCode;
+
+namespace Pica::Shader {
+
+u16 GetUsedBoolUniforms(const ProgramCode& program_code) {
+    // Words that are not instructions may add bools the program never reads, which only costs
+    // a few more variants
+    u16 used = 0;
+    for (const u32 word : program_code) {
+        const Instruction instr = {word};
+        switch (instr.opcode.Value().EffectiveOpCode()) {
+        case OpCode::Id::IFU:
+        case OpCode::Id::CALLU:
+        case OpCode::Id::JMPU:
+            used |= static_cast<u16>(1U << instr.flow_control.bool_uniform_id);
+            break;
+        default:
+            break;
+        }
+    }
+    return used;
+}
+
+BoolUniformSpecialization BoolUniformSpecializer::Get(ShaderSetup& setup) {
+    auto [it, is_new] = programs.try_emplace(setup.GetProgramCodeHash());
+    Program& program = it->second;
+    if (is_new) {
+        program.used_bool_uniforms = GetUsedBoolUniforms(setup.program_code);
+    }
+    if (program.used_bool_uniforms == 0) {
+        return {};
+    }
+
+    u16 values = 0;
+    for (std::size_t i = 0; i < setup.uniforms.b.size(); i++) {
+        values |= static_cast<u16>(setup.uniforms.b[i] ? 1U << i : 0U);
+    }
+    values &= program.used_bool_uniforms;
+
+    const bool known = std::find(program.variants.begin(), program.variants.end(), values) !=
+                       program.variants.end();
+    if (!known) {
+        if (program.variants.size() >= MaxVariantsPerProgram) {
+            return {};
+        }
+        program.variants.push_back(values);
+    }
+    return {program.used_bool_uniforms, values};
+}
+
+} // namespace Pica::Shader
@@ -0,0 +1,48 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "video_core/shader/shader.h"
+
+namespace Pica::Shader {
+
+/// Returns the mask of the bool uniforms read by the flow control instructions of a program
+u16 GetUsedBoolUniforms(const ProgramCode& program_code);
+
+/// Bool uniforms to fold into constants when generating a host shader
+struct BoolUniformSpecialization {
+    /// Bool uniforms that are replaced by constants, 0 for the generic shader
+    u16 mask;
+    /// Values of the replaced bool uniforms
+    u16 values;
+};
+
+/**
+ * Picks the bool uniform values the host shaders of a program are specialized for. Every program
+ * gets at most MaxVariantsPerProgram specializations, later values use the generic shader so that
+ * programs whose uniforms change often do not compile a new shader for each draw.
+ */
+class BoolUniformSpecializer {
+public:
+    static constexpr std::size_t MaxVariantsPerProgram = 4;
+
+    BoolUniformSpecialization Get(ShaderSetup& setup);
+
+    void Clear() {
+        programs.clear();
+    }
+
+private:
+    struct Program {
+        u16 used_bool_uniforms;
+        std::vector<u16> variants;
+    };
+    std::unordered_map<u64, Program> programs;
+};
+
+} // namespace Pica::Shader
@@ -96,6 +96,14 @@ static_assert(sizeof(VSUniformData) == 1856,
 static_assert(sizeof(VSUniformData) < 16384,
               "VSUniformData structure must be less than 16kb as per the OpenGL spec");
 
+struct GSUniformData {
+    PicaUniformsData uniforms;
+};
+static_assert(sizeof(GSUniformData) == 1856,
+              "The size of the GSUniformData does not match the structure in the shader");
+static_assert(sizeof(GSUniformData) < 16384,
+              "GSUniformData structure must be less than 16kb as per the OpenGL spec");
+
 std::string BuildShaderUniformDefinitions(const std::string& extra_layout_parameters = "");
 
 } // namespace Pica::Shader
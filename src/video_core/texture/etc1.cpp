@@ -115,6 +115,53 @@ union ETC1Tile {
 
         return ret.Cast<u8>();
     }
+
+    void DecodeAll(std::span<Common::Vec3<u8>, 16> texels) const {
+        // Base colors and modifier tables of both halves are only looked up once
+        std::array<Common::Vec3<int>, 2> base;
+        if (differential_mode) {
+            const Common::Vec3<int> base1{static_cast<int>(differential.r),
+                                          static_cast<int>(differential.g),
+                                          static_cast<int>(differential.b)};
+            const Common::Vec3<int> base2 =
+                base1 + Common::Vec3<int>{static_cast<int>(differential.dr),
+                                          static_cast<int>(differential.dg),
+                                          static_cast<int>(differential.db)};
+            for (std::size_t half = 0; half < 2; half++) {
+                const Common::Vec3<int>& color = half ? base2 : base1;
+                base[half] = {Common::Color::Convert5To8(color.r()),
+                              Common::Color::Convert5To8(color.g()),
+                              Common::Color::Convert5To8(color.b())};
+            }
+        } else {
+            base[0] = {Common::Color::Convert4To8(static_cast<u8>(separate.r1)),
+                       Common::Color::Convert4To8(static_cast<u8>(separate.g1)),
+                       Common::Color::Convert4To8(static_cast<u8>(separate.b1))};
+            base[1] = {Common::Color::Convert4To8(static_cast<u8>(separate.r2)),
+                       Common::Color::Convert4To8(static_cast<u8>(separate.g2)),
+                       Common::Color::Convert4To8(static_cast<u8>(separate.b2))};
+        }
+        const std::array<const std::array<u8, 2>*, 2> tables = {
+            &etc1_modifier_table[table_index_1], &etc1_modifier_table[table_index_2]};
+
+        for (unsigned y = 0; y < 4; y++) {
+            for (unsigned x = 0; x < 4; x++) {
+                const unsigned texel = 4 * x + y;
+                const std::size_t half = ((flip ? y : x) >= 2) ? 1 : 0;
+
+                int modifier = (*tables[half])[GetTableSubIndex(texel)];
+                if (GetNegationFlag(texel))
+                    modifier *= -1;
+
+                const Common::Vec3<int> color =
+                    base[half] + Common::MakeVec(modifier, modifier, modifier);
+                texels[y * 4 + x] = Common::MakeVec(std::clamp(color.r(), 0, 255),
+                                                    std::clamp(color.g(), 0, 255),
+                                                    std::clamp(color.b(), 0, 255))
+                                        .Cast<u8>();
+            }
+        }
+    }
 };
 
 } // anonymous namespace
@@ -124,4 +171,9 @@ Common::Vec3<u8> SampleETC1Subtile(u64 value, unsigned int x, unsigned int y) {
     return tile.GetRGB(x, y);
 }
 
+void DecodeETC1Subtile(u64 value, std::span<Common::Vec3<u8>, 16> texels) {
+    ETC1Tile tile{value};
+    tile.DecodeAll(texels);
+}
+
 } // namespace Pica::Texture
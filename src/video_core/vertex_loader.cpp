@@ -17,6 +17,38 @@
 
 namespace Pica {
 
+namespace {
+
+template <typename T, u32 elements>
+void LoadAttribute(const u8* source, float24* attr) {
+    const T* srcdata = reinterpret_cast<const T*>(source);
+    for (u32 comp = 0; comp < elements; ++comp) {
+        attr[comp] = float24::FromFloat32(static_cast<float>(srcdata[comp]));
+    }
+    // Default attribute values set if array elements have < 4 components. This
+    // is *not* carried over from the default attribute settings even if they're
+    // enabled for this attribute.
+    for (u32 comp = elements; comp < 4; ++comp) {
+        attr[comp] = float24::FromFloat32(comp == 3 ? 1.0f : 0.0f);
+    }
+}
+
+template <typename T>
+constexpr std::array<VertexLoader::AttributeLoadFn, 4> MakeLoaders() {
+    return {&LoadAttribute<T, 1>, &LoadAttribute<T, 2>, &LoadAttribute<T, 3>,
+            &LoadAttribute<T, 4>};
+}
+
+/// Loaders indexed by [format][elements - 1], specialized so the per vertex loop doesn't branch
+constexpr std::array<std::array<VertexLoader::AttributeLoadFn, 4>, 4> AttributeLoaders = {
+    MakeLoaders<s8>(),
+    MakeLoaders<u8>(),
+    MakeLoaders<s16>(),
+    MakeLoaders<float>(),
+};
+
+} // Anonymous namespace
+
 void VertexLoader::Setup(const PipelineRegs& regs) {
     ASSERT_MSG(!is_setup, "VertexLoader is not intended to be setup more than once.");
 
@@ -68,6 +100,24 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
         }
     }
 
+    // Resolve the attributes that are read for every vertex
+    for (int i = 0; i < num_total_attributes; ++i) {
+        const u32 elements = vertex_attribute_elements[i];
+        if (elements != 0) {
+            const auto format = vertex_attribute_formats[i];
+            array_attributes[num_array_attributes++] = ArrayAttribute{
+                .load = AttributeLoaders[static_cast<u32>(format)][elements - 1],
+                .index = static_cast<u32>(i),
+                .source = vertex_attribute_sources[i],
+                .stride = vertex_attribute_strides[i],
+                .elements = elements,
+                .size_in_bytes = elements * attribute_config.GetElementSizeInBytes(i),
+            };
+        } else if (vertex_attribute_is_default[i]) {
+            default_attributes[num_default_attributes++] = static_cast<u32>(i);
+        }
+    }
+
     is_setup = true;
 }
 
@@ -76,88 +126,40 @@ void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
                               DebugUtils::MemoryAccessTracker& memory_accesses) {
     ASSERT_MSG(is_setup, "A VertexLoader needs to be setup before loading vertices.");
 
-    for (int i = 0; i < num_total_attributes; ++i) {
-        if (vertex_attribute_elements[i] != 0) {
-            // Load per-vertex data from the loader arrays
-            u32 source_addr =
-                base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
-
-            if (g_debug_context && Pica::g_debug_context->recorder) {
-                memory_accesses.AddAccess(
-                    source_addr,
-                    vertex_attribute_elements[i] *
-                        ((vertex_attribute_formats[i] == PipelineRegs::VertexAttributeFormat::FLOAT)
-                             ? 4
-                         : (vertex_attribute_formats[i] ==
-                            PipelineRegs::VertexAttributeFormat::SHORT)
-                             ? 2
-                             : 1));
-            }
+    const bool track_accesses = g_debug_context && g_debug_context->recorder;
+    for (u32 i = 0; i < num_array_attributes; ++i) {
+        const ArrayAttribute& attribute = array_attributes[i];
+        // Load per-vertex data from the loader arrays
+        const u32 source_addr = base_address + attribute.source + attribute.stride * vertex;
+        if (track_accesses) {
+            memory_accesses.AddAccess(source_addr, attribute.size_in_bytes);
+        }
 
-            switch (vertex_attribute_formats[i]) {
-            case PipelineRegs::VertexAttributeFormat::BYTE: {
-                const s8* srcdata = reinterpret_cast<const s8*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::UBYTE: {
-                const u8* srcdata = reinterpret_cast<const u8*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::SHORT: {
-                const s16* srcdata = reinterpret_cast<const s16*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::FLOAT: {
-                const float* srcdata = reinterpret_cast<const float*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            }
+        auto& attr = input.attr[attribute.index];
+        attribute.load(VideoCore::g_memory->GetPhysicalPointer(source_addr), &attr[0]);
 
-            // Default attribute values set if array elements have < 4 components. This
-            // is *not* carried over from the default attribute settings even if they're
-            // enabled for this attribute.
-            for (unsigned int comp = vertex_attribute_elements[i]; comp < 4; ++comp) {
-                input.attr[i][comp] =
-                    comp == 3 ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
-            }
+        LOG_TRACE(HW_GPU,
+                  "Loaded {} components of attribute {:x} for vertex {:x} (index {:x}) from "
+                  "0x{:08x} + 0x{:08x} + 0x{:04x}: {} {} {} {}",
+                  attribute.elements, attribute.index, vertex, index, base_address,
+                  attribute.source, attribute.stride * vertex, attr[0].ToFloat32(),
+                  attr[1].ToFloat32(), attr[2].ToFloat32(), attr[3].ToFloat32());
+    }
 
-            LOG_TRACE(HW_GPU,
-                      "Loaded {} components of attribute {:x} for vertex {:x} (index {:x}) from "
-                      "0x{:08x} + 0x{:08x} + 0x{:04x}: {} {} {} {}",
-                      vertex_attribute_elements[i], i, vertex, index, base_address,
-                      vertex_attribute_sources[i], vertex_attribute_strides[i] * vertex,
-                      input.attr[i][0].ToFloat32(), input.attr[i][1].ToFloat32(),
-                      input.attr[i][2].ToFloat32(), input.attr[i][3].ToFloat32());
-        } else if (vertex_attribute_is_default[i]) {
-            // Load the default attribute if we're configured to do so
-            input.attr[i] = g_state.input_default_attributes.attr[i];
-            LOG_TRACE(
-                HW_GPU,
-                "Loaded default attribute {:x} for vertex {:x} (index {:x}): ({}, {}, {}, {})", i,
-                vertex, index, input.attr[i][0].ToFloat32(), input.attr[i][1].ToFloat32(),
-                input.attr[i][2].ToFloat32(), input.attr[i][3].ToFloat32());
-        } else {
-            // TODO(yuriks): In this case, no data gets loaded and the vertex
-            // remains with the last value it had. This isn't currently maintained
-            // as global state, however, and so won't work in Citra yet.
-        }
+    for (u32 i = 0; i < num_default_attributes; ++i) {
+        // Load the default attribute if we're configured to do so
+        const u32 attribute_index = default_attributes[i];
+        auto& attr = input.attr[attribute_index];
+        attr = g_state.input_default_attributes.attr[attribute_index];
+        LOG_TRACE(HW_GPU,
+                  "Loaded default attribute {:x} for vertex {:x} (index {:x}): ({}, {}, {}, {})",
+                  attribute_index, vertex, index, attr[0].ToFloat32(), attr[1].ToFloat32(),
+                  attr[2].ToFloat32(), attr[3].ToFloat32());
     }
+
+    // TODO(yuriks): Attributes that are neither loaded from arrays nor default keep the last
+    // value they had. This isn't currently maintained as global state, however, and so won't
+    // work in Citra yet.
 }
 
 } // namespace Pica
@@ -2,6 +2,7 @@
 
 #include <array>
 #include "common/common_types.h"
+#include "video_core/pica_types.h"
 #include "video_core/regs_pipeline.h"
 
 namespace Pica {
@@ -16,6 +17,9 @@ struct AttributeBuffer;
 
 class VertexLoader {
 public:
+    /// Converts the elements of one attribute and pads the rest with (0, 0, 0, 1)
+    using AttributeLoadFn = void (*)(const u8* source, float24* attr);
+
     VertexLoader() = default;
     explicit VertexLoader(const PipelineRegs& regs) {
         Setup(regs);
@@ -30,11 +34,25 @@ public:
     }
 
 private:
+    /// Attribute read from the vertex arrays, resolved once for the whole draw
+    struct ArrayAttribute {
+        AttributeLoadFn load;
+        u32 index;
+        u32 source;
+        u32 stride;
+        u32 elements;
+        u32 size_in_bytes;
+    };
+
     std::array<u32, 16> vertex_attribute_sources;
     std::array<u32, 16> vertex_attribute_strides{};
     std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
     std::array<u32, 16> vertex_attribute_elements{};
     std::array<bool, 16> vertex_attribute_is_default;
+    std::array<ArrayAttribute, 16> array_attributes;
+    std::array<u32, 16> default_attributes;
+    u32 num_array_attributes = 0;
+    u32 num_default_attributes = 0;
     int num_total_attributes = 0;
     bool is_setup = false;
 };
@@ -2,14 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <memory>
 #include "common/archives.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "core/core.h"
+#include "core/loader/loader.h"
+#include "video_core/compile_report.h"
 #include "video_core/pica.h"
 #include "video_core/pica_state.h"
 #include "video_core/renderer_base.h"
+#include "video_core/renderer_null/renderer_null.h"
 #include "video_core/renderer_opengl/gl_vars.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
 #include "video_core/renderer_vulkan/renderer_vulkan.h"
@@ -27,6 +32,8 @@ std::atomic<bool> g_shader_jit_enabled;
 std::atomic<bool> g_hw_shader_enabled;
 std::atomic<bool> g_hw_shader_accurate_mul;
 std::atomic<bool> g_texture_filter_update_requested;
+std::atomic<u16> g_dynamic_resolution_scale;
+std::atomic<bool> g_skip_draws;
 
 Memory::MemorySystem* g_memory;
 
@@ -46,6 +53,9 @@ ResultStatus Init(Frontend::EmuWindow& emu_window, Frontend::EmuWindow* secondar
     case Settings::GraphicsAPI::Vulkan:
         g_renderer = std::make_unique<Vulkan::RendererVulkan>(system, emu_window, secondary_window);
         break;
+    case Settings::GraphicsAPI::Null:
+        g_renderer = std::make_unique<Null::RendererNull>(system, emu_window, secondary_window);
+        break;
     default:
         LOG_CRITICAL(Render, "Invalid graphics API enum value {}", graphics_api);
         UNREACHABLE();
@@ -59,6 +69,22 @@ void Shutdown() {
     Pica::Shutdown();
 
     g_renderer.reset();
+    g_dynamic_resolution_scale = 0;
+
+    // Shader stutter is title specific, so each title keeps the report of its last session
+    if (!g_compile_report.GetEvents().empty()) {
+        u64 program_id{};
+        Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id);
+        const std::string path =
+            fmt::format("{}compile_report_{:016X}.txt",
+                        FileUtil::GetUserPath(FileUtil::UserPath::LogDir), program_id);
+        if (FileUtil::CreateFullPath(path) && g_compile_report.Write(path)) {
+            LOG_INFO(Render, "Wrote the shader compile report to {}", path);
+        } else {
+            LOG_ERROR(Render, "Failed to write the shader compile report to {}", path);
+        }
+    }
+    g_compile_report.Clear();
 
     LOG_DEBUG(Render, "shutdown OK");
 }
@@ -74,6 +100,12 @@ u16 GetResolutionScaleFactor() {
     }
 }
 
+u16 GetRenderTargetScaleFactor() {
+    const u16 scale_factor = GetResolutionScaleFactor();
+    const u16 dynamic_scale = g_dynamic_resolution_scale;
+    return dynamic_scale != 0 ? std::min(dynamic_scale, scale_factor) : scale_factor;
+}
+
 template <class Archive>
 void serialize(Archive& ar, const unsigned int) {
     ar& Pica::g_state;
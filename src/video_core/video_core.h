@@ -37,6 +37,10 @@ extern std::atomic<bool> g_shader_jit_enabled;
 extern std::atomic<bool> g_hw_shader_enabled;
 extern std::atomic<bool> g_hw_shader_accurate_mul;
 extern std::atomic<bool> g_texture_filter_update_requested;
+/// Scale render targets are created at when dynamic resolution is active, zero otherwise
+extern std::atomic<u16> g_dynamic_resolution_scale;
+/// Whether the draws of the current frame are skipped by frame skipping
+extern std::atomic<bool> g_skip_draws;
 
 extern Memory::MemorySystem* g_memory;
 
@@ -55,6 +59,10 @@ void Shutdown();
 
 u16 GetResolutionScaleFactor();
 
+/// Returns the scale new render targets are created at, below the resolution scale factor
+/// while dynamic resolution is reducing the GPU load
+u16 GetRenderTargetScaleFactor();
+
 template <class Archive>
 void serialize(Archive& ar, const unsigned int file_version);
 